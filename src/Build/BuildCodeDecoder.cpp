@@ -0,0 +1,294 @@
+#include "BuildCodeDecoder.h"
+#include "../Utils/XmlReader.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace Nexile {
+
+    namespace {
+        // Base64 lookup accepting both the standard and URL-safe alphabets
+        std::array<int8_t, 256> BuildBase64Table() {
+            std::array<int8_t, 256> table;
+            table.fill(-1);
+
+            const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+            for (int i = 0; i < 62; i++) {
+                table[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+            }
+            table['+'] = 62;
+            table['-'] = 62;
+            table['/'] = 63;
+            table['_'] = 63;
+            return table;
+        }
+
+        // Parse the comma separated node id list of a <Spec> element
+        void ParseNodeList(std::string_view list, std::vector<uint32_t>& nodes) {
+            nodes.clear();
+            nodes.reserve(list.size() / 5 + 1);
+
+            uint32_t value = 0;
+            bool inNumber = false;
+            for (char c : list) {
+                if (c >= '0' && c <= '9') {
+                    value = value * 10 + static_cast<uint32_t>(c - '0');
+                    inNumber = true;
+                } else if (inNumber) {
+                    nodes.push_back(value);
+                    value = 0;
+                    inNumber = false;
+                }
+            }
+            if (inNumber) {
+                nodes.push_back(value);
+            }
+        }
+
+        // Split an <Item> text block into rarity, name and base type
+        void ParseItemText(std::string_view text, BuildItem& item) {
+            std::vector<std::string_view> lines;
+            size_t pos = 0;
+            while (pos < text.size() && lines.size() < 4) {
+                size_t end = text.find('\n', pos);
+                if (end == std::string_view::npos) end = text.size();
+
+                std::string_view line = text.substr(pos, end - pos);
+                while (!line.empty() && (line.front() == ' ' || line.front() == '\t' || line.front() == '\r')) line.remove_prefix(1);
+                while (!line.empty() && (line.back() == ' ' || line.back() == '\t' || line.back() == '\r')) line.remove_suffix(1);
+                if (!line.empty()) lines.push_back(line);
+
+                pos = end + 1;
+            }
+
+            size_t next = 0;
+            if (!lines.empty() && lines[0].compare(0, 7, "Rarity:") == 0) {
+                std::string_view rarity = lines[0].substr(7);
+                while (!rarity.empty() && rarity.front() == ' ') rarity.remove_prefix(1);
+                item.rarity = std::string(rarity);
+                next = 1;
+            }
+
+            if (next < lines.size()) {
+                item.name = std::string(lines[next]);
+            }
+
+            if ((item.rarity == "RARE" || item.rarity == "UNIQUE" || item.rarity == "RELIC") && next + 1 < lines.size()) {
+                item.baseType = std::string(lines[next + 1]);
+            } else {
+                item.baseType = item.name;
+            }
+        }
+    }
+
+    bool BuildCodeDecoder::Decode(std::string_view code, BuildModel& model, std::string& error) {
+        if (!DecodeToXml(code, m_xml, error)) {
+            return false;
+        }
+        return ParseXml(m_xml, model, error);
+    }
+
+    bool BuildCodeDecoder::DecodeToXml(std::string_view code, std::string& xml, std::string& error) {
+        if (!DecodeBase64(code, m_compressed) || m_compressed.empty()) {
+            error = "Build code is not valid base64";
+            return false;
+        }
+
+        return Inflate(m_compressed, xml, error);
+    }
+
+    bool BuildCodeDecoder::DecodeBase64(std::string_view input, std::string& output) {
+        static const std::array<int8_t, 256> table = BuildBase64Table();
+
+        output.clear();
+        output.reserve(input.size() * 3 / 4);
+
+        uint32_t accumulator = 0;
+        int bits = 0;
+
+        for (char c : input) {
+            if (c == '=' ) break;
+            if (c == ' ' || c == '\r' || c == '\n' || c == '\t') continue;
+
+            int8_t value = table[static_cast<unsigned char>(c)];
+            if (value < 0) {
+                return false;
+            }
+
+            accumulator = (accumulator << 6) | static_cast<uint32_t>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                output += static_cast<char>((accumulator >> bits) & 0xFF);
+            }
+        }
+
+        return true;
+    }
+
+    bool BuildCodeDecoder::Inflate(const std::string& compressed, std::string& output, std::string& error) {
+        z_stream stream = {};
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+        stream.avail_in = static_cast<uInt>(compressed.size());
+
+        // 15 window bits + 32 enables zlib/gzip header auto-detection
+        if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+            error = "Failed to initialize zlib";
+            return false;
+        }
+
+        // Build XML compresses roughly 8-12x; start there and grow if needed, up
+        // to one byte past the limit so a stream of exactly the limit still fits
+        const size_t capacity = kMaxInflatedSize + 1;
+        output.resize(std::min(std::max<size_t>(compressed.size() * 10, 4096), capacity));
+
+        int result = Z_OK;
+        while (result == Z_OK) {
+            if (stream.total_out >= output.size()) {
+                if (output.size() >= capacity) {
+                    break;
+                }
+                output.resize(std::min(output.size() * 2, capacity));
+            }
+
+            stream.next_out = reinterpret_cast<Bytef*>(&output[stream.total_out]);
+            stream.avail_out = static_cast<uInt>(output.size() - stream.total_out);
+
+            result = inflate(&stream, Z_NO_FLUSH);
+        }
+
+        size_t produced = stream.total_out;
+        inflateEnd(&stream);
+
+        // A small code can expand without bound; stop before it takes the UI with it
+        if (produced > kMaxInflatedSize) {
+            error = "Build code data inflates past " + std::to_string(kMaxInflatedSize / (1024 * 1024)) + " MB";
+            output.clear();
+            return false;
+        }
+
+        if (result != Z_STREAM_END) {
+            error = "Build code data is not a valid zlib stream";
+            output.clear();
+            return false;
+        }
+
+        output.resize(produced);
+        return true;
+    }
+
+    bool BuildCodeDecoder::ParseXml(std::string_view xml, BuildModel& model, std::string& error) {
+        model.Clear();
+
+        XmlReader reader(xml);
+
+        bool sawBuild = false;
+        int activeSpec = 1;
+        int specIndex = 0;
+        int activeSkillSet = 0;
+        int skillSetId = 0;
+        bool inItems = false;
+        bool inSkills = false;
+        BuildItem* currentItem = nullptr;
+        BuildSkillGroup* currentGroup = nullptr;
+
+        for (;;) {
+            XmlReader::Token token = reader.Next();
+
+            if (token == XmlReader::Token::End) {
+                break;
+            }
+
+            if (token == XmlReader::Token::Error) {
+                error = "Malformed build XML near offset " + std::to_string(reader.GetOffset());
+                return false;
+            }
+
+            if (token == XmlReader::Token::Text) {
+                if (currentItem && currentItem->rarity.empty() && currentItem->name.empty()) {
+                    ParseItemText(reader.GetText(), *currentItem);
+                }
+                continue;
+            }
+
+            std::string_view name = reader.GetName();
+
+            if (token == XmlReader::Token::EndElement) {
+                if (name == "Item") currentItem = nullptr;
+                else if (name == "Skill") currentGroup = nullptr;
+                else if (name == "Items") inItems = false;
+                else if (name == "Skills") inSkills = false;
+                continue;
+            }
+
+            // Start elements
+            if (name == "Build") {
+                sawBuild = true;
+                model.level = reader.GetIntAttribute("level", 1);
+                model.className = reader.GetAttribute("className");
+                model.ascendancy = reader.GetAttribute("ascendClassName");
+                if (model.ascendancy == "None") model.ascendancy.clear();
+            }
+            else if (name == "Tree") {
+                activeSpec = reader.GetIntAttribute("activeSpec", 1);
+            }
+            else if (name == "Spec") {
+                specIndex++;
+                // Keep the first spec unless the active one comes along
+                if (specIndex == activeSpec || model.treeNodes.empty()) {
+                    model.treeVersion = reader.GetAttribute("treeVersion");
+                    ParseNodeList(reader.GetRawAttribute("nodes"), model.treeNodes);
+                }
+            }
+            else if (name == "Items") {
+                inItems = true;
+            }
+            else if (name == "Item" && inItems) {
+                model.items.emplace_back();
+                currentItem = &model.items.back();
+                currentItem->id = reader.GetIntAttribute("id");
+            }
+            else if (name == "Skills") {
+                inSkills = true;
+                activeSkillSet = reader.GetIntAttribute("activeSkillSet", 0);
+            }
+            else if (name == "SkillSet") {
+                skillSetId = reader.GetIntAttribute("id", 0);
+            }
+            else if (name == "Skill" && inSkills) {
+                // With skill sets, only the active set counts
+                if (activeSkillSet == 0 || skillSetId == 0 || skillSetId == activeSkillSet) {
+                    model.skillGroups.emplace_back();
+                    currentGroup = &model.skillGroups.back();
+                    currentGroup->label = reader.GetAttribute("label");
+                    currentGroup->slot = reader.GetAttribute("slot");
+                    currentGroup->enabled = reader.GetBoolAttribute("enabled", true);
+                }
+            }
+            else if (name == "Gem" && currentGroup) {
+                BuildGem gem;
+                gem.name = reader.GetAttribute("nameSpec");
+                gem.level = reader.GetIntAttribute("level", 1);
+                gem.quality = reader.GetIntAttribute("quality", 0);
+                gem.enabled = reader.GetBoolAttribute("enabled", true);
+
+                std::string_view skillId = reader.GetRawAttribute("skillId");
+                std::string_view gemId = reader.GetRawAttribute("gemId");
+                gem.support = skillId.compare(0, 7, "Support") == 0 ||
+                              gemId.find("/Support") != std::string_view::npos;
+
+                currentGroup->gems.push_back(std::move(gem));
+            }
+        }
+
+        if (!sawBuild) {
+            error = "XML is not a Path of Building export";
+            return false;
+        }
+
+        return true;
+    }
+
+} // namespace Nexile
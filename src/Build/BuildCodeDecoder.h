@@ -0,0 +1,42 @@
+#pragma once
+
+#include "BuildModel.h"
+#include <string>
+#include <string_view>
+
+namespace Nexile {
+
+    // Path of Building export code decoding.
+    //
+    // An export code is the build XML, zlib-compressed and encoded as URL-safe
+    // base64. Decoding runs base64 -> inflate -> streaming XML parse straight into
+    // a BuildModel; no DOM is built and the XML buffer is reused between calls.
+    class BuildCodeDecoder {
+    public:
+        BuildCodeDecoder() = default;
+
+        // Decode an export code into a build model
+        bool Decode(std::string_view code, BuildModel& model, std::string& error);
+
+        // Decode an export code into its XML text
+        bool DecodeToXml(std::string_view code, std::string& xml, std::string& error);
+
+        // Parse PoB build XML into a build model
+        static bool ParseXml(std::string_view xml, BuildModel& model, std::string& error);
+
+        // Decode standard or URL-safe base64 (padding optional, whitespace ignored)
+        static bool DecodeBase64(std::string_view input, std::string& output);
+
+        // Inflate a zlib or gzip stream; fails past kMaxInflatedSize
+        static bool Inflate(const std::string& compressed, std::string& output, std::string& error);
+
+        // Largest build XML accepted (real exports are well under 1 MB)
+        static constexpr size_t kMaxInflatedSize = 32 * 1024 * 1024;
+
+    private:
+        // Reused decode buffers
+        std::string m_compressed;
+        std::string m_xml;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Item equipped or stored in a Path of Building build
+    struct BuildItem {
+        int id;                 // PoB item id (referenced by slots)
+        std::string rarity;     // "RARE", "UNIQUE", ...
+        std::string name;       // First name line
+        std::string baseType;   // Base type line (empty for normal/magic single-line items)
+
+        BuildItem() : id(0) {}
+    };
+
+    // Gem inside a skill group
+    struct BuildGem {
+        std::string name;
+        int level;
+        int quality;
+        bool enabled;
+        bool support;
+
+        BuildGem() : level(1), quality(0), enabled(true), support(false) {}
+    };
+
+    // Linked skill group (one socket group in PoB)
+    struct BuildSkillGroup {
+        std::string label;
+        std::string slot;
+        bool enabled;
+        std::vector<BuildGem> gems;
+
+        BuildSkillGroup() : enabled(true) {}
+    };
+
+    // Compact model of a Path of Building export - only what the build guide needs
+    struct BuildModel {
+        std::string className;
+        std::string ascendancy;
+        int level;
+
+        // Active passive tree spec
+        std::string treeVersion;
+        std::vector<uint32_t> treeNodes;
+
+        std::vector<BuildItem> items;
+        std::vector<BuildSkillGroup> skillGroups;
+
+        BuildModel() : level(1) {}
+
+        void Clear() { *this = BuildModel(); }
+    };
+
+} // namespace Nexile
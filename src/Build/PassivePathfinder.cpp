@@ -0,0 +1,260 @@
+#include "PassivePathfinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace Nexile {
+
+    namespace {
+        // Switch to bottom-up once the frontier is this fraction of the unvisited nodes
+        const size_t kBottomUpDivisor = 8;
+
+        const int kUnreached = std::numeric_limits<int>::max();
+    }
+
+    PassivePathfinder::PassivePathfinder(const PassiveTree& tree)
+        : m_tree(tree) {
+        Reset();
+    }
+
+    void PassivePathfinder::Reset() {
+        size_t count = m_tree.GetNodeCount();
+        m_blocked.Resize(count);
+        m_visited.Resize(count);
+        m_frontier.Resize(count);
+        m_next.Resize(count);
+        m_connected.Resize(count);
+        m_remaining.Resize(count);
+        m_parent.assign(count, -1);
+        m_distance.assign(count, kUnreached);
+    }
+
+    void PassivePathfinder::BlockOtherClassStarts(int ownStart) {
+        m_blocked.Clear();
+        for (size_t i = 0; i < m_tree.GetNodeCount(); i++) {
+            int index = static_cast<int>(i);
+            if (m_tree.GetNode(index).kind == PassiveNodeKind::ClassStart && index != ownStart) {
+                m_blocked.Set(index);
+            }
+        }
+    }
+
+    int PassivePathfinder::FindPath(const PassiveNodeSet& allocated, const PassiveNodeSet& targets,
+                                    std::vector<int>& path) {
+        path.clear();
+
+        int reached = Search(allocated, &targets);
+        if (reached >= 0) {
+            TracePath(reached, allocated, path);
+        }
+        return reached;
+    }
+
+    void PassivePathfinder::PlanAllocation(const PassiveNodeSet& allocated, const std::vector<int>& targets,
+                                           PassivePlan& plan) {
+        auto start = std::chrono::steady_clock::now();
+        plan.Clear();
+
+        m_connected = allocated;
+        m_remaining.Clear();
+        for (int target : targets) {
+            if (target >= 0 && !m_connected.Test(target)) {
+                m_remaining.Set(target);
+            }
+        }
+
+        // One full search gives every node's distance to the allocated tree
+        Search(m_connected, nullptr);
+
+        std::vector<int> added;
+        const size_t wordCount = m_remaining.GetWordCount();
+
+        while (m_remaining.Any()) {
+            // Nearest and farthest remaining targets
+            int nearest = kUnreached;
+            int farthest = 0;
+            m_remaining.ForEach([this, &nearest, &farthest](int index) {
+                if (m_distance[index] != kUnreached) {
+                    nearest = std::min(nearest, m_distance[index]);
+                    farthest = std::max(farthest, m_distance[index]);
+                }
+            });
+
+            if (nearest == kUnreached) {
+                m_remaining.ForEach([&plan](int index) { plan.unreachable.push_back(index); });
+                break;
+            }
+
+            // Connect every target at that distance. Each is traced after the
+            // previous ones joined the tree, so shared prefixes are only paid
+            // for once and later paths can only get shorter.
+            added.clear();
+            for (size_t w = 0; w < wordCount; w++) {
+                for (uint64_t bits = m_remaining.GetWord(w); bits; bits &= bits - 1) {
+                    int target = static_cast<int>(w * 64 + PassiveNodeSet::LowestBit(bits));
+                    if (m_distance[target] != nearest || !m_remaining.Test(target)) continue;
+
+                    PassivePathStep step;
+                    step.target = target;
+                    TracePath(target, m_connected, step.path);
+
+                    // Targets passed on the way are connected by this step too
+                    for (int node : step.path) {
+                        m_connected.Set(node);
+                        m_remaining.Reset(node);
+                        added.push_back(node);
+                    }
+
+                    plan.pointCount += step.path.size();
+                    plan.steps.push_back(std::move(step));
+                }
+            }
+
+            // Distances only shrink when the tree grows, so only the region
+            // around the new nodes needs to be revisited - and only as far as
+            // the farthest target, since no shorter path leaves that radius
+            Relax(added, farthest);
+        }
+
+        m_lastPlanMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    int PassivePathfinder::Search(const PassiveNodeSet& sources, const PassiveNodeSet* targets) {
+        const size_t wordCount = m_visited.GetWordCount();
+
+        std::fill(m_distance.begin(), m_distance.end(), kUnreached);
+
+        size_t frontierCount = 0;
+        for (size_t w = 0; w < wordCount; w++) {
+            uint64_t word = sources.GetWord(w) & ~m_blocked.GetWord(w);
+            m_frontier.Word(w) = word;
+            m_visited.Word(w) = word | m_blocked.GetWord(w);
+            for (; word; word &= word - 1) {
+                int node = static_cast<int>(w * 64 + PassiveNodeSet::LowestBit(word));
+                m_distance[node] = 0;
+                m_parent[node] = -1;
+                frontierCount++;
+            }
+        }
+
+        size_t unvisitedCount = m_tree.GetNodeCount() - frontierCount;
+
+        for (int level = 1; frontierCount > 0; level++) {
+            size_t added = (frontierCount * kBottomUpDivisor > unvisitedCount)
+                ? ExpandBottomUp(level) : ExpandTopDown(level);
+            unvisitedCount -= std::min(added, unvisitedCount);
+
+            // Lowest index among the targets reached at this level
+            if (targets) {
+                for (size_t w = 0; w < wordCount; w++) {
+                    uint64_t hit = m_next.GetWord(w) & targets->GetWord(w);
+                    if (hit) {
+                        return static_cast<int>(w * 64 + PassiveNodeSet::LowestBit(hit));
+                    }
+                }
+            }
+
+            m_frontier.Swap(m_next);
+            frontierCount = added;
+        }
+
+        return -1;
+    }
+
+    size_t PassivePathfinder::ExpandTopDown(int level) {
+        m_next.Clear();
+        size_t added = 0;
+
+        m_frontier.ForEach([this, level, &added](int node) {
+            for (const int* it = m_tree.NeighboursBegin(node); it != m_tree.NeighboursEnd(node); ++it) {
+                int neighbour = *it;
+                if (!m_visited.Test(neighbour)) {
+                    m_visited.Set(neighbour);
+                    m_next.Set(neighbour);
+                    m_parent[neighbour] = node;
+                    m_distance[neighbour] = level;
+                    added++;
+                }
+            }
+        });
+
+        return added;
+    }
+
+    size_t PassivePathfinder::ExpandBottomUp(int level) {
+        m_next.Clear();
+        size_t added = 0;
+
+        const size_t nodeCount = m_tree.GetNodeCount();
+        const size_t wordCount = m_visited.GetWordCount();
+
+        for (size_t w = 0; w < wordCount; w++) {
+            uint64_t candidates = ~m_visited.GetWord(w);
+            if (w == wordCount - 1 && (nodeCount & 63)) {
+                candidates &= (uint64_t(1) << (nodeCount & 63)) - 1;
+            }
+
+            for (; candidates; candidates &= candidates - 1) {
+                int node = static_cast<int>(w * 64 + PassiveNodeSet::LowestBit(candidates));
+
+                for (const int* it = m_tree.NeighboursBegin(node); it != m_tree.NeighboursEnd(node); ++it) {
+                    if (m_frontier.Test(*it)) {
+                        m_next.Set(node);
+                        m_parent[node] = *it;
+                        m_distance[node] = level;
+                        added++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Mark the new level visited only after the scan so it cannot chain within a level
+        for (size_t w = 0; w < wordCount; w++) {
+            m_visited.Word(w) |= m_next.GetWord(w);
+        }
+
+        return added;
+    }
+
+    void PassivePathfinder::Relax(const std::vector<int>& added, int maxLevel) {
+        m_frontier.Clear();
+        for (int node : added) {
+            m_distance[node] = 0;
+            m_parent[node] = -1;
+            m_frontier.Set(node);
+        }
+
+        bool any = !added.empty();
+        for (int level = 1; any && level <= maxLevel; level++) {
+            m_next.Clear();
+            any = false;
+
+            m_frontier.ForEach([this, level, &any](int node) {
+                for (const int* it = m_tree.NeighboursBegin(node); it != m_tree.NeighboursEnd(node); ++it) {
+                    int neighbour = *it;
+                    if (m_distance[neighbour] > level && !m_blocked.Test(neighbour)) {
+                        m_distance[neighbour] = level;
+                        m_parent[neighbour] = node;
+                        m_next.Set(neighbour);
+                        any = true;
+                    }
+                }
+            });
+
+            m_frontier.Swap(m_next);
+        }
+    }
+
+    void PassivePathfinder::TracePath(int node, const PassiveNodeSet& sources, std::vector<int>& path) const {
+        path.clear();
+        while (node >= 0 && !sources.Test(node)) {
+            path.push_back(node);
+            node = m_parent[node];
+        }
+        std::reverse(path.begin(), path.end());
+    }
+
+} // namespace Nexile
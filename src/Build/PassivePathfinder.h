@@ -0,0 +1,170 @@
+#pragma once
+
+#include "PassiveTree.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Nexile {
+
+    // Fixed-size set of passive node indices packed into 64-bit words
+    class PassiveNodeSet {
+    public:
+        PassiveNodeSet() = default;
+        explicit PassiveNodeSet(size_t size) { Resize(size); }
+
+        // Resize and clear
+        void Resize(size_t size) {
+            m_size = size;
+            m_words.assign((size + 63) / 64, 0);
+        }
+
+        void Clear() { std::fill(m_words.begin(), m_words.end(), 0); }
+
+        void Set(int index) { m_words[index >> 6] |= Bit(index); }
+        void Reset(int index) { m_words[index >> 6] &= ~Bit(index); }
+        bool Test(int index) const { return (m_words[index >> 6] & Bit(index)) != 0; }
+
+        bool Any() const {
+            for (uint64_t word : m_words) {
+                if (word) return true;
+            }
+            return false;
+        }
+
+        size_t GetSize() const { return m_size; }
+        size_t GetWordCount() const { return m_words.size(); }
+        uint64_t GetWord(size_t index) const { return m_words[index]; }
+        uint64_t& Word(size_t index) { return m_words[index]; }
+
+        void Swap(PassiveNodeSet& other) {
+            m_words.swap(other.m_words);
+            std::swap(m_size, other.m_size);
+        }
+
+        // Call fn(index) for every member in ascending order
+        template <typename Fn>
+        void ForEach(Fn&& fn) const {
+            for (size_t w = 0; w < m_words.size(); w++) {
+                uint64_t word = m_words[w];
+                while (word) {
+                    fn(static_cast<int>(w * 64 + LowestBit(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        // Index of the lowest set bit of a non-zero word
+        static int LowestBit(uint64_t word) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctzll(word);
+#endif
+        }
+
+    private:
+        static uint64_t Bit(int index) { return uint64_t(1) << (index & 63); }
+
+        std::vector<uint64_t> m_words;
+        size_t m_size = 0;
+    };
+
+    // One leg of an allocation plan: the points to spend to reach a target
+    struct PassivePathStep {
+        int target;              // Target node index
+        std::vector<int> path;   // Nodes to allocate in order; ends with the target
+    };
+
+    // Ordered allocation plan towards a set of target nodes
+    struct PassivePlan {
+        std::vector<PassivePathStep> steps;
+        std::vector<int> unreachable;   // Targets that cannot be connected
+        size_t pointCount = 0;          // Total points the plan spends
+
+        void Clear() {
+            steps.clear();
+            unreachable.clear();
+            pointCount = 0;
+        }
+    };
+
+    // Shortest-path and Steiner tree queries over a PassiveTree.
+    //
+    // Every allocated node costs one point, so paths are breadth-first searches
+    // grown from the whole allocated set at once. Frontiers and the visited set
+    // are bitsets; each level is expanded either top-down (frontier nodes push to
+    // their neighbours) or bottom-up (unvisited nodes look for a frontier
+    // neighbour), whichever touches fewer nodes. The search stops at the first
+    // level that reaches a target, which for build trees is usually level one.
+    //
+    // Plans use the greedy nearest-target Steiner approximation: repeatedly
+    // connect the closest remaining targets to the allocated tree. One full
+    // search seeds the distance to the tree; after each connection only the
+    // neighbourhood whose distance shrank is relaxed again. The result is at
+    // most twice the optimal point count and comes out in allocation order.
+    class PassivePathfinder {
+    public:
+        explicit PassivePathfinder(const PassiveTree& tree);
+
+        // Forget cached buffers after the tree has been reloaded
+        void Reset();
+
+        // Nodes the search may never enter (e.g. other classes' start nodes)
+        void SetBlocked(const PassiveNodeSet& blocked) { m_blocked = blocked; }
+
+        // Block every class start except the given one
+        void BlockOtherClassStarts(int ownStart);
+
+        // Shortest path from the allocated set to the nearest of the targets.
+        // Returns the reached target (-1 if none is reachable); path holds the
+        // nodes to allocate in order.
+        int FindPath(const PassiveNodeSet& allocated, const PassiveNodeSet& targets, std::vector<int>& path);
+
+        // Approximate minimum allocation connecting every target to the allocated set
+        void PlanAllocation(const PassiveNodeSet& allocated, const std::vector<int>& targets, PassivePlan& plan);
+
+        // Wall time of the last plan in milliseconds
+        double GetLastPlanMilliseconds() const { return m_lastPlanMs; }
+
+    private:
+        // Grow a BFS from sources, filling distances and parents. Stops at the
+        // first level that reaches one of the targets (if given) and returns it.
+        int Search(const PassiveNodeSet& sources, const PassiveNodeSet* targets);
+
+        // Lower distances up to maxLevel after nodes joined the source set
+        void Relax(const std::vector<int>& added, int maxLevel);
+
+        // Walk parents from a reached node back to the source set
+        void TracePath(int node, const PassiveNodeSet& sources, std::vector<int>& path) const;
+
+        // Level expansion strategies; return the number of nodes added
+        size_t ExpandTopDown(int level);
+        size_t ExpandBottomUp(int level);
+
+    private:
+        const PassiveTree& m_tree;
+
+        // Search state, sized to the tree and reused between queries
+        PassiveNodeSet m_blocked;
+        PassiveNodeSet m_visited;
+        PassiveNodeSet m_frontier;
+        PassiveNodeSet m_next;
+        PassiveNodeSet m_connected;
+        PassiveNodeSet m_remaining;
+        std::vector<int> m_parent;
+        std::vector<int> m_distance;
+
+        double m_lastPlanMs = 0.0;
+    };
+
+} // namespace Nexile
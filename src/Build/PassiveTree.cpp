@@ -0,0 +1,191 @@
+#include "PassiveTree.h"
+
+#include <algorithm>
+#include <utility>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        // Class order used by the tree data when it has no "classes" array
+        const char* const kDefaultClassNames[] = {
+            "Scion", "Marauder", "Ranger", "Witch", "Duelist", "Templar", "Shadow"
+        };
+
+        // Node ids are object keys in the tree data but numbers in "out"/"in"
+        // depending on the data version
+        bool ReadNodeId(const json& value, uint32_t& id) {
+            if (value.is_number_unsigned() || value.is_number_integer()) {
+                id = value.get<uint32_t>();
+                return true;
+            }
+            if (value.is_string()) {
+                const std::string& text = value.get_ref<const std::string&>();
+                if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+                    return false;
+                }
+                id = static_cast<uint32_t>(std::stoul(text));
+                return true;
+            }
+            return false;
+        }
+
+        bool IsMainTreeNode(const json& node) {
+            if (node.value("isMastery", false) || node.value("isProxy", false)) {
+                return false;
+            }
+            if (node.contains("ascendancyName")) {
+                return false;
+            }
+            return true;
+        }
+    }
+
+    bool PassiveTree::LoadFromJson(const std::string& jsonText, std::string& error) {
+        Clear();
+
+        json data = json::parse(jsonText, nullptr, false);
+        if (data.is_discarded() || !data.is_object()) {
+            error = "Passive tree data is not a JSON object";
+            return false;
+        }
+
+        if (!data.contains("nodes") || !data["nodes"].is_object()) {
+            error = "Passive tree data has no 'nodes' object";
+            return false;
+        }
+
+        if (data.contains("tree") && data["tree"].is_string()) {
+            m_version = data["tree"].get<std::string>();
+        }
+
+        if (data.contains("classes") && data["classes"].is_array()) {
+            for (const auto& cls : data["classes"]) {
+                m_classNames.push_back(cls.value("name", ""));
+            }
+        } else {
+            m_classNames.assign(std::begin(kDefaultClassNames), std::end(kDefaultClassNames));
+        }
+        m_classStarts.assign(m_classNames.size(), -1);
+
+        const json& nodes = data["nodes"];
+        m_nodes.reserve(nodes.size());
+
+        // First pass: register main tree nodes
+        for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+            const json& node = it.value();
+            uint32_t id = 0;
+            if (!node.is_object() || !IsMainTreeNode(node)) continue;
+            if (!ReadNodeId(node.contains("skill") ? node["skill"] : json(it.key()), id)) continue;
+
+            PassiveNode passive;
+            passive.id = id;
+            passive.name = node.value("name", "");
+
+            if (node.contains("classStartIndex")) {
+                passive.kind = PassiveNodeKind::ClassStart;
+                passive.classStartIndex = node.value("classStartIndex", -1);
+            } else if (node.value("isKeystone", false)) {
+                passive.kind = PassiveNodeKind::Keystone;
+            } else if (node.value("isNotable", false)) {
+                passive.kind = PassiveNodeKind::Notable;
+            } else if (node.value("isJewelSocket", false)) {
+                passive.kind = PassiveNodeKind::JewelSocket;
+            }
+
+            int index = static_cast<int>(m_nodes.size());
+            if (!m_index.emplace(id, index).second) continue;
+
+            if (passive.classStartIndex >= 0) {
+                if (static_cast<size_t>(passive.classStartIndex) >= m_classStarts.size()) {
+                    m_classStarts.resize(passive.classStartIndex + 1, -1);
+                }
+                m_classStarts[passive.classStartIndex] = index;
+            }
+
+            m_nodes.push_back(std::move(passive));
+        }
+
+        if (m_nodes.empty()) {
+            error = "Passive tree data contains no main tree nodes";
+            return false;
+        }
+
+        // Second pass: collect undirected edges between kept nodes
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(m_nodes.size() * 2);
+
+        for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+            const json& node = it.value();
+            uint32_t id = 0;
+            if (!node.is_object()) continue;
+            if (!ReadNodeId(node.contains("skill") ? node["skill"] : json(it.key()), id)) continue;
+
+            int from = FindNode(id);
+            if (from < 0) continue;
+
+            for (const char* key : { "out", "in" }) {
+                if (!node.contains(key) || !node[key].is_array()) continue;
+
+                for (const auto& other : node[key]) {
+                    uint32_t otherId = 0;
+                    if (!ReadNodeId(other, otherId)) continue;
+
+                    int to = FindNode(otherId);
+                    if (to < 0 || to == from) continue;
+
+                    edges.emplace_back(std::min(from, to), std::max(from, to));
+                }
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        // Counting sort into CSR
+        m_offsets.assign(m_nodes.size() + 1, 0);
+        for (const auto& edge : edges) {
+            m_offsets[edge.first + 1]++;
+            m_offsets[edge.second + 1]++;
+        }
+        for (size_t i = 1; i < m_offsets.size(); i++) {
+            m_offsets[i] += m_offsets[i - 1];
+        }
+
+        m_adjacency.resize(edges.size() * 2);
+        std::vector<uint32_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+        for (const auto& edge : edges) {
+            m_adjacency[cursor[edge.first]++] = edge.second;
+            m_adjacency[cursor[edge.second]++] = edge.first;
+        }
+
+        return true;
+    }
+
+    void PassiveTree::Clear() {
+        m_nodes.clear();
+        m_index.clear();
+        m_classStarts.clear();
+        m_classNames.clear();
+        m_offsets.assign(1, 0);
+        m_adjacency.clear();
+        m_version.clear();
+    }
+
+    int PassiveTree::FindNode(uint32_t id) const {
+        auto it = m_index.find(id);
+        return it != m_index.end() ? it->second : -1;
+    }
+
+    int PassiveTree::FindClassStart(const std::string& className) const {
+        for (size_t i = 0; i < m_classNames.size() && i < m_classStarts.size(); i++) {
+            if (m_classNames[i] == className) {
+                return m_classStarts[i];
+            }
+        }
+        return -1;
+    }
+
+} // namespace Nexile
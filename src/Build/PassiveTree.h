@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Role of a passive node in the tree
+    enum class PassiveNodeKind : uint8_t {
+        Normal,
+        Notable,
+        Keystone,
+        JewelSocket,
+        ClassStart
+    };
+
+    // Allocatable passive node
+    struct PassiveNode {
+        uint32_t id;             // Skill id used by the tree data and PoB exports
+        std::string name;
+        PassiveNodeKind kind;
+        int classStartIndex;     // Class index for class start nodes, -1 otherwise
+
+        PassiveNode() : id(0), kind(PassiveNodeKind::Normal), classStartIndex(-1) {}
+    };
+
+    // Passive skill tree graph loaded from the official tree JSON export.
+    //
+    // Only the main tree is kept: mastery, ascendancy and cluster jewel proxy
+    // nodes are dropped, as are the edges of the virtual root. Edges are stored
+    // undirected in compressed sparse row form so that a node's neighbours are
+    // one contiguous run of indices.
+    class PassiveTree {
+    public:
+        PassiveTree() = default;
+
+        // Replace the graph with the contents of a tree data JSON file
+        bool LoadFromJson(const std::string& jsonText, std::string& error);
+
+        // Remove all nodes and edges
+        void Clear();
+
+        // Whether a tree has been loaded
+        bool IsLoaded() const { return !m_nodes.empty(); }
+
+        // Node index for a skill id (-1 if unknown or not part of the main tree)
+        int FindNode(uint32_t id) const;
+
+        // Start node index for a class name such as "Witch" (-1 if unknown)
+        int FindClassStart(const std::string& className) const;
+
+        // Accessors
+        size_t GetNodeCount() const { return m_nodes.size(); }
+        size_t GetEdgeCount() const { return m_adjacency.size() / 2; }
+        const PassiveNode& GetNode(int index) const { return m_nodes[index]; }
+        const std::string& GetVersion() const { return m_version; }
+
+        // Neighbour run of a node
+        const int* NeighboursBegin(int index) const { return m_adjacency.data() + m_offsets[index]; }
+        const int* NeighboursEnd(int index) const { return m_adjacency.data() + m_offsets[index + 1]; }
+        int GetDegree(int index) const { return static_cast<int>(m_offsets[index + 1] - m_offsets[index]); }
+
+    private:
+        // Nodes by index
+        std::vector<PassiveNode> m_nodes;
+
+        // Skill id -> index
+        std::unordered_map<uint32_t, int> m_index;
+
+        // Class start node index by class index
+        std::vector<int> m_classStarts;
+
+        // Class names by class index
+        std::vector<std::string> m_classNames;
+
+        // CSR adjacency: neighbours of node i are m_adjacency[m_offsets[i] .. m_offsets[i + 1])
+        std::vector<uint32_t> m_offsets;
+        std::vector<int> m_adjacency;
+
+        // Tree version reported by the data file
+        std::string m_version;
+    };
+
+} // namespace Nexile
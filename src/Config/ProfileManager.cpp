@@ -42,6 +42,10 @@ namespace Nexile {
         poeProfile.clickThrough = true;
         poeProfile.overlayOpacity = 0.8f;
         poeProfile.enabledModules["price_check"] = true;
+        poeProfile.enabledModules["bulk_exchange"] = true;
+        poeProfile.enabledModules["build_guide"] = true;
+        poeProfile.enabledModules["map_overlay"] = true;
+        poeProfile.enabledModules["stash_search"] = true;
         m_profiles[GameID::PathOfExile] = poeProfile;
 
         // Path of Exile 2 profile (copy from PoE for now)
@@ -5,6 +5,10 @@
 #include "Config/ProfileManager.h"
 #include "Modules/PriceCheckModule.h"
 #include "Modules/SettingsModule.h"
+#include "Modules/BulkExchangeModule.h"
+#include "Modules/BuildGuideModule.h"
+#include "Modules/MapModule.h"
+#include "Modules/StashSearchModule.h"
 #include "Utils/Utils.h"
 #include "Utils/Logger.h"
 
@@ -22,6 +26,76 @@
 
 namespace Nexile {
 
+    namespace {
+        // Kernel + user time of this process in 100ns units
+        uint64_t GetProcessCpuTime() {
+            FILETIME creationTime, exitTime, kernelTime, userTime;
+            if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+                return 0;
+            }
+            auto toUnits = [](const FILETIME& time) {
+                return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+            };
+            return toUnits(kernelTime) + toUnits(userTime);
+        }
+
+        // Wall time since the process was created, so loader and CRT startup count too
+        double GetMillisecondsSinceLaunch() {
+            FILETIME creationTime, exitTime, kernelTime, userTime, now;
+            if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+                return 0.0;
+            }
+            GetSystemTimePreciseAsFileTime(&now);
+            auto toUnits = [](const FILETIME& time) {
+                return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+            };
+            uint64_t start = toUnits(creationTime);
+            uint64_t current = toUnits(now);
+            return current > start ? static_cast<double>(current - start) / 1e4 : 0.0;
+        }
+
+        // Overlay hotkeys only show pages; they wait for the browser. Module
+        // hotkeys read game state at press time and run immediately.
+        bool IsOverlayHotkey(int hotkeyId) {
+            return hotkeyId == HotkeyManager::HOTKEY_TOGGLE_OVERLAY ||
+                   hotkeyId == HotkeyManager::HOTKEY_GAME_SETTINGS ||
+                   hotkeyId == HotkeyManager::HOTKEY_BROWSER;
+        }
+
+        // CEF is started this long after launch if nothing has needed it yet
+        const auto kCefWarmupDelay = std::chrono::seconds(20);
+
+        // UI tasks run per loop turn before input gets its turn again
+        const auto kUITaskBudget = std::chrono::milliseconds(8);
+
+        // Startup phase budgets in milliseconds
+        struct PhaseBudget {
+            const char* phase;
+            double budgetMs;
+        };
+
+        const PhaseBudget kStartupBudgets[] = {
+            {"logger", 50.0},
+            {"main_window", 100.0},
+            {"managers", 200.0},
+            {"overlay_window", 300.0},
+            {"modules", 500.0},
+            {"tray", 100.0},
+            {"game_detection", 100.0},
+            {"hotkeys", 100.0},
+            {"cef", 2500.0},
+            {"cef_initialize", 1500.0},
+            {"browser_create", 500.0}
+        };
+
+        // NEXILE_STARTUP_STRICT=1 makes a launch fail when a phase goes over budget
+        bool IsStrictStartup() {
+            char value[8] = {};
+            DWORD length = GetEnvironmentVariableA("NEXILE_STARTUP_STRICT", value, sizeof(value));
+            return length > 0 && length < sizeof(value) && std::string(value) != "0";
+        }
+    }
+
     // FIXED: Initialize static instance
     NexileApp* NexileApp::s_instance = nullptr;
 
@@ -31,19 +105,23 @@ namespace Nexile {
           m_activeGame(GameID::None),
           m_overlayVisible(false),
           m_inSettingsMode(false),
-          m_browserOpen(false),
-          m_stopIdleTimer(false),
-          m_idleTimerStarted(false) {
+          m_browserOpen(false) {
 
         // Set global instance
         s_instance = this;
 
+        for (const PhaseBudget& budget : kStartupBudgets) {
+            m_startupProfiler.SetBudget(budget.phase, budget.budgetMs);
+        }
+
         // Initialize logging
+        m_startupProfiler.BeginPhase("logger");
         Logger::GetInstance().SetLogLevel(LogLevel::Info);
         Logger::GetInstance().SetLogToConsole(true);
 
         std::string logPath = Utils::CombinePath(Utils::GetAppDataPath(), "nexile.log");
         Logger::GetInstance().SetLogToFile(true, logPath);
+        m_startupProfiler.EndPhase();
 
         LOG_INFO("=================================================================");
         LOG_INFO("Nexile v0.1.0 Starting Up (CEF C API Version)");
@@ -56,80 +134,122 @@ namespace Nexile {
         Utils::CreateDirectory(appDataPath);
 
         // Initialize window class and main window
+        m_startupProfiler.BeginPhase("main_window");
         RegisterWindowClass();
         InitializeWindow();
+        m_startupProfiler.EndPhase();
+
+        // CEF schedules its work through this as soon as it is initialized, so it
+        // must exist before the overlay
+        m_scheduler = std::make_unique<Scheduler>();
+        m_scheduler->SetWakeCallback([this]() {
+            PostMessage(m_mainWindow, WM_SCHEDULER_WAKE, 0, 0);
+        });
+
+        // Everything runs on this thread; other threads post to it
+        m_uiThreadId = std::this_thread::get_id();
+        m_uiTasks = std::make_unique<UiTaskQueue>();
+        m_uiTasks->SetWakeCallback([this]() {
+            PostMessage(m_mainWindow, WM_SCHEDULER_WAKE, 0, 0);
+        });
 
         // Initialize managers
+        m_startupProfiler.BeginPhase("managers");
         m_profileManager = std::make_unique<ProfileManager>();
         m_hotkeyManager = std::make_unique<HotkeyManager>(this);
         m_gameDetector = std::make_unique<GameDetector>();
 
         // Set up manager relationships
         m_profileManager->SetHotkeyManager(std::unique_ptr<HotkeyManager>());  // ProfileManager owns HotkeyManager
+        m_startupProfiler.EndPhase();
 
-        // Create overlay window - FIXED: This now handles CEF C API internally
+        // Create overlay window. CEF starts on the first show or overlay hotkey, or
+        // after the warm-up delay, so the tray comes up without waiting for it.
+        m_startupProfiler.BeginPhase("overlay_window");
         m_overlayWindow = std::make_unique<OverlayWindow>(this);
+        m_overlayWindow->SetReadyCallback([this](bool restored) { OnOverlayReady(restored); });
         m_profileManager->SetOverlayWindow(m_overlayWindow.get());
+        m_startupProfiler.EndPhase();
 
         LogMemoryUsage("Post-Overlay-Init");
 
-        // Register overlay web message callback for communication
-        m_overlayWindow->RegisterWebMessageCallback([this](const std::wstring& message) {
-            try {
-                std::string msgStr = Utils::WideStringToString(message);
-                nlohmann::json msg = nlohmann::json::parse(msgStr);
-
-                std::string action = msg.value("action", "");
-
-                if (action == "toggle_overlay") {
-                    ToggleOverlay();
-                } else if (action == "open_settings") {
-                    OnHotkeyPressed(HotkeyManager::HOTKEY_GAME_SETTINGS);
-                } else if (action == "open_browser") {
-                    OnHotkeyPressed(HotkeyManager::HOTKEY_BROWSER);
-                } else if (action == "show_module") {
-                    std::string moduleId = msg.value("moduleId", "");
-                    if (!moduleId.empty()) {
-                        auto module = GetModule(moduleId);
-                        if (module) {
-                            m_overlayWindow->LoadModuleUI(module);
-                            SetOverlayVisible(true);
-                        }
-                    }
-                } else if (action == "close_browser") {
-                    m_browserOpen = false;
-                    m_overlayWindow->LoadMainOverlayUI();
-                } else if (action == "module_closed") {
-                    // Module was closed, return to main overlay
-                    if (m_overlayVisible) {
-                        m_overlayWindow->LoadMainOverlayUI();
-                    }
+        // Overlay page actions
+        m_overlayWindow->RegisterAction("app", "toggle_overlay", [this](const ActionMessage&) {
+            ToggleOverlay();
+        });
+        m_overlayWindow->RegisterAction("app", "open_settings", [this](const ActionMessage&) {
+            OnHotkeyPressed(HotkeyManager::HOTKEY_GAME_SETTINGS);
+        });
+        m_overlayWindow->RegisterAction("app", "open_browser", [this](const ActionMessage&) {
+            OnHotkeyPressed(HotkeyManager::HOTKEY_BROWSER);
+        });
+        m_overlayWindow->RegisterAction("app", "show_module", [this](const ActionMessage& msg) {
+            std::string moduleId = msg.Json().value("moduleId", "");
+            if (!moduleId.empty()) {
+                auto module = GetModule(moduleId);
+                if (module) {
+                    m_overlayWindow->LoadModuleUI(module);
+                    SetOverlayVisible(true);
                 }
-            } catch (const std::exception& e) {
-                LOG_ERROR("Error processing web message: {}", e.what());
+            }
+        });
+        m_overlayWindow->RegisterAction("app", "close_browser", [this](const ActionMessage&) {
+            m_browserOpen = false;
+            m_overlayWindow->LoadMainOverlayUI();
+        });
+        m_overlayWindow->RegisterAction("app", "module_closed", [this](const ActionMessage&) {
+            // Module was closed, return to main overlay
+            if (m_overlayVisible) {
+                m_overlayWindow->LoadMainOverlayUI();
             }
         });
 
         // Initialize modules
+        m_startupProfiler.BeginPhase("modules");
         InitializeModules();
+        m_startupProfiler.EndPhase();
 
         // Setup system tray
+        m_startupProfiler.BeginPhase("tray");
         AddTrayIcon();
+        m_startupProfiler.EndPhase();
+
+        // The game window is tracked on this thread, which receives its
+        // event hooks; the overlay follows it from there
+        m_gameDetector->SetWindowFoundCallback([this](HWND hwnd) {
+            PostToUI([this, hwnd]() { m_gameDetector->TrackGameWindow(hwnd); });
+        });
+        m_gameDetector->GetWindowTracker().SetChangeCallback([this](const WindowGeometry& geometry) {
+            if (m_overlayWindow) {
+                m_overlayWindow->FollowGameWindow(geometry);
+            }
+        });
 
         // Start game detection
+        m_startupProfiler.BeginPhase("game_detection");
         m_gameDetector->StartDetection([this](GameID gameId) {
-            OnGameChanged(gameId);
+            // Detection runs on its own thread
+            PostToUI([this, gameId]() { OnGameChanged(gameId); });
         });
+        m_startupProfiler.EndPhase();
 
         // Start hotkey registration
+        m_startupProfiler.BeginPhase("hotkeys");
         m_hotkeyManager->RegisterGlobalHotkeys();
+        m_startupProfiler.EndPhase();
 
-        // Start idle timer
+        // Idle check and loop statistics run as main loop timers
         m_lastActivityTime = std::chrono::steady_clock::now();
-        m_stopIdleTimer = false;
-        m_idleTimerThread = std::thread(&NexileApp::IdleTimerThreadFunc, this);
-        m_idleTimerStarted = true;
-
+        m_scheduler->AddTimer(std::chrono::minutes(1), [this]() { CheckIdle(); }, std::chrono::minutes(1));
+        m_scheduler->AddTimer(std::chrono::minutes(5), [this]() { ReportLoopStats(); }, std::chrono::minutes(5));
+        m_scheduler->AddTimer(kCefWarmupDelay, [this]() { m_overlayWindow->StartCEF(); });
+        m_scheduler->TakeStats();
+        m_lastCpuTime = GetProcessCpuTime();
+
+        m_timeToTrayMs = GetMillisecondsSinceLaunch();
+        m_startupProfiler.Mark("tray_ready");
+        LOG_INFO("Startup: tray ready {}ms after launch (CEF deferred)", m_timeToTrayMs);
+        WriteStartupProfile(IsStrictStartup());
         LOG_INFO("Nexile initialized successfully with CEF C API");
         LogMemoryUsage("App-Constructor-End");
     }
@@ -138,17 +258,10 @@ namespace Nexile {
         LOG_INFO("Shutting down Nexile application");
         LogMemoryUsage("Pre-Overlay-Destroy");
 
-        // Stop idle timer
-        if (m_idleTimerStarted) {
-            m_stopIdleTimer = true;
-            if (m_idleTimerThread.joinable()) {
-                m_idleTimerThread.join();
-            }
-        }
-
-        // Stop game detection
+        // Stop game detection and window tracking while the overlay still exists
         if (m_gameDetector) {
             m_gameDetector->StopDetection();
+            m_gameDetector->StopTrackingGameWindow();
         }
 
         // Unregister hotkeys
@@ -179,23 +292,34 @@ namespace Nexile {
         // Show main window (hidden tray application)
         ShowWindow(m_mainWindow, SW_HIDE);
 
-        // FIXED: Message loop with CEF C API work
+        // Event-driven loop: CEF tells the scheduler when it next needs to run
+        // (external message pump), timers add their deadlines, and the thread
+        // blocks until the earliest deadline or an OS message arrives
         MSG msg = {};
-        while (true) {
-            // CRITICAL CHANGE: Process CEF work using C API function
-            cef_do_message_loop_work();
-
-            // Process Windows messages (unchanged)
-            if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+        bool quit = false;
+        while (!quit) {
+            while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
                 if (msg.message == WM_QUIT) {
+                    quit = true;
                     break;
                 }
                 TranslateMessage(&msg);
                 DispatchMessage(&msg);
             }
+            if (quit) break;
+
+            m_uiTasks->Drain(kUITaskBudget);
 
-            // Small sleep to prevent high CPU usage
-            Sleep(1);
+            if (m_scheduler->TakePumpWork()) {
+                cef_do_message_loop_work();
+            }
+            m_scheduler->RunDueTimers();
+
+            auto wait = m_scheduler->BeginWait(std::chrono::hours(1));
+            DWORD timeout = static_cast<DWORD>(
+                std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+            MsgWaitForMultipleObjectsEx(0, nullptr, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            m_scheduler->EndWait();
         }
 
         LOG_INFO("Nexile message loop ended");
@@ -268,6 +392,10 @@ namespace Nexile {
                 return 0;
             }
 
+            case WM_SCHEDULER_WAKE:
+                // Only here to end the main loop's wait
+                return 0;
+
             case WM_CLOSE:
                 // Hide to tray instead of closing
                 ShowWindow(hwnd, SW_HIDE);
@@ -356,6 +484,11 @@ namespace Nexile {
     }
 
     void NexileApp::ToggleOverlay() {
+        if (!IsUIThread()) {
+            PostToUI([this]() { ToggleOverlay(); }, TaskPriority::High);
+            return;
+        }
+
         SetOverlayVisible(!m_overlayVisible);
         UpdateActivityTimestamp();
 
@@ -367,6 +500,11 @@ namespace Nexile {
     }
 
     void NexileApp::SetOverlayVisible(bool visible) {
+        if (!IsUIThread()) {
+            PostToUI([this, visible]() { SetOverlayVisible(visible); }, TaskPriority::High);
+            return;
+        }
+
         m_overlayVisible = visible;
 
         if (m_overlayWindow) {
@@ -376,6 +514,7 @@ namespace Nexile {
                     m_overlayWindow->LoadMainOverlayUI();
                 }
                 m_overlayWindow->Show();
+                ReportFirstOverlay();
             } else {
                 m_overlayWindow->Hide();
                 // Exit settings mode when hiding overlay
@@ -388,6 +527,16 @@ namespace Nexile {
     void NexileApp::OnHotkeyPressed(int hotkeyId) {
         UpdateActivityTimestamp();
 
+        if (!m_overlayWindow->IsBrowserReady() && IsOverlayHotkey(hotkeyId)) {
+            m_pendingHotkeys.push_back(hotkeyId);
+            LOG_INFO("Hotkey {} queued until the overlay browser is ready", hotkeyId);
+            // Either CEF has not started, or the browser was suspended while
+            // hidden; each call is a no-op in the other case
+            m_overlayWindow->StartCEF();
+            m_overlayWindow->RestoreBrowser();
+            return;
+        }
+
         switch (hotkeyId) {
             case HotkeyManager::HOTKEY_TOGGLE_OVERLAY:
                 ToggleOverlay();
@@ -439,6 +588,11 @@ namespace Nexile {
     }
 
     void NexileApp::OnGameChanged(GameID gameId) {
+        if (!IsUIThread()) {
+            PostToUI([this, gameId]() { OnGameChanged(gameId); });
+            return;
+        }
+
         if (m_activeGame == gameId) {
             return; // No change
         }
@@ -467,21 +621,33 @@ namespace Nexile {
         LOG_INFO("Initializing built-in modules");
 
         // Create built-in modules
+        m_startupProfiler.BeginPhase("create_builtin");
         auto priceCheckModule = std::make_shared<PriceCheckModule>();
         auto settingsModule = std::make_shared<SettingsModule>();
+        auto bulkExchangeModule = std::make_shared<BulkExchangeModule>();
+        auto buildGuideModule = std::make_shared<BuildGuideModule>();
+        auto mapModule = std::make_shared<MapModule>();
+        auto stashSearchModule = std::make_shared<StashSearchModule>();
 
         // Register modules
         m_modules[priceCheckModule->GetModuleID()] = priceCheckModule;
         m_modules[settingsModule->GetModuleID()] = settingsModule;
+        m_modules[bulkExchangeModule->GetModuleID()] = bulkExchangeModule;
+        m_modules[buildGuideModule->GetModuleID()] = buildGuideModule;
+        m_modules[mapModule->GetModuleID()] = mapModule;
+        m_modules[stashSearchModule->GetModuleID()] = stashSearchModule;
+        m_startupProfiler.EndPhase();
 
         // Initialize modules with current game
         for (auto& [moduleId, module] : m_modules) {
+            auto phase = m_startupProfiler.Phase("load:" + moduleId);
             module->OnModuleLoad(m_activeGame);
         }
 
         // Load external modules from directory
         std::string modulesDir = Utils::CombinePath(Utils::GetModulePath(), "Modules");
         if (Utils::DirectoryExists(modulesDir)) {
+            auto phase = m_startupProfiler.Phase("external_modules");
             LoadModulesFromDirectory(modulesDir);
         }
 
@@ -511,8 +677,12 @@ namespace Nexile {
             return false;
         }
 
-        // Unload module
+        // Unload module; its page actions and UI document go with it
         it->second->OnModuleUnload();
+        if (m_overlayWindow) {
+            m_overlayWindow->UnregisterActions(moduleId);
+            m_overlayWindow->UnregisterModuleUI(moduleId);
+        }
         m_modules.erase(it);
 
         // Unload DLL if it was loaded from DLL
@@ -606,27 +776,104 @@ namespace Nexile {
         }
     }
 
-    void NexileApp::IdleTimerThreadFunc() {
-        const auto idleThreshold = std::chrono::minutes(30); // 30 minutes idle threshold
+    void NexileApp::OnOverlayReady(bool restored) {
+        if (!restored) {
+            LOG_INFO("Startup: overlay browser ready {}ms after launch", GetMillisecondsSinceLaunch());
+            m_startupProfiler.Mark("overlay_ready");
+        }
+
+        std::vector<int> hotkeys;
+        hotkeys.swap(m_pendingHotkeys);
+        for (int hotkeyId : hotkeys) {
+            OnHotkeyPressed(hotkeyId);
+        }
+
+        // Shown while CEF was starting: the overlay is up now
+        if (m_overlayVisible) {
+            ReportFirstOverlay();
+        }
+    }
 
-        while (!m_stopIdleTimer) {
-            std::this_thread::sleep_for(std::chrono::minutes(1)); // Check every minute
+    void NexileApp::ReportFirstOverlay() {
+        if (m_firstOverlayReported || !m_overlayWindow->IsBrowserReady()) {
+            return;
+        }
+        m_firstOverlayReported = true;
+        LOG_INFO("Startup: first overlay {}ms after launch (tray ready at {}ms)",
+                 GetMillisecondsSinceLaunch(), m_timeToTrayMs);
 
-            if (m_stopIdleTimer) break;
+        // Rewrite the trace with the CEF phases; the launch is past failing by now
+        m_startupProfiler.Mark("first_overlay");
+        WriteStartupProfile(false);
+    }
 
-            auto now = std::chrono::steady_clock::now();
-            auto timeSinceActivity = now - m_lastActivityTime;
+    void NexileApp::WriteStartupProfile(bool enforceBudgets) {
+        LOG_INFO("Startup profile: {}", m_startupProfiler.GetSummary());
 
-            if (timeSinceActivity > idleThreshold) {
-                // System is idle, hide overlay to save resources
-                if (m_overlayVisible) {
-                    LOG_INFO("Auto-hiding overlay due to inactivity");
-                    SetOverlayVisible(false);
-                }
+        std::string tracePath = Utils::CombinePath(Utils::GetAppDataPath(), "startup_trace.json");
+        std::string error;
+        if (!m_startupProfiler.WriteChromeTrace(tracePath, error)) {
+            LOG_WARNING("Could not write startup trace: {}", error);
+        }
+
+        std::vector<StartupPhase> violations = m_startupProfiler.GetBudgetViolations();
+        for (const StartupPhase& phase : violations) {
+            LOG_WARNING("Startup phase '{}' took {}ms (budget {}ms)", phase.name, phase.durationMs, phase.budgetMs);
+        }
 
-                // Trigger memory cleanup
-                LogMemoryUsage("Idle-Cleanup");
+        if (enforceBudgets && !violations.empty()) {
+            // Thrown from the constructor, so the destructor will not undo startup
+            m_gameDetector->StopDetection();
+            m_hotkeyManager->UnregisterAllHotkeys();
+            RemoveTrayIcon();
+            throw std::runtime_error("Startup phase '" + violations.front().name + "' took " +
+                                     std::to_string(violations.front().durationMs) + "ms, over its " +
+                                     std::to_string(violations.front().budgetMs) + "ms budget (NEXILE_STARTUP_STRICT)");
+        }
+    }
+
+    void NexileApp::CheckIdle() {
+        const auto idleThreshold = std::chrono::minutes(30); // 30 minutes idle threshold
+
+        auto now = std::chrono::steady_clock::now();
+        auto timeSinceActivity = now - m_lastActivityTime;
+
+        if (timeSinceActivity > idleThreshold) {
+            // System is idle, hide overlay to save resources
+            if (m_overlayVisible) {
+                LOG_INFO("Auto-hiding overlay due to inactivity");
+                SetOverlayVisible(false);
             }
+
+            // Trigger memory cleanup
+            LogMemoryUsage("Idle-Cleanup");
+        }
+    }
+
+    void NexileApp::ReportLoopStats() {
+        SchedulerStats stats = m_scheduler->TakeStats();
+
+        // Process CPU over the same window
+        uint64_t cpuTime = GetProcessCpuTime();
+        double cpuPercent = 0.0;
+        if (stats.windowSeconds > 0.0) {
+            cpuPercent = static_cast<double>(cpuTime - m_lastCpuTime) / 1e7 / stats.windowSeconds * 100.0;
+        }
+        m_lastCpuTime = cpuTime;
+
+        LOG_INFO("Main loop: {} wakeups/s, {}% idle, {}% CPU, {} CEF pumps, {} timers over {}s",
+                 stats.wakeupsPerSecond, stats.idleFraction * 100.0, cpuPercent,
+                 stats.pumpRuns, stats.timersFired, stats.windowSeconds);
+
+        // Totals since startup, per lane
+        UiTaskStats tasks = m_uiTasks->GetStats();
+        static const char* const kLaneNames[kTaskPriorityCount] = { "high", "normal", "low" };
+        for (size_t lane = 0; lane < kTaskPriorityCount; lane++) {
+            const TaskLaneStats& laneStats = tasks.lanes[lane];
+            if (laneStats.posted == 0) continue;
+            LOG_INFO("UI tasks ({}): {} posted, {} run, {} expired, latency {}ms average, {}ms max",
+                     kLaneNames[lane], laneStats.posted, laneStats.run, laneStats.expired,
+                     laneStats.averageLatencyMs, laneStats.maxLatencyMs);
         }
     }
 
@@ -10,6 +10,9 @@
 #include <chrono>
 #include <shellapi.h>  // ADD THIS LINE
 
+#include "Scheduler.h"
+#include "UiTaskQueue.h"
+#include "StartupProfiler.h"
 #include "../UI/OverlayWindow.h"
 #include "../Modules/ModuleInterface.h"
 #include "../Game/GameDetector.h"
@@ -70,6 +73,22 @@ namespace Nexile {
         // Get profile manager
         ProfileManager* GetProfileManager() { return m_profileManager.get(); }
 
+        // Main loop deadlines; modules add their timers here
+        Scheduler* GetScheduler() { return m_scheduler.get(); }
+
+        // Run task on the UI thread (any thread). Windows and the browser may
+        // only be touched there, so workers hand their UI calls over this way.
+        template <typename F>
+        void PostToUI(F&& task, TaskPriority priority = TaskPriority::Normal,
+                      UiTaskQueue::Duration timeout = UiTaskQueue::Duration::max()) {
+            m_uiTasks->Post(std::forward<F>(task), priority, timeout);
+        }
+        bool IsUIThread() const { return std::this_thread::get_id() == m_uiThreadId; }
+        UiTaskStats GetUITaskStats() const { return m_uiTasks->GetStats(); }
+
+        // Startup phase timings; later phases (lazy CEF start) are recorded too
+        StartupProfiler* GetStartupProfiler() { return &m_startupProfiler; }
+
         // Update activity timestamp to prevent idle mode
         void UpdateActivityTimestamp();
 
@@ -101,8 +120,22 @@ namespace Nexile {
         // Load modules for a specific game
         void LoadModulesForGame(GameID gameId);
 
-        // Idle timer thread function
-        void IdleTimerThreadFunc();
+        // The overlay browser finished starting, or was restored after being
+        // suspended; replays queued hotkeys
+        void OnOverlayReady(bool restored);
+
+        // Log time-to-first-overlay once the overlay is first shown with a browser
+        void ReportFirstOverlay();
+
+        // Log the startup summary and write the Chrome trace; in strict mode a
+        // phase over budget throws
+        void WriteStartupProfile(bool enforceBudgets);
+
+        // Hide the overlay after a long period without activity
+        void CheckIdle();
+
+        // Log main loop wakeups and process CPU since the last report
+        void ReportLoopStats();
 
         // FIXED: Memory monitoring for C API optimization
         void LogMemoryUsage(const std::string& context);
@@ -150,14 +183,33 @@ namespace Nexile {
         // Tray icon data
         NOTIFYICONDATA m_trayIconData = {};
 
-        // Idle timer thread and related variables
-        std::thread m_idleTimerThread;
-        std::atomic<bool> m_stopIdleTimer;
+        // Main loop deadlines and timers
+        std::unique_ptr<Scheduler> m_scheduler;
+
+        // Work posted to the main loop from other threads
+        std::unique_ptr<UiTaskQueue> m_uiTasks;
+        std::thread::id m_uiThreadId;
+
+        // Overlay hotkeys pressed while CEF was still starting
+        std::vector<int> m_pendingHotkeys;
+
+        // Startup profile
+        StartupProfiler m_startupProfiler;
+        double m_timeToTrayMs = 0.0;
+        bool m_firstOverlayReported = false;
+
+        // Idle tracking
         std::chrono::steady_clock::time_point m_lastActivityTime;
-        bool m_idleTimerStarted;
+
+        // Process CPU time (100ns units) at the last stats report
+        uint64_t m_lastCpuTime = 0;
 
         // Custom tray message ID
         static const UINT WM_TRAYICON = WM_USER + 1;
+
+        // Posted to wake the main loop when a deadline moves earlier or a UI
+        // task arrives
+        static const UINT WM_SCHEDULER_WAKE = WM_USER + 2;
     };
 
 } // namespace Nexile
\ No newline at end of file
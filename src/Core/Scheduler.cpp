@@ -0,0 +1,300 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Nexile {
+
+    namespace {
+        const uint64_t kNoTick = std::numeric_limits<uint64_t>::max();
+
+        // Slot value of a due timer whose callback is about to run or running
+        const size_t kRunningSlot = std::numeric_limits<size_t>::max();
+    }
+
+    Scheduler::Scheduler(NowFunction now, Duration tick, size_t slotCount, Duration maxPumpDelay)
+        : m_now(now ? std::move(now) : NowFunction([]() { return Clock::now(); })),
+          m_tick(tick > Duration::zero() ? tick : std::chrono::milliseconds(1)),
+          m_pumpDeadline(TimePoint::max()), m_maxPumpDelay(maxPumpDelay),
+          m_slots(slotCount > 0 ? slotCount : 1), m_cursorTick(0), m_nextTimerId(1),
+          m_nextTimerTick(kNoTick), m_nextTimerDirty(false), m_waiting(false),
+          m_blocked(Duration::zero()) {
+        m_origin = m_now();
+        m_lastPump = m_origin;
+        m_waitStart = m_origin;
+        m_waitUntil = m_origin;
+        m_windowStart = m_origin;
+    }
+
+    void Scheduler::SetWakeCallback(WakeCallback wake) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake = std::move(wake);
+    }
+
+    void Scheduler::SchedulePumpWork(int64_t delayMs) {
+        WakeCallback wake;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            TimePoint now = m_now();
+            m_pumpDeadline = delayMs <= 0 ? now : now + std::chrono::milliseconds(delayMs);
+            if (NeedsWakeLocked(m_pumpDeadline)) {
+                wake = m_wake;
+            }
+        }
+        if (wake) wake();
+    }
+
+    bool Scheduler::TakePumpWork() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TimePoint now = m_now();
+
+        bool requested = m_pumpDeadline != TimePoint::max() && m_pumpDeadline <= now;
+        if (!requested && now - m_lastPump < m_maxPumpDelay) {
+            return false;
+        }
+
+        m_pumpDeadline = TimePoint::max();
+        m_lastPump = now;
+        m_stats.pumpRuns++;
+        return true;
+    }
+
+    Scheduler::TimerId Scheduler::AddTimer(Duration delay, TimerCallback callback, Duration interval) {
+        WakeCallback wake;
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            id = m_nextTimerId++;
+
+            uint64_t dueTick = TickAt(m_now() + std::max(delay, Duration::zero()), true);
+            dueTick = InsertLocked(id, dueTick, interval, std::make_shared<TimerCallback>(std::move(callback)));
+
+            if (NeedsWakeLocked(TimeOfTick(dueTick))) {
+                wake = m_wake;
+            }
+        }
+        if (wake) wake();
+        return id;
+    }
+
+    bool Scheduler::CancelTimer(TimerId id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_timerSlots.find(id);
+        if (it == m_timerSlots.end()) {
+            return false;
+        }
+
+        if (it->second != kRunningSlot) {
+            std::vector<Timer>& slot = m_slots[it->second];
+            for (size_t i = 0; i < slot.size(); i++) {
+                if (slot[i].id == id) {
+                    slot[i] = std::move(slot.back());
+                    slot.pop_back();
+                    break;
+                }
+            }
+            m_nextTimerDirty = true;
+        }
+
+        m_timerSlots.erase(it);
+        return true;
+    }
+
+    size_t Scheduler::GetTimerCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_timerSlots.size();
+    }
+
+    size_t Scheduler::RunDueTimers() {
+        std::vector<Timer> due;
+        uint64_t nowTick;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            nowTick = TickAt(m_now(), false);
+            if (nowTick <= m_cursorTick) {
+                return 0;
+            }
+
+            // Visit each slot that passed, at most one full turn of the wheel
+            uint64_t steps = std::min<uint64_t>(nowTick - m_cursorTick, m_slots.size());
+            for (uint64_t step = 1; step <= steps; step++) {
+                std::vector<Timer>& slot = m_slots[(m_cursorTick + step) % m_slots.size()];
+                for (size_t i = 0; i < slot.size();) {
+                    if (slot[i].dueTick <= nowTick) {
+                        m_timerSlots[slot[i].id] = kRunningSlot;
+                        due.push_back(std::move(slot[i]));
+                        slot[i] = std::move(slot.back());
+                        slot.pop_back();
+                    } else {
+                        i++;
+                    }
+                }
+            }
+
+            m_cursorTick = nowTick;
+            if (!due.empty()) {
+                m_nextTimerDirty = true;
+            }
+        }
+
+        if (due.empty()) {
+            return 0;
+        }
+
+        std::sort(due.begin(), due.end(), [](const Timer& a, const Timer& b) {
+            return a.dueTick != b.dueTick ? a.dueTick < b.dueTick : a.id < b.id;
+        });
+
+        // Callbacks run unlocked so they can add or cancel timers, including
+        // ones that are due in this same pass
+        size_t fired = 0;
+        for (Timer& timer : due) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_timerSlots.find(timer.id);
+                if (it == m_timerSlots.end() || it->second != kRunningSlot) {
+                    timer.callback.reset();
+                    continue;   // Cancelled by an earlier callback
+                }
+                if (timer.interval <= Duration::zero()) {
+                    m_timerSlots.erase(it);
+                }
+            }
+
+            (*timer.callback)();
+            fired++;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.timersFired += fired;
+
+        for (Timer& timer : due) {
+            if (timer.interval <= Duration::zero() || !timer.callback) continue;
+
+            auto it = m_timerSlots.find(timer.id);
+            if (it == m_timerSlots.end() || it->second != kRunningSlot) {
+                continue;   // Cancelled from a callback
+            }
+
+            // Keep the period anchored to the original schedule unless we fell behind
+            uint64_t intervalTicks = std::max<uint64_t>(1, TickAt(m_origin + timer.interval, true));
+            uint64_t nextTick = timer.dueTick + intervalTicks;
+            if (nextTick <= nowTick) {
+                nextTick = nowTick + intervalTicks;
+            }
+            InsertLocked(timer.id, nextTick, timer.interval, std::move(timer.callback));
+        }
+
+        return fired;
+    }
+
+    Scheduler::Duration Scheduler::GetWaitTime(Duration maxWait) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return WaitTimeLocked(m_now(), maxWait);
+    }
+
+    Scheduler::Duration Scheduler::BeginWait(Duration maxWait) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TimePoint now = m_now();
+        Duration wait = WaitTimeLocked(now, maxWait);
+        m_waiting = true;
+        m_waitStart = now;
+        m_waitUntil = now + wait;
+        return wait;
+    }
+
+    void Scheduler::EndWait() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_waiting) return;
+
+        m_waiting = false;
+        m_blocked += m_now() - m_waitStart;
+        m_stats.wakeups++;
+    }
+
+    SchedulerStats Scheduler::TakeStats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TimePoint now = m_now();
+
+        SchedulerStats stats = m_stats;
+        stats.windowSeconds = std::chrono::duration<double>(now - m_windowStart).count();
+        if (stats.windowSeconds > 0.0) {
+            stats.wakeupsPerSecond = static_cast<double>(stats.wakeups) / stats.windowSeconds;
+            stats.idleFraction = std::chrono::duration<double>(m_blocked).count() / stats.windowSeconds;
+        }
+
+        m_stats = SchedulerStats();
+        m_windowStart = now;
+        m_blocked = Duration::zero();
+        return stats;
+    }
+
+    uint64_t Scheduler::TickAt(TimePoint time, bool roundUp) const {
+        if (time <= m_origin) return 0;
+
+        Duration elapsed = time - m_origin;
+        uint64_t ticks = static_cast<uint64_t>(elapsed / m_tick);
+        if (roundUp && elapsed % m_tick != Duration::zero()) {
+            ticks++;
+        }
+        return ticks;
+    }
+
+    Scheduler::TimePoint Scheduler::TimeOfTick(uint64_t tick) const {
+        return m_origin + m_tick * static_cast<Duration::rep>(tick);
+    }
+
+    uint64_t Scheduler::InsertLocked(TimerId id, uint64_t dueTick, Duration interval,
+                                     std::shared_ptr<TimerCallback> callback) {
+        // Ticks up to the cursor have been processed already
+        dueTick = std::max(dueTick, m_cursorTick + 1);
+
+        size_t slot = static_cast<size_t>(dueTick % m_slots.size());
+        m_slots[slot].push_back({ id, dueTick, interval, std::move(callback) });
+        m_timerSlots[id] = slot;
+
+        if (!m_nextTimerDirty && dueTick < m_nextTimerTick) {
+            m_nextTimerTick = dueTick;
+        }
+        return dueTick;
+    }
+
+    uint64_t Scheduler::NextTimerTickLocked() const {
+        if (m_nextTimerDirty) {
+            m_nextTimerTick = kNoTick;
+            for (const auto& slot : m_slots) {
+                for (const Timer& timer : slot) {
+                    m_nextTimerTick = std::min(m_nextTimerTick, timer.dueTick);
+                }
+            }
+            m_nextTimerDirty = false;
+        }
+        return m_nextTimerTick;
+    }
+
+    Scheduler::Duration Scheduler::WaitTimeLocked(TimePoint now, Duration maxWait) const {
+        TimePoint deadline = std::min(m_pumpDeadline, m_lastPump + m_maxPumpDelay);
+
+        uint64_t timerTick = NextTimerTickLocked();
+        if (timerTick != kNoTick) {
+            deadline = std::min(deadline, TimeOfTick(timerTick));
+        }
+
+        if (deadline <= now) {
+            return Duration::zero();
+        }
+        return std::min(deadline - now, maxWait);
+    }
+
+    bool Scheduler::NeedsWakeLocked(TimePoint deadline) {
+        if (!m_waiting || deadline >= m_waitUntil) {
+            return false;
+        }
+
+        // Only the first earlier deadline per wait needs a wake-up
+        m_waitUntil = deadline;
+        return static_cast<bool>(m_wake);
+    }
+
+} // namespace Nexile
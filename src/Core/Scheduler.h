@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Counters of a Scheduler, over the window since the last TakeStats
+    struct SchedulerStats {
+        uint64_t wakeups = 0;           // Returns from a blocking wait
+        uint64_t pumpRuns = 0;          // CEF work calls
+        uint64_t timersFired = 0;
+        double windowSeconds = 0.0;
+        double wakeupsPerSecond = 0.0;
+        double idleFraction = 0.0;      // Share of the window spent blocked
+    };
+
+    // Deadline bookkeeping for the main loop.
+    //
+    // The loop used to spin on CEF work + PeekMessage + Sleep(1), waking about
+    // a thousand times a second even with the overlay hidden. Instead CEF tells
+    // us when it next needs to run (OnScheduleMessagePumpWork) and modules
+    // register timers here; the loop blocks until the earliest of those
+    // deadlines or an OS message.
+    //
+    // Timers live in a hashed timing wheel: adding and cancelling are O(1) and
+    // firing touches only the slots that passed. Timer resolution is one tick.
+    //
+    // The clock is injectable so the deadline logic can be driven by a fake
+    // clock. Scheduling and timer calls are safe from any thread; pump work,
+    // timer callbacks and the wait calls belong to the loop thread.
+    class Scheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+        using Duration = Clock::duration;
+        using NowFunction = std::function<TimePoint()>;
+        using WakeCallback = std::function<void()>;
+        using TimerCallback = std::function<void()>;
+        using TimerId = uint64_t;
+
+        // maxPumpDelay bounds the time between CEF work calls even when CEF
+        // asks for none, as a guard against a lost schedule request
+        explicit Scheduler(NowFunction now = nullptr,
+                           Duration tick = std::chrono::milliseconds(8),
+                           size_t slotCount = 256,
+                           Duration maxPumpDelay = std::chrono::seconds(1));
+
+        // Called (any thread) when a new deadline is earlier than the one the
+        // loop is currently blocked on, so it can wake and re-plan
+        void SetWakeCallback(WakeCallback wake);
+
+        // CEF wants a work call after delayMs; <= 0 means as soon as possible.
+        // Replaces any earlier request.
+        void SchedulePumpWork(int64_t delayMs);
+
+        // True (once) when requested pump work is due, or maxPumpDelay has
+        // passed since the last run
+        bool TakePumpWork();
+
+        // Run callback after delay, then every interval if it is non-zero
+        TimerId AddTimer(Duration delay, TimerCallback callback, Duration interval = Duration::zero());
+        bool CancelTimer(TimerId id);
+        size_t GetTimerCount() const;
+
+        // Run every timer whose deadline has passed; returns how many ran
+        size_t RunDueTimers();
+
+        // Time until the next pump or timer deadline, capped at maxWait.
+        // BeginWait also marks the loop as blocked until EndWait.
+        Duration GetWaitTime(Duration maxWait) const;
+        Duration BeginWait(Duration maxWait);
+        void EndWait();
+
+        // Counters since the previous call
+        SchedulerStats TakeStats();
+
+    private:
+        struct Timer {
+            TimerId id;
+            uint64_t dueTick;
+            Duration interval;
+            std::shared_ptr<TimerCallback> callback;
+        };
+
+    private:
+        uint64_t TickAt(TimePoint time, bool roundUp) const;
+        TimePoint TimeOfTick(uint64_t tick) const;
+
+        // Insert with the lock held; returns the due tick
+        uint64_t InsertLocked(TimerId id, uint64_t dueTick, Duration interval, std::shared_ptr<TimerCallback> callback);
+        uint64_t NextTimerTickLocked() const;
+        Duration WaitTimeLocked(TimePoint now, Duration maxWait) const;
+
+        // Wake the loop if it is blocked past `deadline` (lock held; returns true to wake)
+        bool NeedsWakeLocked(TimePoint deadline);
+
+    private:
+        NowFunction m_now;
+        Duration m_tick;
+        TimePoint m_origin;
+
+        mutable std::mutex m_mutex;
+        WakeCallback m_wake;
+
+        // CEF pump deadline (TimePoint::max() when none) and fallback
+        TimePoint m_pumpDeadline;
+        TimePoint m_lastPump;
+        Duration m_maxPumpDelay;
+
+        // Timing wheel
+        std::vector<std::vector<Timer>> m_slots;
+        std::unordered_map<TimerId, size_t> m_timerSlots;   // Timer id -> slot
+        uint64_t m_cursorTick;                              // Last tick processed
+        TimerId m_nextTimerId;
+        mutable uint64_t m_nextTimerTick;                   // Cached earliest due tick
+        mutable bool m_nextTimerDirty;
+
+        // Wait state
+        bool m_waiting;
+        TimePoint m_waitStart;
+        TimePoint m_waitUntil;
+
+        // Stats window
+        TimePoint m_windowStart;
+        Duration m_blocked;
+        SchedulerStats m_stats;
+    };
+
+} // namespace Nexile
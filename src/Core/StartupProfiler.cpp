@@ -0,0 +1,170 @@
+#include "StartupProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+namespace Nexile {
+
+    // ================== Scope ==================
+
+    StartupProfiler::Scope::Scope(StartupProfiler* profiler, const std::string& name)
+        : m_profiler(profiler) {
+        if (m_profiler) {
+            m_profiler->BeginPhase(name);
+        }
+    }
+
+    StartupProfiler::Scope::~Scope() {
+        if (m_profiler) {
+            m_profiler->EndPhase();
+        }
+    }
+
+    StartupProfiler::Scope::Scope(Scope&& other) noexcept
+        : m_profiler(other.m_profiler) {
+        other.m_profiler = nullptr;
+    }
+
+    // ================== StartupProfiler ==================
+
+    StartupProfiler::StartupProfiler(NowFunction now)
+        : m_now(now ? std::move(now) : NowFunction([]() { return Clock::now(); })) {
+        m_origin = m_now();
+    }
+
+    void StartupProfiler::BeginPhase(const std::string& name) {
+        StartupPhase phase;
+        phase.name = name;
+        phase.depth = static_cast<int>(m_openPhases.size());
+        phase.startMs = ToMs(m_now());
+
+        auto budget = m_budgets.find(name);
+        if (budget != m_budgets.end()) {
+            phase.budgetMs = budget->second;
+        }
+
+        m_openPhases.push_back(m_phases.size());
+        m_phases.push_back(std::move(phase));
+    }
+
+    void StartupProfiler::EndPhase() {
+        if (m_openPhases.empty()) return;
+
+        StartupPhase& phase = m_phases[m_openPhases.back()];
+        m_openPhases.pop_back();
+        phase.durationMs = ToMs(m_now()) - phase.startMs;
+        phase.open = false;
+    }
+
+    void StartupProfiler::Mark(const std::string& name) {
+        m_marks.push_back({name, ToMs(m_now())});
+    }
+
+    void StartupProfiler::SetBudget(const std::string& name, double budgetMs) {
+        m_budgets[name] = budgetMs;
+        for (StartupPhase& phase : m_phases) {
+            if (phase.name == name) {
+                phase.budgetMs = budgetMs;
+            }
+        }
+    }
+
+    double StartupProfiler::GetElapsedMs() const {
+        return ToMs(m_now());
+    }
+
+    std::vector<StartupPhase> StartupProfiler::GetBudgetViolations() const {
+        std::vector<StartupPhase> violations;
+        for (const StartupPhase& phase : m_phases) {
+            if (phase.OverBudget()) {
+                violations.push_back(phase);
+            }
+        }
+        return violations;
+    }
+
+    std::string StartupProfiler::GetSummary() const {
+        std::vector<const StartupPhase*> topLevel;
+        for (const StartupPhase& phase : m_phases) {
+            if (phase.depth == 0 && !phase.open) {
+                topLevel.push_back(&phase);
+            }
+        }
+        std::stable_sort(topLevel.begin(), topLevel.end(), [](const StartupPhase* a, const StartupPhase* b) {
+            return a->durationMs > b->durationMs;
+        });
+
+        std::ostringstream summary;
+        summary << std::lround(GetElapsedMs()) << "ms:";
+        for (size_t i = 0; i < topLevel.size(); i++) {
+            summary << (i == 0 ? " " : ", ") << topLevel[i]->name << " " << std::lround(topLevel[i]->durationMs) << "ms";
+            if (topLevel[i]->OverBudget()) {
+                summary << " (budget " << std::lround(topLevel[i]->budgetMs) << "ms)";
+            }
+        }
+        return summary.str();
+    }
+
+    std::string StartupProfiler::ToChromeTrace() const {
+        nlohmann::json events = nlohmann::json::array();
+
+        for (const StartupPhase& phase : m_phases) {
+            // Phases still open are drawn up to now
+            double durationMs = phase.open ? GetElapsedMs() - phase.startMs : phase.durationMs;
+            nlohmann::json event = {
+                {"name", phase.name},
+                {"cat", "startup"},
+                {"ph", "X"},
+                {"ts", phase.startMs * 1000.0},
+                {"dur", durationMs * 1000.0},
+                {"pid", 1},
+                {"tid", 1}
+            };
+            if (phase.budgetMs > 0.0) {
+                event["args"] = {{"budgetMs", phase.budgetMs}, {"overBudget", phase.OverBudget()}};
+            }
+            events.push_back(std::move(event));
+        }
+
+        for (const StartupMark& mark : m_marks) {
+            events.push_back({
+                {"name", mark.name},
+                {"cat", "startup"},
+                {"ph", "i"},
+                {"s", "g"},
+                {"ts", mark.timeMs * 1000.0},
+                {"pid", 1},
+                {"tid", 1}
+            });
+        }
+
+        nlohmann::json trace = {
+            {"traceEvents", std::move(events)},
+            {"displayTimeUnit", "ms"}
+        };
+        return trace.dump();
+    }
+
+    bool StartupProfiler::WriteChromeTrace(const std::string& path, std::string& error) const {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "Cannot open " + path + " for writing";
+            return false;
+        }
+
+        file << ToChromeTrace();
+        if (!file) {
+            error = "Failed writing " + path;
+            return false;
+        }
+        return true;
+    }
+
+    double StartupProfiler::ToMs(TimePoint time) const {
+        return std::chrono::duration<double, std::milli>(time - m_origin).count();
+    }
+
+} // namespace Nexile
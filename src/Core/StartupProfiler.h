@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexile {
+
+    // One timed startup phase; times are milliseconds since the profiler was created
+    struct StartupPhase {
+        std::string name;
+        int depth = 0;              // 0 for top-level phases
+        double startMs = 0.0;
+        double durationMs = 0.0;
+        double budgetMs = 0.0;      // 0 when the phase has no budget
+        bool open = true;           // Still running
+
+        bool OverBudget() const { return !open && budgetMs > 0.0 && durationMs > budgetMs; }
+    };
+
+    // A point in time worth seeing on the trace (tray ready, first overlay)
+    struct StartupMark {
+        std::string name;
+        double timeMs = 0.0;
+    };
+
+    // Records how long each startup phase takes.
+    //
+    // Phases nest: BeginPhase inside an open phase starts a child, and EndPhase
+    // closes the innermost one. Phase scopes do both for a block. The recording
+    // is exported as a Chrome trace (chrome://tracing, Perfetto) and as a one
+    // line summary of the top-level phases.
+    //
+    // Budgets are per phase name. Phases that exceed them are reported by
+    // GetBudgetViolations so a strict launch can refuse to continue.
+    //
+    // The clock is injectable for headless tests. UI thread only.
+    class StartupProfiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+        using NowFunction = std::function<TimePoint()>;
+
+        // Ends its phase when it goes out of scope
+        class Scope {
+        public:
+            Scope(StartupProfiler* profiler, const std::string& name);
+            ~Scope();
+            Scope(Scope&& other) noexcept;
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            Scope& operator=(Scope&&) = delete;
+
+        private:
+            StartupProfiler* m_profiler;
+        };
+
+        explicit StartupProfiler(NowFunction now = nullptr);
+
+        void BeginPhase(const std::string& name);
+        void EndPhase();
+        Scope Phase(const std::string& name) { return Scope(this, name); }
+
+        void Mark(const std::string& name);
+
+        // Budget for every phase with this name; also applies to phases already recorded
+        void SetBudget(const std::string& name, double budgetMs);
+
+        double GetElapsedMs() const;
+        const std::vector<StartupPhase>& GetPhases() const { return m_phases; }
+        const std::vector<StartupMark>& GetMarks() const { return m_marks; }
+
+        // Closed phases that took longer than their budget, in recording order
+        std::vector<StartupPhase> GetBudgetViolations() const;
+
+        // "812ms: overlay_window 420ms, modules 210ms, ..." (closed top-level phases, slowest first)
+        std::string GetSummary() const;
+
+        // Chrome trace event JSON: complete ("X") events per phase, instant ("i") per mark
+        std::string ToChromeTrace() const;
+        bool WriteChromeTrace(const std::string& path, std::string& error) const;
+
+    private:
+        double ToMs(TimePoint time) const;
+
+    private:
+        NowFunction m_now;
+        TimePoint m_origin;
+
+        std::vector<StartupPhase> m_phases;
+        std::vector<size_t> m_openPhases;       // Indices into m_phases, innermost last
+        std::vector<StartupMark> m_marks;
+        std::unordered_map<std::string, double> m_budgets;
+    };
+
+} // namespace Nexile
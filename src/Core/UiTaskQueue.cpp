@@ -0,0 +1,142 @@
+#include "UiTaskQueue.h"
+
+#include <algorithm>
+
+namespace Nexile {
+
+    UiTaskQueue::UiTaskQueue(NowFunction now) : m_now(std::move(now)) {
+    }
+
+    UiTaskQueue::~UiTaskQueue() {
+        for (Lane& lane : m_lanes) {
+            while (Node* node = Pop(lane)) {
+                delete node;
+            }
+        }
+    }
+
+    void UiTaskQueue::Push(Node* node, TaskPriority priority) {
+        Lane& lane = m_lanes[static_cast<size_t>(priority)];
+        lane.posted.fetch_add(1, std::memory_order_relaxed);
+        Link(lane, node);
+
+        // Only after linking: a drain that cleared the flag either sees the
+        // task or is followed by this wake
+        if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+            m_wakes.fetch_add(1, std::memory_order_relaxed);
+            if (m_wake) {
+                m_wake();
+            }
+        }
+    }
+
+    void UiTaskQueue::Link(Lane& lane, Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = lane.head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    UiTaskQueue::Node* UiTaskQueue::Pop(Lane& lane) {
+        Node* tail = lane.tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &lane.stub) {
+            if (!next) {
+                return nullptr;
+            }
+            lane.tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            lane.tail = next;
+            return tail;
+        }
+
+        // tail is the last linked node unless a producer has swapped the
+        // head but not linked yet
+        if (tail != lane.head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        // Put the stub behind tail so tail can be handed out
+        Link(lane, &lane.stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            lane.tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    size_t UiTaskQueue::Drain(Duration budget) {
+        m_wakePending.store(false, std::memory_order_seq_cst);
+
+        TimePoint start = Now();
+        size_t ran = 0;
+        size_t dropped = 0;
+        bool stopped = false;
+
+        for (size_t priority = 0; priority < kTaskPriorityCount && !stopped; priority++) {
+            Lane& lane = m_lanes[priority];
+            TaskLaneStats& stats = m_stats.lanes[priority];
+
+            while (Node* node = Pop(lane)) {
+                TimePoint now = Now();
+                if (now > node->deadline) {
+                    stats.expired++;
+                    dropped++;
+                } else {
+                    double latency = std::chrono::duration<double, std::milli>(now - node->posted).count();
+                    stats.run++;
+                    stats.lastLatencyMs = latency;
+                    stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+                    stats.averageLatencyMs += (latency - stats.averageLatencyMs) / static_cast<double>(stats.run);
+
+                    node->Run();
+                    ran++;
+                }
+                delete node;
+
+                if (budget != Duration::max() && Now() - start >= budget) {
+                    stopped = true;
+                    break;
+                }
+            }
+        }
+
+        if (ran + dropped > 0) {
+            m_stats.drains++;
+        }
+
+        // Whatever is left runs on the next turn of the loop, after the
+        // messages that came in meanwhile
+        if (stopped && HasPending()) {
+            m_stats.budgetStops++;
+            if (!m_wakePending.exchange(true, std::memory_order_acq_rel) && m_wake) {
+                m_wake();
+            }
+        }
+        return ran;
+    }
+
+    bool UiTaskQueue::HasPending() const {
+        for (const Lane& lane : m_lanes) {
+            if (lane.tail != &lane.stub || lane.tail->next.load(std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    UiTaskStats UiTaskQueue::GetStats() const {
+        UiTaskStats stats = m_stats;
+        for (size_t priority = 0; priority < kTaskPriorityCount; priority++) {
+            stats.lanes[priority].posted = m_lanes[priority].posted.load(std::memory_order_relaxed);
+        }
+        stats.wakes = m_wakes.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+} // namespace Nexile
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Lanes of a UiTaskQueue, drained in this order
+    enum class TaskPriority {
+        High,       // Input feedback: showing or hiding the overlay
+        Normal,     // Results and state changes
+        Low         // Anything that can wait behind the rest
+    };
+
+    constexpr size_t kTaskPriorityCount = 3;
+
+    // Counters of one lane
+    struct TaskLaneStats {
+        uint64_t posted = 0;
+        uint64_t run = 0;
+        uint64_t expired = 0;           // Dropped: still queued at their deadline
+        double lastLatencyMs = 0.0;     // Post -> run, last task
+        double maxLatencyMs = 0.0;
+        double averageLatencyMs = 0.0;  // Over all tasks run
+    };
+
+    // Counters of a UiTaskQueue
+    struct UiTaskStats {
+        TaskLaneStats lanes[kTaskPriorityCount];
+        uint64_t drains = 0;            // Drain calls that ran or dropped a task
+        uint64_t wakes = 0;             // Wake callbacks from producers
+        uint64_t budgetStops = 0;       // Drains that left tasks for the next turn
+    };
+
+    // Tasks handed to the UI thread from any other thread.
+    //
+    // Win32 windows and the CEF browser belong to the thread that created
+    // them, so background work (module workers, the game detector) posts a
+    // task instead of calling into them. Each lane is an intrusive
+    // multi-producer single-consumer list (Vyukov): Post is one allocation, an
+    // atomic exchange and a store, with no lock that the UI thread could hold
+    // up. The first Post after a drain calls the wake callback, so a burst
+    // wakes the loop once.
+    //
+    // Tasks are move-only callables, so they may own what they carry. A task
+    // still queued at its deadline is dropped unrun, for updates that are
+    // worthless once late. The clock is injectable for tests.
+    class UiTaskQueue {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+        using Duration = Clock::duration;
+        using NowFunction = std::function<TimePoint()>;
+        using WakeCallback = std::function<void()>;
+
+        explicit UiTaskQueue(NowFunction now = nullptr);
+
+        // Pending tasks are destroyed without running
+        ~UiTaskQueue();
+
+        UiTaskQueue(const UiTaskQueue&) = delete;
+        UiTaskQueue& operator=(const UiTaskQueue&) = delete;
+
+        // Set before any producer starts
+        void SetWakeCallback(WakeCallback wake) { m_wake = std::move(wake); }
+
+        // Queue task for the UI thread (any thread). It is dropped if it has
+        // not started within timeout.
+        template <typename F>
+        void Post(F&& task, TaskPriority priority = TaskPriority::Normal, Duration timeout = Duration::max()) {
+            using Task = std::decay_t<F>;
+            static_assert(std::is_invocable_v<Task&>, "UI tasks take no arguments");
+
+            TimePoint now = Now();
+            auto* node = new TaskNode<Task>(std::forward<F>(task));
+            node->posted = now;
+            node->deadline = timeout == Duration::max() ? TimePoint::max() : now + timeout;
+            Push(node, priority);
+        }
+
+        // Run queued tasks, higher lanes first, until the queue is empty or
+        // budget has passed; tasks left over wake the loop again (UI thread).
+        // Returns the number run.
+        size_t Drain(Duration budget = Duration::max());
+
+        // Whether a task is queued (UI thread)
+        bool HasPending() const;
+
+        // Counters (UI thread)
+        UiTaskStats GetStats() const;
+
+    private:
+        struct Node {
+            std::atomic<Node*> next{ nullptr };
+            TimePoint posted;
+            TimePoint deadline;
+
+            virtual ~Node() = default;
+            virtual void Run() {}
+        };
+
+        template <typename F>
+        struct TaskNode : Node {
+            explicit TaskNode(F&& f) : task(std::move(f)) {}
+            explicit TaskNode(const F& f) : task(f) {}
+            void Run() override { task(); }
+            F task;
+        };
+
+        struct Lane {
+            std::atomic<Node*> head;        // Producers append here
+            Node* tail;                     // Consumer takes from here
+            Node stub;                      // Keeps the list non-empty
+            std::atomic<uint64_t> posted{ 0 };
+
+            Lane() : head(&stub), tail(&stub) {}
+        };
+
+        TimePoint Now() const { return m_now ? m_now() : Clock::now(); }
+        void Push(Node* node, TaskPriority priority);
+        static void Link(Lane& lane, Node* node);
+
+        // Next task of a lane, or nullptr when it is empty or a producer is
+        // halfway through linking one (it wakes the loop once done)
+        static Node* Pop(Lane& lane);
+
+    private:
+        NowFunction m_now;
+        WakeCallback m_wake;
+        Lane m_lanes[kTaskPriorityCount];
+
+        // Set by the first Post after a drain started; that Post wakes the loop
+        std::atomic<bool> m_wakePending{ false };
+        std::atomic<uint64_t> m_wakes{ 0 };
+
+        // Consumer side
+        UiTaskStats m_stats;
+    };
+
+} // namespace Nexile
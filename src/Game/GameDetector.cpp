@@ -4,6 +4,8 @@
 
 namespace Nexile {
 
+    GameDetector* GameDetector::s_hookTarget = nullptr;
+
     // Helper for FindMainWindowByProcessId
     struct FindWindowData {
         DWORD processId;
@@ -39,7 +41,8 @@ namespace Nexile {
         m_currentGameId(GameID::None),
         m_currentGameWindow(NULL),
         m_manualOverride(false),
-        m_manualGameId(GameID::None) {
+        m_manualGameId(GameID::None),
+        m_trackedWindow(NULL) {
 
         // Initialize game process map
         InitializeGameProcessMap();
@@ -48,6 +51,7 @@ namespace Nexile {
     GameDetector::~GameDetector() {
         // Stop detection thread
         StopDetection();
+        StopTrackingGameWindow();
     }
 
     void GameDetector::InitializeGameProcessMap() {
@@ -107,24 +111,34 @@ namespace Nexile {
             // Detect running game
             GameID detectedGame = DetectRunningGame();
 
-            // If game changed, notify
             std::unique_lock<std::mutex> lock(m_mutex);
-            if (detectedGame != m_currentGameId) {
+            bool gameChanged = detectedGame != m_currentGameId;
+            if (gameChanged) {
                 m_currentGameId = detectedGame;
+                m_currentGameWindow = NULL;
+            }
 
-                // Find game window if a game is running
+            // The window appears some time after the process and may be
+            // recreated (display mode changes), so look until there is one
+            HWND foundWindow = NULL;
+            if (detectedGame != GameID::None &&
+                (m_currentGameWindow == NULL || !IsWindow(m_currentGameWindow))) {
                 m_currentGameWindow = NULL;
-                if (detectedGame != GameID::None) {
-                    DWORD processId = 0;
-                    if (IsProcessRunning(m_gameProcessMap[detectedGame].processName, processId)) {
-                        m_currentGameWindow = FindMainWindowByProcessId(processId);
-                    }
+                DWORD processId = 0;
+                if (IsProcessRunning(m_gameProcessMap[detectedGame].processName, processId)) {
+                    m_currentGameWindow = FindMainWindowByProcessId(processId);
+                    foundWindow = m_currentGameWindow;
                 }
+            }
 
-                // Call callback outside the lock
-                lock.unlock();
+            // Call callbacks outside the lock
+            lock.unlock();
+            if (gameChanged) {
                 ProcessCallback(detectedGame);
             }
+            if (foundWindow != NULL && m_windowFoundCallback) {
+                m_windowFoundCallback(foundWindow);
+            }
 
             // Sleep to avoid high CPU usage (check every 2 seconds)
             std::this_thread::sleep_for(std::chrono::seconds(2));
@@ -208,6 +222,15 @@ namespace Nexile {
     RECT GameDetector::GetGameWindowRect() const {
         RECT result = {};
 
+        WindowGeometry geometry = m_windowTracker.GetGeometry();
+        if (geometry.IsTracking() && !geometry.rect.IsEmpty()) {
+            result.left = geometry.rect.left;
+            result.top = geometry.rect.top;
+            result.right = geometry.rect.right;
+            result.bottom = geometry.rect.bottom;
+            return result;
+        }
+
         std::lock_guard<std::mutex> lock(m_mutex);
         if (m_currentGameWindow != NULL) {
             GetWindowRect(m_currentGameWindow, &result);
@@ -224,6 +247,11 @@ namespace Nexile {
     }
 
     bool GameDetector::IsGameFullscreen() const {
+        WindowGeometry geometry = m_windowTracker.GetGeometry();
+        if (geometry.IsTracking()) {
+            return geometry.IsFullscreen();
+        }
+
         std::lock_guard<std::mutex> lock(m_mutex);
 
         if (m_currentGameWindow == NULL) {
@@ -246,6 +274,130 @@ namespace Nexile {
             windowRect.bottom == monitorInfo.rcMonitor.bottom;
     }
 
+    void GameDetector::TrackGameWindow(HWND hwnd) {
+        StopTrackingGameWindow();
+        if (hwnd == NULL || !IsWindow(hwnd)) {
+            return;
+        }
+
+        DWORD processId = 0;
+        DWORD threadId = GetWindowThreadProcessId(hwnd, &processId);
+        s_hookTarget = this;
+        m_trackedWindow = hwnd;
+
+        // Out of context: events are posted to this thread's message loop
+        // rather than running inside the game
+        const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+        const struct {
+            DWORD first;
+            DWORD last;
+            bool gameOnly;
+        } ranges[] = {
+            { EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, true },
+            { EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY, true },
+            { EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND, true },
+            // Another process taking the foreground means the game lost it
+            { EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, false }
+        };
+        for (const auto& range : ranges) {
+            HWINEVENTHOOK hook = SetWinEventHook(range.first, range.last, NULL, WinEventProc,
+                range.gameOnly ? processId : 0, range.gameOnly ? threadId : 0, flags);
+            if (hook != NULL) {
+                m_eventHooks.push_back(hook);
+            }
+        }
+
+        WindowRect rect, monitor;
+        ReadWindowGeometry(hwnd, rect, monitor);
+        m_windowTracker.Attach(reinterpret_cast<uintptr_t>(hwnd), rect, monitor,
+            IsIconic(hwnd) != FALSE, GetForegroundWindow() == hwnd);
+    }
+
+    void GameDetector::StopTrackingGameWindow() {
+        for (HWINEVENTHOOK hook : m_eventHooks) {
+            UnhookWinEvent(hook);
+        }
+        m_eventHooks.clear();
+
+        if (m_trackedWindow != NULL) {
+            m_trackedWindow = NULL;
+            m_windowTracker.Detach();
+        }
+        if (s_hookTarget == this) {
+            s_hookTarget = nullptr;
+        }
+    }
+
+    void CALLBACK GameDetector::WinEventProc(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject,
+                                             LONG idChild, DWORD, DWORD) {
+        GameDetector* detector = s_hookTarget;
+        if (!detector || hwnd == NULL || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+            return;
+        }
+
+        uint64_t window = reinterpret_cast<uintptr_t>(hwnd);
+        WindowRect rect, monitor;
+        switch (event) {
+        case EVENT_OBJECT_LOCATIONCHANGE:
+            if (hwnd == detector->m_trackedWindow) {
+                ReadWindowGeometry(hwnd, rect, monitor);
+                detector->m_windowTracker.OnMoved(window, rect, monitor);
+            }
+            break;
+
+        case EVENT_SYSTEM_MINIMIZESTART:
+            detector->m_windowTracker.OnMinimized(window, true);
+            break;
+
+        case EVENT_SYSTEM_MINIMIZEEND:
+            // Restoring may not report a location change when nothing moved
+            detector->m_windowTracker.OnMinimized(window, false);
+            if (hwnd == detector->m_trackedWindow) {
+                ReadWindowGeometry(hwnd, rect, monitor);
+                detector->m_windowTracker.OnMoved(window, rect, monitor);
+            }
+            break;
+
+        case EVENT_SYSTEM_FOREGROUND:
+            detector->m_windowTracker.OnForeground(window);
+            break;
+
+        case EVENT_OBJECT_DESTROY:
+            // The detection thread looks for its replacement
+            if (hwnd == detector->m_trackedWindow) {
+                detector->StopTrackingGameWindow();
+            }
+            break;
+        }
+    }
+
+    void GameDetector::ReadWindowGeometry(HWND hwnd, WindowRect& rect, WindowRect& monitor) {
+        rect = WindowRect();
+        monitor = WindowRect();
+
+        if (IsIconic(hwnd)) {
+            rect.left = rect.top = WindowTracker::kMinimizedCoordinate;
+            return;
+        }
+
+        RECT client = {};
+        POINT origin = { 0, 0 };
+        if (GetClientRect(hwnd, &client) && ClientToScreen(hwnd, &origin)) {
+            rect.left = origin.x;
+            rect.top = origin.y;
+            rect.right = origin.x + client.right;
+            rect.bottom = origin.y + client.bottom;
+        }
+
+        MONITORINFO monitorInfo = { sizeof(MONITORINFO) };
+        if (GetMonitorInfo(MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST), &monitorInfo)) {
+            monitor.left = monitorInfo.rcMonitor.left;
+            monitor.top = monitorInfo.rcMonitor.top;
+            monitor.right = monitorInfo.rcMonitor.right;
+            monitor.bottom = monitorInfo.rcMonitor.bottom;
+        }
+    }
+
     void GameDetector::SetManualGameOverride(GameID gameId) {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_manualOverride = true;
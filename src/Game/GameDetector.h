@@ -6,14 +6,17 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <vector>
 
 #include "GameTypes.h"
+#include "WindowTracker.h"
 
 namespace Nexile {
 
     class GameDetector {
     public:
         using GameChangeCallback = std::function<void(GameID)>;
+        using WindowFoundCallback = std::function<void(HWND)>;
 
         GameDetector();
         ~GameDetector();
@@ -27,10 +30,24 @@ namespace Nexile {
         // Check for running games immediately
         GameID DetectRunningGame();
 
+        // Called on the detection thread when the game's main window shows up
+        // (it appears after the process) or is replaced by a new one
+        void SetWindowFoundCallback(WindowFoundCallback callback) { m_windowFoundCallback = std::move(callback); }
+
+        // Follow a window's move, resize, minimize, foreground and destroy
+        // events. UI thread: the event hooks are delivered through its
+        // message loop, and so are the tracker's change callbacks.
+        void TrackGameWindow(HWND hwnd);
+        void StopTrackingGameWindow();
+
+        // Geometry of the tracked window as of the last event
+        WindowTracker& GetWindowTracker() { return m_windowTracker; }
+
         // Get the window handle of the current game
         HWND GetGameWindowHandle() const;
 
-        // Get the window rectangle of the current game
+        // Get the client area of the current game on screen; cached while the
+        // window is tracked
         RECT GetGameWindowRect() const;
 
         // Check if game is in fullscreen mode
@@ -64,6 +81,14 @@ namespace Nexile {
         // Helper to process callback
         void ProcessCallback(GameID newGameId);
 
+        // Forwards events for the tracked window to the tracker
+        static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                          LONG idChild, DWORD eventThread, DWORD eventTime);
+
+        // Client area and monitor of a window on screen; a minimized window
+        // reports the off-screen minimized position
+        static void ReadWindowGeometry(HWND hwnd, WindowRect& rect, WindowRect& monitor);
+
     private:
         // Detection thread
         std::thread m_detectionThread;
@@ -87,6 +112,15 @@ namespace Nexile {
 
         // Game change callback
         GameChangeCallback m_gameChangeCallback;
+        WindowFoundCallback m_windowFoundCallback;
+
+        // Game window geometry, fed by WinEvent hooks (UI thread)
+        WindowTracker m_windowTracker;
+        HWND m_trackedWindow;
+        std::vector<HWINEVENTHOOK> m_eventHooks;
+
+        // Hook procedures get no context; there is one detector
+        static GameDetector* s_hookTarget;
     };
 
 } // namespace Nexile
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "ItemParser.h"
+
+#include <sstream>
+
+namespace Nexile {
+
+    namespace {
+        // Remove leading/trailing whitespace (and the CR of CRLF clipboard text)
+        std::string Trim(const std::string& text) {
+            size_t begin = text.find_first_not_of(" \t\r");
+            if (begin == std::string::npos) {
+                return "";
+            }
+            size_t end = text.find_last_not_of(" \t\r");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        bool StartsWith(const std::string& text, const char* prefix) {
+            return text.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+        }
+    }
+
+    bool ParsePoEItem(const std::string& text, ItemData& item) {
+        // Reset item
+        item = ItemData();
+
+        // Split text into lines
+        std::istringstream stream(text);
+        std::string line;
+        std::vector<std::string> lines;
+
+        while (std::getline(stream, line)) {
+            lines.push_back(Trim(line));
+        }
+
+        if (lines.empty()) {
+            return false;
+        }
+
+        // Header block: optional item class, rarity, then name and base type lines
+        size_t index = 0;
+        if (StartsWith(lines[index], "Item Class:")) {
+            item.itemClass = Trim(lines[index].substr(11));
+            index++;
+        }
+
+        if (index < lines.size() && StartsWith(lines[index], "Rarity:")) {
+            item.rarity = Trim(lines[index].substr(7));
+            index++;
+        }
+
+        // Next line is item name (if present)
+        if (index < lines.size() && !StartsWith(lines[index], "--------")) {
+            item.name = lines[index];
+            index++;
+        }
+
+        // Following line might be base type (for rare/unique items)
+        if (index < lines.size() && !StartsWith(lines[index], "--------") &&
+            (item.rarity == "Rare" || item.rarity == "Magic" || item.rarity == "Unique")) {
+            item.baseType = lines[index];
+            index++;
+        }
+
+        // Extract item level and mods (lines after a separator)
+        bool inMods = false;
+        for (; index < lines.size(); index++) {
+            const std::string& current = lines[index];
+
+            if (StartsWith(current, "--------")) {
+                inMods = true;
+                continue;
+            }
+
+            if (StartsWith(current, "Item Level:")) {
+                item.itemLevel = Trim(current.substr(11));
+            }
+
+            if (inMods && !current.empty()) {
+                item.mods.push_back(current);
+            }
+        }
+
+        return !item.name.empty() && !item.rarity.empty();
+    }
+
+    std::string GetItemProperty(const std::string& text, const std::string& label) {
+        std::istringstream stream(text);
+        std::string line;
+
+        while (std::getline(stream, line)) {
+            if (line.size() > label.size() && line.compare(0, label.size(), label) == 0 &&
+                line[label.size()] == ':') {
+                std::string value = Trim(line.substr(label.size() + 1));
+
+                // Drop annotations such as "(augmented)"
+                size_t annotation = value.find(" (");
+                if (annotation != std::string::npos) {
+                    value.erase(annotation);
+                }
+                return value;
+            }
+        }
+
+        return "";
+    }
+
+} // namespace Nexile
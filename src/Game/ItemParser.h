@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Nexile {
+
+    // Item copied from Path of Exile with Ctrl+C
+    struct ItemData {
+        std::string itemClass;          // "Maps", "Body Armours", ... (empty on old clients)
+        std::string name;
+        std::string baseType;
+        std::string rarity;
+        std::string itemLevel;
+        std::vector<std::string> mods;  // Non-empty lines after the header block
+    };
+
+    // Parse the clipboard text of a Path of Exile item.
+    // Accepts both CRLF and LF text, with or without the "Item Class:" line.
+    bool ParsePoEItem(const std::string& text, ItemData& item);
+
+    // Value of a "Label: value" property line anywhere in the item text (empty if absent)
+    std::string GetItemProperty(const std::string& text, const std::string& label);
+
+} // namespace Nexile
@@ -0,0 +1,209 @@
+#include "ModMatcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Nexile {
+
+    namespace {
+        bool IsDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        char ToLower(char c) {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        // Normalise text into out: lower-case ASCII, numbers collapsed to '#'
+        void NormalizeInto(std::string_view text, std::string& out) {
+            out.clear();
+            out.reserve(text.size());
+
+            for (size_t i = 0; i < text.size(); i++) {
+                char c = text[i];
+
+                if (IsDigit(c) || c == '#') {
+                    // A number - including "1.5" - becomes one '#'
+                    while (i + 1 < text.size() &&
+                           (IsDigit(text[i + 1]) ||
+                            (text[i + 1] == '.' && i + 2 < text.size() && IsDigit(text[i + 2])))) {
+                        i++;
+                    }
+                    out.push_back('#');
+                } else {
+                    out.push_back(ToLower(c));
+                }
+            }
+        }
+    }
+
+    ModMatcher::ModMatcher()
+        : m_classCount(1), m_compiled(false) {
+        std::memset(m_byteClass, 0, sizeof(m_byteClass));
+    }
+
+    void ModMatcher::Clear() {
+        std::memset(m_byteClass, 0, sizeof(m_byteClass));
+        m_classCount = 1;
+        m_transitions.clear();
+        m_outputs.clear();
+        m_outputLinks.clear();
+        m_duplicates.clear();
+        m_patterns.clear();
+        m_compiled = false;
+    }
+
+    std::string ModMatcher::Normalize(std::string_view text) {
+        std::string out;
+        NormalizeInto(text, out);
+        return out;
+    }
+
+    int ModMatcher::AddPattern(std::string_view pattern) {
+        std::string normalized = Normalize(pattern);
+
+        // Surrounding spaces would only make the pattern miss at line edges
+        size_t begin = normalized.find_first_not_of(' ');
+        if (begin == std::string::npos) {
+            return -1;
+        }
+        normalized = normalized.substr(begin, normalized.find_last_not_of(' ') - begin + 1);
+
+        m_patterns.push_back(std::move(normalized));
+        m_compiled = false;
+        return static_cast<int>(m_patterns.size() - 1);
+    }
+
+    void ModMatcher::Compile() {
+        // Assign byte classes to the bytes the patterns use
+        std::memset(m_byteClass, 0, sizeof(m_byteClass));
+        m_classCount = 1;
+        for (const std::string& pattern : m_patterns) {
+            for (unsigned char c : pattern) {
+                if (m_byteClass[c] == 0) {
+                    m_byteClass[c] = static_cast<uint16_t>(m_classCount++);
+                }
+            }
+        }
+
+        // Build the trie
+        m_transitions.assign(m_classCount, -1);
+        m_outputs.assign(1, -1);
+        m_duplicates.assign(m_patterns.size(), -1);
+
+        for (size_t id = 0; id < m_patterns.size(); id++) {
+            int32_t state = 0;
+            for (unsigned char c : m_patterns[id]) {
+                size_t cell = static_cast<size_t>(state) * m_classCount + m_byteClass[c];
+                if (m_transitions[cell] < 0) {
+                    int32_t next = static_cast<int32_t>(m_outputs.size());
+                    m_transitions[cell] = next;
+                    m_transitions.resize(m_transitions.size() + m_classCount, -1);
+                    m_outputs.push_back(-1);
+                }
+                state = m_transitions[cell];
+            }
+
+            // Duplicate patterns share a state and are chained behind the first id
+            if (m_outputs[state] < 0) {
+                m_outputs[state] = static_cast<int32_t>(id);
+            } else {
+                int32_t last = m_outputs[state];
+                while (m_duplicates[last] >= 0) last = m_duplicates[last];
+                m_duplicates[last] = static_cast<int32_t>(id);
+            }
+        }
+
+        // Breadth-first pass turns the trie into a DFA and links outputs
+        std::vector<int32_t> failure(m_outputs.size(), 0);
+        m_outputLinks.assign(m_outputs.size(), -1);
+
+        std::vector<int32_t> queue;
+        queue.reserve(m_outputs.size());
+
+        for (size_t cls = 0; cls < m_classCount; cls++) {
+            int32_t& next = m_transitions[cls];
+            if (next < 0) {
+                next = 0;
+            } else {
+                queue.push_back(next);
+            }
+        }
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            int32_t state = queue[head];
+            size_t row = static_cast<size_t>(state) * m_classCount;
+            size_t failRow = static_cast<size_t>(failure[state]) * m_classCount;
+
+            for (size_t cls = 0; cls < m_classCount; cls++) {
+                int32_t& next = m_transitions[row + cls];
+                if (next < 0) {
+                    next = m_transitions[failRow + cls];
+                } else {
+                    int32_t fail = m_transitions[failRow + cls];
+                    failure[next] = fail;
+                    m_outputLinks[next] = m_outputs[fail] >= 0 ? fail : m_outputLinks[fail];
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        m_compiled = true;
+    }
+
+    void ModMatcher::Match(std::string_view text, std::vector<int>& matches) const {
+        matches.clear();
+        if (!m_compiled || m_patterns.empty()) {
+            return;
+        }
+
+        std::vector<uint8_t> seen(m_patterns.size(), 0);
+        Scan(text, seen, matches);
+        std::sort(matches.begin(), matches.end());
+    }
+
+    void ModMatcher::MatchLines(const std::vector<std::string>& lines, std::vector<int>& matches) const {
+        matches.clear();
+        if (!m_compiled || m_patterns.empty()) {
+            return;
+        }
+
+        std::vector<uint8_t> seen(m_patterns.size(), 0);
+        for (const std::string& line : lines) {
+            Scan(line, seen, matches);
+        }
+        std::sort(matches.begin(), matches.end());
+    }
+
+    void ModMatcher::Scan(std::string_view text, std::vector<uint8_t>& seen, std::vector<int>& matches) const {
+        int32_t state = 0;
+
+        // Normalisation is done on the fly so the input is never copied
+        for (size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+
+            if (IsDigit(c) || c == '#') {
+                while (i + 1 < text.size() &&
+                       (IsDigit(text[i + 1]) ||
+                        (text[i + 1] == '.' && i + 2 < text.size() && IsDigit(text[i + 2])))) {
+                    i++;
+                }
+                c = '#';
+            } else {
+                c = ToLower(c);
+            }
+
+            state = Step(state, static_cast<unsigned char>(c));
+
+            for (int32_t out = m_outputs[state] >= 0 ? state : m_outputLinks[state]; out >= 0; out = m_outputLinks[out]) {
+                for (int32_t id = m_outputs[out]; id >= 0; id = m_duplicates[id]) {
+                    if (!seen[id]) {
+                        seen[id] = 1;
+                        matches.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+
+} // namespace Nexile
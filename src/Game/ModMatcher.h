@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Multi-pattern matcher for item modifier text.
+    //
+    // All patterns are compiled into one Aho-Corasick automaton, so a mod line is
+    // scanned once no matter how many patterns are registered. Patterns and
+    // input are normalised the same way before matching: ASCII is lower-cased and
+    // every number (including decimals) becomes a single '#'. A pattern written as
+    // "reflect #% of elemental damage" or copied verbatim as "reflect 18% of
+    // elemental damage" therefore matches any roll of that mod.
+    //
+    // The automaton is a dense transition table over byte classes: only bytes
+    // that occur in some pattern get their own class, everything else shares
+    // class 0, which keeps the table small enough to stay in cache.
+    class ModMatcher {
+    public:
+        ModMatcher();
+
+        // Remove all patterns
+        void Clear();
+
+        // Add a pattern; returns its id (patterns that normalise to nothing are ignored and return -1)
+        int AddPattern(std::string_view pattern);
+
+        // Build the automaton; must be called after adding patterns and before
+        // matching. Patterns added later join at the next Compile, keeping their ids.
+        void Compile();
+
+        // Collect the ids of every pattern found in the text (each id once, ascending)
+        void Match(std::string_view text, std::vector<int>& matches) const;
+
+        // Match several lines; ids are de-duplicated across lines
+        void MatchLines(const std::vector<std::string>& lines, std::vector<int>& matches) const;
+
+        // Number of registered patterns
+        size_t GetPatternCount() const { return m_patterns.size(); }
+
+        // Number of automaton states
+        size_t GetStateCount() const { return m_outputs.size(); }
+
+        // Normalise text the way patterns and input are matched
+        static std::string Normalize(std::string_view text);
+
+    private:
+        // Feed one text through the automaton, marking matched ids
+        void Scan(std::string_view text, std::vector<uint8_t>& seen, std::vector<int>& matches) const;
+
+        // Step the automaton by one normalised byte
+        int32_t Step(int32_t state, unsigned char c) const {
+            return m_transitions[static_cast<size_t>(state) * m_classCount + m_byteClass[c]];
+        }
+
+    private:
+        // Byte -> class (0 = byte not used by any pattern)
+        uint16_t m_byteClass[256];
+        size_t m_classCount;
+
+        // Trie built by AddPattern; -1 marks a missing edge until Compile fills it
+        std::vector<int32_t> m_transitions;
+
+        // Pattern id ending at each state (-1 if none)
+        std::vector<int32_t> m_outputs;
+
+        // Next pattern id with the same normalised text (-1 if none)
+        std::vector<int32_t> m_duplicates;
+
+        // Nearest state on the failure chain that has an output (-1 if none)
+        std::vector<int32_t> m_outputLinks;
+
+        // Normalised patterns by id; kept so the automaton can be rebuilt
+        std::vector<std::string> m_patterns;
+
+        bool m_compiled;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,121 @@
+#include "WindowTracker.h"
+
+namespace Nexile {
+
+    namespace {
+        bool SameGeometry(const WindowGeometry& a, const WindowGeometry& b) {
+            return a.window == b.window && a.rect == b.rect && a.monitor == b.monitor &&
+                a.minimized == b.minimized && a.foreground == b.foreground;
+        }
+
+        bool IsMinimizedRect(const WindowRect& rect) {
+            return rect.left <= WindowTracker::kMinimizedCoordinate && rect.top <= WindowTracker::kMinimizedCoordinate;
+        }
+    }
+
+    template <typename F>
+    bool WindowTracker::Update(F&& update) {
+        WindowGeometry changed;
+        ChangeCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.events++;
+
+            WindowGeometry next = m_geometry;
+            update(next);
+            if (SameGeometry(next, m_geometry)) {
+                m_stats.ignored++;
+                return false;
+            }
+
+            next.version = m_geometry.version + 1;
+            m_geometry = next;
+            m_stats.changes++;
+            changed = m_geometry;
+            callback = m_changeCallback;
+        }
+
+        if (callback) {
+            callback(changed);
+        }
+        return true;
+    }
+
+    void WindowTracker::SetChangeCallback(ChangeCallback callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_changeCallback = std::move(callback);
+    }
+
+    void WindowTracker::Attach(uint64_t window, const WindowRect& rect, const WindowRect& monitor,
+                               bool minimized, bool foreground) {
+        Update([&](WindowGeometry& geometry) {
+            if (!IsMinimizedRect(rect)) {
+                geometry.rect = rect;
+                geometry.monitor = monitor;
+            } else if (geometry.window != window) {
+                // Minimized from the start: no position known yet
+                geometry.rect = WindowRect();
+                geometry.monitor = WindowRect();
+            }
+            geometry.window = window;
+            geometry.minimized = minimized || IsMinimizedRect(rect);
+            geometry.foreground = foreground;
+        });
+    }
+
+    void WindowTracker::Detach() {
+        Update([](WindowGeometry& geometry) {
+            uint64_t version = geometry.version;
+            geometry = WindowGeometry();
+            geometry.version = version;
+        });
+    }
+
+    void WindowTracker::OnMoved(uint64_t window, const WindowRect& rect, const WindowRect& monitor) {
+        Update([&](WindowGeometry& geometry) {
+            if (window != geometry.window || geometry.window == 0) {
+                return;
+            }
+            if (IsMinimizedRect(rect)) {
+                // Moved off screen by minimizing; the minimize event may come after
+                geometry.minimized = true;
+                return;
+            }
+            geometry.rect = rect;
+            geometry.monitor = monitor;
+            geometry.minimized = false;
+        });
+    }
+
+    void WindowTracker::OnMinimized(uint64_t window, bool minimized) {
+        Update([&](WindowGeometry& geometry) {
+            if (window == geometry.window && geometry.window != 0) {
+                geometry.minimized = minimized;
+            }
+        });
+    }
+
+    void WindowTracker::OnForeground(uint64_t window) {
+        Update([&](WindowGeometry& geometry) {
+            if (geometry.window != 0) {
+                geometry.foreground = window == geometry.window;
+            }
+        });
+    }
+
+    WindowGeometry WindowTracker::GetGeometry() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_geometry;
+    }
+
+    uint64_t WindowTracker::GetVersion() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_geometry.version;
+    }
+
+    WindowTrackerStats WindowTracker::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+} // namespace Nexile
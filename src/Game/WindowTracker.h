@@ -0,0 +1,100 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Screen rectangle, right and bottom exclusive (like a Win32 RECT)
+    struct WindowRect {
+        int left = 0;
+        int top = 0;
+        int right = 0;
+        int bottom = 0;
+
+        int Width() const { return right - left; }
+        int Height() const { return bottom - top; }
+        bool IsEmpty() const { return right <= left || bottom <= top; }
+
+        bool operator==(const WindowRect& other) const {
+            return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+        }
+        bool operator!=(const WindowRect& other) const { return !(*this == other); }
+    };
+
+    // What is known about the tracked window; version changes with every field
+    struct WindowGeometry {
+        uint64_t version = 0;
+        uint64_t window = 0;            // Native handle; 0 when nothing is tracked
+        WindowRect rect;                // Client area on screen, as last seen restored
+        WindowRect monitor;             // Monitor holding most of it
+        bool minimized = false;
+        bool foreground = false;
+
+        bool IsTracking() const { return window != 0; }
+        bool IsFullscreen() const { return IsTracking() && !rect.IsEmpty() && rect == monitor; }
+    };
+
+    // Counters of a WindowTracker
+    struct WindowTrackerStats {
+        uint64_t events = 0;
+        uint64_t changes = 0;           // Events that changed the geometry
+        uint64_t ignored = 0;           // Events that changed nothing
+    };
+
+    // Geometry of the game window, kept up to date from window events.
+    //
+    // The platform side subscribes to move/resize, minimize, foreground and
+    // destroy events for the window and feeds them in here; this class is
+    // only the state machine, so it can be driven by synthetic event streams.
+    // Readers get the cached geometry and its version instead of asking the
+    // window system, and the change callback lets the overlay follow a move
+    // from within the event that reported it.
+    //
+    // A minimized window reports itself at (-32000, -32000); those moves are
+    // ignored so the last restored position survives minimizing.
+    class WindowTracker {
+    public:
+        using ChangeCallback = std::function<void(const WindowGeometry& geometry)>;
+
+        // Told about every change, after it was made (event thread)
+        void SetChangeCallback(ChangeCallback callback);
+
+        // Start tracking a window, replacing any previous one
+        void Attach(uint64_t window, const WindowRect& rect, const WindowRect& monitor,
+                    bool minimized, bool foreground);
+
+        // The window went away
+        void Detach();
+
+        // The window moved or was resized; events for other windows are ignored
+        void OnMoved(uint64_t window, const WindowRect& rect, const WindowRect& monitor);
+        void OnMinimized(uint64_t window, bool minimized);
+
+        // Some window became the foreground one
+        void OnForeground(uint64_t window);
+
+        // Current geometry (any thread)
+        WindowGeometry GetGeometry() const;
+        uint64_t GetVersion() const;
+
+        WindowTrackerStats GetStats() const;
+
+        // Coordinate Windows gives minimized windows
+        static constexpr int kMinimizedCoordinate = -32000;
+
+    private:
+        // Apply an update under the lock; returns true (and bumps the version)
+        // when the geometry changed
+        template <typename F>
+        bool Update(F&& update);
+
+    private:
+        mutable std::mutex m_mutex;
+        ChangeCallback m_changeCallback;
+        WindowGeometry m_geometry;
+        WindowTrackerStats m_stats;
+    };
+
+} // namespace Nexile
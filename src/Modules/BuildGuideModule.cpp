@@ -0,0 +1,564 @@
+#include "BuildGuideModule.h"
+#include "../Core/NexileApp.h"
+#include "../Input/HotkeyManager.h"
+#include "../UI/OverlayWindow.h"
+#include "../Utils/Utils.h"
+#include "../Utils/Logger.h"
+
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <chrono>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        // Passive node id of a "tree:<id>" or "node:<id>" checklist key. Keys come
+        // from the page and from disk, so anything but a whole uint32 is refused.
+        bool ParseNodeKey(const std::string& key, const char* prefix, uint32_t& id) {
+            if (key.compare(0, 5, prefix) != 0 || key.size() == 5) {
+                return false;
+            }
+            const char* end = key.data() + key.size();
+            auto [ptr, ec] = std::from_chars(key.data() + 5, end, id);
+            return ec == std::errc() && ptr == end;
+        }
+    }
+
+    BuildGuideModule::BuildGuideModule()
+        : m_hasBuild(false), m_lastDecodeMs(0.0), m_pathfinder(m_passiveTree), m_allocatedPassives(0) {
+        // Initialize here
+    }
+
+    BuildGuideModule::~BuildGuideModule() {
+        // Cleanup
+    }
+
+    std::string BuildGuideModule::GetModuleID() const {
+        return "build_guide";
+    }
+
+    std::string BuildGuideModule::GetModuleName() const {
+        return "Build Guide";
+    }
+
+    std::string BuildGuideModule::GetModuleDescription() const {
+        return "Checklist for a Path of Building build";
+    }
+
+    std::string BuildGuideModule::GetModuleVersion() const {
+        return "1.0.0";
+    }
+
+    std::string BuildGuideModule::GetModuleAuthor() const {
+        return "Nexile Team";
+    }
+
+    bool BuildGuideModule::SupportsGame(GameID gameId) const {
+        // Path of Building only covers Path of Exile
+        return gameId == GameID::PathOfExile;
+    }
+
+    std::string BuildGuideModule::GetModuleUIHTML() const {
+        return R"(
+        <!DOCTYPE html>
+        <html>
+        <head>
+            <meta charset="utf-8">
+            <title>Build Guide</title>
+            <style>
+                body {
+                    background-color: rgba(30, 30, 30, 0.85);
+                    color: #e0e0e0;
+                    font-family: 'Segoe UI', sans-serif;
+                    padding: 16px;
+                    margin: 0;
+                }
+                h2 { color: #4a90e2; margin: 0 0 4px 0; }
+                h3 { color: #9aa5b1; font-weight: normal; margin: 16px 0 6px 0; }
+                .summary { color: #9aa5b1; margin-bottom: 8px; }
+                .error { color: #e25c5c; }
+                .entry { display: flex; align-items: center; padding: 3px 0; cursor: pointer; }
+                .entry input { margin-right: 8px; }
+                .entry.done span { color: #6c757d; text-decoration: line-through; }
+                .support { color: #8fb3d9; }
+                textarea { width: 100%; height: 48px; background: #222; color: #ddd; border: 1px solid #444; }
+                button {
+                    background-color: #4a90e2; color: white; border: none;
+                    padding: 6px 12px; border-radius: 4px; cursor: pointer; margin-top: 4px;
+                }
+            </style>
+        </head>
+        <body>
+            <h2 id="build-title">Build Guide</h2>
+            <div id="build-summary" class="summary">Copy a Path of Building code and press the build guide hotkey, or paste it below.</div>
+            <textarea id="build-code" placeholder="Path of Building export code"></textarea>
+            <button id="import-button">Import</button>
+            <div id="build-checklist"></div>
+            <script>
+                function sendMessage(data) {
+                    if (window.nexile && window.nexile.postMessage) {
+                        window.nexile.postMessage(data);
+                    }
+                }
+
+                function addSection(container, title, entries) {
+                    if (!entries.length) return;
+                    const header = document.createElement('h3');
+                    header.textContent = title;
+                    container.appendChild(header);
+
+                    for (const entry of entries) {
+                        const row = document.createElement('label');
+                        row.className = 'entry' + (entry.done ? ' done' : '');
+
+                        const box = document.createElement('input');
+                        box.type = 'checkbox';
+                        box.checked = entry.done;
+                        box.addEventListener('change', function() {
+                            row.classList.toggle('done', box.checked);
+                            sendMessage({ action: 'build_guide_toggle', key: entry.key, done: box.checked });
+                        });
+
+                        const text = document.createElement('span');
+                        text.textContent = entry.text;
+                        if (entry.support) text.className = 'support';
+
+                        row.appendChild(box);
+                        row.appendChild(text);
+                        container.appendChild(row);
+                    }
+                }
+
+                function updateBuildGuide(data) {
+                    const title = document.getElementById('build-title');
+                    const summary = document.getElementById('build-summary');
+                    const checklist = document.getElementById('build-checklist');
+                    checklist.textContent = '';
+
+                    if (data.error) {
+                        summary.textContent = data.error;
+                        summary.className = 'summary error';
+                        return;
+                    }
+
+                    summary.className = 'summary';
+                    if (!data.loaded) return;
+
+                    title.textContent = 'Level ' + data.level + ' ' + (data.ascendancy || data.className);
+                    summary.textContent = data.treeNodes + ' passive points, tree ' + data.treeVersion +
+                        ' (decoded in ' + data.decodeMs.toFixed(2) + ' ms)';
+                    if (data.treeRemaining !== undefined) {
+                        summary.textContent += ' - ' + data.treeAllocated + ' allocated, ' +
+                            data.treeRemaining + ' to go';
+                    }
+
+                    for (const section of data.sections) {
+                        addSection(checklist, section.title, section.entries);
+                    }
+                }
+
+                document.getElementById('import-button').addEventListener('click', function() {
+                    const code = document.getElementById('build-code').value.trim();
+                    if (code) sendMessage({ action: 'build_guide_import', code: code });
+                });
+
+                window.addEventListener('message', function(event) {
+                    const message = event.data;
+                    if (message && message.module === 'build_guide') {
+                        updateBuildGuide(message.data);
+                    }
+                });
+
+                sendMessage({ action: 'build_guide_get' });
+            </script>
+        </body>
+        </html>
+    )";
+    }
+
+    void BuildGuideModule::OnLoad() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (app) {
+            // Register hotkey for the build guide (Alt+G)
+            HotkeyManager* hotkeyManager = app->GetProfileManager()->GetHotkeyManager();
+            if (hotkeyManager) {
+                hotkeyManager->RegisterHotkey(MOD_ALT, 'G', HotkeyManager::HOTKEY_BUILD_GUIDE);
+            }
+
+            OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+            if (overlay) {
+                overlay->RegisterAction(GetModuleID(), "build_guide_get", [this](const ActionMessage&) {
+                    UpdateUI();
+                    });
+                overlay->RegisterAction(GetModuleID(), "build_guide_import", [this](const ActionMessage& msg) {
+                    ImportBuildCode(msg.Json().value("code", ""));
+                    });
+                overlay->RegisterAction(GetModuleID(), "build_guide_toggle", [this](const ActionMessage& msg) {
+                    const json& data = msg.Json();
+                    ToggleEntry(data.value("key", ""), data.value("done", false));
+                    });
+            }
+        }
+
+        LoadPassiveTree();
+        LoadState();
+    }
+
+    void BuildGuideModule::OnUnload() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (app) {
+            HotkeyManager* hotkeyManager = app->GetProfileManager()->GetHotkeyManager();
+            if (hotkeyManager) {
+                hotkeyManager->UnregisterHotkey(HotkeyManager::HOTKEY_BUILD_GUIDE);
+            }
+        }
+
+        SaveState();
+    }
+
+    void BuildGuideModule::OnGameChanged() {
+        // Update enabled state based on game
+        m_enabled = SupportsGame(m_currentGame);
+    }
+
+    void BuildGuideModule::OnHotkeyPressed(int hotkeyId) {
+        if (!m_enabled || hotkeyId != HotkeyManager::HOTKEY_BUILD_GUIDE) {
+            return;
+        }
+
+        // A build code on the clipboard replaces the current guide. Codes
+        // copied from pastebins and forums often carry a trailing newline.
+        std::string clipboard;
+        if (Utils::ReadClipboardText(clipboard)) {
+            const char* whitespace = " \t\r\n";
+            size_t first = clipboard.find_first_not_of(whitespace);
+            size_t last = clipboard.find_last_not_of(whitespace);
+            std::string code = first == std::string::npos ? std::string() : clipboard.substr(first, last - first + 1);
+
+            if (code.size() > 64 && code.find_first_of(" \t\r\n:") == std::string::npos) {
+                ImportBuildCode(code);
+            }
+        }
+
+        NexileApp* app = NexileApp::GetInstance();
+        if (app && app->GetModule("build_guide")) {
+            app->SetOverlayVisible(true);
+            app->GetProfileManager()->GetOverlayWindow()->LoadModuleUI(app->GetModule("build_guide"));
+        }
+    }
+
+    bool BuildGuideModule::ImportBuildCode(const std::string& code) {
+        bool imported = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto start = std::chrono::steady_clock::now();
+
+            BuildModel build;
+            std::string error;
+            imported = m_decoder.Decode(code, build, error);
+
+            double decodeMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            if (!imported) {
+                m_lastError = "Could not import build: " + error;
+                LOG_WARNING("Build guide import failed: {}", error);
+            } else {
+                // A different build resets the checklist
+                if (code != m_buildCode) {
+                    m_completed.clear();
+                }
+
+                m_build = std::move(build);
+                m_buildCode = code;
+                m_hasBuild = true;
+                m_lastDecodeMs = decodeMs;
+                m_lastError.clear();
+
+                PlanPassives();
+
+                LOG_INFO("Imported build: level {} {} ({} nodes, {} items, {} skill groups) in {}ms",
+                         m_build.level, m_build.className, m_build.treeNodes.size(),
+                         m_build.items.size(), m_build.skillGroups.size(), decodeMs);
+            }
+        }
+
+        if (imported) {
+            SaveState();
+        }
+
+        UpdateUI();
+        return imported;
+    }
+
+    void BuildGuideModule::ToggleEntry(const std::string& key, bool done) {
+        if (key.empty()) {
+            return;
+        }
+
+        bool replanned = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint32_t id = 0;
+            if (key.compare(0, 5, "tree:") == 0) {
+                // Checking a passive step allocates its whole path
+                if (!ParseNodeKey(key, "tree:", id)) {
+                    LOG_WARNING("Ignoring malformed build guide key: {}", key);
+                    return;
+                }
+                if (done) {
+                    AllocatePlanStep(id);
+                    PlanPassives();
+                    replanned = true;
+                }
+            } else if (key.compare(0, 5, "node:") == 0 && !ParseNodeKey(key, "node:", id)) {
+                LOG_WARNING("Ignoring malformed build guide key: {}", key);
+                return;
+            } else if (done) {
+                m_completed.insert(key);
+            } else {
+                m_completed.erase(key);
+            }
+        }
+        SaveState();
+
+        if (replanned) {
+            UpdateUI();
+        }
+    }
+
+    void BuildGuideModule::UpdateUI() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (!app) return;
+
+        OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+        if (!overlay) return;
+
+        json data;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            data["loaded"] = m_hasBuild;
+            if (!m_lastError.empty()) {
+                data["error"] = m_lastError;
+            }
+
+            if (m_hasBuild) {
+                data["level"] = m_build.level;
+                data["className"] = m_build.className;
+                data["ascendancy"] = m_build.ascendancy;
+                data["treeVersion"] = m_build.treeVersion;
+                data["treeNodes"] = m_build.treeNodes.size();
+                data["decodeMs"] = m_lastDecodeMs;
+
+                json gems = json::array();
+                for (size_t group = 0; group < m_build.skillGroups.size(); group++) {
+                    const BuildSkillGroup& skillGroup = m_build.skillGroups[group];
+                    if (!skillGroup.enabled) continue;
+
+                    for (const BuildGem& gem : skillGroup.gems) {
+                        if (!gem.enabled || gem.name.empty()) continue;
+
+                        std::string key = "gem:" + std::to_string(group) + ":" + gem.name;
+                        std::string text = gem.name + " (" + std::to_string(gem.level) + "/" +
+                                           std::to_string(gem.quality) + ")";
+                        if (!skillGroup.slot.empty()) text += " - " + skillGroup.slot;
+
+                        gems.push_back({
+                            {"key", key}, {"text", text}, {"support", gem.support},
+                            {"done", m_completed.count(key) > 0}
+                        });
+                    }
+                }
+
+                json items = json::array();
+                for (const BuildItem& item : m_build.items) {
+                    std::string key = "item:" + std::to_string(item.id);
+                    std::string text = item.name;
+                    if (!item.baseType.empty() && item.baseType != item.name) text += ", " + item.baseType;
+
+                    items.push_back({
+                        {"key", key}, {"text", text}, {"support", false},
+                        {"done", m_completed.count(key) > 0}
+                    });
+                }
+
+                // Next few passive paths in allocation order
+                json passives = json::array();
+                for (size_t i = 0; i < m_plan.steps.size() && i < 10; i++) {
+                    const PassivePathStep& step = m_plan.steps[i];
+                    const PassiveNode& target = m_passiveTree.GetNode(step.target);
+
+                    std::string text = target.name.empty() ? "Passive " + std::to_string(target.id) : target.name;
+                    if (step.path.size() > 1) text += " (" + std::to_string(step.path.size()) + " points)";
+
+                    passives.push_back({
+                        {"key", "tree:" + std::to_string(target.id)}, {"text", text},
+                        {"support", target.kind == PassiveNodeKind::Normal}, {"done", false}
+                    });
+                }
+
+                if (m_passiveTree.IsLoaded()) {
+                    data["treeAllocated"] = m_allocatedPassives;
+                    data["treeRemaining"] = m_plan.pointCount;
+                }
+
+                data["sections"] = json::array({
+                    {{"title", "Passive Tree"}, {"entries", passives}},
+                    {{"title", "Skill Gems"}, {"entries", gems}},
+                    {{"title", "Items"}, {"entries", items}}
+                });
+            }
+        }
+
+        std::wstringstream script;
+        script << L"window.postMessage({";
+        script << L"module: 'build_guide',";
+        script << L"data: " << Utils::StringToWideString(data.dump());
+        script << L"}, '*');";
+
+        overlay->ExecuteScript(script.str(), "build_guide");
+    }
+
+    void BuildGuideModule::SaveState() {
+        json state;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_hasBuild) return;
+
+            state["code"] = m_buildCode;
+            state["completed"] = m_completed;
+        }
+
+        if (!Utils::WriteTextFile(GetStatePath(), state.dump())) {
+            LOG_WARNING("Failed to save build guide state");
+        }
+    }
+
+    void BuildGuideModule::LoadState() {
+        std::string path = GetStatePath();
+        if (!Utils::FileExists(path)) {
+            return;
+        }
+
+        try {
+            json state = json::parse(Utils::ReadTextFile(path));
+            std::string code = state.value("code", "");
+            if (code.empty()) return;
+
+            {
+                // Restore progress first; importing the same code keeps it
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_buildCode = code;
+                if (state.contains("completed")) {
+                    m_completed = state["completed"].get<std::set<std::string>>();
+
+                    // Drop node keys a hand edit or an older version left unparsable
+                    uint32_t id = 0;
+                    for (auto it = m_completed.begin(); it != m_completed.end();) {
+                        if (it->compare(0, 5, "node:") == 0 && !ParseNodeKey(*it, "node:", id)) {
+                            it = m_completed.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+                }
+            }
+
+            ImportBuildCode(code);
+        }
+        catch (const std::exception& e) {
+            LOG_WARNING("Ignoring unreadable build guide state: {}", e.what());
+        }
+    }
+
+    std::string BuildGuideModule::GetStatePath() const {
+        return Utils::CombinePath(Utils::GetAppDataPath(), "build_guide.json");
+    }
+
+    void BuildGuideModule::LoadPassiveTree() {
+        // Tree data as published by GGG (data.json of the skill tree export)
+        std::string path = Utils::CombinePath(Utils::GetAppDataPath(), "passive_tree.json");
+        if (!Utils::FileExists(path)) {
+            LOG_INFO("No passive tree data at {}, passive planning disabled", path);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::string error;
+        if (!m_passiveTree.LoadFromJson(Utils::ReadTextFile(path), error)) {
+            LOG_WARNING("Failed to load passive tree data: {}", error);
+            m_passiveTree.Clear();
+            m_pathfinder.Reset();
+            return;
+        }
+
+        m_pathfinder.Reset();
+
+        LOG_INFO("Loaded passive tree {}: {} nodes, {} edges",
+                 m_passiveTree.GetVersion(), m_passiveTree.GetNodeCount(), m_passiveTree.GetEdgeCount());
+    }
+
+    void BuildGuideModule::PlanPassives() {
+        m_plan.Clear();
+        m_allocatedPassives = 0;
+
+        if (!m_hasBuild || !m_passiveTree.IsLoaded()) {
+            return;
+        }
+
+        int start = m_passiveTree.FindClassStart(m_build.className);
+        if (start < 0) {
+            LOG_WARNING("Passive tree has no start node for class {}", m_build.className);
+            return;
+        }
+
+        m_pathfinder.BlockOtherClassStarts(start);
+
+        PassiveNodeSet allocated(m_passiveTree.GetNodeCount());
+        allocated.Set(start);
+        for (const std::string& key : m_completed) {
+            uint32_t id = 0;
+            if (!ParseNodeKey(key, "node:", id)) continue;
+
+            int index = m_passiveTree.FindNode(id);
+            if (index >= 0) {
+                allocated.Set(index);
+                m_allocatedPassives++;
+            }
+        }
+
+        // Ascendancy and mastery nodes in the export are not part of the graph
+        std::vector<int> targets;
+        targets.reserve(m_build.treeNodes.size());
+        for (uint32_t id : m_build.treeNodes) {
+            int index = m_passiveTree.FindNode(id);
+            if (index >= 0) {
+                targets.push_back(index);
+            }
+        }
+
+        m_pathfinder.PlanAllocation(allocated, targets, m_plan);
+
+        LOG_DEBUG("Passive plan: {} steps, {} points, {} unreachable in {}ms",
+                  m_plan.steps.size(), m_plan.pointCount, m_plan.unreachable.size(),
+                  m_pathfinder.GetLastPlanMilliseconds());
+    }
+
+    void BuildGuideModule::AllocatePlanStep(uint32_t targetId) {
+        for (const PassivePathStep& step : m_plan.steps) {
+            if (m_passiveTree.GetNode(step.target).id != targetId) continue;
+
+            for (int node : step.path) {
+                m_completed.insert("node:" + std::to_string(m_passiveTree.GetNode(node).id));
+            }
+            return;
+        }
+    }
+
+} // namespace Nexile
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ModuleInterface.h"
+#include "../Build/BuildModel.h"
+#include "../Build/BuildCodeDecoder.h"
+#include "../Build/PassiveTree.h"
+#include "../Build/PassivePathfinder.h"
+#include <string>
+#include <set>
+#include <mutex>
+
+namespace Nexile {
+
+    // Build guide for Path of Exile, driven by Path of Building export codes
+    class BuildGuideModule : public ModuleBase {
+    public:
+        BuildGuideModule();
+        ~BuildGuideModule() override;
+
+        // IModule implementation
+        std::string GetModuleID() const override;
+        std::string GetModuleName() const override;
+        std::string GetModuleDescription() const override;
+        std::string GetModuleVersion() const override;
+        std::string GetModuleAuthor() const override;
+        bool SupportsGame(GameID gameId) const override;
+        std::string GetModuleUIHTML() const override;
+        void OnHotkeyPressed(int hotkeyId) override;
+
+        // Import a Path of Building export code
+        bool ImportBuildCode(const std::string& code);
+
+    protected:
+        // ModuleBase overrides
+        void OnLoad() override;
+        void OnUnload() override;
+        void OnGameChanged() override;
+
+    private:
+        // Check or uncheck a checklist entry from the UI
+        void ToggleEntry(const std::string& key, bool done);
+
+        // Send the checklist to the overlay
+        void UpdateUI();
+
+        // Persist the imported code and checklist progress
+        void SaveState();
+
+        // Restore the last imported build
+        void LoadState();
+
+        // Get the path of the saved guide state
+        std::string GetStatePath() const;
+
+        // Load the passive tree data file if present
+        void LoadPassiveTree();
+
+        // Recompute the allocation plan from the checked-off nodes (caller holds m_mutex)
+        void PlanPassives();
+
+        // Check off every node on the path to a planned target (caller holds m_mutex)
+        void AllocatePlanStep(uint32_t targetId);
+
+    private:
+        // Mutex for thread safety
+        std::mutex m_mutex;
+
+        // Decoder with reusable buffers
+        BuildCodeDecoder m_decoder;
+
+        // Current build
+        BuildModel m_build;
+        std::string m_buildCode;
+        bool m_hasBuild;
+        double m_lastDecodeMs;
+
+        // Checklist entries the user has completed ("node:<id>" for allocated passives)
+        std::set<std::string> m_completed;
+
+        // Passive tree graph and planner
+        PassiveTree m_passiveTree;
+        PassivePathfinder m_pathfinder;
+        PassivePlan m_plan;
+        size_t m_allocatedPassives;
+
+        // Last import error (empty on success)
+        std::string m_lastError;
+    };
+
+} // namespace Nexile
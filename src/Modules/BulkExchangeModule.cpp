@@ -0,0 +1,268 @@
+#include "BulkExchangeModule.h"
+#include "../Core/NexileApp.h"
+#include "../UI/OverlayWindow.h"
+#include "../Utils/Utils.h"
+#include "../Utils/Logger.h"
+
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <cstdio>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        // One table row per cycle; the cells are formatted by UpdateUI
+        const char* kCycleRowsTemplate =
+            "{{#cycles}}<tr>"
+            "<td>{{route}}</td>"
+            "<td class=\"profit\">{{margin}}</td>"
+            "<td>{{depth}}</td>"
+            "<td>{{expected}}</td>"
+            "</tr>{{/cycles}}";
+
+        std::string FormatFixed(double value, int decimals, const char* suffix = "") {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%.*f%s", decimals, value, suffix);
+            return buffer;
+        }
+    }
+
+    BulkExchangeModule::BulkExchangeModule() {
+        std::string error;
+        if (!m_cycleTemplate.Compile(kCycleRowsTemplate, error)) {
+            LOG_ERROR("Invalid bulk exchange cycle template: {}", error);
+        }
+    }
+
+    BulkExchangeModule::~BulkExchangeModule() {
+        // Cleanup
+    }
+
+    std::string BulkExchangeModule::GetModuleID() const {
+        return "bulk_exchange";
+    }
+
+    std::string BulkExchangeModule::GetModuleName() const {
+        return "Bulk Exchange";
+    }
+
+    std::string BulkExchangeModule::GetModuleDescription() const {
+        return "Finds profitable currency trade cycles in bulk exchange ratios";
+    }
+
+    std::string BulkExchangeModule::GetModuleVersion() const {
+        return "1.0.0";
+    }
+
+    std::string BulkExchangeModule::GetModuleAuthor() const {
+        return "Nexile Team";
+    }
+
+    bool BulkExchangeModule::SupportsGame(GameID gameId) const {
+        // Bulk exchange exists in Path of Exile and Path of Exile 2
+        return gameId == GameID::PathOfExile || gameId == GameID::PathOfExile2;
+    }
+
+    std::string BulkExchangeModule::GetModuleUIHTML() const {
+        return R"(
+        <!DOCTYPE html>
+        <html>
+        <head>
+            <meta charset="utf-8">
+            <title>Bulk Exchange</title>
+            <style>
+                body {
+                    background-color: rgba(30, 30, 30, 0.85);
+                    color: #e0e0e0;
+                    font-family: 'Segoe UI', sans-serif;
+                    padding: 16px;
+                    margin: 0;
+                }
+                h2 { color: #4a90e2; margin: 0 0 12px 0; }
+                table { width: 100%; border-collapse: collapse; }
+                th, td { text-align: left; padding: 6px 8px; border-bottom: 1px solid rgba(255, 255, 255, 0.1); }
+                th { color: #9aa5b1; font-weight: normal; }
+                .profit { color: #6fcf6f; }
+                .status { color: #9aa5b1; margin-bottom: 8px; }
+                .error { color: #e25c5c; }
+                button {
+                    background-color: #4a90e2; color: white; border: none;
+                    padding: 6px 12px; border-radius: 4px; cursor: pointer; float: right;
+                }
+            </style>
+        </head>
+        <body>
+            <button id="refresh-button">Refresh</button>
+            <h2>Bulk Exchange Cycles</h2>
+            <div id="bulk-status" class="status">Waiting for ratio data...</div>
+            <table>
+                <thead><tr><th>Trades</th><th>Margin</th><th>Depth</th><th>Expected (chaos)</th></tr></thead>
+                <tbody id="bulk-cycles"></tbody>
+            </table>
+            <script>
+                function sendMessage(data) {
+                    if (window.nexile && window.nexile.postMessage) {
+                        window.nexile.postMessage(data);
+                    }
+                }
+
+                function updateBulkExchange(data) {
+                    const status = document.getElementById('bulk-status');
+                    const body = document.getElementById('bulk-cycles');
+                    body.textContent = '';
+
+                    if (data.error) {
+                        status.textContent = data.error;
+                        status.className = 'status error';
+                        return;
+                    }
+
+                    status.className = 'status';
+                    status.textContent = data.currencies + ' currencies, ' + data.pairs + ' pairs scanned in ' +
+                        data.scanMs.toFixed(2) + ' ms';
+
+                    body.innerHTML = data.cyclesHtml;
+                }
+
+                document.getElementById('refresh-button').addEventListener('click', function() {
+                    sendMessage({ action: 'bulk_exchange_refresh' });
+                });
+
+                window.addEventListener('message', function(event) {
+                    const message = event.data;
+                    if (message && message.module === 'bulk_exchange') {
+                        updateBulkExchange(message.data);
+                    }
+                });
+
+                sendMessage({ action: 'bulk_exchange_get_results' });
+            </script>
+        </body>
+        </html>
+    )";
+    }
+
+    void BulkExchangeModule::OnLoad() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (app) {
+            OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+            if (overlay) {
+                overlay->RegisterAction(GetModuleID(), "bulk_exchange_refresh", [this](const ActionMessage&) {
+                    RefreshFromSnapshotFile();
+                    });
+                overlay->RegisterAction(GetModuleID(), "bulk_exchange_get_results", [this](const ActionMessage&) {
+                    UpdateUI();
+                    });
+            }
+        }
+
+        RefreshFromSnapshotFile();
+    }
+
+    void BulkExchangeModule::OnUnload() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_graph.Clear();
+    }
+
+    void BulkExchangeModule::OnGameChanged() {
+        // Update enabled state based on game
+        m_enabled = SupportsGame(m_currentGame);
+    }
+
+    void BulkExchangeModule::OnHotkeyPressed(int hotkeyId) {
+        // No dedicated hotkey; the module is opened from the overlay
+    }
+
+    bool BulkExchangeModule::UpdateRatioBook(const std::string& snapshotJson) {
+        bool loaded = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            std::string error;
+            loaded = m_graph.LoadSnapshot(snapshotJson, error);
+            if (!loaded) {
+                m_lastError = error;
+                LOG_ERROR("Failed to load bulk exchange ratios: {}", error);
+            } else {
+                m_lastError.clear();
+                m_scanner.Scan(m_graph);
+                LOG_INFO("Bulk exchange scan: {} currencies, {} pairs, {} cycles in {}ms",
+                         m_graph.GetCurrencyCount(), m_graph.GetEdgeCount(),
+                         m_scanner.GetResults().size(), m_scanner.GetLastScanMilliseconds());
+            }
+        }
+
+        UpdateUI();
+        return loaded;
+    }
+
+    void BulkExchangeModule::RefreshFromSnapshotFile() {
+        std::string path = GetSnapshotPath();
+        if (!Utils::FileExists(path)) {
+            LOG_INFO("No bulk exchange ratio snapshot at {}", path);
+            return;
+        }
+
+        UpdateRatioBook(Utils::ReadTextFile(path));
+    }
+
+    void BulkExchangeModule::UpdateUI() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (!app) return;
+
+        OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+        if (!overlay) return;
+
+        json data;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!m_lastError.empty()) {
+                data["error"] = m_lastError;
+            } else {
+                data["currencies"] = m_graph.GetCurrencyCount();
+                data["pairs"] = m_graph.GetEdgeCount();
+                data["scanMs"] = m_scanner.GetLastScanMilliseconds();
+
+                json table = { {"cycles", json::array()} };
+                for (const ArbitrageCycle& cycle : m_scanner.GetResults()) {
+                    const std::string& start = m_graph.GetCurrency(cycle.currencies.front()).name;
+
+                    std::string route;
+                    for (int currency : cycle.currencies) {
+                        route += m_graph.GetCurrency(currency).name;
+                        route += " \xE2\x86\x92 ";    // U+2192 rightwards arrow
+                    }
+                    route += start;
+
+                    table["cycles"].push_back({
+                        {"route", route},
+                        {"margin", FormatFixed(cycle.profitFraction * 100.0, 2, "%")},
+                        {"depth", cycle.maxVolume > 0 ? FormatFixed(cycle.maxVolume, 1, " ") + start : "unknown"},
+                        {"expected", FormatFixed(cycle.expectedProfitChaos, 1)}
+                    });
+                }
+
+                // The buffer keeps its capacity from one scan to the next
+                m_cyclesHtml.clear();
+                m_cycleTemplate.Render(table, m_cyclesHtml);
+                data["cyclesHtml"] = m_cyclesHtml;
+            }
+        }
+
+        std::wstringstream script;
+        script << L"window.postMessage({";
+        script << L"module: 'bulk_exchange',";
+        script << L"data: " << Utils::StringToWideString(data.dump());
+        script << L"}, '*');";
+
+        overlay->ExecuteScript(script.str(), "bulk_exchange");
+    }
+
+    std::string BulkExchangeModule::GetSnapshotPath() const {
+        return Utils::CombinePath(Utils::GetAppDataPath(), "bulk_ratios.json");
+    }
+
+} // namespace Nexile
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ModuleInterface.h"
+#include "../Trade/CurrencyGraph.h"
+#include "../Trade/ArbitrageScanner.h"
+#include "../UI/HtmlTemplate.h"
+#include <string>
+#include <mutex>
+
+namespace Nexile {
+
+    // Bulk exchange arbitrage scanner for Path of Exile
+    class BulkExchangeModule : public ModuleBase {
+    public:
+        BulkExchangeModule();
+        ~BulkExchangeModule() override;
+
+        // IModule implementation
+        std::string GetModuleID() const override;
+        std::string GetModuleName() const override;
+        std::string GetModuleDescription() const override;
+        std::string GetModuleVersion() const override;
+        std::string GetModuleAuthor() const override;
+        bool SupportsGame(GameID gameId) const override;
+        std::string GetModuleUIHTML() const override;
+        void OnHotkeyPressed(int hotkeyId) override;
+
+        // Ingest a fresh ratio book and rescan it
+        bool UpdateRatioBook(const std::string& snapshotJson);
+
+    protected:
+        // ModuleBase overrides
+        void OnLoad() override;
+        void OnUnload() override;
+        void OnGameChanged() override;
+
+    private:
+        // Reload the ratio snapshot from disk
+        void RefreshFromSnapshotFile();
+
+        // Send ranked cycles to the overlay
+        void UpdateUI();
+
+        // Get the path of the recorded ratio snapshot
+        std::string GetSnapshotPath() const;
+
+    private:
+        // Mutex for thread safety
+        std::mutex m_mutex;
+
+        // Latest ratio book
+        CurrencyGraph m_graph;
+
+        // Scanner with reusable work buffers
+        ArbitrageScanner m_scanner;
+
+        // Last ingest error (empty on success)
+        std::string m_lastError;
+
+        // Cycle table body, rendered here so the page sets it in one go
+        HtmlTemplate m_cycleTemplate;
+        std::string m_cyclesHtml;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,404 @@
+#include "MapModule.h"
+#include "../Core/NexileApp.h"
+#include "../Input/HotkeyManager.h"
+#include "../UI/OverlayWindow.h"
+#include "../Utils/Utils.h"
+#include "../Utils/Logger.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        // Danger list written on first run; users edit map_dangers.json to tune it
+        const MapDangerRule kDefaultRules[] = {
+            { "Monsters reflect #% of Elemental Damage", "deadly", "Elemental reflect" },
+            { "Monsters reflect #% of Physical Damage", "deadly", "Physical reflect" },
+            { "Players cannot Regenerate Life, Mana or Energy Shield", "deadly", "No regeneration" },
+            { "less Recovery Rate of Life and Energy Shield", "danger", "Reduced recovery" },
+            { "Cannot Leech Life from Monsters", "danger", "No leech" },
+            { "Players are Cursed with Temporal Chains", "danger", "Temporal Chains" },
+            { "Players are Cursed with Elemental Weakness", "warning", "Elemental Weakness" },
+            { "Players are Cursed with Vulnerability", "warning", "Vulnerability" },
+            { "Players have #% less Armour", "warning", "Less armour" },
+            { "Monsters have #% chance to Avoid Elemental Ailments", "warning", "Ailment avoidance" },
+            { "extra Physical Damage as", "warning", "Extra damage" },
+            { "additional Projectiles", "warning", "Extra projectiles" },
+            { "Monsters' skills Chain # additional times", "warning", "Chaining skills" },
+            { "increased Critical Strike Chance", "warning", "Monster crits" },
+        };
+
+        int SeverityRank(const std::string& severity) {
+            if (severity == "deadly") return 0;
+            if (severity == "danger") return 1;
+            return 2;
+        }
+    }
+
+    MapModule::MapModule()
+        : m_lastMatchMicroseconds(0.0), m_hasResult(false) {
+        // Initialize here
+    }
+
+    MapModule::~MapModule() {
+        // Cleanup
+        if (m_mapCheckOperation.valid()) {
+            try {
+                m_mapCheckOperation.wait();
+            }
+            catch (...) {
+                // Ignore exceptions during cleanup
+            }
+        }
+    }
+
+    std::string MapModule::GetModuleID() const {
+        return "map_overlay";
+    }
+
+    std::string MapModule::GetModuleName() const {
+        return "Map Check";
+    }
+
+    std::string MapModule::GetModuleDescription() const {
+        return "Warns about dangerous map modifiers";
+    }
+
+    std::string MapModule::GetModuleVersion() const {
+        return "1.0.0";
+    }
+
+    std::string MapModule::GetModuleAuthor() const {
+        return "Nexile Team";
+    }
+
+    bool MapModule::SupportsGame(GameID gameId) const {
+        return gameId == GameID::PathOfExile || gameId == GameID::PathOfExile2;
+    }
+
+    std::string MapModule::GetModuleUIHTML() const {
+        return R"(
+        <!DOCTYPE html>
+        <html>
+        <head>
+            <meta charset="utf-8">
+            <title>Map Check</title>
+            <style>
+                body {
+                    background-color: rgba(30, 30, 30, 0.85);
+                    color: #e0e0e0;
+                    font-family: 'Segoe UI', sans-serif;
+                    padding: 16px;
+                    margin: 0;
+                }
+                h2 { color: #4a90e2; margin: 0 0 4px 0; }
+                .summary { color: #9aa5b1; margin-bottom: 10px; }
+                .safe { color: #5cb85c; font-size: 18px; font-weight: bold; }
+                .error { color: #e25c5c; }
+                .warning-row { padding: 6px 8px; margin-bottom: 4px; border-radius: 4px; }
+                .warning-row .mod { font-size: 12px; color: #c0c0c0; }
+                .deadly { background-color: rgba(200, 40, 40, 0.45); }
+                .danger { background-color: rgba(220, 120, 30, 0.40); }
+                .warning { background-color: rgba(200, 180, 40, 0.25); }
+                button {
+                    background-color: #4a90e2; color: white; border: none;
+                    padding: 6px 12px; border-radius: 4px; cursor: pointer; margin-top: 8px;
+                }
+            </style>
+        </head>
+        <body>
+            <h2 id="map-title">Map Check</h2>
+            <div id="map-summary" class="summary">Hover a map and press the map check hotkey.</div>
+            <div id="map-warnings"></div>
+            <button id="reload-button">Reload danger list</button>
+            <script>
+                function sendMessage(data) {
+                    if (window.nexile && window.nexile.postMessage) {
+                        window.nexile.postMessage(data);
+                    }
+                }
+
+                function updateMapCheck(data) {
+                    const title = document.getElementById('map-title');
+                    const summary = document.getElementById('map-summary');
+                    const warnings = document.getElementById('map-warnings');
+                    warnings.textContent = '';
+
+                    if (data.error) {
+                        summary.textContent = data.error;
+                        summary.className = 'summary error';
+                        return;
+                    }
+
+                    summary.className = 'summary';
+                    if (!data.loaded) {
+                        summary.textContent = data.ruleCount + ' danger rules loaded. Hover a map and press the map check hotkey.';
+                        return;
+                    }
+
+                    title.textContent = data.name + (data.tier ? ' (T' + data.tier + ')' : '');
+                    summary.textContent = data.modCount + ' mods checked against ' + data.ruleCount +
+                        ' rules in ' + data.matchUs.toFixed(1) + ' µs';
+
+                    if (!data.warnings.length) {
+                        const safe = document.createElement('div');
+                        safe.className = 'safe';
+                        safe.textContent = 'No dangerous mods';
+                        warnings.appendChild(safe);
+                        return;
+                    }
+
+                    for (const warning of data.warnings) {
+                        const row = document.createElement('div');
+                        row.className = 'warning-row ' + warning.severity;
+
+                        const note = document.createElement('div');
+                        note.textContent = warning.note;
+                        row.appendChild(note);
+
+                        const mod = document.createElement('div');
+                        mod.className = 'mod';
+                        mod.textContent = warning.pattern;
+                        row.appendChild(mod);
+
+                        warnings.appendChild(row);
+                    }
+                }
+
+                document.getElementById('reload-button').addEventListener('click', function() {
+                    sendMessage({ action: 'map_overlay_reload' });
+                });
+
+                window.addEventListener('message', function(event) {
+                    const message = event.data;
+                    if (message && message.module === 'map_overlay') {
+                        updateMapCheck(message.data);
+                    }
+                });
+
+                sendMessage({ action: 'map_overlay_get' });
+            </script>
+        </body>
+        </html>
+    )";
+    }
+
+    void MapModule::OnLoad() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (app) {
+            // Register hotkey for map check (Alt+M)
+            HotkeyManager* hotkeyManager = app->GetProfileManager()->GetHotkeyManager();
+            if (hotkeyManager) {
+                hotkeyManager->RegisterHotkey(MOD_ALT, 'M', HotkeyManager::HOTKEY_MAP_OVERLAY);
+            }
+
+            OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+            if (overlay) {
+                overlay->RegisterAction(GetModuleID(), "map_overlay_get", [this](const ActionMessage&) {
+                    UpdateUI();
+                    });
+                overlay->RegisterAction(GetModuleID(), "map_overlay_reload", [this](const ActionMessage&) {
+                    LoadDangerRules();
+                    UpdateUI();
+                    });
+            }
+        }
+
+        LoadDangerRules();
+    }
+
+    void MapModule::OnUnload() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (app) {
+            HotkeyManager* hotkeyManager = app->GetProfileManager()->GetHotkeyManager();
+            if (hotkeyManager) {
+                hotkeyManager->UnregisterHotkey(HotkeyManager::HOTKEY_MAP_OVERLAY);
+            }
+        }
+    }
+
+    void MapModule::OnGameChanged() {
+        // Update enabled state based on game
+        m_enabled = SupportsGame(m_currentGame);
+    }
+
+    void MapModule::OnHotkeyPressed(int hotkeyId) {
+        if (!m_enabled || hotkeyId != HotkeyManager::HOTKEY_MAP_OVERLAY) {
+            return;
+        }
+
+        // Hotkeys arrive on the UI thread, which must not wait out the
+        // clipboard timeout of a check still in flight; its result is coming
+        if (m_mapCheckOperation.valid() &&
+            m_mapCheckOperation.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            LOG_DEBUG("Map check still running, hotkey press dropped");
+            return;
+        }
+
+        m_mapCheckOperation = std::async(std::launch::async, [this]() {
+            PerformMapCheck();
+            });
+
+        // Show the module UI
+        NexileApp* app = NexileApp::GetInstance();
+        if (app && app->GetModule("map_overlay")) {
+            app->SetOverlayVisible(true);
+            app->GetProfileManager()->GetOverlayWindow()->LoadModuleUI(app->GetModule("map_overlay"));
+        }
+    }
+
+    void MapModule::PerformMapCheck() {
+        std::string itemText;
+        if (!Utils::CopyFromGame(itemText)) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_lastError = "No item data found in clipboard";
+            }
+            UpdateUI();
+            return;
+        }
+
+        EvaluateMapText(itemText);
+    }
+
+    bool MapModule::EvaluateMapText(const std::string& itemText) {
+        ItemData item;
+        bool isMap = ParsePoEItem(itemText, item) &&
+            (item.itemClass == "Maps" || item.baseType.find(" Map") != std::string::npos ||
+             item.name.find(" Map") != std::string::npos);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!isMap) {
+                m_lastError = "The copied item is not a map";
+            } else {
+                auto start = std::chrono::steady_clock::now();
+                m_matcher.MatchLines(item.mods, m_matchedRules);
+                m_lastMatchMicroseconds = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - start).count();
+
+                // Most severe first, then in list order
+                std::stable_sort(m_matchedRules.begin(), m_matchedRules.end(), [this](int a, int b) {
+                    return SeverityRank(m_rules[a].severity) < SeverityRank(m_rules[b].severity);
+                });
+
+                m_currentMap = std::move(item);
+                m_mapTier = GetItemProperty(itemText, "Map Tier");
+                m_hasResult = true;
+                m_lastError.clear();
+
+                LOG_INFO("Map check: {} - {} of {} rules matched in {}us",
+                         m_currentMap.name, m_matchedRules.size(), m_rules.size(), m_lastMatchMicroseconds);
+            }
+        }
+
+        UpdateUI();
+        return isMap;
+    }
+
+    void MapModule::LoadDangerRules() {
+        std::string path = GetRulesPath();
+        std::vector<MapDangerRule> rules;
+
+        if (Utils::FileExists(path)) {
+            try {
+                json data = json::parse(Utils::ReadTextFile(path));
+                for (const auto& entry : data.value("rules", json::array())) {
+                    MapDangerRule rule;
+                    rule.pattern = entry.value("pattern", "");
+                    rule.severity = entry.value("severity", "warning");
+                    rule.note = entry.value("note", rule.pattern);
+                    if (!rule.pattern.empty()) {
+                        rules.push_back(rule);
+                    }
+                }
+            }
+            catch (const std::exception& e) {
+                LOG_ERROR("Failed to read map danger list: {}", e.what());
+            }
+        } else {
+            // First run: write the defaults so they can be edited
+            json data;
+            data["rules"] = json::array();
+            for (const MapDangerRule& rule : kDefaultRules) {
+                rules.push_back(rule);
+                data["rules"].push_back({ {"pattern", rule.pattern}, {"severity", rule.severity}, {"note", rule.note} });
+            }
+
+            if (!Utils::WriteTextFile(path, data.dump(4))) {
+                LOG_WARNING("Failed to write default map danger list");
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Matcher ids are indices into m_rules
+            m_rules.clear();
+            m_matcher.Clear();
+            for (const MapDangerRule& rule : rules) {
+                if (m_matcher.AddPattern(rule.pattern) >= 0) {
+                    m_rules.push_back(rule);
+                }
+            }
+            m_matcher.Compile();
+
+            m_matchedRules.clear();
+            m_hasResult = false;
+        }
+
+        LOG_INFO("Loaded {} map danger rules ({} matcher states)", m_rules.size(), m_matcher.GetStateCount());
+    }
+
+    void MapModule::UpdateUI() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (!app) return;
+
+        OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+        if (!overlay) return;
+
+        json data;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            data["loaded"] = m_hasResult;
+            data["ruleCount"] = m_rules.size();
+            if (!m_lastError.empty()) {
+                data["error"] = m_lastError;
+            }
+
+            if (m_hasResult) {
+                data["name"] = m_currentMap.name;
+                data["tier"] = m_mapTier;
+                data["modCount"] = m_currentMap.mods.size();
+                data["matchUs"] = m_lastMatchMicroseconds;
+
+                json warnings = json::array();
+                for (int id : m_matchedRules) {
+                    const MapDangerRule& rule = m_rules[id];
+                    warnings.push_back({ {"pattern", rule.pattern}, {"severity", rule.severity}, {"note", rule.note} });
+                }
+                data["warnings"] = warnings;
+            }
+        }
+
+        std::wstringstream script;
+        script << L"window.postMessage({";
+        script << L"module: 'map_overlay',";
+        script << L"data: " << Utils::StringToWideString(data.dump());
+        script << L"}, '*');";
+
+        overlay->ExecuteScript(script.str(), "map_overlay");
+    }
+
+    std::string MapModule::GetRulesPath() const {
+        return Utils::CombinePath(Utils::GetAppDataPath(), "map_dangers.json");
+    }
+
+} // namespace Nexile
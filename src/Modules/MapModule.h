@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ModuleInterface.h"
+#include "../Game/ItemParser.h"
+#include "../Game/ModMatcher.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <future>
+
+namespace Nexile {
+
+    // User-defined map modifier warning
+    struct MapDangerRule {
+        std::string pattern;    // Mod text; numbers may be written as '#'
+        std::string severity;   // "deadly", "danger" or "warning"
+        std::string note;       // Short label shown instead of the mod text
+    };
+
+    // Map modifier danger check for Path of Exile
+    class MapModule : public ModuleBase {
+    public:
+        MapModule();
+        ~MapModule() override;
+
+        // IModule implementation
+        std::string GetModuleID() const override;
+        std::string GetModuleName() const override;
+        std::string GetModuleDescription() const override;
+        std::string GetModuleVersion() const override;
+        std::string GetModuleAuthor() const override;
+        bool SupportsGame(GameID gameId) const override;
+        std::string GetModuleUIHTML() const override;
+        void OnHotkeyPressed(int hotkeyId) override;
+
+        // Check copied map text against the danger list
+        bool EvaluateMapText(const std::string& itemText);
+
+    protected:
+        // ModuleBase overrides
+        void OnLoad() override;
+        void OnUnload() override;
+        void OnGameChanged() override;
+
+    private:
+        // Copy the hovered map and evaluate it
+        void PerformMapCheck();
+
+        // Load the danger list (writing the defaults on first run) and compile the matcher
+        void LoadDangerRules();
+
+        // Send the last result to the overlay
+        void UpdateUI();
+
+        // Get the path of the danger list
+        std::string GetRulesPath() const;
+
+    private:
+        // Mutex for thread safety
+        std::mutex m_mutex;
+
+        // Danger list and its compiled matcher
+        std::vector<MapDangerRule> m_rules;
+        ModMatcher m_matcher;
+
+        // Last evaluated map
+        ItemData m_currentMap;
+        std::string m_mapTier;
+        std::vector<int> m_matchedRules;
+        double m_lastMatchMicroseconds;
+        bool m_hasResult;
+
+        // Last error (empty on success)
+        std::string m_lastError;
+
+        // Current map check operation
+        std::future<void> m_mapCheckOperation;
+    };
+
+} // namespace Nexile
@@ -2,6 +2,7 @@
 #include "../Core/NexileApp.h"
 #include "../Input/HotkeyManager.h"
 #include "../UI/OverlayWindow.h"
+#include "../Utils/Utils.h"
 
 #include <Windows.h>
 #include <regex>
@@ -204,29 +205,23 @@ namespace Nexile {
                 app->GetProfileManager()->GetOverlayWindow()->LoadModuleUI(app->GetModule("price_check"));
 
                 // Show loading state
-                UpdateUI(R"({"loading": true})");
+                UpdateUI({ {"loading", true} });
             }
         }
     }
 
     void PriceCheckModule::PerformPriceCheck() {
-        // Send Ctrl+C to copy item under cursor
-        SendCopyCommand();
-
-        // Wait a bit for the clipboard to be updated
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-        // Get item text from clipboard
+        // Copy the item under the cursor
         std::string itemText;
-        if (!ParseItemTextFromClipboard(itemText)) {
-            UpdateUI(R"({"error": "No item data found in clipboard"})");
+        if (!Utils::CopyFromGame(itemText)) {
+            UpdateUI({ {"error", "No item data found in clipboard"} });
             return;
         }
 
         // Parse item data
         ItemData item;
         if (!ParsePoEItem(itemText, item)) {
-            UpdateUI(R"({"error": "Failed to parse item data"})");
+            UpdateUI({ {"error", "Failed to parse item data"} });
             return;
         }
 
@@ -237,133 +232,6 @@ namespace Nexile {
         QueryPriceAPI(itemText);
     }
 
-    bool PriceCheckModule::ParseItemTextFromClipboard(std::string& itemText) {
-        itemText.clear();
-
-        // Try to open clipboard
-        if (!OpenClipboard(NULL)) {
-            return false;
-        }
-
-        // Get clipboard data
-        HANDLE hData = GetClipboardData(CF_TEXT);
-        if (hData == NULL) {
-            CloseClipboard();
-            return false;
-        }
-
-        // Lock clipboard data
-        char* pszText = static_cast<char*>(GlobalLock(hData));
-        if (pszText == NULL) {
-            CloseClipboard();
-            return false;
-        }
-
-        // Copy data
-        itemText = pszText;
-
-        // Unlock and close
-        GlobalUnlock(hData);
-        CloseClipboard();
-
-        return !itemText.empty();
-    }
-
-    void PriceCheckModule::SendCopyCommand() {
-        // Send Ctrl+C to the game
-        // Note: This is allowed as it's one action per hotkey press
-
-        // Press Ctrl down
-        SimulateKeyPress(VK_CONTROL | 0x100);
-
-        // Press C down
-        SimulateKeyPress('C' | 0x100);
-
-        // Wait a bit
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
-        // Release C
-        SimulateKeyPress('C');
-
-        // Release Ctrl
-        SimulateKeyPress(VK_CONTROL);
-
-        // Wait for clipboard to update
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    }
-
-    void PriceCheckModule::SimulateKeyPress(int virtualKey) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wVk = virtualKey & 0xFF;
-        input.ki.dwFlags = (virtualKey & 0x100) ? 0 : KEYEVENTF_KEYUP;
-        SendInput(1, &input, sizeof(INPUT));
-    }
-
-    bool PriceCheckModule::ParsePoEItem(const std::string& text, ItemData& item) {
-        // Reset item
-        item = ItemData();
-
-        // Split text into lines
-        std::istringstream stream(text);
-        std::string line;
-        std::vector<std::string> lines;
-
-        while (std::getline(stream, line)) {
-            lines.push_back(line);
-        }
-
-        if (lines.empty()) {
-            return false;
-        }
-
-        // First line is the rarity
-        if (lines[0].find("Rarity:") == 0) {
-            item.rarity = lines[0].substr(8);
-
-            // Remove leading/trailing whitespace
-            item.rarity.erase(0, item.rarity.find_first_not_of(" \t"));
-            item.rarity.erase(item.rarity.find_last_not_of(" \t") + 1);
-        }
-
-        // Second line is item name (if present)
-        if (lines.size() > 1) {
-            item.name = lines[1];
-        }
-
-        // Third line might be base type (for rare/magic items)
-        if (lines.size() > 2 &&
-            (item.rarity == "Rare" || item.rarity == "Magic" || item.rarity == "Unique")) {
-            item.baseType = lines[2];
-        }
-
-        // Look for item level
-        for (const auto& line : lines) {
-            if (line.find("Item Level:") == 0) {
-                item.itemLevel = line.substr(11);
-
-                // Remove leading/trailing whitespace
-                item.itemLevel.erase(0, item.itemLevel.find_first_not_of(" \t"));
-                item.itemLevel.erase(item.itemLevel.find_last_not_of(" \t") + 1);
-            }
-        }
-
-        // Extract mods (lines after a separator)
-        bool inMods = false;
-        for (const auto& line : lines) {
-            if (line.find("--------") == 0) {
-                inMods = true;
-                continue;
-            }
-
-            if (inMods && !line.empty()) {
-                item.mods.push_back(line);
-            }
-        }
-
-        return !item.name.empty() && !item.rarity.empty();
-    }
-
     void PriceCheckModule::QueryPriceAPI(const std::string& itemText) {
         // TODO: Implement actual API query
         // For now, simulate a delay and return mock data
@@ -371,53 +239,41 @@ namespace Nexile {
         std::this_thread::sleep_for(std::chrono::seconds(1));
 
         // Create a JSON response
-        std::ostringstream json;
-        json << "{";
+        nlohmann::json result = nlohmann::json::object();
 
         if (!m_currentItem.name.empty()) {
-            json << "\"name\": \"" << m_currentItem.name << "\",";
+            result["name"] = m_currentItem.name;
         }
 
         if (!m_currentItem.baseType.empty()) {
-            json << "\"baseType\": \"" << m_currentItem.baseType << "\",";
+            result["baseType"] = m_currentItem.baseType;
         }
 
         if (!m_currentItem.rarity.empty()) {
-            json << "\"rarity\": \"" << m_currentItem.rarity << "\",";
+            result["rarity"] = m_currentItem.rarity;
         }
 
         if (!m_currentItem.itemLevel.empty()) {
-            json << "\"itemLevel\": \"" << m_currentItem.itemLevel << "\",";
+            result["itemLevel"] = m_currentItem.itemLevel;
         }
 
         // Mock price data
-        json << "\"price\": \"5-10 chaos\",";
-        json << "\"confidence\": \"medium\"";
-
-        json << "}";
+        result["price"] = "5-10 chaos";
+        result["confidence"] = "medium";
 
         // Update UI with results
-        UpdateUI(json.str());
+        UpdateUI(std::move(result));
     }
 
-    void PriceCheckModule::UpdateUI(const std::string& results) {
+    void PriceCheckModule::UpdateUI(nlohmann::json results) {
         // Send results to overlay
         NexileApp* app = NexileApp::GetInstance();
         if (app) {
             OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
             if (overlay) {
-                // Create message for JavaScript
-                std::ostringstream script;
-                script << "window.postMessage({";
-                script << "module: 'price_check',";
-                script << "data: " << results;
-                script << "}, '*');";
-
-                // Convert to wide string
-                std::wstring wScript(script.str().begin(), script.str().end());
-
-                // Execute in overlay
-                overlay->ExecuteScript(wScript);
+                // The page receives the difference to what it shows; updates
+                // within one frame fold into a single delta
+                overlay->GetStateStore()->Set("price_check", std::move(results));
             }
         }
     }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ModuleInterface.h"
+#include "../Game/ItemParser.h"
+#include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -34,34 +36,13 @@ namespace Nexile {
         // Perform a price check
         void PerformPriceCheck();
 
-        // Parse item text from clipboard
-        bool ParseItemTextFromClipboard(std::string& itemText);
-
-        // Send Ctrl+C to the game to copy item data
-        void SendCopyCommand();
-
         // Query price API
         void QueryPriceAPI(const std::string& itemText);
 
         // Update UI with price results
-        void UpdateUI(const std::string& results);
-
-        // Simulates pressing a key
-        void SimulateKeyPress(int virtualKey);
+        void UpdateUI(nlohmann::json results);
 
     private:
-        // Item data structure
-        struct ItemData {
-            std::string name;
-            std::string baseType;
-            std::string rarity;
-            std::string itemLevel;
-            std::vector<std::string> mods;
-        };
-
-        // Parse Path of Exile item text
-        bool ParsePoEItem(const std::string& text, ItemData& item);
-
         // Current item data
         ItemData m_currentItem;
 
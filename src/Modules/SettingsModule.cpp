@@ -239,8 +239,34 @@ namespace Nexile {
         if (app) {
             OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
             if (overlay) {
-                overlay->RegisterWebMessageCallback([this](const std::wstring& message) {
-                    ProcessSettingsMessage(Utils::WideStringToString(message));
+                overlay->RegisterAction(GetModuleID(), "get_settings", [this](const ActionMessage&) {
+                    UpdateSettingsUI();
+                    });
+                overlay->RegisterAction(GetModuleID(), "save_settings", [this](const ActionMessage& msg) {
+                    SaveSettingsFromUI(msg.Json());
+                    });
+                overlay->RegisterAction(GetModuleID(), "cancel_settings", [](const ActionMessage&) {
+                    // Close settings UI without saving
+                    NexileApp* app = NexileApp::GetInstance();
+                    if (app) {
+                        app->OnHotkeyPressed(HotkeyManager::HOTKEY_GAME_SETTINGS);
+                    }
+                    });
+                overlay->RegisterAction(GetModuleID(), "reset_settings", [this](const ActionMessage&) {
+                    // TODO: Implement reset to default
+                    UpdateSettingsUI();
+                    });
+                overlay->RegisterAction(GetModuleID(), "hotkey_recording_start", [this](const ActionMessage& msg) {
+                    const json& data = msg.Json();
+                    if (data.contains("hotkeyId")) {
+                        StartHotkeyRecording(data["hotkeyId"].get<int>());
+                    }
+                    });
+                overlay->RegisterAction(GetModuleID(), "hotkey_recording_stop", [this](const ActionMessage&) {
+                    StopHotkeyRecording();
+                    });
+                overlay->RegisterAction(GetModuleID(), "hotkey_update", [this](const ActionMessage& msg) {
+                    UpdateHotkeyFromUI(msg.Json());
                     });
             }
         }
@@ -330,134 +356,82 @@ namespace Nexile {
                 hotkeyManager->GetHotkeyString(HotkeyManager::HOTKEY_MAP_OVERLAY);
         }
 
-        // Send settings to UI
-        std::wstringstream script;
-        script << L"window.postMessage({";
-        script << L"action: 'load_settings',";
-        script << L"settings: " << Utils::StringToWideString(json(settings).dump());
-        script << L"}, '*');";
-
-        overlay->ExecuteScript(script.str());
+        // The settings page gets only what changed since it last heard
+        overlay->GetStateStore()->Set("settings", std::move(settings));
     }
 
-    void SettingsModule::ProcessSettingsMessage(const std::string& message) {
-        try {
-            json msg = json::parse(message);
+    void SettingsModule::SaveSettingsFromUI(const json& msg) {
+        NexileApp* app = NexileApp::GetInstance();
+        if (!app) return;
+
+        ProfileManager* profileManager = app->GetProfileManager();
+        if (!profileManager) return;
 
-            // Check if this is a settings message
-            if (!msg.contains("action")) {
-                return;
-            }
+        // Get current profile
+        ProfileSettings& profile = profileManager->GetCurrentProfile();
 
-            std::string action = msg["action"];
+        // Update general settings
+        if (msg.contains("settings") && msg["settings"].contains("general")) {
+            json general = msg["settings"]["general"];
 
-            if (action == "get_settings") {
-                // Send current settings to UI
-                UpdateSettingsUI();
+            if (general.contains("opacity")) {
+                profile.overlayOpacity = static_cast<float>(general["opacity"].get<int>()) / 100.0f;
             }
-            else if (action == "save_settings") {
-                NexileApp* app = NexileApp::GetInstance();
-                if (!app) return;
-
-                ProfileManager* profileManager = app->GetProfileManager();
-                if (!profileManager) return;
 
-                // Get current profile
-                ProfileSettings& profile = profileManager->GetCurrentProfile();
+            if (general.contains("clickThrough")) {
+                profile.clickThrough = general["clickThrough"].get<bool>();
 
-                // Update general settings
-                if (msg.contains("settings") && msg["settings"].contains("general")) {
-                    json general = msg["settings"]["general"];
+                // Update overlay click-through setting
+                OverlayWindow* overlay = profileManager->GetOverlayWindow();
+                if (overlay) {
+                    overlay->SetClickThrough(profile.clickThrough);
+                }
+            }
 
-                    if (general.contains("opacity")) {
-                        profile.overlayOpacity = static_cast<float>(general["opacity"].get<int>()) / 100.0f;
-                    }
+            // TODO: Handle other general settings
+        }
 
-                    if (general.contains("clickThrough")) {
-                        profile.clickThrough = general["clickThrough"].get<bool>();
+        // Update module settings
+        if (msg.contains("settings") && msg["settings"].contains("modules")) {
+            json modules = msg["settings"]["modules"];
 
-                        // Update overlay click-through setting
-                        OverlayWindow* overlay = profileManager->GetOverlayWindow();
-                        if (overlay) {
-                            overlay->SetClickThrough(profile.clickThrough);
-                        }
-                    }
+            if (modules.contains("priceCheck")) {
+                profileManager->SetModuleEnabled("price_check", modules["priceCheck"].get<bool>());
+            }
 
-                    // TODO: Handle other general settings
-                }
+            // TODO: Handle other module settings
+        }
 
-                // Update module settings
-                if (msg.contains("settings") && msg["settings"].contains("modules")) {
-                    json modules = msg["settings"]["modules"];
+        // Save settings
+        SaveSettings();
 
-                    if (modules.contains("priceCheck")) {
-                        profileManager->SetModuleEnabled("price_check", modules["priceCheck"].get<bool>());
-                    }
+        // Close settings UI and return to overlay
+        OverlayWindow* overlay = profileManager->GetOverlayWindow();
+        if (overlay) {
+            overlay->LoadMainOverlayUI();
+        }
 
-                    // TODO: Handle other module settings
-                }
+        // Exit settings mode in NexileApp
+        app->OnHotkeyPressed(HotkeyManager::HOTKEY_GAME_SETTINGS);
+    }
 
-                // Save settings
-                SaveSettings();
+    void SettingsModule::UpdateHotkeyFromUI(const json& msg) {
+        if (msg.contains("hotkeyId") && msg.contains("ctrl") &&
+            msg.contains("alt") && msg.contains("shift") && msg.contains("key")) {
 
-                // Close settings UI and return to overlay
-                OverlayWindow* overlay = profileManager->GetOverlayWindow();
-                if (overlay) {
-                    overlay->LoadMainOverlayUI();
-                }
+            int hotkeyId = msg["hotkeyId"].get<int>();
+            bool ctrl = msg["ctrl"].get<bool>();
+            bool alt = msg["alt"].get<bool>();
+            bool shift = msg["shift"].get<bool>();
+            int key = msg["key"].get<int>();
 
-                // Exit settings mode in NexileApp
-                app->OnHotkeyPressed(HotkeyManager::HOTKEY_GAME_SETTINGS);
-            }
-            else if (action == "cancel_settings") {
-                // Close settings UI without saving
-                NexileApp* app = NexileApp::GetInstance();
-                if (app) {
-                    // Exit settings mode in NexileApp
-                    app->OnHotkeyPressed(HotkeyManager::HOTKEY_GAME_SETTINGS);
-                }
-            }
-            else if (action == "reset_settings") {
-                // Reset settings to default
-                NexileApp* app = NexileApp::GetInstance();
-                if (app) {
-                    // TODO: Implement reset to default
+            // Calculate modifiers
+            int modifiers = 0;
+            if (ctrl) modifiers |= MOD_CONTROL;
+            if (alt) modifiers |= MOD_ALT;
+            if (shift) modifiers |= MOD_SHIFT;
 
-                    // Update UI
-                    UpdateSettingsUI();
-                }
-            }
-            else if (action == "hotkey_recording_start") {
-                if (msg.contains("hotkeyId")) {
-                    int hotkeyId = msg["hotkeyId"].get<int>();
-                    StartHotkeyRecording(hotkeyId);
-                }
-            }
-            else if (action == "hotkey_recording_stop") {
-                StopHotkeyRecording();
-            }
-            else if (action == "hotkey_update") {
-                if (msg.contains("hotkeyId") && msg.contains("ctrl") &&
-                    msg.contains("alt") && msg.contains("shift") && msg.contains("key")) {
-
-                    int hotkeyId = msg["hotkeyId"].get<int>();
-                    bool ctrl = msg["ctrl"].get<bool>();
-                    bool alt = msg["alt"].get<bool>();
-                    bool shift = msg["shift"].get<bool>();
-                    int key = msg["key"].get<int>();
-
-                    // Calculate modifiers
-                    int modifiers = 0;
-                    if (ctrl) modifiers |= MOD_CONTROL;
-                    if (alt) modifiers |= MOD_ALT;
-                    if (shift) modifiers |= MOD_SHIFT;
-
-                    UpdateHotkey(hotkeyId, modifiers, key);
-                }
-            }
-        }
-        catch (const std::exception& e) {
-            LOG_ERROR("Error processing settings message: {}", e.what());
+            UpdateHotkey(hotkeyId, modifiers, key);
         }
     }
 
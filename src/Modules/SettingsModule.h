@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ModuleInterface.h"
+#include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -40,8 +41,11 @@ namespace Nexile {
         // Update UI with current settings
         void UpdateSettingsUI();
 
-        // Process settings message from UI
-        void ProcessSettingsMessage(const std::string& message);
+        // Apply and save the settings page's {settings: {general, modules}}
+        void SaveSettingsFromUI(const nlohmann::json& msg);
+
+        // Apply a hotkey edited on the settings page
+        void UpdateHotkeyFromUI(const nlohmann::json& msg);
 
         // Handle hotkey recording
         void StartHotkeyRecording(int hotkeyId);
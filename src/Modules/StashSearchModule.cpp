@@ -0,0 +1,449 @@
+#include "StashSearchModule.h"
+#include "../Core/NexileApp.h"
+#include "../Stash/StashIngester.h"
+#include "../UI/OverlayWindow.h"
+#include "../Utils/Utils.h"
+#include "../Utils/Logger.h"
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        // One table row per match in a result window
+        const char* kResultRowsTemplate =
+            "{{#rows}}<tr>"
+            "<td class=\"{{rarity}}\">{{name}}</td>"
+            "<td>{{base}}</td>"
+            "<td>{{ilvl}}</td>"
+            "</tr>{{/rows}}";
+
+        const char* RarityName(uint8_t rarity) {
+            switch (static_cast<StashRarity>(rarity)) {
+            case StashRarity::Normal: return "normal";
+            case StashRarity::Magic: return "magic";
+            case StashRarity::Rare: return "rare";
+            case StashRarity::Unique: return "unique";
+            case StashRarity::Gem: return "gem";
+            case StashRarity::Currency: return "currency";
+            case StashRarity::DivinationCard: return "divination";
+            default: return "other";
+            }
+        }
+    }
+
+    StashSearchModule::StashSearchModule()
+        : m_fileCount(0), m_loadMilliseconds(0.0), m_loading(false),
+          m_queryValid(false), m_matchCount(0), m_queryMilliseconds(0.0),
+          m_results(std::make_shared<ResultTable>()) {
+        std::string error;
+        if (!m_results->SetRowTemplate(kResultRowsTemplate, error)) {
+            LOG_ERROR("Invalid stash result template: {}", error);
+        }
+    }
+
+    StashSearchModule::~StashSearchModule() {
+        // Cleanup
+        if (m_loadOperation.valid()) {
+            try {
+                m_loadOperation.wait();
+            }
+            catch (...) {
+                // Ignore exceptions during cleanup
+            }
+        }
+    }
+
+    std::string StashSearchModule::GetModuleID() const {
+        return "stash_search";
+    }
+
+    std::string StashSearchModule::GetModuleName() const {
+        return "Stash Search";
+    }
+
+    std::string StashSearchModule::GetModuleDescription() const {
+        return "Searches saved stash tabs with item queries";
+    }
+
+    std::string StashSearchModule::GetModuleVersion() const {
+        return "1.0.0";
+    }
+
+    std::string StashSearchModule::GetModuleAuthor() const {
+        return "Nexile Team";
+    }
+
+    bool StashSearchModule::SupportsGame(GameID gameId) const {
+        return gameId == GameID::PathOfExile || gameId == GameID::PathOfExile2;
+    }
+
+    std::string StashSearchModule::GetModuleUIHTML() const {
+        return R"(
+        <!DOCTYPE html>
+        <html>
+        <head>
+            <meta charset="utf-8">
+            <title>Stash Search</title>
+            <style>
+                body {
+                    background-color: rgba(30, 30, 30, 0.85);
+                    color: #e0e0e0;
+                    font-family: 'Segoe UI', sans-serif;
+                    padding: 16px;
+                    margin: 0;
+                }
+                h2 { color: #4a90e2; margin: 0 0 8px 0; }
+                .summary { color: #9aa5b1; margin: 6px 0 10px 0; font-size: 12px; }
+                .error { color: #e25c5c; }
+                .query-row { display: flex; gap: 6px; }
+                #query-input {
+                    flex: 1; background-color: #2a2a2a; color: #e0e0e0; border: 1px solid #555;
+                    border-radius: 4px; padding: 6px 8px; font-family: Consolas, monospace;
+                }
+                button {
+                    background-color: #4a90e2; color: white; border: none;
+                    padding: 6px 12px; border-radius: 4px; cursor: pointer;
+                }
+                table { width: 100%; border-collapse: collapse; font-size: 13px; }
+                td, th { text-align: left; padding: 3px 6px; border-bottom: 1px solid #333; }
+                th { color: #9aa5b1; font-weight: normal; }
+                .normal { color: #c8c8c8; }
+                .magic { color: #8888ff; }
+                .rare { color: #ffff77; }
+                .unique { color: #af6025; }
+                .gem { color: #1ba29b; }
+                .currency { color: #aa9e82; }
+                .hint { color: #777; font-size: 11px; margin-top: 4px; }
+                #results-scroll { height: calc(100vh - 170px); overflow-y: auto; }
+                #results-scroll thead th { position: sticky; top: 0; background-color: #1e1e1e; cursor: pointer; }
+                #results tr { height: 24px; }
+                #results td { white-space: nowrap; overflow: hidden; text-overflow: ellipsis; max-width: 0; }
+                #filter-input {
+                    background-color: #2a2a2a; color: #e0e0e0; border: 1px solid #555;
+                    border-radius: 4px; padding: 3px 6px; margin-bottom: 6px; width: 240px;
+                }
+            </style>
+            <script src="nexile://nexile_state.js"></script>
+            <script src="nexile://nexile_table.js"></script>
+        </head>
+        <body>
+            <h2>Stash Search</h2>
+            <div class="query-row">
+                <input id="query-input" type="text" placeholder="rarity = rare and pseudo.total_life >= 70">
+                <button id="search-button">Search</button>
+                <button id="reload-button">Reload</button>
+            </div>
+            <div class="hint">Fields: rarity, ilvl, base (= or ~), pseudo.*, "mod text". Combine with and / or / not.</div>
+            <div id="summary" class="summary">Loading stash...</div>
+            <input id="filter-input" type="text" placeholder="Filter matches">
+            <div id="results-scroll">
+                <table>
+                    <thead><tr><th data-column="name">Item</th><th data-column="base">Base</th><th data-column="ilvl">iLvl</th></tr></thead>
+                    <tbody id="results"></tbody>
+                </table>
+            </div>
+            <script>
+                function sendMessage(data) {
+                    if (window.nexile && window.nexile.postMessage) {
+                        window.nexile.postMessage(data);
+                    }
+                }
+
+                function search() {
+                    const query = document.getElementById('query-input').value;
+                    if (window.nexile && window.nexile.request) {
+                        window.nexile.request('stash_search.query', { query: query })
+                            .then(updateStashSearch)
+                            .catch(function(error) {
+                                const summary = document.getElementById('summary');
+                                summary.className = 'summary error';
+                                summary.textContent = error.message;
+                            });
+                    } else {
+                        sendMessage({ action: 'stash_search_query', query: query });
+                    }
+                }
+
+                // Matches stay in C++; the table fetches the rows in view as they scroll in
+                const results = nexileTable.attach('stash_search', {
+                    scroller: document.getElementById('results-scroll'),
+                    body: document.getElementById('results'),
+                    rowHeight: 24,
+                    columns: 3
+                });
+
+                let sortColumn = '';
+                let sortDescending = false;
+                document.querySelectorAll('#results-scroll th').forEach(function(header) {
+                    header.addEventListener('click', function() {
+                        const column = header.dataset.column;
+                        sortDescending = column === sortColumn ? !sortDescending : column === 'ilvl';
+                        sortColumn = column;
+                        results.sort(column, sortDescending);
+                    });
+                });
+
+                let filterTimer = null;
+                document.getElementById('filter-input').addEventListener('input', function(event) {
+                    clearTimeout(filterTimer);
+                    filterTimer = setTimeout(function() { results.filter(event.target.value); }, 100);
+                });
+
+                function updateStashSearch(data) {
+                    const summary = document.getElementById('summary');
+
+                    if (data.loading) {
+                        summary.className = 'summary';
+                        summary.textContent = 'Loading stash...';
+                        return;
+                    }
+
+                    if (data.error) {
+                        summary.className = 'summary error';
+                        summary.textContent = data.error;
+                    } else {
+                        summary.className = 'summary';
+                        summary.textContent = data.itemCount + ' items from ' + data.fileCount + ' files (' +
+                            data.loadMs.toFixed(0) + ' ms)' + (data.hasQuery ? ' - ' + data.matchCount +
+                            ' matches in ' + data.queryMs.toFixed(2) + ' ms' : '');
+                    }
+                }
+
+                document.getElementById('search-button').addEventListener('click', search);
+                document.getElementById('query-input').addEventListener('keydown', function(event) {
+                    if (event.key === 'Enter') search();
+                });
+                document.getElementById('reload-button').addEventListener('click', function() {
+                    sendMessage({ action: 'stash_search_reload' });
+                });
+
+                window.addEventListener('message', function(event) {
+                    const message = event.data;
+                    if (message && message.module === 'stash_search') {
+                        updateStashSearch(message.data);
+                    }
+                });
+
+                sendMessage({ action: 'stash_search_get' });
+            </script>
+        </body>
+        </html>
+    )";
+    }
+
+    void StashSearchModule::OnLoad() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (app) {
+            OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+            if (overlay) {
+                overlay->RegisterAction(GetModuleID(), "stash_search_get", [this](const ActionMessage&) {
+                    UpdateUI();
+                    });
+                overlay->RegisterAction(GetModuleID(), "stash_search_query", [this](const ActionMessage& msg) {
+                    RunQuery(msg.Json().value("query", ""));
+                    UpdateUI();
+                    });
+                overlay->RegisterAction(GetModuleID(), "stash_search_reload", [this](const ActionMessage&) {
+                    StartLoad();
+                    UpdateUI();
+                    });
+
+                overlay->RegisterResultTable("stash_search", m_results);
+
+                // Query results go straight back to the promise that asked for them
+                overlay->RegisterRequestHandler("stash_search.query",
+                    [this](const json& payload, json& reply, std::string&) {
+                        RunQuery(payload.value("query", ""));
+                        reply = BuildState();
+                        return true;
+                    });
+            }
+        }
+
+        StartLoad();
+    }
+
+    void StashSearchModule::OnUnload() {
+        if (m_loadOperation.valid()) {
+            m_loadOperation.wait();
+        }
+    }
+
+    void StashSearchModule::OnGameChanged() {
+        // Update enabled state based on game
+        m_enabled = SupportsGame(m_currentGame);
+    }
+
+    void StashSearchModule::StartLoad() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_loading) {
+                return;
+            }
+            m_loading = true;
+        }
+
+        // The previous load has finished once m_loading was clear
+        if (m_loadOperation.valid()) {
+            m_loadOperation.wait();
+        }
+
+        m_loadOperation = std::async(std::launch::async, [this]() {
+            LoadStashFiles();
+            UpdateUI();
+            });
+    }
+
+    void StashSearchModule::LoadStashFiles() {
+        std::string directory = GetStashDirectory();
+        if (!Utils::DirectoryExists(directory)) {
+            Utils::CreateDirectory(directory);
+        }
+
+        // Ingest into a fresh store so queries keep running on the old one meanwhile
+        StashStore store;
+        StashIngester ingester(store);
+        size_t fileCount = 0;
+        std::string error;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const std::string& path : Utils::GetFilesInDirectory(directory, ".json")) {
+            std::string fileError;
+            if (ingester.IngestFile(path, fileError)) {
+                fileCount++;
+            } else {
+                LOG_WARNING("Failed to load stash file {}: {}", path, fileError);
+                error = fileError;
+            }
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        LOG_INFO("Loaded {} stash items from {} files in {}ms", store.GetItemCount(), fileCount, elapsed);
+
+        std::string queryText;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_store = std::move(store);
+            m_fileCount = fileCount;
+            m_loadMilliseconds = elapsed;
+            m_loading = false;
+            m_lastError = error;
+
+            // Compiled programs reference the old dictionaries
+            m_queryValid = false;
+            m_matches.Resize(0);
+            m_matchCount = 0;
+            m_results->Clear();
+            queryText = m_queryText;
+        }
+
+        if (!queryText.empty()) {
+            RunQuery(queryText);
+        }
+    }
+
+    bool StashSearchModule::RunQuery(const std::string& queryText) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_queryValid || queryText != m_queryText) {
+            m_queryText = queryText;
+            m_queryValid = QueryCompiler::Compile(queryText, m_store, m_query, m_lastError);
+            if (!m_queryValid) {
+                m_matches.Resize(0);
+                m_matchCount = 0;
+                m_results->Clear();
+                return false;
+            }
+            LOG_DEBUG("Compiled stash query '{}':\n{}", queryText, m_query.Disassemble());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        m_query.Execute(m_store, m_matches);
+        m_matchCount = m_matches.Count();
+        m_queryMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_lastError.clear();
+
+        PublishMatches();
+        return true;
+    }
+
+    void StashSearchModule::PublishMatches() {
+        std::vector<uint32_t> rows;
+        m_matches.GetRows(rows);
+
+        std::vector<ResultColumn> columns(4);
+        columns[0].name = "name";
+        columns[1].name = "base";
+        columns[2].name = "ilvl";
+        columns[2].numeric = true;
+        columns[3].name = "rarity";
+        for (ResultColumn& column : columns) {
+            if (column.numeric) {
+                column.numbers.reserve(rows.size());
+            } else {
+                column.text.reserve(rows.size());
+            }
+        }
+
+        for (uint32_t row : rows) {
+            const std::string& base = m_store.GetBaseName(m_store.GetBaseColumn()[row]);
+            const std::string& name = m_store.GetItemName(row);
+
+            // Items without a name show their base
+            columns[0].text.push_back(name.empty() ? base : name);
+            columns[1].text.push_back(base);
+            columns[2].numbers.push_back(m_store.GetItemLevelColumn()[row]);
+            columns[3].text.push_back(RarityName(m_store.GetRarityColumn()[row]));
+        }
+
+        std::string error;
+        if (!m_results->SetColumns(std::move(columns), error)) {
+            LOG_ERROR("Failed to publish stash matches: {}", error);
+        }
+    }
+
+    void StashSearchModule::UpdateUI() {
+        NexileApp* app = NexileApp::GetInstance();
+        if (!app) return;
+
+        OverlayWindow* overlay = app->GetProfileManager()->GetOverlayWindow();
+        if (!overlay) return;
+
+        std::wstringstream script;
+        script << L"window.postMessage({";
+        script << L"module: 'stash_search',";
+        script << L"data: " << Utils::StringToWideString(BuildState().dump());
+        script << L"}, '*');";
+
+        overlay->ExecuteScript(script.str(), "stash_search");
+    }
+
+    json StashSearchModule::BuildState() {
+        json data;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            data["loading"] = m_loading;
+            data["itemCount"] = m_store.GetItemCount();
+            data["fileCount"] = m_fileCount;
+            data["loadMs"] = m_loadMilliseconds;
+            data["hasQuery"] = m_queryValid;
+            data["matchCount"] = m_matchCount;
+            data["queryMs"] = m_queryMilliseconds;
+            if (!m_lastError.empty()) {
+                data["error"] = m_lastError;
+            }
+        }
+        return data;
+    }
+
+    std::string StashSearchModule::GetStashDirectory() const {
+        return Utils::CombinePath(Utils::GetAppDataPath(), "stash");
+    }
+
+} // namespace Nexile
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ModuleInterface.h"
+#include "../Stash/StashStore.h"
+#include "../Stash/QueryCompiler.h"
+#include "../UI/ResultTable.h"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <future>
+#include <memory>
+
+namespace Nexile {
+
+    // Searches saved stash tabs with the stash query language
+    class StashSearchModule : public ModuleBase {
+    public:
+        StashSearchModule();
+        ~StashSearchModule() override;
+
+        // IModule implementation
+        std::string GetModuleID() const override;
+        std::string GetModuleName() const override;
+        std::string GetModuleDescription() const override;
+        std::string GetModuleVersion() const override;
+        std::string GetModuleAuthor() const override;
+        bool SupportsGame(GameID gameId) const override;
+        std::string GetModuleUIHTML() const override;
+
+        // Compile (or reuse) and run a query against the loaded stash
+        bool RunQuery(const std::string& queryText);
+
+    protected:
+        // ModuleBase overrides
+        void OnLoad() override;
+        void OnUnload() override;
+        void OnGameChanged() override;
+
+    private:
+        // Ingest every stash export in the stash folder in the background
+        void StartLoad();
+        void LoadStashFiles();
+
+        // Send status and results to the overlay
+        void UpdateUI();
+
+        // Status as sent to the page
+        nlohmann::json BuildState();
+
+        // Hand the matches to the result table (lock held)
+        void PublishMatches();
+
+        // Get the folder holding stash exports
+        std::string GetStashDirectory() const;
+
+    private:
+        // Mutex for thread safety
+        std::mutex m_mutex;
+
+        // Loaded stash
+        StashStore m_store;
+        size_t m_fileCount;
+        double m_loadMilliseconds;
+        bool m_loading;
+
+        // Last compiled query; reused while the text and the store are unchanged
+        std::string m_queryText;
+        StashQuery m_query;
+        bool m_queryValid;
+
+        // Last result
+        StashBitmap m_matches;
+        size_t m_matchCount;
+        double m_queryMilliseconds;
+
+        // Last error (empty on success)
+        std::string m_lastError;
+
+        // Every match, which the page scrolls through window by window
+        std::shared_ptr<ResultTable> m_results;
+
+        // Current load operation
+        std::future<void> m_loadOperation;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,873 @@
+#include "QueryCompiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+namespace Nexile {
+
+    namespace {
+        const float kInfinity = std::numeric_limits<float>::infinity();
+
+        char ToLower(char c) {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        std::string Lowered(std::string_view text) {
+            std::string out(text);
+            for (char& c : out) c = ToLower(c);
+            return out;
+        }
+
+        // ---------------------------------------------------------------------
+        // Lexer
+        // ---------------------------------------------------------------------
+
+        enum class TokenKind {
+            Ident,
+            Number,
+            String,
+            Compare,    // = == != <> < <= > >= ~
+            Arith,      // + - * /
+            LParen,
+            RParen,
+            And,
+            Or,
+            Not,
+            End
+        };
+
+        struct Token {
+            TokenKind kind;
+            std::string text;
+            double number = 0.0;
+            size_t pos = 0;
+        };
+
+        bool IsIdentChar(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.';
+        }
+
+        bool Tokenize(std::string_view text, std::vector<Token>& tokens, std::string& error) {
+            size_t i = 0;
+            while (i < text.size()) {
+                char c = text[i];
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                    i++;
+                    continue;
+                }
+
+                Token token;
+                token.pos = i;
+
+                if (c >= '0' && c <= '9') {
+                    size_t end = i;
+                    while (end < text.size() && ((text[end] >= '0' && text[end] <= '9') || text[end] == '.')) end++;
+                    token.kind = TokenKind::Number;
+                    token.text = std::string(text.substr(i, end - i));
+                    try {
+                        token.number = std::stod(token.text);
+                    }
+                    catch (...) {
+                        error = "Invalid number '" + token.text + "' at " + std::to_string(i);
+                        return false;
+                    }
+                    i = end;
+                } else if (IsIdentChar(c)) {
+                    size_t end = i;
+                    while (end < text.size() && IsIdentChar(text[end])) end++;
+                    token.text = std::string(text.substr(i, end - i));
+
+                    std::string word = Lowered(token.text);
+                    token.kind = word == "and" ? TokenKind::And
+                        : word == "or" ? TokenKind::Or
+                        : word == "not" ? TokenKind::Not
+                        : TokenKind::Ident;
+                    i = end;
+                } else if (c == '"' || c == '\'') {
+                    size_t end = text.find(c, i + 1);
+                    if (end == std::string_view::npos) {
+                        error = "Unterminated string at " + std::to_string(i);
+                        return false;
+                    }
+                    token.kind = TokenKind::String;
+                    token.text = std::string(text.substr(i + 1, end - i - 1));
+                    i = end + 1;
+                } else if (c == '(' || c == ')') {
+                    token.kind = c == '(' ? TokenKind::LParen : TokenKind::RParen;
+                    token.text = std::string(1, c);
+                    i++;
+                } else if (c == '&' || c == '|') {
+                    if (i + 1 >= text.size() || text[i + 1] != c) {
+                        error = std::string("Expected '") + c + c + "' at " + std::to_string(i);
+                        return false;
+                    }
+                    token.kind = c == '&' ? TokenKind::And : TokenKind::Or;
+                    i += 2;
+                } else if (c == '=' || c == '!' || c == '<' || c == '>' || c == '~') {
+                    size_t length = 1;
+                    if (i + 1 < text.size() && (text[i + 1] == '=' || (c == '<' && text[i + 1] == '>'))) {
+                        length = 2;
+                    }
+                    token.text = std::string(text.substr(i, length));
+                    if (token.text == "!") {
+                        token.kind = TokenKind::Not;
+                    } else {
+                        token.kind = TokenKind::Compare;
+                        if (token.text == "==") token.text = "=";
+                        if (token.text == "<>") token.text = "!=";
+                    }
+                    i += length;
+                } else if (c == '+' || c == '-' || c == '*' || c == '/') {
+                    token.kind = TokenKind::Arith;
+                    token.text = std::string(1, c);
+                    i++;
+                } else {
+                    error = std::string("Unexpected character '") + c + "' at " + std::to_string(i);
+                    return false;
+                }
+
+                tokens.push_back(std::move(token));
+            }
+
+            Token end;
+            end.kind = TokenKind::End;
+            end.pos = text.size();
+            tokens.push_back(end);
+            return true;
+        }
+
+        // ---------------------------------------------------------------------
+        // Syntax tree
+        // ---------------------------------------------------------------------
+
+        // Constant expression on the right-hand side of a comparison
+        struct ValueNode {
+            enum class Kind { Number, String, Binary, Negate } kind;
+            double number = 0.0;
+            std::string text;
+            char op = 0;
+            std::unique_ptr<ValueNode> left;
+            std::unique_ptr<ValueNode> right;
+            size_t pos = 0;
+        };
+
+        struct QueryNode {
+            enum class Kind { And, Or, Not, Compare, Scan, Const } kind;
+            std::vector<std::unique_ptr<QueryNode>> children;
+            size_t pos = 0;
+
+            // Compare
+            std::string field;
+            bool quotedField = false;
+            std::string op;
+            std::unique_ptr<ValueNode> value;
+
+            // Scan (after resolution)
+            QueryOp scan = QueryOp::None;
+            int32_t arg = 0;
+            float lo = 0.0f;
+            float hi = 0.0f;
+            std::string text;
+
+            // Const
+            bool truth = false;
+        };
+
+        std::unique_ptr<QueryNode> MakeConst(bool truth) {
+            auto node = std::make_unique<QueryNode>();
+            node->kind = QueryNode::Kind::Const;
+            node->truth = truth;
+            return node;
+        }
+
+        // ---------------------------------------------------------------------
+        // Parser (recursive descent)
+        //
+        //   or      := and ('or' and)*
+        //   and     := unary ('and' unary)*
+        //   unary   := 'not' unary | '(' or ')' | compare
+        //   compare := (ident | string) op sum
+        //   sum     := product (('+' | '-') product)*
+        //   product := factor (('*' | '/') factor)*
+        //   factor  := number | ident | string | '-' factor | '(' sum ')'
+        // ---------------------------------------------------------------------
+
+        class Parser {
+        public:
+            Parser(const std::vector<Token>& tokens, std::string& error)
+                : m_tokens(tokens), m_error(error), m_index(0) {
+            }
+
+            std::unique_ptr<QueryNode> Parse() {
+                auto node = ParseOr();
+                if (node && Peek().kind != TokenKind::End) {
+                    Fail("Unexpected '" + Peek().text + "'");
+                    return nullptr;
+                }
+                return node;
+            }
+
+        private:
+            const Token& Peek() const { return m_tokens[m_index]; }
+            const Token& Next() { return m_tokens[m_index++]; }
+
+            void Fail(const std::string& message) {
+                if (m_error.empty()) {
+                    m_error = message + " at " + std::to_string(Peek().pos);
+                }
+            }
+
+            std::unique_ptr<QueryNode> ParseOr() {
+                auto left = ParseAnd();
+                while (left && Peek().kind == TokenKind::Or) {
+                    Next();
+                    auto right = ParseAnd();
+                    if (!right) return nullptr;
+                    left = Combine(QueryNode::Kind::Or, std::move(left), std::move(right));
+                }
+                return left;
+            }
+
+            std::unique_ptr<QueryNode> ParseAnd() {
+                auto left = ParseUnary();
+                while (left && Peek().kind == TokenKind::And) {
+                    Next();
+                    auto right = ParseUnary();
+                    if (!right) return nullptr;
+                    left = Combine(QueryNode::Kind::And, std::move(left), std::move(right));
+                }
+                return left;
+            }
+
+            std::unique_ptr<QueryNode> ParseUnary() {
+                if (Peek().kind == TokenKind::Not) {
+                    size_t pos = Next().pos;
+                    auto child = ParseUnary();
+                    if (!child) return nullptr;
+
+                    auto node = std::make_unique<QueryNode>();
+                    node->kind = QueryNode::Kind::Not;
+                    node->pos = pos;
+                    node->children.push_back(std::move(child));
+                    return node;
+                }
+
+                if (Peek().kind == TokenKind::LParen) {
+                    Next();
+                    auto inner = ParseOr();
+                    if (!inner) return nullptr;
+                    if (Peek().kind != TokenKind::RParen) {
+                        Fail("Expected ')'");
+                        return nullptr;
+                    }
+                    Next();
+                    return inner;
+                }
+
+                return ParseCompare();
+            }
+
+            std::unique_ptr<QueryNode> ParseCompare() {
+                const Token& field = Peek();
+                if (field.kind != TokenKind::Ident && field.kind != TokenKind::String) {
+                    Fail("Expected a field");
+                    return nullptr;
+                }
+                Next();
+
+                if (Peek().kind != TokenKind::Compare) {
+                    Fail("Expected a comparison after '" + field.text + "'");
+                    return nullptr;
+                }
+                const Token& op = Next();
+
+                auto value = ParseSum();
+                if (!value) return nullptr;
+
+                auto node = std::make_unique<QueryNode>();
+                node->kind = QueryNode::Kind::Compare;
+                node->pos = field.pos;
+                node->field = field.text;
+                node->quotedField = field.kind == TokenKind::String;
+                node->op = op.text;
+                node->value = std::move(value);
+                return node;
+            }
+
+            std::unique_ptr<ValueNode> ParseSum() {
+                auto left = ParseProduct();
+                while (left && Peek().kind == TokenKind::Arith && (Peek().text == "+" || Peek().text == "-")) {
+                    left = Binary(std::move(left), &Parser::ParseProduct);
+                }
+                return left;
+            }
+
+            std::unique_ptr<ValueNode> ParseProduct() {
+                auto left = ParseFactor();
+                while (left && Peek().kind == TokenKind::Arith && (Peek().text == "*" || Peek().text == "/")) {
+                    left = Binary(std::move(left), &Parser::ParseFactor);
+                }
+                return left;
+            }
+
+            std::unique_ptr<ValueNode> Binary(std::unique_ptr<ValueNode> left,
+                                              std::unique_ptr<ValueNode> (Parser::*operand)()) {
+                const Token& op = Next();
+                auto right = (this->*operand)();
+                if (!right) return nullptr;
+
+                auto node = std::make_unique<ValueNode>();
+                node->kind = ValueNode::Kind::Binary;
+                node->op = op.text[0];
+                node->pos = op.pos;
+                node->left = std::move(left);
+                node->right = std::move(right);
+                return node;
+            }
+
+            std::unique_ptr<ValueNode> ParseFactor() {
+                const Token& token = Peek();
+                auto node = std::make_unique<ValueNode>();
+                node->pos = token.pos;
+
+                switch (token.kind) {
+                case TokenKind::Number:
+                    node->kind = ValueNode::Kind::Number;
+                    node->number = token.number;
+                    Next();
+                    return node;
+
+                case TokenKind::Ident:
+                case TokenKind::String:
+                    node->kind = ValueNode::Kind::String;
+                    node->text = token.text;
+                    Next();
+                    return node;
+
+                case TokenKind::Arith:
+                    if (token.text == "-") {
+                        Next();
+                        node->kind = ValueNode::Kind::Negate;
+                        node->left = ParseFactor();
+                        return node->left ? std::move(node) : nullptr;
+                    }
+                    break;
+
+                case TokenKind::LParen: {
+                    Next();
+                    auto inner = ParseSum();
+                    if (!inner) return nullptr;
+                    if (Peek().kind != TokenKind::RParen) {
+                        Fail("Expected ')'");
+                        return nullptr;
+                    }
+                    Next();
+                    return inner;
+                }
+
+                default:
+                    break;
+                }
+
+                Fail("Expected a value");
+                return nullptr;
+            }
+
+            static std::unique_ptr<QueryNode> Combine(QueryNode::Kind kind, std::unique_ptr<QueryNode> left,
+                                                      std::unique_ptr<QueryNode> right) {
+                auto node = std::make_unique<QueryNode>();
+                node->kind = kind;
+                node->pos = left->pos;
+                node->children.push_back(std::move(left));
+                node->children.push_back(std::move(right));
+                return node;
+            }
+
+        private:
+            const std::vector<Token>& m_tokens;
+            std::string& m_error;
+            size_t m_index;
+        };
+
+        // ---------------------------------------------------------------------
+        // Constant folding and name resolution
+        // ---------------------------------------------------------------------
+
+        struct Constant {
+            bool isNumber = false;
+            double number = 0.0;
+            std::string text;
+        };
+
+        bool FoldValue(const ValueNode& node, Constant& out, std::string& error) {
+            switch (node.kind) {
+            case ValueNode::Kind::Number:
+                out.isNumber = true;
+                out.number = node.number;
+                return true;
+
+            case ValueNode::Kind::String:
+                out.isNumber = false;
+                out.text = node.text;
+                return true;
+
+            case ValueNode::Kind::Negate:
+                if (!FoldValue(*node.left, out, error)) return false;
+                if (!out.isNumber) {
+                    error = "Cannot negate text at " + std::to_string(node.pos);
+                    return false;
+                }
+                out.number = -out.number;
+                return true;
+
+            case ValueNode::Kind::Binary: {
+                Constant left, right;
+                if (!FoldValue(*node.left, left, error) || !FoldValue(*node.right, right, error)) return false;
+                if (!left.isNumber || !right.isNumber) {
+                    error = std::string("Arithmetic on text at ") + std::to_string(node.pos);
+                    return false;
+                }
+
+                out.isNumber = true;
+                switch (node.op) {
+                case '+': out.number = left.number + right.number; break;
+                case '-': out.number = left.number - right.number; break;
+                case '*': out.number = left.number * right.number; break;
+                default:
+                    if (right.number == 0.0) {
+                        error = "Division by zero at " + std::to_string(node.pos);
+                        return false;
+                    }
+                    out.number = left.number / right.number;
+                    break;
+                }
+                return true;
+            }
+            }
+            return false;
+        }
+
+        // Turn a numeric comparison into an inclusive [lo, hi] range
+        bool ComparisonRange(const std::string& op, double value, float& lo, float& hi, bool& negate) {
+            float v = static_cast<float>(value);
+            negate = false;
+            lo = -kInfinity;
+            hi = kInfinity;
+
+            if (op == "=") { lo = v; hi = v; }
+            else if (op == "!=") { lo = v; hi = v; negate = true; }
+            else if (op == ">=") { lo = v; }
+            else if (op == ">") { lo = std::nextafter(v, kInfinity); }
+            else if (op == "<=") { hi = v; }
+            else if (op == "<") { hi = std::nextafter(v, -kInfinity); }
+            else return false;
+
+            return true;
+        }
+
+        std::unique_ptr<QueryNode> MakeScan(QueryOp scan, int32_t arg, float lo, float hi, bool negate) {
+            auto node = std::make_unique<QueryNode>();
+            node->kind = QueryNode::Kind::Scan;
+            node->scan = scan;
+            node->arg = arg;
+            node->lo = lo;
+            node->hi = hi;
+
+            if (!negate) {
+                return node;
+            }
+
+            auto inverted = std::make_unique<QueryNode>();
+            inverted->kind = QueryNode::Kind::Not;
+            inverted->children.push_back(std::move(node));
+            return inverted;
+        }
+
+        // Resolve one comparison into a scan (or a constant)
+        std::unique_ptr<QueryNode> ResolveCompare(const QueryNode& node, const StashStore& store, std::string& error) {
+            Constant value;
+            if (!FoldValue(*node.value, value, error)) {
+                return nullptr;
+            }
+
+            std::string at = " at " + std::to_string(node.pos);
+            std::string field = node.quotedField ? node.field : Lowered(node.field);
+
+            // Numeric fields: item level, pseudo stats and quoted stat text
+            QueryOp numericScan = QueryOp::None;
+            int32_t arg = 0;
+
+            if (node.quotedField) {
+                std::string key;
+                float ignored = 0.0f;
+                if (!StashStore::ParseMod(node.field, key, ignored)) {
+                    error = "Empty stat" + at;
+                    return nullptr;
+                }
+                int statId = store.FindStat(key);
+                if (statId < 0) {
+                    // No item has this stat, so no item can satisfy the comparison
+                    return MakeConst(node.op == "!=");
+                }
+                numericScan = QueryOp::ScanStat;
+                arg = statId;
+            } else if (field == "ilvl" || field == "itemlevel" || field == "item_level") {
+                numericScan = QueryOp::ScanItemLevel;
+            } else if (field.compare(0, 7, "pseudo.") == 0) {
+                StashPseudoStat stat;
+                if (!StashStore::ParsePseudoStat(field, stat)) {
+                    error = "Unknown pseudo stat '" + node.field + "'" + at;
+                    return nullptr;
+                }
+                numericScan = QueryOp::ScanPseudo;
+                arg = static_cast<int32_t>(stat);
+            }
+
+            if (numericScan != QueryOp::None) {
+                if (!value.isNumber) {
+                    error = "'" + node.field + "' needs a number" + at;
+                    return nullptr;
+                }
+
+                float lo, hi;
+                bool negate;
+                if (!ComparisonRange(node.op, value.number, lo, hi, negate)) {
+                    error = "'" + node.op + "' cannot compare numbers" + at;
+                    return nullptr;
+                }
+                return MakeScan(numericScan, arg, lo, hi, negate);
+            }
+
+            if (field == "rarity" || field == "frame") {
+                StashRarity rarity;
+                if (value.isNumber || !StashStore::ParseRarity(value.text, rarity)) {
+                    error = "Unknown rarity" + at;
+                    return nullptr;
+                }
+                if (node.op != "=" && node.op != "!=") {
+                    error = "Rarity only supports = and !=" + at;
+                    return nullptr;
+                }
+                return MakeScan(QueryOp::ScanRarity, static_cast<int32_t>(rarity), 0.0f, 0.0f, node.op == "!=");
+            }
+
+            if (field == "base" || field == "basetype" || field == "type") {
+                if (value.isNumber) {
+                    error = "'" + node.field + "' needs text" + at;
+                    return nullptr;
+                }
+
+                if (node.op == "~") {
+                    auto scan = MakeScan(QueryOp::ScanBaseContains, 0, 0.0f, 0.0f, false);
+                    scan->text = value.text;
+                    return scan;
+                }
+
+                if (node.op != "=" && node.op != "!=") {
+                    error = "Base type only supports =, != and ~" + at;
+                    return nullptr;
+                }
+
+                // Exact names are resolved against the dictionary now
+                std::string wanted = Lowered(value.text);
+                for (size_t code = 0; code < store.GetBaseCount(); code++) {
+                    if (Lowered(store.GetBaseName(static_cast<uint32_t>(code))) == wanted) {
+                        return MakeScan(QueryOp::ScanBase, static_cast<int32_t>(code), 0.0f, 0.0f, node.op == "!=");
+                    }
+                }
+                return MakeConst(node.op == "!=");
+            }
+
+            error = "Unknown field '" + node.field + "'" + at;
+            return nullptr;
+        }
+
+        // Resolve comparisons bottom-up
+        std::unique_ptr<QueryNode> Resolve(std::unique_ptr<QueryNode> node, const StashStore& store, std::string& error) {
+            if (node->kind == QueryNode::Kind::Compare) {
+                return ResolveCompare(*node, store, error);
+            }
+
+            for (auto& child : node->children) {
+                child = Resolve(std::move(child), store, error);
+                if (!child) return nullptr;
+            }
+            return node;
+        }
+
+        bool IsRangeScan(const QueryNode& node) {
+            return node.kind == QueryNode::Kind::Scan &&
+                (node.scan == QueryOp::ScanItemLevel || node.scan == QueryOp::ScanStat || node.scan == QueryOp::ScanPseudo);
+        }
+
+        // Fold constants, flatten nested AND/OR, remove double negation and
+        // intersect ranges on the same field under AND
+        std::unique_ptr<QueryNode> Simplify(std::unique_ptr<QueryNode> node) {
+            if (node->kind == QueryNode::Kind::Not) {
+                auto child = Simplify(std::move(node->children[0]));
+                if (child->kind == QueryNode::Kind::Const) {
+                    return MakeConst(!child->truth);
+                }
+                if (child->kind == QueryNode::Kind::Not) {
+                    return std::move(child->children[0]);
+                }
+                node->children[0] = std::move(child);
+                return node;
+            }
+
+            if (node->kind != QueryNode::Kind::And && node->kind != QueryNode::Kind::Or) {
+                return node;
+            }
+
+            bool isAnd = node->kind == QueryNode::Kind::And;
+            std::vector<std::unique_ptr<QueryNode>> children;
+
+            for (auto& original : node->children) {
+                auto child = Simplify(std::move(original));
+
+                if (child->kind == QueryNode::Kind::Const) {
+                    // false under AND / true under OR decides the whole node
+                    if (child->truth != isAnd) {
+                        return MakeConst(child->truth);
+                    }
+                    continue;
+                }
+
+                if (child->kind == node->kind) {
+                    for (auto& grandchild : child->children) {
+                        children.push_back(std::move(grandchild));
+                    }
+                } else {
+                    children.push_back(std::move(child));
+                }
+            }
+
+            if (isAnd) {
+                // Intersect ranges over the same column
+                for (size_t i = 0; i < children.size(); i++) {
+                    if (!IsRangeScan(*children[i])) continue;
+
+                    for (size_t j = i + 1; j < children.size();) {
+                        QueryNode& a = *children[i];
+                        const QueryNode& b = *children[j];
+                        if (IsRangeScan(b) && a.scan == b.scan && a.arg == b.arg) {
+                            a.lo = std::max(a.lo, b.lo);
+                            a.hi = std::min(a.hi, b.hi);
+                            children.erase(children.begin() + j);
+                        } else {
+                            j++;
+                        }
+                    }
+
+                    if (children[i]->lo > children[i]->hi) {
+                        return MakeConst(false);
+                    }
+                }
+            }
+
+            if (children.empty()) {
+                return MakeConst(isAnd);
+            }
+            if (children.size() == 1) {
+                return std::move(children[0]);
+            }
+
+            node->children = std::move(children);
+            return node;
+        }
+
+        // ---------------------------------------------------------------------
+        // Code generation
+        // ---------------------------------------------------------------------
+
+        void Emit(const QueryNode& node, std::vector<QueryInstruction>& code, std::vector<std::string>& strings,
+                  size_t depth, size_t& maxDepth) {
+            maxDepth = std::max(maxDepth, depth + 1);
+
+            switch (node.kind) {
+            case QueryNode::Kind::Const:
+                code.push_back({ node.truth ? QueryOp::All : QueryOp::None, 0, 0.0f, 0.0f });
+                break;
+
+            case QueryNode::Kind::Scan: {
+                QueryInstruction instruction = { node.scan, node.arg, node.lo, node.hi };
+                if (node.scan == QueryOp::ScanBaseContains) {
+                    instruction.arg = static_cast<int32_t>(strings.size());
+                    strings.push_back(node.text);
+                }
+                code.push_back(instruction);
+                break;
+            }
+
+            case QueryNode::Kind::Not:
+                Emit(*node.children[0], code, strings, depth, maxDepth);
+                code.push_back({ QueryOp::Not, 0, 0.0f, 0.0f });
+                break;
+
+            case QueryNode::Kind::And:
+            case QueryNode::Kind::Or: {
+                QueryOp op = node.kind == QueryNode::Kind::And ? QueryOp::And : QueryOp::Or;
+                Emit(*node.children[0], code, strings, depth, maxDepth);
+                for (size_t i = 1; i < node.children.size(); i++) {
+                    Emit(*node.children[i], code, strings, depth + 1, maxDepth);
+                    code.push_back({ op, 0, 0.0f, 0.0f });
+                }
+                break;
+            }
+
+            default:
+                break;
+            }
+        }
+
+        uint8_t ClampLevel(float value) {
+            if (!(value > 0.0f)) return 0;
+            if (value >= 255.0f) return 255;
+            return static_cast<uint8_t>(value);
+        }
+    }
+
+    bool QueryCompiler::Compile(std::string_view text, const StashStore& store, StashQuery& query, std::string& error) {
+        query.m_code.clear();
+        query.m_strings.clear();
+        query.m_maxDepth = 0;
+
+        std::vector<Token> tokens;
+        if (!Tokenize(text, tokens, error)) {
+            return false;
+        }
+
+        // An empty query matches everything
+        if (tokens.size() == 1) {
+            query.m_code.push_back({ QueryOp::All, 0, 0.0f, 0.0f });
+            query.m_maxDepth = 1;
+            return true;
+        }
+
+        error.clear();
+        Parser parser(tokens, error);
+        auto tree = parser.Parse();
+        if (!tree) {
+            return false;
+        }
+
+        tree = Resolve(std::move(tree), store, error);
+        if (!tree) {
+            return false;
+        }
+
+        tree = Simplify(std::move(tree));
+        Emit(*tree, query.m_code, query.m_strings, 0, query.m_maxDepth);
+        return true;
+    }
+
+    void StashQuery::Execute(const StashStore& store, StashBitmap& result) const {
+        if (m_stack.size() < m_maxDepth) {
+            m_stack.resize(m_maxDepth);
+        }
+
+        size_t top = 0;
+        for (const QueryInstruction& instruction : m_code) {
+            switch (instruction.op) {
+            case QueryOp::ScanRarity:
+                store.FilterRarity(static_cast<StashRarity>(instruction.arg), m_stack[top++]);
+                break;
+
+            case QueryOp::ScanItemLevel: {
+                // Integer column: round the float range inwards
+                float lo = std::ceil(instruction.lo);
+                float hi = std::floor(instruction.hi);
+                if (lo > hi || hi < 0.0f || lo > 255.0f) {
+                    m_stack[top].Resize(store.GetItemCount());
+                } else {
+                    store.FilterItemLevel(ClampLevel(lo), ClampLevel(hi), m_stack[top]);
+                }
+                top++;
+                break;
+            }
+
+            case QueryOp::ScanBase:
+                store.FilterBase(static_cast<uint32_t>(instruction.arg), m_stack[top++]);
+                break;
+
+            case QueryOp::ScanBaseContains:
+                store.FilterBaseContains(m_strings[instruction.arg], m_stack[top++]);
+                break;
+
+            case QueryOp::ScanStat:
+                store.FilterStat(instruction.arg, instruction.lo, instruction.hi, m_stack[top++]);
+                break;
+
+            case QueryOp::ScanPseudo:
+                store.FilterPseudo(static_cast<StashPseudoStat>(instruction.arg), instruction.lo, instruction.hi, m_stack[top++]);
+                break;
+
+            case QueryOp::All:
+                m_stack[top].Resize(store.GetItemCount());
+                m_stack[top++].Fill();
+                break;
+
+            case QueryOp::None:
+                m_stack[top++].Resize(store.GetItemCount());
+                break;
+
+            case QueryOp::And:
+                top--;
+                m_stack[top - 1].And(m_stack[top]);
+                break;
+
+            case QueryOp::Or:
+                top--;
+                m_stack[top - 1].Or(m_stack[top]);
+                break;
+
+            case QueryOp::Not:
+                m_stack[top - 1].Invert();
+                break;
+            }
+        }
+
+        if (top == 0) {
+            result.Resize(store.GetItemCount());
+            return;
+        }
+
+        std::swap(result, m_stack[0]);
+    }
+
+    std::string StashQuery::Disassemble() const {
+        static const char* const names[] = {
+            "SCAN_RARITY", "SCAN_ILVL", "SCAN_BASE", "SCAN_BASE_CONTAINS", "SCAN_STAT", "SCAN_PSEUDO",
+            "ALL", "NONE", "AND", "OR", "NOT"
+        };
+
+        std::ostringstream out;
+        for (const QueryInstruction& instruction : m_code) {
+            out << names[static_cast<int>(instruction.op)];
+            switch (instruction.op) {
+            case QueryOp::ScanRarity:
+            case QueryOp::ScanBase:
+                out << " " << instruction.arg;
+                break;
+            case QueryOp::ScanBaseContains:
+                out << " \"" << m_strings[instruction.arg] << "\"";
+                break;
+            case QueryOp::ScanItemLevel:
+                out << " [" << instruction.lo << ", " << instruction.hi << "]";
+                break;
+            case QueryOp::ScanStat:
+            case QueryOp::ScanPseudo:
+                out << " " << instruction.arg << " [" << instruction.lo << ", " << instruction.hi << "]";
+                break;
+            default:
+                break;
+            }
+            out << "\n";
+        }
+        return out.str();
+    }
+
+} // namespace Nexile
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "StashStore.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Bytecode operations. Scans push a bitmap, logic ops combine the top of the stack.
+    enum class QueryOp : uint8_t {
+        ScanRarity,         // arg = rarity
+        ScanItemLevel,      // [lo, hi]
+        ScanBase,           // arg = base code
+        ScanBaseContains,   // arg = string index
+        ScanStat,           // arg = stat id, [lo, hi]
+        ScanPseudo,         // arg = pseudo stat, [lo, hi]
+        All,
+        None,
+        And,
+        Or,
+        Not
+    };
+
+    struct QueryInstruction {
+        QueryOp op;
+        int32_t arg;
+        float lo;
+        float hi;
+    };
+
+    // Compiled stash query.
+    //
+    // A program is a postfix sequence of column scans and bitmap operations, run
+    // on a small stack of reusable bitmaps; every scan is one of the vectorised
+    // StashScan kernels. A program is bound to the dictionaries of the store it
+    // was compiled against and must be recompiled after the store is rebuilt.
+    class StashQuery {
+    public:
+        StashQuery() = default;
+
+        // Run the program; result holds the matching rows
+        void Execute(const StashStore& store, StashBitmap& result) const;
+
+        // Human-readable listing of the program
+        std::string Disassemble() const;
+
+        const std::vector<QueryInstruction>& GetInstructions() const { return m_code; }
+
+    private:
+        friend class QueryCompiler;
+
+        std::vector<QueryInstruction> m_code;
+        std::vector<std::string> m_strings;
+        size_t m_maxDepth = 0;
+
+        // Evaluation stack, kept between runs
+        mutable std::vector<StashBitmap> m_stack;
+    };
+
+    // Compiler for the stash search language:
+    //
+    //   rarity = rare and pseudo.total_life >= 70 and ilvl >= 84
+    //   base ~ "ring" and ("+# to maximum life" > 40 or not rarity = unique)
+    //
+    // Fields are rarity, ilvl, base (= exact, ~ contains), pseudo.<name> and
+    // quoted mod text for individual stats ("+40 to maximum Life" and
+    // "+# to maximum life" name the same stat). Values may be arithmetic on
+    // constants. Compilation folds constants, resolves stat, base and rarity
+    // names against the store, turns comparisons into ranges, merges ranges on
+    // the same field under AND and drops branches that are always true or false.
+    class QueryCompiler {
+    public:
+        static bool Compile(std::string_view text, const StashStore& store, StashQuery& query, std::string& error);
+    };
+
+} // namespace Nexile
@@ -0,0 +1,264 @@
+#include "StashIngester.h"
+
+#include <chrono>
+#include <fstream>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        // Item fields the store cares about
+        enum class ItemField {
+            None,
+            Name,
+            TypeLine,
+            BaseType,
+            FrameType,
+            ItemLevel,
+            Mods
+        };
+
+        ItemField ClassifyKey(const std::string& key) {
+            if (key == "name") return ItemField::Name;
+            if (key == "typeLine") return ItemField::TypeLine;
+            if (key == "baseType") return ItemField::BaseType;
+            if (key == "frameType") return ItemField::FrameType;
+            if (key == "ilvl") return ItemField::ItemLevel;
+            if (key == "explicitMods" || key == "implicitMods" || key == "craftedMods" ||
+                key == "fracturedMods" || key == "enchantMods") {
+                return ItemField::Mods;
+            }
+            return ItemField::None;
+        }
+
+        // SAX handler that recognises objects inside "items" arrays as items
+        class StashSaxHandler : public nlohmann::json_sax<json> {
+        public:
+            explicit StashSaxHandler(StashStore& store)
+                : m_store(store), m_role(FrameRole::Other), m_itemDepth(0), m_field(ItemField::None), m_items(0) {
+                m_stack.reserve(32);
+            }
+
+            size_t GetItemCount() const { return m_items; }
+            const std::string& GetError() const { return m_error; }
+
+            bool null() override { return Scalar(); }
+            bool boolean(bool) override { return Scalar(); }
+
+            bool number_integer(number_integer_t value) override {
+                SetNumber(static_cast<double>(value));
+                return Scalar();
+            }
+
+            bool number_unsigned(number_unsigned_t value) override {
+                SetNumber(static_cast<double>(value));
+                return Scalar();
+            }
+
+            bool number_float(number_float_t value, const string_t&) override {
+                SetNumber(value);
+                return Scalar();
+            }
+
+            bool string(string_t& value) override {
+                if (InItemFields()) {
+                    switch (m_field) {
+                    case ItemField::Name: m_record.name = StripMarkup(value); break;
+                    case ItemField::TypeLine: m_typeLine = StripMarkup(value); break;
+                    case ItemField::BaseType: m_record.baseType = value; break;
+                    default: break;
+                    }
+                } else if (InModArray()) {
+                    m_record.mods.push_back(std::move(value));
+                }
+                return Scalar();
+            }
+
+            bool binary(binary_t&) override { return Scalar(); }
+
+            bool start_object(std::size_t) override {
+                // An object directly inside an "items" array is an item - unless
+                // we are already inside one (socketed items are not stash rows)
+                bool isItem = m_itemDepth == 0 && !m_stack.empty() &&
+                    m_stack.back().isArray && m_stack.back().role == FrameRole::Items;
+
+                m_stack.push_back({ false, TakeRole() });
+
+                if (isItem) {
+                    m_itemDepth = m_stack.size();
+                    m_record.Clear();
+                    m_typeLine.clear();
+                }
+                return true;
+            }
+
+            bool end_object() override {
+                if (m_itemDepth != 0 && m_stack.size() == m_itemDepth) {
+                    // Older responses have no baseType; typeLine is the base for non-magic items
+                    if (m_record.baseType.empty()) {
+                        m_record.baseType = m_typeLine;
+                    }
+                    m_store.AddItem(m_record);
+                    m_items++;
+                    m_itemDepth = 0;
+                }
+
+                m_stack.pop_back();
+                return true;
+            }
+
+            bool start_array(std::size_t) override {
+                m_stack.push_back({ true, TakeRole() });
+                return true;
+            }
+
+            bool end_array() override {
+                m_stack.pop_back();
+                return true;
+            }
+
+            bool key(string_t& value) override {
+                if (InItemFields()) {
+                    m_field = ClassifyKey(value);
+                    m_role = m_field == ItemField::Mods ? FrameRole::Mods : FrameRole::Other;
+                } else {
+                    m_role = (m_itemDepth == 0 && value == "items") ? FrameRole::Items : FrameRole::Other;
+                }
+                return true;
+            }
+
+            bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override {
+                m_error = "JSON error at byte " + std::to_string(position) + ": " + ex.what();
+                return false;
+            }
+
+        private:
+            // What the key a container was stored under means to us
+            enum class FrameRole : uint8_t {
+                Other,
+                Items,   // "items" array outside an item
+                Mods     // One of the item's mod arrays
+            };
+
+            struct Frame {
+                bool isArray;
+                FrameRole role;
+            };
+
+            // Consume the pending key for a container value (array elements have none)
+            FrameRole TakeRole() {
+                FrameRole role = FrameRole::Other;
+                if (!m_stack.empty() && !m_stack.back().isArray) {
+                    role = m_role;
+                }
+                m_role = FrameRole::Other;
+                return role;
+            }
+
+            // Directly inside the current item object
+            bool InItemFields() const {
+                return m_itemDepth != 0 && m_stack.size() == m_itemDepth;
+            }
+
+            // Directly inside one of the current item's mod arrays
+            bool InModArray() const {
+                return m_itemDepth != 0 && m_stack.size() == m_itemDepth + 1 &&
+                    m_stack.back().isArray && m_stack.back().role == FrameRole::Mods;
+            }
+
+            void SetNumber(double value) {
+                if (!InItemFields()) return;
+
+                if (m_field == ItemField::FrameType) {
+                    m_record.rarity = value >= 0 && value < 255 ? static_cast<uint8_t>(value) : 255;
+                } else if (m_field == ItemField::ItemLevel) {
+                    m_record.itemLevel = value <= 0 ? 0 : (value >= 255 ? 255 : static_cast<uint8_t>(value));
+                }
+            }
+
+            bool Scalar() {
+                if (InItemFields()) {
+                    m_field = ItemField::None;
+                }
+                return true;
+            }
+
+            // Names can carry localisation markup such as "<<set:MS>><<set:M>><<set:S>>"
+            static std::string StripMarkup(const std::string& text) {
+                size_t pos = text.rfind(">>");
+                return pos == std::string::npos ? text : text.substr(pos + 2);
+            }
+
+        private:
+            StashStore& m_store;
+            std::vector<Frame> m_stack;
+            FrameRole m_role;
+            std::string m_error;
+
+            // Stack depth of the item object being assembled (0 when outside an item)
+            size_t m_itemDepth;
+            ItemField m_field;
+
+            StashItemRecord m_record;
+            std::string m_typeLine;
+            size_t m_items;
+        };
+    }
+
+    StashIngester::StashIngester(StashStore& store)
+        : m_store(store) {
+    }
+
+    bool StashIngester::IngestText(const std::string& jsonText, std::string& error) {
+        auto start = std::chrono::steady_clock::now();
+
+        StashSaxHandler handler(m_store);
+        bool ok = json::sax_parse(jsonText, &handler);
+
+        m_stats.items = handler.GetItemCount();
+        m_stats.bytes = jsonText.size();
+        m_stats.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (!ok) {
+            error = handler.GetError();
+        }
+        return ok;
+    }
+
+    bool StashIngester::IngestFile(const std::string& path, std::string& error) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "Cannot open " + path;
+            return false;
+        }
+
+        bool ok = IngestStream(file, error);
+
+        file.clear();
+        file.seekg(0, std::ios::end);
+        m_stats.bytes = static_cast<size_t>(file.tellg());
+        return ok;
+    }
+
+    bool StashIngester::IngestStream(std::istream& stream, std::string& error) {
+        auto start = std::chrono::steady_clock::now();
+
+        StashSaxHandler handler(m_store);
+        bool ok = json::sax_parse(stream, &handler);
+
+        m_stats.items = handler.GetItemCount();
+        m_stats.bytes = 0;
+        m_stats.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (!ok) {
+            error = handler.GetError();
+        }
+        return ok;
+    }
+
+} // namespace Nexile
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "StashStore.h"
+
+#include <string>
+#include <istream>
+
+namespace Nexile {
+
+    // Ingest statistics
+    struct StashIngestStats {
+        size_t items = 0;       // Items added to the store
+        size_t bytes = 0;       // JSON bytes consumed (0 for streams of unknown size)
+        double milliseconds = 0.0;
+    };
+
+    // Streams stash JSON into a StashStore.
+    //
+    // Accepts the stash-tab API response ({"items": [...]}), public stash pages
+    // ({"stashes": [{"items": [...]}]}) and local exports that wrap either of
+    // them. Parsing is SAX based: items are assembled field by field in a reused
+    // record and appended as soon as their object closes, so the JSON document is
+    // never materialised and memory stays proportional to the store.
+    class StashIngester {
+    public:
+        explicit StashIngester(StashStore& store);
+
+        // Ingest a JSON document held in memory
+        bool IngestText(const std::string& jsonText, std::string& error);
+
+        // Ingest a JSON file without loading it whole
+        bool IngestFile(const std::string& path, std::string& error);
+
+        // Ingest from any stream
+        bool IngestStream(std::istream& stream, std::string& error);
+
+        // Statistics of the last ingest
+        const StashIngestStats& GetLastStats() const { return m_stats; }
+
+    private:
+        StashStore& m_store;
+        StashIngestStats m_stats;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,199 @@
+#include "StashScan.h"
+
+#include <cmath>
+
+#ifdef NEXILE_STASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Nexile {
+
+    namespace {
+        int PopCount(uint64_t word) {
+#ifdef _MSC_VER
+            return static_cast<int>(__popcnt64(word));
+#else
+            return __builtin_popcountll(word);
+#endif
+        }
+
+        int LowestBit(uint64_t word) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctzll(word);
+#endif
+        }
+
+        // Pack a partial word for the scalar tail of a kernel
+        template <typename Predicate>
+        void ScalarTail(size_t begin, size_t count, uint64_t* out, Predicate&& matches) {
+            for (size_t row = begin; row < count; row++) {
+                if ((row & 63) == 0) {
+                    out[row >> 6] = 0;
+                }
+                if (matches(row)) {
+                    out[row >> 6] |= uint64_t(1) << (row & 63);
+                }
+            }
+        }
+    }
+
+    void StashBitmap::Fill() {
+        m_words.assign(m_words.size(), ~uint64_t(0));
+        TrimTail();
+    }
+
+    void StashBitmap::And(const StashBitmap& other) {
+        for (size_t i = 0; i < m_words.size(); i++) m_words[i] &= other.m_words[i];
+    }
+
+    void StashBitmap::Or(const StashBitmap& other) {
+        for (size_t i = 0; i < m_words.size(); i++) m_words[i] |= other.m_words[i];
+    }
+
+    void StashBitmap::AndNot(const StashBitmap& other) {
+        for (size_t i = 0; i < m_words.size(); i++) m_words[i] &= ~other.m_words[i];
+    }
+
+    void StashBitmap::Invert() {
+        for (uint64_t& word : m_words) word = ~word;
+        TrimTail();
+    }
+
+    size_t StashBitmap::Count() const {
+        size_t count = 0;
+        for (uint64_t word : m_words) count += PopCount(word);
+        return count;
+    }
+
+    void StashBitmap::GetRows(std::vector<uint32_t>& rows, size_t limit) const {
+        rows.clear();
+        for (size_t w = 0; w < m_words.size() && rows.size() < limit; w++) {
+            for (uint64_t word = m_words[w]; word && rows.size() < limit; word &= word - 1) {
+                rows.push_back(static_cast<uint32_t>(w * 64 + LowestBit(word)));
+            }
+        }
+    }
+
+    void StashBitmap::TrimTail() {
+        if (!m_words.empty() && (m_size & 63)) {
+            m_words.back() &= (uint64_t(1) << (m_size & 63)) - 1;
+        }
+    }
+
+    namespace StashScan {
+
+        void RangeU8(const uint8_t* values, size_t count, uint8_t lo, uint8_t hi, uint64_t* out) {
+            size_t row = 0;
+
+#ifdef NEXILE_STASH_SSE2
+            // Unsigned range test with max/min: v >= lo <=> max(v, lo) == v
+            const __m128i vlo = _mm_set1_epi8(static_cast<char>(lo));
+            const __m128i vhi = _mm_set1_epi8(static_cast<char>(hi));
+
+            for (; row + 64 <= count; row += 64) {
+                uint64_t word = 0;
+                for (int lane = 0; lane < 4; lane++) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + row + lane * 16));
+                    __m128i geLo = _mm_cmpeq_epi8(_mm_max_epu8(v, vlo), v);
+                    __m128i leHi = _mm_cmpeq_epi8(_mm_min_epu8(v, vhi), v);
+                    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(geLo, leHi)));
+                    word |= static_cast<uint64_t>(mask) << (lane * 16);
+                }
+                out[row >> 6] = word;
+            }
+#endif
+
+            ScalarTail(row, count, out, [&](size_t i) { return values[i] >= lo && values[i] <= hi; });
+        }
+
+        void EqualsU32(const uint32_t* values, size_t count, uint32_t key, uint64_t* out) {
+            size_t row = 0;
+
+#ifdef NEXILE_STASH_SSE2
+            const __m128i vkey = _mm_set1_epi32(static_cast<int>(key));
+
+            for (; row + 64 <= count; row += 64) {
+                uint64_t word = 0;
+                for (int lane = 0; lane < 16; lane++) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + row + lane * 4));
+                    uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, vkey))));
+                    word |= static_cast<uint64_t>(mask) << (lane * 4);
+                }
+                out[row >> 6] = word;
+            }
+#endif
+
+            ScalarTail(row, count, out, [&](size_t i) { return values[i] == key; });
+        }
+
+        void InTableU32(const uint32_t* values, size_t count, const uint8_t* table, uint64_t* out) {
+            // A gather per row; SSE2 has no gather, so build whole words branch-free instead
+            size_t row = 0;
+            for (; row + 64 <= count; row += 64) {
+                uint64_t word = 0;
+                for (int bit = 0; bit < 64; bit++) {
+                    word |= static_cast<uint64_t>(table[values[row + bit]] != 0) << bit;
+                }
+                out[row >> 6] = word;
+            }
+
+            ScalarTail(row, count, out, [&](size_t i) { return table[values[i]] != 0; });
+        }
+
+        void RangeF32(const float* values, size_t count, float lo, float hi, uint64_t* out) {
+            size_t row = 0;
+
+#ifdef NEXILE_STASH_SSE2
+            const __m128 vlo = _mm_set1_ps(lo);
+            const __m128 vhi = _mm_set1_ps(hi);
+
+            for (; row + 64 <= count; row += 64) {
+                uint64_t word = 0;
+                for (int lane = 0; lane < 16; lane++) {
+                    __m128 v = _mm_loadu_ps(values + row + lane * 4);
+                    __m128 inRange = _mm_and_ps(_mm_cmpge_ps(v, vlo), _mm_cmple_ps(v, vhi));
+                    word |= static_cast<uint64_t>(_mm_movemask_ps(inRange)) << (lane * 4);
+                }
+                out[row >> 6] = word;
+            }
+#endif
+
+            ScalarTail(row, count, out, [&](size_t i) { return values[i] >= lo && values[i] <= hi; });
+        }
+
+        void SparseRangeF32(const uint32_t* rows, const float* values, size_t count,
+                            float lo, float hi, uint64_t* out) {
+            size_t i = 0;
+
+#ifdef NEXILE_STASH_SSE2
+            const __m128 vlo = _mm_set1_ps(lo);
+            const __m128 vhi = _mm_set1_ps(hi);
+
+            for (; i + 4 <= count; i += 4) {
+                __m128 v = _mm_loadu_ps(values + i);
+                int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(v, vlo), _mm_cmple_ps(v, vhi)));
+                for (; mask; mask &= mask - 1) {
+                    uint32_t row = rows[i + LowestBit(static_cast<uint64_t>(mask))];
+                    out[row >> 6] |= uint64_t(1) << (row & 63);
+                }
+            }
+#endif
+
+            for (; i < count; i++) {
+                if (values[i] >= lo && values[i] <= hi) {
+                    out[rows[i] >> 6] |= uint64_t(1) << (rows[i] & 63);
+                }
+            }
+        }
+
+    } // namespace StashScan
+
+} // namespace Nexile
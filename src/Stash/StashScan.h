@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// SSE2 is part of the x64 baseline on every compiler we build with; 32-bit
+// and non-x86 builds fall back to the scalar kernels.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NEXILE_STASH_SSE2 1
+#endif
+
+namespace Nexile {
+
+    // One bit per stash row
+    class StashBitmap {
+    public:
+        StashBitmap() = default;
+        explicit StashBitmap(size_t size) { Resize(size); }
+
+        // Resize and clear
+        void Resize(size_t size) {
+            m_size = size;
+            m_words.assign((size + 63) / 64, 0);
+        }
+
+        // Set every row
+        void Fill();
+
+        // Clear every row
+        void Clear() { m_words.assign(m_words.size(), 0); }
+
+        void Set(size_t row) { m_words[row >> 6] |= uint64_t(1) << (row & 63); }
+        bool Test(size_t row) const { return (m_words[row >> 6] >> (row & 63)) & 1; }
+
+        // Word-wise set operations (bitmaps must have the same size)
+        void And(const StashBitmap& other);
+        void Or(const StashBitmap& other);
+        void AndNot(const StashBitmap& other);
+        void Invert();
+
+        // Number of set rows
+        size_t Count() const;
+
+        // Indices of set rows, ascending, at most limit
+        void GetRows(std::vector<uint32_t>& rows, size_t limit = SIZE_MAX) const;
+
+        size_t GetSize() const { return m_size; }
+        size_t GetWordCount() const { return m_words.size(); }
+        uint64_t* GetWords() { return m_words.data(); }
+        const uint64_t* GetWords() const { return m_words.data(); }
+
+    private:
+        // Zero the unused bits of the last word
+        void TrimTail();
+
+        std::vector<uint64_t> m_words;
+        size_t m_size = 0;
+    };
+
+    // Column scan kernels. Each writes (not ORs) one bit per row of the column
+    // into out, which must hold at least (count + 63) / 64 words.
+    namespace StashScan {
+
+        // lo <= value <= hi over an 8-bit column
+        void RangeU8(const uint8_t* values, size_t count, uint8_t lo, uint8_t hi, uint64_t* out);
+
+        // value == key over a 32-bit column
+        void EqualsU32(const uint32_t* values, size_t count, uint32_t key, uint64_t* out);
+
+        // table[value] != 0 over a 32-bit dictionary-coded column
+        void InTableU32(const uint32_t* values, size_t count, const uint8_t* table, uint64_t* out);
+
+        // lo <= value <= hi over a dense float column (NaN never matches)
+        void RangeF32(const float* values, size_t count, float lo, float hi, uint64_t* out);
+
+        // For a sparse column of (row, value) pairs, set the rows whose value is in range.
+        // out is ORed into and must already be cleared.
+        void SparseRangeF32(const uint32_t* rows, const float* values, size_t count,
+                            float lo, float hi, uint64_t* out);
+
+    } // namespace StashScan
+
+} // namespace Nexile
@@ -0,0 +1,413 @@
+#include "StashStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Nexile {
+
+    namespace {
+        // Mods that feed pseudo stats, keyed by normalised stat text
+        struct PseudoContribution {
+            const char* statKey;
+            StashPseudoStat stat;
+            float weight;
+        };
+
+        const PseudoContribution kPseudoContributions[] = {
+            { "+# to maximum life", StashPseudoStat::TotalLife, 1.0f },
+            { "+# to strength", StashPseudoStat::TotalLife, 0.5f },
+            { "+# to strength and dexterity", StashPseudoStat::TotalLife, 0.5f },
+            { "+# to strength and intelligence", StashPseudoStat::TotalLife, 0.5f },
+            { "+# to all attributes", StashPseudoStat::TotalLife, 0.5f },
+
+            { "+# to maximum mana", StashPseudoStat::TotalMana, 1.0f },
+            { "+# to intelligence", StashPseudoStat::TotalMana, 0.5f },
+            { "+# to dexterity and intelligence", StashPseudoStat::TotalMana, 0.5f },
+            { "+# to strength and intelligence", StashPseudoStat::TotalMana, 0.5f },
+            { "+# to all attributes", StashPseudoStat::TotalMana, 0.5f },
+
+            { "+# to maximum energy shield", StashPseudoStat::TotalEnergyShield, 1.0f },
+
+            { "+# to strength", StashPseudoStat::TotalStrength, 1.0f },
+            { "+# to strength and dexterity", StashPseudoStat::TotalStrength, 1.0f },
+            { "+# to strength and intelligence", StashPseudoStat::TotalStrength, 1.0f },
+            { "+# to all attributes", StashPseudoStat::TotalStrength, 1.0f },
+
+            { "+# to dexterity", StashPseudoStat::TotalDexterity, 1.0f },
+            { "+# to strength and dexterity", StashPseudoStat::TotalDexterity, 1.0f },
+            { "+# to dexterity and intelligence", StashPseudoStat::TotalDexterity, 1.0f },
+            { "+# to all attributes", StashPseudoStat::TotalDexterity, 1.0f },
+
+            { "+# to intelligence", StashPseudoStat::TotalIntelligence, 1.0f },
+            { "+# to strength and intelligence", StashPseudoStat::TotalIntelligence, 1.0f },
+            { "+# to dexterity and intelligence", StashPseudoStat::TotalIntelligence, 1.0f },
+            { "+# to all attributes", StashPseudoStat::TotalIntelligence, 1.0f },
+
+            { "+#% to fire resistance", StashPseudoStat::TotalFireResistance, 1.0f },
+            { "+#% to fire and cold resistances", StashPseudoStat::TotalFireResistance, 1.0f },
+            { "+#% to fire and lightning resistances", StashPseudoStat::TotalFireResistance, 1.0f },
+            { "+#% to fire and chaos resistances", StashPseudoStat::TotalFireResistance, 1.0f },
+            { "+#% to all elemental resistances", StashPseudoStat::TotalFireResistance, 1.0f },
+
+            { "+#% to cold resistance", StashPseudoStat::TotalColdResistance, 1.0f },
+            { "+#% to fire and cold resistances", StashPseudoStat::TotalColdResistance, 1.0f },
+            { "+#% to cold and lightning resistances", StashPseudoStat::TotalColdResistance, 1.0f },
+            { "+#% to cold and chaos resistances", StashPseudoStat::TotalColdResistance, 1.0f },
+            { "+#% to all elemental resistances", StashPseudoStat::TotalColdResistance, 1.0f },
+
+            { "+#% to lightning resistance", StashPseudoStat::TotalLightningResistance, 1.0f },
+            { "+#% to fire and lightning resistances", StashPseudoStat::TotalLightningResistance, 1.0f },
+            { "+#% to cold and lightning resistances", StashPseudoStat::TotalLightningResistance, 1.0f },
+            { "+#% to lightning and chaos resistances", StashPseudoStat::TotalLightningResistance, 1.0f },
+            { "+#% to all elemental resistances", StashPseudoStat::TotalLightningResistance, 1.0f },
+
+            { "+#% to chaos resistance", StashPseudoStat::TotalChaosResistance, 1.0f },
+            { "+#% to fire and chaos resistances", StashPseudoStat::TotalChaosResistance, 1.0f },
+            { "+#% to cold and chaos resistances", StashPseudoStat::TotalChaosResistance, 1.0f },
+            { "+#% to lightning and chaos resistances", StashPseudoStat::TotalChaosResistance, 1.0f },
+
+            { "+#% to fire resistance", StashPseudoStat::TotalElementalResistance, 1.0f },
+            { "+#% to cold resistance", StashPseudoStat::TotalElementalResistance, 1.0f },
+            { "+#% to lightning resistance", StashPseudoStat::TotalElementalResistance, 1.0f },
+            { "+#% to fire and cold resistances", StashPseudoStat::TotalElementalResistance, 2.0f },
+            { "+#% to fire and lightning resistances", StashPseudoStat::TotalElementalResistance, 2.0f },
+            { "+#% to cold and lightning resistances", StashPseudoStat::TotalElementalResistance, 2.0f },
+            { "+#% to fire and chaos resistances", StashPseudoStat::TotalElementalResistance, 1.0f },
+            { "+#% to cold and chaos resistances", StashPseudoStat::TotalElementalResistance, 1.0f },
+            { "+#% to lightning and chaos resistances", StashPseudoStat::TotalElementalResistance, 1.0f },
+            { "+#% to all elemental resistances", StashPseudoStat::TotalElementalResistance, 3.0f },
+
+            { "+#% to fire resistance", StashPseudoStat::TotalResistance, 1.0f },
+            { "+#% to cold resistance", StashPseudoStat::TotalResistance, 1.0f },
+            { "+#% to lightning resistance", StashPseudoStat::TotalResistance, 1.0f },
+            { "+#% to chaos resistance", StashPseudoStat::TotalResistance, 1.0f },
+            { "+#% to fire and cold resistances", StashPseudoStat::TotalResistance, 2.0f },
+            { "+#% to fire and lightning resistances", StashPseudoStat::TotalResistance, 2.0f },
+            { "+#% to cold and lightning resistances", StashPseudoStat::TotalResistance, 2.0f },
+            { "+#% to fire and chaos resistances", StashPseudoStat::TotalResistance, 2.0f },
+            { "+#% to cold and chaos resistances", StashPseudoStat::TotalResistance, 2.0f },
+            { "+#% to lightning and chaos resistances", StashPseudoStat::TotalResistance, 2.0f },
+            { "+#% to all elemental resistances", StashPseudoStat::TotalResistance, 3.0f },
+        };
+
+        const char* const kPseudoNames[] = {
+            "pseudo.total_life",
+            "pseudo.total_mana",
+            "pseudo.total_energy_shield",
+            "pseudo.total_strength",
+            "pseudo.total_dexterity",
+            "pseudo.total_intelligence",
+            "pseudo.total_fire_resistance",
+            "pseudo.total_cold_resistance",
+            "pseudo.total_lightning_resistance",
+            "pseudo.total_chaos_resistance",
+            "pseudo.total_elemental_resistance",
+            "pseudo.total_resistance",
+        };
+
+        static_assert(sizeof(kPseudoNames) / sizeof(kPseudoNames[0]) == static_cast<size_t>(StashPseudoStat::Count),
+                      "Every pseudo stat needs a name");
+
+        struct RarityName {
+            const char* name;
+            StashRarity rarity;
+        };
+
+        const RarityName kRarityNames[] = {
+            { "normal", StashRarity::Normal },
+            { "magic", StashRarity::Magic },
+            { "rare", StashRarity::Rare },
+            { "unique", StashRarity::Unique },
+            { "gem", StashRarity::Gem },
+            { "currency", StashRarity::Currency },
+            { "divination", StashRarity::DivinationCard },
+            { "card", StashRarity::DivinationCard },
+            { "quest", StashRarity::Quest },
+        };
+
+        bool IsDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        char ToLower(char c) {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); i++) {
+                if (ToLower(a[i]) != ToLower(b[i])) return false;
+            }
+            return true;
+        }
+    }
+
+    StashStore::StashStore() {
+        Clear();
+    }
+
+    void StashStore::Clear() {
+        m_base.clear();
+        m_rarity.clear();
+        m_itemLevel.clear();
+        m_names.clear();
+        for (auto& column : m_pseudo) {
+            column.clear();
+        }
+        for (auto& column : m_stats) {
+            column.rows.clear();
+            column.values.clear();
+        }
+    }
+
+    void StashStore::Reserve(size_t items) {
+        m_base.reserve(items);
+        m_rarity.reserve(items);
+        m_itemLevel.reserve(items);
+        m_names.reserve(items);
+        for (auto& column : m_pseudo) {
+            column.reserve(items);
+        }
+    }
+
+    uint32_t StashStore::AddItem(const StashItemRecord& record) {
+        uint32_t row = static_cast<uint32_t>(m_rarity.size());
+
+        m_base.push_back(InternBase(record.baseType));
+        m_rarity.push_back(record.rarity);
+        m_itemLevel.push_back(record.itemLevel);
+
+        if (record.name.empty() || record.name == record.baseType) {
+            m_names.push_back(record.baseType);
+        } else {
+            m_names.push_back(record.name + " " + record.baseType);
+        }
+
+        // Collect (stat, value) for the row, summing repeated stats
+        m_rowStats.clear();
+        for (const std::string& mod : record.mods) {
+            float value = 0.0f;
+            if (!ParseMod(mod, m_keyBuffer, value)) continue;
+
+            int statId = InternStat(m_keyBuffer);
+            auto it = std::find_if(m_rowStats.begin(), m_rowStats.end(),
+                                   [statId](const std::pair<int, float>& entry) { return entry.first == statId; });
+            if (it != m_rowStats.end()) {
+                it->second += value;
+            } else {
+                m_rowStats.emplace_back(statId, value);
+            }
+        }
+
+        float pseudo[static_cast<int>(StashPseudoStat::Count)] = {};
+        for (const auto& [statId, value] : m_rowStats) {
+            m_stats[statId].rows.push_back(row);
+            m_stats[statId].values.push_back(value);
+
+            for (const auto& [pseudoIndex, weight] : m_statPseudo[statId]) {
+                pseudo[pseudoIndex] += value * weight;
+            }
+        }
+
+        for (int i = 0; i < static_cast<int>(StashPseudoStat::Count); i++) {
+            m_pseudo[i].push_back(pseudo[i]);
+        }
+
+        return row;
+    }
+
+    int StashStore::FindBase(std::string_view baseType) const {
+        auto it = m_baseIndex.find(std::string(baseType));
+        return it != m_baseIndex.end() ? static_cast<int>(it->second) : -1;
+    }
+
+    int StashStore::FindStat(std::string_view statKey) const {
+        auto it = m_statIndex.find(std::string(statKey));
+        return it != m_statIndex.end() ? it->second : -1;
+    }
+
+    float StashStore::GetStatValue(uint32_t row, int statId) const {
+        const StashStatColumn& column = m_stats[statId];
+        auto it = std::lower_bound(column.rows.begin(), column.rows.end(), row);
+        if (it == column.rows.end() || *it != row) {
+            return 0.0f;
+        }
+        return column.values[it - column.rows.begin()];
+    }
+
+    void StashStore::FilterRarity(StashRarity rarity, StashBitmap& out) const {
+        PrepareBitmap(out);
+        uint8_t value = static_cast<uint8_t>(rarity);
+        StashScan::RangeU8(m_rarity.data(), m_rarity.size(), value, value, out.GetWords());
+    }
+
+    void StashStore::FilterItemLevel(uint8_t minLevel, uint8_t maxLevel, StashBitmap& out) const {
+        PrepareBitmap(out);
+        StashScan::RangeU8(m_itemLevel.data(), m_itemLevel.size(), minLevel, maxLevel, out.GetWords());
+    }
+
+    void StashStore::FilterBase(uint32_t code, StashBitmap& out) const {
+        PrepareBitmap(out);
+        StashScan::EqualsU32(m_base.data(), m_base.size(), code, out.GetWords());
+    }
+
+    void StashStore::FilterBaseContains(std::string_view text, StashBitmap& out) const {
+        PrepareBitmap(out);
+
+        // Resolve the substring against the dictionary once, then scan codes
+        std::vector<uint8_t> table(m_baseNames.size(), 0);
+        std::string needle;
+        for (char c : text) needle.push_back(ToLower(c));
+
+        std::string lowered;
+        for (size_t code = 0; code < m_baseNames.size(); code++) {
+            lowered.clear();
+            for (char c : m_baseNames[code]) lowered.push_back(ToLower(c));
+            table[code] = lowered.find(needle) != std::string::npos;
+        }
+
+        StashScan::InTableU32(m_base.data(), m_base.size(), table.data(), out.GetWords());
+    }
+
+    void StashStore::FilterStat(int statId, float minValue, float maxValue, StashBitmap& out) const {
+        PrepareBitmap(out);
+        if (statId < 0 || static_cast<size_t>(statId) >= m_stats.size()) {
+            return;
+        }
+
+        const StashStatColumn& column = m_stats[statId];
+        StashScan::SparseRangeF32(column.rows.data(), column.values.data(), column.rows.size(),
+                                  minValue, maxValue, out.GetWords());
+    }
+
+    void StashStore::FilterPseudo(StashPseudoStat stat, float minValue, float maxValue, StashBitmap& out) const {
+        PrepareBitmap(out);
+        const std::vector<float>& column = m_pseudo[static_cast<int>(stat)];
+        StashScan::RangeF32(column.data(), column.size(), minValue, maxValue, out.GetWords());
+    }
+
+    bool StashStore::ParseMod(std::string_view mod, std::string& key, float& value) {
+        key.clear();
+        key.reserve(mod.size());
+
+        float numbers[2] = {};
+        int numberCount = 0;
+
+        for (size_t i = 0; i < mod.size(); i++) {
+            char c = mod[i];
+
+            bool signedNumber = (c == '+' || c == '-') && i + 1 < mod.size() && IsDigit(mod[i + 1]);
+            if (!IsDigit(c) && !signedNumber) {
+                key.push_back(ToLower(c));
+                continue;
+            }
+
+            // Parse the number; a sign is folded into the value and written as '+'
+            bool negative = c == '-';
+            if (signedNumber) {
+                key.push_back('+');
+                i++;
+            }
+
+            float number = 0.0f;
+            for (; i < mod.size() && IsDigit(mod[i]); i++) {
+                number = number * 10.0f + static_cast<float>(mod[i] - '0');
+            }
+            if (i + 1 < mod.size() && mod[i] == '.' && IsDigit(mod[i + 1])) {
+                float scale = 0.1f;
+                for (i++; i < mod.size() && IsDigit(mod[i]); i++) {
+                    number += static_cast<float>(mod[i] - '0') * scale;
+                    scale *= 0.1f;
+                }
+            }
+            i--;
+
+            if (numberCount < 2) {
+                numbers[numberCount] = negative ? -number : number;
+            }
+            numberCount++;
+            key.push_back('#');
+        }
+
+        if (key.empty()) {
+            return false;
+        }
+
+        // "Adds # to # Fire Damage" style ranges use the average
+        if (numberCount >= 2 && key.find("# to #") != std::string::npos) {
+            value = (numbers[0] + numbers[1]) * 0.5f;
+        } else {
+            value = numberCount > 0 ? numbers[0] : 1.0f;
+        }
+
+        return true;
+    }
+
+    bool StashStore::ParseRarity(std::string_view name, StashRarity& rarity) {
+        for (const RarityName& entry : kRarityNames) {
+            if (EqualsIgnoreCase(name, entry.name)) {
+                rarity = entry.rarity;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool StashStore::ParsePseudoStat(std::string_view name, StashPseudoStat& stat) {
+        for (int i = 0; i < static_cast<int>(StashPseudoStat::Count); i++) {
+            if (EqualsIgnoreCase(name, kPseudoNames[i])) {
+                stat = static_cast<StashPseudoStat>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* StashStore::GetPseudoStatName(StashPseudoStat stat) {
+        return kPseudoNames[static_cast<int>(stat)];
+    }
+
+    uint32_t StashStore::InternBase(const std::string& baseType) {
+        auto it = m_baseIndex.find(baseType);
+        if (it != m_baseIndex.end()) {
+            return it->second;
+        }
+
+        uint32_t code = static_cast<uint32_t>(m_baseNames.size());
+        m_baseNames.push_back(baseType);
+        m_baseIndex.emplace(baseType, code);
+        return code;
+    }
+
+    int StashStore::InternStat(const std::string& key) {
+        auto it = m_statIndex.find(key);
+        if (it != m_statIndex.end()) {
+            return it->second;
+        }
+
+        int statId = static_cast<int>(m_statKeys.size());
+        m_statKeys.push_back(key);
+        m_statIndex.emplace(key, statId);
+        m_stats.emplace_back();
+
+        // Work out once which pseudo stats this stat feeds
+        std::vector<std::pair<int, float>> contributions;
+        for (const PseudoContribution& entry : kPseudoContributions) {
+            if (key == entry.statKey) {
+                contributions.emplace_back(static_cast<int>(entry.stat), entry.weight);
+            }
+        }
+        m_statPseudo.push_back(std::move(contributions));
+
+        return statId;
+    }
+
+    void StashStore::PrepareBitmap(StashBitmap& out) const {
+        if (out.GetSize() != GetItemCount()) {
+            out.Resize(GetItemCount());
+        } else {
+            out.Clear();
+        }
+    }
+
+} // namespace Nexile
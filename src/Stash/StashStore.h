@@ -0,0 +1,166 @@
+#pragma once
+
+#include "StashScan.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Rarity column values (the API's frameType)
+    enum class StashRarity : uint8_t {
+        Normal = 0,
+        Magic = 1,
+        Rare = 2,
+        Unique = 3,
+        Gem = 4,
+        Currency = 5,
+        DivinationCard = 6,
+        Quest = 7,
+        Other = 255
+    };
+
+    // Pseudo stats summed from several mods at ingest time
+    enum class StashPseudoStat : int {
+        TotalLife,
+        TotalMana,
+        TotalEnergyShield,
+        TotalStrength,
+        TotalDexterity,
+        TotalIntelligence,
+        TotalFireResistance,
+        TotalColdResistance,
+        TotalLightningResistance,
+        TotalChaosResistance,
+        TotalElementalResistance,
+        TotalResistance,
+        Count
+    };
+
+    // One item as seen by the ingester, before it is split into columns
+    struct StashItemRecord {
+        std::string name;
+        std::string baseType;
+        uint8_t rarity = static_cast<uint8_t>(StashRarity::Other);
+        uint8_t itemLevel = 0;
+        std::vector<std::string> mods;
+
+        void Clear() {
+            name.clear();
+            baseType.clear();
+            rarity = static_cast<uint8_t>(StashRarity::Other);
+            itemLevel = 0;
+            mods.clear();
+        }
+    };
+
+    // Sparse stat column: values for the rows that have the stat, in row order
+    struct StashStatColumn {
+        std::vector<uint32_t> rows;
+        std::vector<float> values;
+    };
+
+    // Column-oriented in-memory stash index.
+    //
+    // Every item is a row. Base type is dictionary coded (uint32), rarity and
+    // item level are one byte each, pseudo stats are dense float columns and
+    // explicit/implicit stats form a sparse matrix stored column by column. A
+    // stat is identified by its mod text with numbers replaced by '#', lower
+    // case ("+# to maximum life"); its value is the number in the mod (the
+    // average for "# to #" ranges), summed when an item has the same stat twice.
+    //
+    // Filters are column scans that produce a StashBitmap; compound queries
+    // AND/OR the bitmaps.
+    class StashStore {
+    public:
+        StashStore();
+
+        // Remove all items (dictionaries are kept so stat ids stay stable)
+        void Clear();
+
+        // Pre-size the columns
+        void Reserve(size_t items);
+
+        // Append an item; returns its row
+        uint32_t AddItem(const StashItemRecord& record);
+
+        // Row count
+        size_t GetItemCount() const { return m_rarity.size(); }
+
+        // Display name of a row ("Doom Loop Two-Stone Ring")
+        const std::string& GetItemName(uint32_t row) const { return m_names[row]; }
+
+        // Dictionaries
+        int FindBase(std::string_view baseType) const;
+        const std::string& GetBaseName(uint32_t code) const { return m_baseNames[code]; }
+        size_t GetBaseCount() const { return m_baseNames.size(); }
+
+        int FindStat(std::string_view statKey) const;
+        const std::string& GetStatKey(int statId) const { return m_statKeys[statId]; }
+        size_t GetStatCount() const { return m_statKeys.size(); }
+
+        // Columns
+        const std::vector<uint32_t>& GetBaseColumn() const { return m_base; }
+        const std::vector<uint8_t>& GetRarityColumn() const { return m_rarity; }
+        const std::vector<uint8_t>& GetItemLevelColumn() const { return m_itemLevel; }
+        const StashStatColumn& GetStatColumn(int statId) const { return m_stats[statId]; }
+        const std::vector<float>& GetPseudoColumn(StashPseudoStat stat) const { return m_pseudo[static_cast<int>(stat)]; }
+
+        // Value of a stat on a row (0 if absent)
+        float GetStatValue(uint32_t row, int statId) const;
+
+        // Filters; each overwrites out with the matching rows
+        void FilterRarity(StashRarity rarity, StashBitmap& out) const;
+        void FilterItemLevel(uint8_t minLevel, uint8_t maxLevel, StashBitmap& out) const;
+        void FilterBase(uint32_t code, StashBitmap& out) const;
+        void FilterBaseContains(std::string_view text, StashBitmap& out) const;
+        void FilterStat(int statId, float minValue, float maxValue, StashBitmap& out) const;
+        void FilterPseudo(StashPseudoStat stat, float minValue, float maxValue, StashBitmap& out) const;
+
+        // Split a mod line into its stat key and value
+        static bool ParseMod(std::string_view mod, std::string& key, float& value);
+
+        // Name lookups used by queries ("rare", "pseudo.total_life")
+        static bool ParseRarity(std::string_view name, StashRarity& rarity);
+        static bool ParsePseudoStat(std::string_view name, StashPseudoStat& stat);
+        static const char* GetPseudoStatName(StashPseudoStat stat);
+
+    private:
+        // Dictionary lookups that register unseen values
+        uint32_t InternBase(const std::string& baseType);
+        int InternStat(const std::string& key);
+
+        // Prepare the output bitmap for a filter
+        void PrepareBitmap(StashBitmap& out) const;
+
+    private:
+        // Row columns
+        std::vector<uint32_t> m_base;
+        std::vector<uint8_t> m_rarity;
+        std::vector<uint8_t> m_itemLevel;
+        std::vector<std::string> m_names;
+        std::vector<float> m_pseudo[static_cast<int>(StashPseudoStat::Count)];
+
+        // Sparse stat matrix, one column per stat id
+        std::vector<StashStatColumn> m_stats;
+
+        // Pseudo stat contributions of each stat id: (pseudo index, weight)
+        std::vector<std::vector<std::pair<int, float>>> m_statPseudo;
+
+        // Base type dictionary
+        std::vector<std::string> m_baseNames;
+        std::unordered_map<std::string, uint32_t> m_baseIndex;
+
+        // Stat dictionary
+        std::vector<std::string> m_statKeys;
+        std::unordered_map<std::string, int> m_statIndex;
+
+        // Ingest scratch space
+        std::string m_keyBuffer;
+        std::vector<std::pair<int, float>> m_rowStats;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,177 @@
+#include "ArbitrageScanner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace Nexile {
+
+    namespace {
+        const double kInfinity = std::numeric_limits<double>::infinity();
+    }
+
+    ArbitrageScanner::ArbitrageScanner(const ArbitrageScanOptions& options)
+        : m_options(options) {
+    }
+
+    const std::vector<ArbitrageCycle>& ArbitrageScanner::Scan(const CurrencyGraph& graph) {
+        auto start = std::chrono::steady_clock::now();
+
+        m_results.clear();
+        m_seenKeys.clear();
+
+        m_currencyCount = graph.GetCurrencyCount();
+        int maxHops = std::max(2, m_options.maxCycleLength);
+        size_t tableSize = static_cast<size_t>(maxHops + 1) * m_currencyCount;
+        if (m_distance.size() < tableSize) {
+            m_distance.resize(tableSize);
+            m_parent.resize(tableSize);
+        }
+
+        if (m_currencyCount >= 2 && graph.GetEdgeCount() > 0) {
+            for (int source = 0; source < static_cast<int>(m_currencyCount); source++) {
+                ScanFromSource(graph, source);
+            }
+        }
+
+        std::sort(m_results.begin(), m_results.end(), [](const ArbitrageCycle& a, const ArbitrageCycle& b) {
+            if (a.expectedProfitChaos != b.expectedProfitChaos) {
+                return a.expectedProfitChaos > b.expectedProfitChaos;
+            }
+            return a.profitFraction > b.profitFraction;
+        });
+
+        if (m_results.size() > m_options.maxResults) {
+            m_results.resize(m_options.maxResults);
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        m_lastScanMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        return m_results;
+    }
+
+    void ArbitrageScanner::ScanFromSource(const CurrencyGraph& graph, int source) {
+        const size_t n = m_currencyCount;
+        const int maxHops = std::max(2, m_options.maxCycleLength);
+
+        // A cycle is worth reporting when its summed weight is below -log(1 + margin)
+        const double threshold = -std::log1p(m_options.minProfitFraction);
+
+        double* distance0 = m_distance.data();
+        std::fill(distance0, distance0 + n, kInfinity);
+        distance0[source] = 0.0;
+
+        for (int hops = 1; hops <= maxHops; hops++) {
+            const double* previous = m_distance.data() + static_cast<size_t>(hops - 1) * n;
+            double* current = m_distance.data() + static_cast<size_t>(hops) * n;
+            int* parent = m_parent.data() + static_cast<size_t>(hops) * n;
+
+            std::fill(current, current + n, kInfinity);
+
+            for (size_t from = 0; from < n; from++) {
+                double base = previous[from];
+                if (base == kInfinity) {
+                    continue;
+                }
+
+                // Walks may only pass through the start currency at the very end
+                if (hops > 1 && static_cast<int>(from) == source) {
+                    continue;
+                }
+
+                const double* row = graph.GetWeightRow(static_cast<int>(from));
+                for (size_t to = 0; to < n; to++) {
+                    double candidate = base + row[to];
+                    if (candidate < current[to]) {
+                        current[to] = candidate;
+                        parent[to] = static_cast<int>(from);
+                    }
+                }
+            }
+
+            if (hops >= 2 && current[source] < threshold) {
+                ArbitrageCycle cycle;
+                if (ExtractCycle(source, hops, cycle.currencies)) {
+                    uint64_t key = CycleKey(cycle.currencies);
+                    if (m_seenKeys.insert(key).second) {
+                        EvaluateCycle(graph, cycle);
+                        m_results.push_back(std::move(cycle));
+                    }
+                }
+            }
+        }
+    }
+
+    bool ArbitrageScanner::ExtractCycle(int source, int hops, std::vector<int>& cycle) const {
+        const size_t n = m_currencyCount;
+
+        cycle.assign(static_cast<size_t>(hops), source);
+
+        // Walk the parent chain backwards: cycle[k] is the currency held after k trades
+        int node = source;
+        for (int k = hops; k >= 1; k--) {
+            node = m_parent[static_cast<size_t>(k) * n + node];
+            cycle[static_cast<size_t>(k - 1)] = node;
+        }
+
+        if (cycle.front() != source) {
+            return false;
+        }
+
+        // Reject walks that revisit a currency; the simple cycle inside is found elsewhere
+        std::vector<int> sorted(cycle);
+        std::sort(sorted.begin(), sorted.end());
+        return std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+    }
+
+    void ArbitrageScanner::EvaluateCycle(const CurrencyGraph& graph, ArbitrageCycle& cycle) const {
+        const std::vector<int>& path = cycle.currencies;
+
+        double product = 1.0;
+        double maxVolume = kInfinity;
+        bool stockKnown = true;
+
+        for (size_t i = 0; i < path.size(); i++) {
+            int from = path[i];
+            int to = path[(i + 1) % path.size()];
+
+            product *= graph.GetRate(from, to);
+
+            // After this trade we hold `product` units of `to` per start unit;
+            // the listing can only hand out `stock` units of `to`.
+            double stock = graph.GetStock(from, to);
+            if (stock > 0.0) {
+                maxVolume = std::min(maxVolume, stock / product);
+            } else {
+                stockKnown = false;
+            }
+        }
+
+        cycle.rateProduct = product;
+        cycle.profitFraction = product - 1.0;
+        cycle.maxVolume = (stockKnown && maxVolume != kInfinity) ? maxVolume : 0.0;
+        cycle.expectedProfit = cycle.profitFraction * cycle.maxVolume;
+
+        double chaosValue = graph.GetCurrency(path.front()).chaosValue;
+        cycle.expectedProfitChaos = cycle.expectedProfit * (chaosValue > 0.0 ? chaosValue : 1.0);
+    }
+
+    uint64_t ArbitrageScanner::CycleKey(const std::vector<int>& cycle) {
+        // Rotate so the smallest index comes first, then FNV-1a over the sequence
+        size_t offset = static_cast<size_t>(std::min_element(cycle.begin(), cycle.end()) - cycle.begin());
+
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < cycle.size(); i++) {
+            uint32_t value = static_cast<uint32_t>(cycle[(offset + i) % cycle.size()]);
+            for (int byte = 0; byte < 4; byte++) {
+                hash ^= (value >> (byte * 8)) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+        }
+
+        return hash ^ cycle.size();
+    }
+
+} // namespace Nexile
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CurrencyGraph.h"
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+namespace Nexile {
+
+    // A profitable sequence of bulk trades that starts and ends in the same currency
+    struct ArbitrageCycle {
+        std::vector<int> currencies;   // Trade order; the cycle returns to currencies[0]
+        double rateProduct;            // Units of currencies[0] received per unit spent
+        double profitFraction;         // rateProduct - 1
+        double maxVolume;              // Largest start amount the listed stock can absorb (0 if unknown)
+        double expectedProfit;         // profitFraction * maxVolume, in start currency
+        double expectedProfitChaos;    // expectedProfit normalised by the start currency's chaos value
+
+        ArbitrageCycle()
+            : rateProduct(0.0), profitFraction(0.0), maxVolume(0.0),
+              expectedProfit(0.0), expectedProfitChaos(0.0) {
+        }
+    };
+
+    // Tuning for a scan
+    struct ArbitrageScanOptions {
+        int maxCycleLength;        // Longest trade chain considered (2 = simple round trip)
+        double minProfitFraction;  // Ignore cycles below this margin (covers rounding on listings)
+        size_t maxResults;         // Number of ranked cycles to keep
+
+        ArbitrageScanOptions()
+            : maxCycleLength(4), minProfitFraction(0.001), maxResults(10) {
+        }
+    };
+
+    // Finds negative cycles in the -log(rate) graph and ranks them.
+    //
+    // For every start currency a hop-bounded Bellman-Ford pass computes the best
+    // walk of each length back to the start. Bounding the hop count keeps the scan
+    // at O(L * n^3) on a dense book and matches how trades are actually executed -
+    // nobody chains ten bulk trades to make a fraction of a chaos. Non-simple walks
+    // are discarded (their simple sub-cycle is found from another start), and
+    // rotations of the same cycle are de-duplicated.
+    //
+    // The scanner owns its work buffers so that rescanning on every ratio refresh
+    // does not allocate once the book size has stabilised.
+    class ArbitrageScanner {
+    public:
+        explicit ArbitrageScanner(const ArbitrageScanOptions& options = ArbitrageScanOptions());
+
+        // Scan the graph and return cycles ranked by expected chaos profit, then margin
+        const std::vector<ArbitrageCycle>& Scan(const CurrencyGraph& graph);
+
+        // Results of the last scan
+        const std::vector<ArbitrageCycle>& GetResults() const { return m_results; }
+
+        // Wall time of the last scan in milliseconds
+        double GetLastScanMilliseconds() const { return m_lastScanMs; }
+
+        // Change scan options
+        void SetOptions(const ArbitrageScanOptions& options) { m_options = options; }
+        const ArbitrageScanOptions& GetOptions() const { return m_options; }
+
+    private:
+        // Run the bounded relaxation from one start currency and collect closing cycles
+        void ScanFromSource(const CurrencyGraph& graph, int source);
+
+        // Rebuild the cycle ending at (hops, source) from the parent table
+        bool ExtractCycle(int source, int hops, std::vector<int>& cycle) const;
+
+        // Fill in volume and profit figures
+        void EvaluateCycle(const CurrencyGraph& graph, ArbitrageCycle& cycle) const;
+
+        // Rotation-independent key used for de-duplication
+        static uint64_t CycleKey(const std::vector<int>& cycle);
+
+    private:
+        ArbitrageScanOptions m_options;
+
+        // (maxCycleLength + 1) * n distance and parent tables, reused between scans
+        std::vector<double> m_distance;
+        std::vector<int> m_parent;
+        size_t m_currencyCount = 0;
+
+        // Cycle keys seen during the current scan
+        std::unordered_set<uint64_t> m_seenKeys;
+
+        // Ranked results of the last scan
+        std::vector<ArbitrageCycle> m_results;
+
+        // Timing of the last scan
+        double m_lastScanMs = 0.0;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,140 @@
+#include "CurrencyGraph.h"
+
+#include <cmath>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        const double kNoEdge = std::numeric_limits<double>::infinity();
+    }
+
+    bool CurrencyGraph::LoadSnapshot(const std::string& jsonText, std::string& error) {
+        Clear();
+
+        json snapshot = json::parse(jsonText, nullptr, false);
+        if (snapshot.is_discarded() || !snapshot.is_object()) {
+            error = "Ratio snapshot is not a JSON object";
+            return false;
+        }
+
+        if (!snapshot.contains("ratios") || !snapshot["ratios"].is_array()) {
+            error = "Ratio snapshot has no 'ratios' array";
+            return false;
+        }
+
+        // Register all currencies first so the matrices are allocated once
+        if (snapshot.contains("currencies") && snapshot["currencies"].is_array()) {
+            for (const auto& currency : snapshot["currencies"]) {
+                std::string id = currency.value("id", "");
+                if (!id.empty()) {
+                    RegisterCurrency(id, currency.value("name", id), currency.value("chaosValue", 0.0));
+                }
+            }
+        }
+
+        for (const auto& ratio : snapshot["ratios"]) {
+            std::string have = ratio.value("have", "");
+            std::string want = ratio.value("want", "");
+            if (!have.empty()) RegisterCurrency(have, "", 0.0);
+            if (!want.empty()) RegisterCurrency(want, "", 0.0);
+        }
+
+        Resize(0);
+
+        for (const auto& ratio : snapshot["ratios"]) {
+            int from = FindCurrency(ratio.value("have", ""));
+            int to = FindCurrency(ratio.value("want", ""));
+            double rate = ratio.value("rate", 0.0);
+            double stock = ratio.value("stock", 0.0);
+
+            if (from < 0 || to < 0 || from == to || !(rate > 0.0) || !std::isfinite(rate)) {
+                continue;
+            }
+
+            SetRatio(from, to, rate, stock);
+        }
+
+        return true;
+    }
+
+    void CurrencyGraph::Clear() {
+        m_currencies.clear();
+        m_index.clear();
+        m_rates.clear();
+        m_stock.clear();
+        m_weights.clear();
+        m_edgeCount = 0;
+    }
+
+    int CurrencyGraph::AddCurrency(const std::string& id, const std::string& name, double chaosValue) {
+        size_t oldCount = m_currencies.size();
+        int index = RegisterCurrency(id, name, chaosValue);
+
+        if (m_currencies.size() != oldCount) {
+            Resize(oldCount);
+        }
+
+        return index;
+    }
+
+    int CurrencyGraph::RegisterCurrency(const std::string& id, const std::string& name, double chaosValue) {
+        auto it = m_index.find(id);
+        if (it != m_index.end()) {
+            CurrencyNode& node = m_currencies[it->second];
+            if (!name.empty()) node.name = name;
+            if (chaosValue > 0.0) node.chaosValue = chaosValue;
+            return it->second;
+        }
+
+        int index = static_cast<int>(m_currencies.size());
+        m_currencies.emplace_back(id, name.empty() ? id : name, chaosValue);
+        m_index[id] = index;
+        return index;
+    }
+
+    void CurrencyGraph::SetRatio(int from, int to, double rate, double stock) {
+        size_t cell = Cell(from, to);
+
+        if (m_rates[cell] <= 0.0) {
+            m_edgeCount++;
+        } else if (rate <= m_rates[cell]) {
+            return; // Existing listing is at least as good
+        }
+
+        m_rates[cell] = rate;
+        m_stock[cell] = stock;
+        m_weights[cell] = -std::log(rate);
+    }
+
+    int CurrencyGraph::FindCurrency(const std::string& id) const {
+        auto it = m_index.find(id);
+        return it != m_index.end() ? it->second : -1;
+    }
+
+    void CurrencyGraph::Resize(size_t oldCount) {
+        size_t newCount = m_currencies.size();
+
+        std::vector<double> rates(newCount * newCount, 0.0);
+        std::vector<double> stock(newCount * newCount, 0.0);
+        std::vector<double> weights(newCount * newCount, kNoEdge);
+
+        for (size_t from = 0; from < oldCount; from++) {
+            for (size_t to = 0; to < oldCount; to++) {
+                size_t oldCell = from * oldCount + to;
+                size_t newCell = from * newCount + to;
+                rates[newCell] = m_rates[oldCell];
+                stock[newCell] = m_stock[oldCell];
+                weights[newCell] = m_weights[oldCell];
+            }
+        }
+
+        m_rates.swap(rates);
+        m_stock.swap(stock);
+        m_weights.swap(weights);
+    }
+
+} // namespace Nexile
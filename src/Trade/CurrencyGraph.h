@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Nexile {
+
+    // Currency or fragment that takes part in bulk exchange
+    struct CurrencyNode {
+        std::string id;           // Trade id (e.g. "chaos", "divine")
+        std::string name;         // Display name
+        double chaosValue;        // Reference value used to normalise profits (0 if unknown)
+
+        CurrencyNode() : chaosValue(0.0) {}
+
+        CurrencyNode(const std::string& currencyId, const std::string& displayName, double value)
+            : id(currencyId), name(displayName), chaosValue(value) {
+        }
+    };
+
+    // Dense exchange-ratio graph built from a bulk exchange ratio book.
+    //
+    // Edge (from, to) means "give one unit of `from`, receive `rate` units of `to`".
+    // Rates are stored alongside their negative logarithm so that a profitable
+    // trade cycle shows up as a negative-weight cycle. The matrices are stored
+    // row-major with one row per source currency, which keeps the scanner's
+    // relaxation loop on contiguous memory.
+    class CurrencyGraph {
+    public:
+        CurrencyGraph() = default;
+
+        // Replace the graph contents with a recorded or live ratio book snapshot.
+        //
+        // Expected layout:
+        //   {
+        //     "currencies": [ { "id": "chaos", "name": "Chaos Orb", "chaosValue": 1 } ],
+        //     "ratios":     [ { "have": "chaos", "want": "divine", "rate": 0.0055, "stock": 40 } ]
+        //   }
+        //
+        // Currencies referenced only by ratios are added automatically. When a
+        // pair is listed more than once the best rate wins.
+        bool LoadSnapshot(const std::string& jsonText, std::string& error);
+
+        // Remove all currencies and ratios
+        void Clear();
+
+        // Add a currency (or return the index of an existing one)
+        int AddCurrency(const std::string& id, const std::string& name = "", double chaosValue = 0.0);
+
+        // Set the exchange rate for a pair, keeping the better of the old and new rate
+        void SetRatio(int from, int to, double rate, double stock);
+
+        // Look up a currency index by id (-1 if unknown)
+        int FindCurrency(const std::string& id) const;
+
+        // Accessors
+        size_t GetCurrencyCount() const { return m_currencies.size(); }
+        const CurrencyNode& GetCurrency(int index) const { return m_currencies[index]; }
+        bool HasEdge(int from, int to) const { return m_rates[Cell(from, to)] > 0.0; }
+        double GetRate(int from, int to) const { return m_rates[Cell(from, to)]; }
+        double GetStock(int from, int to) const { return m_stock[Cell(from, to)]; }
+
+        // Row of -log(rate) weights for a source currency (+inf where no listing exists)
+        const double* GetWeightRow(int from) const { return m_weights.data() + Cell(from, 0); }
+
+        // Number of listed pairs
+        size_t GetEdgeCount() const { return m_edgeCount; }
+
+    private:
+        size_t Cell(int from, int to) const {
+            return static_cast<size_t>(from) * m_currencies.size() + static_cast<size_t>(to);
+        }
+
+        // Add a currency without touching the matrices
+        int RegisterCurrency(const std::string& id, const std::string& name, double chaosValue);
+
+        // Grow the dense matrices to the current currency count, preserving edges
+        void Resize(size_t oldCount);
+
+    private:
+        // Currencies by index
+        std::vector<CurrencyNode> m_currencies;
+
+        // Currency id -> index
+        std::unordered_map<std::string, int> m_index;
+
+        // Dense n*n matrices
+        std::vector<double> m_rates;
+        std::vector<double> m_stock;
+        std::vector<double> m_weights;
+
+        // Number of listed pairs
+        size_t m_edgeCount = 0;
+    };
+
+} // namespace Nexile
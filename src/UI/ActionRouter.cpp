@@ -0,0 +1,391 @@
+#include "ActionRouter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace Nexile {
+
+    namespace {
+        // Attempts per bucket before a build tries a bigger table
+        constexpr uint32_t kMaxSeed = 1u << 12;
+
+        size_t NextPowerOfTwo(size_t value) {
+            size_t power = 1;
+            while (power < value) {
+                power <<= 1;
+            }
+            return power;
+        }
+
+        bool IsSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        void SkipSpace(std::string_view text, size_t& pos) {
+            while (pos < text.size() && IsSpace(text[pos])) {
+                pos++;
+            }
+        }
+
+        // Reads the string at pos (on its opening quote); false when it ends
+        // early or, if plainOnly, holds escapes
+        bool ReadString(std::string_view text, size_t& pos, std::string_view& value, bool plainOnly) {
+            size_t start = ++pos;
+            while (pos < text.size() && text[pos] != '"') {
+                if (text[pos] == '\\') {
+                    if (plainOnly) return false;
+                    pos++;
+                }
+                pos++;
+            }
+            if (pos >= text.size()) return false;
+            value = text.substr(start, pos - start);
+            pos++;
+            return true;
+        }
+
+        // Steps over any value, nested ones included, without checking it
+        bool SkipValue(std::string_view text, size_t& pos) {
+            std::string_view ignored;
+            if (pos >= text.size()) return false;
+            if (text[pos] == '"') {
+                return ReadString(text, pos, ignored, false);
+            }
+            if (text[pos] == '{' || text[pos] == '[') {
+                int depth = 0;
+                while (pos < text.size()) {
+                    char c = text[pos];
+                    if (c == '"') {
+                        if (!ReadString(text, pos, ignored, false)) return false;
+                        continue;
+                    }
+                    if (c == '{' || c == '[') {
+                        depth++;
+                    } else if (c == '}' || c == ']') {
+                        if (--depth == 0) {
+                            pos++;
+                            return true;
+                        }
+                    }
+                    pos++;
+                }
+                return false;
+            }
+            size_t start = pos;
+            while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' && !IsSpace(text[pos])) {
+                pos++;
+            }
+            return pos > start;
+        }
+
+        double ElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    ActionMessage::ActionMessage(std::string_view text, std::string_view action)
+        : m_text(text), m_action(action) {
+    }
+
+    const nlohmann::json& ActionMessage::Json() const {
+        if (!m_parsed) {
+            m_parsed = true;
+            try {
+                m_json = nlohmann::json::parse(m_text.begin(), m_text.end());
+            } catch (const nlohmann::json::parse_error&) {
+                m_malformed = true;
+                m_error = std::current_exception();
+                throw;
+            }
+        } else if (m_malformed) {
+            // A handler that caught the first error gets it again
+            std::rethrow_exception(m_error);
+        }
+        return m_json;
+    }
+
+    ActionRouter::ActionRouter() : m_table(std::make_shared<Table>()) {
+    }
+
+    void ActionRouter::Register(const std::string& owner, const std::string& action, ActionHandler handler) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto route = std::make_shared<Route>();
+        route->action = action;
+        route->owner = owner;
+        route->handler = std::move(handler);
+        route->stats.action = action;
+        route->stats.owner = owner;
+        m_routes[action] = std::move(route);
+        Rebuild();
+    }
+
+    void ActionRouter::Unregister(const std::string& action) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_routes.erase(action) > 0) {
+            Rebuild();
+        }
+    }
+
+    void ActionRouter::UnregisterOwner(const std::string& owner) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t before = m_routes.size();
+        for (auto it = m_routes.begin(); it != m_routes.end();) {
+            if (it->second->owner == owner) {
+                it = m_routes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (m_routes.size() != before) {
+            Rebuild();
+        }
+    }
+
+    bool ActionRouter::HasAction(const std::string& action) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return Find(*m_table, action) != nullptr;
+    }
+
+    bool ActionRouter::Dispatch(std::string_view message, std::string& error) {
+        std::shared_ptr<const Table> table;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            table = m_table;
+            m_stats.messages++;
+        }
+
+        auto fail = [&](uint64_t ActionRouterStats::* counter, std::string reason) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.*counter += 1;
+            error = std::move(reason);
+            return false;
+        };
+
+        std::string_view action;
+        bool found = false;
+        bool scanned = FindAction(message, action, found);
+
+        // The scan could not tell; the parse it would have saved happens now
+        nlohmann::json parsed;
+        std::string parsedAction;
+        if (!scanned) {
+            parsed = nlohmann::json::parse(message.begin(), message.end(), nullptr, false);
+            if (parsed.is_discarded()) {
+                return fail(&ActionRouterStats::malformed, "Malformed web message");
+            }
+            auto it = parsed.is_object() ? parsed.find("action") : parsed.end();
+            if (it != parsed.end() && it->is_string()) {
+                parsedAction = it->get<std::string>();
+                action = parsedAction;
+                found = true;
+            }
+        }
+
+        Route* route = found ? Find(*table, action) : nullptr;
+        if (!route) {
+            return fail(&ActionRouterStats::unhandled, "");
+        }
+
+        // Parsed text is handed over; scanned text waits for Json()
+        ActionMessage view(message, action);
+        if (!scanned) {
+            view.m_json = std::move(parsed);
+            view.m_parsed = true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = true;
+        try {
+            route->handler(view);
+        } catch (const std::exception& e) {
+            error = view.m_malformed ? "Malformed web message for action '" + route->action + "'"
+                                     : "Action '" + route->action + "' failed: " + e.what();
+            ok = false;
+        }
+        double elapsed = ElapsedMilliseconds(start);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (view.m_parsed) m_stats.parses++;
+        if (!ok && view.m_malformed) {
+            m_stats.malformed++;
+            return false;
+        }
+        ActionStats& stats = route->stats;
+        stats.messages++;
+        if (!ok) stats.failures++;
+        stats.lastMs = elapsed;
+        if (elapsed > stats.maxMs) stats.maxMs = elapsed;
+        stats.averageMs += (elapsed - stats.averageMs) / static_cast<double>(stats.messages);
+        return ok;
+    }
+
+    bool ActionRouter::FindAction(std::string_view message, std::string_view& action, bool& found) {
+        found = false;
+        size_t pos = 0;
+        SkipSpace(message, pos);
+        if (pos >= message.size() || message[pos] != '{') return false;
+        pos++;
+
+        SkipSpace(message, pos);
+        if (pos < message.size() && message[pos] == '}') return true;
+
+        while (pos < message.size()) {
+            std::string_view key;
+            if (message[pos] != '"' || !ReadString(message, pos, key, true)) return false;
+
+            SkipSpace(message, pos);
+            if (pos >= message.size() || message[pos] != ':') return false;
+            pos++;
+            SkipSpace(message, pos);
+
+            if (key == "action") {
+                if (pos < message.size() && message[pos] == '"') {
+                    if (!ReadString(message, pos, action, true)) return false;
+                    found = true;
+                }
+                return true;
+            }
+            if (!SkipValue(message, pos)) return false;
+
+            SkipSpace(message, pos);
+            if (pos >= message.size()) return false;
+            if (message[pos] == '}') return true;
+            if (message[pos] != ',') return false;
+            pos++;
+            SkipSpace(message, pos);
+        }
+        return false;
+    }
+
+    std::vector<ActionStats> ActionRouter::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<ActionStats> stats;
+        stats.reserve(m_routes.size());
+        for (const auto& route : m_routes) {
+            stats.push_back(route.second->stats);
+        }
+        return stats;
+    }
+
+    ActionRouterStats ActionRouter::GetRouterStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    std::shared_ptr<const ActionRouter::Table> ActionRouter::BuildTable() const {
+        auto table = std::make_shared<Table>();
+        if (m_routes.empty()) {
+            return table;
+        }
+
+        std::vector<std::shared_ptr<Route>> routes;
+        routes.reserve(m_routes.size());
+        for (const auto& route : m_routes) {
+            routes.push_back(route.second);
+        }
+
+        // About two keys per bucket in a table at most half full; a failed
+        // attempt (or two keys with the same hash) retries with another salt
+        // and, every few salts, twice the slots
+        size_t bucketCount = NextPowerOfTwo((routes.size() + 1) / 2);
+        size_t slotCount = NextPowerOfTwo(routes.size() * 2);
+        for (uint64_t salt = 0;; salt++) {
+            if (salt > 0 && salt % 4 == 0) {
+                slotCount *= 2;
+            }
+
+            std::vector<uint64_t> hashes(routes.size());
+            std::vector<std::vector<size_t>> buckets(bucketCount);
+            for (size_t i = 0; i < routes.size(); i++) {
+                hashes[i] = Hash(routes[i]->action, salt);
+                buckets[hashes[i] & (bucketCount - 1)].push_back(i);
+            }
+
+            // Fullest buckets first, while most slots are still free
+            std::vector<size_t> order(bucketCount);
+            for (size_t i = 0; i < bucketCount; i++) order[i] = i;
+            std::stable_sort(order.begin(), order.end(),
+                [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+            table->salt = salt;
+            table->seeds.assign(bucketCount, 0);
+            table->slots.assign(slotCount, nullptr);
+
+            bool placed = true;
+            std::vector<size_t> chosen;
+            for (size_t bucket : order) {
+                const std::vector<size_t>& keys = buckets[bucket];
+                if (keys.empty()) break;
+
+                bool fits = false;
+                for (uint32_t seed = 0; seed < kMaxSeed && !fits; seed++) {
+                    chosen.clear();
+                    fits = true;
+                    for (size_t key : keys) {
+                        size_t slot = Mix(hashes[key], seed) & (slotCount - 1);
+                        if (table->slots[slot] || std::find(chosen.begin(), chosen.end(), slot) != chosen.end()) {
+                            fits = false;
+                            break;
+                        }
+                        chosen.push_back(slot);
+                    }
+                    if (fits) {
+                        table->seeds[bucket] = seed;
+                        for (size_t i = 0; i < keys.size(); i++) {
+                            table->slots[chosen[i]] = routes[keys[i]];
+                        }
+                    }
+                }
+                if (!fits) {
+                    placed = false;
+                    break;
+                }
+            }
+            if (placed) {
+                return table;
+            }
+        }
+    }
+
+    void ActionRouter::Rebuild() {
+        auto start = std::chrono::steady_clock::now();
+        m_table = BuildTable();
+        m_stats.rebuilds++;
+        m_stats.actions = m_routes.size();
+        m_stats.tableSize = m_table->slots.size();
+        m_stats.lastBuildMs = ElapsedMilliseconds(start);
+    }
+
+    ActionRouter::Route* ActionRouter::Find(const Table& table, std::string_view action) {
+        if (table.slots.empty()) {
+            return nullptr;
+        }
+        uint64_t hash = Hash(action, table.salt);
+        uint32_t seed = table.seeds[hash & (table.seeds.size() - 1)];
+        Route* route = table.slots[Mix(hash, seed) & (table.slots.size() - 1)].get();
+        return route && route->action == action ? route : nullptr;
+    }
+
+    uint64_t ActionRouter::Hash(std::string_view key, uint64_t salt) {
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ull ^ (salt * 0x9e3779b97f4a7c15ull);
+        for (char c : key) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    uint64_t ActionRouter::Mix(uint64_t hash, uint64_t seed) {
+        // MurmurHash3 finalizer over the hash and the bucket's seed
+        uint64_t x = hash ^ (seed * 0xff51afd7ed558ccdull + 0x632be59bd9b4e5c9ull);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+} // namespace Nexile
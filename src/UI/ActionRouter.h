@@ -0,0 +1,141 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+#include <exception>
+
+namespace Nexile {
+
+    // A routed web message: its text and action as received, parsed into a
+    // json tree on the first Json() call only. Valid while the handler runs;
+    // a handler that keeps the message for later copies Json() or Text().
+    class ActionMessage {
+    public:
+        ActionMessage(std::string_view text, std::string_view action);
+
+        std::string_view Text() const { return m_text; }
+        std::string_view Action() const { return m_action; }
+
+        // The parsed message; throws nlohmann::json::parse_error when the
+        // text is not JSON (the router reports that as a malformed message)
+        const nlohmann::json& Json() const;
+        bool IsParsed() const { return m_parsed; }
+        bool IsMalformed() const { return m_malformed; }
+
+    private:
+        friend class ActionRouter;
+
+        std::string_view m_text;
+        std::string_view m_action;
+        mutable nlohmann::json m_json;
+        mutable bool m_parsed = false;
+        mutable bool m_malformed = false;
+        mutable std::exception_ptr m_error;
+    };
+
+    // Handles one action; reads the payload through message.Json() if it
+    // needs it
+    using ActionHandler = std::function<void(const ActionMessage& message)>;
+
+    // Counters of one action
+    struct ActionStats {
+        std::string action;
+        std::string owner;
+        uint64_t messages = 0;
+        uint64_t failures = 0;          // Handler threw
+        double lastMs = 0.0;            // Handler time of the last message
+        double maxMs = 0.0;
+        double averageMs = 0.0;
+    };
+
+    // Counters of the router as a whole
+    struct ActionRouterStats {
+        uint64_t messages = 0;
+        uint64_t unhandled = 0;         // No action, or none registered for it
+        uint64_t malformed = 0;         // Not JSON
+        uint64_t parses = 0;            // Messages parsed into a json tree
+        uint64_t rebuilds = 0;          // Lookup tables built
+        size_t actions = 0;
+        size_t tableSize = 0;           // Slots in the current lookup table
+        double lastBuildMs = 0.0;
+    };
+
+    // Routes {action: "...", ...} web messages to the handler registered for
+    // the action.
+    //
+    // Only the "action" member is read first, straight from the message text
+    // without building a json tree, and looked up in a perfect-hash table
+    // rebuilt whenever the set of actions changes: one hash of the action,
+    // one displacement lookup and one string compare find the handler or
+    // prove there is none. The message is parsed at most once, and only
+    // when the handler calls Json(), so actions that carry no payload cost
+    // the scan and the lookup alone. Dispatch takes the lock just long
+    // enough to pick up the current table, so handlers run unlocked and may
+    // register actions.
+    class ActionRouter {
+    public:
+        ActionRouter();
+
+        // Register the handler for an action, replacing any previous one.
+        // owner (usually a module id) groups actions for UnregisterOwner.
+        void Register(const std::string& owner, const std::string& action, ActionHandler handler);
+        void Unregister(const std::string& action);
+        void UnregisterOwner(const std::string& owner);
+        bool HasAction(const std::string& action) const;
+
+        // Run the handler for the message's action (any thread). Returns true
+        // when a handler ran; false with error set when the message was
+        // malformed or the handler threw, and with error empty when no
+        // handler is registered for the action. A message is malformed when
+        // the action cannot be read from it, or when its handler asks for
+        // the json tree of text that is not JSON.
+        bool Dispatch(std::string_view message, std::string& error);
+
+        // Find the top-level "action" string member without parsing the rest.
+        // Returns false when the message has to be parsed to tell (escaped
+        // characters in the action, or text that is not a JSON object);
+        // found is false when there is plainly no string action.
+        static bool FindAction(std::string_view message, std::string_view& action, bool& found);
+
+        std::vector<ActionStats> GetStats() const;
+        ActionRouterStats GetRouterStats() const;
+
+    private:
+        struct Route {
+            std::string action;
+            std::string owner;
+            ActionHandler handler;
+            ActionStats stats;
+        };
+
+        // Hash-and-displace table: a key's bucket picks the seed that sends
+        // it to its slot, and no two keys share a slot
+        struct Table {
+            uint64_t salt = 0;
+            std::vector<uint32_t> seeds;                // Per bucket
+            std::vector<std::shared_ptr<Route>> slots;  // Power-of-two sized
+        };
+
+        std::shared_ptr<const Table> BuildTable() const;
+        void Rebuild();
+        // Routes stay writable through a snapshot so Dispatch can count
+        static Route* Find(const Table& table, std::string_view action);
+        static uint64_t Hash(std::string_view key, uint64_t salt);
+        static uint64_t Mix(uint64_t hash, uint64_t seed);
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, std::shared_ptr<Route>> m_routes;
+        std::shared_ptr<const Table> m_table;
+        ActionRouterStats m_stats;
+    };
+
+} // namespace Nexile
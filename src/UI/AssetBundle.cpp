@@ -0,0 +1,307 @@
+#include "AssetBundle.h"
+#include "AssetCache.h"
+#include "Utils/Transcoder.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace Nexile {
+
+    namespace {
+        const char kMagic[4] = { 'N', 'X', 'P', 'K' };
+        const uint32_t kVersion = 1;
+        const uint32_t kFlagCompressed = 1;
+
+        const size_t kHeaderSize = 24;
+        const size_t kEntrySize = 32;
+
+        uint32_t ReadU32(const uint8_t* p) {
+            return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+        }
+
+        uint64_t ReadU64(const uint8_t* p) {
+            return uint64_t(ReadU32(p)) | (uint64_t(ReadU32(p + 4)) << 32);
+        }
+
+        void WriteU32(std::vector<uint8_t>& out, size_t at, uint32_t value) {
+            for (int i = 0; i < 4; i++) out[at + i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+
+        void WriteU64(std::vector<uint8_t>& out, size_t at, uint64_t value) {
+            WriteU32(out, at, static_cast<uint32_t>(value));
+            WriteU32(out, at + 4, static_cast<uint32_t>(value >> 32));
+        }
+    }
+
+    // ================== AssetBundle ==================
+
+    AssetBundle::~AssetBundle() {
+        Close();
+    }
+
+    bool AssetBundle::OpenMemory(const void* data, size_t size, std::string& error) {
+        Close();
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = size;
+
+        if (!Validate(error)) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    bool AssetBundle::OpenFile(const std::string& path, std::string& error) {
+        Close();
+
+#ifdef _WIN32
+        std::wstring widePath;
+        Transcoder::AppendUtf16(path, widePath);
+
+        HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            error = "Cannot open asset bundle: " + path;
+            return false;
+        }
+
+        LARGE_INTEGER fileSize = {};
+        GetFileSizeEx(file, &fileSize);
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            error = "Cannot map asset bundle: " + path;
+            return false;
+        }
+
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<const uint8_t*>(view);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            error = "Cannot open asset bundle: " + path;
+            return false;
+        }
+
+        std::streamoff size = file.tellg();
+        m_ownedData.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        file.seekg(0);
+        if (!m_ownedData.empty() && !file.read(reinterpret_cast<char*>(m_ownedData.data()), size)) {
+            error = "Cannot read asset bundle: " + path;
+            return false;
+        }
+
+        m_data = m_ownedData.data();
+        m_size = m_ownedData.size();
+#endif
+
+        if (!Validate(error)) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void AssetBundle::Close() {
+#ifdef _WIN32
+        if (m_mapping) {
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+        }
+        if (m_file) {
+            CloseHandle(m_file);
+        }
+#endif
+        m_file = nullptr;
+        m_mapping = nullptr;
+        m_data = nullptr;
+        m_size = 0;
+        m_entryCount = 0;
+        m_ownedData.clear();
+    }
+
+    bool AssetBundle::Validate(std::string& error) {
+        if (!m_data || m_size < kHeaderSize || memcmp(m_data, kMagic, sizeof(kMagic)) != 0) {
+            error = "Not an asset bundle";
+            return false;
+        }
+
+        if (ReadU32(m_data + 4) != kVersion) {
+            error = "Unsupported asset bundle version " + std::to_string(ReadU32(m_data + 4));
+            return false;
+        }
+
+        uint64_t entryCount = ReadU32(m_data + 8);
+        uint64_t stringsOffset = ReadU32(m_data + 12);
+        uint64_t dataOffset = ReadU32(m_data + 16);
+
+        if (kHeaderSize + entryCount * kEntrySize > stringsOffset || stringsOffset > dataOffset || dataOffset > m_size) {
+            error = "Corrupt asset bundle header";
+            return false;
+        }
+
+        // Check every entry once so lookups can trust the index
+        std::string_view previous;
+        for (uint64_t i = 0; i < entryCount; i++) {
+            const uint8_t* entry = m_data + kHeaderSize + i * kEntrySize;
+            uint64_t pathOffset = ReadU32(entry);
+            uint64_t pathLength = ReadU32(entry + 4);
+            uint64_t blobOffset = ReadU32(entry + 8);
+            uint64_t storedSize = ReadU32(entry + 12);
+
+            if (stringsOffset + pathOffset + pathLength > dataOffset || dataOffset + blobOffset + storedSize > m_size) {
+                error = "Corrupt asset bundle entry " + std::to_string(i);
+                return false;
+            }
+
+            std::string_view path(reinterpret_cast<const char*>(m_data + stringsOffset + pathOffset), pathLength);
+            if (i > 0 && !(previous < path)) {
+                error = "Asset bundle index is not sorted";
+                return false;
+            }
+            previous = path;
+        }
+
+        m_entryCount = static_cast<uint32_t>(entryCount);
+        return true;
+    }
+
+    AssetBundleEntry AssetBundle::GetEntry(size_t index) const {
+        const uint8_t* entry = m_data + kHeaderSize + index * kEntrySize;
+        uint32_t stringsOffset = ReadU32(m_data + 12);
+        uint32_t dataOffset = ReadU32(m_data + 16);
+
+        AssetBundleEntry result;
+        result.path = std::string_view(reinterpret_cast<const char*>(m_data + stringsOffset + ReadU32(entry)), ReadU32(entry + 4));
+        result.data = m_data + dataOffset + ReadU32(entry + 8);
+        result.storedSize = ReadU32(entry + 12);
+        result.size = ReadU32(entry + 16);
+        result.compressed = (ReadU32(entry + 20) & kFlagCompressed) != 0;
+        result.hash = ReadU64(entry + 24);
+        return result;
+    }
+
+    bool AssetBundle::Find(std::string_view path, AssetBundleEntry& entry) const {
+        size_t lo = 0;
+        size_t hi = m_entryCount;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            AssetBundleEntry candidate = GetEntry(mid);
+            int order = candidate.path.compare(path);
+            if (order == 0) {
+                entry = candidate;
+                return true;
+            }
+            if (order < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return false;
+    }
+
+    bool AssetBundle::Read(const AssetBundleEntry& entry, std::string& out) const {
+        if (!entry.compressed) {
+            out.assign(reinterpret_cast<const char*>(entry.data), entry.storedSize);
+            return true;
+        }
+
+        out.resize(entry.size);
+        uLongf length = entry.size;
+        if (uncompress(reinterpret_cast<Bytef*>(&out[0]), &length, entry.data, entry.storedSize) != Z_OK ||
+            length != entry.size) {
+            out.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // ================== AssetBundleWriter ==================
+
+    void AssetBundleWriter::Add(const std::string& path, const std::string& contents) {
+        for (auto& file : m_files) {
+            if (file.first == path) {
+                file.second = contents;
+                return;
+            }
+        }
+        m_files.emplace_back(path, contents);
+    }
+
+    bool AssetBundleWriter::Write(std::vector<uint8_t>& out, std::string& error, size_t minCompressSize) const {
+        std::vector<const std::pair<std::string, std::string>*> files;
+        for (const auto& file : m_files) files.push_back(&file);
+        std::sort(files.begin(), files.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+        size_t stringsSize = 0;
+        for (const auto* file : files) stringsSize += file->first.size();
+
+        size_t stringsOffset = kHeaderSize + files.size() * kEntrySize;
+        size_t dataOffset = stringsOffset + stringsSize;
+
+        out.assign(dataOffset, 0);
+        memcpy(out.data(), kMagic, sizeof(kMagic));
+        WriteU32(out, 4, kVersion);
+        WriteU32(out, 8, static_cast<uint32_t>(files.size()));
+        WriteU32(out, 12, static_cast<uint32_t>(stringsOffset));
+        WriteU32(out, 16, static_cast<uint32_t>(dataOffset));
+
+        size_t pathOffset = 0;
+        std::vector<uint8_t> compressed;
+        for (size_t i = 0; i < files.size(); i++) {
+            const std::string& path = files[i]->first;
+            const std::string& contents = files[i]->second;
+
+            // Compress where it pays off
+            const uint8_t* blob = reinterpret_cast<const uint8_t*>(contents.data());
+            size_t blobSize = contents.size();
+            uint32_t flags = 0;
+
+            if (contents.size() >= minCompressSize) {
+                uLongf length = compressBound(static_cast<uLong>(contents.size()));
+                compressed.resize(length);
+                if (compress2(compressed.data(), &length, blob, static_cast<uLong>(contents.size()), Z_BEST_COMPRESSION) == Z_OK &&
+                    length < contents.size()) {
+                    blob = compressed.data();
+                    blobSize = length;
+                    flags |= kFlagCompressed;
+                }
+            }
+
+            size_t blobOffset = out.size() - dataOffset;
+            if (out.size() + blobSize > UINT32_MAX) {
+                error = "Asset bundle exceeds 4 GB";
+                return false;
+            }
+
+            size_t entry = kHeaderSize + i * kEntrySize;
+            WriteU32(out, entry, static_cast<uint32_t>(pathOffset));
+            WriteU32(out, entry + 4, static_cast<uint32_t>(path.size()));
+            WriteU32(out, entry + 8, static_cast<uint32_t>(blobOffset));
+            WriteU32(out, entry + 12, static_cast<uint32_t>(blobSize));
+            WriteU32(out, entry + 16, static_cast<uint32_t>(contents.size()));
+            WriteU32(out, entry + 20, flags);
+            WriteU64(out, entry + 24, AssetCache::HashContent(contents));
+
+            memcpy(out.data() + stringsOffset + pathOffset, path.data(), path.size());
+            pathOffset += path.size();
+
+            out.insert(out.end(), blob, blob + blobSize);
+        }
+
+        return true;
+    }
+
+} // namespace Nexile
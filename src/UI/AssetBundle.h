@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Entry of a packed asset bundle
+    struct AssetBundleEntry {
+        std::string_view path;      // Cache key (see AssetCache::NormalizePath)
+        const uint8_t* data;        // Stored bytes inside the bundle
+        uint32_t storedSize;
+        uint32_t size;              // Size after decompression
+        uint64_t hash;              // FNV-1a of the uncompressed bytes
+        bool compressed;            // Stored as a zlib stream
+    };
+
+    // Read-only view of an NXPK asset bundle.
+    //
+    // Layout (little endian):
+    //   header   "NXPK", version, entry count, string table offset, data offset
+    //   index    entryCount x { path offset, path length, data offset,
+    //                           stored size, size, flags, hash (u64) }
+    //   strings  paths, not terminated
+    //   data     blobs, zlib-compressed where that made them smaller
+    //
+    // The index is sorted by path so lookups are a binary search over the
+    // mapped bytes. The bundle is normally linked into the executable as a
+    // resource (see OpenMemory) so serving a page needs no file system call at
+    // all; OpenFile maps a bundle on disk instead.
+    class AssetBundle {
+    public:
+        AssetBundle() = default;
+        ~AssetBundle();
+
+        AssetBundle(const AssetBundle&) = delete;
+        AssetBundle& operator=(const AssetBundle&) = delete;
+
+        // Use bundle bytes that outlive this object (e.g. an executable resource)
+        bool OpenMemory(const void* data, size_t size, std::string& error);
+
+        // Map a bundle file
+        bool OpenFile(const std::string& path, std::string& error);
+
+        void Close();
+        bool IsOpen() const { return m_data != nullptr; }
+
+        // Look up an entry by cache key
+        bool Find(std::string_view path, AssetBundleEntry& entry) const;
+
+        // Decompress (or copy) an entry's contents
+        bool Read(const AssetBundleEntry& entry, std::string& out) const;
+
+        size_t GetEntryCount() const { return m_entryCount; }
+        AssetBundleEntry GetEntry(size_t index) const;
+
+    private:
+        // Validate the header and every index entry; callers Close() on failure
+        bool Validate(std::string& error);
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        uint32_t m_entryCount = 0;
+
+        // Bundles read from disk on platforms without mapping
+        std::vector<uint8_t> m_ownedData;
+
+        // File mapping handles (Windows)
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+    };
+
+    // Builds an NXPK bundle
+    class AssetBundleWriter {
+    public:
+        // Add a file under a cache key; later additions of the same key win
+        void Add(const std::string& path, const std::string& contents);
+
+        // Serialise the bundle; entries smaller than minCompressSize are stored as-is
+        bool Write(std::vector<uint8_t>& out, std::string& error, size_t minCompressSize = 256) const;
+
+        size_t GetEntryCount() const { return m_files.size(); }
+
+    private:
+        std::vector<std::pair<std::string, std::string>> m_files;
+    };
+
+} // namespace Nexile
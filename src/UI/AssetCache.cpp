@@ -0,0 +1,440 @@
+#include "AssetCache.h"
+#include "AssetBundle.h"
+
+#include <fstream>
+#include <chrono>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace Nexile {
+
+    namespace {
+        struct MimeMapping {
+            const char* extension;
+            const char* mimeType;
+        };
+
+        const MimeMapping kMimeTypes[] = {
+            { ".html", "text/html" },
+            { ".htm", "text/html" },
+            { ".css", "text/css" },
+            { ".js", "application/javascript" },
+            { ".mjs", "application/javascript" },
+            { ".json", "application/json" },
+            { ".svg", "image/svg+xml" },
+            { ".png", "image/png" },
+            { ".jpg", "image/jpeg" },
+            { ".jpeg", "image/jpeg" },
+            { ".gif", "image/gif" },
+            { ".webp", "image/webp" },
+            { ".ico", "image/x-icon" },
+            { ".woff", "font/woff" },
+            { ".woff2", "font/woff2" },
+            { ".ttf", "font/ttf" },
+            { ".txt", "text/plain" },
+        };
+
+        // Interval between checks when no change notification is available
+        const auto kWatchInterval = std::chrono::milliseconds(500);
+
+        std::string FormatETag(uint64_t hash) {
+            static const char digits[] = "0123456789abcdef";
+            std::string etag = "\"";
+            for (int shift = 60; shift >= 0; shift -= 4) {
+                etag += digits[(hash >> shift) & 0xF];
+            }
+            etag += "\"";
+            return etag;
+        }
+
+        bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); i++) {
+                char x = (a[i] >= 'A' && a[i] <= 'Z') ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+                if (x != b[i]) return false;
+            }
+            return true;
+        }
+    }
+
+    AssetCache::AssetCache(const std::string& rootDirectory)
+        : m_root(fs::u8path(rootDirectory)), m_hits(0), m_misses(0), m_stopWatching(false) {
+    }
+
+    AssetCache::~AssetCache() {
+        StopWatching();
+    }
+
+    void AssetCache::SetBundle(std::shared_ptr<const AssetBundle> bundle) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_bundle = std::move(bundle);
+        m_assets.clear();
+    }
+
+    AssetPtr AssetCache::Get(std::string_view urlPath) {
+        std::string key;
+        if (!NormalizePath(urlPath, key)) {
+            return nullptr;
+        }
+
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            auto it = m_virtual.find(key);
+            if (it != m_virtual.end()) {
+                m_hits++;
+                return it->second;
+            }
+            it = m_assets.find(key);
+            if (it != m_assets.end()) {
+                m_hits++;
+                return it->second;
+            }
+        }
+
+        // Read outside the lock; a racing reader of the same file just loads it twice
+        m_misses++;
+        AssetPtr asset = LoadAsset(key);
+        if (!asset) {
+            return nullptr;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto result = m_assets.emplace(key, asset);
+        return result.first->second;
+    }
+
+    AssetPtr AssetCache::RegisterVirtual(std::string_view urlPath, std::string contents) {
+        std::string key;
+        if (!NormalizePath(urlPath, key)) {
+            return nullptr;
+        }
+
+        uint64_t hash = HashContent(contents);
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            auto it = m_virtual.find(key);
+            if (it != m_virtual.end() && it->second->hash == hash && it->second->size == contents.size()) {
+                return it->second;
+            }
+        }
+
+        auto asset = std::make_shared<CachedAsset>();
+        asset->path = key;
+        asset->size = contents.size();
+        asset->data = std::move(contents);
+        asset->mimeType = GetMimeType(key);
+        asset->hash = hash;
+        asset->etag = FormatETag(hash);
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_virtual[key] = asset;
+        return asset;
+    }
+
+    void AssetCache::UnregisterVirtual(std::string_view urlPath) {
+        std::string key;
+        if (!NormalizePath(urlPath, key)) return;
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_virtual.erase(key);
+    }
+
+    size_t AssetCache::Preload() {
+        std::vector<std::string> keys;
+
+        if (m_bundle) {
+            for (size_t i = 0; i < m_bundle->GetEntryCount(); i++) {
+                keys.emplace_back(m_bundle->GetEntry(i).path);
+            }
+        }
+
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(m_root, ec), end; !m_bundle && !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file(ec)) continue;
+
+            std::string key;
+            if (NormalizePath(it->path().lexically_relative(m_root).generic_u8string(), key)) {
+                keys.push_back(key);
+            }
+        }
+
+        size_t loaded = 0;
+        for (const std::string& key : keys) {
+            AssetPtr asset = LoadAsset(key);
+            if (!asset) continue;
+
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            m_assets[key] = asset;
+            loaded++;
+        }
+
+        return loaded;
+    }
+
+    void AssetCache::Invalidate(std::string_view urlPath) {
+        std::string key;
+        if (!NormalizePath(urlPath, key)) return;
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_assets.erase(key);
+    }
+
+    void AssetCache::Clear() {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_assets.clear();
+    }
+
+    size_t AssetCache::GetEntryCount() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_assets.size();
+    }
+
+    void AssetCache::StartWatching() {
+        if (m_watcher.joinable()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_watchMutex);
+            m_stopWatching = false;
+        }
+        m_watcher = std::thread(&AssetCache::WatchLoop, this);
+    }
+
+    void AssetCache::StopWatching() {
+        if (!m_watcher.joinable()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_watchMutex);
+            m_stopWatching = true;
+        }
+        m_watchCondition.notify_all();
+        m_watcher.join();
+    }
+
+    AssetPtr AssetCache::LoadAsset(const std::string& key) const {
+        if (m_bundle) {
+            return LoadBundledAsset(key);
+        }
+
+        fs::path path;
+        if (!ResolveFile(key, path)) {
+            return nullptr;
+        }
+
+        std::error_code ec;
+        auto modified = fs::last_write_time(path, ec);
+        if (ec) return nullptr;
+
+        uint64_t size = fs::file_size(path, ec);
+        if (ec) return nullptr;
+
+        auto asset = std::make_shared<CachedAsset>();
+        asset->path = key;
+        asset->size = size;
+        asset->mimeType = GetMimeType(key);
+        asset->modified = modified;
+
+        if (size > kMaxCachedFileSize) {
+            // Large files stay on disk; identify the version by size and write time
+            uint64_t version[2] = { size, static_cast<uint64_t>(modified.time_since_epoch().count()) };
+            asset->streamPath = path;
+            asset->hash = HashContent(std::string_view(reinterpret_cast<const char*>(version), sizeof(version)));
+            asset->etag = FormatETag(asset->hash);
+            return asset;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return nullptr;
+
+        asset->data.resize(static_cast<size_t>(size));
+        if (size > 0 && !file.read(&asset->data[0], static_cast<std::streamsize>(size))) {
+            return nullptr;
+        }
+
+        asset->hash = HashContent(asset->data);
+        asset->etag = FormatETag(asset->hash);
+        return asset;
+    }
+
+    bool AssetCache::ResolveFile(const std::string& key, fs::path& path) const {
+        path = (m_root / fs::u8path(key)).lexically_normal();
+
+        // Keys are normalised already; this keeps a key that slipped past from leaving the root
+        fs::path relative = path.lexically_relative(m_root.lexically_normal());
+        return !relative.empty() && !relative.is_absolute() && *relative.begin() != "..";
+    }
+
+    AssetPtr AssetCache::LoadBundledAsset(const std::string& key) const {
+        AssetBundleEntry entry;
+        if (!m_bundle->Find(key, entry)) {
+            return nullptr;
+        }
+
+        auto asset = std::make_shared<CachedAsset>();
+        if (entry.compressed) {
+            if (!m_bundle->Read(entry, asset->data)) {
+                return nullptr;
+            }
+        } else {
+            // Stored entries are served straight from the bundle
+            asset->external = reinterpret_cast<const char*>(entry.data);
+            asset->owner = m_bundle;
+        }
+
+        // The packer hashed the contents already
+        asset->path = key;
+        asset->size = entry.size;
+        asset->mimeType = GetMimeType(key);
+        asset->hash = entry.hash;
+        asset->etag = FormatETag(asset->hash);
+        return asset;
+    }
+
+    void AssetCache::Revalidate() {
+        if (m_bundle) return;
+
+        std::vector<std::pair<std::string, fs::file_time_type>> entries;
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            entries.reserve(m_assets.size());
+            for (const auto& [key, asset] : m_assets) {
+                entries.emplace_back(key, asset->modified);
+            }
+        }
+
+        for (const auto& [key, modified] : entries) {
+            fs::path path;
+            std::error_code ec;
+            if (!ResolveFile(key, path) || fs::last_write_time(path, ec) != modified || ec) {
+                std::unique_lock<std::shared_mutex> lock(m_mutex);
+                auto it = m_assets.find(key);
+                if (it != m_assets.end() && it->second->modified == modified) {
+                    m_assets.erase(it);
+                }
+            }
+        }
+    }
+
+    void AssetCache::WatchLoop() {
+#ifdef _WIN32
+        HANDLE change = FindFirstChangeNotificationW(m_root.wstring().c_str(), TRUE,
+            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+#endif
+
+        std::unique_lock<std::mutex> lock(m_watchMutex);
+        while (!m_stopWatching) {
+#ifdef _WIN32
+            if (change != INVALID_HANDLE_VALUE) {
+                // Wait for the directory to change, waking up regularly to check for shutdown
+                lock.unlock();
+                DWORD result = WaitForSingleObject(change, static_cast<DWORD>(kWatchInterval.count()));
+                if (result == WAIT_OBJECT_0) {
+                    Revalidate();
+                    FindNextChangeNotification(change);
+                }
+                lock.lock();
+                continue;
+            }
+#endif
+            // No notification handle: poll write times
+            if (m_watchCondition.wait_for(lock, kWatchInterval, [this]() { return m_stopWatching; })) {
+                break;
+            }
+            lock.unlock();
+            Revalidate();
+            lock.lock();
+        }
+
+#ifdef _WIN32
+        if (change != INVALID_HANDLE_VALUE) {
+            FindCloseChangeNotification(change);
+        }
+#endif
+    }
+
+    AssetPtr AssetCache::GetNotFound() {
+        static const AssetPtr notFound = []() {
+            auto asset = std::make_shared<CachedAsset>();
+            asset->data = "<html><body><h1>404 Not Found</h1></body></html>";
+            asset->size = asset->data.size();
+            asset->mimeType = "text/html";
+            asset->hash = HashContent(asset->data);
+            return asset;
+        }();
+        return notFound;
+    }
+
+    const char* AssetCache::GetMimeType(std::string_view path) {
+        size_t dot = path.find_last_of('.');
+        if (dot != std::string_view::npos) {
+            std::string_view extension = path.substr(dot);
+            for (const MimeMapping& mapping : kMimeTypes) {
+                if (EqualsIgnoreCase(extension, mapping.extension)) {
+                    return mapping.mimeType;
+                }
+            }
+        }
+        return "application/octet-stream";
+    }
+
+    uint64_t AssetCache::HashContent(std::string_view data) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool AssetCache::NormalizePath(std::string_view urlPath, std::string& key) {
+        // Drop query and fragment
+        size_t end = urlPath.find_first_of("?#");
+        if (end != std::string_view::npos) {
+            urlPath = urlPath.substr(0, end);
+        }
+
+        key.clear();
+        key.reserve(urlPath.size());
+
+        size_t segmentStart = 0;
+        for (size_t i = 0; i <= urlPath.size(); i++) {
+            char c = i < urlPath.size() ? urlPath[i] : '/';
+            if (c == '\\') c = '/';
+
+            if (c == '/') {
+                std::string_view segment(key.data() + segmentStart, key.size() - segmentStart);
+                // ':' would name a drive or an alternate data stream on Windows
+                if (segment == ".." || segment.find(':') != std::string_view::npos) {
+                    return false;
+                }
+                if (segment.empty() || segment == ".") {
+                    // Collapse empty and current-directory segments
+                    key.resize(segmentStart);
+                    continue;
+                }
+                key += '/';
+                segmentStart = key.size();
+                continue;
+            }
+
+            // The HTML directory lives on a case-insensitive file system
+            key += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        if (!key.empty() && key.back() == '/') {
+            key.pop_back();
+        }
+
+        // A rooted key would replace the root when joined to it
+        fs::path path = fs::u8path(key);
+        if (path.has_root_name() || path.has_root_directory()) {
+            return false;
+        }
+        return !key.empty();
+    }
+
+} // namespace Nexile
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <cstdint>
+
+namespace Nexile {
+
+    class AssetBundle;
+
+    // Immutable file served by the nexile:// scheme.
+    //
+    // Contents live in one of three places: the data string (files read from
+    // disk, compressed bundle entries), memory owned by someone else (stored
+    // bundle entries, used in place) or, for large files, on disk where
+    // responses stream them from in chunks.
+    struct CachedAsset {
+        std::string path;           // Cache key (relative, lower case, '/' separated)
+        std::string data;           // Contents held by the asset
+        const char* external = nullptr;         // Contents held by `owner`
+        std::shared_ptr<const void> owner;      // Keeps `external` alive (the bundle)
+        std::filesystem::path streamPath;       // Set for assets streamed from disk
+        uint64_t size = 0;
+        std::string mimeType;
+        uint64_t hash = 0;          // FNV-1a of the contents (of size and write time when streamed)
+        std::string etag;           // Quoted hex hash, usable as an HTTP ETag
+        std::filesystem::file_time_type modified;
+
+        // In-memory contents; empty for streamed assets
+        std::string_view GetBytes() const {
+            return external ? std::string_view(external, static_cast<size_t>(size)) : std::string_view(data);
+        }
+
+        bool IsStreamed() const { return !streamPath.empty(); }
+    };
+
+    using AssetPtr = std::shared_ptr<const CachedAsset>;
+
+    // In-memory cache of the overlay's HTML directory.
+    //
+    // Files are read once, in binary, on first access (or up front through
+    // Preload) and handed out as shared immutable buffers, so serving a page
+    // never touches the disk and never copies the file; entries that are
+    // invalidated while a response is streaming stay alive until it finishes.
+    // With watching enabled (dev builds) a background thread evicts entries
+    // whose file changed, so edited HTML shows up on the next navigation.
+    //
+    // When a packed bundle is attached, assets come from the bundle only and
+    // the directory is never consulted.
+    //
+    // Generated documents (module UIs) can be registered under a path of their
+    // own. They are served ahead of the bundle and the directory and are not
+    // affected by Clear or the watcher.
+    class AssetCache {
+    public:
+        explicit AssetCache(const std::string& rootDirectory);
+        ~AssetCache();
+
+        AssetCache(const AssetCache&) = delete;
+        AssetCache& operator=(const AssetCache&) = delete;
+
+        // Serve from a packed bundle instead of the directory
+        void SetBundle(std::shared_ptr<const AssetBundle> bundle);
+
+        // Look up an asset by URL path ("main_overlay.html", "css/a.css?v=2");
+        // nullptr if the file does not exist or the path leaves the root
+        AssetPtr Get(std::string_view urlPath);
+
+        // Serve `contents` at urlPath until unregistered. Registering the same
+        // contents again keeps the current asset; its hash identifies the version.
+        // nullptr if the path leaves the root.
+        AssetPtr RegisterVirtual(std::string_view urlPath, std::string contents);
+        void UnregisterVirtual(std::string_view urlPath);
+
+        // Load every file under the root; returns the number of cached files
+        size_t Preload();
+
+        // Drop one entry or everything
+        void Invalidate(std::string_view urlPath);
+        void Clear();
+
+        // Evict entries whose file changed on disk
+        void StartWatching();
+        void StopWatching();
+
+        // Statistics
+        size_t GetEntryCount() const;
+        size_t GetHitCount() const { return m_hits; }
+        size_t GetMissCount() const { return m_misses; }
+
+        // Response used for unknown paths
+        static AssetPtr GetNotFound();
+
+        // MIME type from the file extension
+        static const char* GetMimeType(std::string_view path);
+
+        // 64-bit FNV-1a
+        static uint64_t HashContent(std::string_view data);
+
+        // Files larger than this are streamed from disk instead of cached
+        static constexpr uint64_t kMaxCachedFileSize = 1024 * 1024;
+
+        // Turn a URL path into a cache key; false for paths outside the root
+        static bool NormalizePath(std::string_view urlPath, std::string& key);
+
+    private:
+        // Read a file from the bundle or disk (no locking)
+        AssetPtr LoadAsset(const std::string& key) const;
+        AssetPtr LoadBundledAsset(const std::string& key) const;
+
+        // Path of a key's file under the root; false if it would leave the root
+        bool ResolveFile(const std::string& key, std::filesystem::path& path) const;
+
+        // Drop entries whose file is missing or has a new write time
+        void Revalidate();
+
+        // Watcher thread body
+        void WatchLoop();
+
+    private:
+        std::filesystem::path m_root;
+        std::shared_ptr<const AssetBundle> m_bundle;
+
+        mutable std::shared_mutex m_mutex;
+        std::unordered_map<std::string, AssetPtr> m_assets;
+        std::unordered_map<std::string, AssetPtr> m_virtual;
+
+        std::atomic<size_t> m_hits;
+        std::atomic<size_t> m_misses;
+
+        // Watcher
+        std::thread m_watcher;
+        std::mutex m_watchMutex;
+        std::condition_variable m_watchCondition;
+        bool m_stopWatching;
+    };
+
+} // namespace Nexile
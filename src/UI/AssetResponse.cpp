@@ -0,0 +1,162 @@
+#include "AssetResponse.h"
+
+#include <cstring>
+
+namespace Nexile {
+
+    namespace {
+        bool ParseNumber(std::string_view text, uint64_t& value) {
+            if (text.empty() || text.size() > 19) return false;
+
+            value = 0;
+            for (char c : text) {
+                if (c < '0' || c > '9') return false;
+                value = value * 10 + static_cast<uint64_t>(c - '0');
+            }
+            return true;
+        }
+
+        std::string_view Trim(std::string_view text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+            return text;
+        }
+
+        // If-None-Match holds a list of (possibly weak) tags or "*"
+        bool MatchesETag(std::string_view header, const std::string& etag) {
+            while (!header.empty()) {
+                size_t comma = header.find(',');
+                std::string_view tag = Trim(header.substr(0, comma));
+                if (tag.size() > 2 && tag.compare(0, 2, "W/") == 0) tag.remove_prefix(2);
+                if (tag == "*" || tag == etag) return true;
+                if (comma == std::string_view::npos) break;
+                header.remove_prefix(comma + 1);
+            }
+            return false;
+        }
+    }
+
+    void AssetResponse::Begin(AssetPtr asset, std::string_view rangeHeader, std::string_view ifNoneMatch) {
+        Cancel();
+        m_asset = std::move(asset);
+        m_status = 200;
+        m_offset = 0;
+        m_end = m_asset ? m_asset->size : 0;
+        m_contentRange.clear();
+
+        if (!m_asset) {
+            m_status = 404;
+            return;
+        }
+
+        if (!ifNoneMatch.empty() && !m_asset->etag.empty() && MatchesETag(ifNoneMatch, m_asset->etag)) {
+            m_status = 304;
+            m_end = 0;
+            return;
+        }
+
+        // Malformed or multi-range headers are ignored and the whole asset is sent
+        uint64_t first = 0, last = 0;
+        bool satisfiable = true;
+        if (!rangeHeader.empty() && ParseRange(rangeHeader, m_asset->size, first, last, satisfiable)) {
+            if (!satisfiable) {
+                m_status = 416;
+                m_end = 0;
+                m_contentRange = "bytes */" + std::to_string(m_asset->size);
+                return;
+            }
+
+            m_status = 206;
+            m_offset = first;
+            m_end = last + 1;
+            m_contentRange = "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(m_asset->size);
+        }
+
+        if (m_asset->IsStreamed() && m_offset < m_end) {
+            m_stream.open(m_asset->streamPath, std::ios::binary);
+            if (!m_stream.is_open() || !m_stream.seekg(static_cast<std::streamoff>(m_offset))) {
+                m_stream.close();
+                m_status = 404;
+                m_offset = m_end = 0;
+            }
+        }
+    }
+
+    size_t AssetResponse::Read(void* out, size_t capacity) {
+        if (!m_asset || m_offset >= m_end || capacity == 0) {
+            return 0;
+        }
+
+        size_t count = static_cast<size_t>(m_end - m_offset < capacity ? m_end - m_offset : capacity);
+
+        if (m_asset->IsStreamed()) {
+            m_stream.read(static_cast<char*>(out), static_cast<std::streamsize>(count));
+            count = static_cast<size_t>(m_stream.gcount());
+            if (count == 0) {
+                // File shrank underneath us; end the body early
+                m_end = m_offset;
+                return 0;
+            }
+        } else {
+            memcpy(out, m_asset->GetBytes().data() + m_offset, count);
+        }
+
+        m_offset += count;
+        return count;
+    }
+
+    void AssetResponse::Cancel() {
+        if (m_stream.is_open()) {
+            m_stream.close();
+        }
+        m_stream.clear();
+        m_asset.reset();
+        m_offset = m_end = 0;
+    }
+
+    bool AssetResponse::ParseRange(std::string_view header, uint64_t size, uint64_t& first, uint64_t& last,
+                                   bool& satisfiable) {
+        header = Trim(header);
+        if (header.compare(0, 6, "bytes=") != 0) return false;
+        header.remove_prefix(6);
+        if (header.find(',') != std::string_view::npos) return false;
+
+        size_t dash = header.find('-');
+        if (dash == std::string_view::npos) return false;
+
+        std::string_view from = Trim(header.substr(0, dash));
+        std::string_view to = Trim(header.substr(dash + 1));
+        satisfiable = true;
+
+        if (from.empty()) {
+            // Suffix range: the last N bytes
+            uint64_t suffix;
+            if (!ParseNumber(to, suffix)) return false;
+            if (suffix == 0 || size == 0) {
+                satisfiable = false;
+                return true;
+            }
+            first = suffix >= size ? 0 : size - suffix;
+            last = size - 1;
+            return true;
+        }
+
+        if (!ParseNumber(from, first)) return false;
+
+        if (to.empty()) {
+            last = size ? size - 1 : 0;
+        } else if (!ParseNumber(to, last) || last < first) {
+            return false;
+        }
+
+        if (first >= size) {
+            satisfiable = false;
+            return true;
+        }
+        if (last >= size) {
+            last = size - 1;
+        }
+        return true;
+    }
+
+} // namespace Nexile
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "AssetCache.h"
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Response state of a single nexile:// request.
+    //
+    // Each resource handler owns one, so concurrent requests never share an
+    // offset or a buffer. Begin() works out the status from the conditional
+    // and range headers; Read() then copies the selected bytes out in chunks,
+    // straight from the cached buffer or, for streamed assets, from the file.
+    class AssetResponse {
+    public:
+        AssetResponse() = default;
+
+        // Prepare a response; rangeHeader and ifNoneMatch may be empty
+        void Begin(AssetPtr asset, std::string_view rangeHeader, std::string_view ifNoneMatch);
+
+        // Copy up to capacity bytes; returns 0 once the body is complete
+        size_t Read(void* out, size_t capacity);
+
+        // Drop the asset and close any open file
+        void Cancel();
+
+        int GetStatus() const { return m_status; }
+        uint64_t GetContentLength() const { return m_end - m_offset; }
+        const std::string& GetContentRange() const { return m_contentRange; }
+        const AssetPtr& GetAsset() const { return m_asset; }
+        bool IsComplete() const { return m_offset >= m_end; }
+
+        // Parse a single "bytes=first-last" range (suffix and open ranges allowed).
+        // Returns false when the header is not a single byte range; sets
+        // satisfiable to false when it is one but lies outside the asset.
+        static bool ParseRange(std::string_view header, uint64_t size, uint64_t& first, uint64_t& last,
+                               bool& satisfiable);
+
+    private:
+        AssetPtr m_asset;
+        uint64_t m_offset = 0;      // Next byte to send
+        uint64_t m_end = 0;         // One past the last byte to send
+        int m_status = 200;
+        std::string m_contentRange;
+
+        // Open while streaming from disk
+        std::ifstream m_stream;
+    };
+
+} // namespace Nexile
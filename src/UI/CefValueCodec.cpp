@@ -0,0 +1,425 @@
+#include "CefValueCodec.h"
+#include "Utils/Transcoder.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        std::string ToUtf8(const cef_string_t* str) {
+            return CefValueCodec::ToStdString(str);
+        }
+
+        void SetUtf8(const std::string& value, cef_string_t* str) {
+            CefValueCodec::SetString(value, str);
+        }
+
+        // Destructor for strings SetString allocates
+        void FreeUtf16(char16* buffer) {
+            delete[] buffer;
+        }
+
+        template <typename T>
+        void Release(T* object) {
+            if (object) object->base.release(&object->base);
+        }
+
+        // ArrayBuffers handed to V8 are malloc'd copies freed by this callback.
+        // It is a process-wide singleton, so its reference count is a no-op.
+        void CEF_CALLBACK NoopAddRef(cef_base_ref_counted_t*) {}
+        int CEF_CALLBACK NoopRelease(cef_base_ref_counted_t*) { return 0; }
+        int CEF_CALLBACK AlwaysOneRef(cef_base_ref_counted_t*) { return 1; }
+
+        void CEF_CALLBACK FreeArrayBuffer(cef_v8array_buffer_release_callback_t*, void* buffer) {
+            std::free(buffer);
+        }
+
+        cef_v8array_buffer_release_callback_t* GetArrayBufferRelease() {
+            static cef_v8array_buffer_release_callback_t callback = []() {
+                cef_v8array_buffer_release_callback_t cb;
+                std::memset(&cb, 0, sizeof(cb));
+                cb.base.size = sizeof(cb);
+                cb.base.add_ref = NoopAddRef;
+                cb.base.release = NoopRelease;
+                cb.base.has_one_ref = AlwaysOneRef;
+                cb.release_buffer = FreeArrayBuffer;
+                return cb;
+            }();
+            return &callback;
+        }
+    }
+
+    std::string CefValueCodec::ToStdString(const cef_string_t* str) {
+        std::string result;
+        if (str && str->str) {
+            Transcoder::AppendUtf8(str->str, str->length, result);
+        }
+        return result;
+    }
+
+    void CefValueCodec::SetString(const std::string& value, cef_string_t* str) {
+        cef_string_clear(str);
+        if (value.empty()) return;
+
+        // Convert straight into the buffer the string will own. The predicted
+        // length is exact unless the input is invalid, in which case the
+        // replacing conversion gets its worst-case buffer instead.
+        size_t length = Transcoder::Utf16LengthOfUtf8(value.data(), value.size());
+        char16* buffer = new char16[length];
+        if (!Transcoder::Utf8ToUtf16(value.data(), value.size(), reinterpret_cast<char16_t*>(buffer)).Ok()) {
+            delete[] buffer;
+            buffer = new char16[Transcoder::MaxUtf16LengthOfUtf8(value.size())];
+            length = Transcoder::Utf8ToUtf16Replacing(value.data(), value.size(), reinterpret_cast<char16_t*>(buffer));
+        }
+
+        str->str = buffer;
+        str->length = length;
+        str->dtor = FreeUtf16;
+    }
+
+    cef_value_t* CefValueCodec::ToCefValue(const json& value) {
+        return ToCefValue(value, 0);
+    }
+
+    json CefValueCodec::FromCefValue(cef_value_t* value) {
+        return FromCefValue(value, 0);
+    }
+
+    cef_value_t* CefValueCodec::FromV8(cef_v8value_t* value) {
+        return FromV8(value, 0);
+    }
+
+    cef_v8value_t* CefValueCodec::ToV8(cef_value_t* value) {
+        return ToV8(value, 0);
+    }
+
+    cef_value_t* CefValueCodec::ToCefValue(const json& value, int depth) {
+        cef_value_t* result = cef_value_create();
+
+        if (depth > kMaxDepth) {
+            result->set_null(result);
+            return result;
+        }
+
+        switch (value.type()) {
+        case json::value_t::boolean:
+            result->set_bool(result, value.get<bool>() ? 1 : 0);
+            break;
+
+        case json::value_t::number_integer: {
+            int64_t number = value.get<int64_t>();
+            if (number >= std::numeric_limits<int32_t>::min() && number <= std::numeric_limits<int32_t>::max()) {
+                result->set_int(result, static_cast<int>(number));
+            } else {
+                result->set_double(result, static_cast<double>(number));
+            }
+            break;
+        }
+
+        case json::value_t::number_unsigned: {
+            uint64_t number = value.get<uint64_t>();
+            if (number <= static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+                result->set_int(result, static_cast<int>(number));
+            } else {
+                result->set_double(result, static_cast<double>(number));
+            }
+            break;
+        }
+
+        case json::value_t::number_float:
+            result->set_double(result, value.get<double>());
+            break;
+
+        case json::value_t::string: {
+            cef_string_t str = {};
+            SetUtf8(value.get_ref<const std::string&>(), &str);
+            result->set_string(result, &str);
+            cef_string_clear(&str);
+            break;
+        }
+
+        case json::value_t::binary: {
+            const auto& bytes = value.get_binary();
+            cef_binary_value_t* binary = bytes.empty() ? nullptr : cef_binary_value_create(bytes.data(), bytes.size());
+            if (binary) {
+                result->set_binary(result, binary);
+                Release(binary);
+            } else {
+                // CEF has no empty binary value
+                result->set_null(result);
+            }
+            break;
+        }
+
+        case json::value_t::array: {
+            cef_list_value_t* list = cef_list_value_create();
+            list->set_size(list, value.size());
+            for (size_t i = 0; i < value.size(); i++) {
+                cef_value_t* item = ToCefValue(value[i], depth + 1);
+                list->set_value(list, i, item);
+                Release(item);
+            }
+            result->set_list(result, list);
+            Release(list);
+            break;
+        }
+
+        case json::value_t::object: {
+            cef_dictionary_value_t* dictionary = cef_dictionary_value_create();
+            for (auto it = value.begin(); it != value.end(); ++it) {
+                cef_string_t key = {};
+                SetUtf8(it.key(), &key);
+                cef_value_t* item = ToCefValue(it.value(), depth + 1);
+                dictionary->set_value(dictionary, &key, item);
+                Release(item);
+                cef_string_clear(&key);
+            }
+            result->set_dictionary(result, dictionary);
+            Release(dictionary);
+            break;
+        }
+
+        default:
+            result->set_null(result);
+            break;
+        }
+
+        return result;
+    }
+
+    json CefValueCodec::FromCefValue(cef_value_t* value, int depth) {
+        if (!value || depth > kMaxDepth) {
+            return nullptr;
+        }
+
+        switch (value->get_type(value)) {
+        case VTYPE_BOOL:
+            return value->get_bool(value) != 0;
+
+        case VTYPE_INT:
+            return value->get_int(value);
+
+        case VTYPE_DOUBLE:
+            return value->get_double(value);
+
+        case VTYPE_STRING: {
+            cef_string_userfree_t str = value->get_string(value);
+            std::string result = ToUtf8(str);
+            if (str) cef_string_userfree_free(str);
+            return result;
+        }
+
+        case VTYPE_BINARY: {
+            cef_binary_value_t* binary = value->get_binary(value);
+            std::vector<uint8_t> bytes(binary ? binary->get_size(binary) : 0);
+            if (!bytes.empty()) {
+                binary->get_data(binary, bytes.data(), bytes.size(), 0);
+            }
+            Release(binary);
+            return json::binary(std::move(bytes));
+        }
+
+        case VTYPE_LIST: {
+            cef_list_value_t* list = value->get_list(value);
+            json result = json::array();
+            size_t size = list ? list->get_size(list) : 0;
+            for (size_t i = 0; i < size; i++) {
+                cef_value_t* item = list->get_value(list, i);
+                result.push_back(FromCefValue(item, depth + 1));
+                Release(item);
+            }
+            Release(list);
+            return result;
+        }
+
+        case VTYPE_DICTIONARY: {
+            cef_dictionary_value_t* dictionary = value->get_dictionary(value);
+            json result = json::object();
+            if (dictionary) {
+                cef_string_list_t keys = cef_string_list_alloc();
+                dictionary->get_keys(dictionary, keys);
+                size_t count = cef_string_list_size(keys);
+                for (size_t i = 0; i < count; i++) {
+                    cef_string_t key = {};
+                    cef_string_list_value(keys, i, &key);
+                    cef_value_t* item = dictionary->get_value(dictionary, &key);
+                    result[ToUtf8(&key)] = FromCefValue(item, depth + 1);
+                    Release(item);
+                    cef_string_clear(&key);
+                }
+                cef_string_list_free(keys);
+            }
+            Release(dictionary);
+            return result;
+        }
+
+        default:
+            return nullptr;
+        }
+    }
+
+    cef_value_t* CefValueCodec::FromV8(cef_v8value_t* value, int depth) {
+        cef_value_t* result = cef_value_create();
+
+        if (!value || depth > kMaxDepth || value->is_undefined(value) || value->is_null(value) ||
+            value->is_function(value) || value->is_date(value) || value->is_array_buffer(value)) {
+            result->set_null(result);
+        }
+        else if (value->is_bool(value)) {
+            result->set_bool(result, value->get_bool_value(value));
+        }
+        else if (value->is_int(value)) {
+            result->set_int(result, value->get_int_value(value));
+        }
+        else if (value->is_uint(value)) {
+            uint32_t number = value->get_uint_value(value);
+            if (number <= static_cast<uint32_t>(std::numeric_limits<int32_t>::max())) {
+                result->set_int(result, static_cast<int>(number));
+            } else {
+                result->set_double(result, static_cast<double>(number));
+            }
+        }
+        else if (value->is_double(value)) {
+            result->set_double(result, value->get_double_value(value));
+        }
+        else if (value->is_string(value)) {
+            cef_string_userfree_t str = value->get_string_value(value);
+            if (str) {
+                result->set_string(result, str);
+                cef_string_userfree_free(str);
+            } else {
+                cef_string_t empty = {};
+                result->set_string(result, &empty);
+            }
+        }
+        else if (value->is_array(value)) {
+            cef_list_value_t* list = cef_list_value_create();
+            int length = value->get_array_length(value);
+            list->set_size(list, length > 0 ? static_cast<size_t>(length) : 0);
+            for (int i = 0; i < length; i++) {
+                cef_v8value_t* element = value->get_value_byindex(value, i);
+                cef_value_t* item = FromV8(element, depth + 1);
+                list->set_value(list, static_cast<size_t>(i), item);
+                Release(item);
+                Release(element);
+            }
+            result->set_list(result, list);
+            Release(list);
+        }
+        else if (value->is_object(value)) {
+            cef_dictionary_value_t* dictionary = cef_dictionary_value_create();
+            cef_string_list_t keys = cef_string_list_alloc();
+            value->get_keys(value, keys);
+            size_t count = cef_string_list_size(keys);
+            for (size_t i = 0; i < count; i++) {
+                cef_string_t key = {};
+                cef_string_list_value(keys, i, &key);
+                cef_v8value_t* member = value->get_value_bykey(value, &key);
+                if (member && !member->is_function(member) && !member->is_undefined(member)) {
+                    cef_value_t* item = FromV8(member, depth + 1);
+                    dictionary->set_value(dictionary, &key, item);
+                    Release(item);
+                }
+                Release(member);
+                cef_string_clear(&key);
+            }
+            cef_string_list_free(keys);
+            result->set_dictionary(result, dictionary);
+            Release(dictionary);
+        }
+        else {
+            result->set_null(result);
+        }
+
+        return result;
+    }
+
+    cef_v8value_t* CefValueCodec::ToV8(cef_value_t* value, int depth) {
+        if (!value || depth > kMaxDepth) {
+            return cef_v8value_create_null();
+        }
+
+        switch (value->get_type(value)) {
+        case VTYPE_BOOL:
+            return cef_v8value_create_bool(value->get_bool(value));
+
+        case VTYPE_INT:
+            return cef_v8value_create_int(value->get_int(value));
+
+        case VTYPE_DOUBLE:
+            return cef_v8value_create_double(value->get_double(value));
+
+        case VTYPE_STRING: {
+            cef_string_userfree_t str = value->get_string(value);
+            cef_string_t empty = {};
+            cef_v8value_t* result = cef_v8value_create_string(str ? str : &empty);
+            if (str) cef_string_userfree_free(str);
+            return result;
+        }
+
+        case VTYPE_BINARY: {
+            cef_binary_value_t* binary = value->get_binary(value);
+            size_t size = binary ? binary->get_size(binary) : 0;
+            void* buffer = std::malloc(size > 0 ? size : 1);
+            if (!buffer) {
+                Release(binary);
+                return cef_v8value_create_null();
+            }
+            if (size > 0) {
+                binary->get_data(binary, buffer, size, 0);
+            }
+            Release(binary);
+            return cef_v8value_create_array_buffer(buffer, size, GetArrayBufferRelease());
+        }
+
+        case VTYPE_LIST: {
+            cef_list_value_t* list = value->get_list(value);
+            size_t size = list ? list->get_size(list) : 0;
+            cef_v8value_t* result = cef_v8value_create_array(static_cast<int>(size));
+            for (size_t i = 0; i < size; i++) {
+                cef_value_t* item = list->get_value(list, i);
+                cef_v8value_t* element = ToV8(item, depth + 1);
+                result->set_value_byindex(result, static_cast<int>(i), element);
+                Release(element);
+                Release(item);
+            }
+            Release(list);
+            return result;
+        }
+
+        case VTYPE_DICTIONARY: {
+            cef_dictionary_value_t* dictionary = value->get_dictionary(value);
+            cef_v8value_t* result = cef_v8value_create_object(nullptr, nullptr);
+            if (dictionary) {
+                cef_string_list_t keys = cef_string_list_alloc();
+                dictionary->get_keys(dictionary, keys);
+                size_t count = cef_string_list_size(keys);
+                for (size_t i = 0; i < count; i++) {
+                    cef_string_t key = {};
+                    cef_string_list_value(keys, i, &key);
+                    cef_value_t* item = dictionary->get_value(dictionary, &key);
+                    cef_v8value_t* member = ToV8(item, depth + 1);
+                    result->set_value_bykey(result, &key, member, V8_PROPERTY_ATTRIBUTE_NONE);
+                    Release(member);
+                    Release(item);
+                    cef_string_clear(&key);
+                }
+                cef_string_list_free(keys);
+            }
+            Release(dictionary);
+            return result;
+        }
+
+        default:
+            return cef_v8value_create_null();
+        }
+    }
+
+} // namespace Nexile
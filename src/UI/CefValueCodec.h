@@ -0,0 +1,52 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+#include "include/capi/cef_values_capi.h"
+#include "include/capi/cef_v8_capi.h"
+
+namespace Nexile {
+
+    // Converts request and reply payloads between the three shapes they take on
+    // the way between a page and a module: V8 values in the renderer, CEF
+    // list/dictionary/binary values inside process messages, and json trees in
+    // module handlers. Everything is copied value by value; nothing is
+    // stringified.
+    //
+    // Every function returns a new reference the caller releases. Nesting deeper
+    // than kMaxDepth is cut off as null, which also guards against cyclic page
+    // objects.
+    class CefValueCodec {
+    public:
+        static const int kMaxDepth = 64;
+
+        // json -> CEF value. Integers outside the int32 range become doubles,
+        // json binary becomes a binary value.
+        static cef_value_t* ToCefValue(const nlohmann::json& value);
+
+        // CEF value -> json. Binary values become json binary.
+        static nlohmann::json FromCefValue(cef_value_t* value);
+
+        // Page value -> CEF value. Functions, undefined, dates and array buffers
+        // become null (this CEF version has no way to read an ArrayBuffer).
+        static cef_value_t* FromV8(cef_v8value_t* value);
+
+        // CEF value -> page value; binary becomes an ArrayBuffer. Must be called
+        // with a V8 context entered.
+        static cef_v8value_t* ToV8(cef_value_t* value);
+
+        // cef_string_t <-> UTF-8 without an intermediate copy; invalid input
+        // becomes U+FFFD. SetString clears the previous contents.
+        static std::string ToStdString(const cef_string_t* str);
+        static void SetString(const std::string& value, cef_string_t* str);
+
+    private:
+        static cef_value_t* ToCefValue(const nlohmann::json& value, int depth);
+        static nlohmann::json FromCefValue(cef_value_t* value, int depth);
+        static cef_value_t* FromV8(cef_v8value_t* value, int depth);
+        static cef_v8value_t* ToV8(cef_value_t* value, int depth);
+    };
+
+} // namespace Nexile
@@ -0,0 +1,226 @@
+#include "FrameCompositor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Nexile {
+
+    namespace {
+        // Merging two rects is always fine when it touches at most this many extra pixels
+        const int64_t kFreeMergePixels = 32 * 32;
+    }
+
+    // ================== PaintRect ==================
+
+    PaintRect PaintRect::Union(const PaintRect& a, const PaintRect& b) {
+        if (a.IsEmpty()) return b;
+        if (b.IsEmpty()) return a;
+
+        int left = std::min(a.x, b.x);
+        int top = std::min(a.y, b.y);
+        int right = std::max(a.Right(), b.Right());
+        int bottom = std::max(a.Bottom(), b.Bottom());
+        return PaintRect(left, top, right - left, bottom - top);
+    }
+
+    PaintRect PaintRect::Intersect(const PaintRect& a, const PaintRect& b) {
+        int left = std::max(a.x, b.x);
+        int top = std::max(a.y, b.y);
+        int right = std::min(a.Right(), b.Right());
+        int bottom = std::min(a.Bottom(), b.Bottom());
+        if (right <= left || bottom <= top) {
+            return PaintRect();
+        }
+        return PaintRect(left, top, right - left, bottom - top);
+    }
+
+    // ================== DirtyRegion ==================
+
+    DirtyRegion::DirtyRegion(int maxRects, double fullFrameFraction)
+        : m_maxRects(maxRects > 0 ? maxRects : 1), m_fullFrameFraction(fullFrameFraction),
+          m_width(0), m_height(0) {
+    }
+
+    void DirtyRegion::SetBounds(int width, int height) {
+        m_width = width;
+        m_height = height;
+        m_rects.clear();
+    }
+
+    void DirtyRegion::Add(const PaintRect& rect) {
+        PaintRect clipped = rect;
+        if (m_width > 0 && m_height > 0) {
+            clipped = PaintRect::Intersect(rect, PaintRect(0, 0, m_width, m_height));
+        }
+        if (clipped.IsEmpty()) return;
+
+        for (const PaintRect& existing : m_rects) {
+            if (PaintRect::Intersect(existing, clipped).Area() == clipped.Area()) {
+                return; // Already covered
+            }
+        }
+
+        m_rects.push_back(clipped);
+        MergeAround(m_rects.size() - 1);
+
+        // Over the cap: merge whichever pair wastes least until it fits
+        while (m_rects.size() > static_cast<size_t>(m_maxRects)) {
+            size_t bestA = 0, bestB = 1;
+            int64_t bestWaste = std::numeric_limits<int64_t>::max();
+            for (size_t a = 0; a < m_rects.size(); a++) {
+                for (size_t b = a + 1; b < m_rects.size(); b++) {
+                    int64_t waste = MergeWaste(m_rects[a], m_rects[b]);
+                    if (waste < bestWaste) {
+                        bestWaste = waste;
+                        bestA = a;
+                        bestB = b;
+                    }
+                }
+            }
+            m_rects[bestA] = PaintRect::Union(m_rects[bestA], m_rects[bestB]);
+            m_rects.erase(m_rects.begin() + bestB);
+            MergeAround(bestA);
+        }
+
+        int64_t frameArea = static_cast<int64_t>(m_width) * m_height;
+        if (frameArea > 0 && static_cast<double>(GetArea()) >= m_fullFrameFraction * static_cast<double>(frameArea)) {
+            AddFull();
+        }
+    }
+
+    void DirtyRegion::AddFull() {
+        m_rects.clear();
+        if (m_width > 0 && m_height > 0) {
+            m_rects.push_back(PaintRect(0, 0, m_width, m_height));
+        }
+    }
+
+    void DirtyRegion::Clear() {
+        m_rects.clear();
+    }
+
+    PaintRect DirtyRegion::GetBounds() const {
+        PaintRect bounds;
+        for (const PaintRect& rect : m_rects) {
+            bounds = PaintRect::Union(bounds, rect);
+        }
+        return bounds;
+    }
+
+    int64_t DirtyRegion::GetArea() const {
+        int64_t area = 0;
+        for (const PaintRect& rect : m_rects) {
+            area += rect.Area();
+        }
+        return area;
+    }
+
+    int64_t DirtyRegion::MergeWaste(const PaintRect& a, const PaintRect& b) {
+        int64_t covered = a.Area() + b.Area() - PaintRect::Intersect(a, b).Area();
+        return PaintRect::Union(a, b).Area() - covered;
+    }
+
+    void DirtyRegion::MergeAround(size_t index) {
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (size_t other = 0; other < m_rects.size(); other++) {
+                if (other == index) continue;
+
+                const PaintRect& a = m_rects[index];
+                const PaintRect& b = m_rects[other];
+                int64_t waste = MergeWaste(a, b);
+                if (waste > kFreeMergePixels && waste * 4 > a.Area() + b.Area()) {
+                    continue;
+                }
+
+                m_rects[index] = PaintRect::Union(a, b);
+                m_rects.erase(m_rects.begin() + other);
+                if (other < index) index--;
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    // ================== FrameCompositor ==================
+
+    FrameCompositor::FrameCompositor(const FramePacerOptions& pacing, int maxRects, double fullFrameFraction)
+        : m_pacer(pacing), m_dirty(maxRects, fullFrameFraction),
+          m_pixels(nullptr), m_width(0), m_height(0), m_stride(0), m_paintsSincePresent(0) {
+    }
+
+    void FrameCompositor::Attach(uint8_t* pixels, int width, int height, int stride) {
+        m_pixels = pixels;
+        m_width = width;
+        m_height = height;
+        m_stride = stride;
+        m_dirty.SetBounds(width, height);
+        m_dirty.AddFull();
+    }
+
+    void FrameCompositor::Detach() {
+        m_pixels = nullptr;
+        m_width = 0;
+        m_height = 0;
+        m_stride = 0;
+        m_dirty.SetBounds(0, 0);
+    }
+
+    void FrameCompositor::OnPaint(const void* buffer, int width, int height,
+                                  const PaintRect* rects, size_t rectCount, TimePoint now) {
+        m_stats.paints++;
+        m_paintsSincePresent++;
+        m_pacer.OnPaint(now);
+
+        // A paint for another size arrives while a resize is in flight; the
+        // next paint at the new size covers the whole frame anyway
+        if (!m_pixels || !buffer || width != m_width || height != m_height) {
+            return;
+        }
+
+        const uint8_t* source = static_cast<const uint8_t*>(buffer);
+        const size_t sourceStride = static_cast<size_t>(width) * 4;
+        const PaintRect frame(0, 0, width, height);
+
+        for (size_t i = 0; i < rectCount; i++) {
+            PaintRect rect = PaintRect::Intersect(rects[i], frame);
+            if (rect.IsEmpty()) continue;
+
+            const size_t rowBytes = static_cast<size_t>(rect.width) * 4;
+            for (int y = rect.y; y < rect.Bottom(); y++) {
+                std::memcpy(m_pixels + static_cast<size_t>(y) * m_stride + static_cast<size_t>(rect.x) * 4,
+                            source + static_cast<size_t>(y) * sourceStride + static_cast<size_t>(rect.x) * 4,
+                            rowBytes);
+            }
+
+            m_stats.pixelsCopied += static_cast<uint64_t>(rect.Area());
+            m_dirty.Add(rect);
+        }
+    }
+
+    bool FrameCompositor::Present(TimePoint now, const PresentCallback& present) {
+        if (m_dirty.IsEmpty() || !m_pixels || now < m_pacer.NextPresentTime(now)) {
+            return false;
+        }
+
+        PaintRect bounds = m_dirty.GetBounds();
+        present(m_dirty.GetRects(), bounds);
+
+        m_stats.presents++;
+        m_stats.pixelsPresented += static_cast<uint64_t>(m_dirty.GetArea());
+        if (bounds.Area() == static_cast<int64_t>(m_width) * m_height) {
+            m_stats.fullFramePresents++;
+        }
+        if (m_paintsSincePresent > 1) {
+            m_stats.coalescedPaints += m_paintsSincePresent - 1;
+        }
+        m_paintsSincePresent = 0;
+
+        m_dirty.Clear();
+        m_pacer.OnPresent(now);
+        return true;
+    }
+
+} // namespace Nexile
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "FramePacer.h"
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace Nexile {
+
+    // Axis-aligned pixel rectangle
+    struct PaintRect {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+
+        PaintRect() = default;
+        PaintRect(int left, int top, int w, int h) : x(left), y(top), width(w), height(h) {}
+
+        bool IsEmpty() const { return width <= 0 || height <= 0; }
+        int64_t Area() const { return IsEmpty() ? 0 : static_cast<int64_t>(width) * height; }
+        int Right() const { return x + width; }
+        int Bottom() const { return y + height; }
+
+        static PaintRect Union(const PaintRect& a, const PaintRect& b);
+        static PaintRect Intersect(const PaintRect& a, const PaintRect& b);
+    };
+
+    // Accumulates dirty rectangles between presents.
+    //
+    // Rectangles are clipped to the frame and merged whenever their bounding
+    // box wastes little area, so a burst of small paints (blinking caret,
+    // progress text, hover highlights) ends up as a few blits instead of many.
+    // The list is capped at maxRects by merging the cheapest pair, and once the
+    // dirty area covers most of the frame it collapses to one full-frame rect.
+    class DirtyRegion {
+    public:
+        DirtyRegion(int maxRects = 8, double fullFrameFraction = 0.6);
+
+        void SetBounds(int width, int height);
+
+        void Add(const PaintRect& rect);
+        void AddFull();
+        void Clear();
+
+        bool IsEmpty() const { return m_rects.empty(); }
+        const std::vector<PaintRect>& GetRects() const { return m_rects; }
+        PaintRect GetBounds() const;
+        int64_t GetArea() const;
+
+    private:
+        // Extra pixels merging a and b would touch
+        static int64_t MergeWaste(const PaintRect& a, const PaintRect& b);
+
+        // Fold `index` into any rect it is cheap to merge with, repeatedly
+        void MergeAround(size_t index);
+
+    private:
+        int m_maxRects;
+        double m_fullFrameFraction;
+        int m_width;
+        int m_height;
+        std::vector<PaintRect> m_rects;
+    };
+
+    // Counters of a FrameCompositor
+    struct CompositorStats {
+        uint64_t paints = 0;            // Paint callbacks received
+        uint64_t presents = 0;          // Blits to the window
+        uint64_t coalescedPaints = 0;   // Paints folded into a later present
+        uint64_t pixelsCopied = 0;      // Paint buffer -> backing store
+        uint64_t pixelsPresented = 0;   // Backing store -> window
+        uint64_t fullFramePresents = 0;
+    };
+
+    // Off-screen paint handling for the overlay.
+    //
+    // CEF paints a full BGRA frame plus the rects that changed. Only those rects
+    // are copied into the attached backing store (the layered window's DIB
+    // section on Windows) and added to the dirty region. Present pushes the
+    // merged region to the window when the pacer allows it. UI thread only.
+    class FrameCompositor {
+    public:
+        using Clock = FramePacer::Clock;
+        using TimePoint = FramePacer::TimePoint;
+
+        // Push the backing store to the window; bounds covers every rect
+        using PresentCallback = std::function<void(const std::vector<PaintRect>& rects, const PaintRect& bounds)>;
+
+        explicit FrameCompositor(const FramePacerOptions& pacing = FramePacerOptions(),
+                                 int maxRects = 8, double fullFrameFraction = 0.6);
+
+        // Backing store (32-bit pixels). Attaching marks the whole frame dirty.
+        void Attach(uint8_t* pixels, int width, int height, int stride);
+        void Detach();
+        bool IsAttached() const { return m_pixels != nullptr; }
+
+        // Copy the dirty parts of a CEF paint (tightly packed BGRA, width * 4 stride)
+        void OnPaint(const void* buffer, int width, int height,
+                     const PaintRect* rects, size_t rectCount, TimePoint now);
+
+        // Present pending changes if the pacer allows; true when something was presented
+        bool Present(TimePoint now, const PresentCallback& present);
+
+        bool HasPending() const { return !m_dirty.IsEmpty(); }
+        FramePacer& GetPacer() { return m_pacer; }
+        const FramePacer& GetPacer() const { return m_pacer; }
+        const CompositorStats& GetStats() const { return m_stats; }
+
+    private:
+        FramePacer m_pacer;
+        DirtyRegion m_dirty;
+
+        uint8_t* m_pixels;
+        int m_width;
+        int m_height;
+        int m_stride;
+
+        uint64_t m_paintsSincePresent;
+        CompositorStats m_stats;
+    };
+
+} // namespace Nexile
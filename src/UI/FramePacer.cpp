@@ -0,0 +1,72 @@
+#include "FramePacer.h"
+
+namespace Nexile {
+
+    FramePacer::FramePacer(const FramePacerOptions& options)
+        : m_options(options), m_visible(true), m_active(false), m_presented(false) {
+    }
+
+    void FramePacer::SetVisible(bool visible, TimePoint now) {
+        if (visible && !m_visible) {
+            // Becoming visible repaints everything
+            OnActivity(now);
+        }
+        m_visible = visible;
+    }
+
+    void FramePacer::OnActivity(TimePoint now) {
+        m_active = true;
+        m_lastActivity = now;
+    }
+
+    void FramePacer::OnPaint(TimePoint now) {
+        OnActivity(now);
+    }
+
+    void FramePacer::OnPresent(TimePoint now) {
+        m_presented = true;
+        m_lastPresent = now;
+    }
+
+    PaceMode FramePacer::GetMode(TimePoint now) const {
+        if (!m_visible) {
+            return PaceMode::Hidden;
+        }
+        if (m_active && now - m_lastActivity < m_options.animationHold) {
+            return PaceMode::Animating;
+        }
+        return PaceMode::Static;
+    }
+
+    int FramePacer::GetTargetFps(TimePoint now) const {
+        switch (GetMode(now)) {
+        case PaceMode::Animating: return m_options.animatingFps;
+        case PaceMode::Static: return m_options.staticFps;
+        default: return 0;
+        }
+    }
+
+    FramePacer::TimePoint FramePacer::NextPresentTime(TimePoint now) const {
+        int fps = GetTargetFps(now);
+        if (fps <= 0) {
+            return TimePoint::max();
+        }
+        if (!m_presented) {
+            return now;
+        }
+
+        // An eighth of a frame of slack so paints that arrive exactly one frame
+        // apart are not pushed to the frame after by timer rounding
+        auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+        TimePoint due = m_lastPresent + interval - interval / 8;
+        return due > now ? due : now;
+    }
+
+    FramePacer::TimePoint FramePacer::NextModeChange(TimePoint now) const {
+        if (GetMode(now) != PaceMode::Animating) {
+            return TimePoint::max();
+        }
+        return m_lastActivity + m_options.animationHold;
+    }
+
+} // namespace Nexile
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Render rate the overlay is currently running at
+    enum class PaceMode {
+        Hidden,     // Nothing is presented and CEF is told the view is hidden
+        Static,     // Nothing changed recently; CEF runs at the static rate
+        Animating   // Paints or input within the hold window; full rate
+    };
+
+    struct FramePacerOptions {
+        int animatingFps = 60;
+        int staticFps = 1;
+
+        // How long after the last paint or input the overlay counts as animating
+        std::chrono::milliseconds animationHold{ 500 };
+    };
+
+    // Decides when the off-screen overlay may present and what frame rate CEF
+    // should paint at.
+    //
+    // Any paint, input event or page update moves the pacer to Animating, so
+    // the first change after a quiet period is presented at once and CEF is
+    // raised to full rate before the follow-up frames. After animationHold
+    // without activity it drops to the static rate; while hidden it presents
+    // nothing. Presents are spaced by the current mode's frame interval, which
+    // coalesces bursts of paints into one blit.
+    class FramePacer {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+        explicit FramePacer(const FramePacerOptions& options = FramePacerOptions());
+
+        void SetVisible(bool visible, TimePoint now);
+        bool IsVisible() const { return m_visible; }
+
+        // Input or a script update that is likely to repaint
+        void OnActivity(TimePoint now);
+
+        // CEF delivered a paint
+        void OnPaint(TimePoint now);
+
+        // A frame went to the window
+        void OnPresent(TimePoint now);
+
+        PaceMode GetMode(TimePoint now) const;
+
+        // Frame rate for the current mode (0 while hidden)
+        int GetTargetFps(TimePoint now) const;
+
+        // Earliest time pending content may be presented (TimePoint::max() while hidden)
+        TimePoint NextPresentTime(TimePoint now) const;
+
+        // When GetMode will next change on its own (TimePoint::max() if it will not)
+        TimePoint NextModeChange(TimePoint now) const;
+
+        const FramePacerOptions& GetOptions() const { return m_options; }
+
+    private:
+        FramePacerOptions m_options;
+        bool m_visible;
+        bool m_active;              // Any activity seen yet
+        TimePoint m_lastActivity;
+        bool m_presented;           // Any frame presented yet
+        TimePoint m_lastPresent;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,169 @@
+// Client side of the overlay's StateStore.
+//
+// nexileState.subscribe(key, listener) fetches a snapshot of the key through
+// nexile.request('state.subscribe') and then applies the JSON-Patch deltas
+// the overlay posts each tick. Listeners get (value, ops, key); ops is null
+// for a snapshot. nexileState.changed(value, ops) returns a copy of value
+// holding only the members ops touched (removed ones as null), for pages that
+// update just those parts of the DOM.
+(function() {
+    'use strict';
+    if (window.nexileState) return;
+
+    const entries = new Map();      // key -> { version, value, listeners }
+    const pendingKeys = new Set();
+    let retryTimer = null;
+
+    function parsePointer(path) {
+        return path.split('/').slice(1).map(function(token) {
+            return token.replace(/~1/g, '/').replace(/~0/g, '~');
+        });
+    }
+
+    // Apply one add/remove/replace operation; returns the new root
+    function applyOp(root, op) {
+        if (op.path === '') {
+            return op.op === 'remove' ? null : op.value;
+        }
+
+        const tokens = parsePointer(op.path);
+        const last = tokens.pop();
+        let parent = root;
+        for (const token of tokens) {
+            parent = parent[Array.isArray(parent) ? Number(token) : token];
+        }
+
+        if (Array.isArray(parent)) {
+            const index = last === '-' ? parent.length : Number(last);
+            if (op.op === 'add') parent.splice(index, 0, op.value);
+            else if (op.op === 'remove') parent.splice(index, 1);
+            else parent[index] = op.value;
+        } else if (op.op === 'remove') {
+            delete parent[last];
+        } else {
+            parent[last] = op.value;
+        }
+        return root;
+    }
+
+    function changed(value, ops) {
+        if (!ops) return value;
+
+        let sparse = {};
+        for (const op of ops) {
+            if (op.path === '') return value;
+
+            // Copy down to the touched member; arrays are taken whole
+            const tokens = parsePointer(op.path);
+            let source = value;
+            let target = sparse;
+            for (let i = 0; i < tokens.length; i++) {
+                const token = tokens[i];
+                const next = source !== null && typeof source === 'object' ? source[token] : undefined;
+                if (i === tokens.length - 1 || Array.isArray(next) || next === null || typeof next !== 'object') {
+                    target[token] = next === undefined ? null : next;
+                    break;
+                }
+                if (target[token] === undefined || target[token] === null || typeof target[token] !== 'object') {
+                    target[token] = {};
+                }
+                source = next;
+                target = target[token];
+            }
+        }
+        return sparse;
+    }
+
+    function notify(key, entry, ops) {
+        for (const listener of entry.listeners) {
+            try {
+                listener(entry.value, ops, key);
+            } catch (e) {
+                console.error('State listener for ' + key + ' failed:', e);
+            }
+        }
+    }
+
+    function requestSnapshots() {
+        retryTimer = null;
+        if (!pendingKeys.size) return;
+
+        // The bridge is injected when the page finishes loading
+        if (!window.nexile || !window.nexile.request) {
+            retryTimer = setTimeout(requestSnapshots, 50);
+            return;
+        }
+
+        const keys = Array.from(pendingKeys);
+        pendingKeys.clear();
+        window.nexile.request('state.subscribe', { keys: keys }).then(function(snapshot) {
+            for (const key of keys) {
+                const entry = entries.get(key);
+                const state = snapshot && snapshot[key];
+                if (!entry || !state || state.version <= entry.version) continue;
+                entry.version = state.version;
+                entry.value = state.value;
+                notify(key, entry, null);
+            }
+        }).catch(function(e) {
+            console.error('State subscription failed:', e);
+        });
+    }
+
+    function resync(key) {
+        pendingKeys.add(key);
+        if (!retryTimer) requestSnapshots();
+    }
+
+    function applyDelta(delta) {
+        const entry = entries.get(delta.key);
+        if (!entry || delta.to <= entry.version) return;
+
+        if (entry.version !== delta.from) {
+            // Missed a delta or still waiting for the snapshot
+            resync(delta.key);
+            return;
+        }
+
+        try {
+            let value = entry.value;
+            for (const op of delta.ops) {
+                value = applyOp(value, op);
+            }
+            entry.value = value;
+            entry.version = delta.to;
+        } catch (e) {
+            resync(delta.key);
+            return;
+        }
+        notify(delta.key, entry, delta.ops);
+    }
+
+    window.addEventListener('message', function(event) {
+        const data = event.data;
+        if (data && Array.isArray(data.nexileState)) {
+            data.nexileState.forEach(applyDelta);
+        }
+    });
+
+    window.nexileState = {
+        subscribe: function(key, listener) {
+            let entry = entries.get(key);
+            if (!entry) {
+                entry = { version: -1, value: null, listeners: [] };
+                entries.set(key, entry);
+            }
+            entry.listeners.push(listener);
+            if (entry.version >= 0) {
+                listener(entry.value, null, key);
+            } else {
+                resync(key);
+            }
+        },
+        get: function(key) {
+            const entry = entries.get(key);
+            return entry ? entry.value : undefined;
+        },
+        changed: changed
+    };
+})();
@@ -0,0 +1,138 @@
+// Virtual scrolling over a result table the overlay keeps in C++.
+//
+// nexileTable.attach(name, options) shows the ResultTable registered under
+// name in a table body inside a scrolling element. Only the rows in view
+// (plus some overscan) are in the DOM: on scroll the page asks for that
+// window through nexile.request('table.window') and gets it as rendered
+// rows, with spacer rows standing in for the rest. Rows need a fixed height.
+//
+// Options: scroller (the scrolling element), body (its tbody), rowHeight in
+// pixels, columns (for the spacer cells), overscan in rows, onChange(count)
+// after the view changed size. Returns { sort(column, descending),
+// filter(text), refresh() }.
+//
+// Needs nexile_state.js, which delivers "table.<name>" when the rows change.
+(function() {
+    'use strict';
+    if (window.nexileTable) return;
+
+    function spacer(height, columns) {
+        return height > 0 ? '<tr class="nexile-spacer" style="height:' + height + 'px"><td colspan="' + columns +
+            '" style="padding:0;border:0"></td></tr>' : '';
+    }
+
+    function attach(name, options) {
+        const scroller = options.scroller;
+        const body = options.body;
+        const rowHeight = options.rowHeight || 24;
+        const columns = options.columns || 1;
+        const overscan = options.overscan || 20;
+
+        let version = 0;        // Newest version of the table we know of
+        let count = 0;          // Rows in its view
+        let shown = { version: -1, offset: 0, rows: 0 };
+        let reported = -1;      // Count last passed to onChange
+        let inFlight = false;
+        let frame = 0;
+
+        function bridge() {
+            return window.nexile && window.nexile.request ? window.nexile : null;
+        }
+
+        function visibleRange() {
+            const first = Math.floor(scroller.scrollTop / rowHeight);
+            const last = Math.ceil((scroller.scrollTop + scroller.clientHeight) / rowHeight);
+            return { first: Math.min(first, count), last: Math.min(last, count) };
+        }
+
+        function render(slice) {
+            const top = slice.offset * rowHeight;
+            const bottom = (slice.count - slice.offset - slice.rows) * rowHeight;
+            body.innerHTML = spacer(top, columns) + slice.html + spacer(bottom, columns);
+            shown = { version: slice.version, offset: slice.offset, rows: slice.rows };
+        }
+
+        // One request at a time; whatever the page needs once it returns is
+        // asked for next
+        function update() {
+            frame = 0;
+            if (inFlight) return;
+
+            const range = visibleRange();
+            if (shown.version === version && range.first >= shown.offset &&
+                range.last <= shown.offset + shown.rows) {
+                return;
+            }
+
+            const nexile = bridge();
+            if (!nexile) {
+                setTimeout(schedule, 50);
+                return;
+            }
+
+            const offset = Math.max(0, range.first - overscan);
+            inFlight = true;
+            nexile.request('table.window', {
+                table: name,
+                offset: offset,
+                count: range.last - offset + overscan
+            }).then(function(slice) {
+                inFlight = false;
+                if (slice.version >= version) {
+                    version = slice.version;
+                    count = slice.count;
+                    render(slice);
+                    if (count !== reported && options.onChange) {
+                        reported = count;
+                        options.onChange(count);
+                    }
+                }
+                schedule();
+            }).catch(function(e) {
+                inFlight = false;
+                console.error('Table window for ' + name + ' failed:', e);
+            });
+        }
+
+        function schedule() {
+            if (!frame) frame = requestAnimationFrame(update);
+        }
+
+        function changed(state) {
+            if (!state || state.version <= version) return;
+            version = state.version;
+            count = state.rows;
+            schedule();
+        }
+
+        scroller.addEventListener('scroll', schedule, { passive: true });
+        window.addEventListener('resize', schedule);
+        if (window.nexileState) {
+            window.nexileState.subscribe('table.' + name, changed);
+        }
+        schedule();
+
+        function send(channel, payload) {
+            const nexile = bridge();
+            if (!nexile) return Promise.reject(new Error('Bridge not ready'));
+            payload.table = name;
+            return nexile.request(channel, payload).then(function(state) {
+                changed({ version: state.version, rows: state.count });
+                return state;
+            });
+        }
+
+        return {
+            sort: function(column, descending) {
+                return send('table.sort', { column: column, descending: !!descending });
+            },
+            filter: function(text) {
+                scroller.scrollTop = 0;
+                return send('table.filter', { text: text });
+            },
+            refresh: schedule
+        };
+    }
+
+    window.nexileTable = { attach: attach };
+})();
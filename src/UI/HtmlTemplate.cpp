@@ -0,0 +1,338 @@
+#include "HtmlTemplate.h"
+
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        // Characters AppendEscaped replaces
+        struct EscapeTable {
+            bool escape[256] = {};
+
+            EscapeTable() {
+                for (unsigned char c : std::string_view("&<>\"'")) {
+                    escape[c] = true;
+                }
+            }
+        };
+
+        const EscapeTable kEscapeTable;
+
+        // True when any byte of the word is one of & < > " '
+        inline bool HasSpecialByte(uint64_t word) {
+            constexpr uint64_t kOnes = 0x0101010101010101ull;
+            constexpr uint64_t kHigh = 0x8080808080808080ull;
+            auto hasZero = [](uint64_t v) { return (v - kOnes) & ~v & kHigh; };
+            return hasZero(word ^ (kOnes * '&')) | hasZero(word ^ (kOnes * '<')) | hasZero(word ^ (kOnes * '>')) |
+                hasZero(word ^ (kOnes * '"')) | hasZero(word ^ (kOnes * '\''));
+        }
+
+        std::string_view Trim(std::string_view text) {
+            size_t begin = text.find_first_not_of(" \t\r\n");
+            if (begin == std::string_view::npos) return {};
+            size_t end = text.find_last_not_of(" \t\r\n");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        size_t LineAt(std::string_view source, size_t position) {
+            size_t line = 1;
+            for (size_t i = 0; i < position && i < source.size(); i++) {
+                if (source[i] == '\n') line++;
+            }
+            return line;
+        }
+
+        template <typename Number>
+        void AppendNumber(Number value, std::string& out) {
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr);
+        }
+    }
+
+    bool HtmlTemplate::Compile(std::string_view source, std::string& error) {
+        m_instructions.clear();
+        m_paths.clear();
+        m_text.clear();
+
+        std::unordered_map<std::string, uint32_t> pathIndex;
+        struct OpenSection {
+            std::string name;
+            size_t instruction;
+            size_t position;    // Of the opening tag in source
+        };
+        std::vector<OpenSection> open;
+
+        auto fail = [&](const std::string& message, size_t position) {
+            error = message + " at line " + std::to_string(LineAt(source, position));
+            m_instructions.clear();
+            m_paths.clear();
+            m_text.clear();
+            return false;
+        };
+
+        auto addText = [&](std::string_view text) {
+            if (text.empty()) return;
+            // Chunks are appended to the pool in order, so a chunk after a
+            // comment extends the previous one
+            if (!m_instructions.empty() && m_instructions.back().op == Op::Text &&
+                m_instructions.back().offset + m_instructions.back().length == m_text.size()) {
+                m_instructions.back().length += static_cast<uint32_t>(text.size());
+            } else {
+                m_instructions.push_back({ Op::Text, 0, static_cast<uint32_t>(m_text.size()),
+                    static_cast<uint32_t>(text.size()), 0 });
+            }
+            m_text.append(text);
+        };
+
+        auto addPath = [&](const std::string& name, uint32_t& index) {
+            auto it = pathIndex.find(name);
+            if (it != pathIndex.end()) {
+                index = it->second;
+                return true;
+            }
+
+            Path path;
+            if (name != ".") {
+                size_t start = 0;
+                while (true) {
+                    size_t dot = name.find('.', start);
+                    std::string part = name.substr(start, dot == std::string::npos ? std::string::npos : dot - start);
+                    if (part.empty()) return false;
+                    path.push_back(std::move(part));
+                    if (dot == std::string::npos) break;
+                    start = dot + 1;
+                }
+            }
+
+            index = static_cast<uint32_t>(m_paths.size());
+            m_paths.push_back(std::move(path));
+            pathIndex.emplace(name, index);
+            return true;
+        };
+
+        size_t position = 0;
+        while (position < source.size()) {
+            size_t tagStart = source.find("{{", position);
+            if (tagStart == std::string_view::npos) {
+                addText(source.substr(position));
+                break;
+            }
+            addText(source.substr(position, tagStart - position));
+
+            bool triple = source.compare(tagStart, 3, "{{{") == 0;
+            size_t bodyStart = tagStart + (triple ? 3 : 2);
+            size_t tagEnd = source.find(triple ? "}}}" : "}}", bodyStart);
+            if (tagEnd == std::string_view::npos) {
+                return fail("Unclosed tag", tagStart);
+            }
+            position = tagEnd + (triple ? 3 : 2);
+
+            std::string_view body = Trim(source.substr(bodyStart, tagEnd - bodyStart));
+            char sigil = triple || body.empty() ? '\0' : body[0];
+            if (sigil == '!') continue;
+            if (sigil == '#' || sigil == '^' || sigil == '/' || sigil == '&') {
+                body = Trim(body.substr(1));
+            }
+
+            std::string name(body);
+            uint32_t path = 0;
+            if (name.empty() || !addPath(name, path)) {
+                return fail("Invalid name '" + name + "'", tagStart);
+            }
+
+            if (sigil == '#' || sigil == '^') {
+                open.push_back({ name, m_instructions.size(), tagStart });
+                m_instructions.push_back({ sigil == '#' ? Op::Section : Op::Inverted, path, 0, 0, 0 });
+            } else if (sigil == '/') {
+                if (open.empty() || open.back().name != name) {
+                    return fail("Unexpected end of section '" + name + "'", tagStart);
+                }
+                size_t begin = open.back().instruction;
+                open.pop_back();
+                m_instructions[begin].jump = static_cast<uint32_t>(m_instructions.size());
+                m_instructions.push_back({ Op::End, path, 0, 0, static_cast<uint32_t>(begin) });
+            } else {
+                Op op = triple || sigil == '&' ? Op::Raw : Op::Escaped;
+                m_instructions.push_back({ op, path, 0, 0, 0 });
+            }
+        }
+
+        if (!open.empty()) {
+            return fail("Unclosed section '" + open.back().name + "'", open.back().position);
+        }
+
+        return true;
+    }
+
+    void HtmlTemplate::Render(const json& data, std::string& out) const {
+        std::vector<const json*> scope;
+        scope.reserve(8);
+        scope.push_back(&data);
+        RenderRange(0, m_instructions.size(), scope, out);
+    }
+
+    std::string HtmlTemplate::Render(const json& data) const {
+        std::string out;
+        Render(data, out);
+        return out;
+    }
+
+    void HtmlTemplate::AppendEscaped(std::string_view text, std::string& out) {
+        const char* data = text.data();
+        size_t length = text.size();
+        size_t run = 0;
+
+        size_t i = 0;
+        while (i < length) {
+            // Skip clean text eight bytes at a time
+            while (i + 8 <= length) {
+                uint64_t word;
+                std::memcpy(&word, data + i, sizeof(word));
+                if (HasSpecialByte(word)) break;
+                i += 8;
+            }
+            while (i < length && !kEscapeTable.escape[static_cast<unsigned char>(data[i])]) {
+                i++;
+            }
+            if (i == length) break;
+
+            unsigned char c = static_cast<unsigned char>(data[i]);
+
+            out.append(data + run, i - run);
+            switch (c) {
+            case '&': out.append("&amp;", 5); break;
+            case '<': out.append("&lt;", 4); break;
+            case '>': out.append("&gt;", 4); break;
+            case '"': out.append("&quot;", 6); break;
+            default: out.append("&#39;", 5); break;
+            }
+            run = ++i;
+        }
+        out.append(data + run, length - run);
+    }
+
+    void HtmlTemplate::RenderRange(size_t begin, size_t end, std::vector<const json*>& scope,
+        std::string& out) const {
+        for (size_t i = begin; i < end; i++) {
+            const Instruction& instruction = m_instructions[i];
+
+            switch (instruction.op) {
+            case Op::Text:
+                out.append(m_text.data() + instruction.offset, instruction.length);
+                break;
+
+            case Op::Escaped:
+            case Op::Raw: {
+                const json* value = Resolve(m_paths[instruction.path], scope);
+                if (value) {
+                    AppendValue(*value, instruction.op == Op::Escaped, out);
+                }
+                break;
+            }
+
+            case Op::Section: {
+                const json* value = Resolve(m_paths[instruction.path], scope);
+                if (value && value->is_array()) {
+                    for (const json& element : *value) {
+                        scope.push_back(&element);
+                        RenderRange(i + 1, instruction.jump, scope, out);
+                        scope.pop_back();
+                    }
+                } else if (value && value->is_object()) {
+                    scope.push_back(value);
+                    RenderRange(i + 1, instruction.jump, scope, out);
+                    scope.pop_back();
+                } else if (IsTruthy(value)) {
+                    RenderRange(i + 1, instruction.jump, scope, out);
+                }
+                i = instruction.jump;
+                break;
+            }
+
+            case Op::Inverted:
+                if (!IsTruthy(Resolve(m_paths[instruction.path], scope))) {
+                    RenderRange(i + 1, instruction.jump, scope, out);
+                }
+                i = instruction.jump;
+                break;
+
+            case Op::End:
+                break;
+            }
+        }
+    }
+
+    const json* HtmlTemplate::Resolve(const Path& path, const std::vector<const json*>& scope) {
+        if (path.empty()) {
+            return scope.back();
+        }
+
+        // The first name comes from the innermost section that has it
+        const json* value = nullptr;
+        for (auto it = scope.rbegin(); it != scope.rend(); ++it) {
+            if (!(*it)->is_object()) continue;
+            auto found = (*it)->find(path[0]);
+            if (found != (*it)->end()) {
+                value = &*found;
+                break;
+            }
+        }
+
+        for (size_t i = 1; value && i < path.size(); i++) {
+            if (!value->is_object()) return nullptr;
+            auto found = value->find(path[i]);
+            value = found != value->end() ? &*found : nullptr;
+        }
+        return value;
+    }
+
+    bool HtmlTemplate::IsTruthy(const json* value) {
+        if (!value) return false;
+
+        switch (value->type()) {
+        case json::value_t::null: return false;
+        case json::value_t::boolean: return value->get<bool>();
+        case json::value_t::string: return !value->get_ref<const std::string&>().empty();
+        case json::value_t::array: return !value->empty();
+        case json::value_t::number_integer: return value->get<int64_t>() != 0;
+        case json::value_t::number_unsigned: return value->get<uint64_t>() != 0;
+        case json::value_t::number_float: return value->get<double>() != 0.0;
+        default: return true;
+        }
+    }
+
+    void HtmlTemplate::AppendValue(const json& value, bool escape, std::string& out) {
+        switch (value.type()) {
+        case json::value_t::string: {
+            const std::string& text = value.get_ref<const std::string&>();
+            if (escape) {
+                AppendEscaped(text, out);
+            } else {
+                out.append(text);
+            }
+            break;
+        }
+        case json::value_t::boolean:
+            out.append(value.get<bool>() ? "true" : "false");
+            break;
+        case json::value_t::number_integer:
+            AppendNumber(value.get<int64_t>(), out);
+            break;
+        case json::value_t::number_unsigned:
+            AppendNumber(value.get<uint64_t>(), out);
+            break;
+        case json::value_t::number_float:
+            AppendNumber(value.get<double>(), out);
+            break;
+        default:
+            // null, objects and arrays render as nothing
+            break;
+        }
+    }
+
+} // namespace Nexile
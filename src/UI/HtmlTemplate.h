@@ -0,0 +1,82 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace Nexile {
+
+    // HTML template compiled once and rendered many times against JSON data.
+    //
+    // Syntax (a Mustache subset):
+    //   {{name}}            value, HTML escaped
+    //   {{{name}}}          value, as is
+    //   {{item.base}}       dotted path; the first name is looked up from the
+    //                       innermost section outwards, {{.}} is the current value
+    //   {{#items}}..{{/items}}  repeat per array element (as the current value),
+    //                       once with an object as the current value, once for
+    //                       any other truthy value
+    //   {{^items}}..{{/items}}  once when the value is missing, false, null, 0,
+    //                       "" or an empty array
+    //   {{! comment}}
+    //
+    // Compile turns the source into a flat instruction list: literal chunks
+    // (offsets into one text pool), slots and section jumps, with the paths
+    // split up front. Rendering walks that list and appends to the caller's
+    // buffer, so a buffer that is cleared and reused between renders stops
+    // allocating once it has grown to the page size.
+    class HtmlTemplate {
+    public:
+        HtmlTemplate() = default;
+
+        // Replace the template; on failure it is left empty and error says where
+        bool Compile(std::string_view source, std::string& error);
+
+        bool IsEmpty() const { return m_instructions.empty(); }
+        size_t GetInstructionCount() const { return m_instructions.size(); }
+
+        // Append the rendering to out
+        void Render(const nlohmann::json& data, std::string& out) const;
+        std::string Render(const nlohmann::json& data) const;
+
+        // Append text with & < > " ' replaced by entities
+        static void AppendEscaped(std::string_view text, std::string& out);
+
+    private:
+        enum class Op : uint8_t {
+            Text,       // Literal chunk: m_text[offset, offset + length)
+            Escaped,    // Value of path, escaped
+            Raw,        // Value of path, unescaped
+            Section,    // Enter when path is truthy; jump = matching End
+            Inverted,   // Enter when path is falsy; jump = matching End
+            End
+        };
+
+        struct Instruction {
+            Op op;
+            uint32_t path;      // Index into m_paths (slots and sections)
+            uint32_t offset;    // Text
+            uint32_t length;    // Text
+            uint32_t jump;      // Sections
+        };
+
+        using Path = std::vector<std::string>;  // Empty for "."
+
+        // Render instructions [begin, end) with `scope` as the section stack
+        void RenderRange(size_t begin, size_t end, std::vector<const nlohmann::json*>& scope,
+            std::string& out) const;
+
+        static const nlohmann::json* Resolve(const Path& path, const std::vector<const nlohmann::json*>& scope);
+        static bool IsTruthy(const nlohmann::json* value);
+        static void AppendValue(const nlohmann::json& value, bool escape, std::string& out);
+
+    private:
+        std::vector<Instruction> m_instructions;
+        std::vector<Path> m_paths;
+        std::string m_text;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,109 @@
+#include "MemoryManager.h"
+
+#include <algorithm>
+
+namespace Nexile {
+
+    MemoryManager::MemoryManager(const MemoryManagerOptions& options)
+        : m_options(options), m_hidden(false), m_stage(MemoryStage::Active), m_restoring(false) {
+    }
+
+    void MemoryManager::OnHidden(TimePoint now) {
+        if (m_hidden) return;
+        m_hidden = true;
+        m_hiddenSince = now;
+    }
+
+    MemoryStage MemoryManager::OnShown() {
+        MemoryStage reached = m_stage;
+        m_hidden = false;
+        m_stage = MemoryStage::Active;
+        return reached;
+    }
+
+    MemoryStage MemoryManager::GetNextStage() const {
+        if (!m_hidden) return MemoryStage::Active;
+
+        for (MemoryStage stage : { MemoryStage::Trimmed, MemoryStage::PagesDiscarded, MemoryStage::Suspended }) {
+            if (stage > m_stage && GetDelay(stage).count() > 0) {
+                return stage;
+            }
+        }
+        return MemoryStage::Active;
+    }
+
+    MemoryManager::TimePoint MemoryManager::GetNextStageTime() const {
+        MemoryStage next = GetNextStage();
+        if (next == MemoryStage::Active) {
+            return TimePoint::max();
+        }
+        return m_hiddenSince + GetDelay(next);
+    }
+
+    MemoryStage MemoryManager::TakeDueStage(TimePoint now) {
+        MemoryStage next = GetNextStage();
+        if (next == MemoryStage::Active || now < GetNextStageTime()) {
+            return MemoryStage::Active;
+        }
+        m_stage = next;
+        return next;
+    }
+
+    void MemoryManager::RecordStage(MemoryStage stage, size_t bytesBefore, size_t bytesAfter) {
+        switch (stage) {
+        case MemoryStage::Trimmed: m_stats.trims++; break;
+        case MemoryStage::PagesDiscarded: m_stats.discards++; break;
+        case MemoryStage::Suspended: m_stats.suspends++; break;
+        default: break;
+        }
+
+        m_stats.lastStage = stage;
+        m_stats.lastBytesBefore = bytesBefore;
+        m_stats.lastBytesAfter = bytesAfter;
+        if (bytesBefore > bytesAfter) {
+            m_stats.bytesReleased += bytesBefore - bytesAfter;
+        }
+    }
+
+    void MemoryManager::BeginRestore(TimePoint now) {
+        m_restoring = true;
+        m_restoreStart = now;
+
+        if (m_hidden) {
+            m_stage = MemoryStage::Active;
+            m_hiddenSince = now;
+        }
+    }
+
+    double MemoryManager::EndRestore(TimePoint now) {
+        if (!m_restoring) return 0.0;
+        m_restoring = false;
+
+        double ms = std::chrono::duration<double, std::milli>(now - m_restoreStart).count();
+        m_stats.restores++;
+        m_stats.lastRestoreMs = ms;
+        m_stats.averageRestoreMs += (ms - m_stats.averageRestoreMs) / static_cast<double>(m_stats.restores);
+        m_stats.maxRestoreMs = std::max(m_stats.maxRestoreMs, ms);
+        return ms;
+    }
+
+    const char* MemoryManager::GetStageName(MemoryStage stage) {
+        switch (stage) {
+        case MemoryStage::Active: return "active";
+        case MemoryStage::Trimmed: return "trimmed";
+        case MemoryStage::PagesDiscarded: return "pages-discarded";
+        case MemoryStage::Suspended: return "suspended";
+        }
+        return "unknown";
+    }
+
+    std::chrono::milliseconds MemoryManager::GetDelay(MemoryStage stage) const {
+        switch (stage) {
+        case MemoryStage::Trimmed: return m_options.trimAfter;
+        case MemoryStage::PagesDiscarded: return m_options.discardAfter;
+        case MemoryStage::Suspended: return m_options.suspendAfter;
+        default: return std::chrono::milliseconds(0);
+        }
+    }
+
+} // namespace Nexile
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nexile {
+
+    // How far the hidden overlay has given memory back, in the order stages run
+    enum class MemoryStage {
+        Active,         // Shown, or hidden for less than trimAfter
+        Trimmed,        // Caches, backing store and garbage released, working set trimmed
+        PagesDiscarded, // Warm pages other than the current one unloaded
+        Suspended       // Browser closed; the page is reloaded on show
+    };
+
+    struct MemoryManagerOptions {
+        // Time hidden before each stage runs; zero turns the stage off
+        std::chrono::milliseconds trimAfter{ std::chrono::seconds(30) };
+        std::chrono::milliseconds discardAfter{ std::chrono::minutes(5) };
+        std::chrono::milliseconds suspendAfter{ 0 };
+    };
+
+    struct MemoryStats {
+        uint64_t trims = 0;
+        uint64_t discards = 0;
+        uint64_t suspends = 0;
+        uint64_t restores = 0;
+
+        // Working set around the last stage, and released by all of them
+        MemoryStage lastStage = MemoryStage::Active;
+        size_t lastBytesBefore = 0;
+        size_t lastBytesAfter = 0;
+        uint64_t bytesReleased = 0;
+
+        // From show to the restored page being on screen
+        double lastRestoreMs = 0.0;
+        double averageRestoreMs = 0.0;
+        double maxRestoreMs = 0.0;
+    };
+
+    // Decides when a hidden overlay gives memory back.
+    //
+    // Hiding starts a clock; each enabled stage falls due once the overlay has
+    // been hidden for its delay, and stages run one at a time in order, so a
+    // long absence ends with everything released while a quick toggle costs
+    // nothing. Showing stops the clock and reports the stage reached, which
+    // tells the overlay whether the browser has to be restored. The overlay
+    // does the releasing and reports the working set around each stage.
+    class MemoryManager {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+        explicit MemoryManager(const MemoryManagerOptions& options = MemoryManagerOptions());
+
+        // New delays apply to the current hide as well
+        void SetOptions(const MemoryManagerOptions& options) { m_options = options; }
+        const MemoryManagerOptions& GetOptions() const { return m_options; }
+
+        void OnHidden(TimePoint now);
+
+        // Returns the stage reached while hidden
+        MemoryStage OnShown();
+
+        bool IsHidden() const { return m_hidden; }
+        MemoryStage GetStage() const { return m_stage; }
+
+        // The next enabled stage while hidden (Active if none) and when it is due
+        MemoryStage GetNextStage() const;
+        TimePoint GetNextStageTime() const;
+
+        // Advance to the next stage if it is due and return it; Active if nothing is
+        MemoryStage TakeDueStage(TimePoint now);
+
+        // Working set before and after the overlay ran a stage
+        void RecordStage(MemoryStage stage, size_t bytesBefore, size_t bytesAfter);
+
+        // A suspended browser is being brought back. While still hidden (a
+        // hotkey woke it) the stages start over from now.
+        void BeginRestore(TimePoint now);
+        bool IsRestoring() const { return m_restoring; }
+        // Returns the restore time in milliseconds
+        double EndRestore(TimePoint now);
+        void CancelRestore() { m_restoring = false; }
+
+        const MemoryStats& GetStats() const { return m_stats; }
+
+        static const char* GetStageName(MemoryStage stage);
+
+    private:
+        std::chrono::milliseconds GetDelay(MemoryStage stage) const;
+
+    private:
+        MemoryManagerOptions m_options;
+        bool m_hidden;
+        TimePoint m_hiddenSince;
+        MemoryStage m_stage;
+
+        bool m_restoring;
+        TimePoint m_restoreStart;
+
+        MemoryStats m_stats;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,102 @@
+#include "MessageChannel.h"
+
+#include <chrono>
+#include <climits>
+#include <exception>
+
+namespace Nexile {
+
+    void MessageChannel::RegisterHandler(const std::string& channel, RequestHandler handler) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry& entry = m_entries[channel];
+        entry.handler = std::make_shared<RequestHandler>(std::move(handler));
+        entry.stats.channel = channel;
+    }
+
+    void MessageChannel::UnregisterHandler(const std::string& channel) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.erase(channel);
+    }
+
+    bool MessageChannel::HasHandler(const std::string& channel) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.find(channel) != m_entries.end();
+    }
+
+    bool MessageChannel::Dispatch(const std::string& channel, const nlohmann::json& payload,
+                                  nlohmann::json& reply, std::string& error) {
+        std::shared_ptr<RequestHandler> handler;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(channel);
+            if (it == m_entries.end()) {
+                error = "No handler for channel '" + channel + "'";
+                return false;
+            }
+            handler = it->second.handler;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = false;
+        try {
+            ok = (*handler)(payload, reply, error);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        if (!ok && error.empty()) {
+            error = "Request on channel '" + channel + "' failed";
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(channel);
+        if (it != m_entries.end()) {
+            ChannelStats& stats = it->second.stats;
+            stats.requests++;
+            if (!ok) stats.failures++;
+            stats.lastMs = elapsed;
+            if (elapsed > stats.maxMs) stats.maxMs = elapsed;
+            stats.averageMs += (elapsed - stats.averageMs) / static_cast<double>(stats.requests);
+        }
+        return ok;
+    }
+
+    ChannelReply MessageChannel::Answer(int requestId, const std::string& channel, const nlohmann::json& payload) {
+        ChannelReply reply;
+        reply.requestId = requestId;
+        reply.ok = Dispatch(channel, payload, reply.value, reply.error);
+        if (!reply.ok) {
+            reply.value = nullptr;
+        }
+        return reply;
+    }
+
+    std::vector<ChannelStats> MessageChannel::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<ChannelStats> stats;
+        stats.reserve(m_entries.size());
+        for (const auto& entry : m_entries) {
+            stats.push_back(entry.second.stats);
+        }
+        return stats;
+    }
+
+    int PendingRequests::Begin() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int requestId = m_nextId;
+        m_nextId = m_nextId == INT_MAX ? 1 : m_nextId + 1;
+        m_pending.insert(requestId);
+        return requestId;
+    }
+
+    bool PendingRequests::Settle(int requestId) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending.erase(requestId) > 0;
+    }
+
+    size_t PendingRequests::GetPendingCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending.size();
+    }
+
+} // namespace Nexile
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Handles one request; fills reply on success, error on failure
+    using RequestHandler = std::function<bool(const nlohmann::json& payload, nlohmann::json& reply, std::string& error)>;
+
+    // Counters of one request channel
+    struct ChannelStats {
+        std::string channel;
+        uint64_t requests = 0;
+        uint64_t failures = 0;          // Handler returned false or threw
+        double lastMs = 0.0;            // Handler time of the last request
+        double maxMs = 0.0;
+        double averageMs = 0.0;
+    };
+
+    // Answer to one request, tagged with the id the renderer gave it
+    struct ChannelReply {
+        int requestId = 0;
+        bool ok = false;
+        nlohmann::json value;           // Handler reply when ok
+        std::string error;              // Why it failed otherwise
+    };
+
+    // Routes typed page requests to C++ handlers by channel name.
+    //
+    // nexile.request(channel, payload) on the page sends the payload as CEF
+    // list/dictionary/binary values and gets back a promise. The browser side
+    // decodes the values straight into a json tree, runs the handler registered
+    // for the channel and sends the reply back the same way, tagged with the
+    // request id, so neither direction goes through JSON text.
+    class MessageChannel {
+    public:
+        // Register the handler for a channel, replacing any previous one
+        void RegisterHandler(const std::string& channel, RequestHandler handler);
+        void UnregisterHandler(const std::string& channel);
+        bool HasHandler(const std::string& channel) const;
+
+        // Run the handler for a channel (any thread). Handlers run outside the
+        // lock, so they may register further handlers.
+        bool Dispatch(const std::string& channel, const nlohmann::json& payload,
+                      nlohmann::json& reply, std::string& error);
+
+        // Dispatch a request and build the reply that goes back for it
+        ChannelReply Answer(int requestId, const std::string& channel, const nlohmann::json& payload);
+
+        std::vector<ChannelStats> GetStats() const;
+
+    private:
+        struct Entry {
+            std::shared_ptr<RequestHandler> handler;
+            ChannelStats stats;
+        };
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+    };
+
+    // Renderer side of the channel: the requests pages have in flight.
+    //
+    // Ids are handed out here rather than by each page, so they are unique
+    // across frames and reloads. A reply is delivered only while its id is
+    // pending; a reply for an unknown id, or one that arrives twice, is dropped
+    // before it is converted to page values.
+    class PendingRequests {
+    public:
+        // Record a new request and return its id (any thread)
+        int Begin();
+
+        // Take a request off the list; false if the id was not pending
+        bool Settle(int requestId);
+
+        size_t GetPendingCount() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_set<int> m_pending;
+        int m_nextId = 1;
+    };
+
+} // namespace Nexile
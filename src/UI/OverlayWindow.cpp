@@ -1,4 +1,7 @@
 ﻿#include "UI/OverlayWindow.h"
+#include "UI/AssetBundle.h"
+#include "UI/CefValueCodec.h"
+#include "UI/Resources.h"
 #include "Core/NexileApp.h"
 #include "Modules/ModuleInterface.h"
 #include "Input/HotkeyManager.h"
@@ -47,6 +50,12 @@ namespace Nexile {
             }
             #endif
         }
+
+        // Requests in flight from this renderer process's pages
+        PendingRequests& RendererRequests() {
+            static PendingRequests requests;
+            return requests;
+        }
     }
 
     // ================== CEF Base Reference Counting Helper ==================
@@ -87,23 +96,53 @@ namespace Nexile {
     // ================== Constructor/Destructor ==================
     OverlayWindow::OverlayWindow(NexileApp* app)
         : m_app(app), m_hwnd(nullptr), m_visible(false), m_clickThrough(true),
-          m_cefInitialized(false), m_browser(nullptr), m_client(nullptr),
+          m_cefInitialized(false), m_cefStarted(false), m_browser(nullptr), m_client(nullptr),
           m_life_span_handler(nullptr), m_load_handler(nullptr), m_display_handler(nullptr),
-          m_request_handler(nullptr), m_render_process_handler(nullptr), m_app_handler(nullptr),
-          m_context(nullptr), m_memoryOptimizationEnabled(true) {
+          m_request_handler(nullptr), m_render_process_handler(nullptr),
+          m_browser_process_handler(nullptr), m_render_handler(nullptr), m_app_handler(nullptr),
+          m_context(nullptr), m_pagePolicy(PagePolicy::WarmPool), m_nextSwitchToken(0),
+          m_shellLoaded(false), m_shellLoading(false), m_offscreen(false), m_osrDC(nullptr),
+          m_osrBitmap(nullptr), m_osrOldBitmap(nullptr), m_osrWidth(0), m_osrHeight(0),
+          m_osrFrameRate(0), m_osrTrackingMouse(false), m_memoryOptimizationEnabled(true) {
 
         m_windowRect = {0, 0, 1280, 960};
 
+#ifdef NEXILE_OFFSCREEN_RENDERING
+        // Windowless browser: paints are composited into the layered window and
+        // presented at most once per frame
+        m_offscreen = true;
+        m_compositor = std::make_unique<FrameCompositor>();
+        m_compositor->GetPacer().SetVisible(false, std::chrono::steady_clock::now());
+#endif
+
         // FIXED: Create shared context
-        m_context = new NexileHandlerContext{this, "", 0, ""};
+        m_context = new NexileHandlerContext{this};
+
+        // Overlay pages are served from memory: release builds use the bundle linked into
+        // the executable, dev builds read the HTML directory and pick up edits on disk
+        m_assetCache = std::make_unique<AssetCache>(Utils::CombinePath(Utils::GetModulePath(), "HTML"));
+#ifdef NEXILE_ASSET_WATCH
+        m_assetCache->StartWatching();
+#else
+        LoadEmbeddedAssetBundle();
+#endif
+
+        // Module updates are batched and run on the UI thread once per frame
+        m_scriptDispatcher = std::make_unique<ScriptDispatcher>(
+            [this](const std::string& script) { DispatchScript(script); },
+            [this]() { return m_hwnd && PostMessage(m_hwnd, WM_FLUSH_SCRIPTS, 0, 0); });
+        m_stateStore = std::make_unique<StateStore>(
+            [this]() { return m_hwnd && PostMessage(m_hwnd, WM_FLUSH_SCRIPTS, 0, 0); });
+
+        RegisterBuiltinChannels();
 
         LOG_INFO("Initializing Nexile Overlay with CEF C API");
         LogMemoryUsage("Pre-Init");
 
         RegisterWindowClass();
         InitializeWindow();
-        InitializeCEF();
 
+        // CEF itself is started by StartCEF on first use
         LogMemoryUsage("Post-Init");
     }
 
@@ -121,6 +160,8 @@ namespace Nexile {
             m_browser = nullptr;
         }
 
+        DestroyBackingStore();
+
         if (m_hwnd) {
             DestroyWindow(m_hwnd);
             m_hwnd = nullptr;
@@ -171,7 +212,10 @@ namespace Nexile {
             throw std::runtime_error("Failed to create overlay window");
         }
 
-        SetLayeredWindowAttributes(m_hwnd, RGB(0, 0, 0), 200, LWA_ALPHA);
+        // Off-screen frames carry their own alpha and go through UpdateLayeredWindow
+        if (!m_offscreen) {
+            SetLayeredWindowAttributes(m_hwnd, RGB(0, 0, 0), 200, LWA_ALPHA);
+        }
         SetClickThrough(m_clickThrough);
     }
 
@@ -194,6 +238,10 @@ namespace Nexile {
     }
 
     LRESULT OverlayWindow::HandleMessage(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp) {
+        if (m_offscreen && ForwardInput(msg, wp, lp)) {
+            return 0;
+        }
+
         switch (msg) {
             case WM_SIZE: {
                 if (m_browser) {
@@ -212,6 +260,33 @@ namespace Nexile {
                 Hide();
                 return 0;
 
+            case WM_FLUSH_SCRIPTS:
+                FlushScripts();
+                return 0;
+
+            case WM_TIMER:
+                if (wp == SCRIPT_FLUSH_TIMER) {
+                    KillTimer(hwnd, SCRIPT_FLUSH_TIMER);
+                    FlushScripts();
+                    return 0;
+                }
+                if (wp == OSR_PRESENT_TIMER) {
+                    KillTimer(hwnd, OSR_PRESENT_TIMER);
+                    PresentFrame();
+                    return 0;
+                }
+                if (wp == OSR_PACE_TIMER) {
+                    KillTimer(hwnd, OSR_PACE_TIMER);
+                    UpdateFrameRate();
+                    return 0;
+                }
+                if (wp == MEMORY_STAGE_TIMER) {
+                    KillTimer(hwnd, MEMORY_STAGE_TIMER);
+                    RunMemoryStages();
+                    return 0;
+                }
+                return DefWindowProc(hwnd, msg, wp, lp);
+
             case WM_DESTROY:
                 return 0;
 
@@ -223,12 +298,28 @@ namespace Nexile {
     void OverlayWindow::CenterWindow() {
         if (!m_hwnd) return;
 
-        int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-        int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-        int x = (screenWidth - 1280) / 2;
-        int y = (screenHeight - 960) / 2;
+        // The cached game rect; the window system is not asked here
+        WindowRect area = m_gameGeometry.rect;
+        if (!m_gameGeometry.IsTracking() || m_gameGeometry.minimized || area.IsEmpty()) {
+            area = { 0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN) };
+        }
+
+        int width = (std::min)(1280, area.Width());
+        int height = (std::min)(960, area.Height());
+        int x = area.left + (area.Width() - width) / 2;
+        int y = area.top + (area.Height() - height) / 2;
+
+        SetWindowPos(m_hwnd, HWND_TOPMOST, x, y, width, height, SWP_NOACTIVATE);
+    }
+
+    void OverlayWindow::FollowGameWindow(const WindowGeometry& geometry) {
+        m_gameGeometry = geometry;
 
-        SetWindowPos(m_hwnd, HWND_TOPMOST, x, y, 1280, 960, SWP_NOACTIVATE);
+        // Show places a hidden overlay; a visible one moves with the game and
+        // gets back on top when the game takes the foreground
+        if (m_hwnd && m_visible) {
+            CenterWindow();
+        }
     }
 
     void OverlayWindow::SetPosition(const RECT& rect) {
@@ -254,6 +345,25 @@ namespace Nexile {
     }
 
     // ================== CEF Initialization ==================
+    void OverlayWindow::StartCEF() {
+        if (m_cefStarted) return;
+        m_cefStarted = true;
+
+        LOG_INFO("Starting CEF");
+        m_cefStartTime = std::chrono::steady_clock::now();
+        try {
+            auto phase = m_app->GetStartupProfiler()->Phase("cef");
+            InitializeCEF();
+        } catch (const std::exception& e) {
+            LOG_ERROR("CEF startup failed: {}", e.what());
+            return;
+        }
+
+        LOG_INFO("CEF initialized in {}ms", std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - m_cefStartTime).count());
+        LogMemoryUsage("Post-CEF-Init");
+    }
+
     void OverlayWindow::InitializeCEF() {
         cef_main_args_t main_args = {};
         main_args.instance = m_app->GetInstanceHandle();
@@ -270,6 +380,7 @@ namespace Nexile {
         settings.no_sandbox = 1;
         settings.single_process = 1;
         settings.multi_threaded_message_loop = 0;
+        settings.external_message_pump = 1;     // Work is scheduled through the app's main loop
         settings.uncaught_exception_stack_size = 10;
         settings.persist_session_cookies = 0;
         settings.persist_user_preferences = 0;
@@ -278,27 +389,39 @@ namespace Nexile {
         // Set paths
         std::string cef_cache = Utils::CombinePath(Utils::GetAppDataPath(), "cef_cache");
         Utils::CreateDirectory(cef_cache);
-        cef_string_from_utf8(cef_cache.c_str(), cef_cache.length(), &settings.cache_path);
+        StdStringToCefString(cef_cache, &settings.cache_path);
 
         std::string cef_log = Utils::CombinePath(Utils::GetAppDataPath(), "cef.log");
-        cef_string_from_utf8(cef_log.c_str(), cef_log.length(), &settings.log_file);
+        StdStringToCefString(cef_log, &settings.log_file);
 
         std::string resource_dir = Utils::GetModulePath();
-        cef_string_from_utf8(resource_dir.c_str(), resource_dir.length(), &settings.resources_dir_path);
+        StdStringToCefString(resource_dir, &settings.resources_dir_path);
 
         std::string locales_dir = Utils::CombinePath(Utils::GetModulePath(), "locales");
-        cef_string_from_utf8(locales_dir.c_str(), locales_dir.length(), &settings.locales_dir_path);
+        StdStringToCefString(locales_dir, &settings.locales_dir_path);
 
+        StartupProfiler* profiler = m_app->GetStartupProfiler();
+        profiler->BeginPhase("create_handlers");
         CreateCEFHandlers();
+        profiler->EndPhase();
 
-        if (!cef_initialize(&main_args, &settings, &m_app_handler->handler, nullptr)) {
-            throw std::runtime_error("Failed to initialize CEF C API");
+        {
+            auto phase = profiler->Phase("cef_initialize");
+            if (!cef_initialize(&main_args, &settings, &m_app_handler->handler, nullptr)) {
+                throw std::runtime_error("Failed to initialize CEF C API");
+            }
         }
 
         m_cefInitialized = true;
         LOG_INFO("CEF C API initialized with memory constraints");
 
-        // Create browser
+        {
+            auto phase = profiler->Phase("browser_create");
+            CreateBrowser();
+        }
+    }
+
+    void OverlayWindow::CreateBrowser() {
         cef_window_info_t windowInfo = {};
         windowInfo.style = WS_CHILD | WS_VISIBLE;
         windowInfo.parent_window = m_hwnd;
@@ -306,6 +429,10 @@ namespace Nexile {
         windowInfo.y = 0;
         windowInfo.width = 1280;
         windowInfo.height = 960;
+        if (m_offscreen) {
+            // No child window; the overlay window is only used for input and screen info
+            windowInfo.windowless_rendering_enabled = 1;
+        }
 
         cef_browser_settings_t browserSettings = {};
         browserSettings.size = sizeof(cef_browser_settings_t);
@@ -324,12 +451,18 @@ namespace Nexile {
         browserSettings.application_cache = STATE_DISABLED;
         browserSettings.webgl = STATE_DISABLED;
         browserSettings.background_color = 0; // Transparent
+        if (m_offscreen) {
+            browserSettings.windowless_frame_rate = m_compositor->GetPacer().GetOptions().animatingFps;
+            m_osrFrameRate = browserSettings.windowless_frame_rate;
+        }
 
         cef_string_t url = {};
         std::string dataURL = "data:text/html;charset=utf-8,<html><body style='background:transparent;margin:0;padding:0;'></body></html>";
-        cef_string_from_utf8(dataURL.c_str(), dataURL.length(), &url);
+        StdStringToCefString(dataURL, &url);
 
+        // Creation itself is asynchronous; OnBrowserCreated marks when it is done
         if (!cef_browser_host_create_browser(&windowInfo, &m_client->client, &url, &browserSettings, nullptr, nullptr)) {
+            cef_string_clear(&url);
             throw std::runtime_error("Failed to create CEF browser");
         }
 
@@ -380,11 +513,28 @@ namespace Nexile {
         m_render_process_handler->handler.on_process_message_received = OnProcessMessageReceived;
         m_render_process_handler->context = m_context;
 
+        // Browser Process Handler
+        m_browser_process_handler = new NexileBrowserProcessHandler;
+        memset(m_browser_process_handler, 0, sizeof(NexileBrowserProcessHandler));
+        InitializeCefBase((cef_base_ref_counted_t*)&m_browser_process_handler->handler, sizeof(cef_browser_process_handler_t));
+        m_browser_process_handler->handler.on_schedule_message_pump_work = OnScheduleMessagePumpWork;
+        m_browser_process_handler->context = m_context;
+
+        // Render Handler
+        m_render_handler = new NexileRenderHandler;
+        memset(m_render_handler, 0, sizeof(NexileRenderHandler));
+        InitializeCefBase((cef_base_ref_counted_t*)&m_render_handler->handler, sizeof(cef_render_handler_t));
+        m_render_handler->handler.get_view_rect = OsrGetViewRect;
+        m_render_handler->handler.on_paint = OsrOnPaint;
+        m_render_handler->context = m_context;
+
         // App Handler
         m_app_handler = new NexileAppHandler;
         memset(m_app_handler, 0, sizeof(NexileAppHandler));
         InitializeCefBase((cef_base_ref_counted_t*)&m_app_handler->handler, sizeof(cef_app_t));
         m_app_handler->handler.get_render_process_handler = GetRenderProcessHandler;
+        m_app_handler->handler.get_browser_process_handler = GetBrowserProcessHandler;
+        m_app_handler->handler.on_before_command_line_processing = OnBeforeCommandLineProcessing;
         m_app_handler->context = m_context;
 
         // Client Handler
@@ -395,6 +545,10 @@ namespace Nexile {
         m_client->client.get_load_handler = GetLoadHandler;
         m_client->client.get_display_handler = GetDisplayHandler;
         m_client->client.get_request_handler = GetRequestHandler;
+        if (m_offscreen) {
+            m_client->client.get_render_handler = GetRenderHandler;
+        }
+        m_client->client.on_process_message_received = OnBrowserProcessMessageReceived;
         m_client->context = m_context;
 
         // FIXED: Register handlers in global registry for cleanup tracking
@@ -404,6 +558,8 @@ namespace Nexile {
         s_handlerRegistry[m_display_handler] = this;
         s_handlerRegistry[m_request_handler] = this;
         s_handlerRegistry[m_render_process_handler] = this;
+        s_handlerRegistry[m_browser_process_handler] = this;
+        s_handlerRegistry[m_render_handler] = this;
         s_handlerRegistry[m_app_handler] = this;
         s_handlerRegistry[m_client] = this;
     }
@@ -417,6 +573,8 @@ namespace Nexile {
             s_handlerRegistry.erase(m_display_handler);
             s_handlerRegistry.erase(m_request_handler);
             s_handlerRegistry.erase(m_render_process_handler);
+            s_handlerRegistry.erase(m_browser_process_handler);
+            s_handlerRegistry.erase(m_render_handler);
             s_handlerRegistry.erase(m_app_handler);
             s_handlerRegistry.erase(m_client);
         }
@@ -434,6 +592,8 @@ namespace Nexile {
         releaseHandler(&m_display_handler);
         releaseHandler(&m_request_handler);
         releaseHandler(&m_render_process_handler);
+        releaseHandler(&m_browser_process_handler);
+        releaseHandler(&m_render_handler);
         releaseHandler(&m_app_handler);
     }
 
@@ -462,7 +622,7 @@ namespace Nexile {
     void CEF_CALLBACK OverlayWindow::OnBeforeClose(cef_life_span_handler_t* self, cef_browser_t* browser) {
         NexileLifeSpanHandler* handler = reinterpret_cast<NexileLifeSpanHandler*>(self);
         if (handler && handler->context && handler->context->overlay) {
-            handler->context->overlay->OnBrowserClosing();
+            handler->context->overlay->OnBrowserClosing(browser);
         }
     }
 
@@ -475,10 +635,22 @@ namespace Nexile {
 
     void CEF_CALLBACK OverlayWindow::OnLoadEnd(cef_load_handler_t* self, cef_browser_t* browser,
                                               cef_frame_t* frame, int httpStatusCode) {
-        if (frame && frame->is_main(frame)) {
+        if (!frame) return;
+
+        if (frame->is_main(frame)) {
             LOG_INFO("CEF load completed with status: {}", httpStatusCode);
 
-            // Inject JavaScript bridge
+            NexileLoadHandler* handler = reinterpret_cast<NexileLoadHandler*>(self);
+            if (handler && handler->context && handler->context->overlay) {
+                cef_string_userfree_t url_ptr = frame->get_url(frame);
+                std::string url = CefStringToStdString(url_ptr);
+                if (url_ptr) cef_string_userfree_free(url_ptr);
+                handler->context->overlay->OnMainFrameLoaded(url);
+            }
+        }
+
+        // Inject JavaScript bridge into every frame; module pages run in shell iframes
+        {
             cef_string_t script = {};
             std::string bridgeScript = R"(
                 window.nexile = window.nexile || {};
@@ -487,6 +659,24 @@ namespace Nexile {
                         window.nexileBridge.postMessage(JSON.stringify(data));
                     }
                 };
+                window.nexile._pending = window.nexile._pending || new Map();
+                window.nexile.request = function(channel, payload) {
+                    return new Promise(function(resolve, reject) {
+                        if (!window.nexileBridge || !window.nexileBridge.request) {
+                            reject(new Error('Nexile bridge unavailable'));
+                            return;
+                        }
+                        // The reply comes back in a later task, after the id is stored
+                        const id = window.nexileBridge.request(String(channel), payload === undefined ? null : payload);
+                        window.nexile._pending.set(id, { resolve: resolve, reject: reject });
+                    });
+                };
+                window.nexile._settle = function(id, ok, value) {
+                    const pending = window.nexile._pending.get(id);
+                    if (!pending) return;
+                    window.nexile._pending.delete(id);
+                    if (ok) pending.resolve(value); else pending.reject(new Error(value));
+                };
                 window.chrome = window.chrome || {};
                 window.chrome.webview = {
                     postMessage: function(data) {
@@ -496,7 +686,7 @@ namespace Nexile {
                 console.log('Nexile bridge initialized');
             )";
 
-            cef_string_from_utf8(bridgeScript.c_str(), bridgeScript.length(), &script);
+            StdStringToCefString(bridgeScript, &script);
             cef_string_t url = {};
             frame->execute_java_script(frame, &script, &url, 0);
             cef_string_clear(&script);
@@ -534,6 +724,18 @@ namespace Nexile {
             memset(resHandler, 0, sizeof(NexileResourceHandler));
             InitializeCefBase((cef_base_ref_counted_t*)&resHandler->handler, sizeof(cef_resource_handler_t));
 
+            // Per-request state, freed together with the handler
+            resHandler->response = new AssetResponse();
+            resHandler->handler.base.release = [](cef_base_ref_counted_t* self) -> int {
+                if (--self->ref_count == 0) {
+                    NexileResourceHandler* handler = reinterpret_cast<NexileResourceHandler*>(self);
+                    delete handler->response;
+                    delete handler;
+                    return 1;
+                }
+                return 0;
+            };
+
             resHandler->handler.process_request = ResourceProcessRequest;
             resHandler->handler.get_response_headers = ResourceGetResponseHeaders;
             resHandler->handler.read_response = ResourceReadResponse;
@@ -553,7 +755,7 @@ namespace Nexile {
     int CEF_CALLBACK OverlayWindow::ResourceProcessRequest(cef_resource_handler_t* self,
                                                           cef_request_t* request, cef_callback_t* callback) {
         NexileResourceHandler* handler = reinterpret_cast<NexileResourceHandler*>(self);
-        if (!handler || !handler->context) return 0;
+        if (!handler || !handler->context || !handler->response) return 0;
 
         cef_string_userfree_t url_ptr = request->get_url(request);
         std::string url = CefStringToStdString(url_ptr);
@@ -564,17 +766,17 @@ namespace Nexile {
             filename = url.substr(9);
         }
 
-        // Load HTML content
-        std::string htmlPath = Utils::CombinePath(Utils::GetModulePath(), "HTML\\" + filename);
-        if (Utils::FileExists(htmlPath)) {
-            handler->context->currentResourceData = Utils::ReadTextFile(htmlPath);
-            handler->context->resourceMimeType = "text/html";
+        handler->requestStart = std::chrono::steady_clock::now();
+
+        // Serve from the asset cache (disk is only touched on the first request for a file)
+        AssetPtr asset = handler->context->overlay->m_assetCache->Get(filename);
+        if (!asset) {
+            LOG_WARNING("nexile:// resource not found: {}", filename);
+            handler->response->Begin(AssetCache::GetNotFound(), "", "");
         } else {
-            handler->context->currentResourceData = "<html><body><h1>404 Not Found</h1></body></html>";
-            handler->context->resourceMimeType = "text/html";
+            handler->response->Begin(asset, GetRequestHeader(request, "Range"), GetRequestHeader(request, "If-None-Match"));
         }
 
-        handler->context->resourceOffset = 0;
         callback->cont(callback);
         return 1;
     }
@@ -583,44 +785,66 @@ namespace Nexile {
                                                                cef_response_t* response, int64* response_length,
                                                                cef_string_t* redirectUrl) {
         NexileResourceHandler* handler = reinterpret_cast<NexileResourceHandler*>(self);
-        if (!handler || !handler->context) return;
+        if (!handler || !handler->response) return;
+
+        const AssetResponse& state = *handler->response;
+        const AssetPtr& asset = state.GetAsset();
+        if (!asset) return;
 
         cef_string_t mimeType = {};
-        cef_string_from_utf8(handler->context->resourceMimeType.c_str(),
-                           handler->context->resourceMimeType.length(), &mimeType);
+        StdStringToCefString(asset->mimeType, &mimeType);
         response->set_mime_type(response, &mimeType);
         cef_string_clear(&mimeType);
 
-        response->set_status(response, 200);
-        *response_length = handler->context->currentResourceData.length();
+        int status = asset == AssetCache::GetNotFound() ? 404 : state.GetStatus();
+        response->set_status(response, status);
+
+        if (status != 404) {
+            // Let the page revalidate with If-None-Match instead of refetching
+            SetResponseHeader(response, "ETag", asset->etag);
+            SetResponseHeader(response, "Cache-Control", "no-cache");
+            SetResponseHeader(response, "Accept-Ranges", "bytes");
+        }
+        if (!state.GetContentRange().empty()) {
+            SetResponseHeader(response, "Content-Range", state.GetContentRange());
+        }
+
+        *response_length = static_cast<int64>(state.GetContentLength());
     }
 
     int CEF_CALLBACK OverlayWindow::ResourceReadResponse(cef_resource_handler_t* self, void* data_out,
                                                         int bytes_to_read, int* bytes_read,
                                                         cef_callback_t* callback) {
         NexileResourceHandler* handler = reinterpret_cast<NexileResourceHandler*>(self);
-        if (!handler || !handler->context) {
-            *bytes_read = 0;
+        *bytes_read = 0;
+        if (!handler || !handler->response || bytes_to_read <= 0) {
             return 0;
         }
 
-        *bytes_read = 0;
-        if (handler->context->resourceOffset < handler->context->currentResourceData.length()) {
-            int transfer_size = std::min(bytes_to_read,
-                                       static_cast<int>(handler->context->currentResourceData.length() - handler->context->resourceOffset));
-            memcpy(data_out, handler->context->currentResourceData.c_str() + handler->context->resourceOffset, transfer_size);
-            handler->context->resourceOffset += transfer_size;
-            *bytes_read = transfer_size;
-            return 1;
+        bool firstChunk = handler->requestStart != std::chrono::steady_clock::time_point();
+
+        // Copy the next chunk straight from the asset source
+        size_t transferred = handler->response->Read(data_out, static_cast<size_t>(bytes_to_read));
+        if (transferred == 0) {
+            return 0;
         }
-        return 0;
+
+        if (firstChunk) {
+            LOG_DEBUG("nexile://{} first byte after {}us", handler->response->GetAsset()->path,
+                      std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - handler->requestStart).count());
+            handler->requestStart = std::chrono::steady_clock::time_point();
+        }
+
+        *bytes_read = static_cast<int>(transferred);
+        return 1;
     }
 
     void CEF_CALLBACK OverlayWindow::ResourceCancel(cef_resource_handler_t* self) {
         NexileResourceHandler* handler = reinterpret_cast<NexileResourceHandler*>(self);
-        if (handler && handler->context) {
-            handler->context->currentResourceData.clear();
-            handler->context->currentResourceData.shrink_to_fit();
+        if (handler && handler->response) {
+            // Only drops this request's reference; the buffer stays in the cache
+            handler->response->Cancel();
         }
     }
 
@@ -666,6 +890,58 @@ namespace Nexile {
         return nullptr;
     }
 
+    cef_render_handler_t* CEF_CALLBACK OverlayWindow::GetRenderHandler(cef_client_t* self) {
+        NexileClient* client = reinterpret_cast<NexileClient*>(self);
+        if (client && client->context && client->context->overlay && client->context->overlay->m_render_handler) {
+            client->context->overlay->m_render_handler->handler.base.add_ref(
+                (cef_base_ref_counted_t*)&client->context->overlay->m_render_handler->handler);
+            return &client->context->overlay->m_render_handler->handler;
+        }
+        return nullptr;
+    }
+
+    int CEF_CALLBACK OverlayWindow::OnBrowserProcessMessageReceived(cef_client_t* self,
+                                                                    cef_browser_t* browser, cef_frame_t* frame,
+                                                                    cef_process_id_t source_process,
+                                                                    cef_process_message_t* message) {
+        NexileClient* client = reinterpret_cast<NexileClient*>(self);
+        if (!client || !client->context || !client->context->overlay) {
+            return 0;
+        }
+        OverlayWindow* overlay = client->context->overlay;
+
+        cef_string_userfree_t name_ptr = message->get_name(message);
+        std::string name = CefStringToStdString(name_ptr);
+        cef_string_userfree_free(name_ptr);
+
+        int handled = 0;
+        cef_list_value_t* args = message->get_argument_list(message);
+
+        if (name == "nexile_message" && args->get_size(args) > 0) {
+            cef_string_userfree_t msg_ptr = args->get_string(args, 0);
+            std::string msg = CefStringToStdString(msg_ptr);
+            cef_string_userfree_free(msg_ptr);
+
+            overlay->HandleWebMessage(msg);
+            handled = 1;
+        }
+        else if (name == "nexile_request" && args->get_size(args) >= 3) {
+            int requestId = args->get_int(args, 0);
+
+            cef_string_userfree_t channel_ptr = args->get_string(args, 1);
+            std::string channel = CefStringToStdString(channel_ptr);
+            cef_string_userfree_free(channel_ptr);
+
+            cef_value_t* payload = args->get_value(args, 2);
+            overlay->HandleRequest(frame, requestId, channel, payload);
+            payload->base.release((cef_base_ref_counted_t*)payload);
+            handled = 1;
+        }
+
+        args->base.release((cef_base_ref_counted_t*)args);
+        return handled;
+    }
+
     cef_render_process_handler_t* CEF_CALLBACK OverlayWindow::GetRenderProcessHandler(cef_app_t* self) {
         NexileAppHandler* appHandler = reinterpret_cast<NexileAppHandler*>(self);
         if (appHandler && appHandler->context && appHandler->context->overlay) {
@@ -676,6 +952,74 @@ namespace Nexile {
         return nullptr;
     }
 
+    void CEF_CALLBACK OverlayWindow::OnBeforeCommandLineProcessing(cef_app_t* self, const cef_string_t* process_type,
+                                                                   cef_command_line_t* command_line) {
+        if (!command_line) return;
+
+        // Expose window.gc so a hidden overlay can collect garbage on demand
+        cef_string_t name = {};
+        cef_string_t value = {};
+        StdStringToCefString("js-flags", &name);
+        StdStringToCefString("--expose-gc", &value);
+        command_line->append_switch_with_value(command_line, &name, &value);
+        cef_string_clear(&name);
+        cef_string_clear(&value);
+    }
+
+    cef_browser_process_handler_t* CEF_CALLBACK OverlayWindow::GetBrowserProcessHandler(cef_app_t* self) {
+        NexileAppHandler* appHandler = reinterpret_cast<NexileAppHandler*>(self);
+        if (appHandler && appHandler->context && appHandler->context->overlay) {
+            appHandler->context->overlay->m_browser_process_handler->handler.base.add_ref(
+                (cef_base_ref_counted_t*)&appHandler->context->overlay->m_browser_process_handler->handler);
+            return &appHandler->context->overlay->m_browser_process_handler->handler;
+        }
+        return nullptr;
+    }
+
+    void CEF_CALLBACK OverlayWindow::OnScheduleMessagePumpWork(cef_browser_process_handler_t* self, int64 delay_ms) {
+        // May be called on any thread; the scheduler wakes the main loop if needed
+        NexileBrowserProcessHandler* handler = reinterpret_cast<NexileBrowserProcessHandler*>(self);
+        if (handler && handler->context && handler->context->overlay && handler->context->overlay->m_app) {
+            Scheduler* scheduler = handler->context->overlay->m_app->GetScheduler();
+            if (scheduler) {
+                scheduler->SchedulePumpWork(delay_ms);
+            }
+        }
+    }
+
+    // ================== Render Handler Callbacks ==================
+
+    void CEF_CALLBACK OverlayWindow::OsrGetViewRect(cef_render_handler_t* self, cef_browser_t* browser, cef_rect_t* rect) {
+        rect->x = 0;
+        rect->y = 0;
+        rect->width = 1280;
+        rect->height = 960;
+
+        NexileRenderHandler* handler = reinterpret_cast<NexileRenderHandler*>(self);
+        if (handler && handler->context && handler->context->overlay && handler->context->overlay->m_hwnd) {
+            RECT client;
+            if (GetClientRect(handler->context->overlay->m_hwnd, &client) && client.right > 0 && client.bottom > 0) {
+                rect->width = client.right;
+                rect->height = client.bottom;
+            }
+        }
+    }
+
+    void CEF_CALLBACK OverlayWindow::OsrOnPaint(cef_render_handler_t* self, cef_browser_t* browser,
+                                                cef_paint_element_type_t type, size_t dirtyRectsCount,
+                                                cef_rect_t const* dirtyRects, const void* buffer,
+                                                int width, int height) {
+        // Popups (select dropdowns) are not used by the overlay pages
+        if (type != PET_VIEW) {
+            return;
+        }
+
+        NexileRenderHandler* handler = reinterpret_cast<NexileRenderHandler*>(self);
+        if (handler && handler->context && handler->context->overlay) {
+            handler->context->overlay->OnOffscreenPaint(dirtyRects, dirtyRectsCount, buffer, width, height);
+        }
+    }
+
     // ================== V8 and Process Message Handling ==================
 
     void CEF_CALLBACK OverlayWindow::OnContextCreated(cef_render_process_handler_t* self,
@@ -694,22 +1038,30 @@ namespace Nexile {
         v8Handler->context = renderHandler->context;
 
         cef_string_t funcName = {};
-        cef_string_from_utf8("postMessage", 11, &funcName);
+        StdStringToCefString("postMessage", &funcName);
         cef_v8value_t* postMessageFunc = cef_v8value_create_function(&funcName, &v8Handler->handler);
         cef_string_clear(&funcName);
 
         cef_string_t bridgeProperty = {};
-        cef_string_from_utf8("postMessage", 11, &bridgeProperty);
+        StdStringToCefString("postMessage", &bridgeProperty);
         nexileBridge->set_value_bykey(nexileBridge, &bridgeProperty, postMessageFunc, V8_PROPERTY_ATTRIBUTE_NONE);
         cef_string_clear(&bridgeProperty);
 
+        // request(channel, payload) -> id: typed request, answered through nexile._settle
+        cef_string_t requestName = {};
+        StdStringToCefString("request", &requestName);
+        cef_v8value_t* requestFunc = cef_v8value_create_function(&requestName, &v8Handler->handler);
+        nexileBridge->set_value_bykey(nexileBridge, &requestName, requestFunc, V8_PROPERTY_ATTRIBUTE_NONE);
+        cef_string_clear(&requestName);
+
         cef_string_t windowProperty = {};
-        cef_string_from_utf8("nexileBridge", 12, &windowProperty);
+        StdStringToCefString("nexileBridge", &windowProperty);
         window->set_value_bykey(window, &windowProperty, nexileBridge, V8_PROPERTY_ATTRIBUTE_NONE);
         cef_string_clear(&windowProperty);
 
         // Cleanup references
         postMessageFunc->base.release((cef_base_ref_counted_t*)postMessageFunc);
+        requestFunc->base.release((cef_base_ref_counted_t*)requestFunc);
         nexileBridge->base.release((cef_base_ref_counted_t*)nexileBridge);
         window->base.release((cef_base_ref_counted_t*)window);
     }
@@ -732,8 +1084,7 @@ namespace Nexile {
                 // Handle message in overlay
                 NexileRenderProcessHandler* handler = reinterpret_cast<NexileRenderProcessHandler*>(self);
                 if (handler && handler->context && handler->context->overlay) {
-                    std::wstring wmsg = Utils::StringToWideString(msg);
-                    handler->context->overlay->HandleWebMessage(wmsg);
+                    handler->context->overlay->HandleWebMessage(msg);
                 }
 
                 args->base.release((cef_base_ref_counted_t*)args);
@@ -741,9 +1092,66 @@ namespace Nexile {
             }
             args->base.release((cef_base_ref_counted_t*)args);
         }
+        else if (name == "nexile_reply") {
+            cef_list_value_t* args = message->get_argument_list(message);
+            if (args->get_size(args) >= 3) {
+                SettleRequest(frame, args);
+            }
+            args->base.release((cef_base_ref_counted_t*)args);
+            return 1;
+        }
         return 0;
     }
 
+    void OverlayWindow::SettleRequest(cef_frame_t* frame, cef_list_value_t* args) {
+        // Only replies to requests still in flight reach the page
+        if (!RendererRequests().Settle(args->get_int(args, 0))) {
+            return;
+        }
+
+        cef_v8context_t* context = frame ? frame->get_v8context(frame) : nullptr;
+        if (!context) return;
+
+        if (context->enter(context)) {
+            cef_v8value_t* window = context->get_global(context);
+
+            cef_string_t key = {};
+            StdStringToCefString("nexile", &key);
+            cef_v8value_t* nexile = window->get_value_bykey(window, &key);
+            cef_string_clear(&key);
+
+            cef_v8value_t* settle = nullptr;
+            if (nexile && nexile->is_object(nexile)) {
+                StdStringToCefString("_settle", &key);
+                settle = nexile->get_value_bykey(nexile, &key);
+                cef_string_clear(&key);
+            }
+
+            if (settle && settle->is_function(settle)) {
+                cef_value_t* payload = args->get_value(args, 2);
+                cef_v8value_t* settleArgs[3] = {
+                    cef_v8value_create_int(args->get_int(args, 0)),
+                    cef_v8value_create_bool(args->get_bool(args, 1)),
+                    CefValueCodec::ToV8(payload)
+                };
+                payload->base.release((cef_base_ref_counted_t*)payload);
+
+                cef_v8value_t* result = settle->execute_function(settle, nullptr, 3, settleArgs);
+                if (result) result->base.release((cef_base_ref_counted_t*)result);
+                for (cef_v8value_t* arg : settleArgs) {
+                    arg->base.release((cef_base_ref_counted_t*)arg);
+                }
+            }
+
+            if (settle) settle->base.release((cef_base_ref_counted_t*)settle);
+            if (nexile) nexile->base.release((cef_base_ref_counted_t*)nexile);
+            window->base.release((cef_base_ref_counted_t*)window);
+            context->exit(context);
+        }
+
+        context->base.release((cef_base_ref_counted_t*)context);
+    }
+
     int CEF_CALLBACK OverlayWindow::V8Execute(cef_v8handler_t* self, const cef_string_t* name,
                                              cef_v8value_t* object, size_t argumentsCount,
                                              cef_v8value_t* const* arguments, cef_v8value_t** retval,
@@ -761,13 +1169,13 @@ namespace Nexile {
             cef_frame_t* frame = context->get_frame(context);
 
             cef_string_t msgName = {};
-            cef_string_from_utf8("nexile_message", 14, &msgName);
+            StdStringToCefString("nexile_message", &msgName);
             cef_process_message_t* msg = cef_process_message_create(&msgName);
             cef_string_clear(&msgName);
 
             cef_list_value_t* args = msg->get_argument_list(msg);
             cef_string_t messageStr = {};
-            cef_string_from_utf8(message.c_str(), message.length(), &messageStr);
+            StdStringToCefString(message, &messageStr);
             args->set_string(args, 0, &messageStr);
             cef_string_clear(&messageStr);
 
@@ -783,35 +1191,95 @@ namespace Nexile {
             *retval = cef_v8value_create_bool(1);
             return 1;
         }
+
+        if (nameStr == "request" && argumentsCount == 2 && arguments[0]->is_string(arguments[0])) {
+            cef_v8context_t* context = cef_v8context_get_current_context();
+            cef_frame_t* frame = context->get_frame(context);
+
+            cef_string_t msgName = {};
+            StdStringToCefString("nexile_request", &msgName);
+            cef_process_message_t* msg = cef_process_message_create(&msgName);
+            cef_string_clear(&msgName);
+
+            // The payload goes over as structured values, not JSON text
+            int requestId = RendererRequests().Begin();
+            cef_list_value_t* args = msg->get_argument_list(msg);
+            args->set_int(args, 0, requestId);
+            cef_string_userfree_t channel = arguments[0]->get_string_value(arguments[0]);
+            args->set_string(args, 1, channel);
+            if (channel) cef_string_userfree_free(channel);
+            cef_value_t* payload = CefValueCodec::FromV8(arguments[1]);
+            args->set_value(args, 2, payload);
+            payload->base.release((cef_base_ref_counted_t*)payload);
+
+            frame->send_process_message(frame, PID_BROWSER, msg);
+
+            args->base.release((cef_base_ref_counted_t*)args);
+            msg->base.release((cef_base_ref_counted_t*)msg);
+            frame->base.release((cef_base_ref_counted_t*)frame);
+            context->base.release((cef_base_ref_counted_t*)context);
+
+            *retval = cef_v8value_create_int(requestId);
+            return 1;
+        }
         return 0;
     }
 
     // ================== String Conversion Helpers ==================
 
     std::string OverlayWindow::CefStringToStdString(const cef_string_t* cef_str) {
-        if (!cef_str || !cef_str->str) return "";
-        std::wstring wstr(cef_str->str, cef_str->length);
-        return Utils::WideStringToString(wstr);
+        return CefValueCodec::ToStdString(cef_str);
     }
 
     void OverlayWindow::StdStringToCefString(const std::string& std_str, cef_string_t* cef_str) {
-        std::wstring wstr = Utils::StringToWideString(std_str);
-        cef_string_from_wide(wstr.c_str(), wstr.length(), cef_str);
+        CefValueCodec::SetString(std_str, cef_str);
     }
 
     void OverlayWindow::FreeCefString(cef_string_t* cef_str) {
         cef_string_clear(cef_str);
     }
 
+    std::string OverlayWindow::GetRequestHeader(cef_request_t* request, const std::string& name) {
+        cef_string_t key = {};
+        StdStringToCefString(name, &key);
+        cef_string_userfree_t value = request->get_header_by_name(request, &key);
+        FreeCefString(&key);
+
+        std::string result = CefStringToStdString(value);
+        if (value) {
+            cef_string_userfree_free(value);
+        }
+        return result;
+    }
+
+    void OverlayWindow::SetResponseHeader(cef_response_t* response, const std::string& name, const std::string& value) {
+        cef_string_t key = {};
+        cef_string_t text = {};
+        StdStringToCefString(name, &key);
+        StdStringToCefString(value, &text);
+        response->set_header_by_name(response, &key, &text, 1);
+        FreeCefString(&key);
+        FreeCefString(&text);
+    }
+
     // ================== Public API Implementation ==================
 
     void OverlayWindow::Navigate(const std::wstring& uri) {
+        // Leaving the shell unloads every pooled page
+        m_shellLoaded = false;
+        m_shellLoading = false;
+        m_pendingShellScript.clear();
+        m_pagePool.Clear();
+
+        NavigateMainFrame(Utils::WideStringToString(uri));
+    }
+
+    void OverlayWindow::NavigateMainFrame(const std::string& urlStr) {
         if (m_browser) {
             auto frame = m_browser->get_main_frame(m_browser);
             if (frame) {
                 cef_string_t url = {};
-                std::string urlStr = Utils::WideStringToString(uri);
-                cef_string_from_utf8(urlStr.c_str(), urlStr.length(), &url);
+                StdStringToCefString(urlStr, &url);
 
                 frame->load_url(frame, &url);
                 cef_string_clear(&url);
@@ -820,11 +1288,50 @@ namespace Nexile {
                 LOG_INFO("Navigating to: {}", urlStr);
             }
         } else {
-            LOG_ERROR("Cannot navigate: browser not initialized");
+            // The latest request wins once the browser is up
+            m_pendingUrl = urlStr;
+            LOG_DEBUG("Browser not ready, {} loads once it is", urlStr);
+            StartCEF();
         }
     }
 
-    void OverlayWindow::ExecuteScript(const std::wstring& script) {
+    void OverlayWindow::ExecuteScript(const std::wstring& script, const std::string& channel) {
+        m_scriptDispatcher->Post(Utils::WideStringToString(script), channel);
+    }
+
+    void OverlayWindow::ExecuteScript(const std::string& script, const std::string& channel) {
+        m_scriptDispatcher->Post(script, channel);
+    }
+
+    void OverlayWindow::FlushScripts() {
+        // Scripts stay queued until the browser exists; OnBrowserCreated flushes them
+        if (!m_browser) return;
+
+        // State changes since the last tick ride along as one script. It never
+        // coalesces, so consecutive deltas reach the page in order.
+        std::string deltas = m_stateStore->TakeDeltaScript();
+        if (!deltas.empty()) {
+            m_scriptDispatcher->Post(std::move(deltas));
+        }
+
+        uint64_t batches = m_scriptDispatcher->GetStats().batches;
+
+        auto wait = m_scriptDispatcher->Flush();
+        if (wait > ScriptDispatcher::Clock::duration::zero()) {
+            // Called again within the same frame: collect until the frame is over
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(wait).count();
+            SetTimer(m_hwnd, SCRIPT_FLUSH_TIMER, static_cast<UINT>(ms > 0 ? ms : 1), nullptr);
+            return;
+        }
+
+        ScriptDispatchStats stats = m_scriptDispatcher->GetStats();
+        if (stats.batches != batches) {
+            LOG_DEBUG("Script batch dispatched {}ms after posting (average {}ms, max {}ms, {} of {} scripts coalesced)",
+                      stats.lastLatencyMs, stats.averageLatencyMs, stats.maxLatencyMs, stats.coalesced, stats.posted);
+        }
+    }
+
+    void OverlayWindow::DispatchScript(const std::string& script) {
         if (!m_browser) {
             LOG_ERROR("Cannot execute script: browser not initialized");
             return;
@@ -833,8 +1340,7 @@ namespace Nexile {
         auto frame = m_browser->get_main_frame(m_browser);
         if (frame) {
             cef_string_t scriptStr = {};
-            std::string scriptUtf8 = Utils::WideStringToString(script);
-            cef_string_from_utf8(scriptUtf8.c_str(), scriptUtf8.length(), &scriptStr);
+            StdStringToCefString(script, &scriptStr);
 
             cef_string_t url = {};
             frame->execute_java_script(frame, &scriptStr, &url, 0);
@@ -842,18 +1348,53 @@ namespace Nexile {
             cef_string_clear(&scriptStr);
             frame->base.release((cef_base_ref_counted_t*)frame);
         }
+
+        // Page updates usually repaint; raise the frame rate before they land
+        NotifyRenderActivity();
     }
 
     void OverlayWindow::OnBrowserCreated(cef_browser_t* browser) {
         m_browser = browser;
         m_browser->base.add_ref((cef_base_ref_counted_t*)m_browser);
 
-        LoadWelcomePage();
-        LOG_INFO("CEF browser created successfully via C API");
-        LogMemoryUsage("Browser-Created");
+        // Off-screen browsers start at full rate; drop to the pacer's rate (hidden until shown)
+        UpdateFrameRate();
+
+        // Load whatever was asked for while CEF was starting
+        if (!m_pendingUrl.empty()) {
+            std::string url = std::move(m_pendingUrl);
+            m_pendingUrl.clear();
+            NavigateMainFrame(url);
+        } else {
+            LoadWelcomePage();
+        }
+        FlushScripts();
+
+        bool restored = m_memoryManager.IsRestoring();
+        if (restored) {
+            LogMemoryUsage("Browser-Restored");
+        } else {
+            LOG_INFO("CEF browser created {}ms after CEF start", std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - m_cefStartTime).count());
+            m_app->GetStartupProfiler()->Mark("browser_created");
+            LogMemoryUsage("Browser-Created");
+        }
+
+        // Hotkeys pressed while there was no browser are replayed from here,
+        // after a restore as much as at startup
+        if (m_readyCallback) {
+            m_readyCallback(restored);
+        }
     }
 
-    void OverlayWindow::OnBrowserClosing() {
+    void OverlayWindow::OnBrowserClosing(cef_browser_t* browser) {
+        // A browser closed by SuspendBrowser can finish closing after
+        // RestoreBrowser created its replacement; that one stays
+        if (m_browser && browser && browser->get_identifier(browser) != m_browser->get_identifier(m_browser)) {
+            LOG_DEBUG("Suspended CEF browser closed");
+            return;
+        }
+
         if (m_browser) {
             m_browser->base.release((cef_base_ref_counted_t*)m_browser);
             m_browser = nullptr;
@@ -868,8 +1409,22 @@ namespace Nexile {
         }
 
         m_visible = true;
+        KillTimer(m_hwnd, MEMORY_STAGE_TIMER);
+        // Trimming now would only page the overlay back in
+        FinishMemoryStages(false);
+        MemoryStage reached = m_memoryManager.OnShown();
+
+        StartCEF();
+        if (reached == MemoryStage::Suspended) {
+            RestoreBrowser();
+        }
         CenterWindow();
         ShowWindow(m_hwnd, SW_SHOWNOACTIVATE);
+
+        if (m_compositor) {
+            m_compositor->GetPacer().SetVisible(true, std::chrono::steady_clock::now());
+            UpdateFrameRate();
+        }
         LOG_INFO("Overlay window shown");
         LogMemoryUsage("Window-Shown");
     }
@@ -883,9 +1438,17 @@ namespace Nexile {
         m_visible = false;
         ShowWindow(m_hwnd, SW_HIDE);
 
-        // Memory cleanup on hide
+        if (m_compositor) {
+            // CEF stops painting while hidden
+            m_compositor->GetPacer().SetVisible(false, std::chrono::steady_clock::now());
+            KillTimer(m_hwnd, OSR_PRESENT_TIMER);
+            UpdateFrameRate();
+        }
+
+        // Memory is given back in stages the longer the overlay stays hidden
         if (m_memoryOptimizationEnabled) {
-            ExecuteScript(L"if(window.gc) window.gc();");
+            m_memoryManager.OnHidden(std::chrono::steady_clock::now());
+            ScheduleMemoryStage();
         }
 
         LOG_INFO("Overlay window hidden");
@@ -894,30 +1457,381 @@ namespace Nexile {
 
     // ================== Helper Functions ==================
 
+    void OverlayWindow::LoadEmbeddedAssetBundle() {
+        HRSRC resource = FindResourceW(nullptr, MAKEINTRESOURCEW(IDR_ASSET_BUNDLE), RT_RCDATA);
+        HGLOBAL handle = resource ? LoadResource(nullptr, resource) : nullptr;
+        const void* data = handle ? LockResource(handle) : nullptr;
+        if (!data) {
+            LOG_WARNING("No embedded asset bundle, serving overlay HTML from disk");
+            return;
+        }
+
+        // Resource memory stays mapped for the lifetime of the process
+        auto bundle = std::make_shared<AssetBundle>();
+        std::string error;
+        if (!bundle->OpenMemory(data, SizeofResource(nullptr, resource), error)) {
+            LOG_ERROR("Embedded asset bundle is invalid ({}), serving overlay HTML from disk", error);
+            return;
+        }
+
+        LOG_INFO("Serving {} overlay assets from the embedded bundle", bundle->GetEntryCount());
+        m_assetCache->SetBundle(std::move(bundle));
+    }
+
     std::string OverlayWindow::LoadHTMLResource(const std::string& filename) {
-        std::string htmlPath = Utils::CombinePath(Utils::GetModulePath(), "HTML\\" + filename);
-        if (Utils::FileExists(htmlPath)) {
-            return Utils::ReadTextFile(htmlPath);
+        AssetPtr asset = m_assetCache->Get(filename);
+        if (!asset) {
+            return "";
+        }
+        if (asset->IsStreamed()) {
+            return Utils::ReadTextFile(asset->streamPath.u8string());
         }
-        return "";
+        return std::string(asset->GetBytes());
+    }
+
+    std::string OverlayWindow::RegisterModuleUI(const std::shared_ptr<IModule>& module) {
+        std::string moduleId = module->GetModuleID();
+        std::string path = "module/" + moduleId + "/index.html";
+
+        AssetPtr asset = m_assetCache->RegisterVirtual(path, module->GetModuleUIHTML());
+        if (!asset || asset->size == 0) {
+            m_assetCache->UnregisterVirtual(path);
+            m_moduleUIUrls.erase(moduleId);
+            return "";
+        }
+
+        // The version in the query makes a changed document a new URL, so warm
+        // pages reload it while unchanged ones keep revalidating by ETag
+        std::string url = "nexile://" + asset->path + "?v=" + asset->etag.substr(1, asset->etag.size() - 2);
+        m_moduleUIUrls[moduleId] = url;
+        LOG_DEBUG("Registered UI of module {} ({} bytes) at {}", moduleId, asset->size, url);
+        return url;
+    }
+
+    void OverlayWindow::UnregisterModuleUI(const std::string& moduleId) {
+        m_assetCache->UnregisterVirtual("module/" + moduleId + "/index.html");
+        m_moduleUIUrls.erase(moduleId);
+    }
+
+    void OverlayWindow::RegisterAction(const std::string& owner, const std::string& action, ActionHandler handler) {
+        m_actionRouter.Register(owner, action, std::move(handler));
+    }
+
+    void OverlayWindow::UnregisterActions(const std::string& owner) {
+        m_actionRouter.UnregisterOwner(owner);
+    }
+
+    void OverlayWindow::RegisterBuiltinChannels() {
+        // Echo channel for measuring bridge round trips from the page
+        m_messageChannel.RegisterHandler("bridge.echo",
+            [](const nlohmann::json& payload, nlohmann::json& reply, std::string&) {
+                reply = payload;
+                return true;
+            });
+
+        // The shell reports when a page has become visible
+        m_messageChannel.RegisterHandler("shell.shown",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string&) {
+                OnPageShown(payload.value("view", ""), payload.value("token", static_cast<uint64_t>(0)),
+                    payload.value("warm", false));
+                reply = true;
+                return true;
+            });
+
+        // Switch instrumentation for both policies, and policy selection for comparing them
+        m_messageChannel.RegisterHandler("shell.stats",
+            [this](const nlohmann::json&, nlohmann::json& reply, std::string&) {
+                auto toJson = [](const PageSwitchStats& stats) {
+                    return nlohmann::json{
+                        {"switches", stats.switches},
+                        {"warmSwitches", stats.warmSwitches},
+                        {"evictions", stats.evictions},
+                        {"lastLatencyMs", stats.lastLatencyMs},
+                        {"averageLatencyMs", stats.averageLatencyMs},
+                        {"maxLatencyMs", stats.maxLatencyMs},
+                        {"averageWarmLatencyMs", stats.averageWarmLatencyMs},
+                        {"averageColdLatencyMs", stats.averageColdLatencyMs},
+                        {"lastWorkingSetMB", stats.lastWorkingSetBytes / (1024.0 * 1024.0)},
+                        {"peakWorkingSetMB", stats.peakWorkingSetBytes / (1024.0 * 1024.0)}
+                    };
+                };
+                reply = {
+                    {"policy", m_pagePolicy == PagePolicy::WarmPool ? "pool" : "navigate"},
+                    {"pages", m_pagePool.GetPages()},
+                    {"poolMB", m_pagePool.GetMemoryUsage() / (1024.0 * 1024.0)},
+                    {"navigate", toJson(m_pagePool.GetStats(PagePolicy::Navigate))},
+                    {"pool", toJson(m_pagePool.GetStats(PagePolicy::WarmPool))}
+                };
+                return true;
+            });
+
+        m_messageChannel.RegisterHandler("shell.policy",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string& error) {
+                std::string policy = payload.value("policy", "");
+                if (policy == "pool") {
+                    SetPagePolicy(PagePolicy::WarmPool);
+                } else if (policy == "navigate") {
+                    SetPagePolicy(PagePolicy::Navigate);
+                } else {
+                    error = "Unknown page policy '" + policy + "'";
+                    return false;
+                }
+                reply = policy;
+                return true;
+            });
+
+        // Pages fetch a snapshot of the state keys they show, then get deltas
+        m_messageChannel.RegisterHandler("state.subscribe",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string& error) {
+                const nlohmann::json& keys = payload.is_object() && payload.contains("keys") ? payload["keys"] : payload;
+                if (!keys.is_array()) {
+                    error = "state.subscribe expects { keys: [...] }";
+                    return false;
+                }
+
+                std::vector<std::string> names;
+                for (const auto& key : keys) {
+                    if (key.is_string()) {
+                        names.push_back(key.get<std::string>());
+                    }
+                }
+                reply = m_stateStore->Subscribe(names);
+                return true;
+            });
+
+        m_messageChannel.RegisterHandler("state.stats",
+            [this](const nlohmann::json&, nlohmann::json& reply, std::string&) {
+                StateStoreStats stats = m_stateStore->GetStats();
+                reply = {
+                    {"sets", stats.sets},
+                    {"changes", stats.changes},
+                    {"deliveries", stats.deliveries},
+                    {"deltas", stats.deltas},
+                    {"ops", stats.ops},
+                    {"deltaBytes", stats.deltaBytes},
+                    {"snapshots", stats.snapshots},
+                    {"snapshotBytes", stats.snapshotBytes}
+                };
+                return true;
+            });
+
+        // Result tables: pages fetch the rows they can see and ask for sorting
+        // and filtering, which run on the C++ side
+        m_messageChannel.RegisterHandler("table.window",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string& error) {
+                std::shared_ptr<ResultTable> table = FindResultTable(payload, error);
+                if (!table) return false;
+
+                reply = table->GetWindow(payload.value("offset", static_cast<size_t>(0)),
+                    payload.value("count", static_cast<size_t>(100)));
+                return true;
+            });
+
+        m_messageChannel.RegisterHandler("table.sort",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string& error) {
+                std::shared_ptr<ResultTable> table = FindResultTable(payload, error);
+                if (!table || !table->Sort(payload.value("column", ""), payload.value("descending", false), error)) {
+                    return false;
+                }
+                reply = { {"version", table->GetVersion()}, {"count", table->GetViewCount()} };
+                return true;
+            });
+
+        m_messageChannel.RegisterHandler("table.filter",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string& error) {
+                std::shared_ptr<ResultTable> table = FindResultTable(payload, error);
+                if (!table) return false;
+
+                table->Filter(payload.value("text", ""));
+                reply = { {"version", table->GetVersion()}, {"count", table->GetViewCount()} };
+                return true;
+            });
+
+        m_messageChannel.RegisterHandler("table.stats",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string& error) {
+                std::shared_ptr<ResultTable> table = FindResultTable(payload, error);
+                if (!table) return false;
+
+                ResultTableStats stats = table->GetStats();
+                reply = {
+                    {"rows", table->GetRowCount()},
+                    {"viewRows", table->GetViewCount()},
+                    {"windows", stats.windows},
+                    {"windowRows", stats.windowRows},
+                    {"lastWindowMs", stats.lastWindowMs},
+                    {"maxWindowMs", stats.maxWindowMs},
+                    {"lastSortMs", stats.lastSortMs},
+                    {"lastFilterMs", stats.lastFilterMs}
+                };
+                return true;
+            });
+
+        // Memory given back while hidden, and the delays before each stage
+        m_messageChannel.RegisterHandler("memory.stats",
+            [this](const nlohmann::json&, nlohmann::json& reply, std::string&) {
+                const MemoryManagerOptions& options = m_memoryManager.GetOptions();
+                const MemoryStats& stats = m_memoryManager.GetStats();
+                const double mb = 1024.0 * 1024.0;
+                reply = {
+                    {"stage", MemoryManager::GetStageName(m_memoryManager.GetStage())},
+                    {"trimAfterMs", options.trimAfter.count()},
+                    {"discardAfterMs", options.discardAfter.count()},
+                    {"suspendAfterMs", options.suspendAfter.count()},
+                    {"trims", stats.trims},
+                    {"discards", stats.discards},
+                    {"suspends", stats.suspends},
+                    {"restores", stats.restores},
+                    {"lastStage", MemoryManager::GetStageName(stats.lastStage)},
+                    {"lastBeforeMB", stats.lastBytesBefore / mb},
+                    {"lastAfterMB", stats.lastBytesAfter / mb},
+                    {"releasedMB", stats.bytesReleased / mb},
+                    {"lastRestoreMs", stats.lastRestoreMs},
+                    {"averageRestoreMs", stats.averageRestoreMs},
+                    {"maxRestoreMs", stats.maxRestoreMs},
+                    {"workingSetMB", GetWorkingSetBytes() / mb}
+                };
+                return true;
+            });
+
+        m_messageChannel.RegisterHandler("memory.options",
+            [this](const nlohmann::json& payload, nlohmann::json& reply, std::string& error) {
+                if (!payload.is_object()) {
+                    error = "memory.options expects { trimAfterMs, discardAfterMs, suspendAfterMs }";
+                    return false;
+                }
+
+                MemoryManagerOptions options = m_memoryManager.GetOptions();
+                options.trimAfter = std::chrono::milliseconds(payload.value("trimAfterMs", options.trimAfter.count()));
+                options.discardAfter = std::chrono::milliseconds(payload.value("discardAfterMs", options.discardAfter.count()));
+                options.suspendAfter = std::chrono::milliseconds(payload.value("suspendAfterMs", options.suspendAfter.count()));
+                SetMemoryOptions(options);
+
+                reply = {
+                    {"trimAfterMs", options.trimAfter.count()},
+                    {"discardAfterMs", options.discardAfter.count()},
+                    {"suspendAfterMs", options.suspendAfter.count()}
+                };
+                return true;
+            });
+
+        // Off-screen compositor counters (empty when rendering on-screen)
+        m_messageChannel.RegisterHandler("render.stats",
+            [this](const nlohmann::json&, nlohmann::json& reply, std::string&) {
+                CompositorStats stats = GetCompositorStats();
+                reply = {
+                    {"offscreen", m_offscreen},
+                    {"frameRate", m_osrFrameRate},
+                    {"paints", stats.paints},
+                    {"presents", stats.presents},
+                    {"coalescedPaints", stats.coalescedPaints},
+                    {"pixelsCopied", stats.pixelsCopied},
+                    {"pixelsPresented", stats.pixelsPresented},
+                    {"fullFramePresents", stats.fullFramePresents}
+                };
+                return true;
+            });
+
+        // Web message routing: per-action handler times and the lookup table
+        m_messageChannel.RegisterHandler("actions.stats",
+            [this](const nlohmann::json&, nlohmann::json& reply, std::string&) {
+                ActionRouterStats router = m_actionRouter.GetRouterStats();
+                nlohmann::json actions = nlohmann::json::array();
+                for (const ActionStats& stats : m_actionRouter.GetStats()) {
+                    actions.push_back({
+                        {"action", stats.action},
+                        {"owner", stats.owner},
+                        {"messages", stats.messages},
+                        {"failures", stats.failures},
+                        {"lastMs", stats.lastMs},
+                        {"maxMs", stats.maxMs},
+                        {"averageMs", stats.averageMs}
+                    });
+                }
+                reply = {
+                    {"messages", router.messages},
+                    {"unhandled", router.unhandled},
+                    {"malformed", router.malformed},
+                    {"rebuilds", router.rebuilds},
+                    {"tableSize", router.tableSize},
+                    {"lastBuildMs", router.lastBuildMs},
+                    {"actions", actions}
+                };
+                return true;
+            });
     }
 
-    std::string OverlayWindow::CreateDataURL(const std::string& html) {
-        return "data:text/html;charset=utf-8," + html;
+    void OverlayWindow::RegisterRequestHandler(const std::string& channel, RequestHandler handler) {
+        m_messageChannel.RegisterHandler(channel, std::move(handler));
     }
 
-    void OverlayWindow::RegisterWebMessageCallback(WebMessageCallback cb) {
-        std::lock_guard<std::mutex> lock(m_callbackMutex);
-        m_webMessageCallbacks.push_back(cb);
+    void OverlayWindow::RegisterResultTable(const std::string& name, std::shared_ptr<ResultTable> table) {
+        if (!table) return;
+
+        std::string key = "table." + name;
+        table->SetChangeCallback([this, key](uint64_t version, size_t viewRows) {
+            m_stateStore->Set(key, { {"version", version}, {"rows", viewRows} });
+        });
+        m_stateStore->Set(key, { {"version", table->GetVersion()}, {"rows", table->GetViewCount()} });
+
+        std::lock_guard<std::mutex> lock(m_resultTableMutex);
+        m_resultTables[name] = std::move(table);
     }
 
-    void OverlayWindow::HandleWebMessage(const std::wstring& message) {
-        std::lock_guard<std::mutex> lock(m_callbackMutex);
-        for (auto& callback : m_webMessageCallbacks) {
-            try {
-                callback(message);
-            } catch (const std::exception& e) {
-                LOG_ERROR("Error in web message callback: {}", e.what());
+    std::shared_ptr<ResultTable> OverlayWindow::FindResultTable(const nlohmann::json& payload, std::string& error) const {
+        std::string name = payload.is_object() ? payload.value("table", "") : "";
+
+        std::lock_guard<std::mutex> lock(m_resultTableMutex);
+        auto it = m_resultTables.find(name);
+        if (it == m_resultTables.end()) {
+            error = "Unknown result table '" + name + "'";
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    void OverlayWindow::HandleRequest(cef_frame_t* frame, int requestId, const std::string& channel, cef_value_t* payload) {
+        auto start = std::chrono::steady_clock::now();
+
+        ChannelReply reply = m_messageChannel.Answer(requestId, channel, CefValueCodec::FromCefValue(payload));
+        if (!reply.ok) {
+            LOG_WARNING("Request {} on '{}' failed: {}", requestId, channel, reply.error);
+        }
+
+        cef_string_t msgName = {};
+        StdStringToCefString("nexile_reply", &msgName);
+        cef_process_message_t* msg = cef_process_message_create(&msgName);
+        cef_string_clear(&msgName);
+
+        cef_list_value_t* args = msg->get_argument_list(msg);
+        args->set_int(args, 0, reply.requestId);
+        args->set_bool(args, 1, reply.ok ? 1 : 0);
+        if (reply.ok) {
+            cef_value_t* value = CefValueCodec::ToCefValue(reply.value);
+            args->set_value(args, 2, value);
+            value->base.release((cef_base_ref_counted_t*)value);
+        } else {
+            cef_string_t errorStr = {};
+            StdStringToCefString(reply.error, &errorStr);
+            args->set_string(args, 2, &errorStr);
+            cef_string_clear(&errorStr);
+        }
+
+        frame->send_process_message(frame, PID_RENDERER, msg);
+
+        args->base.release((cef_base_ref_counted_t*)args);
+        msg->base.release((cef_base_ref_counted_t*)msg);
+
+        LOG_DEBUG("Request {} on '{}' answered in {}ms", requestId, channel,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    void OverlayWindow::HandleWebMessage(const std::string& message) {
+        std::string error;
+        if (!m_actionRouter.Dispatch(message, error)) {
+            if (!error.empty()) {
+                LOG_ERROR("Error processing web message: {}", error);
+            } else {
+                LOG_DEBUG("Web message without a handler: {}", message.substr(0, 120));
             }
         }
     }
@@ -931,7 +1845,544 @@ namespace Nexile {
     }
 
     void OverlayWindow::LoadMainOverlayUI() {
-        Navigate(L"nexile://main_overlay.html");
+        ShowPage("main", "nexile://main_overlay.html");
+    }
+
+    void OverlayWindow::ShowPage(const std::string& view, const std::string& url) {
+        m_currentView = view;
+        m_currentViewUrl = url;
+        m_pageSwitch.view = view;
+        m_pageSwitch.token = ++m_nextSwitchToken;
+        m_pageSwitch.policy = m_pagePolicy;
+        m_pageSwitch.start = std::chrono::steady_clock::now();
+        m_pageSwitch.workingSetBefore = GetWorkingSetBytes();
+
+        if (m_pagePolicy == PagePolicy::Navigate) {
+            Navigate(Utils::StringToWideString(url));
+            return;
+        }
+
+        if (!m_shellLoaded && !m_shellLoading) {
+            m_pagePool.Clear();
+            m_shellLoading = true;
+            NavigateMainFrame("nexile://shell.html");
+        }
+
+        PagePool::Activation activation = m_pagePool.Activate(view);
+        EvictPages(activation.evicted);
+
+        std::string script = "window.nexileShell && nexileShell.show(" + nlohmann::json(view).dump() + ", " +
+            nlohmann::json(url).dump() + ", " + std::to_string(m_pageSwitch.token) + ");";
+        if (m_shellLoaded) {
+            ExecuteScript(script, "shell");
+        } else {
+            m_pendingShellScript = script;
+        }
+    }
+
+    void OverlayWindow::SetPagePolicy(PagePolicy policy) {
+        if (policy == m_pagePolicy) return;
+        m_pagePolicy = policy;
+        LOG_INFO("Page policy set to {}", policy == PagePolicy::WarmPool ? "warm pool" : "navigate");
+    }
+
+    void OverlayWindow::OnMainFrameLoaded(const std::string& url) {
+        // A new document: the pages that subscribed to state are gone
+        m_stateStore->ClearSubscriptions();
+        m_mainFrameUrl = url;
+
+        if (url.rfind("nexile://shell.html", 0) == 0) {
+            m_shellLoaded = true;
+            m_shellLoading = false;
+            if (!m_pendingShellScript.empty()) {
+                ExecuteScript(m_pendingShellScript, "shell");
+                m_pendingShellScript.clear();
+            }
+            return;
+        }
+
+        // Under the navigate policy a switch ends when its page has loaded
+        if (m_pageSwitch.token != 0 && m_pageSwitch.policy == PagePolicy::Navigate) {
+            OnPageShown(m_pageSwitch.view, m_pageSwitch.token, false);
+        }
+
+        // A restored page outside the shell is back once it has loaded
+        if (m_memoryManager.IsRestoring() && url != "about:blank" && url.rfind("data:", 0) != 0) {
+            LOG_INFO("Overlay restored in {}ms", m_memoryManager.EndRestore(std::chrono::steady_clock::now()));
+            LogMemoryUsage("Post-Restore");
+        }
+    }
+
+    void OverlayWindow::OnPageShown(const std::string& view, uint64_t token, bool warm) {
+        if (token == 0 || token != m_pageSwitch.token || view != m_pageSwitch.view) {
+            return; // Superseded by a later switch
+        }
+
+        double latencyMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - m_pageSwitch.start).count();
+        size_t workingSet = GetWorkingSetBytes();
+        m_pagePool.RecordSwitch(m_pageSwitch.policy, warm, latencyMs, workingSet);
+
+        // Charge a freshly loaded page with the renderer growth its load caused
+        if (!warm && m_pageSwitch.policy == PagePolicy::WarmPool) {
+            size_t cost = workingSet > m_pageSwitch.workingSetBefore ?
+                workingSet - m_pageSwitch.workingSetBefore : PagePool::kDefaultPageCost;
+            EvictPages(m_pagePool.SetPageCost(view, cost));
+        }
+        m_pageSwitch.token = 0;
+
+        if (m_memoryManager.IsRestoring()) {
+            LOG_INFO("Overlay restored in {}ms", m_memoryManager.EndRestore(std::chrono::steady_clock::now()));
+            LogMemoryUsage("Post-Restore");
+        }
+
+        LOG_DEBUG("Page '{}' shown in {}ms ({}, {} policy); renderer {}MB, pool {} pages / {}MB",
+                  view, latencyMs, warm ? "warm" : "cold",
+                  m_pageSwitch.policy == PagePolicy::WarmPool ? "pool" : "navigate",
+                  workingSet / (1024 * 1024), m_pagePool.GetPageCount(),
+                  m_pagePool.GetMemoryUsage() / (1024 * 1024));
+    }
+
+    void OverlayWindow::EvictPages(const std::vector<std::string>& views) {
+        for (const std::string& view : views) {
+            LOG_DEBUG("Evicting page '{}' from the pool", view);
+            if (m_shellLoaded) {
+                ExecuteScript("window.nexileShell && nexileShell.evict(" + nlohmann::json(view).dump() + ");");
+            }
+        }
+    }
+
+    size_t OverlayWindow::GetWorkingSetBytes() {
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+            return pmc.WorkingSetSize;
+        }
+        return 0;
+    }
+
+    // ================== Memory Release While Hidden ==================
+
+    void OverlayWindow::SetMemoryOptions(const MemoryManagerOptions& options) {
+        m_memoryManager.SetOptions(options);
+        if (m_hwnd && m_memoryManager.IsHidden()) {
+            KillTimer(m_hwnd, MEMORY_STAGE_TIMER);
+            ScheduleMemoryStage();
+        }
+    }
+
+    void OverlayWindow::ScheduleMemoryStage() {
+        auto next = m_memoryManager.GetNextStageTime();
+        if (!m_pendingTrimStages.empty()) {
+            next = std::min(next, m_workingSetTrimTime);
+        }
+        if (next == MemoryManager::TimePoint::max()) return;
+
+        auto ms = std::chrono::ceil<std::chrono::milliseconds>(next - std::chrono::steady_clock::now()).count();
+        SetTimer(m_hwnd, MEMORY_STAGE_TIMER, static_cast<UINT>(ms > 0 ? ms : 1), nullptr);
+    }
+
+    void OverlayWindow::RunMemoryStages() {
+        if (m_visible) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (!m_pendingTrimStages.empty() && now >= m_workingSetTrimTime) {
+            FinishMemoryStages(true);
+        }
+
+        MemoryStage stage;
+        while ((stage = m_memoryManager.TakeDueStage(now)) != MemoryStage::Active) {
+            ApplyMemoryStage(stage);
+        }
+        ScheduleMemoryStage();
+    }
+
+    void OverlayWindow::ApplyMemoryStage(MemoryStage stage) {
+        std::string name = MemoryManager::GetStageName(stage);
+        size_t before = GetWorkingSetBytes();
+        LogMemoryUsage("Pre-Memory-" + name);
+
+        switch (stage) {
+        case MemoryStage::Trimmed:
+            ReleaseRendererMemory();
+            break;
+
+        case MemoryStage::PagesDiscarded: {
+            // The page that was on screen stays so showing again is still warm
+            std::vector<std::string> views;
+            for (const std::string& view : m_pagePool.GetPages()) {
+                if (view != m_currentView) {
+                    m_pagePool.Remove(view);
+                    views.push_back(view);
+                }
+            }
+            EvictPages(views);
+            ReleaseRendererMemory();
+            break;
+        }
+
+        case MemoryStage::Suspended:
+            SuspendBrowser();
+            break;
+
+        default:
+            return;
+        }
+
+        // The page runs the trim script on the next script batch; the working
+        // set is trimmed and measured after it has had time to let go
+        m_workingSetTrimTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(WORKING_SET_TRIM_DELAY_MS);
+        m_pendingTrimStages.emplace_back(stage, before);
+    }
+
+    void OverlayWindow::FinishMemoryStages(bool trimWorkingSet) {
+        if (m_pendingTrimStages.empty()) return;
+
+        if (trimWorkingSet) {
+            // CEF runs single-process, so this covers the renderer too
+            SetProcessWorkingSetSize(GetCurrentProcess(), static_cast<SIZE_T>(-1), static_cast<SIZE_T>(-1));
+        }
+
+        size_t after = GetWorkingSetBytes();
+        for (const auto& [stage, before] : m_pendingTrimStages) {
+            std::string name = MemoryManager::GetStageName(stage);
+            m_memoryManager.RecordStage(stage, before, after);
+            LogMemoryUsage("Post-Memory-" + name);
+            LOG_INFO("Hidden overlay {}: working set {}MB -> {}MB{}", name, before / (1024 * 1024),
+                     after / (1024 * 1024), trimWorkingSet ? "" : " (shown before the trim)");
+        }
+        m_pendingTrimStages.clear();
+    }
+
+    void OverlayWindow::ReleaseRendererMemory() {
+        // Cached files go (registered module pages stay), and so does the
+        // off-screen backing store, which the first paint after show recreates
+        m_assetCache->Clear();
+        if (m_offscreen) {
+            DestroyBackingStore();
+        }
+
+        // Pages may drop their own caches on the message; window.gc exists
+        // because of --expose-gc. ApplyMemoryStage trims the working set after.
+        if (m_browser) {
+            ExecuteScript("window.postMessage({nexileMemory:'trim'},'*'); if (window.gc) window.gc();", "memory");
+        }
+    }
+
+    void OverlayWindow::SuspendBrowser() {
+        if (!m_browser) return;
+
+        // What the next show reloads. Module state lives in the StateStore and
+        // reaches the reloaded pages when they subscribe again.
+        m_suspendedPage = {
+            {"url", m_mainFrameUrl},
+            {"shell", m_shellLoaded},
+            {"view", m_currentView},
+            {"viewUrl", m_currentViewUrl},
+            {"pages", m_pagePool.GetPages()}
+        };
+
+        auto host = m_browser->get_host(m_browser);
+        if (host) {
+            host->close_browser(host, 1);
+            host->base.release((cef_base_ref_counted_t*)host);
+        }
+        m_browser->base.release((cef_base_ref_counted_t*)m_browser);
+        m_browser = nullptr;
+
+        m_shellLoaded = false;
+        m_shellLoading = false;
+        m_pendingShellScript.clear();
+        m_pagePool.Clear();
+        m_stateStore->ClearSubscriptions();
+        ReleaseRendererMemory();
+
+        LOG_INFO("Overlay browser suspended, keeping {} bytes of page state", m_suspendedPage.dump().size());
+    }
+
+    void OverlayWindow::RestoreBrowser() {
+        if (m_browser || !m_cefInitialized || m_suspendedPage.is_null()) return;
+
+        m_memoryManager.BeginRestore(std::chrono::steady_clock::now());
+        LogMemoryUsage("Pre-Restore");
+
+        // Woken by a hotkey while hidden: the stages start over, so the
+        // browser is suspended again if the overlay stays hidden
+        if (!m_visible && m_memoryOptimizationEnabled) {
+            ScheduleMemoryStage();
+        }
+
+        std::string url = m_suspendedPage.value("url", "");
+        std::string view = m_suspendedPage.value("view", "");
+        std::string viewUrl = m_suspendedPage.value("viewUrl", "");
+        bool shell = m_suspendedPage.value("shell", false);
+        m_suspendedPage = nullptr;
+
+        // Queue the page; OnBrowserCreated loads it and the restore ends when it is shown
+        if (shell && !view.empty()) {
+            ShowPage(view, viewUrl);
+        } else if (!url.empty()) {
+            m_pendingUrl = url;
+        }
+
+        try {
+            CreateBrowser();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to restore overlay browser: {}", e.what());
+            m_memoryManager.CancelRestore();
+        }
+    }
+
+    // ================== Off-screen Rendering ==================
+
+    void OverlayWindow::OnOffscreenPaint(const cef_rect_t* dirtyRects, size_t dirtyRectsCount,
+                                         const void* buffer, int width, int height) {
+        if (!m_compositor) return;
+
+        if (width != m_osrWidth || height != m_osrHeight) {
+            CreateBackingStore(width, height);
+        }
+
+        m_osrPaintRects.clear();
+        for (size_t i = 0; i < dirtyRectsCount; i++) {
+            m_osrPaintRects.emplace_back(dirtyRects[i].x, dirtyRects[i].y, dirtyRects[i].width, dirtyRects[i].height);
+        }
+
+        m_compositor->OnPaint(buffer, width, height, m_osrPaintRects.data(), m_osrPaintRects.size(),
+                              std::chrono::steady_clock::now());
+        PresentFrame();
+        UpdateFrameRate();
+    }
+
+    void OverlayWindow::CreateBackingStore(int width, int height) {
+        DestroyBackingStore();
+        if (width <= 0 || height <= 0) return;
+
+        // Top-down 32-bit DIB; CEF paints premultiplied BGRA, which is what
+        // UpdateLayeredWindow expects with AC_SRC_ALPHA
+        BITMAPINFO info = {};
+        info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        info.bmiHeader.biWidth = width;
+        info.bmiHeader.biHeight = -height;
+        info.bmiHeader.biPlanes = 1;
+        info.bmiHeader.biBitCount = 32;
+        info.bmiHeader.biCompression = BI_RGB;
+
+        HDC screen = GetDC(nullptr);
+        void* bits = nullptr;
+        m_osrDC = CreateCompatibleDC(screen);
+        m_osrBitmap = CreateDIBSection(screen, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+        ReleaseDC(nullptr, screen);
+
+        if (!m_osrDC || !m_osrBitmap || !bits) {
+            LOG_ERROR("Failed to create {}x{} off-screen backing store", width, height);
+            DestroyBackingStore();
+            return;
+        }
+
+        m_osrOldBitmap = SelectObject(m_osrDC, m_osrBitmap);
+        m_osrWidth = width;
+        m_osrHeight = height;
+        m_compositor->Attach(static_cast<uint8_t*>(bits), width, height, width * 4);
+        LOG_DEBUG("Off-screen backing store {}x{}", width, height);
+    }
+
+    void OverlayWindow::DestroyBackingStore() {
+        if (m_compositor) {
+            m_compositor->Detach();
+        }
+        if (m_osrDC) {
+            if (m_osrOldBitmap) {
+                SelectObject(m_osrDC, m_osrOldBitmap);
+                m_osrOldBitmap = nullptr;
+            }
+            DeleteDC(m_osrDC);
+            m_osrDC = nullptr;
+        }
+        if (m_osrBitmap) {
+            DeleteObject(m_osrBitmap);
+            m_osrBitmap = nullptr;
+        }
+        m_osrWidth = 0;
+        m_osrHeight = 0;
+    }
+
+    void OverlayWindow::PresentFrame() {
+        if (!m_compositor || !m_hwnd) return;
+
+        auto now = std::chrono::steady_clock::now();
+        bool presented = m_compositor->Present(now, [this](const std::vector<PaintRect>&, const PaintRect& bounds) {
+            // UpdateLayeredWindowIndirect takes a single dirty rect, so the
+            // merged region goes out as its bounding box
+            POINT source = {0, 0};
+            SIZE size = {m_osrWidth, m_osrHeight};
+            BLENDFUNCTION blend = {AC_SRC_OVER, 0, 200, AC_SRC_ALPHA};
+            RECT dirty = {bounds.x, bounds.y, bounds.Right(), bounds.Bottom()};
+
+            UPDATELAYEREDWINDOWINFO info = {};
+            info.cbSize = sizeof(info);
+            info.hdcSrc = m_osrDC;
+            info.pptSrc = &source;
+            info.psize = &size;
+            info.pblend = &blend;
+            info.dwFlags = ULW_ALPHA;
+            info.prcDirty = &dirty;
+            if (!UpdateLayeredWindowIndirect(m_hwnd, &info)) {
+                LOG_WARNING("UpdateLayeredWindowIndirect failed: {}", GetLastError());
+            }
+        });
+
+        if (!presented && m_compositor->HasPending()) {
+            // Too soon after the last frame: present what has collected when the interval is up
+            auto due = m_compositor->GetPacer().NextPresentTime(now);
+            if (due != FramePacer::TimePoint::max()) {
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count();
+                SetTimer(m_hwnd, OSR_PRESENT_TIMER, static_cast<UINT>(ms > 0 ? ms : 1), nullptr);
+            }
+        }
+    }
+
+    void OverlayWindow::UpdateFrameRate() {
+        if (!m_compositor || !m_hwnd) return;
+
+        auto now = std::chrono::steady_clock::now();
+        FramePacer& pacer = m_compositor->GetPacer();
+        int fps = pacer.GetTargetFps(now);
+
+        if (m_browser && fps != m_osrFrameRate) {
+            auto host = m_browser->get_host(m_browser);
+            if (host) {
+                if (fps == 0) {
+                    host->was_hidden(host, 1);
+                } else {
+                    if (m_osrFrameRate == 0) {
+                        host->was_hidden(host, 0);
+                    }
+                    host->set_windowless_frame_rate(host, fps);
+                }
+                host->base.release((cef_base_ref_counted_t*)host);
+            }
+            LOG_DEBUG("Off-screen frame rate {} -> {}", m_osrFrameRate, fps);
+            m_osrFrameRate = fps;
+        }
+
+        // Come back when the animation hold runs out to drop to the static rate
+        auto change = pacer.NextModeChange(now);
+        if (change != FramePacer::TimePoint::max()) {
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(change - now).count() + 1;
+            SetTimer(m_hwnd, OSR_PACE_TIMER, static_cast<UINT>(ms > 0 ? ms : 1), nullptr);
+        }
+    }
+
+    void OverlayWindow::NotifyRenderActivity() {
+        if (!m_compositor) return;
+
+        m_compositor->GetPacer().OnActivity(std::chrono::steady_clock::now());
+        UpdateFrameRate();
+    }
+
+    bool OverlayWindow::ForwardInput(UINT msg, WPARAM wp, LPARAM lp) {
+        switch (msg) {
+            case WM_MOUSEMOVE: case WM_MOUSELEAVE: case WM_MOUSEWHEEL:
+            case WM_LBUTTONDOWN: case WM_LBUTTONUP:
+            case WM_RBUTTONDOWN: case WM_RBUTTONUP:
+            case WM_MBUTTONDOWN: case WM_MBUTTONUP:
+            case WM_KEYDOWN: case WM_KEYUP: case WM_CHAR:
+            case WM_SYSKEYDOWN: case WM_SYSKEYUP: case WM_SYSCHAR:
+            case WM_SETFOCUS: case WM_KILLFOCUS:
+                break;
+            default:
+                return false;
+        }
+
+        if (!m_browser) return false;
+        auto host = m_browser->get_host(m_browser);
+        if (!host) return false;
+
+        uint32 modifiers = 0;
+        if (GetKeyState(VK_SHIFT) & 0x8000) modifiers |= EVENTFLAG_SHIFT_DOWN;
+        if (GetKeyState(VK_CONTROL) & 0x8000) modifiers |= EVENTFLAG_CONTROL_DOWN;
+        if (GetKeyState(VK_MENU) & 0x8000) modifiers |= EVENTFLAG_ALT_DOWN;
+        if (GetKeyState(VK_LBUTTON) & 0x8000) modifiers |= EVENTFLAG_LEFT_MOUSE_BUTTON;
+        if (GetKeyState(VK_MBUTTON) & 0x8000) modifiers |= EVENTFLAG_MIDDLE_MOUSE_BUTTON;
+        if (GetKeyState(VK_RBUTTON) & 0x8000) modifiers |= EVENTFLAG_RIGHT_MOUSE_BUTTON;
+
+        cef_mouse_event_t mouse = {};
+        mouse.x = static_cast<short>(LOWORD(lp));
+        mouse.y = static_cast<short>(HIWORD(lp));
+        mouse.modifiers = modifiers;
+
+        cef_key_event_t key = {};
+        key.windows_key_code = static_cast<int>(wp);
+        key.native_key_code = static_cast<int>(lp);
+        key.is_system_key = (msg == WM_SYSKEYDOWN || msg == WM_SYSKEYUP || msg == WM_SYSCHAR) ? 1 : 0;
+        key.modifiers = modifiers;
+
+        switch (msg) {
+            case WM_MOUSEMOVE:
+                if (!m_osrTrackingMouse) {
+                    TRACKMOUSEEVENT track = {sizeof(TRACKMOUSEEVENT), TME_LEAVE, m_hwnd, 0};
+                    TrackMouseEvent(&track);
+                    m_osrTrackingMouse = true;
+                }
+                host->send_mouse_move_event(host, &mouse, 0);
+                break;
+
+            case WM_MOUSELEAVE: {
+                m_osrTrackingMouse = false;
+                POINT cursor;
+                GetCursorPos(&cursor);
+                ScreenToClient(m_hwnd, &cursor);
+                mouse.x = cursor.x;
+                mouse.y = cursor.y;
+                host->send_mouse_move_event(host, &mouse, 1);
+                break;
+            }
+
+            case WM_MOUSEWHEEL: {
+                // Wheel coordinates are in screen space
+                POINT cursor = {mouse.x, mouse.y};
+                ScreenToClient(m_hwnd, &cursor);
+                mouse.x = cursor.x;
+                mouse.y = cursor.y;
+                host->send_mouse_wheel_event(host, &mouse, 0, GET_WHEEL_DELTA_WPARAM(wp));
+                break;
+            }
+
+            case WM_LBUTTONDOWN: case WM_RBUTTONDOWN: case WM_MBUTTONDOWN:
+                SetCapture(m_hwnd);
+                host->send_mouse_click_event(host, &mouse,
+                    msg == WM_LBUTTONDOWN ? MBT_LEFT : (msg == WM_RBUTTONDOWN ? MBT_RIGHT : MBT_MIDDLE), 0, 1);
+                break;
+
+            case WM_LBUTTONUP: case WM_RBUTTONUP: case WM_MBUTTONUP:
+                ReleaseCapture();
+                host->send_mouse_click_event(host, &mouse,
+                    msg == WM_LBUTTONUP ? MBT_LEFT : (msg == WM_RBUTTONUP ? MBT_RIGHT : MBT_MIDDLE), 1, 1);
+                break;
+
+            case WM_KEYDOWN: case WM_SYSKEYDOWN:
+                key.type = KEYEVENT_RAWKEYDOWN;
+                host->send_key_event(host, &key);
+                break;
+
+            case WM_KEYUP: case WM_SYSKEYUP:
+                key.type = KEYEVENT_KEYUP;
+                host->send_key_event(host, &key);
+                break;
+
+            case WM_CHAR: case WM_SYSCHAR:
+                key.type = KEYEVENT_CHAR;
+                host->send_key_event(host, &key);
+                break;
+
+            case WM_SETFOCUS: case WM_KILLFOCUS:
+                host->set_focus(host, msg == WM_SETFOCUS ? 1 : 0);
+                break;
+        }
+
+        host->base.release((cef_base_ref_counted_t*)host);
+        NotifyRenderActivity();
+        return true;
     }
 
     void OverlayWindow::LoadModuleUI(const std::shared_ptr<IModule>& module) {
@@ -939,15 +2390,16 @@ namespace Nexile {
 
         std::string moduleId = module->GetModuleID();
         if (moduleId == "price_check") {
-            Navigate(L"nexile://price_check_module.html");
+            ShowPage(moduleId, "nexile://price_check_module.html");
         } else if (moduleId == "settings") {
-            Navigate(L"nexile://settings.html");
+            ShowPage(moduleId, "nexile://settings.html");
         } else {
-            // Use module's HTML content
-            std::string html = module->GetModuleUIHTML();
-            if (!html.empty()) {
-                std::string dataURL = CreateDataURL(html);
-                Navigate(Utils::StringToWideString(dataURL));
+            // The module's HTML is served from memory; navigation only carries
+            // the short URL. Registering again is cheap when the HTML is
+            // unchanged and gives changed HTML a new version.
+            std::string url = RegisterModuleUI(module);
+            if (!url.empty()) {
+                ShowPage(moduleId, url);
             }
         }
     }
@@ -8,6 +8,7 @@
 #include <mutex>
 #include <memory>
 #include <unordered_map>
+#include <chrono>
 
 // CEF C API includes - CRITICAL CHANGE: Different include structure
 #include "include/capi/cef_app_capi.h"
@@ -20,23 +21,32 @@
 #include "include/capi/cef_request_handler_capi.h"
 #include "include/capi/cef_resource_handler_capi.h"
 #include "include/capi/cef_render_process_handler_capi.h"
+#include "include/capi/cef_browser_process_handler_capi.h"
 #include "include/capi/cef_v8_capi.h"
+#include "include/capi/cef_render_handler_capi.h"
 #include "include/cef_version.h"
 #include "include/cef_app.h"  // For main functions
 
+#include "AssetCache.h"
+#include "AssetResponse.h"
+#include "ScriptDispatcher.h"
+#include "MessageChannel.h"
+#include "ActionRouter.h"
+#include "StateStore.h"
+#include "ResultTable.h"
+#include "MemoryManager.h"
+#include "PagePool.h"
+#include "FrameCompositor.h"
+#include "../Game/WindowTracker.h"
+
 namespace Nexile {
 
     class NexileApp;
     class IModule;
 
-    using WebMessageCallback = std::function<void(const std::wstring&)>;
-
     // FIXED: Proper context structure with embedded OverlayWindow pointer
     struct NexileHandlerContext {
         class OverlayWindow* overlay;
-        std::string currentResourceData;
-        size_t resourceOffset;
-        std::string resourceMimeType;
     };
 
     // FIXED: Extended handler structures with embedded context
@@ -60,9 +70,12 @@ namespace Nexile {
         NexileHandlerContext* context;
     };
 
+    // One per nexile:// request; the handler owns its response state
     struct NexileResourceHandler {
         cef_resource_handler_t handler;
         NexileHandlerContext* context;
+        AssetResponse* response;
+        std::chrono::steady_clock::time_point requestStart;
     };
 
     struct NexileRenderProcessHandler {
@@ -70,6 +83,16 @@ namespace Nexile {
         NexileHandlerContext* context;
     };
 
+    struct NexileBrowserProcessHandler {
+        cef_browser_process_handler_t handler;
+        NexileHandlerContext* context;
+    };
+
+    struct NexileRenderHandler {
+        cef_render_handler_t handler;
+        NexileHandlerContext* context;
+    };
+
     struct NexileAppHandler {
         cef_app_t handler;
         NexileHandlerContext* context;
@@ -95,20 +118,66 @@ namespace Nexile {
         void Hide();
         void SetPosition(const RECT& rect);
         void Navigate(const std::wstring& uri);
-        void ExecuteScript(const std::wstring& script);
+        // Queue a script for the page; updates on the same channel replace each other
+        void ExecuteScript(const std::wstring& script, const std::string& channel = "");
+        void ExecuteScript(const std::string& script, const std::string& channel = "");
+        ScriptDispatchStats GetScriptStats() const { return m_scriptDispatcher->GetStats(); }
+        // UI state that subscribed pages receive as deltas (any thread)
+        StateStore* GetStateStore() const { return m_stateStore.get(); }
+        // Serve a large result set to pages window by window through the
+        // table.* channels; its version and size go out as state "table.<name>"
+        void RegisterResultTable(const std::string& name, std::shared_ptr<ResultTable> table);
         void SetClickThrough(bool clickThrough);
-        void RegisterWebMessageCallback(WebMessageCallback cb);
+        // Run handler for web messages {action: "...", ...} posted by pages;
+        // owner (the module id) lets UnregisterActions drop them together
+        void RegisterAction(const std::string& owner, const std::string& action, ActionHandler handler);
+        void UnregisterActions(const std::string& owner);
+        std::vector<ActionStats> GetActionStats() const { return m_actionRouter.GetStats(); }
+        // Answer nexile.request(channel, payload) calls from the page
+        void RegisterRequestHandler(const std::string& channel, RequestHandler handler);
+        std::vector<ChannelStats> GetChannelStats() const { return m_messageChannel.GetStats(); }
         void LoadModuleUI(const std::shared_ptr<IModule>& module);
+        // Serve a module's UI HTML at nexile://module/<id>/index.html; returns
+        // the URL with a content version, or "" when the module has no UI
+        std::string RegisterModuleUI(const std::shared_ptr<IModule>& module);
+        void UnregisterModuleUI(const std::string& moduleId);
+        // Show a page by view id; under WarmPool it stays loaded for the next switch
+        void ShowPage(const std::string& view, const std::string& url);
+        void SetPagePolicy(PagePolicy policy);
+        PagePolicy GetPagePolicy() const { return m_pagePolicy; }
+        const PageSwitchStats& GetPageSwitchStats(PagePolicy policy) const { return m_pagePool.GetStats(policy); }
+        // Off-screen rendering (NEXILE_OFFSCREEN_RENDERING builds)
+        bool IsOffscreen() const { return m_offscreen; }
+        CompositorStats GetCompositorStats() const { return m_compositor ? m_compositor->GetStats() : CompositorStats(); }
         void LoadMainOverlayUI();
         void LoadWelcomePage();
         void LoadBrowserPage();
+        // Centre over the game window when one is tracked, else the screen
         void CenterWindow();
+        // The game window moved, resized, minimized or changed focus; a
+        // visible overlay follows it right away (UI thread)
+        void FollowGameWindow(const WindowGeometry& geometry);
         bool GetClickThrough() const { return m_clickThrough; }
+        // When a hidden overlay trims, discards warm pages and suspends the browser
+        void SetMemoryOptions(const MemoryManagerOptions& options);
+        const MemoryStats& GetMemoryStats() const { return m_memoryManager.GetStats(); }
+
+        // CEF is started on first use rather than at construction. Pages and
+        // scripts requested before the browser exists are kept until it does.
+        void StartCEF();
+        bool IsBrowserReady() const { return m_browser != nullptr; }
+        // Bring back a browser suspended while hidden (no-op otherwise)
+        void RestoreBrowser();
+        // Called on the UI thread once the browser has been created, and again
+        // with restored = true after each restore of a suspended browser
+        void SetReadyCallback(std::function<void(bool restored)> callback) { m_readyCallback = std::move(callback); }
 
         // ================== CEF Integration ==================
-        void HandleWebMessage(const std::wstring& message);
+        void HandleWebMessage(const std::string& message);
+        void HandleRequest(cef_frame_t* frame, int requestId, const std::string& channel, cef_value_t* payload);
+        void OnMainFrameLoaded(const std::string& url);
         void OnBrowserCreated(cef_browser_t* browser);
-        void OnBrowserClosing();
+        void OnBrowserClosing(cef_browser_t* browser);
 
         // ================== Static CEF C API Callbacks ==================
 
@@ -144,6 +213,7 @@ namespace Nexile {
                                                          cef_browser_t* browser, cef_frame_t* frame,
                                                          cef_process_id_t source_process,
                                                          cef_process_message_t* message);
+        static void SettleRequest(cef_frame_t* frame, cef_list_value_t* args);
 
         // Resource Handler Callbacks
         static int CEF_CALLBACK ResourceProcessRequest(cef_resource_handler_t* self,
@@ -167,12 +237,39 @@ namespace Nexile {
         static cef_load_handler_t* CEF_CALLBACK GetLoadHandler(cef_client_t* self);
         static cef_display_handler_t* CEF_CALLBACK GetDisplayHandler(cef_client_t* self);
         static cef_request_handler_t* CEF_CALLBACK GetRequestHandler(cef_client_t* self);
+        static cef_render_handler_t* CEF_CALLBACK GetRenderHandler(cef_client_t* self);
+        static int CEF_CALLBACK OnBrowserProcessMessageReceived(cef_client_t* self,
+                                                                cef_browser_t* browser, cef_frame_t* frame,
+                                                                cef_process_id_t source_process,
+                                                                cef_process_message_t* message);
+
+        // Render Handler Callbacks (off-screen only)
+        static void CEF_CALLBACK OsrGetViewRect(cef_render_handler_t* self, cef_browser_t* browser, cef_rect_t* rect);
+        static void CEF_CALLBACK OsrOnPaint(cef_render_handler_t* self, cef_browser_t* browser,
+                                            cef_paint_element_type_t type, size_t dirtyRectsCount,
+                                            cef_rect_t const* dirtyRects, const void* buffer,
+                                            int width, int height);
 
         // App Handler Callbacks
         static cef_render_process_handler_t* CEF_CALLBACK GetRenderProcessHandler(cef_app_t* self);
+        static cef_browser_process_handler_t* CEF_CALLBACK GetBrowserProcessHandler(cef_app_t* self);
+
+        static void CEF_CALLBACK OnBeforeCommandLineProcessing(cef_app_t* self, const cef_string_t* process_type,
+                                                               cef_command_line_t* command_line);
+
+        // Browser Process Handler Callbacks
+        static void CEF_CALLBACK OnScheduleMessagePumpWork(cef_browser_process_handler_t* self, int64 delay_ms);
 
     private:
         // ================== Window Management ==================
+        static const UINT WM_FLUSH_SCRIPTS = WM_APP + 1;
+        static const UINT_PTR SCRIPT_FLUSH_TIMER = 1;
+        static const UINT_PTR OSR_PRESENT_TIMER = 2;
+        static const UINT_PTR OSR_PACE_TIMER = 3;
+        static const UINT_PTR MEMORY_STAGE_TIMER = 4;
+        // Time the page gets to run the trim script before the working set is trimmed
+        static const UINT WORKING_SET_TRIM_DELAY_MS = 500;
+
         static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp);
         LRESULT HandleMessage(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp);
         void RegisterWindowClass();
@@ -180,18 +277,53 @@ namespace Nexile {
 
         // ================== CEF Management ==================
         void InitializeCEF();
+        void CreateBrowser();
         void ShutdownCEF();
         void CreateCEFHandlers();
         void ReleaseCEFHandlers();
 
         // ================== Helper Functions ==================
+        void LoadEmbeddedAssetBundle();
         std::string LoadHTMLResource(const std::string& filename);
-        std::string CreateDataURL(const std::string& html);
+
+        // Channels answered by the overlay itself (bridge.*, shell.*)
+        void RegisterBuiltinChannels();
+        std::shared_ptr<ResultTable> FindResultTable(const nlohmann::json& payload, std::string& error) const;
+
+        // Page switching
+        void NavigateMainFrame(const std::string& url);
+        void OnPageShown(const std::string& view, uint64_t token, bool warm);
+        void EvictPages(const std::vector<std::string>& views);
+        static size_t GetWorkingSetBytes();
+
+        // Memory release while hidden
+        void ScheduleMemoryStage();
+        void RunMemoryStages();
+        void ApplyMemoryStage(MemoryStage stage);
+        void FinishMemoryStages(bool trimWorkingSet);
+        void ReleaseRendererMemory();
+        void SuspendBrowser();
+
+        // Off-screen rendering
+        void OnOffscreenPaint(const cef_rect_t* dirtyRects, size_t dirtyRectsCount,
+                              const void* buffer, int width, int height);
+        void CreateBackingStore(int width, int height);
+        void DestroyBackingStore();
+        void PresentFrame();
+        void UpdateFrameRate();
+        void NotifyRenderActivity();
+        bool ForwardInput(UINT msg, WPARAM wp, LPARAM lp);
+
+        // Drain the script queue (UI thread) and run one batch in the main frame
+        void FlushScripts();
+        void DispatchScript(const std::string& script);
 
         // CEF String Conversion Helpers
         static std::string CefStringToStdString(const cef_string_t* cef_str);
         static void StdStringToCefString(const std::string& std_str, cef_string_t* cef_str);
         static void FreeCefString(cef_string_t* cef_str);
+        static std::string GetRequestHeader(cef_request_t* request, const std::string& name);
+        static void SetResponseHeader(cef_response_t* response, const std::string& name, const std::string& value);
 
         // CEF Reference Counting Helper
         static void InitializeCefBase(cef_base_ref_counted_t* base, size_t size);
@@ -207,6 +339,12 @@ namespace Nexile {
         bool m_visible;
         bool m_clickThrough;
         bool m_cefInitialized;
+        bool m_cefStarted;
+        std::chrono::steady_clock::time_point m_cefStartTime;
+        std::function<void(bool restored)> m_readyCallback;
+
+        // Main frame URL requested before the browser existed
+        std::string m_pendingUrl;
 
         // CEF C API structures - FIXED: Using extended structures
         cef_browser_t* m_browser;
@@ -216,21 +354,84 @@ namespace Nexile {
         NexileDisplayHandler* m_display_handler;
         NexileRequestHandler* m_request_handler;
         NexileRenderProcessHandler* m_render_process_handler;
+        NexileBrowserProcessHandler* m_browser_process_handler;
+        NexileRenderHandler* m_render_handler;
         NexileAppHandler* m_app_handler;
 
         // Context data - FIXED: Single context shared by all handlers
         NexileHandlerContext* m_context;
 
-        // Message handling
-        std::mutex m_callbackMutex;
-        std::vector<WebMessageCallback> m_webMessageCallbacks;
+        // Web message handlers by action
+        ActionRouter m_actionRouter;
+
+        // Typed request handlers by channel
+        MessageChannel m_messageChannel;
+
+        // Module pages kept loaded in the shell, and the switch being timed
+        struct PageSwitch {
+            std::string view;
+            uint64_t token = 0;
+            PagePolicy policy = PagePolicy::WarmPool;
+            std::chrono::steady_clock::time_point start;
+            size_t workingSetBefore = 0;
+        };
+        PagePolicy m_pagePolicy;
+        PagePool m_pagePool;
+        PageSwitch m_pageSwitch;
+        uint64_t m_nextSwitchToken;
+        bool m_shellLoaded;
+        bool m_shellLoading;
+        std::string m_pendingShellScript;
+
+        // Off-screen rendering: CEF paints into the DIB section, which is
+        // pushed to the layered window one merged dirty region at a time
+        bool m_offscreen;
+        std::unique_ptr<FrameCompositor> m_compositor;
+        HDC m_osrDC;
+        HBITMAP m_osrBitmap;
+        HGDIOBJ m_osrOldBitmap;
+        int m_osrWidth;
+        int m_osrHeight;
+        int m_osrFrameRate;     // Rate last sent to CEF
+        bool m_osrTrackingMouse;
+        std::vector<PaintRect> m_osrPaintRects;
 
         // Window properties
         RECT m_windowRect;
 
+        // Game window the overlay is placed over, as last reported
+        WindowGeometry m_gameGeometry;
+
         // Memory optimization flag
         bool m_memoryOptimizationEnabled;
 
+        // Stages of memory release while hidden, and what a suspended browser
+        // reloads on show
+        MemoryManager m_memoryManager;
+        // Stages (with the working set before them) waiting for the trim
+        std::vector<std::pair<MemoryStage, size_t>> m_pendingTrimStages;
+        std::chrono::steady_clock::time_point m_workingSetTrimTime;
+        nlohmann::json m_suspendedPage;
+        std::string m_mainFrameUrl;
+        std::string m_currentView;
+        std::string m_currentViewUrl;
+
+        // nexile:// files, read once and served from memory
+        std::unique_ptr<AssetCache> m_assetCache;
+
+        // Module id -> versioned URL of its registered UI
+        std::unordered_map<std::string, std::string> m_moduleUIUrls;
+
+        // Scripts waiting for the next UI tick
+        std::unique_ptr<ScriptDispatcher> m_scriptDispatcher;
+
+        // Module UI state; its deltas go out with the script batch
+        std::unique_ptr<StateStore> m_stateStore;
+
+        // Result sets registered by modules, by name
+        std::unordered_map<std::string, std::shared_ptr<ResultTable>> m_resultTables;
+        mutable std::mutex m_resultTableMutex;
+
         // Global handler registry for cleanup tracking
         static std::unordered_map<void*, OverlayWindow*> s_handlerRegistry;
         static std::mutex s_registryMutex;
@@ -0,0 +1,107 @@
+#include "PagePool.h"
+
+namespace Nexile {
+
+    PagePool::PagePool(size_t maxPages, size_t memoryBudget)
+        : m_maxPages(maxPages > 0 ? maxPages : 1), m_memoryBudget(memoryBudget), m_memoryUsage(0) {
+    }
+
+    PagePool::Activation PagePool::Activate(const std::string& id) {
+        Activation activation;
+
+        auto it = m_index.find(id);
+        if (it != m_index.end()) {
+            activation.warm = true;
+            m_pages.splice(m_pages.begin(), m_pages, it->second);
+        } else {
+            m_pages.push_front({ id, kDefaultPageCost });
+            m_index[id] = m_pages.begin();
+            m_memoryUsage += kDefaultPageCost;
+        }
+
+        activation.evicted = EvictOverLimit();
+        return activation;
+    }
+
+    std::vector<std::string> PagePool::SetPageCost(const std::string& id, size_t bytes) {
+        auto it = m_index.find(id);
+        if (it == m_index.end()) {
+            return {};
+        }
+
+        m_memoryUsage = m_memoryUsage - it->second->cost + bytes;
+        it->second->cost = bytes;
+        return EvictOverLimit();
+    }
+
+    void PagePool::Remove(const std::string& id) {
+        auto it = m_index.find(id);
+        if (it == m_index.end()) return;
+
+        m_memoryUsage -= it->second->cost;
+        m_pages.erase(it->second);
+        m_index.erase(it);
+    }
+
+    void PagePool::Clear() {
+        m_pages.clear();
+        m_index.clear();
+        m_memoryUsage = 0;
+    }
+
+    std::vector<std::string> PagePool::GetPages() const {
+        std::vector<std::string> pages;
+        pages.reserve(m_pages.size());
+        for (const Page& page : m_pages) {
+            pages.push_back(page.id);
+        }
+        return pages;
+    }
+
+    void PagePool::SetLimits(size_t maxPages, size_t memoryBudget) {
+        m_maxPages = maxPages > 0 ? maxPages : 1;
+        m_memoryBudget = memoryBudget;
+    }
+
+    std::vector<std::string> PagePool::EvictOverLimit() {
+        std::vector<std::string> evicted;
+
+        // Never evict the front page: it is the one being shown
+        while (m_pages.size() > 1 && (m_pages.size() > m_maxPages || m_memoryUsage > m_memoryBudget)) {
+            Page& victim = m_pages.back();
+            evicted.push_back(victim.id);
+            m_memoryUsage -= victim.cost;
+            m_index.erase(victim.id);
+            m_pages.pop_back();
+        }
+
+        m_stats[static_cast<int>(PagePolicy::WarmPool)].evictions += evicted.size();
+        return evicted;
+    }
+
+    void PagePool::RecordSwitch(PagePolicy policy, bool warm, double latencyMs, size_t workingSetBytes) {
+        PageSwitchStats& stats = m_stats[static_cast<int>(policy)];
+
+        stats.switches++;
+        stats.lastLatencyMs = latencyMs;
+        if (latencyMs > stats.maxLatencyMs) stats.maxLatencyMs = latencyMs;
+        stats.averageLatencyMs += (latencyMs - stats.averageLatencyMs) / static_cast<double>(stats.switches);
+
+        if (warm) {
+            stats.warmSwitches++;
+            stats.averageWarmLatencyMs += (latencyMs - stats.averageWarmLatencyMs) /
+                static_cast<double>(stats.warmSwitches);
+        } else {
+            uint64_t cold = stats.switches - stats.warmSwitches;
+            stats.averageColdLatencyMs += (latencyMs - stats.averageColdLatencyMs) / static_cast<double>(cold);
+        }
+
+        stats.lastWorkingSetBytes = workingSetBytes;
+        if (workingSetBytes > stats.peakWorkingSetBytes) stats.peakWorkingSetBytes = workingSetBytes;
+    }
+
+    const PageSwitchStats& PagePool::GetStats(PagePolicy policy) const {
+        return m_stats[static_cast<int>(policy)];
+    }
+
+} // namespace Nexile
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nexile {
+
+    // How the overlay switches between module pages
+    enum class PagePolicy {
+        Navigate = 0,   // Load each page into the main frame on every switch
+        WarmPool = 1    // Keep pages loaded in the shell and flip visibility
+    };
+
+    // Switch instrumentation for one policy
+    struct PageSwitchStats {
+        uint64_t switches = 0;
+        uint64_t warmSwitches = 0;      // Page was already loaded
+        uint64_t evictions = 0;
+        double lastLatencyMs = 0.0;     // Switch request -> page visible
+        double averageLatencyMs = 0.0;
+        double maxLatencyMs = 0.0;
+        double averageWarmLatencyMs = 0.0;
+        double averageColdLatencyMs = 0.0;
+        size_t lastWorkingSetBytes = 0; // Renderer memory when the page became visible
+        size_t peakWorkingSetBytes = 0;
+    };
+
+    // Bookkeeping for the warm page pool.
+    //
+    // Module pages stay loaded in the overlay shell so switching between them
+    // only changes which one is visible. The pool tracks what is loaded in LRU
+    // order along with an estimated memory cost per page, and names the pages
+    // to unload when it grows past its page count or memory budget. The page
+    // being shown is never evicted. UI thread only.
+    class PagePool {
+    public:
+        struct Activation {
+            bool warm = false;                  // Page was already in the pool
+            std::vector<std::string> evicted;   // Pages to unload, least recent first
+        };
+
+        // A page's cost until it reports one
+        static constexpr size_t kDefaultPageCost = 8 * 1024 * 1024;
+
+        explicit PagePool(size_t maxPages = 6, size_t memoryBudget = 160 * 1024 * 1024);
+
+        // Make a page the most recently used, adding it if needed
+        Activation Activate(const std::string& id);
+
+        // Record the measured cost of a loaded page; may evict others
+        std::vector<std::string> SetPageCost(const std::string& id, size_t bytes);
+
+        void Remove(const std::string& id);
+        void Clear();
+
+        bool Contains(const std::string& id) const { return m_index.find(id) != m_index.end(); }
+        size_t GetPageCount() const { return m_pages.size(); }
+        size_t GetMemoryUsage() const { return m_memoryUsage; }
+
+        // Loaded pages, most recently used first
+        std::vector<std::string> GetPages() const;
+
+        // Limits
+        void SetLimits(size_t maxPages, size_t memoryBudget);
+
+        // Instrumentation, kept per policy so the two can be compared
+        void RecordSwitch(PagePolicy policy, bool warm, double latencyMs, size_t workingSetBytes);
+        const PageSwitchStats& GetStats(PagePolicy policy) const;
+
+    private:
+        struct Page {
+            std::string id;
+            size_t cost;
+        };
+
+        std::vector<std::string> EvictOverLimit();
+
+    private:
+        size_t m_maxPages;
+        size_t m_memoryBudget;
+        size_t m_memoryUsage;
+
+        // Front is most recently used
+        std::list<Page> m_pages;
+        std::unordered_map<std::string, std::list<Page>::iterator> m_index;
+
+        PageSwitchStats m_stats[2];
+    };
+
+} // namespace Nexile
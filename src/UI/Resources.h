@@ -14,3 +14,6 @@
 #define IDR_HTML_MAIN          301
 #define IDR_HTML_PRICE_CHECK   302
 #define IDR_HTML_SETTINGS      303
+
+// Packed overlay assets (NXPK bundle built by tools/nxpack)
+#define IDR_ASSET_BUNDLE       310
@@ -0,0 +1,278 @@
+#include "ResultTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    namespace {
+        char LowerAscii(char c) {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        double ElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    bool ResultTable::SetRowTemplate(std::string_view source, std::string& error) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_rowTemplate.Compile(source, error);
+    }
+
+    void ResultTable::SetChangeCallback(ChangeCallback callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_changeCallback = std::move(callback);
+    }
+
+    bool ResultTable::SetColumns(std::vector<ResultColumn> columns, std::string& error) {
+        size_t rowCount = columns.empty() ? 0 : columns[0].GetRowCount();
+        for (const ResultColumn& column : columns) {
+            if (column.GetRowCount() != rowCount) {
+                error = "Column '" + column.name + "' has " + std::to_string(column.GetRowCount()) +
+                    " rows, expected " + std::to_string(rowCount);
+                return false;
+            }
+        }
+
+        // The search text is built before taking the lock; windows keep being
+        // served from the old contents meanwhile
+        std::string searchText;
+        std::vector<uint32_t> searchOffsets;
+        searchOffsets.reserve(rowCount + 1);
+        for (size_t row = 0; row < rowCount; row++) {
+            searchOffsets.push_back(static_cast<uint32_t>(searchText.size()));
+            for (const ResultColumn& column : columns) {
+                if (column.numeric) continue;
+                for (char c : column.text[row]) {
+                    searchText.push_back(LowerAscii(c));
+                }
+                searchText.push_back('\0');
+            }
+        }
+        searchOffsets.push_back(static_cast<uint32_t>(searchText.size()));
+
+        std::pair<uint64_t, size_t> change;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_columns = std::move(columns);
+            m_rowCount = rowCount;
+            m_searchText = std::move(searchText);
+            m_searchOffsets = std::move(searchOffsets);
+            m_ranks.assign(m_columns.size(), {});
+
+            ApplySort();
+            ApplyFilter();
+            change = MarkChanged();
+        }
+        NotifyChanged(change);
+        return true;
+    }
+
+    void ResultTable::Clear() {
+        std::string error;
+        SetColumns({}, error);
+    }
+
+    bool ResultTable::Sort(const std::string& column, bool descending, std::string& error) {
+        std::pair<uint64_t, size_t> change;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            bool known = std::any_of(m_columns.begin(), m_columns.end(),
+                [&](const ResultColumn& candidate) { return candidate.name == column; });
+            if (!known && !column.empty()) {
+                error = "Unknown column '" + column + "'";
+                return false;
+            }
+
+            m_sortColumn = column;
+            m_sortDescending = descending;
+            ApplySort();
+            ApplyFilter();
+            change = MarkChanged();
+        }
+        NotifyChanged(change);
+        return true;
+    }
+
+    void ResultTable::Filter(const std::string& text) {
+        std::pair<uint64_t, size_t> change;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_filter.clear();
+            for (char c : text) {
+                m_filter.push_back(LowerAscii(c));
+            }
+            ApplyFilter();
+            change = MarkChanged();
+        }
+        NotifyChanged(change);
+    }
+
+    json ResultTable::GetWindow(size_t offset, size_t count) {
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        offset = std::min(offset, m_view.size());
+        size_t end = offset + std::min(count, m_view.size() - offset);
+
+        json rows = json::array();
+        for (size_t i = offset; i < end; i++) {
+            uint32_t row = m_view[i];
+            json values = { {"row", i} };
+            for (const ResultColumn& column : m_columns) {
+                if (column.numeric) {
+                    values[column.name] = column.numbers[row];
+                } else {
+                    values[column.name] = column.text[row];
+                }
+            }
+            rows.push_back(std::move(values));
+        }
+
+        m_windowHtml.clear();
+        m_rowTemplate.Render(json{ {"rows", std::move(rows)} }, m_windowHtml);
+
+        json window = {
+            {"version", m_version},
+            {"total", m_rowCount},
+            {"count", m_view.size()},
+            {"offset", offset},
+            {"rows", end - offset},
+            {"html", m_windowHtml}
+        };
+
+        double elapsed = ElapsedMilliseconds(start);
+        m_stats.windows++;
+        m_stats.windowRows += end - offset;
+        m_stats.lastWindowMs = elapsed;
+        m_stats.maxWindowMs = std::max(m_stats.maxWindowMs, elapsed);
+        return window;
+    }
+
+    uint64_t ResultTable::GetVersion() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_version;
+    }
+
+    size_t ResultTable::GetRowCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_rowCount;
+    }
+
+    size_t ResultTable::GetViewCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_view.size();
+    }
+
+    ResultTableStats ResultTable::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void ResultTable::ApplySort() {
+        auto start = std::chrono::steady_clock::now();
+
+        m_order.resize(m_rowCount);
+        std::iota(m_order.begin(), m_order.end(), 0u);
+
+        auto column = std::find_if(m_columns.begin(), m_columns.end(),
+            [&](const ResultColumn& candidate) { return candidate.name == m_sortColumn; });
+        if (column == m_columns.end()) {
+            m_sortColumn.clear();
+            return;
+        }
+
+        // Sort on plain keys; a text column is compared through its ranks
+        bool descending = m_sortDescending;
+        auto sortBy = [&](const auto& keys) {
+            std::stable_sort(m_order.begin(), m_order.end(), [&](uint32_t a, uint32_t b) {
+                return descending ? keys[b] < keys[a] : keys[a] < keys[b];
+            });
+        };
+        if (column->numeric) {
+            sortBy(column->numbers);
+        } else {
+            sortBy(GetRanks(static_cast<size_t>(column - m_columns.begin())));
+        }
+
+        m_stats.lastSortMs = ElapsedMilliseconds(start);
+    }
+
+    void ResultTable::ApplyFilter() {
+        if (m_filter.empty()) {
+            m_view = m_order;
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        // One pass over the search text; a hit marks its row and the search
+        // resumes at the next row
+        std::vector<uint8_t> matches(m_rowCount, 0);
+        std::string_view text(m_searchText);
+        size_t position = 0;
+        while ((position = text.find(m_filter, position)) != std::string_view::npos) {
+            size_t row = static_cast<size_t>(std::upper_bound(m_searchOffsets.begin(), m_searchOffsets.end(),
+                static_cast<uint32_t>(position)) - m_searchOffsets.begin()) - 1;
+            matches[row] = 1;
+            position = m_searchOffsets[row + 1];
+        }
+
+        m_view.clear();
+        for (uint32_t row : m_order) {
+            if (matches[row]) {
+                m_view.push_back(row);
+            }
+        }
+
+        m_stats.lastFilterMs = ElapsedMilliseconds(start);
+    }
+
+    const std::vector<uint32_t>& ResultTable::GetRanks(size_t column) {
+        std::vector<uint32_t>& ranks = m_ranks[column];
+        if (!ranks.empty() || m_rowCount == 0) {
+            return ranks;
+        }
+
+        const std::vector<std::string>& text = m_columns[column].text;
+        std::vector<uint32_t> sorted(m_rowCount);
+        std::iota(sorted.begin(), sorted.end(), 0u);
+        auto less = [&](uint32_t a, uint32_t b) {
+            return std::lexicographical_compare(text[a].begin(), text[a].end(), text[b].begin(), text[b].end(),
+                [](char x, char y) { return LowerAscii(x) < LowerAscii(y); });
+        };
+        std::sort(sorted.begin(), sorted.end(), less);
+
+        // Values equal but for case share a rank so the stable sort keeps their order
+        ranks.resize(m_rowCount);
+        uint32_t rank = 0;
+        for (size_t i = 0; i < sorted.size(); i++) {
+            if (i > 0 && less(sorted[i - 1], sorted[i])) {
+                rank++;
+            }
+            ranks[sorted[i]] = rank;
+        }
+        return ranks;
+    }
+
+    std::pair<uint64_t, size_t> ResultTable::MarkChanged() {
+        m_version++;
+        return { m_version, m_view.size() };
+    }
+
+    void ResultTable::NotifyChanged(std::pair<uint64_t, size_t> change) {
+        ChangeCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            callback = m_changeCallback;
+        }
+        if (callback) {
+            callback(change.first, change.second);
+        }
+    }
+
+} // namespace Nexile
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "HtmlTemplate.h"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+
+namespace Nexile {
+
+    // One column of a ResultTable; fill `text` or, for numeric columns, `numbers`
+    struct ResultColumn {
+        std::string name;
+        bool numeric = false;
+        std::vector<std::string> text;
+        std::vector<double> numbers;
+
+        size_t GetRowCount() const { return numeric ? numbers.size() : text.size(); }
+    };
+
+    // Counters of a ResultTable
+    struct ResultTableStats {
+        uint64_t windows = 0;           // GetWindow calls
+        uint64_t windowRows = 0;        // Rows rendered by them
+        double lastWindowMs = 0.0;
+        double maxWindowMs = 0.0;
+        double lastSortMs = 0.0;
+        double lastFilterMs = 0.0;
+    };
+
+    // Large result set that pages show through a scrolling window.
+    //
+    // The module hands over whole columns; sorting and filtering run here on
+    // those columns and produce a view (row indices in display order). The
+    // page never receives the set itself: it asks for the rows it can see
+    // and gets them rendered through the row template, so a table of 100k
+    // rows costs the page a few dozen rows per scroll step.
+    //
+    // Every change to the contents, the sort or the filter bumps the version;
+    // windows carry it so pages can drop replies that are out of date.
+    class ResultTable {
+    public:
+        // Told the new version and view size after each change (any thread)
+        using ChangeCallback = std::function<void(uint64_t version, size_t viewRows)>;
+
+        ResultTable() = default;
+
+        // Template for a window: {{#rows}}..{{/rows}}, where each row holds
+        // its column values by name and "row", its position in the view
+        bool SetRowTemplate(std::string_view source, std::string& error);
+
+        void SetChangeCallback(ChangeCallback callback);
+
+        // Replace the contents; all columns need the same length. The sort
+        // and filter carry over (a sort column that is gone is dropped).
+        bool SetColumns(std::vector<ResultColumn> columns, std::string& error);
+        void Clear();
+
+        // Order the view by a column; ties keep the order rows were given in
+        bool Sort(const std::string& column, bool descending, std::string& error);
+
+        // Keep rows with a text column containing `text` (ASCII case
+        // insensitive); "" shows every row
+        void Filter(const std::string& text);
+
+        // Rows [offset, offset + count) of the view:
+        // { version, total, count, offset, rows, html }, where total counts
+        // all rows, count the rows in the view and rows those rendered
+        nlohmann::json GetWindow(size_t offset, size_t count);
+
+        uint64_t GetVersion() const;
+        size_t GetRowCount() const;
+        size_t GetViewCount() const;
+        ResultTableStats GetStats() const;
+
+    private:
+        // Rebuild m_order from the sort settings (lock held)
+        void ApplySort();
+
+        // Rebuild m_view from m_order and the filter (lock held)
+        void ApplyFilter();
+
+        // Sort keys of a text column: the rank of each row's value (lock held)
+        const std::vector<uint32_t>& GetRanks(size_t column);
+
+        // Bump the version and return what the change callback needs (lock held)
+        std::pair<uint64_t, size_t> MarkChanged();
+        void NotifyChanged(std::pair<uint64_t, size_t> change);
+
+    private:
+        mutable std::mutex m_mutex;
+        ChangeCallback m_changeCallback;
+        HtmlTemplate m_rowTemplate;
+
+        std::vector<ResultColumn> m_columns;
+        size_t m_rowCount = 0;
+        uint64_t m_version = 0;
+
+        // Lower-cased text columns of every row, '\0' separated, with each
+        // row's start; filtering searches this once instead of per cell
+        std::string m_searchText;
+        std::vector<uint32_t> m_searchOffsets;
+
+        // Per text column, built on first sort by it
+        std::vector<std::vector<uint32_t>> m_ranks;
+
+        std::string m_sortColumn;
+        bool m_sortDescending = false;
+        std::string m_filter;
+
+        std::vector<uint32_t> m_order;  // All rows, sorted
+        std::vector<uint32_t> m_view;   // m_order minus filtered-out rows
+
+        // Reused by GetWindow
+        std::string m_windowHtml;
+
+        ResultTableStats m_stats;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,129 @@
+#include "ScriptDispatcher.h"
+
+#include <algorithm>
+
+namespace Nexile {
+
+    ScriptDispatcher::ScriptDispatcher(ExecuteCallback execute, WakeCallback wake, Clock::duration frameInterval)
+        : m_execute(std::move(execute)), m_wake(std::move(wake)), m_frameInterval(frameInterval),
+          m_liveCount(0), m_wakeRequested(false) {
+    }
+
+    void ScriptDispatcher::Post(std::string script, const std::string& channel) {
+        if (script.empty()) return;
+
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.posted++;
+
+            if (!channel.empty()) {
+                auto it = m_channelSlots.find(channel);
+                if (it != m_channelSlots.end()) {
+                    // Supersede the pending update; the new one goes to the end so it
+                    // still runs after anything posted in between
+                    m_pending[it->second].script.clear();
+                    m_liveCount--;
+                    m_stats.coalesced++;
+                    it->second = m_pending.size();
+                } else {
+                    m_channelSlots.emplace(channel, m_pending.size());
+                }
+            }
+
+            m_pending.push_back({ std::move(script), Clock::now() });
+            m_liveCount++;
+
+            if (!m_wakeRequested) {
+                m_wakeRequested = true;
+                wake = true;
+            }
+        }
+
+        // Outside the lock: the callback may post a window message
+        if (wake && m_wake && !m_wake()) {
+            // Let the next post try again
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wakeRequested = false;
+        }
+    }
+
+    ScriptDispatcher::Clock::duration ScriptDispatcher::Flush() {
+        Clock::time_point now = Clock::now();
+        Clock::time_point oldest;
+        size_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_liveCount == 0) {
+                m_pending.clear();
+                m_channelSlots.clear();
+                m_wakeRequested = false;
+                return Clock::duration::zero();
+            }
+
+            // Frame pacing: keep collecting until a frame has passed since the last batch
+            Clock::duration sinceLast = now - m_lastFlush;
+            if (sinceLast < m_frameInterval) {
+                return m_frameInterval - sinceLast;
+            }
+
+            m_draining.swap(m_pending);
+            m_pending.clear();
+            m_channelSlots.clear();
+            count = m_liveCount;
+            m_liveCount = 0;
+            m_wakeRequested = false;
+            m_lastFlush = now;
+        }
+
+        // One script per batch; each update is isolated so a throwing one does not stop the rest
+        m_batch.clear();
+        oldest = now;
+        for (const PendingScript& pending : m_draining) {
+            if (pending.script.empty()) continue;
+
+            oldest = std::min(oldest, pending.posted);
+            if (count == 1) {
+                m_batch = pending.script;
+                break;
+            }
+            m_batch += "try{";
+            m_batch += pending.script;
+            m_batch += "\n}catch(e){console.error(e);}\n";
+        }
+        m_draining.clear();
+
+        m_execute(m_batch);
+
+        double latency = std::chrono::duration<double, std::milli>(Clock::now() - oldest).count();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.dispatched += count;
+            m_stats.batches++;
+            m_stats.lastLatencyMs = latency;
+            m_stats.maxLatencyMs = std::max(m_stats.maxLatencyMs, latency);
+            m_stats.averageLatencyMs += (latency - m_stats.averageLatencyMs) / static_cast<double>(m_stats.batches);
+        }
+
+        return Clock::duration::zero();
+    }
+
+    void ScriptDispatcher::Clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.clear();
+        m_channelSlots.clear();
+        m_liveCount = 0;
+        m_wakeRequested = false;
+    }
+
+    bool ScriptDispatcher::HasPending() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_liveCount > 0;
+    }
+
+    ScriptDispatchStats ScriptDispatcher::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+} // namespace Nexile
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Counters of a ScriptDispatcher
+    struct ScriptDispatchStats {
+        uint64_t posted = 0;            // Scripts handed to Post
+        uint64_t coalesced = 0;         // Scripts replaced by a newer one on the same channel
+        uint64_t dispatched = 0;        // Scripts that reached the page
+        uint64_t batches = 0;           // execute_java_script calls
+        double lastLatencyMs = 0.0;     // Oldest pending script -> dispatch, last batch
+        double maxLatencyMs = 0.0;
+        double averageLatencyMs = 0.0;  // Over all batches
+    };
+
+    // Queue between module threads and the overlay page.
+    //
+    // Scripts can be posted from any thread. A script posted on a channel
+    // replaces one still pending on the same channel (modules push their whole
+    // state, so only the latest matters); scripts without a channel are kept in
+    // order. The UI thread drains the queue at most once per frame, joining
+    // everything into one script so each tick costs a single IPC round trip.
+    class ScriptDispatcher {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Runs one batched script (UI thread)
+        using ExecuteCallback = std::function<void(const std::string& script)>;
+
+        // Asks the UI thread to call Flush soon (any thread); false if it could not
+        using WakeCallback = std::function<bool()>;
+
+        ScriptDispatcher(ExecuteCallback execute, WakeCallback wake,
+                         Clock::duration frameInterval = std::chrono::milliseconds(16));
+
+        // Queue a UTF-8 script; an empty channel never coalesces
+        void Post(std::string script, const std::string& channel = "");
+
+        // Dispatch pending scripts as one batch (UI thread). When the previous
+        // batch went out less than a frame ago nothing is sent; the return value
+        // is then the time to wait before calling again (zero otherwise).
+        Clock::duration Flush();
+
+        // Drop everything pending
+        void Clear();
+
+        bool HasPending() const;
+        ScriptDispatchStats GetStats() const;
+
+    private:
+        struct PendingScript {
+            std::string script;         // Empty once superseded
+            Clock::time_point posted;
+        };
+
+    private:
+        ExecuteCallback m_execute;
+        WakeCallback m_wake;
+        Clock::duration m_frameInterval;
+
+        mutable std::mutex m_mutex;
+        std::vector<PendingScript> m_pending;
+        std::unordered_map<std::string, size_t> m_channelSlots;    // Channel -> index in m_pending
+        size_t m_liveCount;
+        bool m_wakeRequested;
+
+        Clock::time_point m_lastFlush;
+        ScriptDispatchStats m_stats;
+
+        // Reused between flushes (UI thread only)
+        std::vector<PendingScript> m_draining;
+        std::string m_batch;
+    };
+
+} // namespace Nexile
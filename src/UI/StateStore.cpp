@@ -0,0 +1,170 @@
+#include "StateStore.h"
+
+using json = nlohmann::json;
+
+namespace Nexile {
+
+    StateStore::StateStore(WakeCallback wake)
+        : m_wake(std::move(wake)), m_wakeRequested(false) {
+    }
+
+    void StateStore::Set(const std::string& key, json value) {
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.sets++;
+
+            Entry& entry = m_entries[key];
+            if (entry.value == value) return;
+
+            entry.value = std::move(value);
+            MarkChanged(entry);
+            if (entry.subscribed && !m_wakeRequested) {
+                m_wakeRequested = true;
+                wake = true;
+            }
+        }
+
+        // Outside the lock: the callback may post a window message
+        if (wake && m_wake && !m_wake()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wakeRequested = false;
+        }
+    }
+
+    bool StateStore::SetAt(const std::string& key, const std::string& pointer, json value) {
+        json updated;
+        try {
+            json::json_pointer path(pointer);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            updated = it != m_entries.end() ? it->second.value : json();
+            if (pointer.empty()) {
+                updated = std::move(value);
+            } else {
+                updated[path] = std::move(value);
+            }
+        } catch (const json::exception&) {
+            // Malformed pointer, or it runs through a non-object
+            return false;
+        }
+
+        Set(key, std::move(updated));
+        return true;
+    }
+
+    void StateStore::Remove(const std::string& key) {
+        Set(key, nullptr);
+    }
+
+    json StateStore::Get(const std::string& key) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        return it != m_entries.end() ? it->second.value : json();
+    }
+
+    uint64_t StateStore::GetVersion(const std::string& key) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        return it != m_entries.end() ? it->second.version : 0;
+    }
+
+    json StateStore::Subscribe(const std::vector<std::string>& keys) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        json snapshot = json::object();
+        for (const std::string& key : keys) {
+            Entry& entry = m_entries[key];
+            if (!entry.subscribed) {
+                // Nothing was sent for this key yet; the snapshot is the baseline.
+                // Keys already subscribed keep theirs so other pages still get
+                // the pending delta.
+                entry.subscribed = true;
+                entry.sent = entry.value;
+                entry.sentVersion = entry.version;
+                entry.dirty = false;
+            }
+
+            json state = { {"version", entry.version}, {"value", entry.value} };
+            m_stats.snapshots++;
+            m_stats.snapshotBytes += state.dump().size();
+            snapshot[key] = std::move(state);
+        }
+        return snapshot;
+    }
+
+    void StateStore::ClearSubscriptions() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& [key, entry] : m_entries) {
+            entry.subscribed = false;
+            entry.sent = json();
+            entry.dirty = false;
+        }
+    }
+
+    json StateStore::TakeDeltas() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeRequested = false;
+
+        json deltas = json::array();
+        for (auto& [key, entry] : m_entries) {
+            if (!entry.dirty || !entry.subscribed) continue;
+            entry.dirty = false;
+
+            // Changes that cancelled out since the last tick send nothing. The
+            // page keeps its version; the next delta starts from it.
+            json ops = json::diff(entry.sent, entry.value);
+            if (ops.empty()) continue;
+
+            // A patch that rewrites most of the value (a result replacing a
+            // loading placeholder) costs more than the value itself
+            if (ops.size() > 1 && ops.dump().size() > entry.value.dump().size()) {
+                ops = json::array({ { {"op", "replace"}, {"path", ""}, {"value", entry.value} } });
+            }
+
+            m_stats.deltas++;
+            m_stats.ops += ops.size();
+            deltas.push_back({
+                {"key", key},
+                {"from", entry.sentVersion},
+                {"to", entry.version},
+                {"ops", std::move(ops)}
+            });
+
+            entry.sent = entry.value;
+            entry.sentVersion = entry.version;
+        }
+
+        if (!deltas.empty()) {
+            m_stats.deliveries++;
+        }
+        return deltas;
+    }
+
+    std::string StateStore::TakeDeltaScript() {
+        json deltas = TakeDeltas();
+        if (deltas.empty()) return "";
+
+        std::string payload = deltas.dump();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.deltaBytes += payload.size();
+        }
+
+        // The shell forwards window messages to every page it hosts
+        return "window.postMessage({nexileState:" + payload + "},'*');";
+    }
+
+    StateStoreStats StateStore::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void StateStore::MarkChanged(Entry& entry) {
+        entry.version++;
+        entry.dirty = true;
+        m_stats.changes++;
+    }
+
+} // namespace Nexile
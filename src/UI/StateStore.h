@@ -0,0 +1,97 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+
+namespace Nexile {
+
+    // Counters of a StateStore
+    struct StateStoreStats {
+        uint64_t sets = 0;              // Set/SetAt/Remove calls
+        uint64_t changes = 0;           // Calls that changed a value
+        uint64_t deliveries = 0;        // Non-empty TakeDeltas results
+        uint64_t deltas = 0;            // Per-key deltas in them
+        uint64_t ops = 0;               // JSON-Patch operations in them
+        uint64_t deltaBytes = 0;        // Serialized size of the deltas sent by TakeDeltaScript
+        uint64_t snapshots = 0;         // Keys handed out by Subscribe
+        uint64_t snapshotBytes = 0;
+    };
+
+    // Keyed UI state shared between modules and pages.
+    //
+    // Modules replace the value under a key ("settings", "price_check") from
+    // any thread; each change bumps that key's version. Once per tick the UI
+    // thread takes the changes as JSON-Patch (RFC 6902) deltas against what
+    // pages were last sent, one per changed key, so pages only touch what
+    // actually changed. Several changes between ticks fold into one delta.
+    //
+    // A page subscribes with a snapshot of the keys it shows. Deltas carry the
+    // version they apply to; a page that is not at that version (it missed
+    // one, or subscribed in between) asks for a new snapshot. Keys nobody
+    // subscribed to are tracked but never sent.
+    class StateStore {
+    public:
+        // Asks the UI thread to call TakeDeltas soon (any thread)
+        using WakeCallback = std::function<bool()>;
+
+        explicit StateStore(WakeCallback wake = nullptr);
+
+        // Replace the value under a key; no change if it is equal
+        void Set(const std::string& key, nlohmann::json value);
+
+        // Replace one member inside a key's value ("/general/opacity"),
+        // creating objects along the way; false for an invalid pointer
+        bool SetAt(const std::string& key, const std::string& pointer, nlohmann::json value);
+
+        // Set the key to null
+        void Remove(const std::string& key);
+
+        nlohmann::json Get(const std::string& key) const;
+        uint64_t GetVersion(const std::string& key) const;
+
+        // Mark keys as shown by a page and return their state:
+        // { key: { "version": n, "value": ... } }
+        nlohmann::json Subscribe(const std::vector<std::string>& keys);
+
+        // Forget all subscriptions (the page that held them is gone)
+        void ClearSubscriptions();
+
+        // Changes since the last call (UI thread):
+        // [ { "key", "from", "to", "ops": [ JSON-Patch ] } ], empty when nothing changed
+        nlohmann::json TakeDeltas();
+
+        // TakeDeltas wrapped in a script that posts them to the page; "" when
+        // nothing changed
+        std::string TakeDeltaScript();
+
+        StateStoreStats GetStats() const;
+
+    private:
+        struct Entry {
+            nlohmann::json value;
+            uint64_t version = 0;
+            nlohmann::json sent;            // Value pages were last given
+            uint64_t sentVersion = 0;
+            bool subscribed = false;
+            bool dirty = false;
+        };
+
+        // Record a change to an entry (lock held)
+        void MarkChanged(Entry& entry);
+
+    private:
+        WakeCallback m_wake;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+        bool m_wakeRequested;
+        StateStoreStats m_stats;
+    };
+
+} // namespace Nexile
@@ -0,0 +1,773 @@
+#include "Transcoder.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define NEXILE_TRANSCODE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 kernels are compiled for AVX2 regardless of the target flags and only
+// called after a CPU check
+#if defined(NEXILE_TRANSCODE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NEXILE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NEXILE_TARGET_AVX2
+#endif
+
+namespace Nexile {
+
+    namespace {
+
+        // ================== Kernels ==================
+
+        // Bulk loops with one implementation per instruction set
+        struct Kernels {
+            const char* name;
+
+            // Length of the leading run of bytes < 0x80
+            size_t (*asciiPrefix)(const uint8_t* data, size_t length);
+
+            // Copy the leading ASCII run to UTF-16; returns its length
+            size_t (*widenAscii)(const uint8_t* data, size_t length, char16_t* out);
+
+            // Copy the leading run of units < 0x80 to UTF-8; returns its length
+            size_t (*narrowAscii)(const char16_t* data, size_t length, char* out);
+
+            // Length of the leading run of non-surrogate units
+            size_t (*plainPrefix)(const char16_t* data, size_t length);
+
+            // Output lengths, exact for valid input
+            size_t (*utf16Length)(const uint8_t* data, size_t length);
+            size_t (*utf8Length)(const char16_t* data, size_t length);
+        };
+
+        inline bool IsSurrogate(uint32_t unit) {
+            return (unit & 0xF800) == 0xD800;
+        }
+
+        // ---------- Scalar ----------
+
+        size_t AsciiPrefixScalar(const uint8_t* data, size_t length) {
+            size_t i = 0;
+            while (i < length && data[i] < 0x80) i++;
+            return i;
+        }
+
+        size_t WidenAsciiScalar(const uint8_t* data, size_t length, char16_t* out) {
+            size_t i = 0;
+            for (; i < length && data[i] < 0x80; i++) {
+                out[i] = data[i];
+            }
+            return i;
+        }
+
+        size_t NarrowAsciiScalar(const char16_t* data, size_t length, char* out) {
+            size_t i = 0;
+            for (; i < length && data[i] < 0x80; i++) {
+                out[i] = static_cast<char>(data[i]);
+            }
+            return i;
+        }
+
+        size_t PlainPrefixScalar(const char16_t* data, size_t length) {
+            size_t i = 0;
+            while (i < length && !IsSurrogate(data[i])) i++;
+            return i;
+        }
+
+        size_t Utf16LengthScalar(const uint8_t* data, size_t length) {
+            // One unit per non-continuation byte, two for 4-byte sequences
+            size_t units = 0;
+            for (size_t i = 0; i < length; i++) {
+                units += (data[i] & 0xC0) != 0x80;
+                units += data[i] >= 0xF0;
+            }
+            return units;
+        }
+
+        size_t Utf8LengthScalar(const char16_t* data, size_t length) {
+            // A surrogate pair is 4 bytes, 2 per unit
+            size_t bytes = 0;
+            for (size_t i = 0; i < length; i++) {
+                uint32_t unit = data[i];
+                bytes += unit < 0x80 ? 1 : (unit < 0x800 || IsSurrogate(unit)) ? 2 : 3;
+            }
+            return bytes;
+        }
+
+        const Kernels kScalarKernels = {
+            "scalar",
+            AsciiPrefixScalar,
+            WidenAsciiScalar,
+            NarrowAsciiScalar,
+            PlainPrefixScalar,
+            Utf16LengthScalar,
+            Utf8LengthScalar
+        };
+
+#ifdef NEXILE_TRANSCODE_X86
+        inline unsigned CountTrailingZeros(uint32_t value) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, value);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+        }
+
+        // ---------- SSE2 ----------
+
+        size_t AsciiPrefixSse2(const uint8_t* data, size_t length) {
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+                if (mask != 0) {
+                    return i + CountTrailingZeros(static_cast<uint32_t>(mask));
+                }
+            }
+            return i + AsciiPrefixScalar(data + i, length - i);
+        }
+
+        size_t WidenAsciiSse2(const uint8_t* data, size_t length, char16_t* out) {
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                if (_mm_movemask_epi8(bytes) != 0) break;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(bytes, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(bytes, zero));
+            }
+            return i + WidenAsciiScalar(data + i, length - i, out + i);
+        }
+
+        size_t NarrowAsciiSse2(const char16_t* data, size_t length, char* out) {
+            const __m128i highBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 8));
+                __m128i high = _mm_and_si128(_mm_or_si128(a, b), highBits);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) break;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+            }
+            return i + NarrowAsciiScalar(data + i, length - i, out + i);
+        }
+
+        size_t PlainPrefixSse2(const char16_t* data, size_t length) {
+            const __m128i surrogateBits = _mm_set1_epi16(static_cast<short>(0xF800));
+            const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+            size_t i = 0;
+            for (; i + 8 <= length; i += 8) {
+                __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, surrogateBits), surrogate));
+                if (mask != 0) {
+                    return i + CountTrailingZeros(static_cast<uint32_t>(mask)) / 2;
+                }
+            }
+            return i + PlainPrefixScalar(data + i, length - i);
+        }
+
+        size_t Utf16LengthSse2(const uint8_t* data, size_t length) {
+            // Continuation bytes are -128..-65 as signed bytes; 4-byte leads are
+            // the bytes left unchanged by an unsigned max with 0xF0
+            const __m128i continuationLimit = _mm_set1_epi8(-64);
+            const __m128i fourByteLead = _mm_set1_epi8(static_cast<char>(0xF0));
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t units = 0;
+            size_t i = 0;
+            while (i + 16 <= length) {
+                // Byte counters, flushed before they can overflow
+                __m128i continuations = zero;
+                __m128i fourByteLeads = zero;
+                size_t blocks = 0;
+                for (; i + 16 <= length && blocks < 255; i += 16, blocks++) {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    continuations = _mm_sub_epi8(continuations, _mm_cmplt_epi8(bytes, continuationLimit));
+                    fourByteLeads = _mm_sub_epi8(fourByteLeads, _mm_cmpeq_epi8(_mm_max_epu8(bytes, fourByteLead), bytes));
+                }
+
+                __m128i continuationSums = _mm_sad_epu8(continuations, zero);
+                __m128i fourByteSums = _mm_sad_epu8(fourByteLeads, zero);
+                units += blocks * 16;
+                units -= static_cast<size_t>(_mm_cvtsi128_si32(continuationSums) +
+                                             _mm_cvtsi128_si32(_mm_srli_si128(continuationSums, 8)));
+                units += static_cast<size_t>(_mm_cvtsi128_si32(fourByteSums) +
+                                             _mm_cvtsi128_si32(_mm_srli_si128(fourByteSums, 8)));
+            }
+            return units + Utf16LengthScalar(data + i, length - i);
+        }
+
+        size_t Utf8LengthSse2(const char16_t* data, size_t length) {
+            // Every unit starts at 3 bytes; subtract one for < 0x80, one for
+            // < 0x800 and one for surrogates (2 bytes each)
+            const __m128i asciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+            const __m128i twoByteBits = _mm_set1_epi16(static_cast<short>(0xF800));
+            const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+            const __m128i ones = _mm_set1_epi16(1);
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t saved = 0;
+            size_t i = 0;
+            while (i + 8 <= length) {
+                // 16-bit counters take at most 3 per block
+                __m128i counters = zero;
+                size_t blocks = 0;
+                for (; i + 8 <= length && blocks < 8192; i += 8, blocks++) {
+                    __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    __m128i top = _mm_and_si128(units, twoByteBits);
+                    counters = _mm_sub_epi16(counters, _mm_cmpeq_epi16(_mm_and_si128(units, asciiBits), zero));
+                    counters = _mm_sub_epi16(counters, _mm_cmpeq_epi16(top, zero));
+                    counters = _mm_sub_epi16(counters, _mm_cmpeq_epi16(top, surrogate));
+                }
+
+                alignas(16) int32_t sums[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_madd_epi16(counters, ones));
+                saved += static_cast<size_t>(sums[0]) + sums[1] + sums[2] + sums[3];
+            }
+            return i * 3 - saved + Utf8LengthScalar(data + i, length - i);
+        }
+
+        const Kernels kSse2Kernels = {
+            "sse2",
+            AsciiPrefixSse2,
+            WidenAsciiSse2,
+            NarrowAsciiSse2,
+            PlainPrefixSse2,
+            Utf16LengthSse2,
+            Utf8LengthSse2
+        };
+
+        // ---------- AVX2 ----------
+        //
+        // The SSE2 tails are not VEX encoded, so the upper halves are cleared
+        // first; mixing the two with dirty upper halves stalls on most CPUs.
+
+        NEXILE_TARGET_AVX2 size_t AsciiPrefixAvx2(const uint8_t* data, size_t length) {
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32) {
+                int mask = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+                if (mask != 0) {
+                    return i + CountTrailingZeros(static_cast<uint32_t>(mask));
+                }
+            }
+            _mm256_zeroupper();
+            return i + AsciiPrefixSse2(data + i, length - i);
+        }
+
+        NEXILE_TARGET_AVX2 size_t WidenAsciiAvx2(const uint8_t* data, size_t length, char16_t* out) {
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32) {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                if (_mm256_movemask_epi8(bytes) != 0) break;
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                    _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 16),
+                                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+            }
+            _mm256_zeroupper();
+            return i + WidenAsciiSse2(data + i, length - i, out + i);
+        }
+
+        NEXILE_TARGET_AVX2 size_t NarrowAsciiAvx2(const char16_t* data, size_t length, char* out) {
+            const __m256i highBits = _mm256_set1_epi16(static_cast<short>(0xFF80));
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 16));
+                if (!_mm256_testz_si256(_mm256_or_si256(a, b), highBits)) break;
+                // packus works per 128-bit lane; restore the order afterwards
+                __m256i packed = _mm256_packus_epi16(a, b);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+            }
+            _mm256_zeroupper();
+            return i + NarrowAsciiSse2(data + i, length - i, out + i);
+        }
+
+        NEXILE_TARGET_AVX2 size_t PlainPrefixAvx2(const char16_t* data, size_t length) {
+            const __m256i surrogateBits = _mm256_set1_epi16(static_cast<short>(0xF800));
+            const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xD800));
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(units, surrogateBits), surrogate));
+                if (mask != 0) {
+                    return i + CountTrailingZeros(static_cast<uint32_t>(mask)) / 2;
+                }
+            }
+            _mm256_zeroupper();
+            return i + PlainPrefixSse2(data + i, length - i);
+        }
+
+        NEXILE_TARGET_AVX2 size_t Utf16LengthAvx2(const uint8_t* data, size_t length) {
+            const __m256i continuationLimit = _mm256_set1_epi8(-64);
+            const __m256i fourByteLead = _mm256_set1_epi8(static_cast<char>(0xF0));
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t units = 0;
+            size_t i = 0;
+            while (i + 32 <= length) {
+                __m256i continuations = zero;
+                __m256i fourByteLeads = zero;
+                size_t blocks = 0;
+                for (; i + 32 <= length && blocks < 255; i += 32, blocks++) {
+                    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    // No signed less-than in AVX2: limit > bytes
+                    continuations = _mm256_sub_epi8(continuations, _mm256_cmpgt_epi8(continuationLimit, bytes));
+                    fourByteLeads = _mm256_sub_epi8(fourByteLeads, _mm256_cmpeq_epi8(_mm256_max_epu8(bytes, fourByteLead), bytes));
+                }
+
+                alignas(32) uint64_t continuationSums[4];
+                alignas(32) uint64_t fourByteSums[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(continuationSums), _mm256_sad_epu8(continuations, zero));
+                _mm256_store_si256(reinterpret_cast<__m256i*>(fourByteSums), _mm256_sad_epu8(fourByteLeads, zero));
+                units += blocks * 32;
+                units -= static_cast<size_t>(continuationSums[0] + continuationSums[1] + continuationSums[2] + continuationSums[3]);
+                units += static_cast<size_t>(fourByteSums[0] + fourByteSums[1] + fourByteSums[2] + fourByteSums[3]);
+            }
+            _mm256_zeroupper();
+            return units + Utf16LengthSse2(data + i, length - i);
+        }
+
+        NEXILE_TARGET_AVX2 size_t Utf8LengthAvx2(const char16_t* data, size_t length) {
+            const __m256i asciiBits = _mm256_set1_epi16(static_cast<short>(0xFF80));
+            const __m256i twoByteBits = _mm256_set1_epi16(static_cast<short>(0xF800));
+            const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xD800));
+            const __m256i ones = _mm256_set1_epi16(1);
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t saved = 0;
+            size_t i = 0;
+            while (i + 16 <= length) {
+                __m256i counters = zero;
+                size_t blocks = 0;
+                for (; i + 16 <= length && blocks < 8192; i += 16, blocks++) {
+                    __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    __m256i top = _mm256_and_si256(units, twoByteBits);
+                    counters = _mm256_sub_epi16(counters, _mm256_cmpeq_epi16(_mm256_and_si256(units, asciiBits), zero));
+                    counters = _mm256_sub_epi16(counters, _mm256_cmpeq_epi16(top, zero));
+                    counters = _mm256_sub_epi16(counters, _mm256_cmpeq_epi16(top, surrogate));
+                }
+
+                alignas(32) int32_t sums[8];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_madd_epi16(counters, ones));
+                for (int32_t sum : sums) {
+                    saved += static_cast<size_t>(sum);
+                }
+            }
+            _mm256_zeroupper();
+            return i * 3 - saved + Utf8LengthSse2(data + i, length - i);
+        }
+
+        const Kernels kAvx2Kernels = {
+            "avx2",
+            AsciiPrefixAvx2,
+            WidenAsciiAvx2,
+            NarrowAsciiAvx2,
+            PlainPrefixAvx2,
+            Utf16LengthAvx2,
+            Utf8LengthAvx2
+        };
+
+        bool CpuHasAvx2() {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+
+            // The OS must save YMM state as well
+            __cpuid(info, 1);
+            const int osxsave = 1 << 27;
+            const int avx = 1 << 28;
+            if ((info[2] & osxsave) == 0 || (info[2] & avx) == 0) return false;
+            if ((_xgetbv(0) & 6) != 6) return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif // NEXILE_TRANSCODE_X86
+
+        const Kernels* DetectKernels() {
+#ifdef NEXILE_TRANSCODE_X86
+            return CpuHasAvx2() ? &kAvx2Kernels : &kSse2Kernels;
+#else
+            return &kScalarKernels;
+#endif
+        }
+
+        std::atomic<const Kernels*> g_kernels{ nullptr };
+
+        const Kernels& GetKernels() {
+            const Kernels* kernels = g_kernels.load(std::memory_order_acquire);
+            if (!kernels) {
+                kernels = DetectKernels();
+                g_kernels.store(kernels, std::memory_order_release);
+            }
+            return *kernels;
+        }
+
+        // ================== Scalar decoding ==================
+
+        // The common 2 and 3 byte sequences, whose leads allow the full
+        // continuation range. Returns 0 for anything else (including invalid
+        // input), which DecodeUtf8 then handles.
+        inline size_t DecodeUtf8Common(const uint8_t* data, size_t length, size_t i, uint32_t& codePoint) {
+            uint32_t lead = data[i];
+            if (lead >= 0xC2 && lead < 0xE0) {
+                if (i + 1 < length && (data[i + 1] & 0xC0) == 0x80) {
+                    codePoint = ((lead & 0x1F) << 6) | (data[i + 1] & 0x3Fu);
+                    return 2;
+                }
+            } else if (lead > 0xE0 && lead < 0xF0 && lead != 0xED) {
+                if (i + 2 < length && (data[i + 1] & 0xC0) == 0x80 && (data[i + 2] & 0xC0) == 0x80) {
+                    codePoint = ((lead & 0x0F) << 12) | ((data[i + 1] & 0x3Fu) << 6) | (data[i + 2] & 0x3Fu);
+                    return 3;
+                }
+            }
+            return 0;
+        }
+
+        // Decode the sequence at data[i]. Returns its length, or 0 with the
+        // error and the length of the maximal invalid subpart to skip.
+        size_t DecodeUtf8(const uint8_t* data, size_t length, size_t i,
+                          uint32_t& codePoint, TranscodeStatus& status, size_t& skip) {
+            uint8_t lead = data[i];
+            if (lead < 0x80) {
+                codePoint = lead;
+                return 1;
+            }
+
+            size_t continuations;
+            uint8_t low = 0x80;
+            uint8_t high = 0xBF;
+            TranscodeStatus rangeError = TranscodeStatus::MissingContinuation;
+
+            if (lead < 0xC0) {
+                status = TranscodeStatus::UnexpectedContinuation;
+                skip = 1;
+                return 0;
+            } else if (lead < 0xC2) {
+                status = TranscodeStatus::Overlong;
+                skip = 1;
+                return 0;
+            } else if (lead < 0xE0) {
+                continuations = 1;
+                codePoint = lead & 0x1F;
+            } else if (lead < 0xF0) {
+                continuations = 2;
+                codePoint = lead & 0x0F;
+                if (lead == 0xE0) {
+                    low = 0xA0;
+                    rangeError = TranscodeStatus::Overlong;
+                } else if (lead == 0xED) {
+                    high = 0x9F;
+                    rangeError = TranscodeStatus::Surrogate;
+                }
+            } else if (lead < 0xF5) {
+                continuations = 3;
+                codePoint = lead & 0x07;
+                if (lead == 0xF0) {
+                    low = 0x90;
+                    rangeError = TranscodeStatus::Overlong;
+                } else if (lead == 0xF4) {
+                    high = 0x8F;
+                    rangeError = TranscodeStatus::TooLarge;
+                }
+            } else {
+                status = lead < 0xF8 ? TranscodeStatus::TooLarge : TranscodeStatus::InvalidByte;
+                skip = 1;
+                return 0;
+            }
+
+            for (size_t k = 1; k <= continuations; k++) {
+                if (i + k >= length) {
+                    status = TranscodeStatus::Truncated;
+                    skip = k;
+                    return 0;
+                }
+
+                uint8_t byte = data[i + k];
+                uint8_t min = k == 1 ? low : 0x80;
+                uint8_t max = k == 1 ? high : 0xBF;
+                if (byte < min || byte > max) {
+                    // A continuation byte outside the lead's narrowed range says why it failed
+                    bool continuation = (byte & 0xC0) == 0x80;
+                    status = (k == 1 && continuation) ? rangeError : TranscodeStatus::MissingContinuation;
+                    skip = k;
+                    return 0;
+                }
+                codePoint = (codePoint << 6) | (byte & 0x3F);
+            }
+            return continuations + 1;
+        }
+
+        // Decode the unit(s) at data[i]; 0 for an unpaired surrogate
+        inline size_t DecodeUtf16(const char16_t* data, size_t length, size_t i, uint32_t& codePoint) {
+            uint32_t unit = data[i];
+            if (!IsSurrogate(unit)) {
+                codePoint = unit;
+                return 1;
+            }
+            if (unit <= 0xDBFF && i + 1 < length) {
+                uint32_t trail = data[i + 1];
+                if (trail >= 0xDC00 && trail <= 0xDFFF) {
+                    codePoint = 0x10000 + ((unit - 0xD800) << 10) + (trail - 0xDC00);
+                    return 2;
+                }
+            }
+            return 0;
+        }
+
+        inline size_t EncodeUtf16(uint32_t codePoint, char16_t* out) {
+            if (codePoint < 0x10000) {
+                out[0] = static_cast<char16_t>(codePoint);
+                return 1;
+            }
+            codePoint -= 0x10000;
+            out[0] = static_cast<char16_t>(0xD800 + (codePoint >> 10));
+            out[1] = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+            return 2;
+        }
+
+        inline size_t EncodeUtf8(uint32_t codePoint, char* out) {
+            if (codePoint < 0x80) {
+                out[0] = static_cast<char>(codePoint);
+                return 1;
+            }
+            if (codePoint < 0x800) {
+                out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+                out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                return 2;
+            }
+            if (codePoint < 0x10000) {
+                out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+                out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                return 3;
+            }
+            out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+            out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 4;
+        }
+
+        // ================== Conversion loops ==================
+
+        // ASCII characters copied inline before a run goes to the kernel
+        const size_t kInlineRun = 16;
+
+        template <bool Replace>
+        TranscodeResult ConvertUtf8(const uint8_t* data, size_t length, char16_t* out) {
+            const Kernels& kernels = GetKernels();
+            TranscodeResult result;
+            size_t i = 0;
+            size_t o = 0;
+
+            while (i < length) {
+                if (data[i] < 0x80) {
+                    // Words between other characters are cheaper to copy here;
+                    // runs that go on past the limit are handed to the kernel
+                    size_t limit = length - i > kInlineRun ? i + kInlineRun : length;
+                    do {
+                        out[o++] = data[i++];
+                    } while (i < limit && data[i] < 0x80);
+                    if (i == limit && i < length && data[i] < 0x80) {
+                        size_t run = kernels.widenAscii(data + i, length - i, out + o);
+                        i += run;
+                        o += run;
+                    }
+                    continue;
+                }
+
+                uint32_t codePoint = 0;
+                size_t consumed = DecodeUtf8Common(data, length, i, codePoint);
+                if (consumed != 0) {
+                    out[o++] = static_cast<char16_t>(codePoint);
+                    i += consumed;
+                    continue;
+                }
+
+                TranscodeStatus status = TranscodeStatus::Ok;
+                size_t skip = 0;
+                consumed = DecodeUtf8(data, length, i, codePoint, status, skip);
+                if (consumed == 0) {
+                    if (!Replace) {
+                        result.status = status;
+                        result.position = i;
+                        result.written = o;
+                        return result;
+                    }
+                    out[o++] = Transcoder::kReplacement;
+                    i += skip;
+                    continue;
+                }
+
+                o += EncodeUtf16(codePoint, out + o);
+                i += consumed;
+            }
+
+            result.position = length;
+            result.written = o;
+            return result;
+        }
+
+        template <bool Replace>
+        TranscodeResult ConvertUtf16(const char16_t* data, size_t length, char* out) {
+            const Kernels& kernels = GetKernels();
+            TranscodeResult result;
+            size_t i = 0;
+            size_t o = 0;
+
+            while (i < length) {
+                if (data[i] < 0x80) {
+                    size_t limit = length - i > kInlineRun ? i + kInlineRun : length;
+                    do {
+                        out[o++] = static_cast<char>(data[i++]);
+                    } while (i < limit && data[i] < 0x80);
+                    if (i == limit && i < length && data[i] < 0x80) {
+                        size_t run = kernels.narrowAscii(data + i, length - i, out + o);
+                        i += run;
+                        o += run;
+                    }
+                    continue;
+                }
+
+                uint32_t codePoint = 0;
+                size_t consumed = DecodeUtf16(data, length, i, codePoint);
+                if (consumed == 0) {
+                    if (!Replace) {
+                        result.status = TranscodeStatus::UnpairedSurrogate;
+                        result.position = i;
+                        result.written = o;
+                        return result;
+                    }
+                    codePoint = Transcoder::kReplacement;
+                    consumed = 1;
+                }
+
+                o += EncodeUtf8(codePoint, out + o);
+                i += consumed;
+            }
+
+            result.position = length;
+            result.written = o;
+            return result;
+        }
+    }
+
+    // ================== Transcoder ==================
+
+    TranscodeResult Transcoder::ValidateUtf8(const char* data, size_t length) {
+        const Kernels& kernels = GetKernels();
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+        TranscodeResult result;
+
+        size_t i = 0;
+        while (i < length) {
+            if (bytes[i] < 0x80) {
+                i += kernels.asciiPrefix(bytes + i, length - i);
+                continue;
+            }
+
+            uint32_t codePoint = 0;
+            size_t consumed = DecodeUtf8Common(bytes, length, i, codePoint);
+            if (consumed != 0) {
+                i += consumed;
+                continue;
+            }
+
+            size_t skip = 0;
+            consumed = DecodeUtf8(bytes, length, i, codePoint, result.status, skip);
+            if (consumed == 0) {
+                result.position = i;
+                return result;
+            }
+            i += consumed;
+        }
+
+        result.position = length;
+        return result;
+    }
+
+    TranscodeResult Transcoder::ValidateUtf16(const char16_t* data, size_t length) {
+        const Kernels& kernels = GetKernels();
+        TranscodeResult result;
+
+        size_t i = 0;
+        while (i < length) {
+            i += kernels.plainPrefix(data + i, length - i);
+            if (i >= length) break;
+
+            uint32_t codePoint = 0;
+            if (DecodeUtf16(data, length, i, codePoint) == 0) {
+                result.status = TranscodeStatus::UnpairedSurrogate;
+                result.position = i;
+                return result;
+            }
+            i += 2;
+        }
+
+        result.position = length;
+        return result;
+    }
+
+    size_t Transcoder::Utf16LengthOfUtf8(const char* data, size_t length) {
+        return GetKernels().utf16Length(reinterpret_cast<const uint8_t*>(data), length);
+    }
+
+    size_t Transcoder::Utf8LengthOfUtf16(const char16_t* data, size_t length) {
+        return GetKernels().utf8Length(data, length);
+    }
+
+    TranscodeResult Transcoder::Utf8ToUtf16(const char* data, size_t length, char16_t* out) {
+        return ConvertUtf8<false>(reinterpret_cast<const uint8_t*>(data), length, out);
+    }
+
+    TranscodeResult Transcoder::Utf16ToUtf8(const char16_t* data, size_t length, char* out) {
+        return ConvertUtf16<false>(data, length, out);
+    }
+
+    size_t Transcoder::Utf8ToUtf16Replacing(const char* data, size_t length, char16_t* out) {
+        return ConvertUtf8<true>(reinterpret_cast<const uint8_t*>(data), length, out).written;
+    }
+
+    size_t Transcoder::Utf16ToUtf8Replacing(const char16_t* data, size_t length, char* out) {
+        return ConvertUtf16<true>(data, length, out).written;
+    }
+
+    const char* Transcoder::GetKernelName() {
+        return GetKernels().name;
+    }
+
+    bool Transcoder::SelectKernel(const char* name) {
+        const Kernels* kernels = nullptr;
+        if (std::strcmp(name, "auto") == 0) {
+            kernels = DetectKernels();
+        } else if (std::strcmp(name, "scalar") == 0) {
+            kernels = &kScalarKernels;
+        }
+#ifdef NEXILE_TRANSCODE_X86
+        else if (std::strcmp(name, "sse2") == 0) {
+            kernels = &kSse2Kernels;
+        } else if (std::strcmp(name, "avx2") == 0 && CpuHasAvx2()) {
+            kernels = &kAvx2Kernels;
+        }
+#endif
+        if (!kernels) return false;
+
+        g_kernels.store(kernels, std::memory_order_release);
+        return true;
+    }
+
+} // namespace Nexile
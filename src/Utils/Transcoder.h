@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Nexile {
+
+    enum class TranscodeStatus {
+        Ok,
+        Truncated,              // Input ends inside a sequence
+        MissingContinuation,    // Lead byte not followed by enough continuation bytes
+        UnexpectedContinuation, // Continuation byte without a lead byte
+        InvalidByte,            // 0xF8..0xFF
+        Overlong,               // Longer encoding than the code point needs (includes 0xC0, 0xC1)
+        Surrogate,              // UTF-8 encoding of U+D800..U+DFFF
+        TooLarge,               // Above U+10FFFF
+        UnpairedSurrogate       // UTF-16 surrogate without its partner
+    };
+
+    struct TranscodeResult {
+        TranscodeStatus status = TranscodeStatus::Ok;
+        size_t position = 0;    // Input index of the first invalid sequence, or the input length
+        size_t written = 0;     // Output units written
+
+        bool Ok() const { return status == TranscodeStatus::Ok; }
+    };
+
+    // UTF-8 <-> UTF-16 conversion.
+    //
+    // ASCII runs, validation skips and the length counts use SSE2 or AVX2
+    // (picked at runtime) on x86, with a scalar fallback elsewhere. Other
+    // characters go through a scalar decoder.
+    //
+    // The strict functions stop at the first invalid sequence. The Replacing
+    // and Append functions substitute U+FFFD for each maximal invalid
+    // subsequence (the Unicode recommended practice, which the Win32
+    // converters also follow).
+    class Transcoder {
+    public:
+        static constexpr char16_t kReplacement = 0xFFFD;
+
+        static TranscodeResult ValidateUtf8(const char* data, size_t length);
+        static TranscodeResult ValidateUtf16(const char16_t* data, size_t length);
+
+        // Exact output length for valid input; with invalid input use the Replacing bounds
+        static size_t Utf16LengthOfUtf8(const char* data, size_t length);
+        static size_t Utf8LengthOfUtf16(const char16_t* data, size_t length);
+
+        // Replacing conversions never write more than these
+        static size_t MaxUtf16LengthOfUtf8(size_t length) { return length; }
+        static size_t MaxUtf8LengthOfUtf16(size_t length) { return length * 3; }
+
+        // Strict conversion; out must hold the predicted length
+        static TranscodeResult Utf8ToUtf16(const char* data, size_t length, char16_t* out);
+        static TranscodeResult Utf16ToUtf8(const char16_t* data, size_t length, char* out);
+
+        // Replacing conversion; out must hold the Max* bound. Returns units written.
+        static size_t Utf8ToUtf16Replacing(const char* data, size_t length, char16_t* out);
+        static size_t Utf16ToUtf8Replacing(const char16_t* data, size_t length, char* out);
+
+        // Append to a string of 16-bit units (std::u16string, or std::wstring on
+        // Windows). Returns false when invalid input had to be replaced.
+        template <typename String>
+        static bool AppendUtf16(std::string_view utf8, String& out) {
+            static_assert(sizeof(typename String::value_type) == sizeof(char16_t), "UTF-16 needs 16-bit units");
+
+            size_t base = out.size();
+            out.resize(base + Utf16LengthOfUtf8(utf8.data(), utf8.size()));
+            TranscodeResult result = Utf8ToUtf16(utf8.data(), utf8.size(), reinterpret_cast<char16_t*>(&out[0]) + base);
+            if (result.Ok()) {
+                return true;
+            }
+
+            out.resize(base + MaxUtf16LengthOfUtf8(utf8.size()));
+            out.resize(base + Utf8ToUtf16Replacing(utf8.data(), utf8.size(), reinterpret_cast<char16_t*>(&out[0]) + base));
+            return false;
+        }
+
+        template <typename Char>
+        static bool AppendUtf8(const Char* data, size_t length, std::string& out) {
+            static_assert(sizeof(Char) == sizeof(char16_t), "UTF-16 needs 16-bit units");
+
+            const char16_t* units = reinterpret_cast<const char16_t*>(data);
+            size_t base = out.size();
+            out.resize(base + Utf8LengthOfUtf16(units, length));
+            TranscodeResult result = Utf16ToUtf8(units, length, &out[0] + base);
+            if (result.Ok()) {
+                return true;
+            }
+
+            out.resize(base + MaxUtf8LengthOfUtf16(length));
+            out.resize(base + Utf16ToUtf8Replacing(units, length, &out[0] + base));
+            return false;
+        }
+
+        // Name of the kernel set in use ("avx2", "sse2" or "scalar")
+        static const char* GetKernelName();
+
+        // Force a kernel set ("auto" re-detects), for benchmarks and tests.
+        // False if this CPU or build does not have it.
+        static bool SelectKernel(const char* name);
+    };
+
+} // namespace Nexile
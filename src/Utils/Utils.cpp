@@ -1,45 +1,25 @@
 #include "Utils.h"
+#include "Transcoder.h"
 #include <ShlObj.h>
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
 #include <regex>
-#include <codecvt>
-#include <locale>
 
 namespace Nexile {
     namespace Utils {
 
         std::wstring StringToWideString(const std::string& str) {
-            if (str.empty()) {
-                return L"";
-            }
-
-            int size = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, NULL, 0);
-            if (size <= 0) {
-                return L"";
-            }
-
-            std::vector<wchar_t> buffer(size);
-            MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, buffer.data(), size);
-
-            return std::wstring(buffer.data());
+            // Invalid sequences become U+FFFD, as with MultiByteToWideChar
+            std::wstring result;
+            Transcoder::AppendUtf16(str, result);
+            return result;
         }
 
         std::string WideStringToString(const std::wstring& wstr) {
-            if (wstr.empty()) {
-                return "";
-            }
-
-            int size = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, NULL, 0, NULL, NULL);
-            if (size <= 0) {
-                return "";
-            }
-
-            std::vector<char> buffer(size);
-            WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, buffer.data(), size, NULL, NULL);
-
-            return std::string(buffer.data());
+            std::string result;
+            Transcoder::AppendUtf8(wstr.data(), wstr.size(), result);
+            return result;
         }
 
         std::string GetAppDataPath() {
@@ -270,6 +250,63 @@ namespace Nexile {
             return std::wstring(buffer.data());
         }
 
+        bool ReadClipboardText(std::string& text) {
+            text.clear();
+
+            if (!OpenClipboard(NULL)) {
+                return false;
+            }
+
+            HANDLE hData = GetClipboardData(CF_UNICODETEXT);
+            if (hData == NULL) {
+                CloseClipboard();
+                return false;
+            }
+
+            const wchar_t* data = static_cast<const wchar_t*>(GlobalLock(hData));
+            if (data == NULL) {
+                CloseClipboard();
+                return false;
+            }
+
+            text = WideStringToString(data);
+
+            GlobalUnlock(hData);
+            CloseClipboard();
+
+            return !text.empty();
+        }
+
+        bool CopyFromGame(std::string& text, int timeoutMilliseconds) {
+            DWORD sequence = GetClipboardSequenceNumber();
+
+            // Send Ctrl+C to the game - one action per hotkey press
+            INPUT inputs[4] = {};
+            for (INPUT& input : inputs) {
+                input.type = INPUT_KEYBOARD;
+            }
+            inputs[0].ki.wVk = VK_CONTROL;
+            inputs[1].ki.wVk = 'C';
+            inputs[2].ki.wVk = 'C';
+            inputs[2].ki.dwFlags = KEYEVENTF_KEYUP;
+            inputs[3].ki.wVk = VK_CONTROL;
+            inputs[3].ki.dwFlags = KEYEVENTF_KEYUP;
+            SendInput(4, inputs, sizeof(INPUT));
+
+            // Wait for the game to update the clipboard instead of sleeping a fixed time
+            ULONGLONG deadline = GetTickCount64() + timeoutMilliseconds;
+            while (GetClipboardSequenceNumber() == sequence && GetTickCount64() < deadline) {
+                Sleep(5);
+            }
+
+            if (GetClipboardSequenceNumber() == sequence) {
+                text.clear();
+                return false;
+            }
+
+            return ReadClipboardText(text);
+        }
+
         bool ReadRegistryString(HKEY hKey, const std::wstring& subKey, const std::wstring& valueName, std::wstring& value) {
             HKEY key;
             // Use the W version to match the wstring parameters
@@ -38,6 +38,10 @@ namespace Nexile {
 		std::wstring GetWindowClassName(HWND hwnd);
 		std::wstring GetWindowTitle(HWND hwnd);
 
+		// Clipboard functions
+		bool ReadClipboardText(std::string& text);
+		bool CopyFromGame(std::string& text, int timeoutMilliseconds = 250);
+
 		// Registry functions
 		bool ReadRegistryString(HKEY hKey, const std::wstring& subKey, const std::wstring& valueName, std::wstring& value);
 		bool WriteRegistryString(HKEY hKey, const std::wstring& subKey, const std::wstring& valueName, const std::wstring& value);
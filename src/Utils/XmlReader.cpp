@@ -0,0 +1,284 @@
+#include "XmlReader.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace Nexile {
+
+    namespace {
+        bool IsSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        bool IsNameEnd(char c) {
+            return IsSpace(c) || c == '>' || c == '/' || c == '=';
+        }
+
+        void AppendUtf8(uint32_t codePoint, std::string& output) {
+            if (codePoint < 0x80) {
+                output += static_cast<char>(codePoint);
+            } else if (codePoint < 0x800) {
+                output += static_cast<char>(0xC0 | (codePoint >> 6));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                output += static_cast<char>(0xE0 | (codePoint >> 12));
+                output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else if (codePoint <= 0x10FFFF) {
+                output += static_cast<char>(0xF0 | (codePoint >> 18));
+                output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+    }
+
+    XmlReader::XmlReader(std::string_view document)
+        : m_document(document), m_pos(0), m_pendingEnd(false), m_depth(0) {
+    }
+
+    XmlReader::Token XmlReader::Next() {
+        m_text = {};
+
+        // Second half of a self-closing element
+        if (m_pendingEnd) {
+            m_pendingEnd = false;
+            m_attributes = {};
+            m_depth--;
+            return Token::EndElement;
+        }
+
+        while (m_pos < m_document.size()) {
+            if (m_document[m_pos] != '<') {
+                size_t end = m_document.find('<', m_pos);
+                if (end == std::string_view::npos) end = m_document.size();
+
+                std::string_view text = m_document.substr(m_pos, end - m_pos);
+                m_pos = end;
+
+                // Whitespace between elements is not interesting to callers
+                size_t first = 0;
+                while (first < text.size() && IsSpace(text[first])) first++;
+                if (first == text.size()) continue;
+
+                m_text = text;
+                return Token::Text;
+            }
+
+            if (m_pos + 1 >= m_document.size()) {
+                return Token::Error;
+            }
+
+            char next = m_document[m_pos + 1];
+
+            if (next == '!' && m_document.compare(m_pos, 9, "<![CDATA[") == 0) {
+                size_t end = m_document.find("]]>", m_pos + 9);
+                if (end == std::string_view::npos) return Token::Error;
+                m_text = m_document.substr(m_pos + 9, end - m_pos - 9);
+                m_pos = end + 3;
+                return Token::Text;
+            }
+
+            if (next == '?' || next == '!') {
+                if (!SkipMarkup()) return Token::Error;
+                continue;
+            }
+
+            if (next == '/') {
+                size_t nameStart = m_pos + 2;
+                size_t end = m_document.find('>', nameStart);
+                if (end == std::string_view::npos) return Token::Error;
+
+                size_t nameEnd = nameStart;
+                while (nameEnd < end && !IsSpace(m_document[nameEnd])) nameEnd++;
+
+                m_name = m_document.substr(nameStart, nameEnd - nameStart);
+                m_attributes = {};
+                m_pos = end + 1;
+                m_depth--;
+                return Token::EndElement;
+            }
+
+            // Start element
+            size_t nameStart = m_pos + 1;
+            size_t nameEnd = nameStart;
+            while (nameEnd < m_document.size() && !IsNameEnd(m_document[nameEnd])) nameEnd++;
+            if (nameEnd == nameStart) return Token::Error;
+
+            // Find the closing '>' while respecting quoted attribute values
+            size_t scan = nameEnd;
+            char quote = 0;
+            while (scan < m_document.size()) {
+                char c = m_document[scan];
+                if (quote) {
+                    if (c == quote) quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '>') {
+                    break;
+                }
+                scan++;
+            }
+            if (scan >= m_document.size()) return Token::Error;
+
+            bool selfClosing = m_document[scan - 1] == '/';
+            size_t attributesEnd = selfClosing ? scan - 1 : scan;
+
+            m_name = m_document.substr(nameStart, nameEnd - nameStart);
+            m_attributes = m_document.substr(nameEnd, attributesEnd - nameEnd);
+            m_pos = scan + 1;
+            m_depth++;
+            m_pendingEnd = selfClosing;
+            return Token::StartElement;
+        }
+
+        return m_depth == 0 ? Token::End : Token::Error;
+    }
+
+    bool XmlReader::SkipMarkup() {
+        const char* terminator = ">";
+        size_t skip = 2;
+
+        if (m_document.compare(m_pos, 4, "<!--") == 0) {
+            terminator = "-->";
+            skip = 4;
+        } else if (m_document[m_pos + 1] == '?') {
+            terminator = "?>";
+        }
+
+        size_t end = m_document.find(terminator, m_pos + skip);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+
+        m_pos = end + std::char_traits<char>::length(terminator);
+        return true;
+    }
+
+    std::string XmlReader::GetText() const {
+        std::string result;
+        DecodeEntities(m_text, result);
+        return result;
+    }
+
+    std::string_view XmlReader::GetRawAttribute(std::string_view name) const {
+        size_t pos = 0;
+        const size_t size = m_attributes.size();
+
+        while (pos < size) {
+            while (pos < size && IsSpace(m_attributes[pos])) pos++;
+
+            size_t keyStart = pos;
+            while (pos < size && !IsNameEnd(m_attributes[pos])) pos++;
+            std::string_view key = m_attributes.substr(keyStart, pos - keyStart);
+
+            while (pos < size && IsSpace(m_attributes[pos])) pos++;
+            if (pos >= size || m_attributes[pos] != '=') {
+                if (key.empty()) pos++;
+                continue;
+            }
+            pos++;
+
+            while (pos < size && IsSpace(m_attributes[pos])) pos++;
+            if (pos >= size) break;
+
+            char quote = m_attributes[pos];
+            if (quote != '"' && quote != '\'') break;
+
+            size_t valueStart = ++pos;
+            size_t valueEnd = m_attributes.find(quote, valueStart);
+            if (valueEnd == std::string_view::npos) break;
+
+            if (key == name) {
+                return m_attributes.substr(valueStart, valueEnd - valueStart);
+            }
+            pos = valueEnd + 1;
+        }
+
+        return {};
+    }
+
+    std::string XmlReader::GetAttribute(std::string_view name, std::string_view fallback) const {
+        std::string_view raw = GetRawAttribute(name);
+        if (raw.data() == nullptr) {
+            return std::string(fallback);
+        }
+
+        std::string result;
+        DecodeEntities(raw, result);
+        return result;
+    }
+
+    int XmlReader::GetIntAttribute(std::string_view name, int fallback) const {
+        std::string_view raw = GetRawAttribute(name);
+        if (raw.empty()) {
+            return fallback;
+        }
+
+        bool negative = raw[0] == '-';
+        size_t i = negative ? 1 : 0;
+        if (i >= raw.size()) return fallback;
+
+        int value = 0;
+        for (; i < raw.size(); i++) {
+            char c = raw[i];
+            if (c < '0' || c > '9') break;
+            value = value * 10 + (c - '0');
+        }
+
+        return negative ? -value : value;
+    }
+
+    bool XmlReader::GetBoolAttribute(std::string_view name, bool fallback) const {
+        std::string_view raw = GetRawAttribute(name);
+        if (raw.empty()) {
+            return fallback;
+        }
+        return raw == "true";
+    }
+
+    void XmlReader::DecodeEntities(std::string_view input, std::string& output) {
+        output.reserve(output.size() + input.size());
+
+        size_t pos = 0;
+        while (pos < input.size()) {
+            size_t amp = input.find('&', pos);
+            if (amp == std::string_view::npos) {
+                output.append(input.data() + pos, input.size() - pos);
+                return;
+            }
+
+            output.append(input.data() + pos, amp - pos);
+
+            size_t semicolon = input.find(';', amp);
+            if (semicolon == std::string_view::npos || semicolon - amp > 10) {
+                output += '&';
+                pos = amp + 1;
+                continue;
+            }
+
+            std::string_view entity = input.substr(amp + 1, semicolon - amp - 1);
+            if (entity == "amp") output += '&';
+            else if (entity == "lt") output += '<';
+            else if (entity == "gt") output += '>';
+            else if (entity == "quot") output += '"';
+            else if (entity == "apos") output += '\'';
+            else if (!entity.empty() && entity[0] == '#') {
+                std::string digits(entity.substr(1));
+                uint32_t codePoint = 0;
+                if (!digits.empty() && (digits[0] == 'x' || digits[0] == 'X')) {
+                    codePoint = static_cast<uint32_t>(std::strtoul(digits.c_str() + 1, nullptr, 16));
+                } else {
+                    codePoint = static_cast<uint32_t>(std::strtoul(digits.c_str(), nullptr, 10));
+                }
+                AppendUtf8(codePoint, output);
+            } else {
+                // Unknown entity - keep it verbatim
+                output.append(input.data() + amp, semicolon - amp + 1);
+            }
+
+            pos = semicolon + 1;
+        }
+    }
+
+} // namespace Nexile
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Nexile {
+
+    // Minimal forward-only XML pull reader.
+    //
+    // Walks a document held in memory and reports elements and text without
+    // building a DOM. Names, attributes and text are returned as views into the
+    // source document; entity decoding is only done when a caller asks for a
+    // decoded value. Comments, processing instructions and DOCTYPE are skipped.
+    // Self-closing elements produce a StartElement followed by an EndElement.
+    class XmlReader {
+    public:
+        enum class Token {
+            StartElement,
+            EndElement,
+            Text,
+            End,
+            Error
+        };
+
+        explicit XmlReader(std::string_view document);
+
+        // Advance to the next token
+        Token Next();
+
+        // Element name for StartElement/EndElement
+        std::string_view GetName() const { return m_name; }
+
+        // Raw (undecoded) text for Text tokens
+        std::string_view GetRawText() const { return m_text; }
+
+        // Text with entities decoded
+        std::string GetText() const;
+
+        // Raw attribute value of the current start element (empty view if missing)
+        std::string_view GetRawAttribute(std::string_view name) const;
+
+        // Attribute value with entities decoded
+        std::string GetAttribute(std::string_view name, std::string_view fallback = {}) const;
+
+        // Attribute value parsed as an integer
+        int GetIntAttribute(std::string_view name, int fallback = 0) const;
+
+        // True if the current attribute exists and equals "true" (case-sensitive, PoB style)
+        bool GetBoolAttribute(std::string_view name, bool fallback = false) const;
+
+        // Current nesting depth (1 for the root element)
+        int GetDepth() const { return m_depth; }
+
+        // Byte offset of the reader, useful for error reporting
+        size_t GetOffset() const { return m_pos; }
+
+        // Decode the five predefined entities and numeric character references
+        static void DecodeEntities(std::string_view input, std::string& output);
+
+    private:
+        // Skip <? ?>, <!-- -->, <!DOCTYPE> blocks; returns false on malformed input
+        bool SkipMarkup();
+
+    private:
+        std::string_view m_document;
+        size_t m_pos;
+
+        std::string_view m_name;
+        std::string_view m_attributes;
+        std::string_view m_text;
+
+        bool m_pendingEnd;
+        int m_depth;
+    };
+
+} // namespace Nexile
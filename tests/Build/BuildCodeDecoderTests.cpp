@@ -0,0 +1,103 @@
+#include "TestHarness.h"
+
+#include "Build/BuildCodeDecoder.h"
+
+#include <zlib.h>
+
+using namespace Nexile;
+
+namespace {
+    std::string Compress(const std::string& data) {
+        uLongf compressedSize = compressBound(static_cast<uLong>(data.size()));
+        std::string compressed(compressedSize, '\0');
+        compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressedSize,
+                  reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()), 9);
+        compressed.resize(compressedSize);
+        return compressed;
+    }
+
+    // zlib-compress and URL-safe base64 encode, as PoB exports
+    std::string Encode(const std::string& xml) {
+        static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        std::string code;
+        uint32_t accumulator = 0;
+        int bits = 0;
+        for (unsigned char c : Compress(xml)) {
+            accumulator = (accumulator << 8) | c;
+            bits += 8;
+            while (bits >= 6) {
+                bits -= 6;
+                code += alphabet[(accumulator >> bits) & 0x3F];
+            }
+        }
+        if (bits > 0) {
+            code += alphabet[(accumulator << (6 - bits)) & 0x3F];
+        }
+        return code;
+    }
+
+    const char* const kBuildXml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<PathOfBuilding>\n"
+        "<Build level=\"92\" className=\"Witch\" ascendClassName=\"Occultist\"/>\n"
+        "<Tree activeSpec=\"1\"><Spec treeVersion=\"3_25\" nodes=\"101,2040,33\"/></Tree>\n"
+        "</PathOfBuilding>\n";
+}
+
+NX_TEST(ExportCodesDecodeToTheBuild) {
+    BuildCodeDecoder decoder;
+    BuildModel model;
+    std::string error;
+    REQUIRE(decoder.Decode(Encode(kBuildXml), model, error));
+    CHECK_EQ(model.className, "Witch");
+    CHECK_EQ(model.ascendancy, "Occultist");
+    CHECK_EQ(model.level, 92);
+    CHECK((model.treeNodes == std::vector<uint32_t>{ 101, 2040, 33 }));
+
+    std::string xml;
+    REQUIRE(decoder.DecodeToXml(Encode(kBuildXml), xml, error));
+    CHECK_EQ(xml, kBuildXml);
+}
+
+NX_TEST(BrokenCodesAreRejected) {
+    BuildCodeDecoder decoder;
+    BuildModel model;
+    std::string error;
+    CHECK(!decoder.Decode("not*base64", model, error));
+    CHECK_EQ(error, "Build code is not valid base64");
+
+    // Valid base64 of something that is not a zlib stream
+    error.clear();
+    CHECK(!decoder.Decode("SGVsbG8gd29ybGQ", model, error));
+    CHECK_EQ(error, "Build code data is not a valid zlib stream");
+
+    // A stream cut short
+    std::string compressed = Compress(kBuildXml);
+    std::string output;
+    CHECK(!BuildCodeDecoder::Inflate(compressed.substr(0, compressed.size() / 2), output, error));
+    CHECK(output.empty());
+}
+
+NX_TEST(InflatedSizeIsCapped) {
+    const size_t limit = BuildCodeDecoder::kMaxInflatedSize;
+    std::string output;
+    std::string error;
+
+    // Exactly the limit still decodes
+    REQUIRE(BuildCodeDecoder::Inflate(Compress(std::string(limit, ' ')), output, error));
+    CHECK_EQ(output.size(), limit);
+
+    // One byte more is refused; zeros compress about 1000x, so this is a
+    // bomb of a few dozen KB
+    std::string bomb = Compress(std::string(limit + 1, '\0'));
+    CHECK(bomb.size() < 64 * 1024);
+    CHECK(!BuildCodeDecoder::Inflate(bomb, output, error));
+    CHECK_EQ(error, "Build code data inflates past 32 MB");
+    CHECK(output.empty());
+
+    // The same through a pasted code
+    BuildCodeDecoder decoder;
+    BuildModel model;
+    error.clear();
+    CHECK(!decoder.Decode(Encode(std::string(limit + 4096, 'A')), model, error));
+    CHECK_EQ(error, "Build code data inflates past 32 MB");
+}
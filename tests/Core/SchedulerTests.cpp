@@ -0,0 +1,316 @@
+#include "TestHarness.h"
+
+#include "Core/Scheduler.h"
+
+#include <string>
+
+using namespace Nexile;
+using namespace std::chrono;
+
+namespace {
+    // Fake clock; the scheduler reads it through a NowFunction
+    struct FakeClock {
+        Scheduler::TimePoint now = Scheduler::TimePoint() + hours(1);
+
+        Scheduler::NowFunction Function() {
+            return [this]() { return now; };
+        }
+    };
+
+    // 8 ms ticks on a 16-slot wheel: one turn is 128 ms
+    const Scheduler::Duration kTick = milliseconds(8);
+    const size_t kSlots = 16;
+
+    long long Ms(Scheduler::Duration duration) {
+        return static_cast<long long>(duration_cast<milliseconds>(duration).count());
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Pump work
+// -----------------------------------------------------------------------------
+
+NX_TEST(PumpWorkIsTakenOnceWhenDue) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots, seconds(1));
+
+    // Nothing requested: the fallback pump bounds the wait
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 1000);
+    CHECK_EQ(Ms(scheduler.GetWaitTime(milliseconds(300))), 300);
+
+    scheduler.SchedulePumpWork(20);
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 20);
+    CHECK(!scheduler.TakePumpWork());
+
+    clock.now += milliseconds(20);
+    CHECK(scheduler.TakePumpWork());
+    CHECK(!scheduler.TakePumpWork());
+
+    // <= 0 means now; a new request replaces the old one
+    scheduler.SchedulePumpWork(500);
+    scheduler.SchedulePumpWork(0);
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 0);
+    CHECK(scheduler.TakePumpWork());
+}
+
+NX_TEST(LostPumpRequestsAreCoveredByTheFallback) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots, seconds(1));
+
+    clock.now += milliseconds(999);
+    CHECK(!scheduler.TakePumpWork());
+    clock.now += milliseconds(1);
+    CHECK(scheduler.TakePumpWork());
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 1000);
+}
+
+// -----------------------------------------------------------------------------
+// Timers
+// -----------------------------------------------------------------------------
+
+NX_TEST(TimersFireInDeadlineOrder) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    std::string order;
+    scheduler.AddTimer(milliseconds(40), [&] { order += 'c'; });
+    scheduler.AddTimer(milliseconds(16), [&] { order += 'a'; });
+    scheduler.AddTimer(milliseconds(16), [&] { order += 'b'; });
+    CHECK_EQ(scheduler.GetTimerCount(), 3u);
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 16);
+
+    clock.now += milliseconds(15);
+    CHECK_EQ(scheduler.RunDueTimers(), 0u);
+
+    clock.now += milliseconds(100);
+    CHECK_EQ(scheduler.RunDueTimers(), 3u);
+    CHECK_EQ(order, "abc");
+    CHECK_EQ(scheduler.GetTimerCount(), 0u);
+}
+
+NX_TEST(DeadlinesRoundUpToATick) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    int fired = 0;
+    scheduler.AddTimer(milliseconds(9), [&] { fired++; });
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 16);
+
+    clock.now += milliseconds(9);
+    CHECK_EQ(scheduler.RunDueTimers(), 0u);
+    clock.now += milliseconds(7);
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(fired, 1);
+}
+
+NX_TEST(TimersBeyondOneTurnWaitForTheirTurn) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    int fired = 0;
+    scheduler.AddTimer(milliseconds(1000), [&] { fired++; });
+
+    // Shares a slot with earlier ticks on every turn
+    for (int step = 0; step < 124; step++) {
+        clock.now += kTick;
+        scheduler.RunDueTimers();
+    }
+    CHECK_EQ(fired, 0);
+
+    clock.now += kTick;
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(fired, 1);
+}
+
+NX_TEST(LongJumpsRunEveryDueTimer) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    int fired = 0;
+    for (int i = 1; i <= 40; i++) {
+        scheduler.AddTimer(milliseconds(50 * i), [&] { fired++; });
+    }
+
+    // Far past a full turn of the wheel
+    clock.now += seconds(30);
+    CHECK_EQ(scheduler.RunDueTimers(), 40u);
+    CHECK_EQ(fired, 40);
+}
+
+NX_TEST(PeriodicTimersStayOnSchedule) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots, hours(1));
+
+    int fired = 0;
+    scheduler.AddTimer(milliseconds(48), [&] { fired++; }, milliseconds(48));
+
+    // Running late does not drift the period
+    clock.now += milliseconds(60);
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 36);
+
+    clock.now += milliseconds(36);
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(fired, 2);
+
+    // After falling far behind the next run is one period from now, not a burst
+    clock.now += seconds(2);
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 48);
+    CHECK_EQ(fired, 3);
+    CHECK_EQ(scheduler.GetTimerCount(), 1u);
+}
+
+NX_TEST(CancelledTimersDoNotFire) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    int fired = 0;
+    Scheduler::TimerId once = scheduler.AddTimer(milliseconds(16), [&] { fired++; });
+    Scheduler::TimerId periodic = scheduler.AddTimer(milliseconds(16), [&] { fired++; }, milliseconds(16));
+    CHECK(scheduler.CancelTimer(once));
+    CHECK(scheduler.CancelTimer(periodic));
+    CHECK(!scheduler.CancelTimer(once));
+    CHECK_EQ(scheduler.GetTimerCount(), 0u);
+
+    clock.now += seconds(1);
+    CHECK_EQ(scheduler.RunDueTimers(), 0u);
+    CHECK_EQ(fired, 0);
+
+    // A fired one-shot is gone
+    Scheduler::TimerId done = scheduler.AddTimer(milliseconds(8), [&] { fired++; });
+    clock.now += milliseconds(8);
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK(!scheduler.CancelTimer(done));
+}
+
+NX_TEST(CallbacksCanCancelLaterDueTimers) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    // Both are due in the same pass; the first cancels the second
+    std::string order;
+    Scheduler::TimerId laterOnce = 0;
+    Scheduler::TimerId laterPeriodic = 0;
+    bool cancelledOnce = false;
+    bool cancelledPeriodic = false;
+    scheduler.AddTimer(milliseconds(8), [&] {
+        order += 'a';
+        cancelledOnce = scheduler.CancelTimer(laterOnce);
+        cancelledPeriodic = scheduler.CancelTimer(laterPeriodic);
+    });
+    laterOnce = scheduler.AddTimer(milliseconds(16), [&] { order += 'b'; });
+    laterPeriodic = scheduler.AddTimer(milliseconds(24), [&] { order += 'c'; }, milliseconds(8));
+
+    clock.now += milliseconds(40);
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(order, "a");
+    CHECK(cancelledOnce);
+    CHECK(cancelledPeriodic);
+    CHECK_EQ(scheduler.GetTimerCount(), 0u);
+
+    clock.now += seconds(1);
+    CHECK_EQ(scheduler.RunDueTimers(), 0u);
+    CHECK_EQ(order, "a");
+}
+
+NX_TEST(PeriodicTimersCanCancelThemselves) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    int fired = 0;
+    Scheduler::TimerId self = 0;
+    bool cancelled = false;
+    self = scheduler.AddTimer(milliseconds(8), [&] {
+        fired++;
+        cancelled = scheduler.CancelTimer(self);
+    }, milliseconds(8));
+
+    for (int step = 0; step < 5; step++) {
+        clock.now += kTick;
+        scheduler.RunDueTimers();
+    }
+    CHECK_EQ(fired, 1);
+    CHECK(cancelled);
+    CHECK_EQ(scheduler.GetTimerCount(), 0u);
+}
+
+NX_TEST(CallbacksCanAddTimers) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots);
+
+    std::string order;
+    scheduler.AddTimer(milliseconds(8), [&] {
+        order += 'a';
+        // Due now, but runs on the next pass rather than this one
+        scheduler.AddTimer(Scheduler::Duration::zero(), [&] { order += 'b'; });
+    });
+
+    clock.now += kTick;
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(order, "a");
+    CHECK_EQ(Ms(scheduler.GetWaitTime(seconds(10))), 8);
+
+    clock.now += kTick;
+    CHECK_EQ(scheduler.RunDueTimers(), 1u);
+    CHECK_EQ(order, "ab");
+}
+
+// -----------------------------------------------------------------------------
+// Waiting
+// -----------------------------------------------------------------------------
+
+NX_TEST(EarlierDeadlinesWakeABlockedLoopOnce) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots, seconds(1));
+
+    int wakes = 0;
+    scheduler.SetWakeCallback([&] { wakes++; });
+
+    // Not waiting: nothing to wake
+    scheduler.SchedulePumpWork(0);
+    CHECK_EQ(wakes, 0);
+    CHECK(scheduler.TakePumpWork());
+
+    CHECK_EQ(Ms(scheduler.BeginWait(seconds(10))), 1000);
+    scheduler.AddTimer(seconds(5), [] {});      // later than the wait: no wake
+    CHECK_EQ(wakes, 0);
+    scheduler.SchedulePumpWork(0);
+    scheduler.SchedulePumpWork(0);
+    scheduler.AddTimer(milliseconds(8), [] {});
+    CHECK_EQ(wakes, 1);
+
+    clock.now += milliseconds(3);
+    scheduler.EndWait();
+    scheduler.SchedulePumpWork(0);
+    CHECK_EQ(wakes, 1);
+}
+
+NX_TEST(StatsCoverTheWindow) {
+    FakeClock clock;
+    Scheduler scheduler(clock.Function(), kTick, kSlots, seconds(1));
+    scheduler.AddTimer(milliseconds(100), [] {}, milliseconds(100));
+
+    // A hidden overlay: block until each deadline, run it, repeat for 2 s
+    auto end = clock.now + seconds(2);
+    while (clock.now < end) {
+        scheduler.TakePumpWork();
+        scheduler.RunDueTimers();
+        Scheduler::Duration wait = scheduler.BeginWait(seconds(3));
+        clock.now += wait;
+        scheduler.EndWait();
+        clock.now += microseconds(100);     // work between waits
+    }
+
+    SchedulerStats stats = scheduler.TakeStats();
+    CHECK_NEAR(stats.windowSeconds, 2.0, 0.11);
+    CHECK(stats.wakeups >= 18 && stats.wakeups <= 21);
+    CHECK(stats.timersFired >= 18 && stats.timersFired <= 20);
+    CHECK_EQ(stats.pumpRuns, 1u);         // the fallback pump, once a second
+    CHECK(stats.idleFraction > 0.99);
+    CHECK_NEAR(stats.wakeupsPerSecond, stats.wakeups / stats.windowSeconds, 1e-9);
+
+    SchedulerStats empty = scheduler.TakeStats();
+    CHECK_EQ(empty.wakeups, 0u);
+    CHECK_EQ(empty.timersFired, 0u);
+}
@@ -0,0 +1,210 @@
+#include "TestHarness.h"
+
+#include "Core/StartupProfiler.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+using namespace Nexile;
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+namespace {
+    // Fake clock; the profiler reads it through a NowFunction
+    struct FakeClock {
+        StartupProfiler::TimePoint now = StartupProfiler::TimePoint() + hours(1);
+
+        StartupProfiler::NowFunction Function() {
+            return [this]() { return now; };
+        }
+
+        void Advance(int ms) { now += milliseconds(ms); }
+    };
+
+    // logger 5ms, then overlay_window 160ms holding cef 150ms and handlers 10ms
+    void RecordStartup(StartupProfiler& profiler, FakeClock& clock) {
+        {
+            auto phase = profiler.Phase("logger");
+            clock.Advance(5);
+        }
+        profiler.BeginPhase("overlay_window");
+        {
+            auto phase = profiler.Phase("cef");
+            clock.Advance(150);
+        }
+        {
+            auto phase = profiler.Phase("handlers");
+            clock.Advance(10);
+        }
+        profiler.EndPhase();
+        profiler.Mark("tray_ready");
+    }
+}
+
+NX_TEST(PhasesNestAndAreTimedFromCreation) {
+    FakeClock clock;
+    StartupProfiler profiler(clock.Function());
+    clock.Advance(2);
+    RecordStartup(profiler, clock);
+
+    const auto& phases = profiler.GetPhases();
+    REQUIRE(phases.size() == 4);
+    CHECK_EQ(phases[0].name, "logger");
+    CHECK_EQ(phases[0].depth, 0);
+    CHECK_NEAR(phases[0].startMs, 2.0, 1e-9);
+    CHECK_NEAR(phases[0].durationMs, 5.0, 1e-9);
+
+    CHECK_EQ(phases[1].name, "overlay_window");
+    CHECK_NEAR(phases[1].durationMs, 160.0, 1e-9);
+    CHECK_EQ(phases[2].depth, 1);
+    CHECK_NEAR(phases[2].startMs, 7.0, 1e-9);
+    CHECK_EQ(phases[3].depth, 1);
+    CHECK_NEAR(phases[3].startMs, 157.0, 1e-9);
+    for (const StartupPhase& phase : phases) {
+        CHECK(!phase.open);
+    }
+
+    REQUIRE(profiler.GetMarks().size() == 1);
+    CHECK_EQ(profiler.GetMarks()[0].name, "tray_ready");
+    CHECK_NEAR(profiler.GetMarks()[0].timeMs, 167.0, 1e-9);
+    CHECK_NEAR(profiler.GetElapsedMs(), 167.0, 1e-9);
+}
+
+NX_TEST(UnbalancedEndsAndOpenPhases) {
+    FakeClock clock;
+    StartupProfiler profiler(clock.Function());
+
+    // An end with nothing open is ignored
+    profiler.EndPhase();
+    CHECK(profiler.GetPhases().empty());
+
+    profiler.BeginPhase("modules");
+    clock.Advance(30);
+    CHECK(profiler.GetPhases()[0].open);
+    CHECK_NEAR(profiler.GetPhases()[0].durationMs, 0.0, 1e-9);
+
+    // A phase begun after an end starts at depth 0 again
+    profiler.EndPhase();
+    profiler.BeginPhase("tray");
+    CHECK_EQ(profiler.GetPhases()[1].depth, 0);
+    CHECK(profiler.GetPhases()[1].open);
+}
+
+NX_TEST(MovedScopesEndTheirPhaseOnce) {
+    FakeClock clock;
+    StartupProfiler profiler(clock.Function());
+    profiler.BeginPhase("outer");
+    {
+        StartupProfiler::Scope scope = profiler.Phase("inner");
+        StartupProfiler::Scope moved(std::move(scope));
+        clock.Advance(4);
+    }
+    clock.Advance(6);
+
+    // Only "inner" was ended; "outer" is still running
+    const auto& phases = profiler.GetPhases();
+    REQUIRE(phases.size() == 2);
+    CHECK(!phases[1].open);
+    CHECK_NEAR(phases[1].durationMs, 4.0, 1e-9);
+    CHECK(phases[0].open);
+
+    // A scope without a profiler does nothing
+    { StartupProfiler::Scope detached(nullptr, "none"); }
+    CHECK_EQ(profiler.GetPhases().size(), 2u);
+}
+
+NX_TEST(BudgetsApplyByName) {
+    FakeClock clock;
+    StartupProfiler profiler(clock.Function());
+    profiler.SetBudget("cef", 100);
+    RecordStartup(profiler, clock);
+
+    auto violations = profiler.GetBudgetViolations();
+    REQUIRE(violations.size() == 1);
+    CHECK_EQ(violations[0].name, "cef");
+    CHECK_NEAR(violations[0].budgetMs, 100.0, 1e-9);
+
+    // Budgets set later reach phases already recorded; being within one is fine
+    profiler.SetBudget("logger", 5);
+    profiler.SetBudget("overlay_window", 150);
+    violations = profiler.GetBudgetViolations();
+    REQUIRE(violations.size() == 2);
+    CHECK_EQ(violations[0].name, "overlay_window");
+    CHECK_EQ(violations[1].name, "cef");
+
+    // A phase still running is never over budget
+    profiler.SetBudget("game_detection", 1);
+    profiler.BeginPhase("game_detection");
+    clock.Advance(50);
+    CHECK_EQ(profiler.GetBudgetViolations().size(), 2u);
+}
+
+NX_TEST(SummaryListsTopLevelPhasesSlowestFirst) {
+    FakeClock clock;
+    StartupProfiler profiler(clock.Function());
+    profiler.SetBudget("overlay_window", 100);
+    RecordStartup(profiler, clock);
+    {
+        auto phase = profiler.Phase("tray");
+        clock.Advance(5);
+    }
+    profiler.BeginPhase("hotkeys");
+    clock.Advance(3);
+
+    // Ties keep recording order; open and nested phases are left out
+    CHECK_EQ(profiler.GetSummary(), "173ms: overlay_window 160ms (budget 100ms), logger 5ms, tray 5ms");
+}
+
+NX_TEST(ChromeTraceHoldsPhasesAndMarks) {
+    FakeClock clock;
+    StartupProfiler profiler(clock.Function());
+    profiler.SetBudget("cef", 100);
+    RecordStartup(profiler, clock);
+    profiler.BeginPhase("hotkeys");
+    clock.Advance(8);
+
+    nlohmann::json trace = nlohmann::json::parse(profiler.ToChromeTrace());
+    CHECK_EQ(trace["displayTimeUnit"], "ms");
+    const nlohmann::json& events = trace["traceEvents"];
+    REQUIRE(events.size() == 6);
+
+    // Complete events in microseconds
+    CHECK_EQ(events[1]["name"], "overlay_window");
+    CHECK_EQ(events[1]["ph"], "X");
+    CHECK_EQ(events[1]["ts"].get<double>(), 5000.0);
+    CHECK_EQ(events[1]["dur"].get<double>(), 160000.0);
+    CHECK(!events[1].contains("args"));
+    CHECK_EQ(events[2]["args"]["budgetMs"].get<double>(), 100.0);
+    CHECK_EQ(events[2]["args"]["overBudget"], true);
+
+    // The open phase is drawn up to now
+    CHECK_EQ(events[4]["name"], "hotkeys");
+    CHECK_EQ(events[4]["dur"].get<double>(), 8000.0);
+
+    // Marks are global instant events after the phases
+    CHECK_EQ(events[5]["name"], "tray_ready");
+    CHECK_EQ(events[5]["ph"], "i");
+    CHECK_EQ(events[5]["s"], "g");
+    CHECK_EQ(events[5]["ts"].get<double>(), 165000.0);
+}
+
+NX_TEST(ChromeTraceIsWrittenToDisk) {
+    FakeClock clock;
+    StartupProfiler profiler(clock.Function());
+    RecordStartup(profiler, clock);
+
+    fs::path path = fs::temp_directory_path() / ("nexile_startup_" + std::to_string(std::random_device()()) + ".json");
+    std::string error;
+    REQUIRE(profiler.WriteChromeTrace(path.u8string(), error));
+    std::ostringstream written;
+    written << std::ifstream(path, std::ios::binary).rdbuf();
+    CHECK_EQ(written.str(), profiler.ToChromeTrace());
+    fs::remove(path);
+
+    fs::path missing = fs::temp_directory_path() / "nexile_no_such_dir" / "trace.json";
+    CHECK(!profiler.WriteChromeTrace(missing.u8string(), error));
+    CHECK(error.find("Cannot open") == 0);
+}
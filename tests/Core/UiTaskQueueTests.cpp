@@ -0,0 +1,266 @@
+#include "TestHarness.h"
+
+#include "Core/UiTaskQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Nexile;
+using namespace std::chrono;
+
+namespace {
+    // Fake clock; the queue reads it through a NowFunction
+    struct FakeClock {
+        UiTaskQueue::TimePoint now = UiTaskQueue::TimePoint() + hours(1);
+
+        UiTaskQueue::NowFunction Function() {
+            return [this]() { return now; };
+        }
+    };
+
+    const TaskPriority kLanes[] = { TaskPriority::High, TaskPriority::Normal, TaskPriority::Low };
+}
+
+// -----------------------------------------------------------------------------
+// Fake clock
+// -----------------------------------------------------------------------------
+
+NX_TEST(TasksRunInLaneOrderAndFifoWithinALane) {
+    FakeClock clock;
+    UiTaskQueue queue(clock.Function());
+    std::vector<int> order;
+
+    queue.Post([&] { order.push_back(30); }, TaskPriority::Low);
+    queue.Post([&] { order.push_back(20); });
+    queue.Post([&] { order.push_back(31); }, TaskPriority::Low);
+    queue.Post([&] { order.push_back(10); }, TaskPriority::High);
+    queue.Post([&] { order.push_back(21); }, TaskPriority::Normal);
+    queue.Post([&] { order.push_back(11); }, TaskPriority::High);
+    CHECK(queue.HasPending());
+
+    CHECK_EQ(queue.Drain(), 6u);
+    CHECK((order == std::vector<int>{ 10, 11, 20, 21, 30, 31 }));
+    CHECK(!queue.HasPending());
+
+    UiTaskStats stats = queue.GetStats();
+    CHECK_EQ(stats.lanes[0].posted, 2u);
+    CHECK_EQ(stats.lanes[1].run, 2u);
+    CHECK_EQ(stats.lanes[2].run, 2u);
+    CHECK_EQ(stats.drains, 1u);
+
+    // An empty drain is not counted
+    CHECK_EQ(queue.Drain(), 0u);
+    CHECK_EQ(queue.GetStats().drains, 1u);
+}
+
+NX_TEST(LateTasksExpireUnrun) {
+    FakeClock clock;
+    UiTaskQueue queue(clock.Function());
+    int ran = 0;
+
+    queue.Post([&] { ran += 1; }, TaskPriority::Normal, milliseconds(10));
+    queue.Post([&] { ran += 10; }, TaskPriority::Normal, milliseconds(20));
+    queue.Post([&] { ran += 100; }, TaskPriority::Normal, milliseconds(50));
+    queue.Post([&] { ran += 1000; }, TaskPriority::Low);
+
+    // Exactly at its deadline a task still runs
+    clock.now += milliseconds(20);
+    CHECK_EQ(queue.Drain(), 3u);
+    CHECK_EQ(ran, 1110);
+
+    UiTaskStats stats = queue.GetStats();
+    CHECK_EQ(stats.lanes[1].expired, 1u);
+    CHECK_EQ(stats.lanes[1].run, 2u);
+    CHECK_NEAR(stats.lanes[1].lastLatencyMs, 20.0, 1e-9);
+    CHECK_NEAR(stats.lanes[1].maxLatencyMs, 20.0, 1e-9);
+    CHECK_NEAR(stats.lanes[2].averageLatencyMs, 20.0, 1e-9);
+
+    // A drain that only dropped tasks still counts
+    queue.Post([&] { ran = -1; }, TaskPriority::High, milliseconds(1));
+    clock.now += milliseconds(2);
+    CHECK_EQ(queue.Drain(), 0u);
+    CHECK_EQ(ran, 1110);
+    CHECK_EQ(queue.GetStats().lanes[0].expired, 1u);
+    CHECK_EQ(queue.GetStats().drains, 2u);
+}
+
+NX_TEST(ABurstWakesTheLoopOnce) {
+    FakeClock clock;
+    UiTaskQueue queue(clock.Function());
+    int wakes = 0;
+    queue.SetWakeCallback([&] { wakes++; });
+
+    for (int i = 0; i < 5; i++) queue.Post([] {});
+    CHECK_EQ(wakes, 1);
+
+    // The first post after a drain started wakes again, even one made by a task
+    queue.Drain();
+    queue.Post([&] { queue.Post([] {}, TaskPriority::Low); });
+    CHECK_EQ(wakes, 2);
+    queue.Drain();
+    CHECK_EQ(wakes, 3);
+    CHECK_EQ(queue.GetStats().wakes, 3u);
+}
+
+NX_TEST(BudgetLeavesTheRestForTheNextTurn) {
+    FakeClock clock;
+    UiTaskQueue queue(clock.Function());
+    int wakes = 0;
+    queue.SetWakeCallback([&] { wakes++; });
+
+    // Each task takes 5ms; a 12ms budget runs three
+    std::vector<int> order;
+    for (int i = 0; i < 4; i++) {
+        queue.Post([&, i] { order.push_back(i); clock.now += milliseconds(5); }, TaskPriority::High);
+    }
+    for (int i = 4; i < 10; i++) {
+        queue.Post([&, i] { order.push_back(i); clock.now += milliseconds(5); }, TaskPriority::Low);
+    }
+    CHECK_EQ(wakes, 1);
+
+    CHECK_EQ(queue.Drain(milliseconds(12)), 3u);
+    CHECK(queue.HasPending());
+    CHECK_EQ(wakes, 2);
+    CHECK_EQ(queue.GetStats().budgetStops, 1u);
+
+    // A high task posted meanwhile goes before the low lane
+    queue.Post([&] { order.push_back(100); }, TaskPriority::High);
+    CHECK_EQ(wakes, 2);
+    CHECK_EQ(queue.Drain(), 8u);
+    CHECK((order == std::vector<int>{ 0, 1, 2, 3, 100, 4, 5, 6, 7, 8, 9 }));
+    CHECK_EQ(queue.GetStats().budgetStops, 1u);
+
+    // Running out of budget on the last task needs no wake
+    queue.Post([&] { clock.now += milliseconds(20); });
+    CHECK_EQ(wakes, 3);
+    CHECK_EQ(queue.Drain(milliseconds(12)), 1u);
+    CHECK_EQ(wakes, 3);
+    CHECK_EQ(queue.GetStats().budgetStops, 1u);
+}
+
+NX_TEST(TasksOwnWhatTheyCarry) {
+    FakeClock clock;
+    int value = 0;
+    auto shared = std::make_shared<int>(7);
+    {
+        UiTaskQueue queue(clock.Function());
+        auto owned = std::make_unique<int>(42);
+        queue.Post([owned = std::move(owned), &value] { value = *owned; });
+        queue.Drain();
+        CHECK_EQ(value, 42);
+
+        // Tasks still queued are destroyed without running
+        queue.Post([shared, &value] { value = *shared; });
+        queue.Post([shared, &value] { value = *shared; }, TaskPriority::Low);
+        CHECK_EQ(shared.use_count(), 3);
+    }
+    CHECK_EQ(value, 42);
+    CHECK_EQ(shared.use_count(), 1);
+}
+
+// -----------------------------------------------------------------------------
+// Producers on other threads
+// -----------------------------------------------------------------------------
+
+NX_TEST(ManyProducersKeepFifoPerProducerAndLane) {
+    const int producers = 8;
+    const int tasksPerProducer = 20000;
+
+    // The consumer sleeps until woken; a lost wake times out and fails
+    UiTaskQueue queue;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool woken = false;
+    queue.SetWakeCallback([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        woken = true;
+        wakeup.notify_one();
+    });
+
+    // Touched only by tasks, which run on this thread
+    std::vector<std::vector<int>> last(producers, std::vector<int>(kTaskPriorityCount, -1));
+    int64_t total = 0;
+    bool fifo = true;
+
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; producer++) {
+        threads.emplace_back([&, producer] {
+            for (int i = 0; i < tasksPerProducer; i++) {
+                size_t lane = static_cast<size_t>(i) % kTaskPriorityCount;
+                queue.Post([&, producer, lane, i] {
+                    if (last[producer][lane] >= i) fifo = false;
+                    last[producer][lane] = i;
+                    total++;
+                }, kLanes[lane]);
+            }
+        });
+    }
+
+    const int64_t expected = static_cast<int64_t>(producers) * tasksPerProducer;
+    bool lostWake = false;
+    uint64_t drainCalls = 0;
+    while (total < expected && !lostWake) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            lostWake = !wakeup.wait_for(lock, seconds(10), [&] { return woken; });
+            woken = false;
+        }
+        queue.Drain(milliseconds(1));
+        drainCalls++;
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(!lostWake);
+    CHECK(fifo);
+    CHECK_EQ(total, expected);
+    CHECK(!queue.HasPending());
+
+    UiTaskStats stats = queue.GetStats();
+    uint64_t posted = 0, run = 0;
+    for (const TaskLaneStats& lane : stats.lanes) {
+        posted += lane.posted;
+        run += lane.run;
+        CHECK_EQ(lane.expired, 0u);
+    }
+    CHECK_EQ(posted, static_cast<uint64_t>(expected));
+    CHECK_EQ(run, static_cast<uint64_t>(expected));
+    // Producers wake the loop at most once per drain
+    CHECK(stats.wakes <= drainCalls + 1);
+}
+
+NX_TEST(ProducersRacingTheConsumerLoseNothing) {
+    // Short bursts from several threads with the consumer draining flat out
+    // in between, so producers keep linking while a lane is being emptied
+    UiTaskQueue queue;
+    std::atomic<int> producing{ 4 };
+    std::vector<int64_t> sums(4, 0);
+
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < 4; producer++) {
+        threads.emplace_back([&, producer] {
+            for (int i = 1; i <= 10000; i++) {
+                queue.Post([&, producer, i] { sums[producer] += i; }, kLanes[(i + producer) % 3]);
+                if (i % 64 == 0) std::this_thread::yield();
+            }
+            producing--;
+        });
+    }
+
+    while (producing > 0 || queue.HasPending()) {
+        queue.Drain();
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    queue.Drain();
+
+    for (int64_t sum : sums) {
+        CHECK_EQ(sum, 10000LL * 10001 / 2);
+    }
+}
@@ -0,0 +1,121 @@
+#include "TestHarness.h"
+
+#include "Game/ModMatcher.h"
+
+using namespace Nexile;
+
+namespace {
+    std::vector<int> Match(const ModMatcher& matcher, std::string_view text) {
+        std::vector<int> matches;
+        matcher.Match(text, matches);
+        return matches;
+    }
+}
+
+NX_TEST(NumbersAndCaseAreNormalised) {
+    CHECK_EQ(ModMatcher::Normalize("Monsters reflect 18% of Elemental Damage"), "monsters reflect #% of elemental damage");
+    CHECK_EQ(ModMatcher::Normalize("1.5 to 2,5"), "# to #,#");
+    CHECK_EQ(ModMatcher::Normalize("#% more"), "#% more");
+
+    ModMatcher matcher;
+    int reflect = matcher.AddPattern("reflect #% of Elemental Damage");
+    int verbatim = matcher.AddPattern("Monsters reflect 18% of Elemental Damage");
+    matcher.Compile();
+
+    CHECK(Match(matcher, "Monsters reflect 13% of Elemental Damage") == std::vector<int>({ reflect, verbatim }));
+    CHECK(Match(matcher, "Monsters reflect 13% of Physical Damage").empty());
+}
+
+NX_TEST(MatchesAreSortedAndUnique) {
+    ModMatcher matcher;
+    int cursed = matcher.AddPattern("cursed with temporal chains");
+    int shouting = matcher.AddPattern("CURSED WITH TEMPORAL CHAINS");
+    int chains = matcher.AddPattern("chains");
+    matcher.Compile();
+
+    CHECK(Match(matcher, "Players are Cursed with Temporal Chains") == std::vector<int>({ cursed, shouting, chains }));
+
+    std::vector<int> matches;
+    matcher.MatchLines({ "Temporal Chains", "Players are Cursed with Temporal Chains" }, matches);
+    CHECK(matches == std::vector<int>({ cursed, shouting, chains }));
+}
+
+NX_TEST(OverlappingPatternsAllMatch) {
+    ModMatcher matcher;
+    int he = matcher.AddPattern("he");
+    int she = matcher.AddPattern("she");
+    int hers = matcher.AddPattern("hers");
+    int his = matcher.AddPattern("his");
+    matcher.Compile();
+
+    CHECK(Match(matcher, "ushers") == std::vector<int>({ he, she, hers }));
+    CHECK(Match(matcher, "this") == std::vector<int>({ his }));
+}
+
+NX_TEST(BlankPatternsAreIgnored) {
+    ModMatcher matcher;
+    CHECK_EQ(matcher.AddPattern("   "), -1);
+    CHECK_EQ(matcher.AddPattern(""), -1);
+    CHECK_EQ(matcher.AddPattern("  avoid  "), 0);
+    matcher.Compile();
+
+    CHECK_EQ(matcher.GetPatternCount(), 1u);
+    CHECK(Match(matcher, "cannot avoid").size() == 1);
+}
+
+NX_TEST(NothingMatchesBeforeCompile) {
+    ModMatcher matcher;
+    matcher.AddPattern("life");
+    CHECK(Match(matcher, "maximum life").empty());
+
+    matcher.Compile();
+    CHECK(Match(matcher, "maximum life").size() == 1);
+}
+
+NX_TEST(RecompileKeepsIds) {
+    ModMatcher matcher;
+    int life = matcher.AddPattern("maximum life");
+    matcher.Compile();
+
+    // Added after Compile: a fresh id, matched once compiled again
+    int reflect = matcher.AddPattern("reflect #% of elemental damage");
+    CHECK_EQ(reflect, life + 1);
+    CHECK_EQ(matcher.GetPatternCount(), 2u);
+    matcher.Compile();
+
+    CHECK(Match(matcher, "+80 to maximum Life") == std::vector<int>({ life }));
+    CHECK(Match(matcher, "Monsters reflect 18% of Elemental Damage") == std::vector<int>({ reflect }));
+
+    // Duplicates added after a compile chain behind the first id
+    int again = matcher.AddPattern("Maximum Life");
+    matcher.Compile();
+    CHECK(Match(matcher, "+80 to maximum Life") == std::vector<int>({ life, again }));
+
+    matcher.Compile();
+    CHECK(Match(matcher, "+80 to maximum Life") == std::vector<int>({ life, again }));
+}
+
+NX_TEST(ClearStartsIdsAgain) {
+    ModMatcher matcher;
+    matcher.AddPattern("life");
+    matcher.AddPattern("mana");
+    matcher.Compile();
+
+    matcher.Clear();
+    CHECK_EQ(matcher.GetPatternCount(), 0u);
+    CHECK_EQ(matcher.AddPattern("mana"), 0);
+    matcher.Compile();
+    CHECK(Match(matcher, "maximum mana") == std::vector<int>({ 0 }));
+    CHECK(Match(matcher, "maximum life").empty());
+}
+
+NX_TEST(BytesOutsidePatternsResetTheScan) {
+    ModMatcher matcher;
+    int regen = matcher.AddPattern("cannot regenerate");
+    matcher.Compile();
+
+    CHECK(Match(matcher, "Players cannot Regenerate Life").size() == 1);
+    CHECK(Match(matcher, "cannot\tregenerate").empty());
+    CHECK(Match(matcher, "cannot rege\xC3\xA9nerate").empty());
+    CHECK(Match(matcher, "\xC3\xA9 cannot regenerate") == std::vector<int>({ regen }));
+}
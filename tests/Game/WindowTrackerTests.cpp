@@ -0,0 +1,314 @@
+#include "TestHarness.h"
+
+#include "Game/WindowTracker.h"
+
+#include <random>
+#include <vector>
+
+using namespace Nexile;
+
+namespace {
+    const uint64_t kGame = 0x1001;
+    const uint64_t kOther = 0x2002;
+
+    const WindowRect kMonitor{ 0, 0, 1920, 1080 };
+    const WindowRect kSecondMonitor{ 1920, 0, 4480, 1440 };
+    const WindowRect kWindowed{ 100, 50, 1380, 770 };
+    const WindowRect kMinimized{ -32000, -32000, -31840, -31972 };
+
+    // Keeps every geometry the tracker reported
+    struct Recorder {
+        std::vector<WindowGeometry> changes;
+
+        WindowTracker::ChangeCallback Callback() {
+            return [this](const WindowGeometry& geometry) { changes.push_back(geometry); };
+        }
+    };
+}
+
+NX_TEST(AttachAndMovesBumpTheVersion) {
+    WindowTracker tracker;
+    Recorder recorder;
+    tracker.SetChangeCallback(recorder.Callback());
+    CHECK(!tracker.GetGeometry().IsTracking());
+    CHECK_EQ(tracker.GetVersion(), 0u);
+
+    tracker.Attach(kGame, kWindowed, kMonitor, false, true);
+    WindowGeometry geometry = tracker.GetGeometry();
+    CHECK(geometry.IsTracking());
+    CHECK_EQ(geometry.window, kGame);
+    CHECK(geometry.rect == kWindowed);
+    CHECK(geometry.monitor == kMonitor);
+    CHECK(geometry.foreground);
+    CHECK_EQ(geometry.version, 1u);
+
+    // Dragged onto the second monitor
+    WindowRect moved{ 2000, 100, 3280, 820 };
+    tracker.OnMoved(kGame, moved, kSecondMonitor);
+    CHECK_EQ(tracker.GetVersion(), 2u);
+    CHECK(tracker.GetGeometry().rect == moved);
+    CHECK(tracker.GetGeometry().monitor == kSecondMonitor);
+
+    // The callback saw each change with its version
+    REQUIRE(recorder.changes.size() == 2);
+    CHECK_EQ(recorder.changes[0].version, 1u);
+    CHECK(recorder.changes[0].rect == kWindowed);
+    CHECK_EQ(recorder.changes[1].version, 2u);
+    CHECK(recorder.changes[1].rect == moved);
+}
+
+NX_TEST(EventsThatChangeNothingAreIgnored) {
+    WindowTracker tracker;
+    Recorder recorder;
+    tracker.SetChangeCallback(recorder.Callback());
+
+    // Nothing tracked yet
+    tracker.OnMoved(kGame, kWindowed, kMonitor);
+    tracker.OnMinimized(kGame, true);
+    tracker.OnForeground(kGame);
+    CHECK_EQ(tracker.GetVersion(), 0u);
+
+    tracker.Attach(kGame, kWindowed, kMonitor, false, true);
+
+    // Other windows, and repeats of what is already known
+    tracker.OnMoved(kOther, kMonitor, kMonitor);
+    tracker.OnMinimized(kOther, true);
+    tracker.OnMoved(kGame, kWindowed, kMonitor);
+    tracker.OnForeground(kGame);
+    tracker.Attach(kGame, kWindowed, kMonitor, false, true);
+    CHECK_EQ(tracker.GetVersion(), 1u);
+    CHECK(tracker.GetGeometry().rect == kWindowed);
+    CHECK_EQ(recorder.changes.size(), 1u);
+
+    WindowTrackerStats stats = tracker.GetStats();
+    CHECK_EQ(stats.events, 9u);
+    CHECK_EQ(stats.changes, 1u);
+    CHECK_EQ(stats.ignored, 8u);
+}
+
+NX_TEST(MinimizingKeepsTheRestoredPosition) {
+    WindowTracker tracker;
+    tracker.Attach(kGame, kWindowed, kMonitor, false, true);
+
+    // Windows moves the window off screen before the minimize event arrives
+    tracker.OnMoved(kGame, kMinimized, kMonitor);
+    WindowGeometry geometry = tracker.GetGeometry();
+    CHECK(geometry.minimized);
+    CHECK(geometry.rect == kWindowed);
+    CHECK(geometry.monitor == kMonitor);
+    CHECK_EQ(geometry.version, 2u);
+
+    // The minimize event itself then changes nothing
+    tracker.OnMinimized(kGame, true);
+    CHECK_EQ(tracker.GetVersion(), 2u);
+
+    // Restoring: either event clears the flag, the move also brings the rect
+    tracker.OnMinimized(kGame, false);
+    CHECK(!tracker.GetGeometry().minimized);
+    CHECK(tracker.GetGeometry().rect == kWindowed);
+
+    tracker.OnMinimized(kGame, true);
+    WindowRect restored{ 200, 150, 1480, 870 };
+    tracker.OnMoved(kGame, restored, kMonitor);
+    CHECK(!tracker.GetGeometry().minimized);
+    CHECK(tracker.GetGeometry().rect == restored);
+}
+
+NX_TEST(AttachingAMinimizedWindow) {
+    WindowTracker tracker;
+
+    // Minimized from the start: the position is not known yet
+    tracker.Attach(kGame, kMinimized, kMonitor, false, false);
+    WindowGeometry geometry = tracker.GetGeometry();
+    CHECK(geometry.IsTracking());
+    CHECK(geometry.minimized);
+    CHECK(geometry.rect.IsEmpty());
+    CHECK(geometry.monitor.IsEmpty());
+    CHECK(!geometry.IsFullscreen());
+
+    tracker.OnMoved(kGame, kWindowed, kMonitor);
+    CHECK(tracker.GetGeometry().rect == kWindowed);
+    CHECK(!tracker.GetGeometry().minimized);
+
+    // Attaching the same window again while minimized keeps its position
+    tracker.Attach(kGame, kMinimized, kMonitor, true, false);
+    CHECK(tracker.GetGeometry().minimized);
+    CHECK(tracker.GetGeometry().rect == kWindowed);
+
+    // A different window that is minimized starts with no position
+    tracker.Attach(kOther, kMinimized, kMonitor, true, false);
+    CHECK_EQ(tracker.GetGeometry().window, kOther);
+    CHECK(tracker.GetGeometry().rect.IsEmpty());
+}
+
+NX_TEST(ForegroundFollowsTheActiveWindow) {
+    WindowTracker tracker;
+    tracker.Attach(kGame, kMonitor, kMonitor, false, false);
+    CHECK(!tracker.GetGeometry().foreground);
+
+    tracker.OnForeground(kGame);
+    CHECK(tracker.GetGeometry().foreground);
+    tracker.OnForeground(kOther);
+    CHECK(!tracker.GetGeometry().foreground);
+    tracker.OnForeground(kOther);
+    CHECK_EQ(tracker.GetVersion(), 3u);
+}
+
+NX_TEST(FullscreenMeansTheRectIsTheMonitor) {
+    WindowTracker tracker;
+    CHECK(!tracker.GetGeometry().IsFullscreen());
+
+    tracker.Attach(kGame, kMonitor, kMonitor, false, true);
+    CHECK(tracker.GetGeometry().IsFullscreen());
+
+    tracker.OnMoved(kGame, kWindowed, kMonitor);
+    CHECK(!tracker.GetGeometry().IsFullscreen());
+
+    // Minimizing keeps the fullscreen rect, so it still reads as fullscreen
+    tracker.OnMoved(kGame, kSecondMonitor, kSecondMonitor);
+    tracker.OnMoved(kGame, kMinimized, kMonitor);
+    CHECK(tracker.GetGeometry().minimized);
+    CHECK(tracker.GetGeometry().IsFullscreen());
+}
+
+NX_TEST(DetachClearsButKeepsCounting) {
+    WindowTracker tracker;
+    Recorder recorder;
+    tracker.SetChangeCallback(recorder.Callback());
+    tracker.Attach(kGame, kWindowed, kMonitor, false, true);
+    tracker.OnMoved(kGame, kMonitor, kMonitor);
+
+    tracker.Detach();
+    WindowGeometry geometry = tracker.GetGeometry();
+    CHECK(!geometry.IsTracking());
+    CHECK(geometry.rect.IsEmpty());
+    CHECK(!geometry.foreground);
+    CHECK_EQ(geometry.version, 3u);
+
+    // Late events for the old window change nothing; a second detach neither
+    tracker.OnMoved(kGame, kWindowed, kMonitor);
+    tracker.OnForeground(kGame);
+    tracker.Detach();
+    CHECK_EQ(tracker.GetVersion(), 3u);
+
+    // The version never goes back, even for the same window again
+    tracker.Attach(kGame, kWindowed, kMonitor, false, true);
+    CHECK_EQ(tracker.GetVersion(), 4u);
+    REQUIRE(recorder.changes.size() == 4);
+    CHECK(!recorder.changes[2].IsTracking());
+}
+
+NX_TEST(TheCallbackMayReadTheTracker) {
+    WindowTracker tracker;
+    std::vector<uint64_t> versions;
+
+    // Called outside the lock, so reading back (or a nested event) is fine
+    tracker.SetChangeCallback([&](const WindowGeometry& geometry) {
+        versions.push_back(tracker.GetVersion());
+        if (geometry.minimized) {
+            tracker.OnMinimized(kGame, false);
+        }
+    });
+    tracker.Attach(kGame, kWindowed, kMonitor, false, true);
+    tracker.OnMinimized(kGame, true);
+
+    CHECK((versions == std::vector<uint64_t>{ 1, 2, 3 }));
+    CHECK(!tracker.GetGeometry().minimized);
+}
+
+// -----------------------------------------------------------------------------
+// Synthetic event streams
+// -----------------------------------------------------------------------------
+
+NX_TEST(RandomEventStreamsMatchAModel) {
+    const WindowRect rects[] = { kMonitor, kSecondMonitor, kWindowed, { 10, 10, 810, 610 }, kMinimized };
+    const WindowRect monitors[] = { kMonitor, kSecondMonitor };
+    const uint64_t windows[] = { kGame, kOther, 0x3003 };
+
+    std::mt19937 rng(7);
+    for (int stream = 0; stream < 50; stream++) {
+        WindowTracker tracker;
+        Recorder recorder;
+        tracker.SetChangeCallback(recorder.Callback());
+
+        // What the tracker should hold, updated by the rules in its header
+        WindowGeometry model;
+        bool ok = true;
+        for (int step = 0; step < 400 && ok; step++) {
+            uint64_t window = windows[rng() % 3];
+            const WindowRect& rect = rects[rng() % 5];
+            const WindowRect& monitor = monitors[rng() % 2];
+            bool flag = rng() % 2 == 0;
+            bool minimizedRect = rect == kMinimized;
+
+            WindowGeometry expected = model;
+            switch (rng() % 10) {
+            case 0:
+                if (!minimizedRect) {
+                    expected.rect = rect;
+                    expected.monitor = monitor;
+                } else if (expected.window != window) {
+                    expected.rect = WindowRect();
+                    expected.monitor = WindowRect();
+                }
+                expected.window = window;
+                expected.minimized = flag || minimizedRect;
+                expected.foreground = !flag;
+                tracker.Attach(window, rect, monitor, flag, !flag);
+                break;
+            case 1:
+                expected = WindowGeometry();
+                tracker.Detach();
+                break;
+            case 2:
+            case 3:
+            case 4:
+            case 5:
+                if (model.IsTracking() && window == model.window) {
+                    if (minimizedRect) {
+                        expected.minimized = true;
+                    } else {
+                        expected.rect = rect;
+                        expected.monitor = monitor;
+                        expected.minimized = false;
+                    }
+                }
+                tracker.OnMoved(window, rect, monitor);
+                break;
+            case 6:
+            case 7:
+                if (model.IsTracking() && window == model.window) expected.minimized = flag;
+                tracker.OnMinimized(window, flag);
+                break;
+            default:
+                if (model.IsTracking()) expected.foreground = window == model.window;
+                tracker.OnForeground(window);
+                break;
+            }
+
+            bool changed = expected.window != model.window || expected.rect != model.rect ||
+                expected.monitor != model.monitor || expected.minimized != model.minimized ||
+                expected.foreground != model.foreground;
+            expected.version = model.version + (changed ? 1 : 0);
+            model = expected;
+
+            WindowGeometry geometry = tracker.GetGeometry();
+            ok = geometry.version == model.version && geometry.window == model.window &&
+                geometry.rect == model.rect && geometry.monitor == model.monitor &&
+                geometry.minimized == model.minimized && geometry.foreground == model.foreground;
+            if (!ok) {
+                Test::Fail(__FILE__, __LINE__, "stream " + std::to_string(stream) + " diverged at step " +
+                           std::to_string(step));
+            }
+        }
+
+        // One callback per change, in version order
+        WindowTrackerStats stats = tracker.GetStats();
+        CHECK_EQ(stats.changes, model.version);
+        CHECK_EQ(stats.events, stats.changes + stats.ignored);
+        REQUIRE(recorder.changes.size() == model.version);
+        for (size_t i = 0; i < recorder.changes.size(); i++) {
+            CHECK_EQ(recorder.changes[i].version, i + 1);
+        }
+    }
+}
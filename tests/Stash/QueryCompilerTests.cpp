@@ -0,0 +1,280 @@
+#include "TestHarness.h"
+
+#include "Stash/QueryCompiler.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace Nexile;
+
+namespace {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+
+    StashItemRecord Item(const char* baseType, StashRarity rarity, int itemLevel, std::vector<std::string> mods) {
+        StashItemRecord record;
+        record.baseType = baseType;
+        record.rarity = static_cast<uint8_t>(rarity);
+        record.itemLevel = static_cast<uint8_t>(itemLevel);
+        record.mods = std::move(mods);
+        return record;
+    }
+
+    // Six items with hand-checked columns; rows are referred to by index below
+    const StashStore& Store() {
+        static StashStore store = [] {
+            StashStore s;
+            s.AddItem(Item("Two-Stone Ring", StashRarity::Rare, 84, { "+45 to maximum Life", "+35% to Fire Resistance" }));
+            s.AddItem(Item("Diamond Ring", StashRarity::Magic, 75, { "+20 to maximum Life" }));
+            s.AddItem(Item("Leather Belt", StashRarity::Rare, 78, { "+80 to maximum Life", "+10% to Fire Resistance" }));
+            s.AddItem(Item("Leather Belt", StashRarity::Unique, 86, { "+40 to maximum Life" }));
+            s.AddItem(Item("Onyx Amulet", StashRarity::Normal, 60, {}));
+            s.AddItem(Item("Amethyst Ring", StashRarity::Rare, 74, { "+12% to Fire and Cold Resistances" }));
+            return s;
+        }();
+        return store;
+    }
+
+    StashQuery CompileOk(const char* text) {
+        StashQuery query;
+        std::string error;
+        bool compiled = QueryCompiler::Compile(text, Store(), query, error);
+        if (!compiled) {
+            Test::Fail(__FILE__, __LINE__, std::string(text) + ": " + error);
+        }
+        return query;
+    }
+
+    std::string CompileError(const char* text) {
+        StashQuery query;
+        std::string error;
+        if (QueryCompiler::Compile(text, Store(), query, error)) {
+            return "(compiled)";
+        }
+        return error;
+    }
+
+    std::vector<uint32_t> Rows(const char* text) {
+        StashBitmap result;
+        CompileOk(text).Execute(Store(), result);
+        std::vector<uint32_t> rows;
+        result.GetRows(rows);
+        return rows;
+    }
+
+    std::vector<QueryOp> Ops(const StashQuery& query) {
+        std::vector<QueryOp> ops;
+        for (const QueryInstruction& instruction : query.GetInstructions()) {
+            ops.push_back(instruction.op);
+        }
+        return ops;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Lexer
+// -----------------------------------------------------------------------------
+
+NX_TEST(OperatorSpellingsCompileAlike) {
+    std::string words = CompileOk("ilvl >= 84 and rarity = rare or not base ~ belt").Disassemble();
+    CHECK_EQ(CompileOk("ILVL>=84 AND rarity==rare || !base~belt").Disassemble(), words);
+    CHECK_EQ(CompileOk("ilvl >= 84 && rarity = 'Rare' Or NOT base ~ \"belt\"").Disassemble(), words);
+    CHECK_EQ(CompileOk("rarity <> rare").Disassemble(), CompileOk("rarity != rare").Disassemble());
+    CHECK_EQ(CompileOk("itemlevel > 80").Disassemble(), CompileOk("item_level > 80").Disassemble());
+}
+
+NX_TEST(LexerErrorsNameThePosition) {
+    CHECK_EQ(CompileError("base = \"ring"), "Unterminated string at 7");
+    CHECK_EQ(CompileError("base = 'ring\""), "Unterminated string at 7");
+    CHECK_EQ(CompileError("ilvl > 1 & rarity = rare"), "Expected '&&' at 9");
+    CHECK_EQ(CompileError("ilvl > 1 | rarity = rare"), "Expected '||' at 9");
+    CHECK_EQ(CompileError("ilvl # 1"), "Unexpected character '#' at 5");
+    CHECK_EQ(CompileError(("ilvl > " + std::string(400, '9')).c_str()), "Invalid number '" + std::string(400, '9') + "' at 7");
+}
+
+NX_TEST(EmptyQueryMatchesEverything) {
+    CHECK(Ops(CompileOk("")) == std::vector<QueryOp>({ QueryOp::All }));
+    CHECK(Ops(CompileOk(" \t\r\n")) == std::vector<QueryOp>({ QueryOp::All }));
+    CHECK_EQ(Rows("").size(), Store().GetItemCount());
+}
+
+// -----------------------------------------------------------------------------
+// Parser
+// -----------------------------------------------------------------------------
+
+NX_TEST(AndBindsTighterThanOr) {
+    StashQuery query = CompileOk("rarity = magic or rarity = rare and ilvl >= 84");
+    CHECK(Ops(query) == std::vector<QueryOp>({ QueryOp::ScanRarity, QueryOp::ScanRarity, QueryOp::ScanItemLevel,
+                                               QueryOp::And, QueryOp::Or }));
+    CHECK(Rows("rarity = magic or rarity = rare and ilvl >= 84") == std::vector<uint32_t>({ 0, 1 }));
+    CHECK(Rows("(rarity = magic or rarity = rare) and ilvl >= 84") == std::vector<uint32_t>({ 0 }));
+}
+
+NX_TEST(NotBindsToTheNextTerm) {
+    CHECK(Rows("not rarity = rare and ilvl > 70") == std::vector<uint32_t>({ 1, 3 }));
+    CHECK(Rows("not (rarity = rare and ilvl > 70)") == std::vector<uint32_t>({ 1, 3, 4 }));
+}
+
+NX_TEST(NestedAndOrAreFlattened) {
+    StashQuery query = CompileOk("(rarity = rare || rarity = magic) || rarity = unique");
+    CHECK(Ops(query) == std::vector<QueryOp>({ QueryOp::ScanRarity, QueryOp::ScanRarity, QueryOp::Or,
+                                               QueryOp::ScanRarity, QueryOp::Or }));
+    CHECK(Rows("(rarity = rare || rarity = magic) || rarity = unique") == std::vector<uint32_t>({ 0, 1, 2, 3, 5 }));
+}
+
+NX_TEST(ParserErrorsNameThePosition) {
+    CHECK_EQ(CompileError("ilvl >"), "Expected a value at 6");
+    CHECK_EQ(CompileError("(ilvl > 1"), "Expected ')' at 9");
+    CHECK_EQ(CompileError("ilvl > (1 + 2"), "Expected ')' at 13");
+    CHECK_EQ(CompileError("ilvl 5"), "Expected a comparison after 'ilvl' at 5");
+    CHECK_EQ(CompileError("= 5"), "Expected a field at 0");
+    CHECK_EQ(CompileError("ilvl > 1)"), "Unexpected ')' at 8");
+    CHECK_EQ(CompileError("ilvl > 1 rarity = rare"), "Unexpected 'rarity' at 9");
+    CHECK_EQ(CompileError("ilvl > 1 and"), "Expected a field at 12");
+}
+
+// -----------------------------------------------------------------------------
+// Resolution
+// -----------------------------------------------------------------------------
+
+NX_TEST(FieldsResolveAgainstTheStore) {
+    const StashStore& store = Store();
+    CHECK(Rows("base = 'diamond ring'") == std::vector<uint32_t>({ 1 }));
+    CHECK(Rows("base ~ RING") == std::vector<uint32_t>({ 0, 1, 5 }));
+    CHECK(Rows("type != 'Leather Belt'") == std::vector<uint32_t>({ 0, 1, 4, 5 }));
+    CHECK(Rows("frame = unique") == std::vector<uint32_t>({ 3 }));
+
+    StashQuery query = CompileOk("\"+40 to maximum Life\" > 30");
+    const std::vector<QueryInstruction>& code = query.GetInstructions();
+    REQUIRE(code.size() == 1);
+    CHECK(code[0].op == QueryOp::ScanStat);
+    CHECK_EQ(code[0].arg, store.FindStat("+# to maximum life"));
+    CHECK(Rows("\"+# to maximum life\" > 30") == std::vector<uint32_t>({ 0, 2, 3 }));
+
+    // Pseudo columns sum every contributing mod
+    CHECK(Rows("pseudo.total_fire_resistance >= 12") == std::vector<uint32_t>({ 0, 5 }));
+    CHECK(Rows("PSEUDO.TOTAL_LIFE = 80") == std::vector<uint32_t>({ 2 }));
+}
+
+NX_TEST(UnknownNamesFoldToConstants) {
+    // No item has the stat or base, so the comparison is decided at compile time
+    CHECK(Ops(CompileOk("base = 'Nope' or \"unknown stat\" > 1")) == std::vector<QueryOp>({ QueryOp::None }));
+    CHECK(Ops(CompileOk("\"unknown stat\" != 1")) == std::vector<QueryOp>({ QueryOp::All }));
+    CHECK(Ops(CompileOk("base != 'Nope'")) == std::vector<QueryOp>({ QueryOp::All }));
+    CHECK(Ops(CompileOk("ilvl > 80 and base != 'Nope'")) == std::vector<QueryOp>({ QueryOp::ScanItemLevel }));
+    CHECK(Rows("base = 'Nope'").empty());
+}
+
+NX_TEST(ResolutionErrorsNameTheField) {
+    CHECK_EQ(CompileError("foo = 1"), "Unknown field 'foo' at 0");
+    CHECK_EQ(CompileError("rarity = 5"), "Unknown rarity at 0");
+    CHECK_EQ(CompileError("rarity = legendary"), "Unknown rarity at 0");
+    CHECK_EQ(CompileError("rarity > rare"), "Rarity only supports = and != at 0");
+    CHECK_EQ(CompileError("ilvl = 'x'"), "'ilvl' needs a number at 0");
+    CHECK_EQ(CompileError("ilvl ~ 3"), "'~' cannot compare numbers at 0");
+    CHECK_EQ(CompileError("base < 3"), "'base' needs text at 0");
+    CHECK_EQ(CompileError("base < ring"), "Base type only supports =, != and ~ at 0");
+    CHECK_EQ(CompileError("pseudo.total_luck > 1"), "Unknown pseudo stat 'pseudo.total_luck' at 0");
+    CHECK_EQ(CompileError("ilvl > 1 and '' > 1"), "Empty stat at 13");
+}
+
+// -----------------------------------------------------------------------------
+// Simplifier
+// -----------------------------------------------------------------------------
+
+NX_TEST(ConstantsAreFolded) {
+    StashQuery query = CompileOk("ilvl >= 2*37");
+    const std::vector<QueryInstruction>& code = query.GetInstructions();
+    REQUIRE(code.size() == 1);
+    CHECK(code[0].op == QueryOp::ScanItemLevel);
+    CHECK_EQ(code[0].lo, 74.0f);
+    CHECK(code[0].hi == kInfinity);
+
+    StashQuery folded = CompileOk("ilvl <= (100 - 10) / 2 + -1");
+    const std::vector<QueryInstruction>& arithmetic = folded.GetInstructions();
+    REQUIRE(arithmetic.size() == 1);
+    CHECK_EQ(arithmetic[0].hi, 44.0f);
+    CHECK(arithmetic[0].lo == -kInfinity);
+
+    CHECK_EQ(CompileError("ilvl > 1/0"), "Division by zero at 8");
+    CHECK_EQ(CompileError("ilvl > 'a' + 1"), "Arithmetic on text at 11");
+    CHECK_EQ(CompileError("ilvl > -'a'"), "Cannot negate text at 7");
+}
+
+NX_TEST(StrictBoundsRoundInwards) {
+    // > and < become the next representable float; the integer column rounds inwards
+    StashQuery query = CompileOk("ilvl > 74 and ilvl < 78");
+    const std::vector<QueryInstruction>& code = query.GetInstructions();
+    REQUIRE(code.size() == 1);
+    CHECK_EQ(code[0].lo, std::nextafter(74.0f, kInfinity));
+    CHECK_EQ(code[0].hi, std::nextafter(78.0f, -kInfinity));
+    CHECK(Rows("ilvl > 74 and ilvl < 78") == std::vector<uint32_t>({ 1 }));
+    CHECK(Rows("ilvl > 74.5 and ilvl <= 78") == std::vector<uint32_t>({ 1, 2 }));
+    CHECK(Rows("ilvl > 300 or ilvl < -5").empty());
+}
+
+NX_TEST(RangesOnTheSameColumnMerge) {
+    StashQuery query = CompileOk("ilvl > 70 and ilvl < 80 and ilvl >= 2*37");
+    const std::vector<QueryInstruction>& code = query.GetInstructions();
+    REQUIRE(code.size() == 1);
+    CHECK(code[0].op == QueryOp::ScanItemLevel);
+    CHECK_EQ(code[0].lo, 74.0f);
+    CHECK_EQ(code[0].hi, std::nextafter(80.0f, -kInfinity));
+    CHECK(Rows("ilvl > 70 and ilvl < 80 and ilvl >= 2*37") == std::vector<uint32_t>({ 1, 2, 5 }));
+
+    // Quoted stats merge when they name the same stat, whatever the number in the text
+    StashQuery statQuery = CompileOk("\"+# to maximum life\" >= 20 and '+40 to maximum Life' < 45");
+    const std::vector<QueryInstruction>& stat = statQuery.GetInstructions();
+    REQUIRE(stat.size() == 1);
+    CHECK(stat[0].op == QueryOp::ScanStat);
+    CHECK(Rows("\"+# to maximum life\" >= 20 and '+40 to maximum Life' < 45") == std::vector<uint32_t>({ 1, 3 }));
+
+    // Merging reaches through nested ANDs but not across different columns
+    StashQuery mixed = CompileOk("ilvl > 70 and (pseudo.total_life > 10 and ilvl < 80)");
+    CHECK(Ops(mixed) == std::vector<QueryOp>({ QueryOp::ScanItemLevel, QueryOp::ScanPseudo, QueryOp::And }));
+    CHECK(Rows("ilvl > 70 and (pseudo.total_life > 10 and ilvl < 80)") == std::vector<uint32_t>({ 1, 2 }));
+
+    // Ranges under OR are left alone
+    CHECK(Ops(CompileOk("ilvl < 70 or ilvl > 80")) ==
+          std::vector<QueryOp>({ QueryOp::ScanItemLevel, QueryOp::ScanItemLevel, QueryOp::Or }));
+}
+
+NX_TEST(EmptyRangesFoldToNone) {
+    CHECK(Ops(CompileOk("ilvl > 90 and ilvl < 80")) == std::vector<QueryOp>({ QueryOp::None }));
+    CHECK(Ops(CompileOk("rarity = rare and (ilvl > 90 and ilvl < 80)")) == std::vector<QueryOp>({ QueryOp::None }));
+    CHECK(Ops(CompileOk("ilvl = 75 and ilvl != 75")) ==
+          std::vector<QueryOp>({ QueryOp::ScanItemLevel, QueryOp::ScanItemLevel, QueryOp::Not, QueryOp::And }));
+    CHECK(Rows("ilvl > 90 and ilvl < 80").empty());
+
+    // A false branch drops out of an OR
+    CHECK(Ops(CompileOk("rarity = magic or (ilvl > 90 and ilvl < 80)")) == std::vector<QueryOp>({ QueryOp::ScanRarity }));
+}
+
+NX_TEST(DoubleNegationCancels) {
+    CHECK(Ops(CompileOk("not not rarity != unique")) == std::vector<QueryOp>({ QueryOp::ScanRarity, QueryOp::Not }));
+    CHECK(Ops(CompileOk("!!!(rarity = unique)")) == std::vector<QueryOp>({ QueryOp::ScanRarity, QueryOp::Not }));
+    CHECK(Ops(CompileOk("not (base = 'Nope')")) == std::vector<QueryOp>({ QueryOp::All }));
+    CHECK(Rows("ilvl > 70 and ilvl < 80 and ilvl >= 2*37 and not not rarity != unique") == std::vector<uint32_t>({ 1, 2, 5 }));
+}
+
+// -----------------------------------------------------------------------------
+// Evaluation
+// -----------------------------------------------------------------------------
+
+NX_TEST(ProgramsCanBeRunRepeatedly) {
+    StashQuery query = CompileOk("(rarity = rare || rarity = magic) && !(base ~ belt)");
+    StashBitmap first;
+    StashBitmap second;
+    query.Execute(Store(), first);
+    query.Execute(Store(), second);
+
+    std::vector<uint32_t> rows;
+    second.GetRows(rows);
+    CHECK(rows == std::vector<uint32_t>({ 0, 1, 5 }));
+    CHECK_EQ(first.Count(), second.Count());
+}
+
+NX_TEST(DisassemblyListsEveryInstruction) {
+    std::string listing = CompileOk("base ~ ring and \"+# to maximum life\" > 40 or not rarity = rare").Disassemble();
+    std::string stat = std::to_string(Store().FindStat("+# to maximum life"));
+    CHECK_EQ(listing, "SCAN_BASE_CONTAINS \"ring\"\nSCAN_STAT " + stat + " [40, inf]\nAND\nSCAN_RARITY 2\nNOT\nOR\n");
+}
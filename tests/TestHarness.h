@@ -0,0 +1,82 @@
+#pragma once
+
+// Minimal test registry for the portable cores.
+//
+// Each test executable links TestMain.cpp and any number of files declaring
+// NX_TEST cases. CHECK records a failure and carries on; REQUIRE stops the
+// current case. Run an executable with a substring to run matching cases only.
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Nexile {
+    namespace Test {
+
+        using TestFunction = void (*)();
+
+        struct TestCase {
+            const char* name;
+            TestFunction run;
+        };
+
+        std::vector<TestCase>& Registry();
+
+        struct Registrar {
+            Registrar(const char* name, TestFunction run) { Registry().push_back({ name, run }); }
+        };
+
+        // Thrown by REQUIRE to abandon the current case
+        struct RequireFailed : std::runtime_error {
+            using std::runtime_error::runtime_error;
+        };
+
+        // Record a failed check of the current case
+        void Fail(const char* file, int line, const std::string& message);
+
+        template <typename A, typename B>
+        std::string Describe(const char* expression, const A& a, const B& b) {
+            std::ostringstream out;
+            out << expression << " (" << a << " vs " << b << ")";
+            return out.str();
+        }
+
+        // Directory of recorded test data (tests/data)
+        std::string DataPath(const std::string& name);
+
+    } // namespace Test
+} // namespace Nexile
+
+#define NX_TEST(name)                                                            \
+    static void name();                                                          \
+    static ::Nexile::Test::Registrar name##_registrar(#name, name);              \
+    static void name()
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        if (!(condition)) ::Nexile::Test::Fail(__FILE__, __LINE__, #condition); \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                           \
+    do {                                                                         \
+        if (!((a) == (b)))                                                       \
+            ::Nexile::Test::Fail(__FILE__, __LINE__,                             \
+                ::Nexile::Test::Describe(#a " == " #b, (a), (b)));               \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance)                                              \
+    do {                                                                         \
+        if (!(std::fabs((a) - (b)) <= (tolerance)))                              \
+            ::Nexile::Test::Fail(__FILE__, __LINE__,                             \
+                ::Nexile::Test::Describe(#a " ~= " #b, (a), (b)));               \
+    } while (0)
+
+#define REQUIRE(condition)                                                       \
+    do {                                                                         \
+        if (!(condition)) {                                                      \
+            ::Nexile::Test::Fail(__FILE__, __LINE__, #condition);                \
+            throw ::Nexile::Test::RequireFailed(#condition);                     \
+        }                                                                        \
+    } while (0)
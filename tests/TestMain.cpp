@@ -0,0 +1,66 @@
+#include "TestHarness.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#ifndef NEXILE_TEST_DATA_DIR
+#define NEXILE_TEST_DATA_DIR "data"
+#endif
+
+namespace Nexile {
+    namespace Test {
+
+        namespace {
+            int g_failures = 0;
+        }
+
+        std::vector<TestCase>& Registry() {
+            static std::vector<TestCase> cases;
+            return cases;
+        }
+
+        void Fail(const char* file, int line, const std::string& message) {
+            g_failures++;
+            fprintf(stderr, "  %s:%d: check failed: %s\n", file, line, message.c_str());
+        }
+
+        std::string DataPath(const std::string& name) {
+            return std::string(NEXILE_TEST_DATA_DIR) + "/" + name;
+        }
+
+    } // namespace Test
+} // namespace Nexile
+
+int main(int argc, char** argv) {
+    using namespace Nexile::Test;
+
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    int failed = 0;
+
+    for (const TestCase& test : Registry()) {
+        if (filter && !strstr(test.name, filter)) {
+            continue;
+        }
+
+        int failuresBefore = g_failures;
+        try {
+            test.run();
+        } catch (const RequireFailed&) {
+            // Already reported
+        } catch (const std::exception& e) {
+            Fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+
+        run++;
+        bool passed = g_failures == failuresBefore;
+        if (!passed) {
+            failed++;
+        }
+        printf("[%s] %s\n", passed ? " OK " : "FAIL", test.name);
+    }
+
+    printf("%d of %d cases passed\n", run - failed, run);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#include "TestHarness.h"
+
+#include "Trade/ArbitrageScanner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace Nexile;
+
+namespace {
+    // Loads a recorded ratio book from tests/data/arbitrage
+    CurrencyGraph LoadSnapshot(const std::string& name) {
+        std::ifstream file(Test::DataPath("arbitrage/" + name));
+        REQUIRE(file.is_open());
+        std::ostringstream text;
+        text << file.rdbuf();
+
+        CurrencyGraph graph;
+        std::string error;
+        REQUIRE(graph.LoadSnapshot(text.str(), error));
+        return graph;
+    }
+
+    std::vector<std::string> Ids(const CurrencyGraph& graph, const ArbitrageCycle& cycle) {
+        std::vector<std::string> ids;
+        for (int currency : cycle.currencies) {
+            ids.push_back(graph.GetCurrency(currency).id);
+        }
+        return ids;
+    }
+
+    // Same cycle regardless of where it was entered
+    bool IsRotationOf(std::vector<std::string> cycle, const std::vector<std::string>& expected) {
+        if (cycle.size() != expected.size()) return false;
+        for (size_t i = 0; i < cycle.size(); i++) {
+            if (cycle == expected) return true;
+            std::rotate(cycle.begin(), cycle.begin() + 1, cycle.end());
+        }
+        return false;
+    }
+}
+
+NX_TEST(TriangleCycleIsFound) {
+    CurrencyGraph graph = LoadSnapshot("triangle.json");
+    ArbitrageScanner scanner;
+    const auto& results = scanner.Scan(graph);
+
+    REQUIRE(results.size() == 1);
+    const ArbitrageCycle& cycle = results[0];
+    CHECK(IsRotationOf(Ids(graph, cycle), { "chaos", "divine", "exalted" }));
+    CHECK_NEAR(cycle.rateProduct, 0.0052 * 21 * 9.8, 1e-9);
+    CHECK_NEAR(cycle.profitFraction, cycle.rateProduct - 1.0, 1e-12);
+}
+
+NX_TEST(TriangleVolumeIsBoundByThinnestListing) {
+    CurrencyGraph graph = LoadSnapshot("triangle.json");
+    ArbitrageScanner scanner;
+    const auto& results = scanner.Scan(graph);
+    REQUIRE(results.size() == 1);
+
+    // Entered at chaos: 10 divines listed at 0.0052 per chaos caps the start amount
+    const ArbitrageCycle& cycle = results[0];
+    REQUIRE(graph.GetCurrency(cycle.currencies[0]).id == "chaos");
+    CHECK_NEAR(cycle.maxVolume, 10 / 0.0052, 1e-6);
+    CHECK_NEAR(cycle.expectedProfit, cycle.profitFraction * cycle.maxVolume, 1e-9);
+    CHECK_NEAR(cycle.expectedProfitChaos, cycle.expectedProfit, 1e-9);
+}
+
+NX_TEST(ConsistentBookHasNoCycles) {
+    CurrencyGraph graph = LoadSnapshot("consistent.json");
+    ArbitrageScanner scanner;
+    CHECK(scanner.Scan(graph).empty());
+}
+
+NX_TEST(RotationsAreReportedOnce) {
+    // Every currency of the four-trade loop starts a scan that closes it
+    CurrencyGraph graph = LoadSnapshot("square.json");
+    ArbitrageScanner scanner;
+    const auto& results = scanner.Scan(graph);
+
+    REQUIRE(results.size() == 1);
+    CHECK(IsRotationOf(Ids(graph, results[0]), { "chaos", "divine", "exalted", "annul" }));
+    CHECK_NEAR(results[0].rateProduct, 1.02, 1e-9);
+}
+
+NX_TEST(CycleLengthIsBounded) {
+    CurrencyGraph graph = LoadSnapshot("square.json");
+
+    ArbitrageScanOptions options;
+    options.maxCycleLength = 3;
+    ArbitrageScanner scanner(options);
+    CHECK(scanner.Scan(graph).empty());
+
+    options.maxCycleLength = 4;
+    scanner.SetOptions(options);
+    CHECK_EQ(scanner.Scan(graph).size(), 1u);
+}
+
+NX_TEST(RankedByChaosProfitThenMargin) {
+    CurrencyGraph graph = LoadSnapshot("ranking.json");
+    ArbitrageScanner scanner;
+    const auto& results = scanner.Scan(graph);
+
+    // chance/jewellers: 2% on 980 units; alch/fusing: 5% on 9.5 units;
+    // the two loops without listed stock have no volume and go last by margin
+    REQUIRE(results.size() == 4);
+    CHECK(IsRotationOf(Ids(graph, results[0]), { "chance", "jewellers" }));
+    CHECK(IsRotationOf(Ids(graph, results[1]), { "alch", "fusing" }));
+    CHECK(IsRotationOf(Ids(graph, results[2]), { "regal", "vaal" }));
+    CHECK(IsRotationOf(Ids(graph, results[3]), { "gcp", "scour" }));
+
+    CHECK(results[0].expectedProfitChaos > results[1].expectedProfitChaos);
+    CHECK_EQ(results[2].maxVolume, 0.0);
+    CHECK_EQ(results[3].maxVolume, 0.0);
+    CHECK(results[2].profitFraction > results[3].profitFraction);
+}
+
+NX_TEST(ProfitIsNormalisedByStartCurrencyValue) {
+    // Neither currency is worth 1 chaos; the loop makes 5% either way round
+    CurrencyGraph graph;
+    int divine = graph.AddCurrency("divine", "Divine Orb", 200.0);
+    int exalted = graph.AddCurrency("exalted", "Exalted Orb", 10.0);
+    graph.SetRatio(divine, exalted, 21.0, 100);
+    graph.SetRatio(exalted, divine, 0.05, 10);
+
+    ArbitrageScanner scanner;
+    const auto& results = scanner.Scan(graph);
+    REQUIRE(results.size() == 1);
+    const ArbitrageCycle& cycle = results[0];
+    CHECK_NEAR(cycle.rateProduct, 1.05, 1e-12);
+
+    // From divine the 100 exalted listed cap the start at 100/21 divines;
+    // from exalted the same listing caps it at 100/1.05 exalted. Both make
+    // 1000/21 chaos: 0.05 * 100/21 * 200 = 0.05 * 100/1.05 * 10
+    if (cycle.currencies[0] == divine) {
+        CHECK_NEAR(cycle.maxVolume, 100.0 / 21.0, 1e-9);
+        CHECK_NEAR(cycle.expectedProfit, 5.0 / 21.0, 1e-9);
+    } else {
+        REQUIRE(cycle.currencies[0] == exalted);
+        CHECK_NEAR(cycle.maxVolume, 100.0 / 1.05, 1e-9);
+        CHECK_NEAR(cycle.expectedProfit, 5.0 / 1.05, 1e-9);
+    }
+    CHECK_NEAR(cycle.expectedProfitChaos, 1000.0 / 21.0, 1e-9);
+}
+
+NX_TEST(MarginsBelowThresholdAreIgnored) {
+    CurrencyGraph graph;
+    int chaos = graph.AddCurrency("chaos", "Chaos Orb", 1.0);
+    int alch = graph.AddCurrency("alch", "Orb of Alchemy", 0.25);
+    graph.SetRatio(chaos, alch, 4.002, 1000);
+    graph.SetRatio(alch, chaos, 0.25, 1000);
+
+    ArbitrageScanner scanner;
+    CHECK(scanner.Scan(graph).empty());
+
+    ArbitrageScanOptions options;
+    options.minProfitFraction = 0.0001;
+    scanner.SetOptions(options);
+    CHECK_EQ(scanner.Scan(graph).size(), 1u);
+}
+
+NX_TEST(ResultsAreTruncatedAfterRanking) {
+    CurrencyGraph graph = LoadSnapshot("ranking.json");
+
+    ArbitrageScanOptions options;
+    options.maxResults = 2;
+    ArbitrageScanner scanner(options);
+    const auto& results = scanner.Scan(graph);
+
+    REQUIRE(results.size() == 2);
+    CHECK(IsRotationOf(Ids(graph, results[0]), { "chance", "jewellers" }));
+    CHECK(IsRotationOf(Ids(graph, results[1]), { "alch", "fusing" }));
+}
+
+NX_TEST(RescanReusesBuffersAndRepeatsResults) {
+    CurrencyGraph graph = LoadSnapshot("ranking.json");
+    ArbitrageScanner scanner;
+    std::vector<ArbitrageCycle> first = scanner.Scan(graph);
+
+    CurrencyGraph smaller = LoadSnapshot("triangle.json");
+    CHECK_EQ(scanner.Scan(smaller).size(), 1u);
+
+    const auto& again = scanner.Scan(graph);
+    REQUIRE(again.size() == first.size());
+    for (size_t i = 0; i < first.size(); i++) {
+        CHECK(again[i].currencies == first[i].currencies);
+        CHECK_EQ(again[i].rateProduct, first[i].rateProduct);
+    }
+}
+
+NX_TEST(BestListingWinsForRepeatedPairs) {
+    CurrencyGraph graph;
+    std::string error;
+    REQUIRE(graph.LoadSnapshot(R"({"ratios": [
+        { "have": "chaos", "want": "alch", "rate": 3.9, "stock": 100 },
+        { "have": "chaos", "want": "alch", "rate": 4.1, "stock": 100 },
+        { "have": "alch", "want": "chaos", "rate": 0.25, "stock": 100 }
+    ]})", error));
+
+    CHECK_EQ(graph.GetCurrencyCount(), 2u);
+    CHECK_EQ(graph.GetEdgeCount(), 2u);
+
+    ArbitrageScanner scanner;
+    const auto& results = scanner.Scan(graph);
+    REQUIRE(results.size() == 1);
+    CHECK_NEAR(results[0].rateProduct, 4.1 * 0.25, 1e-12);
+}
+
+NX_TEST(MalformedSnapshotsAreRejected) {
+    CurrencyGraph graph;
+    std::string error;
+    CHECK(!graph.LoadSnapshot("not json", error));
+    CHECK(!error.empty());
+
+    error.clear();
+    CHECK(!graph.LoadSnapshot(R"({"currencies": []})", error));
+    CHECK(!error.empty());
+
+    // Unusable ratios are skipped rather than failing the snapshot
+    CHECK(graph.LoadSnapshot(R"({"ratios": [
+        { "have": "chaos", "want": "chaos", "rate": 2 },
+        { "have": "chaos", "want": "alch", "rate": -1 },
+        { "have": "", "want": "alch", "rate": 1 }
+    ]})", error));
+    CHECK_EQ(graph.GetEdgeCount(), 0u);
+
+    ArbitrageScanner scanner;
+    CHECK(scanner.Scan(graph).empty());
+}
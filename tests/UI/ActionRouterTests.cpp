@@ -0,0 +1,188 @@
+#include "TestHarness.h"
+
+#include "UI/ActionRouter.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+// -----------------------------------------------------------------------------
+// Action scan
+// -----------------------------------------------------------------------------
+
+NX_TEST(ScanFindsTheTopLevelAction) {
+    std::string_view action;
+    bool found = false;
+
+    CHECK(ActionRouter::FindAction(R"({"action":"show_module","moduleId":"x"})", action, found));
+    CHECK(found);
+    CHECK_EQ(std::string(action), "show_module");
+
+    // Members before it are stepped over, nested "action" keys included
+    CHECK(ActionRouter::FindAction(R"( { "a" : {"action":"no"}, "b":[1,"]"], "action" : "yes" })", action, found));
+    CHECK(found);
+    CHECK_EQ(std::string(action), "yes");
+
+    // Plainly no string action
+    CHECK(ActionRouter::FindAction(R"({"moduleId":"x"})", action, found));
+    CHECK(!found);
+    CHECK(ActionRouter::FindAction(R"({"action":5})", action, found));
+    CHECK(!found);
+    CHECK(ActionRouter::FindAction("{}", action, found));
+    CHECK(!found);
+
+    // Escapes, and text that is not an object, need a parse to tell
+    CHECK(!ActionRouter::FindAction(R"({"action":"a\u0062"})", action, found));
+    CHECK(!ActionRouter::FindAction("[1]", action, found));
+    CHECK(!ActionRouter::FindAction(R"({"action")", action, found));
+}
+
+// -----------------------------------------------------------------------------
+// Dispatch
+// -----------------------------------------------------------------------------
+
+NX_TEST(PayloadIsParsedOnlyWhenRead) {
+    ActionRouter router;
+    int toggles = 0;
+    std::string moduleId;
+    router.Register("app", "toggle_overlay", [&toggles](const ActionMessage& message) {
+        CHECK_EQ(std::string(message.Action()), "toggle_overlay");
+        toggles++;
+    });
+    router.Register("app", "show_module", [&moduleId](const ActionMessage& message) {
+        CHECK(!message.IsParsed());
+        moduleId = message.Json().value("moduleId", "");
+        // A second read reuses the tree
+        CHECK_EQ(&message.Json(), &message.Json());
+    });
+
+    std::string error;
+    CHECK(router.Dispatch(R"({"action":"toggle_overlay","settings":{"a":[1,2,3]}})", error));
+    CHECK(router.Dispatch(R"({"action":"show_module","moduleId":"stash_search"})", error));
+    CHECK_EQ(toggles, 1);
+    CHECK_EQ(moduleId, "stash_search");
+    CHECK_EQ(router.GetRouterStats().parses, 1u);
+
+    // The text after the action is not looked at unless read
+    CHECK(router.Dispatch(R"({"action":"toggle_overlay", oops)", error));
+    CHECK_EQ(toggles, 2);
+    CHECK_EQ(router.GetRouterStats().parses, 1u);
+    CHECK_EQ(router.GetRouterStats().malformed, 0u);
+}
+
+NX_TEST(MalformedPayloadsFailTheirAction) {
+    ActionRouter router;
+    bool reached = false;
+    router.Register("settings", "save_settings", [&reached](const ActionMessage& message) {
+        message.Json();
+        reached = true;
+    });
+
+    std::string error;
+    CHECK(!router.Dispatch(R"({"action":"save_settings","settings":{)", error));
+    CHECK_EQ(error, "Malformed web message for action 'save_settings'");
+    CHECK(!reached);
+
+    ActionRouterStats stats = router.GetRouterStats();
+    CHECK_EQ(stats.malformed, 1u);
+    CHECK_EQ(stats.parses, 1u);
+    // The handler did not fail; the message did
+    CHECK_EQ(router.GetStats()[0].messages, 0u);
+    CHECK_EQ(router.GetStats()[0].failures, 0u);
+
+    // Text that cannot even be scanned fails before any handler
+    CHECK(!router.Dispatch("{not json", error));
+    CHECK_EQ(error, "Malformed web message");
+    CHECK_EQ(router.GetRouterStats().malformed, 2u);
+}
+
+NX_TEST(HandlersMayCatchParseErrors) {
+    ActionRouter router;
+    int reads = 0;
+    router.Register("app", "show_module", [&reads](const ActionMessage& message) {
+        for (int i = 0; i < 2; i++) {
+            try {
+                message.Json();
+            } catch (const json::parse_error&) {
+                reads++;
+            }
+        }
+        CHECK(message.IsMalformed());
+    });
+
+    // Caught and handled by the handler: not the router's failure
+    std::string error;
+    CHECK(router.Dispatch(R"({"action":"show_module",)", error));
+    CHECK_EQ(reads, 2);
+    CHECK_EQ(router.GetRouterStats().malformed, 0u);
+}
+
+NX_TEST(EscapedActionsAreParsedOnce) {
+    ActionRouter router;
+    std::string query;
+    router.Register("stash_search", "stash_search_query", [&query](const ActionMessage& message) {
+        // The router parsed to find the action and hands that tree over
+        CHECK(message.IsParsed());
+        CHECK_EQ(std::string(message.Action()), "stash_search_query");
+        query = message.Json().value("query", "");
+    });
+
+    std::string error;
+    CHECK(router.Dispatch(R"({"action":"stash\u005fsearch_query","query":"rarity:rare"})", error));
+    CHECK_EQ(query, "rarity:rare");
+    CHECK_EQ(router.GetRouterStats().parses, 1u);
+}
+
+NX_TEST(HandlerErrorsAndUnknownActions) {
+    ActionRouter router;
+    router.Register("map_overlay", "map_overlay_reload", [](const ActionMessage&) {
+        throw std::runtime_error("rules file missing");
+    });
+
+    std::string error;
+    CHECK(!router.Dispatch(R"({"action":"map_overlay_reload"})", error));
+    CHECK_EQ(error, "Action 'map_overlay_reload' failed: rules file missing");
+    CHECK_EQ(router.GetStats()[0].failures, 1u);
+
+    // No handler: false with no error
+    error.clear();
+    CHECK(!router.Dispatch(R"({"action":"overlay_ready"})", error));
+    CHECK(error.empty());
+    CHECK(!router.Dispatch(R"({"moduleId":"x"})", error));
+    CHECK(error.empty());
+    CHECK_EQ(router.GetRouterStats().unhandled, 2u);
+    CHECK_EQ(router.GetRouterStats().parses, 0u);
+}
+
+// -----------------------------------------------------------------------------
+// Registration
+// -----------------------------------------------------------------------------
+
+NX_TEST(OwnersUnregisterTogether) {
+    ActionRouter router;
+    std::string ran;
+    for (const char* action : { "stash_search_get", "stash_search_query", "stash_search_reload" }) {
+        router.Register("stash_search", action, [&ran, action](const ActionMessage&) { ran = action; });
+    }
+    router.Register("app", "toggle_overlay", [&ran](const ActionMessage&) { ran = "toggle_overlay"; });
+    CHECK(router.HasAction("stash_search_query"));
+
+    // Registering again replaces the handler
+    router.Register("stash_search", "stash_search_get", [&ran](const ActionMessage&) { ran = "replaced"; });
+    std::string error;
+    CHECK(router.Dispatch(R"({"action":"stash_search_get"})", error));
+    CHECK_EQ(ran, "replaced");
+    CHECK_EQ(router.GetRouterStats().actions, 4u);
+
+    router.UnregisterOwner("stash_search");
+    CHECK(!router.HasAction("stash_search_get"));
+    CHECK(!router.HasAction("stash_search_query"));
+    CHECK(router.HasAction("toggle_overlay"));
+    CHECK_EQ(router.GetRouterStats().actions, 1u);
+
+    router.Unregister("toggle_overlay");
+    CHECK(!router.HasAction("toggle_overlay"));
+    CHECK(!router.Dispatch(R"({"action":"toggle_overlay"})", error));
+}
@@ -0,0 +1,330 @@
+#include "TestHarness.h"
+
+#include "UI/AssetBundle.h"
+#include "UI/AssetCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace Nexile;
+
+namespace {
+    const size_t kHeaderSize = 24;
+    const size_t kEntrySize = 32;
+
+    std::string Compressible(size_t size) {
+        std::string text;
+        while (text.size() < size) text += "body { margin: 0; padding: 0; } ";
+        text.resize(size);
+        return text;
+    }
+
+    std::string Noise(size_t size) {
+        std::mt19937 rng(5);
+        std::string bytes(size, '\0');
+        for (char& c : bytes) c = static_cast<char>(rng());
+        return bytes;
+    }
+
+    // Three entries: stored (small), compressed (large, repetitive) and stored (incompressible)
+    std::vector<uint8_t> SampleBundle() {
+        AssetBundleWriter writer;
+        writer.Add("main_overlay.html", "<html></html>");
+        writer.Add("css/overlay.css", Compressible(4096));
+        writer.Add("img/noise.png", Noise(1024));
+
+        std::vector<uint8_t> bytes;
+        std::string error;
+        if (!writer.Write(bytes, error)) {
+            Test::Fail(__FILE__, __LINE__, error);
+        }
+        return bytes;
+    }
+
+    void PutU32(std::vector<uint8_t>& bytes, size_t at, uint32_t value) {
+        for (int i = 0; i < 4; i++) bytes[at + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    uint32_t GetU32(const std::vector<uint8_t>& bytes, size_t at) {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; i--) value = (value << 8) | bytes[at + i];
+        return value;
+    }
+
+    std::string OpenError(const std::vector<uint8_t>& bytes) {
+        AssetBundle bundle;
+        std::string error;
+        if (bundle.OpenMemory(bytes.data(), bytes.size(), error)) {
+            return "(opened)";
+        }
+        return error;
+    }
+}
+
+NX_TEST(StoredAndCompressedEntriesRoundTrip) {
+    std::vector<uint8_t> bytes = SampleBundle();
+    AssetBundle bundle;
+    std::string error;
+    REQUIRE(bundle.OpenMemory(bytes.data(), bytes.size(), error));
+    CHECK(bundle.IsOpen());
+    CHECK_EQ(bundle.GetEntryCount(), 3u);
+
+    struct Expected {
+        const char* path;
+        std::string contents;
+        bool compressed;
+    };
+    const Expected expected[] = {
+        { "main_overlay.html", "<html></html>", false },
+        { "css/overlay.css", Compressible(4096), true },
+        { "img/noise.png", Noise(1024), false },
+    };
+
+    for (const Expected& file : expected) {
+        AssetBundleEntry entry;
+        REQUIRE(bundle.Find(file.path, entry));
+        CHECK_EQ(entry.path, file.path);
+        CHECK_EQ(entry.compressed, file.compressed);
+        CHECK_EQ(entry.size, file.contents.size());
+        CHECK_EQ(entry.hash, AssetCache::HashContent(file.contents));
+        CHECK(file.compressed ? entry.storedSize < entry.size : entry.storedSize == entry.size);
+
+        std::string contents;
+        CHECK(bundle.Read(entry, contents));
+        CHECK(contents == file.contents);
+    }
+
+    // Entries are listed in key order
+    CHECK_EQ(bundle.GetEntry(0).path, "css/overlay.css");
+    CHECK_EQ(bundle.GetEntry(1).path, "img/noise.png");
+    CHECK_EQ(bundle.GetEntry(2).path, "main_overlay.html");
+}
+
+NX_TEST(LaterAdditionsOfAKeyWin) {
+    AssetBundleWriter writer;
+    writer.Add("a.js", "old");
+    writer.Add("b.js", "b");
+    writer.Add("a.js", "new");
+    CHECK_EQ(writer.GetEntryCount(), 2u);
+
+    std::vector<uint8_t> bytes;
+    std::string error;
+    REQUIRE(writer.Write(bytes, error));
+
+    AssetBundle bundle;
+    REQUIRE(bundle.OpenMemory(bytes.data(), bytes.size(), error));
+    AssetBundleEntry entry;
+    std::string contents;
+    REQUIRE(bundle.Find("a.js", entry));
+    CHECK(bundle.Read(entry, contents));
+    CHECK_EQ(contents, "new");
+}
+
+NX_TEST(EmptyBundleOpens) {
+    AssetBundleWriter writer;
+    std::vector<uint8_t> bytes;
+    std::string error;
+    REQUIRE(writer.Write(bytes, error));
+    CHECK_EQ(bytes.size(), kHeaderSize);
+
+    AssetBundle bundle;
+    CHECK(bundle.OpenMemory(bytes.data(), bytes.size(), error));
+    CHECK_EQ(bundle.GetEntryCount(), 0u);
+
+    AssetBundleEntry entry;
+    CHECK(!bundle.Find("main_overlay.html", entry));
+    CHECK(!bundle.Find("", entry));
+}
+
+NX_TEST(UnknownKeysAreNotFound) {
+    std::vector<uint8_t> bytes = SampleBundle();
+    AssetBundle bundle;
+    std::string error;
+    REQUIRE(bundle.OpenMemory(bytes.data(), bytes.size(), error));
+
+    AssetBundleEntry entry;
+    CHECK(!bundle.Find("a.css", entry));                 // before the first key
+    CHECK(!bundle.Find("css/overlay", entry));           // prefix of a key
+    CHECK(!bundle.Find("css/overlay.css2", entry));      // key is a prefix
+    CHECK(!bundle.Find("Main_Overlay.html", entry));     // keys are lower case
+    CHECK(!bundle.Find("zzz.html", entry));              // after the last key
+}
+
+NX_TEST(TruncatedBundlesAreRejected) {
+    std::vector<uint8_t> bytes = SampleBundle();
+    for (size_t size = 0; size < bytes.size(); size++) {
+        AssetBundle bundle;
+        std::string error;
+        if (bundle.OpenMemory(bytes.data(), size, error)) {
+            Test::Fail(__FILE__, __LINE__, "opened a bundle truncated to " + std::to_string(size) + " bytes");
+            break;
+        }
+        CHECK(!bundle.IsOpen());
+        CHECK_EQ(bundle.GetEntryCount(), 0u);
+    }
+
+    CHECK_EQ(OpenError(std::vector<uint8_t>(bytes.begin(), bytes.begin() + 10)), "Not an asset bundle");
+    CHECK_EQ(OpenError(std::vector<uint8_t>(bytes.begin(), bytes.begin() + kHeaderSize)), "Corrupt asset bundle header");
+    CHECK_EQ(OpenError(std::vector<uint8_t>(bytes.begin(), bytes.end() - 1)), "Corrupt asset bundle entry 2");
+}
+
+NX_TEST(CorruptHeadersAreRejected) {
+    const std::vector<uint8_t> good = SampleBundle();
+    uint32_t stringsOffset = GetU32(good, 12);
+    uint32_t dataOffset = GetU32(good, 16);
+
+    std::vector<uint8_t> bytes = good;
+    bytes[0] = 'X';
+    CHECK_EQ(OpenError(bytes), "Not an asset bundle");
+
+    bytes = good;
+    PutU32(bytes, 4, 2);
+    CHECK_EQ(OpenError(bytes), "Unsupported asset bundle version 2");
+
+    bytes = good;
+    PutU32(bytes, 8, 4);    // index would run into the strings
+    CHECK_EQ(OpenError(bytes), "Corrupt asset bundle header");
+
+    bytes = good;
+    PutU32(bytes, 8, 0xFFFFFFFFu);
+    CHECK_EQ(OpenError(bytes), "Corrupt asset bundle header");
+
+    bytes = good;
+    PutU32(bytes, 12, dataOffset + 1);
+    CHECK_EQ(OpenError(bytes), "Corrupt asset bundle header");
+
+    bytes = good;
+    PutU32(bytes, 16, static_cast<uint32_t>(good.size()) + 1);
+    CHECK_EQ(OpenError(bytes), "Corrupt asset bundle header");
+
+    // Entry 1's path runs past the string table
+    bytes = good;
+    PutU32(bytes, kHeaderSize + kEntrySize + 4, dataOffset - stringsOffset + 1);
+    CHECK_EQ(OpenError(bytes), "Corrupt asset bundle entry 1");
+
+    // Entry 0's blob runs past the end
+    bytes = good;
+    PutU32(bytes, kHeaderSize + 12, static_cast<uint32_t>(good.size()));
+    CHECK_EQ(OpenError(bytes), "Corrupt asset bundle entry 0");
+
+    AssetBundle bundle;
+    std::string error;
+    CHECK(!bundle.OpenMemory(nullptr, 0, error));
+    CHECK_EQ(error, "Not an asset bundle");
+}
+
+NX_TEST(UnsortedIndexIsRejected) {
+    const std::vector<uint8_t> good = SampleBundle();
+
+    // Swap the first two index entries
+    std::vector<uint8_t> bytes = good;
+    std::memcpy(&bytes[kHeaderSize], &good[kHeaderSize + kEntrySize], kEntrySize);
+    std::memcpy(&bytes[kHeaderSize + kEntrySize], &good[kHeaderSize], kEntrySize);
+    CHECK_EQ(OpenError(bytes), "Asset bundle index is not sorted");
+
+    // A repeated key is out of order too
+    bytes = good;
+    std::memcpy(&bytes[kHeaderSize + kEntrySize], &good[kHeaderSize], kEntrySize);
+    CHECK_EQ(OpenError(bytes), "Asset bundle index is not sorted");
+}
+
+NX_TEST(FailedOpenClosesThePreviousBundle) {
+    std::vector<uint8_t> good = SampleBundle();
+    std::vector<uint8_t> bad = good;
+    bad[0] = 'X';
+
+    AssetBundle bundle;
+    std::string error;
+    REQUIRE(bundle.OpenMemory(good.data(), good.size(), error));
+    CHECK(!bundle.OpenMemory(bad.data(), bad.size(), error));
+    CHECK(!bundle.IsOpen());
+    CHECK_EQ(bundle.GetEntryCount(), 0u);
+
+    AssetBundleEntry entry;
+    CHECK(!bundle.Find("main_overlay.html", entry));
+}
+
+NX_TEST(CorruptCompressedEntriesFailToRead) {
+    std::vector<uint8_t> bytes = SampleBundle();
+    AssetBundle probe;
+    std::string error;
+    REQUIRE(probe.OpenMemory(bytes.data(), bytes.size(), error));
+    AssetBundleEntry css;
+    REQUIRE(probe.Find("css/overlay.css", css));
+    size_t blob = static_cast<size_t>(css.data - bytes.data());
+    probe.Close();
+
+    bytes[blob + css.storedSize / 2] ^= 0x55;
+    AssetBundle bundle;
+    REQUIRE(bundle.OpenMemory(bytes.data(), bytes.size(), error));
+    REQUIRE(bundle.Find("css/overlay.css", css));
+
+    std::string contents = "stale";
+    CHECK(!bundle.Read(css, contents));
+    CHECK(contents.empty());
+}
+
+NX_TEST(BundleFilesOpen) {
+    std::vector<uint8_t> bytes = SampleBundle();
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+        ("nexile_bundle_" + std::to_string(std::random_device()()) + ".nxpk");
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+    AssetBundle bundle;
+    std::string error;
+    CHECK(bundle.OpenFile(path.u8string(), error));
+    CHECK_EQ(bundle.GetEntryCount(), 3u);
+    bundle.Close();
+    CHECK(!bundle.IsOpen());
+
+    std::filesystem::remove(path);
+    CHECK(!bundle.OpenFile(path.u8string(), error));
+    CHECK_EQ(error, "Cannot open asset bundle: " + path.u8string());
+}
+
+NX_TEST(CacheServesFromTheBundle) {
+    static const std::vector<uint8_t> bytes = SampleBundle();
+    auto bundle = std::make_shared<AssetBundle>();
+    std::string error;
+    REQUIRE(bundle->OpenMemory(bytes.data(), bytes.size(), error));
+
+    // The directory does not exist; a bundle replaces it entirely
+    AssetCache cache("/nonexistent/nexile/html");
+    cache.SetBundle(bundle);
+
+    AssetPtr page = cache.Get("Main_Overlay.html?v=1");
+    REQUIRE(page != nullptr);
+    CHECK_EQ(page->GetBytes(), "<html></html>");
+    CHECK(page->external != nullptr);       // stored entries are used in place
+    CHECK(page->owner == bundle);
+    CHECK_EQ(page->mimeType, "text/html");
+
+    AssetPtr css = cache.Get("css/overlay.css");
+    REQUIRE(css != nullptr);
+    CHECK(css->external == nullptr);        // compressed entries are inflated once
+    CHECK(css->GetBytes() == Compressible(4096));
+    CHECK_EQ(css->hash, AssetCache::HashContent(Compressible(4096)));
+
+    CHECK(cache.Get("missing.js") == nullptr);
+    CHECK_EQ(cache.Preload(), 3u);
+}
+
+NX_TEST(VirtualAssetsFallBackToTheBundle) {
+    static const std::vector<uint8_t> bytes = SampleBundle();
+    auto bundle = std::make_shared<AssetBundle>();
+    std::string error;
+    REQUIRE(bundle->OpenMemory(bytes.data(), bytes.size(), error));
+    AssetCache cache("/nonexistent/nexile/html");
+    cache.SetBundle(bundle);
+
+    REQUIRE(cache.RegisterVirtual("main_overlay.html", "<html>module</html>") != nullptr);
+    CHECK_EQ(cache.Get("main_overlay.html")->GetBytes(), "<html>module</html>");
+
+    cache.UnregisterVirtual("main_overlay.html");
+    AssetPtr page = cache.Get("main_overlay.html");
+    REQUIRE(page != nullptr);
+    CHECK_EQ(page->GetBytes(), "<html></html>");
+    CHECK(page->owner == bundle);
+}
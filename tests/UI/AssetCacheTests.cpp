@@ -0,0 +1,191 @@
+#include "TestHarness.h"
+
+#include "UI/AssetCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace Nexile;
+namespace fs = std::filesystem;
+
+namespace {
+    // Scratch tree: <dir>/html is the cache root, <dir>/secret.txt sits beside it
+    struct ScratchTree {
+        fs::path dir;
+        fs::path root;
+
+        ScratchTree() {
+            dir = fs::temp_directory_path() / ("nexile_asset_cache_" + std::to_string(std::random_device()()));
+            root = dir / "html";
+            fs::create_directories(root / "css");
+            Write("secret.txt", "outside the root");
+            Write("html/main_overlay.html", "<html>main</html>");
+            Write("html/css/a.css", "body{}");
+        }
+
+        ~ScratchTree() {
+            std::error_code ec;
+            fs::remove_all(dir, ec);
+        }
+
+        void Write(const std::string& name, const std::string& contents) const {
+            std::ofstream(dir / name, std::ios::binary) << contents;
+        }
+    };
+
+    std::string Key(std::string_view urlPath) {
+        std::string key;
+        return AssetCache::NormalizePath(urlPath, key) ? key : "(rejected)";
+    }
+}
+
+NX_TEST(PathsNormaliseToKeys) {
+    CHECK_EQ(Key("main_overlay.html"), "main_overlay.html");
+    CHECK_EQ(Key("/Main_Overlay.HTML?v=2#top"), "main_overlay.html");
+    CHECK_EQ(Key("CSS\\A.css"), "css/a.css");
+    CHECK_EQ(Key("//./css//./a.css/"), "css/a.css");
+    CHECK_EQ(Key("//server/share/a.css"), "server/share/a.css");
+}
+
+NX_TEST(PathsLeavingTheRootAreRejected) {
+    CHECK_EQ(Key(""), "(rejected)");
+    CHECK_EQ(Key("/"), "(rejected)");
+    CHECK_EQ(Key("?v=1"), "(rejected)");
+    CHECK_EQ(Key(".."), "(rejected)");
+    CHECK_EQ(Key("../secret.txt"), "(rejected)");
+    CHECK_EQ(Key("css/../../secret.txt"), "(rejected)");
+    CHECK_EQ(Key("css\\..\\..\\secret.txt"), "(rejected)");
+}
+
+NX_TEST(DrivesAndStreamsAreRejected) {
+    // nexile:///C:/Windows/win.ini reaches the cache as "/C:/Windows/win.ini"
+    CHECK_EQ(Key("/C:/Windows/win.ini"), "(rejected)");
+    CHECK_EQ(Key("C:/Windows/win.ini"), "(rejected)");
+    CHECK_EQ(Key("C:\\Windows\\win.ini"), "(rejected)");
+    CHECK_EQ(Key("c:win.ini"), "(rejected)");
+    CHECK_EQ(Key("css/a.css:hidden"), "(rejected)");
+    CHECK_EQ(Key("main_overlay.html::$DATA"), "(rejected)");
+}
+
+NX_TEST(FilesUnderTheRootAreServed) {
+    ScratchTree tree;
+    AssetCache cache(tree.root.u8string());
+
+    AssetPtr page = cache.Get("/main_overlay.html?v=3");
+    REQUIRE(page != nullptr);
+    CHECK_EQ(page->GetBytes(), "<html>main</html>");
+    CHECK_EQ(page->mimeType, "text/html");
+    CHECK_EQ(page->hash, AssetCache::HashContent("<html>main</html>"));
+
+    AssetPtr css = cache.Get("CSS/A.CSS");
+    REQUIRE(css != nullptr);
+    CHECK_EQ(css->mimeType, "text/css");
+
+    // The second request is served from memory
+    CHECK(cache.Get("main_overlay.html") == page);
+    CHECK_EQ(cache.GetMissCount(), 2u);
+    CHECK_EQ(cache.GetHitCount(), 1u);
+    CHECK(cache.Get("missing.html") == nullptr);
+}
+
+NX_TEST(EscapingRequestsAreNotServed) {
+    ScratchTree tree;
+    AssetCache cache(tree.root.u8string());
+
+    CHECK(cache.Get("../secret.txt") == nullptr);
+    CHECK(cache.Get("/C:/Windows/win.ini") == nullptr);
+    CHECK(cache.Get(tree.dir.u8string() + "/secret.txt") == nullptr);
+    CHECK(cache.RegisterVirtual("C:/module.html", "<html></html>") == nullptr);
+    CHECK_EQ(cache.GetEntryCount(), 0u);
+
+    // Preload only picks up files under the root
+    CHECK_EQ(cache.Preload(), 2u);
+}
+
+NX_TEST(VirtualAssetsShadowFiles) {
+    ScratchTree tree;
+    AssetCache cache(tree.root.u8string());
+
+    AssetPtr first = cache.RegisterVirtual("main_overlay.html", "<html>module</html>");
+    REQUIRE(first != nullptr);
+    CHECK_EQ(cache.Get("main_overlay.html")->GetBytes(), "<html>module</html>");
+
+    // Same contents keep the asset; new contents replace it
+    CHECK(cache.RegisterVirtual("MAIN_overlay.html", "<html>module</html>") == first);
+    AssetPtr second = cache.RegisterVirtual("main_overlay.html", "<html>module v2</html>");
+    CHECK(second != first);
+    CHECK(second->etag != first->etag);
+
+    cache.UnregisterVirtual("main_overlay.html");
+    CHECK_EQ(cache.Get("main_overlay.html")->GetBytes(), "<html>main</html>");
+}
+
+NX_TEST(ReRegisteringKeepsTheVersion) {
+    ScratchTree tree;
+    AssetCache cache(tree.root.u8string());
+
+    // A module loaded again registers the same document; pages keep their ETag
+    AssetPtr first = cache.RegisterVirtual("module/build_guide/index.html", "<html>guide</html>");
+    REQUIRE(first != nullptr);
+    AssetPtr again = cache.RegisterVirtual("module/build_guide/index.html", std::string("<html>guide</html>"));
+    CHECK(again == first);
+    CHECK_EQ(again->etag, first->etag);
+    CHECK_EQ(again->hash, AssetCache::HashContent("<html>guide</html>"));
+
+    // Changed contents are a new version with a new hash
+    AssetPtr changed = cache.RegisterVirtual("module/build_guide/index.html", "<html>guide v2</html>");
+    REQUIRE(changed != nullptr);
+    CHECK(changed->hash != first->hash);
+    CHECK_EQ(changed->hash, AssetCache::HashContent("<html>guide v2</html>"));
+    CHECK(cache.Get("module/build_guide/index.html") == changed);
+    CHECK_EQ(first->GetBytes(), "<html>guide</html>");
+}
+
+NX_TEST(ClearLeavesVirtualAssetsAlone) {
+    ScratchTree tree;
+    AssetCache cache(tree.root.u8string());
+    AssetPtr module = cache.RegisterVirtual("module/stash_search/index.html", "<html>stash</html>");
+    AssetPtr file = cache.Get("css/a.css");
+    REQUIRE(file != nullptr);
+
+    cache.Clear();
+    cache.Invalidate("module/stash_search/index.html");
+    CHECK(cache.Get("module/stash_search/index.html") == module);
+    CHECK(cache.Get("css/a.css") != file);
+
+    // Unregistering with no file underneath leaves nothing to serve
+    cache.UnregisterVirtual("module/stash_search/index.html");
+    CHECK(cache.Get("module/stash_search/index.html") == nullptr);
+}
+
+NX_TEST(InvalidatedFilesAreReadAgain) {
+    ScratchTree tree;
+    AssetCache cache(tree.root.u8string());
+
+    AssetPtr before = cache.Get("css/a.css");
+    REQUIRE(before != nullptr);
+    tree.Write("html/css/a.css", "body{color:red}");
+    CHECK(cache.Get("css/a.css") == before);
+
+    cache.Invalidate("css/a.css");
+    AssetPtr after = cache.Get("css/a.css");
+    REQUIRE(after != nullptr);
+    CHECK_EQ(after->GetBytes(), "body{color:red}");
+
+    // Responses holding the old asset keep their contents
+    CHECK_EQ(before->GetBytes(), "body{}");
+}
+
+NX_TEST(LargeFilesAreStreamed) {
+    ScratchTree tree;
+    tree.Write("html/big.bin", std::string(static_cast<size_t>(AssetCache::kMaxCachedFileSize) + 1, 'x'));
+    AssetCache cache(tree.root.u8string());
+
+    AssetPtr big = cache.Get("big.bin");
+    REQUIRE(big != nullptr);
+    CHECK(big->IsStreamed());
+    CHECK(big->GetBytes().empty());
+    CHECK_EQ(big->size, AssetCache::kMaxCachedFileSize + 1);
+    CHECK_EQ(big->mimeType, "application/octet-stream");
+}
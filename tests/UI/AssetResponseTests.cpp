@@ -0,0 +1,316 @@
+#include "TestHarness.h"
+
+#include "UI/AssetBundle.h"
+#include "UI/AssetResponse.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+
+using namespace Nexile;
+namespace fs = std::filesystem;
+
+namespace {
+    struct Range {
+        bool parsed;
+        bool satisfiable;
+        uint64_t first;
+        uint64_t last;
+    };
+
+    Range Parse(std::string_view header, uint64_t size) {
+        Range range = { false, false, 0, 0 };
+        range.parsed = AssetResponse::ParseRange(header, size, range.first, range.last, range.satisfiable);
+        return range;
+    }
+
+    bool Selects(const Range& range, uint64_t first, uint64_t last) {
+        return range.parsed && range.satisfiable && range.first == first && range.last == last;
+    }
+
+    bool Unsatisfiable(const Range& range) {
+        return range.parsed && !range.satisfiable;
+    }
+
+    std::string Noise(size_t size, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::string bytes(size, '\0');
+        for (char& c : bytes) c = static_cast<char>(rng());
+        return bytes;
+    }
+
+    AssetPtr MemoryAsset(std::string contents) {
+        auto asset = std::make_shared<CachedAsset>();
+        asset->size = contents.size();
+        asset->hash = AssetCache::HashContent(contents);
+        asset->etag = "\"abc123\"";
+        asset->data = std::move(contents);
+        return asset;
+    }
+
+    std::string ReadAll(AssetResponse& response, size_t chunk) {
+        std::string body;
+        std::vector<char> buffer(chunk);
+        size_t count;
+        while ((count = response.Read(buffer.data(), buffer.size())) > 0) {
+            body.append(buffer.data(), count);
+        }
+        return body;
+    }
+
+    // Scratch cache root with one cached and one streamed file
+    struct ScratchRoot {
+        fs::path root;
+        std::string small = Noise(20000, 1);
+        std::string big = Noise(static_cast<size_t>(AssetCache::kMaxCachedFileSize) + 300000, 2);
+
+        ScratchRoot() {
+            root = fs::temp_directory_path() / ("nexile_asset_response_" + std::to_string(std::random_device()()));
+            fs::create_directories(root);
+            Write("small.html", small);
+            Write("big.bin", big);
+        }
+
+        ~ScratchRoot() {
+            std::error_code ec;
+            fs::remove_all(root, ec);
+        }
+
+        void Write(const char* name, const std::string& contents) const {
+            std::ofstream(root / name, std::ios::binary) << contents;
+        }
+    };
+}
+
+// -----------------------------------------------------------------------------
+// Range parsing
+// -----------------------------------------------------------------------------
+
+NX_TEST(ClosedRangesAreClamped) {
+    CHECK(Selects(Parse("bytes=0-9", 100), 0, 9));
+    CHECK(Selects(Parse("bytes=99-99", 100), 99, 99));
+    CHECK(Selects(Parse("  bytes= 10 - 19 ", 100), 10, 19));
+    CHECK(Selects(Parse("bytes=50-5000", 100), 50, 99));
+    CHECK(Selects(Parse("bytes=0-18446744073709551", 100), 0, 99));
+}
+
+NX_TEST(OpenEndedRangesRunToTheEnd) {
+    CHECK(Selects(Parse("bytes=90-", 100), 90, 99));
+    CHECK(Selects(Parse("bytes=0-", 100), 0, 99));
+    CHECK(Selects(Parse("bytes=99-", 100), 99, 99));
+}
+
+NX_TEST(SuffixRangesCountFromTheEnd) {
+    CHECK(Selects(Parse("bytes=-10", 100), 90, 99));
+    CHECK(Selects(Parse("bytes=-100", 100), 0, 99));
+    CHECK(Selects(Parse("bytes=-1000", 100), 0, 99));
+    CHECK(Selects(Parse("bytes=-1", 1), 0, 0));
+}
+
+NX_TEST(RangesOutsideTheAssetAreUnsatisfiable) {
+    CHECK(Unsatisfiable(Parse("bytes=100-", 100)));
+    CHECK(Unsatisfiable(Parse("bytes=100-200", 100)));
+    CHECK(Unsatisfiable(Parse("bytes=-0", 100)));
+    CHECK(Unsatisfiable(Parse("bytes=0-", 0)));
+    CHECK(Unsatisfiable(Parse("bytes=-5", 0)));
+}
+
+NX_TEST(OtherRangeHeadersAreIgnored) {
+    // Multi-range, reversed, other units and garbage fall back to the whole asset
+    CHECK(!Parse("bytes=0-1,3-4", 100).parsed);
+    CHECK(!Parse("bytes=0-1, 50-", 100).parsed);
+    CHECK(!Parse("bytes=5-1", 100).parsed);
+    CHECK(!Parse("items=0-1", 100).parsed);
+    CHECK(!Parse("bytes 0-1", 100).parsed);
+    CHECK(!Parse("bytes=", 100).parsed);
+    CHECK(!Parse("bytes=-", 100).parsed);
+    CHECK(!Parse("bytes=5", 100).parsed);
+    CHECK(!Parse("bytes=a-9", 100).parsed);
+    CHECK(!Parse("bytes=0-9x", 100).parsed);
+    CHECK(!Parse("bytes=+1-9", 100).parsed);
+    CHECK(!Parse("bytes=00000000000000000000-1", 100).parsed);
+}
+
+// -----------------------------------------------------------------------------
+// Responses
+// -----------------------------------------------------------------------------
+
+NX_TEST(WholeAndPartialBodies) {
+    AssetResponse response;
+    response.Begin(MemoryAsset("0123456789"), "", "");
+    CHECK_EQ(response.GetStatus(), 200);
+    CHECK_EQ(response.GetContentLength(), 10u);
+    CHECK(response.GetContentRange().empty());
+    CHECK_EQ(ReadAll(response, 3), "0123456789");
+    CHECK(response.IsComplete());
+
+    response.Begin(MemoryAsset("0123456789"), "bytes=2-5", "");
+    CHECK_EQ(response.GetStatus(), 206);
+    CHECK_EQ(response.GetContentLength(), 4u);
+    CHECK_EQ(response.GetContentRange(), "bytes 2-5/10");
+    CHECK_EQ(ReadAll(response, 1), "2345");
+
+    response.Begin(MemoryAsset("0123456789"), "bytes=-3", "");
+    CHECK_EQ(response.GetContentRange(), "bytes 7-9/10");
+    CHECK_EQ(ReadAll(response, 64), "789");
+
+    response.Begin(MemoryAsset("0123456789"), "bytes=10-", "");
+    CHECK_EQ(response.GetStatus(), 416);
+    CHECK_EQ(response.GetContentRange(), "bytes */10");
+    CHECK_EQ(response.GetContentLength(), 0u);
+    CHECK_EQ(ReadAll(response, 64), "");
+
+    // A malformed range sends everything
+    response.Begin(MemoryAsset("0123456789"), "bytes=0-1,4-5", "");
+    CHECK_EQ(response.GetStatus(), 200);
+    CHECK_EQ(ReadAll(response, 64), "0123456789");
+
+    response.Begin(nullptr, "", "");
+    CHECK_EQ(response.GetStatus(), 404);
+    CHECK_EQ(ReadAll(response, 64), "");
+}
+
+NX_TEST(ETagsMatchStrongWeakAndAny) {
+    AssetPtr asset = MemoryAsset("contents");
+    AssetResponse response;
+
+    const char* const matching[] = {
+        "\"abc123\"",
+        "W/\"abc123\"",
+        "*",
+        "\"other\", \"abc123\"",
+        "W/\"other\",W/\"abc123\"",
+        "  \"abc123\"  ",
+        "\"other\", *",
+    };
+    for (const char* header : matching) {
+        response.Begin(asset, "", header);
+        if (response.GetStatus() != 304) {
+            Test::Fail(__FILE__, __LINE__, std::string("no 304 for If-None-Match: ") + header);
+        }
+        CHECK_EQ(response.GetContentLength(), 0u);
+    }
+
+    const char* const different[] = {
+        "\"other\"",
+        "W/\"other\"",
+        "abc123",
+        "\"abc1234\"",
+        "W/",
+        ",",
+        "\"ABC123\"",
+    };
+    for (const char* header : different) {
+        response.Begin(asset, "", header);
+        if (response.GetStatus() != 200) {
+            Test::Fail(__FILE__, __LINE__, std::string("unexpected 304 for If-None-Match: ") + header);
+        }
+    }
+
+    // A match wins over a range
+    response.Begin(asset, "bytes=0-1", "\"abc123\"");
+    CHECK_EQ(response.GetStatus(), 304);
+}
+
+NX_TEST(StreamedAssetsAreReadFromDisk) {
+    ScratchRoot scratch;
+    AssetCache cache(scratch.root.u8string());
+    AssetPtr big = cache.Get("big.bin");
+    REQUIRE(big != nullptr);
+    REQUIRE(big->IsStreamed());
+
+    AssetResponse response;
+    response.Begin(big, "", "");
+    CHECK(ReadAll(response, 65536) == scratch.big);
+
+    response.Begin(big, "bytes=1048570-1048589", "");
+    CHECK_EQ(response.GetStatus(), 206);
+    CHECK(ReadAll(response, 7) == scratch.big.substr(1048570, 20));
+
+    // The file shrinking mid-response ends the body early instead of hanging
+    response.Begin(big, "", "");
+    std::vector<char> buffer(4096);
+    CHECK_EQ(response.Read(buffer.data(), buffer.size()), buffer.size());
+    fs::resize_file(scratch.root / "big.bin", 10000);
+    CHECK_EQ(ReadAll(response, 4096).size(), 10000u - buffer.size());
+    CHECK(response.IsComplete());
+
+    response.Cancel();
+    CHECK(response.GetAsset() == nullptr);
+    CHECK_EQ(response.Read(buffer.data(), buffer.size()), 0u);
+}
+
+NX_TEST(ConcurrentRangedRequests) {
+    ScratchRoot scratch;
+    AssetCache cache(scratch.root.u8string());
+
+    std::string packed(100000, 'a');
+    AssetBundleWriter writer;
+    writer.Add("stored.bin", scratch.small);
+    writer.Add("packed.txt", packed);
+    std::vector<uint8_t> bytes;
+    std::string error;
+    REQUIRE(writer.Write(bytes, error));
+
+    auto bundle = std::make_shared<AssetBundle>();
+    REQUIRE(bundle->OpenMemory(bytes.data(), bytes.size(), error));
+    AssetCache bundled("/nonexistent/nexile/html");
+    bundled.SetBundle(bundle);
+    REQUIRE(bundled.Get("stored.bin")->external != nullptr);
+    REQUIRE(bundled.Get("packed.txt")->external == nullptr);
+
+    struct Source {
+        AssetCache* cache;
+        const char* key;
+        const std::string* contents;
+    };
+    const Source sources[] = {
+        { &cache, "small.html", &scratch.small },
+        { &cache, "big.bin", &scratch.big },
+        { &bundled, "stored.bin", &scratch.small },
+        { &bundled, "packed.txt", &packed },
+    };
+
+    // 32 handlers serve random (ranged) requests while entries are invalidated underneath them
+    std::atomic<size_t> requests{ 0 };
+    std::atomic<size_t> failures{ 0 };
+    std::vector<std::thread> threads;
+    for (unsigned thread = 0; thread < 32; thread++) {
+        threads.emplace_back([&, thread] {
+            std::mt19937 rng(thread);
+            AssetResponse response;
+            for (int i = 0; i < 150; i++) {
+                const Source& source = sources[rng() % 4];
+                if (rng() % 50 == 0) {
+                    source.cache->Invalidate(source.key);
+                }
+
+                size_t size = source.contents->size();
+                size_t first = 0;
+                size_t last = size - 1;
+                std::string range;
+                if (rng() % 2) {
+                    first = rng() % size;
+                    last = first + rng() % (size - first);
+                    range = "bytes=" + std::to_string(first) + "-" + std::to_string(last);
+                }
+
+                response.Begin(source.cache->Get(source.key), range, "");
+                std::string body = ReadAll(response, 1 + rng() % 65536);
+                if (response.GetStatus() != (range.empty() ? 200 : 206) ||
+                    body != source.contents->substr(first, last - first + 1)) {
+                    failures++;
+                }
+                requests++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK_EQ(requests.load(), 32u * 150u);
+    CHECK_EQ(failures.load(), 0u);
+}
@@ -0,0 +1,329 @@
+#include "TestHarness.h"
+
+#include "UI/FrameCompositor.h"
+
+#include <cstring>
+
+using namespace Nexile;
+using namespace std::chrono;
+
+namespace {
+    using TimePoint = FramePacer::TimePoint;
+
+    const TimePoint kStart = TimePoint() + hours(1);
+
+    bool Same(const PaintRect& a, const PaintRect& b) {
+        return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+    }
+
+    // Records what each present pushed to the window
+    struct PresentLog {
+        int presents = 0;
+        std::vector<PaintRect> rects;
+        PaintRect bounds;
+
+        FrameCompositor::PresentCallback Callback() {
+            return [this](const std::vector<PaintRect>& presented, const PaintRect& presentedBounds) {
+                presents++;
+                rects = presented;
+                bounds = presentedBounds;
+            };
+        }
+    };
+}
+
+// -----------------------------------------------------------------------------
+// PaintRect
+// -----------------------------------------------------------------------------
+
+NX_TEST(RectUnionAndIntersection) {
+    PaintRect a(0, 0, 10, 10);
+    PaintRect b(5, 5, 10, 10);
+    CHECK(Same(PaintRect::Union(a, b), PaintRect(0, 0, 15, 15)));
+    CHECK(Same(PaintRect::Intersect(a, b), PaintRect(5, 5, 5, 5)));
+
+    // Touching edges do not intersect; empty rects do not grow a union
+    CHECK(PaintRect::Intersect(a, PaintRect(10, 0, 5, 5)).IsEmpty());
+    CHECK(Same(PaintRect::Union(PaintRect(), b), b));
+    CHECK(Same(PaintRect::Union(a, PaintRect(3, 3, 0, 7)), a));
+    CHECK_EQ(PaintRect(0, 0, -4, 10).Area(), 0);
+}
+
+// -----------------------------------------------------------------------------
+// DirtyRegion
+// -----------------------------------------------------------------------------
+
+NX_TEST(NearbyRectsMergeAndDistantOnesDoNot) {
+    DirtyRegion region(4, 0.6);
+    region.SetBounds(1000, 1000);
+
+    region.Add(PaintRect(10, 10, 10, 10));
+    region.Add(PaintRect(15, 15, 10, 10));
+    REQUIRE(region.GetRects().size() == 1);
+    CHECK(Same(region.GetRects()[0], PaintRect(10, 10, 15, 15)));
+
+    region.Add(PaintRect(500, 500, 20, 20));
+    CHECK_EQ(region.GetRects().size(), 2u);
+    CHECK(Same(region.GetBounds(), PaintRect(10, 10, 510, 510)));
+    CHECK_EQ(region.GetArea(), 15 * 15 + 20 * 20);
+}
+
+NX_TEST(CoveredAndEmptyRectsAreDropped) {
+    DirtyRegion region(4, 0.6);
+    region.SetBounds(1000, 1000);
+    region.Add(PaintRect(100, 100, 50, 50));
+
+    region.Add(PaintRect(110, 110, 2, 2));
+    region.Add(PaintRect(0, 0, 0, 30));
+    region.Add(PaintRect(2000, 2000, 10, 10));      // outside the frame
+    CHECK_EQ(region.GetRects().size(), 1u);
+    CHECK_EQ(region.GetArea(), 2500);
+}
+
+NX_TEST(RectsAreClippedToTheFrame) {
+    DirtyRegion region(4, 0.6);
+    region.SetBounds(100, 100);
+    region.Add(PaintRect(-50, -50, 60, 60));
+    region.Add(PaintRect(95, 20, 30, 5));
+
+    REQUIRE(region.GetRects().size() == 2);
+    CHECK(Same(region.GetRects()[0], PaintRect(0, 0, 10, 10)));
+    CHECK(Same(region.GetRects()[1], PaintRect(95, 20, 5, 5)));
+}
+
+NX_TEST(RectCountIsCapped) {
+    DirtyRegion region(4, 0.6);
+    region.SetBounds(1000, 1000);
+    // Alternating rows so neighbours are too far apart to merge for free
+    for (int i = 0; i < 10; i++) {
+        region.Add(PaintRect(i * 90, (i % 2) * 800, 10, 10));
+        CHECK(region.GetRects().size() <= 4u);
+    }
+    CHECK_EQ(region.GetRects().size(), 4u);
+
+    // Every painted pixel is still covered
+    for (int i = 0; i < 10; i++) {
+        int64_t covered = 0;
+        for (const PaintRect& rect : region.GetRects()) {
+            covered += PaintRect::Intersect(rect, PaintRect(i * 90, (i % 2) * 800, 10, 10)).Area();
+        }
+        CHECK_EQ(covered, 100);
+    }
+}
+
+NX_TEST(LargeRegionsCollapseToTheFullFrame) {
+    DirtyRegion region(4, 0.6);
+    region.SetBounds(1000, 1000);
+    region.Add(PaintRect(500, 500, 20, 20));
+    region.Add(PaintRect(0, 0, 900, 700));
+
+    REQUIRE(region.GetRects().size() == 1);
+    CHECK(Same(region.GetRects()[0], PaintRect(0, 0, 1000, 1000)));
+
+    region.Clear();
+    CHECK(region.IsEmpty());
+    region.AddFull();
+    CHECK_EQ(region.GetArea(), 1000000);
+
+    // Resizing drops what was pending
+    region.SetBounds(200, 100);
+    CHECK(region.IsEmpty());
+}
+
+// -----------------------------------------------------------------------------
+// FramePacer
+// -----------------------------------------------------------------------------
+
+NX_TEST(PacerStartsStaticAndAnimatesOnPaint) {
+    FramePacer pacer;
+    CHECK(pacer.GetMode(kStart) == PaceMode::Static);
+    CHECK_EQ(pacer.GetTargetFps(kStart), 1);
+    CHECK(pacer.NextModeChange(kStart) == TimePoint::max());
+
+    // Nothing presented yet: present at once
+    CHECK(pacer.NextPresentTime(kStart) == kStart);
+
+    pacer.OnPaint(kStart);
+    CHECK(pacer.GetMode(kStart) == PaceMode::Animating);
+    CHECK_EQ(pacer.GetTargetFps(kStart), 60);
+    CHECK(pacer.NextModeChange(kStart) == kStart + milliseconds(500));
+    CHECK(pacer.GetMode(kStart + milliseconds(499)) == PaceMode::Animating);
+    CHECK(pacer.GetMode(kStart + milliseconds(500)) == PaceMode::Static);
+}
+
+NX_TEST(PresentsAreSpacedByTheFrameInterval) {
+    FramePacer pacer;
+    pacer.OnPaint(kStart);
+    pacer.OnPresent(kStart);
+
+    // 60 fps less an eighth of a frame of slack
+    TimePoint next = pacer.NextPresentTime(kStart + milliseconds(1));
+    CHECK(next > kStart + milliseconds(14) && next < kStart + milliseconds(15));
+
+    // Static rate: one frame a second
+    TimePoint quiet = kStart + milliseconds(600);
+    TimePoint staticNext = pacer.NextPresentTime(quiet);
+    CHECK(staticNext > kStart + milliseconds(870) && staticNext < kStart + milliseconds(880));
+
+    // The first paint after a quiet period presents immediately
+    TimePoint later = kStart + seconds(5);
+    pacer.OnPaint(later);
+    CHECK(pacer.NextPresentTime(later) == later);
+}
+
+NX_TEST(HiddenPacerPresentsNothing) {
+    FramePacer pacer;
+    pacer.OnPresent(kStart);
+    pacer.SetVisible(false, kStart);
+    CHECK(!pacer.IsVisible());
+    CHECK(pacer.GetMode(kStart) == PaceMode::Hidden);
+    CHECK_EQ(pacer.GetTargetFps(kStart), 0);
+    CHECK(pacer.NextPresentTime(kStart) == TimePoint::max());
+
+    pacer.OnPaint(kStart + seconds(1));
+    CHECK(pacer.GetMode(kStart + seconds(1)) == PaceMode::Hidden);
+
+    // Showing again counts as activity
+    TimePoint shown = kStart + seconds(10);
+    pacer.SetVisible(true, shown);
+    CHECK(pacer.GetMode(shown) == PaceMode::Animating);
+    CHECK(pacer.NextPresentTime(shown) == shown);
+}
+
+NX_TEST(PacerOptionsAreHonoured) {
+    FramePacerOptions options;
+    options.animatingFps = 30;
+    options.staticFps = 0;
+    options.animationHold = milliseconds(100);
+    FramePacer pacer(options);
+
+    pacer.OnActivity(kStart);
+    pacer.OnPresent(kStart);
+    CHECK_EQ(pacer.GetTargetFps(kStart), 30);
+    TimePoint next = pacer.NextPresentTime(kStart);
+    CHECK(next > kStart + milliseconds(29) && next < kStart + milliseconds(30));
+
+    // A zero static rate never presents while static
+    CHECK(pacer.NextPresentTime(kStart + milliseconds(100)) == TimePoint::max());
+}
+
+// -----------------------------------------------------------------------------
+// FrameCompositor
+// -----------------------------------------------------------------------------
+
+NX_TEST(OnlyDirtyRectsAreCopied) {
+    const int width = 64, height = 48;
+    std::vector<uint8_t> backing(width * height * 4, 0);
+    std::vector<uint8_t> frame(width * height * 4, 0xAB);
+
+    FrameCompositor compositor;
+    compositor.Attach(backing.data(), width, height, width * 4);
+    PresentLog log;
+    CHECK(compositor.Present(kStart, log.Callback()));
+    CHECK(Same(log.bounds, PaintRect(0, 0, width, height)));
+
+    PaintRect rect(10, 20, 5, 3);
+    compositor.OnPaint(frame.data(), width, height, &rect, 1, kStart + milliseconds(1));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bool inside = x >= 10 && x < 15 && y >= 20 && y < 23;
+            if ((backing[(y * width + x) * 4] == 0xAB) != inside) {
+                Test::Fail(__FILE__, __LINE__, "pixel " + std::to_string(x) + "," + std::to_string(y));
+                return;
+            }
+        }
+    }
+    CHECK_EQ(compositor.GetStats().pixelsCopied, 15u);
+}
+
+NX_TEST(BackingStoresWithPaddedRowsAreHonoured) {
+    const int width = 16, height = 8, stride = 20 * 4;
+    std::vector<uint8_t> backing(stride * height, 0);
+    std::vector<uint8_t> frame(width * height * 4);
+    for (size_t i = 0; i < frame.size(); i++) frame[i] = static_cast<uint8_t>(i);
+
+    FrameCompositor compositor;
+    compositor.Attach(backing.data(), width, height, stride);
+    PaintRect all(0, 0, width, height);
+    compositor.OnPaint(frame.data(), width, height, &all, 1, kStart);
+
+    for (int y = 0; y < height; y++) {
+        CHECK(std::memcmp(&backing[y * stride], &frame[y * width * 4], width * 4) == 0);
+        CHECK_EQ(backing[y * stride + width * 4], 0);   // padding untouched
+    }
+}
+
+NX_TEST(PaintsBetweenPresentsAreCoalesced) {
+    const int width = 320, height = 240;
+    std::vector<uint8_t> backing(width * height * 4);
+    std::vector<uint8_t> frame(width * height * 4);
+
+    FrameCompositor compositor;
+    compositor.Attach(backing.data(), width, height, width * 4);
+    PresentLog log;
+    compositor.Present(kStart, log.Callback());
+
+    PaintRect caret(100, 100, 2, 18);
+    PaintRect text(104, 100, 40, 18);
+    compositor.OnPaint(frame.data(), width, height, &caret, 1, kStart + milliseconds(1));
+    CHECK(!compositor.Present(kStart + milliseconds(2), log.Callback()));      // paced
+    compositor.OnPaint(frame.data(), width, height, &text, 1, kStart + milliseconds(9));
+    CHECK(compositor.HasPending());
+
+    CHECK(compositor.Present(kStart + milliseconds(17), log.Callback()));
+    CHECK_EQ(log.presents, 2);
+    CHECK(Same(log.bounds, PaintRect(100, 100, 44, 18)));
+    CHECK(!compositor.HasPending());
+    CHECK(!compositor.Present(kStart + seconds(1), log.Callback()));          // nothing pending
+
+    const CompositorStats& stats = compositor.GetStats();
+    CHECK_EQ(stats.paints, 2u);
+    CHECK_EQ(stats.presents, 2u);
+    CHECK_EQ(stats.coalescedPaints, 1u);
+    CHECK_EQ(stats.fullFramePresents, 1u);
+}
+
+NX_TEST(MismatchedAndDetachedPaintsAreIgnored) {
+    const int width = 32, height = 32;
+    std::vector<uint8_t> backing(width * height * 4, 0);
+    std::vector<uint8_t> frame(64 * 64 * 4, 0xFF);
+
+    FrameCompositor compositor;
+    compositor.Attach(backing.data(), width, height, width * 4);
+    PresentLog log;
+    compositor.Present(kStart, log.Callback());
+
+    // A paint at the old size during a resize
+    PaintRect rect(0, 0, 8, 8);
+    compositor.OnPaint(frame.data(), 64, 64, &rect, 1, kStart + milliseconds(1));
+    CHECK(!compositor.HasPending());
+    CHECK_EQ(backing[0], 0);
+    CHECK_EQ(compositor.GetStats().paints, 1u);
+
+    compositor.Detach();
+    CHECK(!compositor.IsAttached());
+    compositor.OnPaint(frame.data(), width, height, &rect, 1, kStart + seconds(1));
+    CHECK(!compositor.Present(kStart + seconds(2), log.Callback()));
+    CHECK_EQ(log.presents, 1);
+}
+
+NX_TEST(HiddenCompositorKeepsChangesForLater) {
+    const int width = 32, height = 32;
+    std::vector<uint8_t> backing(width * height * 4);
+    std::vector<uint8_t> frame(width * height * 4);
+
+    FrameCompositor compositor;
+    compositor.Attach(backing.data(), width, height, width * 4);
+    PresentLog log;
+    compositor.Present(kStart, log.Callback());
+
+    compositor.GetPacer().SetVisible(false, kStart);
+    PaintRect rect(4, 4, 4, 4);
+    compositor.OnPaint(frame.data(), width, height, &rect, 1, kStart + seconds(1));
+    CHECK(!compositor.Present(kStart + seconds(2), log.Callback()));
+    CHECK(compositor.HasPending());
+
+    compositor.GetPacer().SetVisible(true, kStart + seconds(3));
+    CHECK(compositor.Present(kStart + seconds(3), log.Callback()));
+    CHECK(Same(log.bounds, rect));
+}
@@ -0,0 +1,248 @@
+#include "TestHarness.h"
+
+#include "UI/HtmlTemplate.h"
+
+#include <string>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    std::string EscapeSlowly(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            case '\'': out += "&#39;"; break;
+            default: out += c; break;
+            }
+        }
+        return out;
+    }
+
+    std::string Escape(const std::string& text) {
+        std::string out;
+        HtmlTemplate::AppendEscaped(text, out);
+        return out;
+    }
+
+    // Compile and render, or the compile error
+    std::string RenderSource(const std::string& source, const json& data) {
+        HtmlTemplate html;
+        std::string error;
+        if (!html.Compile(source, error)) return "error: " + error;
+        return html.Render(data);
+    }
+
+    std::string CompileError(const std::string& source) {
+        HtmlTemplate html;
+        std::string error;
+        if (html.Compile(source, error)) return "";
+        CHECK(html.IsEmpty());
+        return error;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Escaping
+// -----------------------------------------------------------------------------
+
+NX_TEST(SpecialCharactersAreEscaped) {
+    CHECK_EQ(Escape("Tailor's Orb <5> & \"more\""), "Tailor&#39;s Orb &lt;5&gt; &amp; &quot;more&quot;");
+    CHECK_EQ(Escape(""), "");
+    CHECK_EQ(Escape("&&&"), "&amp;&amp;&amp;");
+
+    // Multi-byte UTF-8 passes through
+    CHECK_EQ(Escape("Chaos \xE2\x86\x92 Divine"), "Chaos \xE2\x86\x92 Divine");
+
+    // Appends to what the buffer holds
+    std::string out = "<td>";
+    HtmlTemplate::AppendEscaped("a<b", out);
+    CHECK_EQ(out, "<td>a&lt;b");
+}
+
+NX_TEST(EscapingIsRightAroundWordBoundaries) {
+    // Every special character at every position of texts up to three words
+    // long, so each lands first, last and inside an eight-byte word and in
+    // the byte-by-byte tail
+    const std::string specials = "&<>\"'";
+    for (size_t length = 1; length <= 24; length++) {
+        for (size_t position = 0; position < length; position++) {
+            for (char special : specials) {
+                std::string text(length, 'x');
+                text[position] = special;
+                CHECK_EQ(Escape(text), EscapeSlowly(text));
+            }
+        }
+    }
+
+    // Two specials in one word, and specials in adjacent words
+    for (size_t first = 0; first < 16; first++) {
+        for (size_t second = first + 1; second < 17; second++) {
+            std::string text(17, 'a');
+            text[first] = '<';
+            text[second] = '\'';
+            CHECK_EQ(Escape(text), EscapeSlowly(text));
+        }
+    }
+
+    // Bytes that differ from a special one only in the high bit or by one
+    std::string nearMisses;
+    for (char c : specials) {
+        nearMisses += static_cast<char>(c | 0x80);
+        nearMisses += static_cast<char>(c + 1);
+        nearMisses += static_cast<char>(c - 1);
+    }
+    CHECK_EQ(Escape(nearMisses + nearMisses), EscapeSlowly(nearMisses + nearMisses));
+}
+
+NX_TEST(SlotsEscapeUnlessRaw) {
+    json data = { {"name", "<b>Doom Loop</b>"} };
+    CHECK_EQ(RenderSource("{{name}}", data), "&lt;b&gt;Doom Loop&lt;/b&gt;");
+    CHECK_EQ(RenderSource("{{{name}}}", data), "<b>Doom Loop</b>");
+    CHECK_EQ(RenderSource("{{& name }}", data), "<b>Doom Loop</b>");
+
+    // Numbers and bools print; null, objects, arrays and missing names do not
+    json values = { {"ilvl", 84}, {"count", 3000000000u}, {"ratio", 0.5}, {"on", true}, {"off", false},
+                    {"none", nullptr}, {"obj", { {"a", 1} }}, {"list", { 1, 2 }} };
+    CHECK_EQ(RenderSource("{{ilvl}}|{{count}}|{{ratio}}|{{on}}|{{off}}", values), "84|3000000000|0.5|true|false");
+    CHECK_EQ(RenderSource("[{{none}}{{obj}}{{list}}{{missing}}]", values), "[]");
+
+    // Comments vanish, leaving one text chunk
+    HtmlTemplate html;
+    std::string error;
+    REQUIRE(html.Compile("<td>{{! the item name }}</td>", error));
+    CHECK_EQ(html.GetInstructionCount(), 1u);
+    CHECK_EQ(html.Render(json::object()), "<td></td>");
+}
+
+// -----------------------------------------------------------------------------
+// Sections
+// -----------------------------------------------------------------------------
+
+NX_TEST(SectionsRepeatOrEnterByValue) {
+    const std::string source = "{{#v}}[{{.}}]{{/v}}";
+
+    // Arrays repeat per element, objects enter once as the scope
+    CHECK_EQ(RenderSource(source, { {"v", { 1, "two", 3 }} }), "[1][two][3]");
+    CHECK_EQ(RenderSource("{{#v}}{{name}}{{/v}}", { {"v", { {"name", "Gale Coil"} }} }), "Gale Coil");
+
+    // Other truthy values render once with the scope unchanged
+    CHECK_EQ(RenderSource("{{#v}}yes{{/v}}", { {"v", true} }), "yes");
+    CHECK_EQ(RenderSource("{{#v}}yes{{/v}}", { {"v", "text"} }), "yes");
+    CHECK_EQ(RenderSource("{{#v}}yes{{/v}}", { {"v", 2.5} }), "yes");
+    CHECK_EQ(RenderSource("{{#v}}yes{{/v}}", { {"v", json::object()} }), "yes");
+
+    // Falsy values skip the section
+    for (const json& falsy : { json(false), json(nullptr), json(0), json(0u), json(0.0), json(""), json::array() }) {
+        CHECK_EQ(RenderSource("a{{#v}}yes{{/v}}b", { {"v", falsy} }), "ab");
+    }
+    CHECK_EQ(RenderSource("a{{#v}}yes{{/v}}b", json::object()), "ab");
+}
+
+NX_TEST(InvertedSectionsAreTheOpposite) {
+    const std::string source = "{{^v}}none{{/v}}";
+    for (const json& falsy : { json(false), json(nullptr), json(0), json(0.0), json(""), json::array() }) {
+        CHECK_EQ(RenderSource(source, { {"v", falsy} }), "none");
+    }
+    CHECK_EQ(RenderSource(source, json::object()), "none");
+
+    for (const json& truthy : { json(true), json(1), json("0"), json::array({ 0 }), json::object() }) {
+        CHECK_EQ(RenderSource(source, { {"v", truthy} }), "");
+    }
+
+    // An inverted section does not enter the value as a scope
+    CHECK_EQ(RenderSource("{{#rows}}{{name}}{{/rows}}{{^rows}}No matches{{/rows}}",
+                          { {"rows", json::array()}, {"name", "outer"} }),
+             "No matches");
+}
+
+NX_TEST(SectionsNestAndSkipCleanly) {
+    json data = {
+        {"groups", {
+            { {"title", "Rings"}, {"items", { { {"name", "Doom Loop"} }, { {"name", "Gale Coil"} } }} },
+            { {"title", "Belts"}, {"items", json::array()} }
+        }}
+    };
+    CHECK_EQ(RenderSource("{{#groups}}<h2>{{title}}</h2>{{#items}}<p>{{name}}</p>{{/items}}"
+                          "{{^items}}<p>empty</p>{{/items}}{{/groups}}!", data),
+             "<h2>Rings</h2><p>Doom Loop</p><p>Gale Coil</p><h2>Belts</h2><p>empty</p>!");
+}
+
+// -----------------------------------------------------------------------------
+// Lookup
+// -----------------------------------------------------------------------------
+
+NX_TEST(NamesResolveFromTheInnermostScope) {
+    json data = {
+        {"currency", "chaos"},
+        {"league", { {"name", "Settlers"}, {"short", "SET"} }},
+        {"rows", {
+            { {"name", "Doom Loop"}, {"price", { {"amount", 5}, {"currency", "divine"} }} },
+            { {"name", "Gale Coil"}, {"price", { {"amount", 40} }} }
+        }}
+    };
+
+    // name comes from the row; currency from the price, else from the root
+    CHECK_EQ(RenderSource("{{#rows}}{{name}}: {{#price}}{{amount}} {{currency}}{{/price}};{{/rows}}", data),
+             "Doom Loop: 5 divine;Gale Coil: 40 chaos;");
+
+    // A dotted path looks up its first name through the scopes, the rest
+    // inside that value only
+    CHECK_EQ(RenderSource("{{#rows}}{{league.name}}/{{price.amount}}/{{name.length}};{{/rows}}", data),
+             "Settlers/5/;Settlers/40/;");
+    CHECK_EQ(RenderSource("{{#rows}}[{{price.currency}}]{{/rows}}", data), "[divine][]");
+    CHECK_EQ(RenderSource("{{#league}}{{short}} {{league.short}}{{/league}}", data), "SET SET");
+
+    // Sections open on dotted paths too
+    CHECK_EQ(RenderSource("{{#league.name}}has league{{/league.name}}", data), "has league");
+}
+
+// -----------------------------------------------------------------------------
+// Compile errors
+// -----------------------------------------------------------------------------
+
+NX_TEST(CompileErrorsGiveTheLine) {
+    CHECK_EQ(CompileError("<tr>\n<td>{{name</td>\n</tr>"), "Unclosed tag at line 2");
+    CHECK_EQ(CompileError("{{#rows}}\n<tr>\n</tr>\n"), "Unclosed section 'rows' at line 1");
+    CHECK_EQ(CompileError("a\nb\n{{#rows}}{{#cells}}\n{{/rows}}{{/cells}}"), "Unexpected end of section 'rows' at line 4");
+    CHECK_EQ(CompileError("\n\n\n{{/rows}}"), "Unexpected end of section 'rows' at line 4");
+    CHECK_EQ(CompileError("x\n{{}}"), "Invalid name '' at line 2");
+    CHECK_EQ(CompileError("{{a..b}}"), "Invalid name 'a..b' at line 1");
+    CHECK_EQ(CompileError("\n{{#.rows}}{{/.rows}}"), "Invalid name '.rows' at line 2");
+    CHECK_EQ(CompileError("{{{raw}}\n"), "Unclosed tag at line 1");
+
+    // A failed compile replaces a good template
+    HtmlTemplate html;
+    std::string error;
+    REQUIRE(html.Compile("<td>{{name}}</td>", error));
+    CHECK(!html.Compile("{{#rows}}", error));
+    CHECK(html.IsEmpty());
+    CHECK_EQ(html.Render({ {"name", "x"} }), "");
+}
+
+NX_TEST(RendersAppendToAReusedBuffer) {
+    HtmlTemplate html;
+    std::string error;
+    REQUIRE(html.Compile("{{#rows}}<tr><td>{{name}}</td></tr>{{/rows}}", error));
+
+    json data = { {"rows", json::array()} };
+    for (int row = 0; row < 100; row++) {
+        data["rows"].push_back({ {"name", "Item " + std::to_string(row)} });
+    }
+
+    std::string out;
+    html.Render(data, out);
+    const std::string first = out;
+    const size_t capacity = out.capacity();
+    out.clear();
+    html.Render(data, out);
+    CHECK_EQ(out, first);
+    CHECK_EQ(out.capacity(), capacity);
+
+    html.Render(data, out);
+    CHECK_EQ(out, first + first);
+}
@@ -0,0 +1,229 @@
+#include "TestHarness.h"
+
+#include "UI/MemoryManager.h"
+
+#include <ostream>
+#include <string>
+
+using namespace Nexile;
+using namespace std::chrono_literals;
+
+namespace Nexile {
+    // For CHECK_EQ messages
+    std::ostream& operator<<(std::ostream& out, MemoryStage stage) {
+        return out << MemoryManager::GetStageName(stage);
+    }
+}
+
+namespace {
+    MemoryManagerOptions AllStages() {
+        MemoryManagerOptions options;
+        options.trimAfter = 30s;
+        options.discardAfter = 5min;
+        options.suspendAfter = 15min;
+        return options;
+    }
+
+    const MemoryManager::TimePoint kStart = MemoryManager::Clock::now();
+}
+
+// -----------------------------------------------------------------------------
+// Stages
+// -----------------------------------------------------------------------------
+
+NX_TEST(StagesFallDueAtTheirThresholds) {
+    MemoryManager manager(AllStages());
+    CHECK_EQ(manager.GetNextStage(), MemoryStage::Active);
+    CHECK(manager.GetNextStageTime() == MemoryManager::TimePoint::max());
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::Active);
+
+    manager.OnHidden(kStart);
+    CHECK(manager.IsHidden());
+    CHECK_EQ(manager.GetNextStage(), MemoryStage::Trimmed);
+    CHECK(manager.GetNextStageTime() == kStart + 30s);
+
+    // Nothing just before a threshold, the stage exactly at it
+    CHECK_EQ(manager.TakeDueStage(kStart + 30s - 1ms), MemoryStage::Active);
+    CHECK_EQ(manager.TakeDueStage(kStart + 30s), MemoryStage::Trimmed);
+    CHECK_EQ(manager.GetStage(), MemoryStage::Trimmed);
+    CHECK(manager.GetNextStageTime() == kStart + 5min);
+
+    CHECK_EQ(manager.TakeDueStage(kStart + 5min - 1ms), MemoryStage::Active);
+    CHECK_EQ(manager.TakeDueStage(kStart + 5min), MemoryStage::PagesDiscarded);
+    CHECK_EQ(manager.TakeDueStage(kStart + 15min - 1ms), MemoryStage::Active);
+    CHECK_EQ(manager.TakeDueStage(kStart + 15min), MemoryStage::Suspended);
+
+    // Nothing is left after the last stage
+    CHECK_EQ(manager.GetNextStage(), MemoryStage::Active);
+    CHECK(manager.GetNextStageTime() == MemoryManager::TimePoint::max());
+    CHECK_EQ(manager.TakeDueStage(kStart + 10h), MemoryStage::Active);
+    CHECK_EQ(manager.GetStage(), MemoryStage::Suspended);
+}
+
+NX_TEST(OverdueStagesRunOneAtATimeInOrder) {
+    MemoryManager manager(AllStages());
+    manager.OnHidden(kStart);
+
+    // Woken long after every threshold: each stage still runs, in order
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::Trimmed);
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::PagesDiscarded);
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::Suspended);
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::Active);
+}
+
+NX_TEST(DisabledStagesAreSkipped) {
+    // The defaults never suspend
+    MemoryManager manager;
+    manager.OnHidden(kStart);
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::Trimmed);
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::PagesDiscarded);
+    CHECK_EQ(manager.TakeDueStage(kStart + 1h), MemoryStage::Active);
+
+    // A stage turned off does not hold back a later one
+    MemoryManagerOptions options = AllStages();
+    options.trimAfter = 0ms;
+    options.discardAfter = 0ms;
+    MemoryManager suspendOnly(options);
+    suspendOnly.OnHidden(kStart);
+    CHECK_EQ(suspendOnly.GetNextStage(), MemoryStage::Suspended);
+    CHECK_EQ(suspendOnly.TakeDueStage(kStart + 1min), MemoryStage::Active);
+    CHECK_EQ(suspendOnly.TakeDueStage(kStart + 15min), MemoryStage::Suspended);
+
+    // And with everything off nothing ever falls due
+    MemoryManager none(MemoryManagerOptions{ 0ms, 0ms, 0ms });
+    none.OnHidden(kStart);
+    CHECK_EQ(none.GetNextStage(), MemoryStage::Active);
+    CHECK_EQ(none.TakeDueStage(kStart + 24h), MemoryStage::Active);
+}
+
+NX_TEST(NewOptionsApplyToTheCurrentHide) {
+    MemoryManager manager(AllStages());
+    manager.OnHidden(kStart);
+    CHECK_EQ(manager.TakeDueStage(kStart + 1min), MemoryStage::Trimmed);
+
+    MemoryManagerOptions options = AllStages();
+    options.discardAfter = 2min;
+    options.suspendAfter = 3min;
+    manager.SetOptions(options);
+    CHECK(manager.GetNextStageTime() == kStart + 2min);
+    CHECK_EQ(manager.TakeDueStage(kStart + 3min), MemoryStage::PagesDiscarded);
+    CHECK_EQ(manager.TakeDueStage(kStart + 3min), MemoryStage::Suspended);
+}
+
+NX_TEST(ShowingReportsTheStageReached) {
+    MemoryManager manager(AllStages());
+    manager.OnHidden(kStart);
+    CHECK_EQ(manager.TakeDueStage(kStart + 6min), MemoryStage::Trimmed);
+    CHECK_EQ(manager.TakeDueStage(kStart + 6min), MemoryStage::PagesDiscarded);
+
+    CHECK_EQ(manager.OnShown(), MemoryStage::PagesDiscarded);
+    CHECK(!manager.IsHidden());
+    CHECK_EQ(manager.GetStage(), MemoryStage::Active);
+    CHECK_EQ(manager.GetNextStage(), MemoryStage::Active);
+
+    // A quick toggle reaches nothing; a second hide does not restart the clock
+    manager.OnHidden(kStart + 10min);
+    manager.OnHidden(kStart + 10min + 20s);
+    CHECK(manager.GetNextStageTime() == kStart + 10min + 30s);
+    CHECK_EQ(manager.OnShown(), MemoryStage::Active);
+}
+
+NX_TEST(StagesRecordTheWorkingSet) {
+    MemoryManager manager(AllStages());
+    manager.RecordStage(MemoryStage::Trimmed, 300u << 20, 180u << 20);
+    manager.RecordStage(MemoryStage::PagesDiscarded, 180u << 20, 120u << 20);
+    // A stage that grew the working set releases nothing
+    manager.RecordStage(MemoryStage::Trimmed, 120u << 20, 125u << 20);
+    manager.RecordStage(MemoryStage::Suspended, 125u << 20, 40u << 20);
+
+    const MemoryStats& stats = manager.GetStats();
+    CHECK_EQ(stats.trims, 2u);
+    CHECK_EQ(stats.discards, 1u);
+    CHECK_EQ(stats.suspends, 1u);
+    CHECK_EQ(stats.lastStage, MemoryStage::Suspended);
+    CHECK_EQ(stats.lastBytesBefore, size_t(125u << 20));
+    CHECK_EQ(stats.lastBytesAfter, size_t(40u << 20));
+    CHECK_EQ(stats.bytesReleased, uint64_t(265u) << 20);
+}
+
+// -----------------------------------------------------------------------------
+// Restores
+// -----------------------------------------------------------------------------
+
+NX_TEST(RestoresAreTimedFromShowToPage) {
+    MemoryManager manager(AllStages());
+    CHECK_EQ(manager.EndRestore(kStart), 0.0);
+    CHECK_EQ(manager.GetStats().restores, 0u);
+
+    manager.BeginRestore(kStart);
+    CHECK(manager.IsRestoring());
+    CHECK_NEAR(manager.EndRestore(kStart + 400ms), 400.0, 1e-9);
+    CHECK(!manager.IsRestoring());
+
+    manager.BeginRestore(kStart + 1s);
+    CHECK_NEAR(manager.EndRestore(kStart + 1s + 200ms), 200.0, 1e-9);
+
+    // Only the first page load after a restore counts
+    CHECK_EQ(manager.EndRestore(kStart + 2s), 0.0);
+
+    // A cancelled restore is not counted
+    manager.BeginRestore(kStart + 3s);
+    manager.CancelRestore();
+    CHECK(!manager.IsRestoring());
+    CHECK_EQ(manager.EndRestore(kStart + 4s), 0.0);
+
+    const MemoryStats& stats = manager.GetStats();
+    CHECK_EQ(stats.restores, 2u);
+    CHECK_NEAR(stats.lastRestoreMs, 200.0, 1e-9);
+    CHECK_NEAR(stats.averageRestoreMs, 300.0, 1e-9);
+    CHECK_NEAR(stats.maxRestoreMs, 400.0, 1e-9);
+}
+
+NX_TEST(ShownAfterSuspendRestores) {
+    MemoryManager manager(AllStages());
+    manager.OnHidden(kStart);
+    while (manager.TakeDueStage(kStart + 20min) != MemoryStage::Active) {
+    }
+
+    // The overlay restores the browser because the stage reached says so
+    CHECK_EQ(manager.OnShown(), MemoryStage::Suspended);
+    manager.BeginRestore(kStart + 20min);
+    CHECK_EQ(manager.GetStage(), MemoryStage::Active);
+    CHECK_EQ(manager.GetNextStage(), MemoryStage::Active);
+    CHECK_NEAR(manager.EndRestore(kStart + 20min + 650ms), 650.0, 1e-9);
+}
+
+NX_TEST(WokenWhileHiddenStagesStartOver) {
+    MemoryManager manager(AllStages());
+    manager.OnHidden(kStart);
+    while (manager.TakeDueStage(kStart + 20min) != MemoryStage::Active) {
+    }
+    CHECK_EQ(manager.GetStage(), MemoryStage::Suspended);
+
+    // A hotkey brings the browser back while the overlay stays hidden
+    const MemoryManager::TimePoint woken = kStart + 1h;
+    manager.BeginRestore(woken);
+    CHECK(manager.IsHidden());
+    CHECK_EQ(manager.GetStage(), MemoryStage::Active);
+    CHECK_EQ(manager.GetNextStage(), MemoryStage::Trimmed);
+    CHECK(manager.GetNextStageTime() == woken + 30s);
+    CHECK_NEAR(manager.EndRestore(woken + 300ms), 300.0, 1e-9);
+
+    // Left hidden, it is suspended again on the same schedule
+    CHECK_EQ(manager.TakeDueStage(woken + 29s), MemoryStage::Active);
+    CHECK_EQ(manager.TakeDueStage(woken + 15min), MemoryStage::Trimmed);
+    CHECK_EQ(manager.TakeDueStage(woken + 15min), MemoryStage::PagesDiscarded);
+    CHECK_EQ(manager.TakeDueStage(woken + 15min), MemoryStage::Suspended);
+
+    // Woken again and then shown: the browser is already on its way back,
+    // so showing does not restore it a second time
+    manager.BeginRestore(woken + 2h);
+    CHECK_EQ(manager.OnShown(), MemoryStage::Active);
+}
+
+NX_TEST(StageNames) {
+    CHECK_EQ(std::string(MemoryManager::GetStageName(MemoryStage::Active)), "active");
+    CHECK_EQ(std::string(MemoryManager::GetStageName(MemoryStage::Trimmed)), "trimmed");
+    CHECK_EQ(std::string(MemoryManager::GetStageName(MemoryStage::PagesDiscarded)), "pages-discarded");
+    CHECK_EQ(std::string(MemoryManager::GetStageName(MemoryStage::Suspended)), "suspended");
+}
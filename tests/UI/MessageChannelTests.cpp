@@ -0,0 +1,174 @@
+#include "TestHarness.h"
+
+#include "UI/MessageChannel.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    const ChannelStats* FindStats(const std::vector<ChannelStats>& stats, const std::string& channel) {
+        for (const ChannelStats& entry : stats) {
+            if (entry.channel == channel) return &entry;
+        }
+        return nullptr;
+    }
+}
+
+NX_TEST(RepliesCarryTheRequestId) {
+    MessageChannel channel;
+    channel.RegisterHandler("math.add", [](const json& payload, json& reply, std::string&) {
+        reply = { {"sum", payload.at("a").get<int>() + payload.at("b").get<int>()} };
+        return true;
+    });
+
+    ChannelReply reply = channel.Answer(41, "math.add", { {"a", 2}, {"b", 3} });
+    CHECK_EQ(reply.requestId, 41);
+    CHECK(reply.ok);
+    CHECK_EQ(reply.value, (json{ {"sum", 5} }));
+    CHECK(reply.error.empty());
+
+    const ChannelStats* stats = FindStats(channel.GetStats(), "math.add");
+    REQUIRE(stats != nullptr);
+    CHECK_EQ(stats->requests, 1u);
+    CHECK_EQ(stats->failures, 0u);
+}
+
+NX_TEST(UnknownChannelsGetAnErrorReply) {
+    MessageChannel channel;
+    ChannelReply reply = channel.Answer(5, "stash_search.query", { {"query", "ring"} });
+    CHECK_EQ(reply.requestId, 5);
+    CHECK(!reply.ok);
+    CHECK(reply.value.is_null());
+    CHECK_EQ(reply.error, "No handler for channel 'stash_search.query'");
+
+    // Unregistered channels stop answering
+    channel.RegisterHandler("bridge.echo", [](const json& payload, json& reply, std::string&) {
+        reply = payload;
+        return true;
+    });
+    CHECK(channel.HasHandler("bridge.echo"));
+    channel.UnregisterHandler("bridge.echo");
+    CHECK(!channel.Answer(6, "bridge.echo", 1).ok);
+}
+
+NX_TEST(FailingHandlersReplyWithTheirError) {
+    MessageChannel channel;
+    channel.RegisterHandler("explicit", [](const json&, json& reply, std::string& error) {
+        reply = { {"partial", true} };
+        error = "Query does not parse";
+        return false;
+    });
+    channel.RegisterHandler("silent", [](const json&, json&, std::string&) { return false; });
+    channel.RegisterHandler("throws", [](const json& payload, json&, std::string&) {
+        return payload.at("missing").get<bool>();
+    });
+    channel.RegisterHandler("runtime", [](const json&, json&, std::string&) -> bool {
+        throw std::runtime_error("Stash not loaded");
+    });
+
+    // A failed handler's partial reply is not sent
+    ChannelReply reply = channel.Answer(1, "explicit", nullptr);
+    CHECK(!reply.ok);
+    CHECK(reply.value.is_null());
+    CHECK_EQ(reply.error, "Query does not parse");
+
+    CHECK_EQ(channel.Answer(2, "silent", nullptr).error, "Request on channel 'silent' failed");
+    CHECK(!channel.Answer(3, "throws", json::object()).error.empty());
+    CHECK_EQ(channel.Answer(4, "runtime", nullptr).error, "Stash not loaded");
+
+    std::vector<ChannelStats> stats = channel.GetStats();
+    for (const char* name : { "explicit", "silent", "throws", "runtime" }) {
+        const ChannelStats* entry = FindStats(stats, name);
+        REQUIRE(entry != nullptr);
+        CHECK_EQ(entry->requests, 1u);
+        CHECK_EQ(entry->failures, 1u);
+    }
+}
+
+NX_TEST(HandlersMayRegisterHandlers) {
+    MessageChannel channel;
+    channel.RegisterHandler("module.load", [&channel](const json&, json& reply, std::string&) {
+        channel.RegisterHandler("module.ping", [](const json&, json& reply, std::string&) {
+            reply = "pong";
+            return true;
+        });
+        reply = true;
+        return true;
+    });
+
+    CHECK(channel.Answer(1, "module.load", nullptr).ok);
+    CHECK_EQ(channel.Answer(2, "module.ping", nullptr).value, "pong");
+}
+
+// -----------------------------------------------------------------------------
+// Renderer bookkeeping
+// -----------------------------------------------------------------------------
+
+NX_TEST(RepliesSettleOnlyPendingIds) {
+    PendingRequests pending;
+    int first = pending.Begin();
+    int second = pending.Begin();
+    int third = pending.Begin();
+    CHECK(first != second && second != third && first != third);
+    CHECK_EQ(pending.GetPendingCount(), 3u);
+
+    // Replies may come back in any order, each exactly once
+    CHECK(pending.Settle(second));
+    CHECK(!pending.Settle(second));
+    CHECK(pending.Settle(first));
+    CHECK_EQ(pending.GetPendingCount(), 1u);
+
+    // Ids nobody asked for are dropped
+    CHECK(!pending.Settle(0));
+    CHECK(!pending.Settle(third + 100));
+    CHECK(pending.Settle(third));
+    CHECK_EQ(pending.GetPendingCount(), 0u);
+}
+
+NX_TEST(RoundTripsMatchRepliesToRequests) {
+    MessageChannel channel;
+    channel.RegisterHandler("double", [](const json& payload, json& reply, std::string&) {
+        reply = payload.get<int>() * 2;
+        return true;
+    });
+
+    // Several requests in flight, answered out of order
+    PendingRequests pending;
+    std::vector<std::pair<int, int>> sent;
+    for (int value = 1; value <= 5; value++) {
+        sent.emplace_back(pending.Begin(), value);
+    }
+    std::reverse(sent.begin(), sent.end());
+
+    for (const auto& request : sent) {
+        ChannelReply reply = channel.Answer(request.first, "double", request.second);
+        REQUIRE(pending.Settle(reply.requestId));
+        CHECK_EQ(reply.value.get<int>(), request.second * 2);
+    }
+    CHECK_EQ(pending.GetPendingCount(), 0u);
+}
+
+NX_TEST(IdsAreUniqueAcrossThreads) {
+    PendingRequests pending;
+    std::vector<std::vector<int>> ids(4);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < ids.size(); thread++) {
+        threads.emplace_back([&, thread] {
+            for (int i = 0; i < 5000; i++) ids[thread].push_back(pending.Begin());
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<int> all;
+    for (const std::vector<int>& list : ids) all.insert(all.end(), list.begin(), list.end());
+    std::sort(all.begin(), all.end());
+    CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+    CHECK_EQ(pending.GetPendingCount(), 20000u);
+}
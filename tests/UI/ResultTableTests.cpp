@@ -0,0 +1,280 @@
+#include "TestHarness.h"
+
+#include "UI/ResultTable.h"
+
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    ResultColumn TextColumn(const std::string& name, std::vector<std::string> text) {
+        ResultColumn column;
+        column.name = name;
+        column.text = std::move(text);
+        return column;
+    }
+
+    ResultColumn NumberColumn(const std::string& name, std::vector<double> numbers) {
+        ResultColumn column;
+        column.name = name;
+        column.numeric = true;
+        column.numbers = std::move(numbers);
+        return column;
+    }
+
+    // A table whose windows list "position:name(ilvl)" per row
+    void Fill(ResultTable& table, std::vector<std::string> names, std::vector<double> levels) {
+        std::string error;
+        REQUIRE(table.SetRowTemplate("{{#rows}}{{row}}:{{name}}({{ilvl}});{{/rows}}", error));
+        std::vector<ResultColumn> columns;
+        columns.push_back(TextColumn("name", std::move(names)));
+        columns.push_back(NumberColumn("ilvl", std::move(levels)));
+        REQUIRE(table.SetColumns(std::move(columns), error));
+    }
+
+    std::string WindowHtml(ResultTable& table, size_t offset = 0, size_t count = 100) {
+        return table.GetWindow(offset, count)["html"].get<std::string>();
+    }
+}
+
+NX_TEST(WindowsRenderASliceOfTheView) {
+    ResultTable table;
+    Fill(table, { "Doom Loop", "Gale Coil", "Vaal Regalia", "Hubris Circlet" }, { 84, 75, 86, 70 });
+    CHECK_EQ(table.GetRowCount(), 4u);
+    CHECK_EQ(table.GetViewCount(), 4u);
+
+    json window = table.GetWindow(1, 2);
+    CHECK_EQ(window["version"], table.GetVersion());
+    CHECK_EQ(window["total"], 4);
+    CHECK_EQ(window["count"], 4);
+    CHECK_EQ(window["offset"], 1);
+    CHECK_EQ(window["rows"], 2);
+    CHECK_EQ(window["html"], "1:Gale Coil(75);2:Vaal Regalia(86);");
+
+    // A window running past the end stops at the last row
+    window = table.GetWindow(3, 10);
+    CHECK_EQ(window["rows"], 1);
+    CHECK_EQ(window["html"], "3:Hubris Circlet(70);");
+
+    ResultTableStats stats = table.GetStats();
+    CHECK_EQ(stats.windows, 2u);
+    CHECK_EQ(stats.windowRows, 3u);
+}
+
+NX_TEST(OffsetsPastTheViewAreClamped) {
+    ResultTable table;
+    Fill(table, { "a", "b", "c" }, { 1, 2, 3 });
+
+    for (size_t offset : { size_t(3), size_t(4), size_t(1000000), static_cast<size_t>(-1) }) {
+        json window = table.GetWindow(offset, 50);
+        CHECK_EQ(window["offset"], 3);
+        CHECK_EQ(window["rows"], 0);
+        CHECK_EQ(window["html"], "");
+    }
+
+    // A huge count does not overflow offset + count
+    json window = table.GetWindow(1, static_cast<size_t>(-1));
+    CHECK_EQ(window["rows"], 2);
+
+    // The clamp follows the filtered view, not the whole set
+    table.Filter("b");
+    window = table.GetWindow(2, 50);
+    CHECK_EQ(window["total"], 3);
+    CHECK_EQ(window["count"], 1);
+    CHECK_EQ(window["offset"], 1);
+    CHECK_EQ(window["rows"], 0);
+
+    // And an empty table
+    table.Clear();
+    table.Filter("");
+    window = table.GetWindow(5, 5);
+    CHECK_EQ(window["offset"], 0);
+    CHECK_EQ(window["rows"], 0);
+}
+
+// -----------------------------------------------------------------------------
+// Sorting
+// -----------------------------------------------------------------------------
+
+NX_TEST(SortsByNumbersStably) {
+    ResultTable table;
+    Fill(table, { "a", "b", "c", "d", "e" }, { 80, 70, 80, 90, 70 });
+    std::string error;
+
+    REQUIRE(table.Sort("ilvl", false, error));
+    CHECK_EQ(WindowHtml(table), "0:b(70);1:e(70);2:a(80);3:c(80);4:d(90);");
+
+    // Ties keep the given order in descending sorts too
+    REQUIRE(table.Sort("ilvl", true, error));
+    CHECK_EQ(WindowHtml(table), "0:d(90);1:a(80);2:c(80);3:b(70);4:e(70);");
+
+    // "" goes back to the given order
+    REQUIRE(table.Sort("", false, error));
+    CHECK_EQ(WindowHtml(table), "0:a(80);1:b(70);2:c(80);3:d(90);4:e(70);");
+
+    CHECK(!table.Sort("price", false, error));
+    CHECK_EQ(error, "Unknown column 'price'");
+}
+
+NX_TEST(TextSortsIgnoreCaseAndKeepTies) {
+    ResultTable table;
+    Fill(table, { "ring", "Amulet", "RING", "belt", "Ring", "amulet", "ring" }, { 1, 2, 3, 4, 5, 6, 7 });
+    std::string error;
+
+    REQUIRE(table.Sort("name", false, error));
+    CHECK_EQ(WindowHtml(table), "0:Amulet(2);1:amulet(6);2:belt(4);3:ring(1);4:RING(3);5:Ring(5);6:ring(7);");
+
+    // Values equal but for case share a rank, so descending keeps them in
+    // the given order rather than reversing them
+    REQUIRE(table.Sort("name", true, error));
+    CHECK_EQ(WindowHtml(table), "0:ring(1);1:RING(3);2:Ring(5);3:ring(7);4:belt(4);5:Amulet(2);6:amulet(6);");
+
+    // A prefix sorts first; letters compare lower-cased, so '_' comes
+    // before them rather than between upper and lower case
+    table.Clear();
+    Fill(table, { "Ring of Fire", "ring", "_ring", "Ring" }, { 1, 2, 3, 4 });
+    REQUIRE(table.Sort("name", false, error));
+    CHECK_EQ(WindowHtml(table), "0:_ring(3);1:ring(2);2:Ring(4);3:Ring of Fire(1);");
+}
+
+NX_TEST(NewContentsKeepTheSortAndFilter) {
+    ResultTable table;
+    Fill(table, { "Doom Loop", "Gale Coil" }, { 84, 75 });
+    std::string error;
+    REQUIRE(table.Sort("ilvl", false, error));
+    table.Filter("o");
+
+    Fill(table, { "Vaal Regalia", "Doom Loop", "Hubris Circlet", "Opal Ring" }, { 86, 84, 70, 81 });
+    CHECK_EQ(WindowHtml(table), "0:Opal Ring(81);1:Doom Loop(84);");
+
+    // A sort column that is gone is dropped
+    std::vector<ResultColumn> columns;
+    columns.push_back(TextColumn("name", { "b", "a", "obo" }));
+    REQUIRE(table.SetColumns(std::move(columns), error));
+    CHECK_EQ(WindowHtml(table), "0:obo();");
+    table.Filter("");
+    CHECK_EQ(WindowHtml(table), "0:b();1:a();2:obo();");
+
+    // Columns of different lengths are refused and leave the table as it was
+    columns.clear();
+    columns.push_back(TextColumn("name", { "a", "b" }));
+    columns.push_back(NumberColumn("ilvl", { 1 }));
+    uint64_t version = table.GetVersion();
+    CHECK(!table.SetColumns(std::move(columns), error));
+    CHECK_EQ(error, "Column 'ilvl' has 1 rows, expected 2");
+    CHECK_EQ(table.GetVersion(), version);
+    CHECK_EQ(table.GetRowCount(), 3u);
+}
+
+// -----------------------------------------------------------------------------
+// Filtering
+// -----------------------------------------------------------------------------
+
+NX_TEST(FiltersMatchAnyTextColumn) {
+    ResultTable table;
+    std::string error;
+    REQUIRE(table.SetRowTemplate("{{#rows}}{{name}}/{{base}};{{/rows}}", error));
+    std::vector<ResultColumn> columns;
+    columns.push_back(TextColumn("name", { "Doom Loop", "", "Gale Coil", "Rapture Clasp" }));
+    columns.push_back(TextColumn("base", { "Two-Stone Ring", "Coral Ring", "Stygian Vise", "Leather Belt" }));
+    columns.push_back(NumberColumn("ilvl", { 84, 12, 75, 86 }));
+    REQUIRE(table.SetColumns(std::move(columns), error));
+
+    table.Filter("RING");
+    CHECK_EQ(table.GetViewCount(), 2u);
+    CHECK_EQ(WindowHtml(table), "Doom Loop/Two-Stone Ring;/Coral Ring;");
+
+    // Numeric columns are not searched; a match cannot span two cells
+    table.Filter("84");
+    CHECK_EQ(table.GetViewCount(), 0u);
+    table.Filter("coilstygian");
+    CHECK_EQ(table.GetViewCount(), 0u);
+    table.Filter("Loop");
+    CHECK_EQ(table.GetViewCount(), 1u);
+
+    table.Filter("zzz");
+    CHECK_EQ(table.GetViewCount(), 0u);
+    CHECK_EQ(table.GetWindow(0, 10)["rows"], 0);
+}
+
+NX_TEST(FiltersFindTheLastRow) {
+    ResultTable table;
+    std::vector<std::string> names;
+    std::vector<double> levels;
+    for (int row = 0; row < 1000; row++) {
+        names.push_back("Item " + std::to_string(row));
+        levels.push_back(row);
+    }
+    names.back() = "Last Unique";
+    Fill(table, names, levels);
+
+    // The hit sits at the very end of the search text
+    table.Filter("unique");
+    REQUIRE(table.GetViewCount() == 1);
+    json window = table.GetWindow(0, 80);
+    CHECK_EQ(window["html"], "0:Last Unique(999);");
+
+    // Offsets index the filtered view
+    table.Filter("item 99");
+    CHECK_EQ(table.GetViewCount(), 10u);   // 99, 990 ... 998
+    window = table.GetWindow(9, 80);
+    CHECK_EQ(window["rows"], 1);
+    CHECK_EQ(window["html"], "9:Item 998(998);");
+    CHECK_EQ(table.GetWindow(10, 80)["rows"], 0);
+
+    // The first and last rows together
+    names.front() = "Unique First";
+    Fill(table, names, levels);
+    table.Filter("unique");
+    CHECK_EQ(WindowHtml(table), "0:Unique First(0);1:Last Unique(999);");
+    std::string error;
+    REQUIRE(table.Sort("ilvl", true, error));
+    CHECK_EQ(WindowHtml(table), "0:Last Unique(999);1:Unique First(0);");
+}
+
+// -----------------------------------------------------------------------------
+// Versions
+// -----------------------------------------------------------------------------
+
+NX_TEST(EveryChangeBumpsTheVersion) {
+    std::vector<std::pair<uint64_t, size_t>> changes;
+    ResultTable table;
+    table.SetChangeCallback([&changes](uint64_t version, size_t viewRows) {
+        changes.emplace_back(version, viewRows);
+    });
+    CHECK_EQ(table.GetVersion(), 0u);
+
+    Fill(table, { "a", "b", "ab" }, { 1, 2, 3 });
+    CHECK_EQ(table.GetVersion(), 1u);
+
+    std::string error;
+    REQUIRE(table.Sort("ilvl", true, error));
+    CHECK_EQ(table.GetVersion(), 2u);
+
+    table.Filter("a");
+    CHECK_EQ(table.GetVersion(), 3u);
+
+    // Repeating a sort or filter still counts, as pages re-request on it
+    table.Filter("a");
+    CHECK_EQ(table.GetVersion(), 4u);
+
+    // A refused sort or set of columns does not
+    CHECK(!table.Sort("price", false, error));
+    std::vector<ResultColumn> uneven;
+    uneven.push_back(TextColumn("name", { "a" }));
+    uneven.push_back(NumberColumn("ilvl", {}));
+    CHECK(!table.SetColumns(std::move(uneven), error));
+    CHECK_EQ(table.GetVersion(), 4u);
+
+    table.Clear();
+    CHECK_EQ(table.GetVersion(), 5u);
+
+    // Windows do not change the table
+    table.GetWindow(0, 10);
+    CHECK_EQ(table.GetVersion(), 5u);
+
+    std::vector<std::pair<uint64_t, size_t>> expected = { {1, 3}, {2, 3}, {3, 2}, {4, 2}, {5, 0} };
+    CHECK(changes == expected);
+}
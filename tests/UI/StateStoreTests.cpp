@@ -0,0 +1,276 @@
+#include "TestHarness.h"
+
+#include "UI/StateStore.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    // The one delta for a key in a TakeDeltas result, or null
+    json FindDelta(const json& deltas, const std::string& key) {
+        for (const json& delta : deltas) {
+            if (delta.at("key") == key) return delta;
+        }
+        return nullptr;
+    }
+
+    const json kSettings = {
+        {"general", { {"opacity", 90}, {"clickThrough", false}, {"currentGame", "poe1"} }},
+        {"modules", { {"price_check", true}, {"build_guide", true} }},
+        {"hotkeys", { {"1", "Alt+Shift+O"}, {"3", "Ctrl+D"} }}
+    };
+}
+
+NX_TEST(NestedChangesBecomePatchOps) {
+    StateStore store;
+    store.Set("settings", kSettings);
+    json snapshot = store.Subscribe({ "settings" });
+    CHECK_EQ(snapshot["settings"]["version"], 1);
+    CHECK_EQ(snapshot["settings"]["value"], kSettings);
+
+    CHECK(store.SetAt("settings", "/general/opacity", 75));
+    CHECK(store.SetAt("settings", "/modules/map_overlay", false));
+    json changed = store.Get("settings");
+    changed["hotkeys"].erase("3");
+    store.Set("settings", changed);
+
+    json deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    const json& delta = deltas[0];
+    CHECK_EQ(delta["key"], "settings");
+    CHECK_EQ(delta["from"], 1);
+    CHECK_EQ(delta["to"], 4);
+
+    // One op per touched member, each at its own path
+    const json& ops = delta["ops"];
+    CHECK_EQ(ops.size(), 3u);
+    CHECK(std::find(ops.begin(), ops.end(),
+                    json{ {"op", "replace"}, {"path", "/general/opacity"}, {"value", 75} }) != ops.end());
+    CHECK(std::find(ops.begin(), ops.end(),
+                    json{ {"op", "add"}, {"path", "/modules/map_overlay"}, {"value", false} }) != ops.end());
+    CHECK(std::find(ops.begin(), ops.end(), json{ {"op", "remove"}, {"path", "/hotkeys/3"} }) != ops.end());
+
+    // Applied to the snapshot they give the store's value
+    CHECK_EQ(snapshot["settings"]["value"].patch(ops), store.Get("settings"));
+    CHECK(store.TakeDeltas().empty());
+
+    StateStoreStats stats = store.GetStats();
+    CHECK_EQ(stats.sets, 4u);
+    CHECK_EQ(stats.changes, 4u);
+    CHECK_EQ(stats.deliveries, 1u);
+    CHECK_EQ(stats.deltas, 1u);
+    CHECK_EQ(stats.ops, 3u);
+}
+
+NX_TEST(EqualValuesAreNotChanges) {
+    int wakes = 0;
+    StateStore store([&wakes] {
+        wakes++;
+        return true;
+    });
+    store.Subscribe({ "settings" });
+    store.Set("settings", kSettings);
+    CHECK_EQ(wakes, 1);
+
+    // Further changes before the tick do not wake again
+    store.SetAt("settings", "/general/opacity", 80);
+    CHECK_EQ(wakes, 1);
+    CHECK_EQ(store.TakeDeltas().size(), 1u);
+
+    // Re-sending what the store holds is no change at all
+    store.Set("settings", store.Get("settings"));
+    CHECK_EQ(store.GetVersion("settings"), 2u);
+    CHECK_EQ(wakes, 1);
+    CHECK(store.TakeDeltaScript().empty());
+
+    StateStoreStats stats = store.GetStats();
+    CHECK_EQ(stats.sets, 3u);
+    CHECK_EQ(stats.changes, 2u);
+}
+
+NX_TEST(ChangesThatCancelOutSendNothing) {
+    StateStore store;
+    store.Set("settings", kSettings);
+    json page = store.Subscribe({ "settings" })["settings"];
+    CHECK_EQ(page["version"], 1);
+
+    // An opacity drag that ends where it started
+    store.SetAt("settings", "/general/opacity", 50);
+    store.SetAt("settings", "/general/opacity", 90);
+    CHECK_EQ(store.GetVersion("settings"), 3u);
+    CHECK(store.TakeDeltas().empty());
+    CHECK(store.TakeDeltaScript().empty());
+
+    // The page kept version 1, so the next delta starts from there
+    store.SetAt("settings", "/general/clickThrough", true);
+    json deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK_EQ(deltas[0]["from"], page["version"]);
+    CHECK_EQ(deltas[0]["to"], 4);
+    CHECK_EQ(page["value"].patch(deltas[0]["ops"]), store.Get("settings"));
+
+    // And the one after that starts where this one ended
+    store.SetAt("settings", "/general/opacity", 60);
+    deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK_EQ(deltas[0]["from"], 4);
+    CHECK_EQ(deltas[0]["to"], 5);
+    CHECK_EQ(store.GetStats().deltas, 2u);
+}
+
+NX_TEST(LargePatchesFallBackToAReplace) {
+    StateStore store;
+    store.Set("price_check", { {"loading", true} });
+    store.Subscribe({ "price_check" });
+
+    // Results replacing the loading placeholder: the patch (remove plus an
+    // add per member) is larger than the value
+    json results = {
+        {"name", "Doom Loop"}, {"baseType", "Two-Stone Ring"}, {"rarity", "Rare"},
+        {"itemLevel", "84"}, {"price", "5-10 chaos"}, {"confidence", "medium"}
+    };
+    store.Set("price_check", results);
+    json deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK_EQ(deltas[0]["ops"], json::array({ { {"op", "replace"}, {"path", ""}, {"value", results} } }));
+
+    // A price refresh is one small op, sent as a patch
+    store.SetAt("price_check", "/price", "6-9 chaos");
+    deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK_EQ(deltas[0]["ops"],
+             json::array({ { {"op", "replace"}, {"path", "/price"}, {"value", "6-9 chaos"} } }));
+
+    // An error replacing the results
+    store.Set("price_check", { {"error", "No item data found in clipboard"} });
+    deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK_EQ(deltas[0]["ops"].size(), 1u);
+    CHECK_EQ(deltas[0]["ops"][0]["path"], "");
+
+    // A single op is kept even when it is larger than the value
+    store.SetAt("price_check", "/error", "Failed to parse item data");
+    deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK(deltas[0]["ops"].dump().size() > store.Get("price_check").dump().size());
+    CHECK_EQ(deltas[0]["ops"],
+             json::array({ { {"op", "replace"}, {"path", "/error"}, {"value", "Failed to parse item data"} } }));
+}
+
+NX_TEST(SecondSubscriberKeepsThePendingDelta) {
+    StateStore store;
+    store.Set("settings", kSettings);
+    json first = store.Subscribe({ "settings" })["settings"];
+    store.SetAt("settings", "/general/opacity", 70);
+
+    // Another page subscribes before the tick: it gets the current value,
+    // and the delta the first page is waiting for still goes out
+    json second = store.Subscribe({ "settings" })["settings"];
+    CHECK_EQ(second["version"], 2);
+    CHECK_EQ(second["value"], store.Get("settings"));
+
+    json delta = FindDelta(store.TakeDeltas(), "settings");
+    REQUIRE(!delta.is_null());
+    CHECK_EQ(delta["from"], first["version"]);
+    CHECK_EQ(delta["to"], second["version"]);
+    CHECK_EQ(first["value"].patch(delta["ops"]), second["value"]);
+
+    // Both pages are now at the same version for the next one
+    store.SetAt("settings", "/general/opacity", 65);
+    delta = FindDelta(store.TakeDeltas(), "settings");
+    REQUIRE(!delta.is_null());
+    CHECK_EQ(delta["from"], 2);
+    CHECK_EQ(store.GetStats().snapshots, 2u);
+}
+
+NX_TEST(UnsubscribedKeysAreNotSent) {
+    int wakes = 0;
+    StateStore store([&wakes] {
+        wakes++;
+        return true;
+    });
+    store.Subscribe({ "settings" });
+    store.Set("price_check", { {"loading", true} });
+    CHECK_EQ(wakes, 0);
+    CHECK_EQ(store.GetVersion("price_check"), 1u);
+
+    store.Set("settings", kSettings);
+    json deltas = store.TakeDeltas();
+    CHECK_EQ(deltas.size(), 1u);
+    CHECK(FindDelta(deltas, "price_check").is_null());
+}
+
+NX_TEST(ResubscribingAfterAClearStartsOver) {
+    int wakes = 0;
+    StateStore store([&wakes] {
+        wakes++;
+        return true;
+    });
+    store.Set("settings", kSettings);
+    store.Subscribe({ "settings" });
+    store.SetAt("settings", "/general/opacity", 70);
+    CHECK_EQ(wakes, 1);
+
+    // The page went away with a delta pending; nothing is sent for it
+    store.ClearSubscriptions();
+    CHECK(store.TakeDeltas().empty());
+    store.SetAt("settings", "/general/opacity", 60);
+    CHECK_EQ(wakes, 1);
+    CHECK(store.TakeDeltas().empty());
+
+    // The new page's snapshot is the baseline for its deltas
+    json page = store.Subscribe({ "settings" })["settings"];
+    CHECK_EQ(page["version"], 3);
+    CHECK_EQ(page["value"]["general"]["opacity"], 60);
+    CHECK(store.TakeDeltas().empty());
+
+    store.SetAt("settings", "/general/opacity", 55);
+    CHECK_EQ(wakes, 2);
+    json deltas = store.TakeDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK_EQ(deltas[0]["from"], 3);
+    CHECK_EQ(deltas[0]["to"], 4);
+    CHECK_EQ(deltas[0]["ops"].size(), 1u);
+    CHECK_EQ(page["value"].patch(deltas[0]["ops"]), store.Get("settings"));
+}
+
+NX_TEST(BadPointersAreRefused) {
+    StateStore store;
+    store.Set("settings", kSettings);
+    CHECK(!store.SetAt("settings", "general/opacity", 1));
+    CHECK(!store.SetAt("settings", "/general/opacity/value", 1));
+    CHECK_EQ(store.Get("settings"), kSettings);
+    CHECK_EQ(store.GetVersion("settings"), 1u);
+
+    // Missing objects along the way are created
+    CHECK(store.SetAt("overlay", "/window/bounds/width", 640));
+    CHECK_EQ(store.Get("overlay"), (json{ {"window", { {"bounds", { {"width", 640} }} }} }));
+
+    store.Remove("overlay");
+    CHECK(store.Get("overlay").is_null());
+    CHECK_EQ(store.GetVersion("overlay"), 2u);
+}
+
+NX_TEST(DeltaScriptsPostTheDeltas) {
+    StateStore store;
+    store.Subscribe({ "price_check" });
+    store.Set("price_check", { {"loading", true} });
+
+    const std::string prefix = "window.postMessage({nexileState:";
+    const std::string suffix = "},'*');";
+    std::string script = store.TakeDeltaScript();
+    REQUIRE(script.compare(0, prefix.size(), prefix) == 0);
+    REQUIRE(script.size() > prefix.size() + suffix.size());
+    REQUIRE(script.compare(script.size() - suffix.size(), suffix.size(), suffix) == 0);
+
+    std::string payload = script.substr(prefix.size(), script.size() - prefix.size() - suffix.size());
+    json deltas = json::parse(payload);
+    REQUIRE(deltas.size() == 1);
+    CHECK_EQ(deltas[0]["from"], 0);
+    CHECK_EQ(deltas[0]["to"], 1);
+    CHECK_EQ(store.GetStats().deltaBytes, payload.size());
+}
@@ -0,0 +1,458 @@
+#include "TestHarness.h"
+
+#include "Utils/Transcoder.h"
+
+#include <random>
+#include <string>
+
+using namespace Nexile;
+
+namespace {
+    const char* const kKernels[] = { "scalar", "sse2", "avx2" };
+
+    // Selects each kernel set this machine has in turn, then goes back to auto
+    template <typename F>
+    void ForEachKernel(F&& f) {
+        for (const char* kernel : kKernels) {
+            if (Transcoder::SelectKernel(kernel)) {
+                f(kernel);
+            }
+        }
+        Transcoder::SelectKernel("auto");
+    }
+
+    const size_t kNoError = static_cast<size_t>(-1);
+
+    struct Decoded8 {
+        std::u16string text;        // With U+FFFD per maximal invalid subpart
+        size_t firstError = kNoError;
+    };
+
+    struct Decoded16 {
+        std::string text;
+        size_t firstError = kNoError;
+    };
+
+    // Reference UTF-8 decoder straight from the well-formed byte sequence
+    // table of the Unicode standard (Table 3-7), one byte at a time
+    Decoded8 ReferenceUtf8(const std::string& input) {
+        Decoded8 decoded;
+        size_t i = 0;
+        while (i < input.size()) {
+            uint8_t lead = static_cast<uint8_t>(input[i]);
+            size_t need = 0;
+            uint8_t low = 0x80, high = 0xBF;
+            uint32_t codePoint = 0;
+            if (lead < 0x80) {
+                decoded.text += static_cast<char16_t>(lead);
+                i++;
+                continue;
+            } else if (lead >= 0xC2 && lead <= 0xDF) {
+                need = 1;
+                codePoint = lead & 0x1F;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                need = 2;
+                codePoint = lead & 0x0F;
+                if (lead == 0xE0) low = 0xA0;
+                if (lead == 0xED) high = 0x9F;
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                need = 3;
+                codePoint = lead & 0x07;
+                if (lead == 0xF0) low = 0x90;
+                if (lead == 0xF4) high = 0x8F;
+            }
+
+            size_t taken = 1;
+            while (need > 0 && taken <= need && i + taken < input.size()) {
+                uint8_t byte = static_cast<uint8_t>(input[i + taken]);
+                if (byte < (taken == 1 ? low : 0x80) || byte > (taken == 1 ? high : 0xBF)) break;
+                codePoint = (codePoint << 6) | (byte & 0x3F);
+                taken++;
+            }
+
+            if (need == 0 || taken <= need) {
+                if (decoded.firstError == kNoError) decoded.firstError = i;
+                decoded.text += Transcoder::kReplacement;
+            } else if (codePoint >= 0x10000) {
+                decoded.text += static_cast<char16_t>(0xD800 + ((codePoint - 0x10000) >> 10));
+                decoded.text += static_cast<char16_t>(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+            } else {
+                decoded.text += static_cast<char16_t>(codePoint);
+            }
+            i += taken;
+        }
+        return decoded;
+    }
+
+    void EncodeUtf8(uint32_t codePoint, std::string& out) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    // Reference UTF-16 decoder: U+FFFD for each unpaired surrogate
+    Decoded16 ReferenceUtf16(const std::u16string& input) {
+        Decoded16 decoded;
+        for (size_t i = 0; i < input.size(); i++) {
+            uint32_t unit = input[i];
+            if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < input.size() &&
+                input[i + 1] >= 0xDC00 && input[i + 1] <= 0xDFFF) {
+                EncodeUtf8(0x10000 + ((unit - 0xD800) << 10) + (input[i + 1] - 0xDC00u), decoded.text);
+                i++;
+            } else if (unit >= 0xD800 && unit <= 0xDFFF) {
+                if (decoded.firstError == kNoError) decoded.firstError = i;
+                EncodeUtf8(Transcoder::kReplacement, decoded.text);
+            } else {
+                EncodeUtf8(unit, decoded.text);
+            }
+        }
+        return decoded;
+    }
+
+    std::u16string Replacements(size_t count) {
+        return std::u16string(count, Transcoder::kReplacement);
+    }
+
+    // Compares every UTF-8 entry point with the reference; returns a description of the first difference
+    std::string CheckUtf8(const std::string& input) {
+        Decoded8 expected = ReferenceUtf8(input);
+        bool valid = expected.firstError == kNoError;
+        size_t position = valid ? input.size() : expected.firstError;
+
+        TranscodeResult validated = Transcoder::ValidateUtf8(input.data(), input.size());
+        if (validated.Ok() != valid || validated.position != position) return "ValidateUtf8";
+
+        std::u16string strict(input.size() + 1, u'\0');
+        TranscodeResult converted = Transcoder::Utf8ToUtf16(input.data(), input.size(), &strict[0]);
+        if (converted.Ok() != valid || converted.position != position) return "Utf8ToUtf16 result";
+        if (valid) {
+            if (Transcoder::Utf16LengthOfUtf8(input.data(), input.size()) != expected.text.size()) return "Utf16LengthOfUtf8";
+            if (strict.compare(0, converted.written, expected.text) != 0) return "Utf8ToUtf16 output";
+        } else if (converted.status != validated.status) {
+            return "Utf8ToUtf16 status";
+        }
+
+        std::u16string appended = u"prefix";
+        if (Transcoder::AppendUtf16(input, appended) != valid) return "AppendUtf16 result";
+        if (appended != u"prefix" + expected.text) return "AppendUtf16 output";
+        return "";
+    }
+
+    std::string CheckUtf16(const std::u16string& input) {
+        Decoded16 expected = ReferenceUtf16(input);
+        bool valid = expected.firstError == kNoError;
+        size_t position = valid ? input.size() : expected.firstError;
+
+        TranscodeResult validated = Transcoder::ValidateUtf16(input.data(), input.size());
+        if (validated.Ok() != valid || validated.position != position) return "ValidateUtf16";
+
+        std::string strict(input.size() * 3 + 1, '\0');
+        TranscodeResult converted = Transcoder::Utf16ToUtf8(input.data(), input.size(), &strict[0]);
+        if (converted.Ok() != valid || converted.position != position) return "Utf16ToUtf8 result";
+        if (valid) {
+            if (Transcoder::Utf8LengthOfUtf16(input.data(), input.size()) != expected.text.size()) return "Utf8LengthOfUtf16";
+            if (strict.compare(0, converted.written, expected.text) != 0) return "Utf16ToUtf8 output";
+        }
+
+        std::string appended = "prefix";
+        if (Transcoder::AppendUtf8(input.data(), input.size(), appended) != valid) return "AppendUtf8 result";
+        if (appended != "prefix" + expected.text) return "AppendUtf8 output";
+        return "";
+    }
+
+    std::string Hex(const std::string& bytes) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        for (char c : bytes) {
+            hex += digits[static_cast<uint8_t>(c) >> 4];
+            hex += digits[static_cast<uint8_t>(c) & 15];
+            hex += ' ';
+        }
+        return hex;
+    }
+
+    // Random UTF-8 built from ASCII runs long enough for the vector loops,
+    // valid characters of every length, and broken sequences
+    std::string RandomUtf8(std::mt19937& rng) {
+        static const char* const broken[] = {
+            "\x80", "\xBF", "\xC0\xAF", "\xC1\xBF", "\xC3", "\xE2\x82", "\xE0\x80\x80", "\xE0\x9F\xBF",
+            "\xED\xA0\x80", "\xED\xBF\xBF", "\xF0\x8F\xBF\xBF", "\xF0\x9F\x98", "\xF4\x90\x80\x80",
+            "\xF5\x80\x80\x80", "\xF8", "\xFE", "\xFF", "\xC3\xA9\xA9",
+        };
+        std::string text;
+        int pieces = 1 + static_cast<int>(rng() % 12);
+        for (int p = 0; p < pieces; p++) {
+            switch (rng() % 6) {
+            case 0:
+            case 1:
+                text.append(rng() % 80, static_cast<char>('a' + rng() % 26));
+                break;
+            case 2:
+                EncodeUtf8(0x80 + rng() % 0x780, text);
+                break;
+            case 3: {
+                uint32_t codePoint = 0x800 + rng() % 0xF800;
+                EncodeUtf8(codePoint >= 0xD800 && codePoint <= 0xDFFF ? codePoint + 0x800 : codePoint, text);
+                break;
+            }
+            case 4:
+                EncodeUtf8(0x10000 + rng() % 0x100000, text);
+                break;
+            default:
+                if (rng() % 4 == 0) {
+                    text += static_cast<char>(rng());
+                } else {
+                    text += broken[rng() % (sizeof(broken) / sizeof(broken[0]))];
+                }
+                break;
+            }
+        }
+        return text;
+    }
+
+    std::u16string RandomUtf16(std::mt19937& rng) {
+        std::u16string text;
+        int pieces = 1 + static_cast<int>(rng() % 12);
+        for (int p = 0; p < pieces; p++) {
+            switch (rng() % 5) {
+            case 0:
+            case 1:
+                text.append(rng() % 80, static_cast<char16_t>('a' + rng() % 26));
+                break;
+            case 2: {
+                char16_t unit = static_cast<char16_t>(0x80 + rng() % 0xFF80);
+                text += (unit >= 0xD800 && unit <= 0xDFFF) ? u'\x20AC' : unit;
+                break;
+            }
+            case 3:
+                text += static_cast<char16_t>(0xD800 + rng() % 0x400);
+                text += static_cast<char16_t>(0xDC00 + rng() % 0x400);
+                break;
+            default:
+                text += static_cast<char16_t>(0xD800 + rng() % 0x800);
+                break;
+            }
+        }
+        return text;
+    }
+
+    struct Utf8Case {
+        const char* name;
+        std::string input;
+        TranscodeStatus status;
+        size_t position;
+        std::u16string replaced;
+    };
+
+    struct Utf16Case {
+        const char* name;
+        std::u16string input;
+        size_t position;
+        std::string replaced;
+    };
+}
+
+// -----------------------------------------------------------------------------
+// Hand-written sequences
+// -----------------------------------------------------------------------------
+
+NX_TEST(BoundaryCharactersConvert) {
+    const Utf8Case cases[] = {
+        { "empty", "", TranscodeStatus::Ok, 0, u"" },
+        { "U+0080", "\xC2\x80", TranscodeStatus::Ok, 2, u"\x0080" },
+        { "U+07FF", "\xDF\xBF", TranscodeStatus::Ok, 2, u"\x07FF" },
+        { "U+0800", "\xE0\xA0\x80", TranscodeStatus::Ok, 3, u"\x0800" },
+        { "U+D7FF", "\xED\x9F\xBF", TranscodeStatus::Ok, 3, u"\xD7FF" },
+        { "U+E000", "\xEE\x80\x80", TranscodeStatus::Ok, 3, u"\xE000" },
+        { "U+FFFF", "\xEF\xBF\xBF", TranscodeStatus::Ok, 3, u"\xFFFF" },
+        { "U+10000", "\xF0\x90\x80\x80", TranscodeStatus::Ok, 4, u"\xD800\xDC00" },
+        { "U+10FFFF", "\xF4\x8F\xBF\xBF", TranscodeStatus::Ok, 4, u"\xDBFF\xDFFF" },
+        { "mixed", "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80z", TranscodeStatus::Ok, 11, u"a\x00E9\x20AC\xD83D\xDE00z" },
+    };
+
+    ForEachKernel([&](const char* kernel) {
+        for (const Utf8Case& c : cases) {
+            std::string failure = CheckUtf8(c.input);
+            if (!failure.empty()) Test::Fail(__FILE__, __LINE__, std::string(kernel) + " " + c.name + ": " + failure);
+
+            std::u16string converted;
+            CHECK(Transcoder::AppendUtf16(c.input, converted));
+            CHECK(converted == c.replaced);
+            std::string back;
+            CHECK(Transcoder::AppendUtf8(converted.data(), converted.size(), back));
+            CHECK(back == c.input);
+        }
+    });
+}
+
+NX_TEST(InvalidUtf8IsRejectedAndReplaced) {
+    const Utf8Case cases[] = {
+        // Overlong forms
+        { "overlong 2-byte", "\xC0\xAF", TranscodeStatus::Overlong, 0, Replacements(2) },
+        { "overlong C1", "ab\xC1\xBF", TranscodeStatus::Overlong, 2, u"ab" + Replacements(2) },
+        { "overlong 3-byte", "a\xE0\x80\xAF", TranscodeStatus::Overlong, 1, u"a" + Replacements(3) },
+        { "overlong 3-byte max", "\xE0\x9F\xBF", TranscodeStatus::Overlong, 0, Replacements(3) },
+        { "overlong 4-byte", "\xF0\x8F\xBF\xBF", TranscodeStatus::Overlong, 0, Replacements(4) },
+        // Surrogates encoded as UTF-8, alone and as a CESU-8 pair
+        { "high surrogate", "\xED\xA0\x80", TranscodeStatus::Surrogate, 0, Replacements(3) },
+        { "low surrogate", "x\xED\xBF\xBFy", TranscodeStatus::Surrogate, 1, u"x" + Replacements(3) + u"y" },
+        { "surrogate pair", "\xED\xA0\xBD\xED\xB8\x80", TranscodeStatus::Surrogate, 0, Replacements(6) },
+        // Beyond U+10FFFF and bytes that never appear
+        { "above U+10FFFF", "\xF4\x90\x80\x80", TranscodeStatus::TooLarge, 0, Replacements(4) },
+        { "F5 lead", "\xF5\x80\x80\x80", TranscodeStatus::TooLarge, 0, Replacements(4) },
+        { "F8", "\xF8\x88\x80\x80\x80", TranscodeStatus::InvalidByte, 0, Replacements(5) },
+        { "FF", "ok\xFF", TranscodeStatus::InvalidByte, 2, u"ok" + Replacements(1) },
+        // Truncation at the end of the input
+        { "truncated 2-byte", "ab\xC3", TranscodeStatus::Truncated, 2, u"ab" + Replacements(1) },
+        { "truncated 3-byte", "\xE2\x82", TranscodeStatus::Truncated, 0, Replacements(1) },
+        { "truncated 4-byte", "x\xF0\x9F\x98", TranscodeStatus::Truncated, 1, u"x" + Replacements(1) },
+        // A lead byte followed by something other than a continuation
+        { "missing 2nd byte", "\xC3z", TranscodeStatus::MissingContinuation, 0, Replacements(1) + u"z" },
+        { "missing 3rd byte", "\xE2\x82z", TranscodeStatus::MissingContinuation, 0, Replacements(1) + u"z" },
+        { "lead after lead", "\xE2\xC3\xA9", TranscodeStatus::MissingContinuation, 0, Replacements(1) + u"\x00E9" },
+        // Continuation bytes with no lead
+        { "lone continuation", "a\x80" "b", TranscodeStatus::UnexpectedContinuation, 1, u"a" + Replacements(1) + u"b" },
+        { "continuation run", "\x80\xBF\x80", TranscodeStatus::UnexpectedContinuation, 0, Replacements(3) },
+        { "extra continuation", "\xC3\xA9\xA9", TranscodeStatus::UnexpectedContinuation, 2, u"\x00E9" + Replacements(1) },
+        // Errors after runs long enough for the vector loops
+        { "after ASCII run", std::string(40, 'a') + "\xFF" + std::string(40, 'b'), TranscodeStatus::InvalidByte, 40,
+          std::u16string(40, u'a') + Replacements(1) + std::u16string(40, u'b') },
+        { "after long ASCII run", std::string(1000, 'a') + "\xE2\x82", TranscodeStatus::Truncated, 1000,
+          std::u16string(1000, u'a') + Replacements(1) },
+    };
+
+    ForEachKernel([&](const char* kernel) {
+        for (const Utf8Case& c : cases) {
+            std::string prefix = std::string(kernel) + " " + c.name + ": ";
+
+            TranscodeResult result = Transcoder::ValidateUtf8(c.input.data(), c.input.size());
+            if (result.status != c.status || result.position != c.position) {
+                Test::Fail(__FILE__, __LINE__, prefix + "status " + std::to_string(static_cast<int>(result.status)) +
+                                               " at " + std::to_string(result.position));
+            }
+
+            std::u16string replaced;
+            CHECK(!Transcoder::AppendUtf16(c.input, replaced));
+            if (replaced != c.replaced) Test::Fail(__FILE__, __LINE__, prefix + "replacement");
+
+            // The reference decoder agrees with the table
+            if (ReferenceUtf8(c.input).text != c.replaced) Test::Fail(__FILE__, __LINE__, prefix + "reference");
+            std::string failure = CheckUtf8(c.input);
+            if (!failure.empty()) Test::Fail(__FILE__, __LINE__, prefix + failure);
+        }
+    });
+}
+
+NX_TEST(UnpairedUtf16SurrogatesAreRejectedAndReplaced) {
+    const std::string replacement = "\xEF\xBF\xBD";
+    const Utf16Case cases[] = {
+        { "high at end", u"ab\xD800", 2, "ab" + replacement },
+        { "low alone", u"\xDC00x", 0, replacement + "x" },
+        { "high then high pair", u"\xD800\xD800\xDC00", 0, replacement + "\xF0\x90\x80\x80" },
+        { "reversed pair", u"\xDC00\xD800", 0, replacement + replacement },
+        { "high then ASCII", u"\xDBFFz", 0, replacement + "z" },
+        { "after ASCII run", std::u16string(40, u'a') + u"\xDFFF" + std::u16string(40, u'b'), 40,
+          std::string(40, 'a') + replacement + std::string(40, 'b') },
+    };
+
+    ForEachKernel([&](const char* kernel) {
+        for (const Utf16Case& c : cases) {
+            std::string prefix = std::string(kernel) + " " + c.name + ": ";
+
+            TranscodeResult result = Transcoder::ValidateUtf16(c.input.data(), c.input.size());
+            if (result.status != TranscodeStatus::UnpairedSurrogate || result.position != c.position) {
+                Test::Fail(__FILE__, __LINE__, prefix + "position " + std::to_string(result.position));
+            }
+
+            std::string replaced;
+            CHECK(!Transcoder::AppendUtf8(c.input.data(), c.input.size(), replaced));
+            if (replaced != c.replaced) Test::Fail(__FILE__, __LINE__, prefix + "replacement");
+
+            std::string failure = CheckUtf16(c.input);
+            if (!failure.empty()) Test::Fail(__FILE__, __LINE__, prefix + failure);
+        }
+
+        // A valid pair is one character
+        std::u16string pair = u"\xD83D\xDE00";
+        std::string encoded;
+        CHECK(Transcoder::AppendUtf8(pair.data(), pair.size(), encoded));
+        CHECK(encoded == "\xF0\x9F\x98\x80");
+    });
+}
+
+// -----------------------------------------------------------------------------
+// Fuzzing against the reference decoders
+// -----------------------------------------------------------------------------
+
+NX_TEST(RandomUtf8MatchesTheReference) {
+    ForEachKernel([&](const char* kernel) {
+        std::mt19937 rng(42);
+        int failures = 0;
+        for (int i = 0; i < 20000 && failures < 5; i++) {
+            std::string input = RandomUtf8(rng);
+            std::string failure = CheckUtf8(input);
+            if (!failure.empty()) {
+                Test::Fail(__FILE__, __LINE__, std::string(kernel) + " " + failure + " for " + Hex(input));
+                failures++;
+            }
+        }
+    });
+}
+
+NX_TEST(RandomUtf16MatchesTheReference) {
+    ForEachKernel([&](const char* kernel) {
+        std::mt19937 rng(7);
+        int failures = 0;
+        for (int i = 0; i < 20000 && failures < 5; i++) {
+            std::u16string input = RandomUtf16(rng);
+            std::string failure = CheckUtf16(input);
+            if (!failure.empty()) {
+                Test::Fail(__FILE__, __LINE__, std::string(kernel) + " " + failure + " at case " + std::to_string(i));
+                failures++;
+            }
+        }
+    });
+}
+
+NX_TEST(LongBuffersRoundTrip) {
+    // Long enough for the vector length counters to be flushed several times
+    std::string text;
+    for (int i = 0; i < 300000; i++) {
+        text += (i % 7 == 0) ? "\xE2\x82\xAC" : (i % 11 == 0) ? "\xF0\x9F\x98\x80" : "a";
+    }
+    std::string ascii(1 << 20, 'x');
+
+    ForEachKernel([&](const char* kernel) {
+        for (const std::string* input : { &text, &ascii }) {
+            std::u16string wide;
+            CHECK(Transcoder::AppendUtf16(*input, wide));
+            CHECK_EQ(Transcoder::Utf16LengthOfUtf8(input->data(), input->size()), wide.size());
+            CHECK(wide == ReferenceUtf8(*input).text);
+
+            std::string back;
+            CHECK(Transcoder::AppendUtf8(wide.data(), wide.size(), back));
+            CHECK_EQ(Transcoder::Utf8LengthOfUtf16(wide.data(), wide.size()), input->size());
+            if (back != *input) Test::Fail(__FILE__, __LINE__, std::string(kernel) + ": round trip differs");
+        }
+    });
+}
+
+NX_TEST(KernelsCanBeSelected) {
+    CHECK(Transcoder::SelectKernel("scalar"));
+    CHECK_EQ(std::string(Transcoder::GetKernelName()), "scalar");
+    CHECK(!Transcoder::SelectKernel("neon-or-nothing"));
+    CHECK_EQ(std::string(Transcoder::GetKernelName()), "scalar");
+    CHECK(Transcoder::SelectKernel("auto"));
+}
@@ -0,0 +1,227 @@
+// Web message dispatch benchmark
+//
+//   action_bench [message count]
+//
+// Dispatches a set of varied web messages (1000 by default) for the 23
+// actions the app and the built-in modules register. It compares the router
+// with the broadcast it replaced: every module callback parsing the message in
+// full and walking its own if/else chain of action names. It also times the
+// router's action scan and lookup alone, messages for unregistered actions,
+// and building the lookup table for 23 and 5000 actions. Every dispatch path
+// must run the same handlers.
+//
+// Router handlers read the payload only for the 7 actions whose module
+// handlers do (show_module, save_settings, ...); the others never build a
+// json tree. The dispatch is timed again with every handler reading it,
+// which is the most the router can cost.
+
+#include "Bench.h"
+
+#include "UI/ActionRouter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    const char* const kActions[] = {
+        // app
+        "toggle_overlay", "open_settings", "open_browser", "show_module", "close_browser", "module_closed",
+        // settings
+        "get_settings", "save_settings", "cancel_settings", "reset_settings",
+        "hotkey_recording_start", "hotkey_recording_stop", "hotkey_update",
+        // build_guide
+        "build_guide_get", "build_guide_import", "build_guide_toggle",
+        // map_overlay
+        "map_overlay_get", "map_overlay_reload",
+        // stash_search
+        "stash_search_get", "stash_search_query", "stash_search_reload",
+        // bulk_exchange
+        "bulk_exchange_refresh", "bulk_exchange_get_results",
+    };
+    const size_t kActionCount = sizeof(kActions) / sizeof(kActions[0]);
+
+    // Actions whose handlers in the app read the payload
+    bool ReadsPayload(const std::string& action) {
+        return action == "show_module" || action == "save_settings" || action == "hotkey_recording_start" ||
+               action == "hotkey_update" || action == "build_guide_import" || action == "build_guide_toggle" ||
+               action == "stash_search_query";
+    }
+
+    // First action of each owner in kActions, then the end
+    const size_t kOwnerStart[] = { 0, 6, 13, 16, 18, 21, 23 };
+    const char* const kOwners[] = { "app", "settings", "build_guide", "map_overlay", "stash_search", "bulk_exchange" };
+    const size_t kOwnerCount = sizeof(kOwners) / sizeof(kOwners[0]);
+
+    double NanosecondsPerMessage(const Bench::Timing& timing, size_t messages) {
+        return timing.median * 1000.0 / static_cast<double>(messages);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: action_bench [message count]\n");
+        return 0;
+    }
+    size_t messageCount = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 1000;
+    if (messageCount == 0) {
+        printf("message count must be positive\n");
+        return 1;
+    }
+
+    std::mt19937 rng(1);
+    std::vector<std::string> messages;
+    std::vector<uint64_t> expected(kActionCount, 0);
+    for (size_t i = 0; i < messageCount; i++) {
+        size_t action = rng() % kActionCount;
+        expected[action]++;
+        json message = {
+            {"action", kActions[action]},
+            {"query", "mod:life>=80 AND rarity:rare"},
+            {"hotkeyId", static_cast<int>(rng() % 8)},
+            {"settings", {{"general", {{"opacity", 80}}}}}
+        };
+        messages.push_back(message.dump());
+    }
+
+    // Handlers count what they were given, so every path can be checked
+    std::vector<uint64_t> routed(kActionCount, 0);
+    std::vector<uint64_t> routedAll(kActionCount, 0);
+    ActionRouter router;
+    ActionRouter readsAll;
+    for (size_t owner = 0; owner < kOwnerCount; owner++) {
+        for (size_t action = kOwnerStart[owner]; action < kOwnerStart[owner + 1]; action++) {
+            bool reads = ReadsPayload(kActions[action]);
+            router.Register(kOwners[owner], kActions[action], [&routed, action, reads](const ActionMessage& message) {
+                routed[action]++;
+                Bench::Consume(reads ? message.Json().size() : message.Text().size());
+            });
+            readsAll.Register(kOwners[owner], kActions[action], [&routedAll, action](const ActionMessage& message) {
+                routedAll[action]++;
+                Bench::Consume(message.Json().size());
+            });
+        }
+    }
+
+    std::vector<uint64_t> broadcast(kActionCount, 0);
+    auto moduleCallback = [&broadcast](const std::string& text, size_t owner) {
+        json message = json::parse(text, nullptr, false);
+        std::string action = message.is_object() ? message.value("action", "") : "";
+        for (size_t i = kOwnerStart[owner]; i < kOwnerStart[owner + 1]; i++) {
+            if (action == kActions[i]) {
+                broadcast[i]++;
+                Bench::Consume(message.size());
+                return;
+            }
+        }
+    };
+
+    const int runs = 20;
+    Bench::Timing old = Bench::Measure(runs, [&] {
+        for (const std::string& message : messages) {
+            for (size_t owner = 0; owner < kOwnerCount; owner++) {
+                moduleCallback(message, owner);
+            }
+        }
+    });
+
+    std::vector<uint64_t> chained(kActionCount, 0);
+    Bench::Timing chain = Bench::Measure(runs, [&] {
+        for (const std::string& text : messages) {
+            json message = json::parse(text, nullptr, false);
+            std::string action = message.is_object() ? message.value("action", "") : "";
+            for (size_t i = 0; i < kActionCount; i++) {
+                if (action == kActions[i]) {
+                    chained[i]++;
+                    Bench::Consume(message.size());
+                    break;
+                }
+            }
+        }
+    });
+
+    size_t failures = 0;
+    Bench::Timing dispatch = Bench::Measure(runs, [&] {
+        std::string error;
+        for (const std::string& message : messages) {
+            failures += !router.Dispatch(message, error);
+        }
+    });
+
+    Bench::Timing dispatchAll = Bench::Measure(runs, [&] {
+        std::string error;
+        for (const std::string& message : messages) {
+            failures += !readsAll.Dispatch(message, error);
+        }
+    });
+
+    size_t found = 0;
+    Bench::Timing lookup = Bench::Measure(runs, [&] {
+        for (const std::string& message : messages) {
+            std::string_view action;
+            bool present = false;
+            if (ActionRouter::FindAction(message, action, present) && present) {
+                found += router.HasAction(std::string(action));
+            }
+        }
+    });
+
+    std::vector<std::string> unregistered;
+    for (size_t i = 0; i < messageCount; i++) {
+        unregistered.push_back(json{{"action", "overlay_ready"}, {"query", std::to_string(i)}}.dump());
+    }
+    size_t unhandled = 0;
+    Bench::Timing unknown = Bench::Measure(runs, [&] {
+        std::string error;
+        for (const std::string& message : unregistered) {
+            unhandled += !router.Dispatch(message, error) && error.empty();
+        }
+    });
+
+    std::vector<std::string> manyActions;
+    for (int i = 0; i < 5000; i++) manyActions.push_back("action_" + std::to_string(i));
+    ActionRouter large;
+    for (const std::string& action : manyActions) large.Register("bench", action, [](const ActionMessage&) {});
+    size_t largeFound = 0;
+    for (const std::string& action : manyActions) largeFound += large.HasAction(action);
+
+    ActionRouterStats stats = router.GetRouterStats();
+    ActionRouterStats largeStats = large.GetRouterStats();
+    printf("%zu messages for %zu actions, ns per message (median of %d runs)\n", messageCount, kActionCount, runs);
+    printf("  broadcast to %zu callbacks, %zu parses  %9.0f\n", kOwnerCount, kOwnerCount,
+           NanosecondsPerMessage(old, messageCount));
+    printf("  one parse + if/else chain           %9.0f\n", NanosecondsPerMessage(chain, messageCount));
+    printf("  router dispatch                     %9.0f (%.1fx faster than the broadcast, %.1fx than the chain;"
+           " %llu of %zu parsed)\n",
+           NanosecondsPerMessage(dispatch, messageCount), old.median / dispatch.median, chain.median / dispatch.median,
+           static_cast<unsigned long long>(stats.parses / (runs + 1)), messageCount);
+    printf("  router dispatch, every handler parses %7.0f\n", NanosecondsPerMessage(dispatchAll, messageCount));
+    printf("  router action scan + lookup         %9.0f\n", NanosecondsPerMessage(lookup, messageCount));
+    printf("  router unregistered action          %9.0f\n", NanosecondsPerMessage(unknown, messageCount));
+    printf("lookup table: %zu slots for %zu actions built in %.3f ms; %zu slots for 5000 in %.3f ms\n",
+           stats.tableSize, stats.actions, stats.lastBuildMs, largeStats.tableSize, largeStats.lastBuildMs);
+
+    // Each path ran 1 + runs times (Measure warms up once)
+    bool ok = true;
+    for (size_t i = 0; i < kActionCount; i++) {
+        uint64_t want = expected[i] * (runs + 1);
+        if (routed[i] != want || routedAll[i] != want || broadcast[i] != want || chained[i] != want) {
+            printf("MISMATCH: %s ran %llu times routed, %llu broadcast, %llu chained; expected %llu\n", kActions[i],
+                   static_cast<unsigned long long>(routed[i]), static_cast<unsigned long long>(broadcast[i]),
+                   static_cast<unsigned long long>(chained[i]), static_cast<unsigned long long>(want));
+            ok = false;
+        }
+    }
+    if (failures != 0 || found != messageCount * (runs + 1) || unhandled != messageCount * (runs + 1) ||
+        largeFound != manyActions.size() || large.HasAction("action_5000")) {
+        printf("MISMATCH: %zu failed dispatches, %zu found, %zu unhandled, %zu of 5000 large-table lookups\n",
+               failures, found, unhandled, largeFound);
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
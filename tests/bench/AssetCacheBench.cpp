@@ -0,0 +1,195 @@
+// nexile:// page serving benchmark
+//
+//   asset_bench [HTML directory]
+//
+// Serves every page of an HTML directory (a generated one shaped like the
+// overlay's by default) the way the resource handler does: look the file
+// up, then hand it to CEF in 64 KiB reads. Compares the old handler path,
+// FileExists plus a line-by-line ReadTextFile into the handler context,
+// with AssetCache::Get and an AssetResponse, on a cold cache and a warm
+// one. Reports time to the first byte and to the whole body per request.
+// Every path must send the same bytes.
+
+#include "Bench.h"
+
+#include "UI/AssetCache.h"
+#include "UI/AssetResponse.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+namespace fs = std::filesystem;
+
+namespace {
+    const size_t kReadSize = 64 * 1024;
+
+    // The old Utils::FileExists and Utils::ReadTextFile
+    bool FileExists(const std::string& path) {
+        return fs::exists(path) && fs::is_regular_file(path);
+    }
+
+    std::string ReadTextFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return "";
+        }
+
+        std::string content;
+        std::string line;
+        while (std::getline(file, line)) {
+            content += line + "\n";
+        }
+        return content;
+    }
+
+    // Pages of roughly the overlay's sizes, markup with short lines
+    void GenerateDirectory(const fs::path& root) {
+        struct Page {
+            const char* name;
+            size_t size;
+        };
+        const Page pages[] = {
+            { "main_overlay.html", 14 * 1024 }, { "settings.html", 48 * 1024 },
+            { "trade_search.html", 120 * 1024 }, { "js/overlay.js", 300 * 1024 }, { "css/overlay.css", 24 * 1024 },
+        };
+        fs::create_directories(root / "js");
+        fs::create_directories(root / "css");
+        for (const Page& page : pages) {
+            std::ofstream file(root / page.name, std::ios::binary);
+            size_t written = 0;
+            for (int row = 0; written < page.size; row++) {
+                std::string line = "    <div class=\"row\" data-id=\"" + std::to_string(row) + "\"><span>Item " +
+                    std::to_string(row * 37) + "</span></div>\n";
+                file << line;
+                written += line.size();
+            }
+        }
+    }
+
+    // First read and whole body of one request
+    struct Sent {
+        size_t first = 0;
+        std::string body;
+    };
+
+    void SendOld(const fs::path& root, const std::string& name, std::vector<char>& buffer, Sent* sent) {
+        std::string path = (root / name).string();
+        std::string data = FileExists(path) ? ReadTextFile(path) : "<html><body><h1>404 Not Found</h1></body></html>";
+        for (size_t offset = 0; offset < data.size(); offset += kReadSize) {
+            size_t size = std::min(kReadSize, data.size() - offset);
+            memcpy(buffer.data(), data.data() + offset, size);
+            Bench::Consume(size);
+            if (sent) sent->body.append(buffer.data(), size);
+        }
+    }
+
+    void SendCached(AssetCache& cache, const std::string& name, std::vector<char>& buffer, Sent* sent) {
+        AssetResponse response;
+        response.Begin(cache.Get(name), "", "");
+        while (size_t size = response.Read(buffer.data(), buffer.size())) {
+            Bench::Consume(size);
+            if (sent) sent->body.append(buffer.data(), size);
+        }
+    }
+
+    // Time from the request to the first read
+    double FirstByteOld(const fs::path& root, const std::string& name, std::vector<char>& buffer) {
+        auto start = Bench::Clock::now();
+        std::string path = (root / name).string();
+        std::string data = FileExists(path) ? ReadTextFile(path) : "";
+        memcpy(buffer.data(), data.data(), std::min(kReadSize, data.size()));
+        return std::chrono::duration<double, std::micro>(Bench::Clock::now() - start).count();
+    }
+
+    double FirstByteCached(AssetCache& cache, const std::string& name, std::vector<char>& buffer) {
+        auto start = Bench::Clock::now();
+        AssetResponse response;
+        response.Begin(cache.Get(name), "", "");
+        Bench::Consume(response.Read(buffer.data(), buffer.size()));
+        return std::chrono::duration<double, std::micro>(Bench::Clock::now() - start).count();
+    }
+
+    double Median(std::vector<double> samples) {
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: asset_bench [HTML directory]\n");
+        return 0;
+    }
+
+    fs::path scratch;
+    fs::path root;
+    if (argc > 1) {
+        root = argv[1];
+    } else {
+        scratch = fs::temp_directory_path() / ("nexile_asset_bench_" + std::to_string(std::random_device()()));
+        root = scratch / "html";
+        GenerateDirectory(root);
+    }
+
+    std::vector<std::string> names;
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        if (entry.is_regular_file()) {
+            names.push_back(fs::relative(entry.path(), root).generic_string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    if (names.empty()) {
+        printf("no files under %s\n", root.string().c_str());
+        return 1;
+    }
+
+    const int runs = 200;
+    std::vector<char> buffer(kReadSize);
+    AssetCache cache(root.u8string());
+    bool ok = true;
+
+    printf("us per request, median of %d runs: first byte / whole body\n", runs);
+    printf("  %-22s %9s  %19s  %19s  %19s\n", "", "bytes", "FileExists+ReadText", "cache miss", "cache hit");
+    for (const std::string& name : names) {
+        Sent oldSent;
+        Sent newSent;
+        SendOld(root, name, buffer, &oldSent);
+        SendCached(cache, name, buffer, &newSent);
+        if (oldSent.body != newSent.body) {
+            printf("MISMATCH: %s differs (%zu bytes old, %zu cached)\n", name.c_str(), oldSent.body.size(),
+                   newSent.body.size());
+            ok = false;
+        }
+
+        std::vector<double> oldFirst, missFirst, hitFirst;
+        for (int i = 0; i < runs; i++) {
+            oldFirst.push_back(FirstByteOld(root, name, buffer));
+            cache.Invalidate(name);
+            missFirst.push_back(FirstByteCached(cache, name, buffer));
+            hitFirst.push_back(FirstByteCached(cache, name, buffer));
+        }
+
+        Bench::Timing oldBody = Bench::Measure(runs, [&] { SendOld(root, name, buffer, nullptr); });
+        Bench::Timing missBody = Bench::Measure(runs, [&] {
+            cache.Invalidate(name);
+            SendCached(cache, name, buffer, nullptr);
+        });
+        Bench::Timing hitBody = Bench::Measure(runs, [&] { SendCached(cache, name, buffer, nullptr); });
+
+        printf("  %-22s %9zu  %8.1f / %8.1f  %8.1f / %8.1f  %8.2f / %8.1f\n", name.c_str(), newSent.body.size(),
+               Median(oldFirst), oldBody.median, Median(missFirst), missBody.median, Median(hitFirst), hitBody.median);
+    }
+    printf("cache: %zu hits, %zu misses\n", cache.GetHitCount(), cache.GetMissCount());
+
+    if (!scratch.empty()) {
+        std::error_code ec;
+        fs::remove_all(scratch, ec);
+    }
+    return ok ? 0 : 1;
+}
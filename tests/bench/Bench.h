@@ -0,0 +1,59 @@
+#pragma once
+
+// Timing helpers shared by the benchmarks
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Nexile {
+    namespace Bench {
+
+        using Clock = std::chrono::steady_clock;
+
+        // Microseconds per run of a measured block
+        struct Timing {
+            double best = 0.0;
+            double median = 0.0;
+        };
+
+        // Runs f `runs` times after one warm-up run
+        template <typename F>
+        Timing Measure(int runs, F&& f) {
+            f();
+
+            std::vector<double> samples;
+            samples.reserve(static_cast<size_t>(runs));
+            for (int i = 0; i < runs; i++) {
+                auto start = Clock::now();
+                f();
+                samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+
+            std::sort(samples.begin(), samples.end());
+            Timing timing;
+            timing.best = samples.front();
+            timing.median = samples[samples.size() / 2];
+            return timing;
+        }
+
+        // Keeps a result alive so the optimiser cannot drop the work behind it
+        inline volatile size_t g_sink = 0;
+        inline void Consume(size_t value) { g_sink = g_sink + value; }
+
+        inline bool ReadFile(const std::string& path, std::string& contents) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) return false;
+
+            std::ostringstream buffer;
+            buffer << file.rdbuf();
+            contents = buffer.str();
+            return true;
+        }
+
+    } // namespace Bench
+} // namespace Nexile
@@ -0,0 +1,189 @@
+// Build code decoding benchmark
+//
+//   build_code_bench [export code file]...
+//
+// Each file holds one Path of Building export code as copied from PoB or a
+// paste site. Without files a large generated build is used: three tree
+// specs, two skill sets and 40 rare items with mod ranges, about the size
+// of a heavily geared endgame export. The budget for base64 + inflate +
+// parse is 10 ms per code.
+
+#include "Bench.h"
+
+#include "Build/BuildCodeDecoder.h"
+
+#include <zlib.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+
+namespace {
+    constexpr double kBudgetMicroseconds = 10000.0;
+
+    std::string GenerateBuildXml() {
+        std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<PathOfBuilding>\n";
+        xml += "<Build level=\"97\" targetVersion=\"3_0\" bandit=\"None\" className=\"Witch\" ascendClassName=\"Occultist\" mainSocketGroup=\"3\">\n";
+        for (int i = 0; i < 220; i++) {
+            xml += "\t<PlayerStat stat=\"Stat" + std::to_string(i) + "\" value=\"" + std::to_string(i * 137.25) + "\"/>\n";
+        }
+        xml += "</Build>\n";
+
+        xml += "<Tree activeSpec=\"3\">\n";
+        for (int spec = 1; spec <= 3; spec++) {
+            xml += "\t<Spec title=\"Level " + std::to_string(spec * 30) + "\" treeVersion=\"3_25\" classId=\"3\" ascendClassId=\"1\" nodes=\"";
+            for (int node = 0; node < 40 * spec + 10; node++) {
+                if (node) xml += ",";
+                xml += std::to_string(1000 + node * 487 % 64000);
+            }
+            xml += "\">\n\t\t<URL>https://www.pathofexile.com/passive-skill-tree/3.25.0/AAAABgMBQ";
+            xml += std::string(300, 'A');
+            xml += "</URL>\n\t\t<Sockets>\n";
+            for (int socket = 0; socket < 8; socket++) {
+                xml += "\t\t\t<Socket nodeId=\"" + std::to_string(2000 + socket) + "\" itemId=\"" + std::to_string(30 + socket) + "\"/>\n";
+            }
+            xml += "\t\t</Sockets>\n\t</Spec>\n";
+        }
+        xml += "</Tree>\n";
+
+        xml += "<Notes>\n";
+        for (int line = 0; line < 60; line++) {
+            xml += "Leveling: swap to the next gem link at level " + std::to_string(line) + " and pick up the life wheel near the Witch start.\n";
+        }
+        xml += "</Notes>\n";
+
+        xml += "<Skills sortGemsByDPSField=\"CombinedDPS\" activeSkillSet=\"2\" sortGemsByDPS=\"true\">\n";
+        for (int set = 1; set <= 2; set++) {
+            xml += "\t<SkillSet id=\"" + std::to_string(set) + "\">\n";
+            for (int group = 0; group < 12; group++) {
+                xml += "\t\t<Skill mainActiveSkillCalcs=\"1\" includeInFullDPS=\"false\" label=\"Link " + std::to_string(group) +
+                    "\" enabled=\"true\" slot=\"Body Armour\" mainActiveSkill=\"1\">\n";
+                for (int gem = 0; gem < 6; gem++) {
+                    bool support = gem > 0;
+                    std::string gemName = support ? "Support Gem " + std::to_string(group * 6 + gem) : "Active Skill " + std::to_string(group);
+                    xml += "\t\t\t<Gem enableGlobal2=\"true\" level=\"20\" gemId=\"Metadata/Items/Gems/" +
+                        std::string(support ? "SupportGem" : "SkillGem") + std::to_string(gem) + "\" skillId=\"" +
+                        std::string(support ? "Support" : "") + "Skill" + std::to_string(gem) + "\" quality=\"20\" qualityId=\"Default\" enabled=\"true\" nameSpec=\"" +
+                        gemName + "\" count=\"1\" enableGlobal1=\"true\"/>\n";
+                }
+                xml += "\t\t</Skill>\n";
+            }
+            xml += "\t</SkillSet>\n";
+        }
+        xml += "</Skills>\n";
+
+        xml += "<Items activeItemSet=\"1\" useSecondWeaponSet=\"false\">\n";
+        for (int item = 1; item <= 40; item++) {
+            xml += "\t<Item id=\"" + std::to_string(item) + "\">\nRarity: RARE\nDoom Loop " + std::to_string(item) +
+                "\nTwo-Stone Ring\nUnique ID: 5f0c9d1e2b3a4c5d6e7f8091a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5\nItem Level: 84\nLevelReq: 60\nImplicits: 1\n{range:0.5}+(12-16)% to Fire and Cold Resistances\n";
+            for (int mod = 0; mod < 10; mod++) {
+                xml += "{range:0." + std::to_string(mod) + "}+(" + std::to_string(20 + mod) + "-" + std::to_string(30 + mod) +
+                    ") to maximum Life\n";
+            }
+            xml += "\t\t<ModRange range=\"0.5\" id=\"1\"/>\n\t\t<ModRange range=\"0.25\" id=\"2\"/>\n\t</Item>\n";
+        }
+        xml += "\t<ItemSet useSecondWeaponSet=\"false\" id=\"1\">\n";
+        for (int slot = 1; slot <= 14; slot++) {
+            xml += "\t\t<Slot name=\"Slot " + std::to_string(slot) + "\" itemId=\"" + std::to_string(slot) + "\"/>\n";
+        }
+        xml += "\t</ItemSet>\n</Items>\n";
+
+        xml += "<Config>\n";
+        for (int input = 0; input < 90; input++) {
+            xml += "\t<Input name=\"condition" + std::to_string(input) + "\" boolean=\"true\"/>\n";
+        }
+        xml += "</Config>\n</PathOfBuilding>\n";
+        return xml;
+    }
+
+    // zlib-compress and URL-safe base64 encode, as PoB exports
+    std::string Encode(const std::string& xml) {
+        uLongf compressedSize = compressBound(static_cast<uLong>(xml.size()));
+        std::string compressed(compressedSize, '\0');
+        compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressedSize,
+                  reinterpret_cast<const Bytef*>(xml.data()), static_cast<uLong>(xml.size()), 9);
+        compressed.resize(compressedSize);
+
+        static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        std::string code;
+        uint32_t accumulator = 0;
+        int bits = 0;
+        for (unsigned char c : compressed) {
+            accumulator = (accumulator << 8) | c;
+            bits += 8;
+            while (bits >= 6) {
+                bits -= 6;
+                code += alphabet[(accumulator >> bits) & 0x3F];
+            }
+        }
+        if (bits > 0) {
+            code += alphabet[(accumulator << (6 - bits)) & 0x3F];
+        }
+        while (code.size() % 4) code += '=';
+        return code;
+    }
+
+    bool Run(const std::string& label, const std::string& code) {
+        BuildCodeDecoder decoder;
+        BuildModel model;
+        std::string error;
+        if (!decoder.Decode(code, model, error)) {
+            printf("%s: %s\n", label.c_str(), error.c_str());
+            return false;
+        }
+
+        std::string compressed;
+        std::string xml;
+        BuildCodeDecoder::DecodeBase64(code, compressed);
+        BuildCodeDecoder::Inflate(compressed, xml, error);
+
+        const int runs = 200;
+        Bench::Timing base64 = Bench::Measure(runs, [&] {
+            BuildCodeDecoder::DecodeBase64(code, compressed);
+            Bench::Consume(compressed.size());
+        });
+        Bench::Timing inflate = Bench::Measure(runs, [&] {
+            BuildCodeDecoder::Inflate(compressed, xml, error);
+            Bench::Consume(xml.size());
+        });
+        Bench::Timing parse = Bench::Measure(runs, [&] {
+            BuildCodeDecoder::ParseXml(xml, model, error);
+            Bench::Consume(model.items.size());
+        });
+        Bench::Timing total = Bench::Measure(runs, [&] {
+            decoder.Decode(code, model, error);
+            Bench::Consume(model.treeNodes.size());
+        });
+
+        printf("%s: code %zu B, xml %zu B, %zu nodes, %zu items, %zu skill groups\n",
+               label.c_str(), code.size(), xml.size(), model.treeNodes.size(), model.items.size(), model.skillGroups.size());
+        printf("  base64 %8.1f us  inflate %8.1f us  parse %8.1f us  (medians)\n", base64.median, inflate.median, parse.median);
+        printf("  decode %8.1f us median, %8.1f us best  -> %s the 10 ms budget\n",
+               total.median, total.best, total.median < kBudgetMicroseconds ? "within" : "OVER");
+        return total.median < kBudgetMicroseconds;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: build_code_bench [export code file]...\n");
+        return 0;
+    }
+
+    bool ok = true;
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            std::string code;
+            if (!Bench::ReadFile(argv[i], code)) {
+                printf("%s: cannot read\n", argv[i]);
+                ok = false;
+                continue;
+            }
+            ok = Run(argv[i], code) && ok;
+        }
+    } else {
+        ok = Run("generated", Encode(GenerateBuildXml()));
+    }
+    return ok ? 0 : 1;
+}
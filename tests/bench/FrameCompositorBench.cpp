@@ -0,0 +1,130 @@
+// Off-screen paint benchmark
+//
+//   paint_bench [paint count]
+//
+// Replays a synthetic overlay animation (a blinking caret, a progress bar and
+// a hover highlight) painted at 120 Hz into a 1280x960 backing store, once
+// through FrameCompositor and once the old way: copying and presenting the
+// whole frame on every paint. Prints pixels copied and presented and the time
+// per paint for both; the two backing stores must end up identical.
+
+#include "Bench.h"
+
+#include "UI/FrameCompositor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+using namespace std::chrono;
+
+namespace {
+    const int kWidth = 1280;
+    const int kHeight = 960;
+    const int kStride = kWidth * 4;
+    const microseconds kPaintInterval(8333);
+
+    // Rects CEF reports for paint `index` of the animation
+    int AnimationRects(int index, PaintRect* rects) {
+        rects[0] = PaintRect(400, 300, 2, 18);                          // caret
+        rects[1] = PaintRect(40 + index % 200, 880, 60, 12);            // progress bar
+        rects[2] = PaintRect(900, 120 + (index / 6) % 5 * 30, 300, 28); // hover row
+        return 3;
+    }
+
+    void Fill(std::vector<uint8_t>& frame, const PaintRect& rect, uint8_t value) {
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            std::memset(frame.data() + static_cast<size_t>(y) * kStride + static_cast<size_t>(rect.x) * 4, value,
+                        static_cast<size_t>(rect.width) * 4);
+        }
+    }
+
+    struct Totals {
+        uint64_t copied = 0;
+        uint64_t presented = 0;
+        uint64_t presents = 0;
+    };
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: paint_bench [paint count]\n");
+        return 0;
+    }
+    int paintCount = argc > 1 ? std::atoi(argv[1]) : 1200;
+    if (paintCount <= 0) {
+        printf("paint count must be positive\n");
+        return 1;
+    }
+
+    // CEF's view buffer: every paint redraws its rects in place
+    std::vector<uint8_t> frame(static_cast<size_t>(kStride) * kHeight, 0x20);
+    std::vector<uint8_t> compositedStore(frame.size());
+    std::vector<uint8_t> fullStore(frame.size());
+
+    Totals dirty;
+    CompositorStats stats;
+    Bench::Timing dirtyTiming = Bench::Measure(3, [&] {
+        FrameCompositor compositor;
+        compositor.Attach(compositedStore.data(), kWidth, kHeight, kStride);
+        dirty = Totals();
+        auto present = [&](const std::vector<PaintRect>&, const PaintRect& bounds) {
+            dirty.presents++;
+            dirty.presented += static_cast<uint64_t>(bounds.Area());
+        };
+
+        // The first paint covers the whole view
+        FramePacer::TimePoint now = FramePacer::TimePoint() + hours(1);
+        PaintRect whole(0, 0, kWidth, kHeight);
+        compositor.OnPaint(frame.data(), kWidth, kHeight, &whole, 1, now);
+        compositor.Present(now, present);
+        for (int i = 0; i < paintCount; i++) {
+            now += kPaintInterval;
+            PaintRect rects[3];
+            int count = AnimationRects(i, rects);
+            for (int r = 0; r < count; r++) Fill(frame, rects[r], static_cast<uint8_t>(i));
+            compositor.OnPaint(frame.data(), kWidth, kHeight, rects, count, now);
+            compositor.Present(now, present);
+        }
+        compositor.Present(now + seconds(1), present);
+        stats = compositor.GetStats();
+        dirty.copied = stats.pixelsCopied;
+    });
+
+    Totals full;
+    Bench::Timing fullTiming = Bench::Measure(3, [&] {
+        full = Totals();
+        for (int i = 0; i < paintCount; i++) {
+            PaintRect rects[3];
+            int count = AnimationRects(i, rects);
+            for (int r = 0; r < count; r++) Fill(frame, rects[r], static_cast<uint8_t>(i));
+            std::memcpy(fullStore.data(), frame.data(), fullStore.size());
+            full.copied += static_cast<uint64_t>(kWidth) * kHeight;
+            full.presented += static_cast<uint64_t>(kWidth) * kHeight;
+            full.presents++;
+        }
+        Bench::Consume(fullStore[static_cast<size_t>(paintCount) % fullStore.size()]);
+    });
+
+    printf("%d paints at 120 Hz into %dx%d\n", paintCount, kWidth, kHeight);
+    printf("  full frame: %8.2f Mpx copied, %8.2f Mpx presented, %5llu presents, %7.2f us/paint\n",
+           full.copied / 1e6, full.presented / 1e6, static_cast<unsigned long long>(full.presents),
+           fullTiming.median / paintCount);
+    printf("  compositor: %8.2f Mpx copied, %8.2f Mpx presented, %5llu presents, %7.2f us/paint\n",
+           dirty.copied / 1e6, dirty.presented / 1e6, static_cast<unsigned long long>(dirty.presents),
+           dirtyTiming.median / paintCount);
+    printf("  %llu paints coalesced, %llu full-frame presents\n",
+           static_cast<unsigned long long>(stats.coalescedPaints),
+           static_cast<unsigned long long>(stats.fullFramePresents));
+
+    // Both stores must now hold the view as last painted
+    if (std::memcmp(compositedStore.data(), frame.data(), compositedStore.size()) != 0 ||
+        std::memcmp(fullStore.data(), compositedStore.data(), fullStore.size()) != 0) {
+        printf("MISMATCH: the composited backing store differs from the full-frame copy\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,203 @@
+// HTML template rendering benchmark
+//
+//   template_bench [rows]
+//
+// Renders a bulk exchange cycle table (10000 rows by default, route, margin,
+// depth and expected profit per row, with currency names that need escaping
+// such as "Jeweller's Orb") the way BulkExchangeModule does: a compiled
+// HtmlTemplate appending to a buffer that is cleared and reused between
+// scans. Compares it with rendering into a new string each time, a
+// hand-written ostringstream renderer, and dumping the old JSON payload
+// the page used to build the rows from. Also reports how often the reused
+// buffer grew during the timed runs and the raw escape throughput. The
+// template and the hand-written renderer must produce the same HTML.
+
+#include "Bench.h"
+
+#include "UI/HtmlTemplate.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    const char* kCycleRowsTemplate =
+        "{{#cycles}}<tr>"
+        "<td>{{route}}</td>"
+        "<td class=\"profit\">{{margin}}</td>"
+        "<td>{{depth}}</td>"
+        "<td>{{expected}}</td>"
+        "</tr>{{/cycles}}";
+
+    const char* const kCurrencies[] = {
+        "Chaos Orb", "Divine Orb", "Exalted Orb", "Jeweller's Orb", "Orb of Fusing", "Chromatic Orb",
+        "Orb of Alchemy", "Vaal Orb", "Gemcutter's Prism", "Blessed Orb", "Orb of Regret", "Cartographer's Chisel"
+    };
+
+    struct Cycle {
+        std::vector<std::string> path;
+        double margin;
+        double depth;
+        double expectedChaos;
+    };
+
+    std::vector<Cycle> GenerateCycles(size_t rows) {
+        std::mt19937 rng(11);
+        std::vector<Cycle> cycles;
+        for (size_t row = 0; row < rows; row++) {
+            Cycle cycle;
+            size_t length = 2 + rng() % 3;
+            for (size_t i = 0; i < length; i++) {
+                cycle.path.push_back(kCurrencies[rng() % 12]);
+            }
+            cycle.margin = (rng() % 2000) / 100000.0;
+            cycle.depth = row % 7 == 0 ? 0.0 : (rng() % 50000) / 10.0;
+            cycle.expectedChaos = (rng() % 100000) / 100.0;
+            cycles.push_back(std::move(cycle));
+        }
+        return cycles;
+    }
+
+    std::string FormatFixed(double value, int decimals, const char* suffix = "") {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.*f%s", decimals, value, suffix);
+        return buffer;
+    }
+
+    // The table BulkExchangeModule::UpdateUI renders
+    json BuildTable(const std::vector<Cycle>& cycles) {
+        json table = { {"cycles", json::array()} };
+        for (const Cycle& cycle : cycles) {
+            std::string route;
+            for (const std::string& currency : cycle.path) {
+                route += currency;
+                route += " \xE2\x86\x92 ";
+            }
+            route += cycle.path.front();
+
+            table["cycles"].push_back({
+                {"route", route},
+                {"margin", FormatFixed(cycle.margin * 100.0, 2, "%")},
+                {"depth", cycle.depth > 0 ? FormatFixed(cycle.depth, 1, " ") + cycle.path.front() : "unknown"},
+                {"expected", FormatFixed(cycle.expectedChaos, 1)}
+            });
+        }
+        return table;
+    }
+
+    // The payload the page used to build the rows from
+    json BuildOldPayload(const std::vector<Cycle>& cycles) {
+        json payload = json::array();
+        for (const Cycle& cycle : cycles) {
+            payload.push_back({
+                {"path", cycle.path},
+                {"margin", cycle.margin},
+                {"depth", cycle.depth},
+                {"expectedChaos", cycle.expectedChaos}
+            });
+        }
+        return payload;
+    }
+
+    void StreamEscaped(std::ostringstream& out, const std::string& text) {
+        for (char c : text) {
+            switch (c) {
+            case '&': out << "&amp;"; break;
+            case '<': out << "&lt;"; break;
+            case '>': out << "&gt;"; break;
+            case '"': out << "&quot;"; break;
+            case '\'': out << "&#39;"; break;
+            default: out << c; break;
+            }
+        }
+    }
+
+    std::string RenderByHand(const json& table) {
+        std::ostringstream out;
+        for (const json& row : table["cycles"]) {
+            out << "<tr><td>";
+            StreamEscaped(out, row["route"].get_ref<const std::string&>());
+            out << "</td><td class=\"profit\">";
+            StreamEscaped(out, row["margin"].get_ref<const std::string&>());
+            out << "</td><td>";
+            StreamEscaped(out, row["depth"].get_ref<const std::string&>());
+            out << "</td><td>";
+            StreamEscaped(out, row["expected"].get_ref<const std::string&>());
+            out << "</td></tr>";
+        }
+        return out.str();
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: template_bench [rows]\n");
+        return 0;
+    }
+    size_t rows = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 10000;
+    if (rows == 0) {
+        printf("row count must be positive\n");
+        return 1;
+    }
+
+    const std::vector<Cycle> cycles = GenerateCycles(rows);
+    const json table = BuildTable(cycles);
+    const json oldPayload = BuildOldPayload(cycles);
+
+    HtmlTemplate html;
+    std::string error;
+    if (!html.Compile(kCycleRowsTemplate, error)) {
+        printf("template does not compile: %s\n", error.c_str());
+        return 1;
+    }
+
+    const int runs = 30;
+    std::string reused;
+    size_t growths = 0;
+    Bench::Timing reusedTiming = Bench::Measure(runs, [&] {
+        size_t capacity = reused.capacity();
+        reused.clear();
+        html.Render(table, reused);
+        if (reused.capacity() != capacity) growths++;
+    });
+    // The warm-up run grows the buffer to the table size
+    growths = growths > 0 ? growths - 1 : 0;
+
+    Bench::Timing fresh = Bench::Measure(runs, [&] { Bench::Consume(html.Render(table).size()); });
+    Bench::Timing byHand = Bench::Measure(runs, [&] { Bench::Consume(RenderByHand(table).size()); });
+    Bench::Timing dump = Bench::Measure(runs, [&] { Bench::Consume(oldPayload.dump().size()); });
+
+    printf("%zu cycle rows, %zu bytes of HTML, ms (median of %d runs)\n", rows, reused.size(), runs);
+    printf("  template, reused buffer       %8.3f (grew %zu times after warm-up)\n", reusedTiming.median / 1000.0,
+           growths);
+    printf("  template, new string          %8.3f\n", fresh.median / 1000.0);
+    printf("  ostringstream by hand         %8.3f\n", byHand.median / 1000.0);
+    printf("  json.dump of the old payload  %8.3f (%zu bytes)\n", dump.median / 1000.0, oldPayload.dump().size());
+
+    // Escaping alone: 1 MiB of text with 1% special characters
+    std::string text(1024 * 1024, 'a');
+    std::mt19937 rng(5);
+    for (size_t i = 0; i < text.size(); i++) {
+        if (rng() % 100 == 0) text[i] = "&<>\"'"[rng() % 5];
+        else text[i] = static_cast<char>('a' + rng() % 26);
+    }
+    std::string escaped;
+    Bench::Timing escape = Bench::Measure(runs, [&] {
+        escaped.clear();
+        HtmlTemplate::AppendEscaped(text, escaped);
+    });
+    printf("  escape 1 MiB, 1%% special      %8.3f (%.2f GB/s)\n", escape.median / 1000.0,
+           text.size() / escape.median / 1000.0);
+
+    if (reused != RenderByHand(table)) {
+        printf("MISMATCH: template and hand-written HTML differ\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// Page request round-trip benchmark
+//
+//   channel_bench [result rows]
+//
+// Sends a stash search query and gets back a result payload (2000 rows by
+// default, each with name, base, item level, price and mods) both ways a
+// page can ask C++ for data. The old path stringifies the request on the
+// page, parses it in C++, dumps the reply into a script and parses it again
+// on the page. The channel path hands the json tree to MessageChannel::Answer
+// and back. CEF is not available here, so the value-by-value conversions
+// the codec does (json -> CEF values -> V8 values) are stood in for by
+// building a copy of the tree per hop. Both paths must deliver the same
+// reply.
+
+#include "Bench.h"
+
+#include "UI/MessageChannel.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    json GenerateResults(size_t rows) {
+        static const char* const bases[] = { "Two-Stone Ring", "Stygian Vise", "Hubris Circlet", "Vaal Regalia",
+                                             "Sorcerer Boots", "Onyx Amulet" };
+        static const char* const mods[] = { "+{} to maximum Life", "+{}% to Fire Resistance",
+                                            "+{}% to Cold Resistance", "+{} to Intelligence",
+                                            "{}% increased Rarity of Items found" };
+        std::mt19937 rng(3);
+        json items = json::array();
+        for (size_t row = 0; row < rows; row++) {
+            json itemMods = json::array();
+            for (int mod = 0; mod < 4; mod++) {
+                std::string text = mods[rng() % 5];
+                text.replace(text.find("{}"), 2, std::to_string(10 + rng() % 90));
+                itemMods.push_back(text);
+            }
+            items.push_back({
+                {"id", "item" + std::to_string(row)},
+                {"name", "Doom Loop " + std::to_string(row)},
+                {"baseType", bases[rng() % 6]},
+                {"ilvl", static_cast<int>(60 + rng() % 27)},
+                {"rarity", "rare"},
+                {"price", static_cast<double>(rng() % 4000) / 10.0},
+                {"mods", std::move(itemMods)}
+            });
+        }
+        return { {"matchCount", rows}, {"queryMs", 1.25}, {"items", std::move(items)} };
+    }
+
+    // Stand-in for one codec hop: a new tree built value by value
+    json Convert(const json& value) {
+        return json(value);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: channel_bench [result rows]\n");
+        return 0;
+    }
+    size_t rows = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 2000;
+    if (rows == 0) {
+        printf("row count must be positive\n");
+        return 1;
+    }
+
+    const json results = GenerateResults(rows);
+    const json query = { {"query", "mod:life>=80 AND rarity:rare"} };
+
+    auto handler = [&results](const json& payload, json& reply, std::string&) {
+        Bench::Consume(payload.at("query").get_ref<const std::string&>().size());
+        reply = results;
+        return true;
+    };
+
+    // Old: page JSON.stringify -> C++ parse -> handler -> dump into a script -> page parse
+    size_t textBytes = 0;
+    json oldDelivered;
+    auto oldRoundTrip = [&] {
+        std::string request = json{ {"action", "stash_search_query"}, {"query", query.at("query")} }.dump();
+        json message = json::parse(request);
+        json reply;
+        std::string error;
+        handler(message, reply, error);
+        std::string script = "window.postMessage({type: 'stash_search_update', data: " + reply.dump() + "}, '*');";
+        textBytes = request.size() + script.size();
+        const std::string suffix = "}, '*');";
+        size_t start = script.find("data: ") + 6;
+        oldDelivered = json::parse(script.begin() + static_cast<std::ptrdiff_t>(start),
+                                   script.end() - static_cast<std::ptrdiff_t>(suffix.size()));
+    };
+
+    // Channel: V8 -> CEF values -> json, Answer, json -> CEF values -> V8
+    MessageChannel channel;
+    channel.RegisterHandler("stash_search.query", handler);
+    PendingRequests pending;
+    json newDelivered;
+    bool settled = true;
+    auto channelRoundTrip = [&] {
+        int id = pending.Begin();
+        json payload = Convert(Convert(query));
+        ChannelReply reply = channel.Answer(id, "stash_search.query", payload);
+        settled = settled && reply.ok && pending.Settle(reply.requestId);
+        newDelivered = Convert(Convert(reply.value));
+    };
+
+    const int runs = 50;
+    Bench::Timing old = Bench::Measure(runs, oldRoundTrip);
+    Bench::Timing typed = Bench::Measure(runs, channelRoundTrip);
+    Bench::Timing handlerOnly = Bench::Measure(runs, [&] {
+        json reply;
+        std::string error;
+        handler(query, reply, error);
+        Bench::Consume(reply.size());
+    });
+
+    printf("%zu result rows, %zu bytes of JSON text per old round trip, ms (median of %d runs)\n", rows, textBytes,
+           runs);
+    printf("  old JSON string path       %8.3f\n", old.median / 1000.0);
+    printf("  channel round trip         %8.3f (%.1fx faster)\n", typed.median / 1000.0, old.median / typed.median);
+    printf("  handler alone              %8.3f\n", handlerOnly.median / 1000.0);
+
+    if (!settled || pending.GetPendingCount() != 0 || oldDelivered != results || newDelivered != results) {
+        printf("MISMATCH: %s, %zu requests left pending\n", settled ? "replies differ" : "a reply did not settle",
+               pending.GetPendingCount());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Map danger matching benchmark
+//
+//   mod_matcher_bench
+//
+// Matches a copied rare map (eight mods plus implicits) against danger
+// lists of 100 to 1,000 patterns: the real map mods the default list warns
+// about, padded with generated mod-like phrases. The compiled matcher must
+// stay under 100 us; a regex per pattern and a substring search per pattern
+// are timed alongside for comparison.
+
+#include "Bench.h"
+
+#include "Game/ItemParser.h"
+#include "Game/ModMatcher.h"
+
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+
+namespace {
+    constexpr double kBudgetMicroseconds = 100.0;
+
+    const char* const kMapText =
+        "Item Class: Maps\r\n"
+        "Rarity: Rare\r\n"
+        "Cursed Haven\r\n"
+        "Atoll Map\r\n"
+        "--------\r\n"
+        "Map Tier: 16\r\n"
+        "Item Quantity: +78% (augmented)\r\n"
+        "Item Rarity: +41% (augmented)\r\n"
+        "Monster Pack Size: +27% (augmented)\r\n"
+        "--------\r\n"
+        "Item Level: 83\r\n"
+        "--------\r\n"
+        "Monsters deal 101% extra Physical Damage as Fire\r\n"
+        "Players are Cursed with Temporal Chains\r\n"
+        "Monsters reflect 18% of Elemental Damage\r\n"
+        "Monsters have 40% increased Area of Effect\r\n"
+        "Area has patches of Shocked Ground which increase Damage taken by 50%\r\n"
+        "Monsters fire 2 additional Projectiles\r\n"
+        "Players have 60% less Recovery Rate of Life and Energy Shield\r\n"
+        "Monsters have +40% chance to Suppress Spell Damage\r\n"
+        "--------\r\n"
+        "Travel to this Map by using it in a personal Map Device. Maps can only be used once.\r\n";
+
+    const char* const kDangerMods[] = {
+        "Monsters reflect #% of Elemental Damage",
+        "Monsters reflect #% of Physical Damage",
+        "Players cannot Regenerate Life, Mana or Energy Shield",
+        "Players have #% less Recovery Rate of Life and Energy Shield",
+        "Players are Cursed with Temporal Chains",
+        "Players are Cursed with Elemental Weakness",
+        "Players are Cursed with Vulnerability",
+        "Players are Cursed with Enfeeble",
+        "Monsters deal #% extra Physical Damage as Fire",
+        "Monsters deal #% extra Physical Damage as Cold",
+        "Monsters deal #% extra Physical Damage as Lightning",
+        "Monsters have #% chance to Avoid Elemental Ailments",
+        "Monsters cannot be Leeched from",
+        "Monsters have #% increased Critical Strike Chance",
+        "Players have #% reduced Maximum total Life, Mana and Energy Shield Recovery per second from Leech",
+        "Monsters fire # additional Projectiles",
+        "Area has patches of Shocked Ground which increase Damage taken by #%",
+        "Area has patches of Burning Ground",
+        "Monsters have +#% chance to Suppress Spell Damage",
+        "Players have #% less Armour",
+        "Monsters gain #% of their Physical Damage as Extra Chaos Damage",
+        "Monsters Poison on Hit",
+        "Monsters Hinder on Hit with Spells",
+        "Monsters are Hexproof",
+    };
+
+    std::vector<std::string> BuildPatterns(size_t count) {
+        static const char* const words[] = {
+            "monsters", "players", "have", "deal", "increased", "reduced", "damage", "life", "chance",
+            "to", "avoid", "critical", "strike", "area", "of", "effect", "cursed", "with", "#%",
+            "additional", "projectiles", "fire", "cold", "lightning", "chaos", "resistance"
+        };
+
+        std::mt19937 rng(3);
+        std::vector<std::string> patterns(std::begin(kDangerMods), std::end(kDangerMods));
+        while (patterns.size() < count) {
+            std::string pattern;
+            int length = 3 + static_cast<int>(rng() % 5);
+            for (int word = 0; word < length; word++) {
+                if (word) pattern += ' ';
+                pattern += words[rng() % (sizeof(words) / sizeof(words[0]))];
+            }
+            patterns.push_back(pattern);
+        }
+        patterns.resize(count);
+        return patterns;
+    }
+
+    // What a per-mod regex list looks like: '#' becomes a number pattern
+    std::regex ToRegex(const std::string& pattern) {
+        std::string expression;
+        for (char c : pattern) {
+            if (c == '#') {
+                expression += "[0-9.]+";
+            } else if (std::string("\\^$.|?*+()[]{}").find(c) != std::string::npos) {
+                expression += '\\';
+                expression += c;
+            } else {
+                expression += c;
+            }
+        }
+        return std::regex(expression, std::regex::icase | std::regex::optimize);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: mod_matcher_bench\n");
+        return 0;
+    }
+
+    ItemData map;
+    if (!ParsePoEItem(kMapText, map)) {
+        printf("map text does not parse\n");
+        return 1;
+    }
+
+    bool ok = true;
+    for (size_t count : { 100, 300, 1000 }) {
+        std::vector<std::string> patterns = BuildPatterns(count);
+
+        ModMatcher matcher;
+        Bench::Timing compile = Bench::Measure(20, [&] {
+            matcher.Clear();
+            for (const std::string& pattern : patterns) {
+                matcher.AddPattern(pattern);
+            }
+            matcher.Compile();
+        });
+
+        std::vector<int> matches;
+        Bench::Timing match = Bench::Measure(2000, [&] {
+            matcher.MatchLines(map.mods, matches);
+            Bench::Consume(matches.size());
+        });
+        size_t matched = matches.size();
+
+        // Substring search of every normalised pattern in every normalised mod
+        std::vector<std::string> normalizedPatterns;
+        for (const std::string& pattern : patterns) {
+            normalizedPatterns.push_back(ModMatcher::Normalize(pattern));
+        }
+        size_t substringMatched = 0;
+        Bench::Timing substring = Bench::Measure(200, [&] {
+            substringMatched = 0;
+            for (const std::string& mod : map.mods) {
+                std::string line = ModMatcher::Normalize(mod);
+                for (const std::string& pattern : normalizedPatterns) {
+                    substringMatched += line.find(pattern) != std::string::npos;
+                }
+            }
+            Bench::Consume(substringMatched);
+        });
+
+        std::vector<std::regex> expressions;
+        for (const std::string& pattern : patterns) {
+            expressions.push_back(ToRegex(pattern));
+        }
+        size_t regexMatched = 0;
+        Bench::Timing regex = Bench::Measure(20, [&] {
+            regexMatched = 0;
+            for (const std::string& mod : map.mods) {
+                for (const std::regex& expression : expressions) {
+                    regexMatched += std::regex_search(mod, expression);
+                }
+            }
+            Bench::Consume(regexMatched);
+        });
+
+        printf("%4zu patterns: %zu states, compile %7.1f us | match %6.2f us median (%zu hits) -> %s\n",
+               count, matcher.GetStateCount(), compile.median, match.median, matched,
+               match.median < kBudgetMicroseconds ? "within the 100 us budget" : "OVER the 100 us budget");
+        printf("               per-pattern substring %8.1f us (%zu hits), per-pattern regex %9.1f us (%zu hits)\n",
+               substring.median, substringMatched, regex.median, regexMatched);
+        ok = ok && match.median < kBudgetMicroseconds;
+    }
+    return ok ? 0 : 1;
+}
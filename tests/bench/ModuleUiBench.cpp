@@ -0,0 +1,132 @@
+// Module UI load benchmark
+//
+//   module_ui_bench [document size in KiB]
+//
+// Loads a generated module document (4 MiB by default: a stylesheet, a large
+// result table and an inline script) the way the shell shows a module page.
+// The old path built a data: URL from the HTML, escaped it into the
+// nexileShell.show() script as a JSON string and converted that script to
+// UTF-16 for CEF. The new path registers the document with the asset cache,
+// puts its short nexile:// URL in the script and serves the document
+// through AssetCache::Get and an AssetResponse in 64 KiB reads. It also
+// times loading a module whose document did not change. Both paths must
+// hand the page the same document.
+
+#include "Bench.h"
+
+#include "UI/AssetCache.h"
+#include "UI/AssetResponse.h"
+#include "Utils/Transcoder.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+
+namespace {
+    std::string GenerateDocument(size_t size) {
+        std::string html = "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><style>\n";
+        for (int rule = 0; rule < 200; rule++) {
+            html += ".row-" + std::to_string(rule) + " { color: #c8c8c8; padding: 2px 6px; }\n";
+        }
+        html += "</style></head><body>\n<table id=\"items\">\n";
+        const std::string script = "<script>document.querySelectorAll('tr').forEach(function(row) { "
+                                   "row.addEventListener('click', function() { row.classList.toggle('on'); }); });"
+                                   "</script>\n</body></html>\n";
+        for (int row = 0; html.size() + script.size() < size; row++) {
+            html += "<tr class=\"row-" + std::to_string(row % 200) + "\"><td>Doom Loop " + std::to_string(row) +
+                "</td><td>Two-Stone Ring</td><td>" + std::to_string(60 + row % 27) +
+                "</td><td>+" + std::to_string(row % 90) + "% to Fire and Cold Resistances \xE2\x80\x94 \"crafted\"</td></tr>\n";
+        }
+        html += "</table>\n" + script;
+        return html;
+    }
+
+    // The script the shell is told to show a page with
+    std::string ShowScript(const std::string& url) {
+        return "window.nexileShell && nexileShell.show(\"build_guide\", " + nlohmann::json(url).dump() + ", 7);";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: module_ui_bench [document size in KiB]\n");
+        return 0;
+    }
+    size_t size = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096) * 1024;
+    if (size == 0) {
+        printf("size must be positive\n");
+        return 1;
+    }
+
+    const std::string document = GenerateDocument(size);
+    const std::string path = "module/build_guide/index.html";
+    std::vector<char> buffer(64 * 1024);
+
+    // Old: the document travels inside a data: URL inside the script
+    size_t oldBytes = 0;
+    std::u16string oldScript;
+    auto oldLoad = [&] {
+        std::string html = document;    // GetModuleUIHTML
+        std::string url = "data:text/html;charset=utf-8," + html;
+        std::string script = ShowScript(url);
+        oldScript.clear();
+        Transcoder::AppendUtf16(script, oldScript);
+        oldBytes = url.size() + script.size() + oldScript.size() * 2;
+    };
+
+    // New: register, send the short URL, serve the document on request
+    AssetCache cache("/nonexistent/nexile/html");
+    size_t newBytes = 0;
+    std::string served;
+    auto newLoad = [&](bool keepServed) {
+        AssetPtr asset = cache.RegisterVirtual(path, std::string(document));
+        std::string url = "nexile://" + asset->path + "?v=" + asset->etag.substr(1, asset->etag.size() - 2);
+        std::u16string script;
+        Transcoder::AppendUtf16(ShowScript(url), script);
+
+        AssetResponse response;
+        response.Begin(cache.Get(url.substr(9)), "", "");
+        size_t total = 0;
+        if (keepServed) served.clear();
+        while (size_t read = response.Read(buffer.data(), buffer.size())) {
+            if (keepServed) served.append(buffer.data(), read);
+            total += read;
+        }
+        newBytes = script.size() * 2 + total;
+        Bench::Consume(total);
+    };
+
+    const int runs = 30;
+    Bench::Timing old = Bench::Measure(runs, oldLoad);
+    Bench::Timing changed = Bench::Measure(runs, [&] {
+        cache.UnregisterVirtual(path);
+        newLoad(false);
+    });
+    Bench::Timing unchanged = Bench::Measure(runs, [&] { newLoad(false); });
+
+    printf("%zu byte module document, ms per load (median of %d runs)\n", document.size(), runs);
+    printf("  data: URL in the show script     %8.3f  (%zu bytes built)\n", old.median / 1000.0, oldBytes);
+    printf("  asset cache, new document        %8.3f  (%zu bytes built and served)\n", changed.median / 1000.0,
+           newBytes);
+    printf("  asset cache, same document       %8.3f  (%.1fx faster than data: URL)\n", unchanged.median / 1000.0,
+           old.median / unchanged.median);
+
+    // The page gets the document back out of the data: URL, or from the response
+    newLoad(true);
+    std::string text;
+    Transcoder::AppendUtf8(oldScript.data(), oldScript.size(), text);
+    size_t start = text.find(", ") + 2;
+    std::string url = nlohmann::json::parse(text.substr(start, text.rfind(", 7);") - start)).get<std::string>();
+    std::string fromDataUrl = url.substr(std::string("data:text/html;charset=utf-8,").size());
+    if (fromDataUrl != document || served != document) {
+        printf("MISMATCH: the page would get %zu bytes from the data: URL, %zu from the cache; expected %zu\n",
+               fromDataUrl.size(), served.size(), document.size());
+        return 1;
+    }
+    return 0;
+}
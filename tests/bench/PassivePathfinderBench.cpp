@@ -0,0 +1,182 @@
+// Passive tree planning benchmark
+//
+//   passive_tree_bench [tree data.json] [class name]
+//
+// With a tree file (data.json of GGG's skill tree export, the same file the
+// build guide reads from passive_tree.json) the real tree is used; without
+// one, a 3,000 node generated tree of the same density. Targets are 120
+// nodes grown outward from the class start, about what an endgame build
+// allocates. The run then replays a levelling session: one point is
+// allocated per level-up and the plan is recomputed after each, which must
+// stay under a millisecond.
+
+#include "Bench.h"
+
+#include "Build/PassivePathfinder.h"
+#include "Build/PassiveTree.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+
+namespace {
+    constexpr double kBudgetMicroseconds = 1000.0;
+    constexpr size_t kTargetCount = 120;
+
+    // 7 class starts off a virtual root, a 60x50 lattice of chains with
+    // random cross links, masteries and ascendancy nodes mixed in
+    std::string GenerateTreeJson() {
+        std::mt19937 rng(1);
+        nlohmann::json data;
+        data["tree"] = "generated";
+        data["classes"] = nlohmann::json::array();
+        for (const char* name : { "Scion", "Marauder", "Ranger", "Witch", "Duelist", "Templar", "Shadow" }) {
+            data["classes"].push_back({ { "name", name } });
+        }
+
+        const int count = 3000;
+        const int width = 60;
+        nlohmann::json& nodes = data["nodes"];
+        nodes["root"] = { { "out", { "1", "2", "3", "4", "5", "6", "7" } } };
+        for (int i = 1; i <= count; i++) {
+            nlohmann::json node = { { "skill", i }, { "name", "Node " + std::to_string(i) },
+                                    { "out", nlohmann::json::array() }, { "in", nlohmann::json::array() } };
+            if (i <= 7) node["classStartIndex"] = i - 1;
+            if (i % 50 == 0) node["isMastery"] = true;
+            if (i % 97 == 0) node["ascendancyName"] = "Occultist";
+            nodes[std::to_string(i)] = node;
+        }
+        for (int i = 1; i <= count; i++) {
+            int row = (i - 1) / width;
+            int column = (i - 1) % width;
+            nlohmann::json& out = nodes[std::to_string(i)]["out"];
+            if (column < width - 1) out.push_back(std::to_string(i + 1));
+            if (row < count / width - 1 && rng() % 4 == 0) out.push_back(std::to_string(i + width));
+        }
+        return data.dump();
+    }
+
+    // Targets reachable from start, grown like a build's allocation
+    std::vector<int> GrowTargets(const PassiveTree& tree, int start, const PassiveNodeSet& blocked) {
+        std::mt19937 rng(7);
+        std::vector<int> grown{ start };
+        std::vector<int> targets;
+        PassiveNodeSet seen(tree.GetNodeCount());
+        seen.Set(start);
+
+        for (int attempts = 0; targets.size() < kTargetCount && attempts < 1000000; attempts++) {
+            int from = grown[rng() % grown.size()];
+            int degree = tree.GetDegree(from);
+            if (degree == 0) continue;
+
+            int to = tree.NeighboursBegin(from)[rng() % degree];
+            if (seen.Test(to) || blocked.Test(to)) continue;
+            seen.Set(to);
+            grown.push_back(to);
+            targets.push_back(to);
+        }
+
+        // Builds pick notables all over their region, not in growth order
+        std::shuffle(targets.begin(), targets.end(), rng);
+        return targets;
+    }
+
+    bool IsConnected(const PassiveTree& tree, PassiveNodeSet allocated, const PassivePlan& plan) {
+        for (const PassivePathStep& step : plan.steps) {
+            for (int node : step.path) {
+                bool touches = false;
+                for (const int* neighbour = tree.NeighboursBegin(node); neighbour != tree.NeighboursEnd(node); ++neighbour) {
+                    touches = touches || allocated.Test(*neighbour);
+                }
+                if (!touches) return false;
+                allocated.Set(node);
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: passive_tree_bench [tree data.json] [class name]\n");
+        return 0;
+    }
+
+    std::string text;
+    if (argc > 1) {
+        if (!Bench::ReadFile(argv[1], text)) {
+            printf("%s: cannot read\n", argv[1]);
+            return 1;
+        }
+    } else {
+        text = GenerateTreeJson();
+    }
+    std::string className = argc > 2 ? argv[2] : "Witch";
+
+    PassiveTree tree;
+    std::string error;
+    Bench::Timing load = Bench::Measure(5, [&] {
+        if (!tree.LoadFromJson(text, error)) return;
+        Bench::Consume(tree.GetNodeCount());
+    });
+    if (!tree.IsLoaded()) {
+        printf("tree: %s\n", error.c_str());
+        return 1;
+    }
+
+    int start = tree.FindClassStart(className);
+    if (start < 0) {
+        printf("no class start for %s\n", className.c_str());
+        return 1;
+    }
+
+    PassivePathfinder pathfinder(tree);
+    pathfinder.BlockOtherClassStarts(start);
+    PassiveNodeSet blocked(tree.GetNodeCount());
+    for (const char* other : { "Scion", "Marauder", "Ranger", "Witch", "Duelist", "Templar", "Shadow" }) {
+        int otherStart = tree.FindClassStart(other);
+        if (otherStart >= 0 && otherStart != start) blocked.Set(otherStart);
+    }
+
+    PassiveNodeSet allocated(tree.GetNodeCount());
+    allocated.Set(start);
+    std::vector<int> targets = GrowTargets(tree, start, blocked);
+
+    printf("tree %s: %zu nodes, %zu edges, load %.1f ms; %zu targets from %s\n",
+           tree.GetVersion().c_str(), tree.GetNodeCount(), tree.GetEdgeCount(), load.median / 1000.0,
+           targets.size(), className.c_str());
+
+    PassivePlan plan;
+    Bench::Timing fresh = Bench::Measure(200, [&] {
+        pathfinder.PlanAllocation(allocated, targets, plan);
+        Bench::Consume(plan.pointCount);
+    });
+    if (!IsConnected(tree, allocated, plan)) {
+        printf("plan does not connect to the allocated tree\n");
+        return 1;
+    }
+    printf("fresh plan: %zu steps, %zu points, %zu unreachable; %.1f us median, %.1f us best\n",
+           plan.steps.size(), plan.pointCount, plan.unreachable.size(), fresh.median, fresh.best);
+
+    // Levelling: allocate the next planned point, then plan again
+    std::vector<double> replans;
+    while (!plan.steps.empty()) {
+        allocated.Set(plan.steps.front().path.front());
+
+        auto begin = Bench::Clock::now();
+        pathfinder.PlanAllocation(allocated, targets, plan);
+        replans.push_back(std::chrono::duration<double, std::micro>(Bench::Clock::now() - begin).count());
+    }
+    std::sort(replans.begin(), replans.end());
+    double median = replans.empty() ? 0.0 : replans[replans.size() / 2];
+    double worst = replans.empty() ? 0.0 : replans.back();
+
+    printf("levelling: %zu replans, %.1f us median, %.1f us worst -> %s the 1 ms budget\n",
+           replans.size(), median, worst, worst < kBudgetMicroseconds ? "within" : "OVER");
+    return worst < kBudgetMicroseconds ? 0 : 1;
+}
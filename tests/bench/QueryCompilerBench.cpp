@@ -0,0 +1,147 @@
+// Stash query evaluation benchmark
+//
+//   query_bench [item count]
+//
+// Ingests the synthetic stash export (50,000 items by default), then for a
+// set of search-box queries times compilation and bytecode execution next to
+// a row-by-row loop evaluating the same predicate. Both must find the same
+// rows; the folded program of each query is printed with its timings.
+
+#include "Bench.h"
+#include "StashFixture.h"
+
+#include "Stash/QueryCompiler.h"
+#include "Stash/StashIngester.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace Nexile;
+
+namespace {
+    int g_lifeStat = -1;
+
+    uint8_t Rarity(const StashStore& store, uint32_t row) { return store.GetRarityColumn()[row]; }
+    uint8_t Level(const StashStore& store, uint32_t row) { return store.GetItemLevelColumn()[row]; }
+
+    bool BaseContains(const StashStore& store, uint32_t row, const char* text) {
+        return store.GetBaseName(store.GetBaseColumn()[row]).find(text) != std::string::npos;
+    }
+
+    struct Query {
+        const char* text;
+        bool (*row)(const StashStore& store, uint32_t row);
+    };
+
+    const Query kQueries[] = {
+        {
+            "base ~ ring and \"+# to maximum life\" > 40 and pseudo.total_fire_resistance > 30",
+            [](const StashStore& store, uint32_t row) {
+                return BaseContains(store, row, "Ring") && store.GetStatValue(row, g_lifeStat) > 40 &&
+                       store.GetPseudoColumn(StashPseudoStat::TotalFireResistance)[row] > 30;
+            },
+        },
+        {
+            "ilvl >= 84 AND rarity = rare",
+            [](const StashStore& store, uint32_t row) {
+                return Level(store, row) >= 84 && Rarity(store, row) == static_cast<uint8_t>(StashRarity::Rare);
+            },
+        },
+        {
+            "ilvl > 70 and ilvl < 80 and ilvl >= 2*37 and not not rarity != unique",
+            [](const StashStore& store, uint32_t row) {
+                return Level(store, row) >= 74 && Level(store, row) < 80 &&
+                       Rarity(store, row) != static_cast<uint8_t>(StashRarity::Unique);
+            },
+        },
+        {
+            "(rarity = rare || rarity = magic) && !(base ~ belt)",
+            [](const StashStore& store, uint32_t row) {
+                return (Rarity(store, row) == static_cast<uint8_t>(StashRarity::Rare) ||
+                        Rarity(store, row) == static_cast<uint8_t>(StashRarity::Magic)) &&
+                       !BaseContains(store, row, "Belt");
+            },
+        },
+        {
+            "'+40 to maximum Life' >= 80 or base = 'diamond ring'",
+            [](const StashStore& store, uint32_t row) {
+                return store.GetStatValue(row, g_lifeStat) >= 80 ||
+                       store.GetBaseName(store.GetBaseColumn()[row]) == "Diamond Ring";
+            },
+        },
+        {
+            "pseudo.total_elemental_resistance > 80 and pseudo.total_life >= 40 and ilvl >= 75",
+            [](const StashStore& store, uint32_t row) {
+                return store.GetPseudoColumn(StashPseudoStat::TotalElementalResistance)[row] > 80 &&
+                       store.GetPseudoColumn(StashPseudoStat::TotalLife)[row] >= 40 && Level(store, row) >= 75;
+            },
+        },
+        {
+            "ilvl > 90 and ilvl < 80",
+            [](const StashStore&, uint32_t) { return false; },
+        },
+    };
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: query_bench [item count]\n");
+        return 0;
+    }
+    size_t itemCount = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 50000;
+
+    StashStore store;
+    StashIngester ingester(store);
+    std::string error;
+    if (!ingester.IngestText(Bench::GenerateStashJson(itemCount), error)) {
+        printf("ingest: %s\n", error.c_str());
+        return 1;
+    }
+    g_lifeStat = store.FindStat("+# to maximum life");
+    if (g_lifeStat < 0) {
+        printf("no life stat in the store (too few items)\n");
+        return 1;
+    }
+    printf("%zu items, %zu bases, %zu stats\n", store.GetItemCount(), store.GetBaseCount(), store.GetStatCount());
+
+    bool ok = true;
+    for (const Query& query : kQueries) {
+        StashQuery program;
+        bool compiled = true;
+        Bench::Timing compile = Bench::Measure(200, [&] {
+            compiled = QueryCompiler::Compile(query.text, store, program, error);
+        });
+        if (!compiled) {
+            printf("%s: %s\n", query.text, error.c_str());
+            ok = false;
+            continue;
+        }
+
+        StashBitmap result;
+        size_t rows = 0;
+        Bench::Timing execute = Bench::Measure(200, [&] {
+            program.Execute(store, result);
+            rows = result.Count();
+        });
+
+        size_t expected = 0;
+        Bench::Timing loop = Bench::Measure(20, [&] {
+            expected = 0;
+            for (uint32_t row = 0; row < store.GetItemCount(); row++) {
+                expected += query.row(store, row);
+            }
+        });
+
+        printf("\n%s\n", query.text);
+        printf("  %zu instructions, %zu rows: compile %6.1f us, execute %7.1f us, row loop %8.1f us (%.0fx)\n",
+               program.GetInstructions().size(), rows, compile.median, execute.median, loop.median,
+               loop.median / execute.median);
+        printf("%s", program.Disassemble().c_str());
+        if (rows != expected) {
+            printf("  MISMATCH: row loop found %zu rows\n", expected);
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+// Result table window benchmark
+//
+//   table_bench [rows]
+//
+// Loads a stash search result set (100000 rows by default, columns name,
+// base, ilvl and rarity as StashSearchModule publishes them) into a
+// ResultTable and times SetColumns, a sort by a number and by a text
+// column, and a filter. Then fetches 80-row windows at 2000 random offsets
+// in each of those views, as a scrolling page does, and reports the mean,
+// p99 and worst time per window against the 1 ms budget a window has
+// within a frame. Fails when the p99 window is over budget, or when a
+// window does not hold the rows an independent sort and filter put there.
+
+#include "Bench.h"
+
+#include "UI/ResultTable.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    const double kWindowBudgetMs = 1.0;
+    const size_t kWindowRows = 80;
+
+    const char* kResultRowsTemplate =
+        "{{#rows}}<tr>"
+        "<td class=\"{{rarity}}\">{{name}}</td>"
+        "<td>{{base}}</td>"
+        "<td>{{ilvl}}</td>"
+        "</tr>{{/rows}}";
+
+    std::vector<ResultColumn> GenerateColumns(size_t rows) {
+        static const char* const bases[] = { "Two-Stone Ring", "Stygian Vise", "Hubris Circlet", "Vaal Regalia",
+                                             "Sorcerer Boots", "Onyx Amulet", "Coral Ring", "Leather Belt" };
+        static const char* const prefixes[] = { "Doom", "Gale", "Rapture", "Havoc", "Storm", "Blood", "Dread" };
+        static const char* const suffixes[] = { "Loop", "Coil", "Clasp", "Gyre", "Band", "Knot", "Grip" };
+        static const char* const rarities[] = { "normal", "magic", "rare", "unique" };
+
+        std::vector<ResultColumn> columns(4);
+        columns[0].name = "name";
+        columns[1].name = "base";
+        columns[2].name = "ilvl";
+        columns[2].numeric = true;
+        columns[3].name = "rarity";
+
+        std::mt19937 rng(7);
+        for (size_t row = 0; row < rows; row++) {
+            std::string base = bases[rng() % 8];
+            int rarity = static_cast<int>(rng() % 4);
+            std::string name = rarity == 2 ? std::string(prefixes[rng() % 7]) + " " + suffixes[rng() % 7] : "";
+            columns[0].text.push_back(name.empty() ? base : name);
+            columns[1].text.push_back(base);
+            columns[2].numbers.push_back(static_cast<double>(1 + rng() % 86));
+            columns[3].text.push_back(rarities[rarity]);
+        }
+        return columns;
+    }
+
+    // The view the table should show, worked out without it; filter is
+    // lower case
+    std::vector<uint32_t> ExpectedView(const std::vector<ResultColumn>& columns, bool byLevel,
+                                       const std::string& filter) {
+        std::vector<uint32_t> view(columns[0].text.size());
+        std::iota(view.begin(), view.end(), 0u);
+        if (byLevel) {
+            const std::vector<double>& levels = columns[2].numbers;
+            std::stable_sort(view.begin(), view.end(), [&](uint32_t a, uint32_t b) { return levels[b] < levels[a]; });
+        }
+        if (!filter.empty()) {
+            std::vector<uint32_t> kept;
+            for (uint32_t row : view) {
+                for (size_t column : { 0, 1, 3 }) {
+                    std::string text = columns[column].text[row];
+                    for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                    if (text.find(filter) != std::string::npos) {
+                        kept.push_back(row);
+                        break;
+                    }
+                }
+            }
+            view.swap(kept);
+        }
+        return view;
+    }
+
+    std::string ExpectedHtml(const std::vector<ResultColumn>& columns, const std::vector<uint32_t>& view,
+                             size_t offset) {
+        HtmlTemplate html;
+        std::string error;
+        html.Compile(kResultRowsTemplate, error);
+        json rows = json::array();
+        for (size_t i = offset; i < std::min(view.size(), offset + kWindowRows); i++) {
+            uint32_t row = view[i];
+            rows.push_back({ {"name", columns[0].text[row]}, {"base", columns[1].text[row]},
+                             {"ilvl", columns[2].numbers[row]}, {"rarity", columns[3].text[row]} });
+        }
+        return html.Render({ {"rows", rows} });
+    }
+
+    struct WindowTimes {
+        double mean = 0.0;
+        double p99 = 0.0;
+        double worst = 0.0;
+    };
+
+    WindowTimes TimeWindows(ResultTable& table, std::mt19937& rng) {
+        const int windows = 2000;
+        size_t view = table.GetViewCount();
+        std::vector<double> samples;
+        for (int i = 0; i < windows; i++) {
+            size_t offset = view > kWindowRows ? rng() % (view - kWindowRows) : 0;
+            auto start = Bench::Clock::now();
+            json window = table.GetWindow(offset, kWindowRows);
+            samples.push_back(std::chrono::duration<double, std::milli>(Bench::Clock::now() - start).count());
+            Bench::Consume(window["html"].get_ref<const std::string&>().size());
+        }
+        std::sort(samples.begin(), samples.end());
+
+        WindowTimes times;
+        times.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        times.p99 = samples[samples.size() * 99 / 100];
+        times.worst = samples.back();
+        return times;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: table_bench [rows]\n");
+        return 0;
+    }
+    size_t rows = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    if (rows == 0) {
+        printf("row count must be positive\n");
+        return 1;
+    }
+
+    const std::vector<ResultColumn> columns = GenerateColumns(rows);
+    ResultTable table;
+    std::string error;
+    if (!table.SetRowTemplate(kResultRowsTemplate, error)) {
+        printf("template does not compile: %s\n", error.c_str());
+        return 1;
+    }
+
+    auto start = Bench::Clock::now();
+    table.SetColumns(columns, error);
+    double setMs = std::chrono::duration<double, std::milli>(Bench::Clock::now() - start).count();
+
+    struct View {
+        const char* name;
+        bool byLevel;
+        std::string filter;
+    };
+    const View views[] = {
+        { "given order", false, "" },
+        { "by ilvl, descending", true, "" },
+        { "by ilvl, filter \"ring\"", true, "ring" },
+    };
+
+    std::mt19937 rng(13);
+    bool ok = true;
+    bool inBudget = true;
+    printf("%zu rows, SetColumns %.1f ms\n", rows, setMs);
+    printf("%zu-row windows at 2000 random offsets, ms\n", kWindowRows);
+    printf("  %-26s %8s  %8s  %8s  %8s\n", "view", "rows", "mean", "p99", "worst");
+    for (const View& view : views) {
+        table.Sort(view.byLevel ? "ilvl" : "", true, error);
+        table.Filter(view.filter);
+
+        WindowTimes times = TimeWindows(table, rng);
+        printf("  %-26s %8zu  %8.3f  %8.3f  %8.3f\n", view.name, table.GetViewCount(), times.mean, times.p99,
+               times.worst);
+        inBudget = inBudget && times.p99 <= kWindowBudgetMs;
+
+        std::vector<uint32_t> expected = ExpectedView(columns, view.byLevel, view.filter);
+        size_t offsets[] = { 0, expected.size() / 2, expected.size() > 1 ? expected.size() - 1 : 0 };
+        for (size_t offset : offsets) {
+            json window = table.GetWindow(offset, kWindowRows);
+            if (window["count"] != expected.size() || window["html"] != ExpectedHtml(columns, expected, offset)) {
+                printf("MISMATCH: %s window at %zu\n", view.name, offset);
+                ok = false;
+            }
+        }
+    }
+
+    ResultTableStats stats = table.GetStats();
+    table.Sort("", false, error);
+    table.Filter("");
+    Bench::Timing numberSort = Bench::Measure(10, [&] { table.Sort("ilvl", true, error); });
+    Bench::Timing textSort = Bench::Measure(10, [&] { table.Sort("name", false, error); });
+    Bench::Timing filter = Bench::Measure(10, [&] { table.Filter("doom"); });
+    printf("sort by ilvl %.1f ms, sort by name %.1f ms, filter %.1f ms (median of 10 runs)\n",
+           numberSort.median / 1000.0, textSort.median / 1000.0, filter.median / 1000.0);
+    printf("ResultTableStats: %llu windows, %llu rows, worst window %.3f ms\n",
+           static_cast<unsigned long long>(stats.windows), static_cast<unsigned long long>(stats.windowRows),
+           stats.maxWindowMs);
+
+    if (!inBudget) {
+        printf("OVER BUDGET: p99 window above %.1f ms\n", kWindowBudgetMs);
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
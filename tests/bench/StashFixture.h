@@ -0,0 +1,73 @@
+#pragma once
+
+// Synthetic public stash pages for the stash benchmarks.
+//
+// Items carry the fields a real stash-tab API response has (icon, sockets,
+// properties, implicit and explicit mods), so ingest touches as much JSON
+// per item as it would on a real export.
+
+#include <random>
+#include <string>
+
+namespace Nexile {
+    namespace Bench {
+
+        inline std::string GenerateStashJson(size_t itemCount, unsigned seed = 7) {
+            static const char* const bases[] = {
+                "Two-Stone Ring", "Amethyst Ring", "Diamond Ring", "Vermillion Ring", "Leather Belt", "Stygian Vise",
+                "Onyx Amulet", "Hubris Circlet", "Vaal Regalia", "Sorcerer Boots", "Titan Gauntlets", "Imperial Claw"
+            };
+            static const char* const mods[] = {
+                "+{} to maximum Life", "+{}% to Fire Resistance", "+{}% to Cold Resistance",
+                "+{}% to Lightning Resistance", "+{}% to all Elemental Resistances", "+{} to Strength",
+                "+{} to Intelligence", "+{}% to Chaos Resistance", "Adds {} to {} Fire Damage to Attacks",
+                "{}% increased Attack Speed", "+{} to maximum Energy Shield", "+{}% to Fire and Cold Resistances",
+                "{}% increased Rarity of Items found"
+            };
+            const size_t baseCount = sizeof(bases) / sizeof(bases[0]);
+            const size_t modCount = sizeof(mods) / sizeof(mods[0]);
+            const size_t itemsPerTab = 200;
+
+            std::mt19937 rng(seed);
+            std::string json = "{\"stashes\":[";
+            json.reserve(itemCount * 520);
+
+            for (size_t item = 0; item < itemCount; item++) {
+                if (item % itemsPerTab == 0) {
+                    if (item) json += "]},";
+                    json += "{\"id\":\"tab" + std::to_string(item / itemsPerTab) + "\",\"public\":true,\"items\":[";
+                } else {
+                    json += ",";
+                }
+
+                unsigned frameType = rng() % 4;
+                json += "{\"verified\":false,\"w\":1,\"h\":1,\"icon\":\"https://web.poecdn.com/gen/image/item.png\",\"name\":\"";
+                json += frameType == 2 ? "Doom Loop" : "";
+                json += "\",\"typeLine\":\"";
+                json += bases[rng() % baseCount];
+                json += "\",\"baseType\":\"";
+                json += bases[rng() % baseCount];
+                json += "\",\"ilvl\":" + std::to_string(60 + rng() % 27) + ",\"frameType\":" + std::to_string(frameType) + ",";
+                json += "\"properties\":[{\"name\":\"Quality\",\"values\":[[\"+20%\",1]],\"displayMode\":0,\"type\":6}],";
+                json += "\"sockets\":[{\"group\":0,\"attr\":\"S\"}],\"socketedItems\":[],";
+                json += "\"implicitMods\":[\"+" + std::to_string(rng() % 30) + "% to Cold Resistance\"],\"explicitMods\":[";
+
+                unsigned modsOnItem = 2 + rng() % 5;
+                for (unsigned mod = 0; mod < modsOnItem; mod++) {
+                    if (mod) json += ",";
+                    std::string text = mods[rng() % modCount];
+                    size_t hole;
+                    while ((hole = text.find("{}")) != std::string::npos) {
+                        text.replace(hole, 2, std::to_string(1 + rng() % 90));
+                    }
+                    json += "\"" + text + "\"";
+                }
+                json += "]}";
+            }
+
+            json += itemCount ? "]}]}" : "]}";
+            return json;
+        }
+
+    } // namespace Bench
+} // namespace Nexile
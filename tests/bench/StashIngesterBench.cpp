@@ -0,0 +1,158 @@
+// Stash ingest and column scan benchmark
+//
+//   stash_bench [item count]
+//
+// Ingests a synthetic public stash export (50,000 items by default) from
+// memory and from a stream, next to a plain DOM parse of the same text for
+// scale, then times filter queries as column scans against a row-by-row
+// scalar loop over the same store. Both must find the same rows.
+
+#include "Bench.h"
+#include "StashFixture.h"
+
+#include "Stash/StashIngester.h"
+
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+using namespace Nexile;
+
+namespace {
+    struct Query {
+        const char* label;
+        size_t (*scan)(const StashStore& store);
+        size_t (*scalar)(const StashStore& store);
+    };
+
+    int g_lifeStat = -1;
+
+    bool IsRing(const StashStore& store, uint32_t row) {
+        return store.GetBaseName(store.GetBaseColumn()[row]).find("Ring") != std::string::npos;
+    }
+
+    const Query kQueries[] = {
+        {
+            "rings with >40 life and >30% fire res",
+            [](const StashStore& store) {
+                StashBitmap rows, life, fire;
+                store.FilterBaseContains("ring", rows);
+                store.FilterStat(g_lifeStat, 40.001f, 1e9f, life);
+                rows.And(life);
+                store.FilterPseudo(StashPseudoStat::TotalFireResistance, 30.001f, 1e9f, fire);
+                rows.And(fire);
+                return rows.Count();
+            },
+            [](const StashStore& store) {
+                size_t count = 0;
+                const std::vector<float>& fire = store.GetPseudoColumn(StashPseudoStat::TotalFireResistance);
+                for (uint32_t row = 0; row < store.GetItemCount(); row++) {
+                    count += IsRing(store, row) && store.GetStatValue(row, g_lifeStat) > 40 && fire[row] > 30;
+                }
+                return count;
+            },
+        },
+        {
+            "rare items of item level 84+",
+            [](const StashStore& store) {
+                StashBitmap rows, rare;
+                store.FilterItemLevel(84, 255, rows);
+                store.FilterRarity(StashRarity::Rare, rare);
+                rows.And(rare);
+                return rows.Count();
+            },
+            [](const StashStore& store) {
+                size_t count = 0;
+                for (uint32_t row = 0; row < store.GetItemCount(); row++) {
+                    count += store.GetItemLevelColumn()[row] >= 84 &&
+                             store.GetRarityColumn()[row] == static_cast<uint8_t>(StashRarity::Rare);
+                }
+                return count;
+            },
+        },
+        {
+            ">80 total elemental resistance",
+            [](const StashStore& store) {
+                StashBitmap rows;
+                store.FilterPseudo(StashPseudoStat::TotalElementalResistance, 80.001f, 1e9f, rows);
+                return rows.Count();
+            },
+            [](const StashStore& store) {
+                size_t count = 0;
+                const std::vector<float>& column = store.GetPseudoColumn(StashPseudoStat::TotalElementalResistance);
+                for (uint32_t row = 0; row < store.GetItemCount(); row++) {
+                    count += column[row] > 80;
+                }
+                return count;
+            },
+        },
+    };
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: stash_bench [item count]\n");
+        return 0;
+    }
+    size_t itemCount = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 50000;
+
+    std::string json = Bench::GenerateStashJson(itemCount);
+    double megabytes = json.size() / 1e6;
+
+    StashStore store;
+    StashIngester ingester(store);
+    std::string error;
+
+    Bench::Timing text = Bench::Measure(5, [&] {
+        store.Clear();
+        store.Reserve(itemCount);
+        if (!ingester.IngestText(json, error)) {
+            printf("ingest: %s\n", error.c_str());
+            std::exit(1);
+        }
+    });
+    if (store.GetItemCount() != itemCount) {
+        printf("ingested %zu of %zu items\n", store.GetItemCount(), itemCount);
+        return 1;
+    }
+
+    Bench::Timing stream = Bench::Measure(5, [&] {
+        std::istringstream input(json);
+        store.Clear();
+        ingester.IngestStream(input, error);
+    });
+
+    Bench::Timing dom = Bench::Measure(3, [&] {
+        Bench::Consume(nlohmann::json::parse(json).size());
+    });
+
+    printf("%zu items, %.1f MB, %zu bases, %zu stats\n", itemCount, megabytes, store.GetBaseCount(), store.GetStatCount());
+    printf("  ingest text   %7.1f ms  (%5.0f MB/s, %7.0f items/s)\n", text.median / 1000.0,
+           megabytes / (text.median / 1e6), itemCount / (text.median / 1e6));
+    printf("  ingest stream %7.1f ms  (%5.0f MB/s)\n", stream.median / 1000.0, megabytes / (stream.median / 1e6));
+    printf("  DOM parse only %6.1f ms  (for scale)\n", dom.median / 1000.0);
+
+    g_lifeStat = store.FindStat("+# to maximum life");
+    if (g_lifeStat < 0) {
+        printf("no life stat in the store (too few items)\n");
+        return 1;
+    }
+
+    bool ok = true;
+    for (const Query& query : kQueries) {
+        size_t rows = 0;
+        size_t expected = 0;
+        Bench::Timing scan = Bench::Measure(200, [&] { rows = query.scan(store); });
+        Bench::Timing scalar = Bench::Measure(20, [&] { expected = query.scalar(store); });
+
+        printf("  %-40s %6zu rows: scan %7.1f us (%6.0f queries/s), row loop %8.1f us\n",
+               query.label, rows, scan.median, 1e6 / scan.median, scalar.median);
+        if (rows != expected) {
+            printf("  MISMATCH: row loop found %zu rows\n", expected);
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+// Module UI state update benchmark
+//
+//   state_bench [price checks]
+//
+// Plays a scripted session, one update per frame: the settings page loads,
+// the opacity slider is dragged over 20 steps, click-through is toggled and
+// the unchanged settings are sent again; then price checks (5 by default)
+// each show a loading state, the results and two price refreshes. The old
+// path posted the whole value in its own script on every update. The new
+// path sets the StateStore and takes one delta script per frame. Reports
+// script executions and bytes per key, the delta figures from
+// StateStoreStats, and the time per session. A page applying the deltas
+// must end up with the store's state after every frame.
+
+#include "Bench.h"
+
+#include "UI/StateStore.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+using json = nlohmann::json;
+
+namespace {
+    struct Update {
+        std::string key;
+        json value;
+    };
+
+    std::vector<Update> GenerateSession(int priceChecks) {
+        json settings = {
+            {"general", { {"opacity", 90}, {"clickThrough", false}, {"autostart", false}, {"autodetect", true},
+                          {"currentGame", "poe1"} }},
+            {"modules", { {"build_guide", true}, {"map_overlay", false}, {"price_check", true},
+                          {"settings", true} }},
+            {"hotkeys", { {"1", "Alt+Shift+O"}, {"2", "Alt+Shift+S"}, {"3", "Ctrl+D"}, {"4", "Alt+B"},
+                          {"5", "Alt+M"} }}
+        };
+
+        std::vector<Update> session;
+        session.push_back({ "settings", settings });
+        for (int step = 1; step <= 20; step++) {
+            settings["general"]["opacity"] = 90 - step * 2;
+            session.push_back({ "settings", settings });
+        }
+        settings["general"]["clickThrough"] = true;
+        session.push_back({ "settings", settings });
+        session.push_back({ "settings", settings });
+
+        static const char* const names[] = { "Doom Loop", "Gale Coil", "Rapture Clasp", "Havoc Gyre" };
+        for (int check = 0; check < priceChecks; check++) {
+            session.push_back({ "price_check", { {"loading", true} } });
+            json results = {
+                {"name", names[check % 4]}, {"baseType", "Two-Stone Ring"}, {"rarity", "Rare"},
+                {"itemLevel", std::to_string(70 + check % 15)}, {"price", "5-10 chaos"}, {"confidence", "medium"}
+            };
+            session.push_back({ "price_check", results });
+            results["price"] = std::to_string(6 + check % 3) + "-10 chaos";
+            session.push_back({ "price_check", results });
+            results["price"] = std::to_string(6 + check % 3) + "-9 chaos";
+            results["confidence"] = "high";
+            session.push_back({ "price_check", results });
+        }
+        return session;
+    }
+
+    // The scripts the modules used to execute
+    std::string OldScript(const Update& update) {
+        if (update.key == "settings") {
+            return "window.postMessage({action: 'load_settings',settings: " + update.value.dump() + "}, '*');";
+        }
+        return "window.postMessage({module: 'price_check',data: " + update.value.dump() + "}, '*');";
+    }
+
+    struct Sent {
+        size_t scripts = 0;
+        size_t bytes = 0;
+    };
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: state_bench [price checks]\n");
+        return 0;
+    }
+    int priceChecks = argc > 1 ? std::atoi(argv[1]) : 5;
+    if (priceChecks <= 0) {
+        printf("price check count must be positive\n");
+        return 1;
+    }
+
+    const std::vector<Update> session = GenerateSession(priceChecks);
+    const std::string prefix = "window.postMessage({nexileState:";
+    const std::string suffix = "},'*');";
+
+    // Old: every update is a script carrying the whole value
+    Sent oldSent[2];
+    for (const Update& update : session) {
+        Sent& sent = oldSent[update.key == "settings" ? 0 : 1];
+        sent.scripts++;
+        sent.bytes += OldScript(update).size();
+    }
+
+    // New: one delta script per frame, applied by a page holding snapshots
+    StateStore store;
+    json page = store.Subscribe({ "settings", "price_check" });
+    Sent newSent[2];
+    bool matched = true;
+    for (const Update& update : session) {
+        store.Set(update.key, update.value);
+        std::string script = store.TakeDeltaScript();
+        if (script.empty()) continue;
+
+        Sent& sent = newSent[update.key == "settings" ? 0 : 1];
+        sent.scripts++;
+        sent.bytes += script.size();
+
+        json deltas = json::parse(script.substr(prefix.size(), script.size() - prefix.size() - suffix.size()));
+        for (const json& delta : deltas) {
+            json& state = page[delta["key"].get<std::string>()];
+            if (state["version"] != delta["from"]) {
+                matched = false;
+                continue;
+            }
+            state["value"] = state["value"].patch(delta["ops"]);
+            state["version"] = delta["to"];
+        }
+        for (const char* key : { "settings", "price_check" }) {
+            matched = matched && page[key]["value"] == store.Get(key) &&
+                page[key]["version"] == store.GetVersion(key);
+        }
+    }
+    StateStoreStats stats = store.GetStats();
+
+    const int runs = 200;
+    Bench::Timing old = Bench::Measure(runs, [&] {
+        for (const Update& update : session) {
+            Bench::Consume(OldScript(update).size());
+        }
+    });
+    Bench::Timing delta = Bench::Measure(runs, [&] {
+        StateStore timed;
+        timed.Subscribe({ "settings", "price_check" });
+        for (const Update& update : session) {
+            timed.Set(update.key, update.value);
+            Bench::Consume(timed.TakeDeltaScript().size());
+        }
+    });
+
+    printf("%zu updates, one per frame: scripts / bytes\n", session.size());
+    printf("  %-12s %19s  %19s\n", "", "whole value", "StateStore delta");
+    const char* const keys[] = { "settings", "price_check" };
+    for (int key = 0; key < 2; key++) {
+        printf("  %-12s %8zu / %8zu  %8zu / %8zu\n", keys[key], oldSent[key].scripts, oldSent[key].bytes,
+               newSent[key].scripts, newSent[key].bytes);
+    }
+    printf("StateStoreStats: %llu sets, %llu changes, %llu deliveries, %llu deltas, %llu ops, %llu delta bytes\n",
+           static_cast<unsigned long long>(stats.sets), static_cast<unsigned long long>(stats.changes),
+           static_cast<unsigned long long>(stats.deliveries), static_cast<unsigned long long>(stats.deltas),
+           static_cast<unsigned long long>(stats.ops), static_cast<unsigned long long>(stats.deltaBytes));
+    printf("us per session (median of %d runs): whole value %.1f, delta %.1f\n", runs, old.median, delta.median);
+
+    if (!matched) {
+        printf("MISMATCH: a page applying the deltas diverged from the store\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+// UTF-8 <-> UTF-16 conversion benchmark
+//
+//   transcode_bench [size in KiB]
+//
+// Converts ASCII (trade JSON), mixed Latin and CJK text (64 KiB each by
+// default) with every kernel set this CPU has, next to the conversion
+// pattern Utils used before Transcoder: a sizing pass, a conversion into a
+// NUL-terminated temporary vector, then a copy of that vector into the
+// result string. MultiByteToWideChar and WideCharToMultiByte are not
+// available here, so the old pattern runs on a non-validating scalar codec.
+// Every result must match the old pattern's output.
+
+#include "Bench.h"
+
+#include "Utils/Transcoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Nexile;
+
+namespace {
+    const char* const kKernels[] = { "scalar", "sse2", "avx2" };
+
+    // Stand-in for MultiByteToWideChar: counts units when out is null
+    size_t WidenScalar(const char* data, size_t length, char16_t* out) {
+        size_t written = 0;
+        for (size_t i = 0; i < length;) {
+            uint8_t lead = static_cast<uint8_t>(data[i]);
+            uint32_t codePoint;
+            size_t size;
+            if (lead < 0x80) {
+                codePoint = lead;
+                size = 1;
+            } else if (lead < 0xE0) {
+                codePoint = lead & 0x1F;
+                size = 2;
+            } else if (lead < 0xF0) {
+                codePoint = lead & 0x0F;
+                size = 3;
+            } else {
+                codePoint = lead & 0x07;
+                size = 4;
+            }
+            for (size_t k = 1; k < size && i + k < length; k++) {
+                codePoint = (codePoint << 6) | (data[i + k] & 0x3F);
+            }
+            i += size;
+
+            if (codePoint >= 0x10000) {
+                if (out) {
+                    out[written] = static_cast<char16_t>(0xD7C0 + (codePoint >> 10));
+                    out[written + 1] = static_cast<char16_t>(0xDC00 | (codePoint & 0x3FF));
+                }
+                written += 2;
+            } else {
+                if (out) out[written] = static_cast<char16_t>(codePoint);
+                written++;
+            }
+        }
+        return written;
+    }
+
+    // Stand-in for WideCharToMultiByte
+    size_t NarrowScalar(const char16_t* data, size_t length, char* out) {
+        size_t written = 0;
+        for (size_t i = 0; i < length; i++) {
+            uint32_t codePoint = data[i];
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 1 < length) {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (data[++i] - 0xDC00u);
+            }
+
+            char bytes[4];
+            size_t size;
+            if (codePoint < 0x80) {
+                bytes[0] = static_cast<char>(codePoint);
+                size = 1;
+            } else if (codePoint < 0x800) {
+                bytes[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+                bytes[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                size = 2;
+            } else if (codePoint < 0x10000) {
+                bytes[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+                bytes[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                bytes[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                size = 3;
+            } else {
+                bytes[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+                bytes[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                bytes[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                bytes[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                size = 4;
+            }
+            if (out) {
+                for (size_t k = 0; k < size; k++) out[written + k] = bytes[k];
+            }
+            written += size;
+        }
+        return written;
+    }
+
+    // The old StringToWideString: size, convert with the terminator, copy up to the NUL
+    std::u16string OldStringToWide(const std::string& text) {
+        size_t size = WidenScalar(text.c_str(), text.size() + 1, nullptr);
+        std::vector<char16_t> buffer(size);
+        WidenScalar(text.c_str(), text.size() + 1, buffer.data());
+        return std::u16string(buffer.data());
+    }
+
+    std::string OldWideToString(const std::u16string& text) {
+        size_t size = NarrowScalar(text.c_str(), text.size() + 1, nullptr);
+        std::vector<char> buffer(size);
+        NarrowScalar(text.c_str(), text.size() + 1, buffer.data());
+        return std::string(buffer.data());
+    }
+
+    std::string Repeat(const char* piece, size_t size) {
+        std::string text;
+        while (text.size() < size) text += piece;
+        return text;
+    }
+
+    double GigabytesPerSecond(size_t bytes, const Bench::Timing& timing) {
+        return static_cast<double>(bytes) / timing.median / 1000.0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        printf("usage: transcode_bench [size in KiB]\n");
+        return 0;
+    }
+    size_t size = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64) * 1024;
+    if (size == 0) {
+        printf("size must be positive\n");
+        return 1;
+    }
+
+    struct Input {
+        const char* name;
+        std::string text;
+    };
+    const Input inputs[] = {
+        { "ascii", Repeat("{\"item\":\"Tabula Rasa\",\"price\":12.5,\"league\":\"Standard\"},", size) },
+        { "mixed", Repeat("Mj\xC3\xB6lner, Pj\xC3\xA4ltverg \xE2\x80\x94 \xC3\x86r\xC3\xAB of Vaal \xE2\x9C\x93 ", size) },
+        { "cjk", Repeat("\xE6\xB7\xB7\xE6\xB2\x8C\xE7\x9F\xB3\xE3\x81\xAE\xE4\xBE\xA1\xE6\xA0\xBC\xE3\x81\xAF"
+                        "\xE5\xA4\x89\xE5\x8B\x95\xE3\x81\x97\xE3\x81\xBE\xE3\x81\x99\xE3\x80\x82 \xF0\x9F\x92\x8E", size) },
+    };
+
+    bool ok = true;
+    printf("GB/s of UTF-8, median of 200 runs (auto picks %s)\n", Transcoder::GetKernelName());
+    for (const Input& input : inputs) {
+        const std::string& text = input.text;
+        std::u16string expected = OldStringToWide(text);
+        std::string expectedBack = OldWideToString(expected);
+
+        Bench::Timing oldWiden = Bench::Measure(200, [&] { Bench::Consume(OldStringToWide(text).size()); });
+        Bench::Timing oldNarrow = Bench::Measure(200, [&] { Bench::Consume(OldWideToString(expected).size()); });
+        printf("\n%s (%zu bytes)\n", input.name, text.size());
+        printf("  %-8s to UTF-16 %6.2f   to UTF-8 %6.2f\n", "old", GigabytesPerSecond(text.size(), oldWiden),
+               GigabytesPerSecond(text.size(), oldNarrow));
+
+        for (const char* kernel : kKernels) {
+            if (!Transcoder::SelectKernel(kernel)) continue;
+
+            // Fresh strings per run, as Utils::StringToWideString returns
+            Bench::Timing widen = Bench::Measure(200, [&] {
+                std::u16string wide;
+                Transcoder::AppendUtf16(text, wide);
+                Bench::Consume(wide.size());
+            });
+            Bench::Timing narrow = Bench::Measure(200, [&] {
+                std::string back;
+                Transcoder::AppendUtf8(expected.data(), expected.size(), back);
+                Bench::Consume(back.size());
+            });
+
+            std::u16string wide;
+            Transcoder::AppendUtf16(text, wide);
+            std::string back;
+            Transcoder::AppendUtf8(wide.data(), wide.size(), back);
+            printf("  %-8s to UTF-16 %6.2f   to UTF-8 %6.2f   (%.1fx, %.1fx)\n", kernel,
+                   GigabytesPerSecond(text.size(), widen), GigabytesPerSecond(text.size(), narrow),
+                   oldWiden.median / widen.median, oldNarrow.median / narrow.median);
+
+            if (wide != expected || back != expectedBack || back != text) {
+                printf("  MISMATCH: %s output differs from the old pattern\n", kernel);
+                ok = false;
+            }
+        }
+        Transcoder::SelectKernel("auto");
+    }
+    return ok ? 0 : 1;
+}
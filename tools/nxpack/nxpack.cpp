@@ -0,0 +1,127 @@
+// nxpack - packs overlay assets into an NXPK bundle
+//
+//   nxpack <output.nxpk> <file or directory>...
+//   nxpack --list <bundle.nxpk>
+//
+// Directories are packed recursively with paths relative to the directory;
+// single files are packed under their file name. Paths are normalised the
+// same way the overlay normalises nexile:// URLs.
+
+#include "UI/AssetBundle.h"
+#include "UI/AssetCache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace Nexile;
+
+namespace {
+    bool ReadFile(const fs::path& path, std::string& contents) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        contents = buffer.str();
+        return true;
+    }
+
+    bool AddFile(AssetBundleWriter& writer, const fs::path& path, const std::string& name) {
+        std::string key;
+        if (!AssetCache::NormalizePath(name, key)) {
+            fprintf(stderr, "nxpack: invalid asset path '%s'\n", name.c_str());
+            return false;
+        }
+
+        std::string contents;
+        if (!ReadFile(path, contents)) {
+            fprintf(stderr, "nxpack: cannot read '%s'\n", path.u8string().c_str());
+            return false;
+        }
+
+        writer.Add(key, contents);
+        return true;
+    }
+
+    int List(const std::string& path) {
+        AssetBundle bundle;
+        std::string error;
+        if (!bundle.OpenFile(path, error)) {
+            fprintf(stderr, "nxpack: %s\n", error.c_str());
+            return 1;
+        }
+
+        for (size_t i = 0; i < bundle.GetEntryCount(); i++) {
+            AssetBundleEntry entry = bundle.GetEntry(i);
+            std::string contents;
+            bool ok = bundle.Read(entry, contents) && AssetCache::HashContent(contents) == entry.hash;
+            printf("%10u %10u %s %016llx %.*s\n", entry.size, entry.storedSize, ok ? "ok " : "BAD",
+                   static_cast<unsigned long long>(entry.hash), static_cast<int>(entry.path.size()), entry.path.data());
+            if (!ok) return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::string(argv[1]) == "--list") {
+        return List(argv[2]);
+    }
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: nxpack <output.nxpk> <file or directory>...\n"
+                        "       nxpack --list <bundle.nxpk>\n");
+        return 2;
+    }
+
+    AssetBundleWriter writer;
+    for (int i = 2; i < argc; i++) {
+        fs::path input = fs::u8path(argv[i]);
+        std::error_code ec;
+
+        if (fs::is_directory(input, ec)) {
+            for (fs::recursive_directory_iterator it(input, ec), end; !ec && it != end; it.increment(ec)) {
+                if (it->is_regular_file(ec) &&
+                    !AddFile(writer, it->path(), it->path().lexically_relative(input).generic_u8string())) {
+                    return 1;
+                }
+            }
+        } else if (!AddFile(writer, input, input.filename().u8string())) {
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> bundle;
+    std::string error;
+    if (!writer.Write(bundle, error)) {
+        fprintf(stderr, "nxpack: %s\n", error.c_str());
+        return 1;
+    }
+
+    // Write through a temporary so an interrupted build never leaves a torn bundle
+    fs::path output = fs::u8path(argv[1]);
+    fs::path temporary = output;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(bundle.data()), static_cast<std::streamsize>(bundle.size()))) {
+            fprintf(stderr, "nxpack: cannot write '%s'\n", temporary.u8string().c_str());
+            return 1;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temporary, output, ec);
+    if (ec) {
+        fprintf(stderr, "nxpack: cannot replace '%s': %s\n", output.u8string().c_str(), ec.message().c_str());
+        return 1;
+    }
+
+    printf("nxpack: %zu assets, %zu bytes -> %s\n", writer.GetEntryCount(), bundle.size(), output.u8string().c_str());
+    return 0;
+}